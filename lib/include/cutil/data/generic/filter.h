@@ -0,0 +1,248 @@
+/** cutil/data/generic/filter.h
+ *
+ * Header for arbitrarily typed approximate membership filters.
+ */
+
+#ifndef CUTIL_GENERIC_FILTER_H_INCLUDED
+#define CUTIL_GENERIC_FILTER_H_INCLUDED
+
+#include <cutil/data/generic/type.h>
+#include <cutil/debug/null.h>
+#include <cutil/io/log.h>
+#include <cutil/status.h>
+#include <cutil/std/stdbool.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/util/macro.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Type (vtable) for cutil filters.
+ */
+typedef struct {
+    const char *const name;
+    void (*const free)(void *data);
+    void (*const reset)(void *data);
+    size_t (*const get_count)(const void *data);
+    cutil_Bool (*const contains)(const void *data, const void *elem);
+    cutil_Status (*const add)(void *data, const void *elem);
+    cutil_Status (*const remove)(void *data, const void *elem); /**< optional */
+    const cutil_GenericType *(*const get_elem_type)(const void *data);
+    size_t (*const serialize)(const void *data, void *buf, size_t buflen);
+} cutil_FilterType;
+
+/**
+ * Returns whether `lhs` is equal to `rhs`.
+ *
+ * @param[in] lhs left-hand side of comparison
+ * @param[in] rhs right-hand side of comparison
+ *
+ * @return is `lhs` equal to `rhs`?
+ */
+cutil_Bool
+cutil_FilterType_equals(
+  const cutil_FilterType *lhs, const cutil_FilterType *rhs
+);
+
+/**
+ * Abstract "class" for cutil filters.
+ *
+ * A filter answers whether an element may have been added to it using memory
+ * far below that of a set of the elements. It stores fingerprints derived
+ * from 'cutil_GenericType_apply_hash' rather than the elements themselves, so
+ * it may report elements that were never added (false positives), but never
+ * misses an element that was added (false negatives). The rate of false
+ * positives is chosen when allocating the filter for an expected number of
+ * elements, and grows beyond it once more elements are added.
+ *
+ * Filters serialize to a portable format that only depends on the hashes of
+ * the elements, so a deserialized filter is valid for element types whose
+ * hash functions do not differ between processes.
+ */
+typedef struct {
+    const cutil_FilterType *vtable;
+    void *data;
+} cutil_Filter;
+
+/**
+ * Convenience MACRO to check for NULLs in `FILTER` in debug mode.
+ *
+ * @param[in] FILTER cutil_Filter to check for NULLs
+ */
+#define CUTIL_NULL_CHECKS_FILTER(FILTER)                                       \
+    do {                                                                       \
+        CUTIL_NULL_CHECK(FILTER);                                              \
+        CUTIL_NULL_CHECK(FILTER->vtable);                                      \
+    } while (0)
+
+/**
+ * Returns vtable of `filter`.
+ *
+ * @param[in] filter cutil_Filter object to get vtable of
+ *
+ * @return vtable of `filter`
+ */
+inline const cutil_FilterType *
+cutil_Filter_get_vtable(const cutil_Filter *filter)
+{
+    CUTIL_RETURN_NULL_IF_NULL(filter);
+    return filter->vtable;
+}
+
+/**
+ * Frees contents of `filter`.
+ *
+ * @param[in] filter cutil_Filter object to be cleared
+ */
+inline void
+cutil_Filter_clear(cutil_Filter *filter)
+{
+    CUTIL_RETURN_IF_NULL(filter);
+    CUTIL_NULL_CHECK_VTABLE(filter->vtable, free);
+    CUTIL_RETURN_IF_NULL(filter->vtable->free);
+    filter->vtable->free(filter->data);
+    filter->data = NULL;
+}
+
+/**
+ * Destructor for 'cutil_Filter'.
+ *
+ * @param[in] filter cutil_Filter object to be destroyed
+ */
+inline void
+cutil_Filter_free(cutil_Filter *filter)
+{
+    cutil_Filter_clear(filter);
+    free(filter);
+}
+
+/**
+ * Removes all elements from `filter`.
+ *
+ * @param[in] filter cutil_Filter to reset
+ */
+inline void
+cutil_Filter_reset(cutil_Filter *filter)
+{
+    CUTIL_NULL_CHECKS_FILTER(filter);
+    CUTIL_NULL_CHECK_VTABLE(filter->vtable, reset);
+    CUTIL_RETURN_IF_NULL(filter->vtable->reset);
+    filter->vtable->reset(filter->data);
+}
+
+/**
+ * Returns number of elements added to `filter` and not removed since,
+ * including duplicates.
+ *
+ * @param[in] filter cutil_Filter object to get number of elements of
+ *
+ * @return number of elements in `filter`
+ */
+inline size_t
+cutil_Filter_get_count(const cutil_Filter *filter)
+{
+    CUTIL_NULL_CHECKS_FILTER(filter);
+    CUTIL_NULL_CHECK_VTABLE(filter->vtable, get_count);
+    CUTIL_RETURN_VAL_IF_NULL(filter->vtable->get_count, 0UL);
+    return filter->vtable->get_count(filter->data);
+}
+
+/**
+ * Returns if `filter` may contain `elem`. False means that `elem` was
+ * definitely never added, while true may be a false positive.
+ *
+ * @param[in] filter cutil_Filter to search in
+ * @param[in] elem element to search for
+ *
+ * @return may `filter` contain `elem`?
+ */
+inline cutil_Bool
+cutil_Filter_contains(const cutil_Filter *filter, const void *elem)
+{
+    CUTIL_NULL_CHECKS_FILTER(filter);
+    CUTIL_NULL_CHECK_VTABLE(filter->vtable, contains);
+    CUTIL_RETURN_VAL_IF_NULL(filter->vtable->contains, true);
+    return filter->vtable->contains(filter->data, elem);
+}
+
+/**
+ * Adds `elem` to `filter`.
+ *
+ * @param[in] filter cutil_Filter to add element to
+ * @param[in] elem element to be added
+ *
+ * @return error code
+ */
+inline cutil_Status
+cutil_Filter_add(cutil_Filter *filter, const void *elem)
+{
+    CUTIL_NULL_CHECKS_FILTER(filter);
+    CUTIL_NULL_CHECK_VTABLE(filter->vtable, add);
+    CUTIL_RETURN_VAL_IF_NULL(filter->vtable->add, CUTIL_STATUS_FAILURE);
+    return filter->vtable->add(filter->data, elem);
+}
+
+/**
+ * Removes `elem` from `filter`, if supported. Only elements that were added
+ * may be removed, as removing others may drop the fingerprint of an added
+ * element and cause false negatives.
+ *
+ * @param[in] filter cutil_Filter to remove element from
+ * @param[in] elem element to be removed
+ *
+ * @return error code
+ */
+inline cutil_Status
+cutil_Filter_remove(cutil_Filter *filter, const void *elem)
+{
+    CUTIL_NULL_CHECKS_FILTER(filter);
+    CUTIL_NULL_CHECK_VTABLE(filter->vtable, remove);
+    CUTIL_RETURN_VAL_IF_NULL(filter->vtable->remove, CUTIL_STATUS_FAILURE);
+    return filter->vtable->remove(filter->data, elem);
+}
+
+/**
+ * Returns element type of `filter`.
+ *
+ * @param[in] filter cutil_Filter object to get element type of
+ *
+ * @return element type of `filter`
+ */
+inline const cutil_GenericType *
+cutil_Filter_get_elem_type(const cutil_Filter *filter)
+{
+    CUTIL_NULL_CHECKS_FILTER(filter);
+    CUTIL_NULL_CHECK_VTABLE(filter->vtable, get_elem_type);
+    CUTIL_RETURN_NULL_IF_NULL(filter->vtable->get_elem_type);
+    return filter->vtable->get_elem_type(filter->data);
+}
+
+/**
+ * Serializes `filter` into `buf` with all integers in little-endian byte
+ * order. Pass buf=NULL with buflen=0 to query the required buffer size.
+ *
+ * @param[in] filter cutil_Filter to serialize
+ * @param[out] buf destination buffer, or NULL to query required size
+ * @param[in] buflen size of destination buffer in bytes, or 0 when querying
+ *
+ * @return number of bytes written, or required size when buf is NULL, or
+ *         CUTIL_ERROR_SIZE on error or if buflen is too small
+ */
+inline size_t
+cutil_Filter_serialize(const cutil_Filter *filter, void *buf, size_t buflen)
+{
+    CUTIL_NULL_CHECKS_FILTER(filter);
+    CUTIL_NULL_CHECK_VTABLE(filter->vtable, serialize);
+    CUTIL_RETURN_VAL_IF_NULL(filter->vtable->serialize, CUTIL_ERROR_SIZE);
+    return filter->vtable->serialize(filter->data, buf, buflen);
+}
+
+#undef CUTIL_NULL_CHECKS_FILTER
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_FILTER_H_INCLUDED */
@@ -0,0 +1,67 @@
+/** cutil/data/generic/filter/bloomfilter.h
+ *
+ * Header for cache-line-blocked Bloom filters.
+ */
+
+#ifndef CUTIL_GENERIC_FILTER_BLOOMFILTER_H_INCLUDED
+#define CUTIL_GENERIC_FILTER_BLOOMFILTER_H_INCLUDED
+
+#include <cutil/data/generic/filter.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/std/stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_FilterType' for a blocked Bloom filter.
+ *
+ * The filter is an array of 256-bit blocks, each made of eight 32-bit words,
+ * in memory aligned to cache lines. An element selects a block by its hash and
+ * sets one bit in each word of it, so adding or looking up an element touches
+ * a single cache line. Where SSE2 is available, all eight bits are tested or
+ * set at once.
+ *
+ * Blocks are sized for the requested rate of false positives, which takes
+ * about 10.5 bits per element for 1% and about 17 bits for 0.1%. Elements
+ * cannot be removed.
+ */
+extern const cutil_FilterType *const CUTIL_FILTER_TYPE_BLOOM;
+
+/**
+ * Constructor for 'cutil_Filter' backed by a blocked Bloom filter for elements
+ * of type `elem_type`, sized so that the rate of false positives does not
+ * exceed `fpp` until `capacity` elements are added.
+ *
+ * @param[in] elem_type cutil_GenericType of elements
+ * @param[in] capacity expected number of elements
+ * @param[in] fpp target rate of false positives, in (0, 1)
+ *
+ * @return newly malloc'd cutil_Filter object, or NULL on invalid arguments
+ */
+cutil_Filter *
+cutil_BloomFilter_alloc(
+  const cutil_GenericType *elem_type, size_t capacity, double fpp
+);
+
+/**
+ * Constructs a blocked Bloom filter for elements of type `elem_type` from
+ * `buflen` bytes of `buf` written by 'cutil_Filter_serialize'.
+ *
+ * @param[in] elem_type cutil_GenericType of elements
+ * @param[in] buf serialized Bloom filter
+ * @param[in] buflen size of `buf` in bytes
+ *
+ * @return newly malloc'd cutil_Filter object, or NULL if `buf` is malformed
+ */
+cutil_Filter *
+cutil_BloomFilter_deserialize(
+  const cutil_GenericType *elem_type, const void *buf, size_t buflen
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_FILTER_BLOOMFILTER_H_INCLUDED */
@@ -0,0 +1,67 @@
+/** cutil/data/generic/filter/cuckoofilter.h
+ *
+ * Header for cuckoo filters.
+ */
+
+#ifndef CUTIL_GENERIC_FILTER_CUCKOOFILTER_H_INCLUDED
+#define CUTIL_GENERIC_FILTER_CUCKOOFILTER_H_INCLUDED
+
+#include <cutil/data/generic/filter.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/std/stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_FilterType' for a cuckoo filter.
+ *
+ * The filter stores a fingerprint of each element in one of two buckets of
+ * four slots, bit-packed so that a bucket is read and compared against a
+ * fingerprint as a single 64-bit word. An element is found by checking both
+ * of its buckets, and an element that was added may be removed again.
+ *
+ * Fingerprints take between 4 and 16 bits, chosen for the requested rate of
+ * false positives; rates below 16 bits' worth (about 0.01%) are capped there.
+ * Adding fails once the filter holds about 95% of its slots, which the
+ * capacity given at allocation accounts for.
+ */
+extern const cutil_FilterType *const CUTIL_FILTER_TYPE_CUCKOO;
+
+/**
+ * Constructor for 'cutil_Filter' backed by a cuckoo filter for elements of
+ * type `elem_type`, sized to hold `capacity` elements at a rate of false
+ * positives of about `fpp`.
+ *
+ * @param[in] elem_type cutil_GenericType of elements
+ * @param[in] capacity expected number of elements
+ * @param[in] fpp target rate of false positives, in (0, 1)
+ *
+ * @return newly malloc'd cutil_Filter object, or NULL on invalid arguments
+ */
+cutil_Filter *
+cutil_CuckooFilter_alloc(
+  const cutil_GenericType *elem_type, size_t capacity, double fpp
+);
+
+/**
+ * Constructs a cuckoo filter for elements of type `elem_type` from `buflen`
+ * bytes of `buf` written by 'cutil_Filter_serialize'.
+ *
+ * @param[in] elem_type cutil_GenericType of elements
+ * @param[in] buf serialized cuckoo filter
+ * @param[in] buflen size of `buf` in bytes
+ *
+ * @return newly malloc'd cutil_Filter object, or NULL if `buf` is malformed
+ */
+cutil_Filter *
+cutil_CuckooFilter_deserialize(
+  const cutil_GenericType *elem_type, const void *buf, size_t buflen
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_FILTER_CUCKOOFILTER_H_INCLUDED */
@@ -33,11 +33,22 @@ typedef struct {
     cutil_Bool (*const contains)(const void *data, const void *key);
     cutil_Status (*const get)(const void *data, const void *key, void *val);
     const void *(*const get_ptr)(const void *data, const void *key);
+    cutil_Status (*const get_ptr_batch)(
+      const void *data, const void *keys, size_t num_keys, const void **vals
+    );
     cutil_Status (*const set)(void *data, const void *key, const void *val);
+    void *(*const get_or_insert)(
+      void *data, const void *key, const void *val, cutil_Bool *inserted
+    );
+    cutil_Status (*const reserve)(void *data, size_t count);
+    cutil_Status (*const shrink_to_fit)(void *data);
     const cutil_GenericType *(*const get_key_type)(const void *data);
     const cutil_GenericType *(*const get_val_type)(const void *data);
     cutil_ConstIterator *(*const get_const_iterator)(const void *data);
     cutil_Iterator *(*const get_iterator)(void *data);
+    cutil_hash_t (*const hash)(const void *data); /**< optional */
+    /** optional `get_ptr` without side effects, e.g. on eviction order */
+    const void *(*const peek_ptr)(const void *data, const void *key);
 } cutil_MapType;
 
 /**
@@ -252,6 +263,24 @@ cutil_Map_get_ptr(const cutil_Map *map, const void *key)
     return map->vtable->get_ptr(map->data, key);
 }
 
+/**
+ * Looks up `num_keys` keys stored contiguously in `keys` and writes pointers
+ * to their values (or NULL if not present) to `vals`. Maps may overlap the
+ * memory accesses of several lookups; otherwise, this falls back to
+ * 'cutil_Map_get_ptr' for each key.
+ *
+ * @param[in] map cutil_Map to be worked with
+ * @param[in] keys array of `num_keys` keys of the map's key type
+ * @param[in] num_keys number of keys to look up
+ * @param[out] vals array of `num_keys` value pointers
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_Map_get_ptr_batch(
+  const cutil_Map *map, const void *keys, size_t num_keys, const void **vals
+);
+
 /**
  * Insert key-value pair [`key`, `val`] into 'cutil_Map' and overwrite if
  * `key` is already present.
@@ -271,6 +300,58 @@ cutil_Map_set(cutil_Map *map, const void *key, const void *val)
     return map->vtable->set(map->data, key, val);
 }
 
+/**
+ * Returns pointer to the value of `key` in `map`. If `key` is not present, the
+ * entry [`key`, `val`] is inserted first. Maps may do this with a single
+ * lookup; otherwise, this falls back to 'cutil_Map_contains' and
+ * 'cutil_Map_set'. The returned pointer is invalidated by later insertions or
+ * removals.
+ *
+ * @param[in] map cutil_Map to be worked with
+ * @param[in] key key to look up
+ * @param[in] val value to insert if `key` is not present
+ * @param[out] inserted whether the entry was inserted, may be NULL
+ *
+ * @return pointer to value of `key`, NULL on failure
+ */
+void *
+cutil_Map_get_or_insert(
+  cutil_Map *map, const void *key, const void *val, cutil_Bool *inserted
+);
+
+/**
+ * Prepares `map` to hold at least `count` entries without reallocating.
+ *
+ * @param[in] map cutil_Map to reserve space in
+ * @param[in] count number of entries to reserve space for
+ *
+ * @return error code
+ */
+inline cutil_Status
+cutil_Map_reserve(cutil_Map *map, size_t count)
+{
+    CUTIL_NULL_CHECKS_MAP(map);
+    CUTIL_NULL_CHECK_VTABLE(map->vtable, reserve);
+    CUTIL_RETURN_VAL_IF_NULL(map->vtable->reserve, CUTIL_STATUS_FAILURE);
+    return map->vtable->reserve(map->data, count);
+}
+
+/**
+ * Releases memory of `map` that is not needed for its current entries.
+ *
+ * @param[in] map cutil_Map to shrink
+ *
+ * @return error code
+ */
+inline cutil_Status
+cutil_Map_shrink_to_fit(cutil_Map *map)
+{
+    CUTIL_NULL_CHECKS_MAP(map);
+    CUTIL_NULL_CHECK_VTABLE(map->vtable, shrink_to_fit);
+    CUTIL_RETURN_VAL_IF_NULL(map->vtable->shrink_to_fit, CUTIL_STATUS_FAILURE);
+    return map->vtable->shrink_to_fit(map->data);
+}
+
 /**
  * Returns key type of `map`.
  *
@@ -368,7 +449,9 @@ cutil_Map_compare(const cutil_Map *lhs, const cutil_Map *rhs);
 
 /**
  * Computes a hash of `map` by XOR-folding `hash(key) ^ hash(value)` per
- * entry. Returns CUTIL_HASH_C(0) for NULL or an empty map.
+ * entry. Returns CUTIL_HASH_C(0) for NULL or an empty map. Maps whose type
+ * implements `hash` maintain this value on modification and return it without
+ * iterating.
  *
  * @param[in] map Map to hash
  *
@@ -0,0 +1,100 @@
+/** cutil/generic/map/btreemap.h
+ *
+ * Header for arbitrarily typed ordered map backed by a B-tree.
+ */
+
+#ifndef CUTIL_GENERIC_MAP_BTREEMAP_H_INCLUDED
+#define CUTIL_GENERIC_MAP_BTREEMAP_H_INCLUDED
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/map.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_MapType' for a B-tree map.
+ *
+ * Keys are ordered by the 'comp' function of the key type. Iterators visit
+ * keys in ascending order. Each node stores its keys contiguously, and the
+ * number of keys per node is chosen such that they span a few cache lines.
+ */
+extern const cutil_MapType *const CUTIL_MAP_TYPE_BTREEMAP;
+
+/**
+ * 'cutil_ConstIteratorType' for a B-tree map iterator (read-only).
+ */
+extern const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_BTREEMAP;
+
+/**
+ * 'cutil_IteratorType' for a B-tree map iterator (read-write).
+ */
+extern const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_BTREEMAP;
+
+/**
+ * Constructor for 'cutil_Map' with key type and value type.
+ *
+ * @param[in] key_type cutil_GenericType of keys
+ * @param[in] val_type cutil_GenericType of vals
+ *
+ * @return newly malloc'd cutil_Map object
+ */
+cutil_Map *
+cutil_BTreeMap_alloc(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+);
+
+/**
+ * Returns iterator over the keys of `map` that are not less than `key`, in
+ * ascending order. Rewinding the iterator restarts at the bound.
+ *
+ * @param[in] map cutil_Map backed by a BTreeMap
+ * @param[in] key lower bound (inclusive)
+ *
+ * @return newly malloc'd cutil_ConstIterator
+ */
+cutil_ConstIterator *
+cutil_BTreeMap_lower_bound(const cutil_Map *map, const void *key);
+
+/**
+ * Returns iterator over the keys of `map` that are greater than `key`, in
+ * ascending order. Rewinding the iterator restarts at the bound.
+ *
+ * @param[in] map cutil_Map backed by a BTreeMap
+ * @param[in] key lower bound (exclusive)
+ *
+ * @return newly malloc'd cutil_ConstIterator
+ */
+cutil_ConstIterator *
+cutil_BTreeMap_upper_bound(const cutil_Map *map, const void *key);
+
+/**
+ * Copies the smallest key of `map` to `key`.
+ *
+ * @param[in] map cutil_Map backed by a BTreeMap
+ * @param[out] key memory to write key to
+ *
+ * @return CUTIL_STATUS_SUCCESS, or CUTIL_STATUS_FAILURE if `map` is empty
+ */
+cutil_Status
+cutil_BTreeMap_get_min(const cutil_Map *map, void *key);
+
+/**
+ * Copies the largest key of `map` to `key`.
+ *
+ * @param[in] map cutil_Map backed by a BTreeMap
+ * @param[out] key memory to write key to
+ *
+ * @return CUTIL_STATUS_SUCCESS, or CUTIL_STATUS_FAILURE if `map` is empty
+ */
+cutil_Status
+cutil_BTreeMap_get_max(const cutil_Map *map, void *key);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_MAP_BTREEMAP_H_INCLUDED */
@@ -0,0 +1,172 @@
+/** cutil/generic/map/cachemap.h
+ *
+ * Header for arbitrarily typed, bounded cache map.
+ */
+
+#ifndef CUTIL_GENERIC_MAP_CACHEMAP_H_INCLUDED
+#define CUTIL_GENERIC_MAP_CACHEMAP_H_INCLUDED
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/map.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Eviction policy of a cache map.
+ */
+typedef struct _cutil_CachePolicy cutil_CachePolicy;
+
+/**
+ * Evicts the least recently used entries. Entries are kept in an intrusive
+ * doubly linked list in order of their last access, so both hits and
+ * evictions take constant time.
+ */
+extern const cutil_CachePolicy *const CUTIL_CACHE_POLICY_LRU;
+
+/**
+ * W-TinyLFU: new entries enter a small LRU window (1% of the budget). Entries
+ * leaving the window are only admitted to the main region, a segmented LRU
+ * whose protected segment takes 80% of it, if their estimated access
+ * frequency exceeds the one of the entry they would evict. Frequencies are
+ * estimated by a count-min sketch of 4-bit counters that are halved
+ * periodically, so that popularity ages. This keeps scans and one-hit
+ * wonders from flushing frequently used entries.
+ */
+extern const cutil_CachePolicy *const CUTIL_CACHE_POLICY_TINYLFU;
+
+/**
+ * Typedef for functions returning the weight of an entry, e.g. the number of
+ * bytes it holds.
+ */
+typedef size_t
+cutil_CacheWeigher(const void *key, const void *val);
+
+/**
+ * Counters of a cache map.
+ */
+typedef struct {
+    size_t hits;       /**< lookups that found their key */
+    size_t misses;     /**< lookups that did not find their key */
+    size_t evictions;  /**< entries evicted to stay within the budget */
+    size_t rejections; /**< entries not admitted by the eviction policy */
+} cutil_CacheStats;
+
+/**
+ * 'cutil_MapType' for a cache map.
+ *
+ * A cache map holds entries up to a maximum total weight. When an insertion
+ * exceeds it, entries chosen by the eviction policy are removed. Lookups
+ * through 'cutil_Map_get', 'cutil_Map_get_ptr' and 'cutil_Map_get_or_insert'
+ * count as accesses: they update the eviction order and the hit and miss
+ * counters, so unlike most maps, a cache map is modified by lookups.
+ * 'cutil_Map_contains', iteration, 'cutil_Map_deep_equals',
+ * 'cutil_Map_compare', 'cutil_Map_hash' and 'cutil_Map_to_string' do not
+ * count as accesses.
+ *
+ * Pointers returned by lookups are valid until the next insertion, which may
+ * evict the entry they point to.
+ */
+extern const cutil_MapType *const CUTIL_MAP_TYPE_CACHE;
+
+/**
+ * 'cutil_ConstIteratorType' for a cache map iterator (read-only).
+ */
+extern const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_CACHE;
+
+/**
+ * 'cutil_IteratorType' for a cache map iterator (read-write).
+ */
+extern const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_CACHE;
+
+/**
+ * Constructor for 'cutil_Map' with key type and value type that holds at most
+ * `max_entries` entries.
+ *
+ * @param[in] key_type cutil_GenericType of keys
+ * @param[in] val_type cutil_GenericType of vals
+ * @param[in] max_entries maximum number of entries, at least 1
+ * @param[in] policy eviction policy, e.g. CUTIL_CACHE_POLICY_LRU
+ *
+ * @return newly malloc'd cutil_Map object, or NULL on invalid arguments
+ */
+cutil_Map *
+cutil_CacheMap_alloc(
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type,
+  size_t max_entries,
+  const cutil_CachePolicy *policy
+);
+
+/**
+ * Constructor for 'cutil_Map' with key type and value type whose entries weigh
+ * at most `max_weight` in total. The weight of an entry is determined by
+ * `weigher` whenever its value is set. If `weigher` is NULL, every entry
+ * weighs the size of its key and value type in bytes. Entries that weigh more
+ * than `max_weight` on their own are not inserted.
+ *
+ * @param[in] key_type cutil_GenericType of keys
+ * @param[in] val_type cutil_GenericType of vals
+ * @param[in] max_weight maximum total weight of all entries, at least 1
+ * @param[in] weigher function returning weight of an entry, or NULL
+ * @param[in] policy eviction policy, e.g. CUTIL_CACHE_POLICY_LRU
+ *
+ * @return newly malloc'd cutil_Map object, or NULL on invalid arguments
+ */
+cutil_Map *
+cutil_CacheMap_alloc_with_budget(
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type,
+  size_t max_weight,
+  cutil_CacheWeigher *weigher,
+  const cutil_CachePolicy *policy
+);
+
+/**
+ * Returns total weight of the entries of `map`.
+ *
+ * @param[in] map cache map
+ *
+ * @return total weight of entries
+ */
+size_t
+cutil_CacheMap_get_weight(const cutil_Map *map);
+
+/**
+ * Writes counters of `map` to `stats`.
+ *
+ * @param[in] map cache map
+ * @param[out] stats counters of `map`
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_CacheMap_get_stats(const cutil_Map *map, cutil_CacheStats *stats);
+
+/**
+ * Resets counters of `map` to 0.
+ *
+ * @param[in] map cache map
+ */
+void
+cutil_CacheMap_reset_stats(cutil_Map *map);
+
+/**
+ * Returns share of lookups in `stats` that found their key, or 0 if there
+ * were no lookups.
+ *
+ * @param[in] stats counters of a cache map
+ *
+ * @return hit rate in [0, 1]
+ */
+double
+cutil_CacheStats_get_hit_rate(const cutil_CacheStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_MAP_CACHEMAP_H_INCLUDED */
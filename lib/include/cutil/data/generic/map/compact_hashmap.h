@@ -0,0 +1,59 @@
+/** cutil/generic/map/compact_hashmap.h
+ *
+ * Header for arbitrarily typed, insertion-ordered hash map with a compact
+ * layout.
+ */
+
+#ifndef CUTIL_GENERIC_MAP_COMPACT_HASHMAP_H_INCLUDED
+#define CUTIL_GENERIC_MAP_COMPACT_HASHMAP_H_INCLUDED
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/map.h>
+#include <cutil/data/generic/type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_MapType' for a compact hash map.
+ *
+ * Entries are stored densely in insertion order, and a separate open
+ * addressing index maps hashes to entry numbers. Depending on the size of
+ * the map, index slots take 1, 2, 4 or 8 bytes, so the sparse part of the
+ * table is small, and no key or value storage is wasted on empty slots.
+ *
+ * Iterators visit keys in insertion order. Setting the value of a present key
+ * keeps its position, while a removed and re-inserted key moves to the end.
+ */
+extern const cutil_MapType *const CUTIL_MAP_TYPE_COMPACT_HASHMAP;
+
+/**
+ * 'cutil_ConstIteratorType' for a compact hash map iterator (read-only).
+ */
+extern const cutil_ConstIteratorType
+  *const CUTIL_CONST_ITERATOR_TYPE_COMPACT_HASHMAP;
+
+/**
+ * 'cutil_IteratorType' for a compact hash map iterator (read-write).
+ */
+extern const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_COMPACT_HASHMAP;
+
+/**
+ * Constructor for 'cutil_Map' with key type and value type.
+ *
+ * @param[in] key_type cutil_GenericType of keys
+ * @param[in] val_type cutil_GenericType of vals
+ *
+ * @return newly malloc'd cutil_Map object
+ */
+cutil_Map *
+cutil_CompactHashMap_alloc(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_MAP_COMPACT_HASHMAP_H_INCLUDED */
@@ -0,0 +1,96 @@
+/** cutil/generic/map/concurrent_hashmap.h
+ *
+ * Header for arbitrarily typed hash map that can be shared between threads.
+ */
+
+#ifndef CUTIL_GENERIC_MAP_CONCURRENT_HASHMAP_H_INCLUDED
+#define CUTIL_GENERIC_MAP_CONCURRENT_HASHMAP_H_INCLUDED
+
+#include <cutil/data/generic/map.h>
+#include <cutil/data/generic/type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_MapType' for a concurrent hash map.
+ *
+ * Entries are distributed over a power-of-two number of shards by the high
+ * bits of their hash. Each shard is a HashMap guarded by its own
+ * reader-writer lock, so operations on different shards never contend and
+ * lookups on the same shard run in parallel.
+ *
+ * Single-entry operations (contains, get, set, remove, get_count, ...) as
+ * well as reset, copy and duplicate are thread-safe. Pointers returned by
+ * get_ptr and get_or_insert are only valid as long as no other thread
+ * modifies the map; use 'cutil_Map_get' to read values that may be written
+ * concurrently.
+ *
+ * Iterators visit the shards one after another and hold the lock of the
+ * shard they are on: const iterators share it with lookups, while iterators
+ * take it exclusively so that they can remove entries. Entries of other
+ * shards may change during iteration. The thread owning a const iterator may
+ * look up entries meanwhile, re-entering the shared lock, but must not modify
+ * the map; the thread owning an iterator must not call any other operation of
+ * the map. Rewinding or freeing an iterator releases its lock.
+ */
+extern const cutil_MapType *const CUTIL_MAP_TYPE_CONCURRENT_HASHMAP;
+
+/**
+ * 'cutil_ConstIteratorType' for a concurrent hash map iterator (read-only).
+ */
+extern const cutil_ConstIteratorType
+  *const CUTIL_CONST_ITERATOR_TYPE_CONCURRENT_HASHMAP;
+
+/**
+ * 'cutil_IteratorType' for a concurrent hash map iterator (read-write).
+ */
+extern const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_CONCURRENT_HASHMAP;
+
+/**
+ * Constructor for 'cutil_Map' with key type and value type and a default
+ * number of shards.
+ *
+ * @param[in] key_type cutil_GenericType of keys
+ * @param[in] val_type cutil_GenericType of vals
+ *
+ * @return newly malloc'd cutil_Map object
+ */
+cutil_Map *
+cutil_ConcurrentHashMap_alloc(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+);
+
+/**
+ * Constructor for 'cutil_Map' with key type and value type and at least
+ * `num_shards` shards. The number of shards is rounded up to a power of two.
+ *
+ * @param[in] key_type cutil_GenericType of keys
+ * @param[in] val_type cutil_GenericType of vals
+ * @param[in] num_shards minimal number of shards, 0 for the default
+ *
+ * @return newly malloc'd cutil_Map object, or NULL on invalid arguments
+ */
+cutil_Map *
+cutil_ConcurrentHashMap_alloc_with_shards(
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type,
+  size_t num_shards
+);
+
+/**
+ * Returns number of shards of `map`.
+ *
+ * @param[in] map cutil_Map backed by a ConcurrentHashMap
+ *
+ * @return number of shards, or 0 if map is NULL
+ */
+size_t
+cutil_ConcurrentHashMap_get_num_shards(const cutil_Map *map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_MAP_CONCURRENT_HASHMAP_H_INCLUDED */
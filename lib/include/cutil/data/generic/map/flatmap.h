@@ -0,0 +1,90 @@
+/** cutil/generic/map/flatmap.h
+ *
+ * Header for arbitrarily typed ordered map backed by sorted arrays.
+ */
+
+#ifndef CUTIL_GENERIC_MAP_FLATMAP_H_INCLUDED
+#define CUTIL_GENERIC_MAP_FLATMAP_H_INCLUDED
+
+#include <cutil/data/generic/array.h>
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/map.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_MapType' for a flat map.
+ *
+ * Keys and values are stored in two 'cutil_Array's, sorted by the 'comp'
+ * function of the key type, without any per-entry overhead. Lookups are
+ * binary searches whose loop is free of branches, and iterators visit keys in
+ * ascending order by walking the arrays.
+ *
+ * Inserting or removing a single entry shifts all entries after it, so flat
+ * maps suit read-mostly maps of up to a few thousand entries. Many entries
+ * are best inserted at once via 'cutil_FlatMap_set_mult', which sorts them
+ * once and merges them with the existing entries.
+ */
+extern const cutil_MapType *const CUTIL_MAP_TYPE_FLATMAP;
+
+/**
+ * 'cutil_ConstIteratorType' for a flat map iterator (read-only).
+ */
+extern const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_FLATMAP;
+
+/**
+ * 'cutil_IteratorType' for a flat map iterator (read-write).
+ */
+extern const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_FLATMAP;
+
+/**
+ * Constructor for 'cutil_Map' with key type and value type.
+ *
+ * @param[in] key_type cutil_GenericType of keys
+ * @param[in] val_type cutil_GenericType of vals
+ *
+ * @return newly malloc'd cutil_Map object, or NULL on invalid arguments
+ */
+cutil_Map *
+cutil_FlatMap_alloc(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+);
+
+/**
+ * Sets the `num` entries given by the parallel arrays `keys` and `vals` in
+ * `map`. The entries are sorted once, of equal keys the last one wins, and
+ * they are merged with the entries of `map` in a single pass from the back.
+ *
+ * @param[in, out] map cutil_Map backed by a FlatMap
+ * @param[in] keys contiguous array of `num` keys
+ * @param[in] vals contiguous array of `num` values
+ * @param[in] num number of entries to set
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_FlatMap_set_mult(
+  cutil_Map *map, const void *keys, const void *vals, size_t num
+);
+
+/**
+ * Constructs a flat map from the parallel arrays `keys` and `vals`, see
+ * 'cutil_FlatMap_set_mult'. Key and value types are taken from the arrays.
+ *
+ * @param[in] keys cutil_Array of keys
+ * @param[in] vals cutil_Array of values with the same capacity as `keys`
+ *
+ * @return newly malloc'd cutil_Map object, or NULL on invalid arguments
+ */
+cutil_Map *
+cutil_FlatMap_from_arrays(const cutil_Array *keys, const cutil_Array *vals);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_MAP_FLATMAP_H_INCLUDED */
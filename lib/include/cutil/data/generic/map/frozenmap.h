@@ -0,0 +1,61 @@
+/** cutil/generic/map/frozenmap.h
+ *
+ * Header for arbitrarily typed read-only map with minimal perfect hashing.
+ */
+
+#ifndef CUTIL_GENERIC_MAP_FROZENMAP_H_INCLUDED
+#define CUTIL_GENERIC_MAP_FROZENMAP_H_INCLUDED
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/map.h>
+#include <cutil/data/generic/type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_MapType' for a frozen map.
+ *
+ * A frozen map is built once from another map and cannot be modified
+ * afterwards. Keys and values are stored in dense arrays of exactly as many
+ * slots as there are entries, and a minimal perfect hash function maps each
+ * key to its slot, so that a lookup hashes the key once and compares it to
+ * exactly one stored key. Keys sharing their hash with another key are kept
+ * in a sorted overflow area, which lookups only search after a failed
+ * comparison.
+ *
+ * Operations that would modify the map (set, remove, get_or_insert and
+ * removal through iterators) fail.
+ */
+extern const cutil_MapType *const CUTIL_MAP_TYPE_FROZEN;
+
+/**
+ * 'cutil_ConstIteratorType' for a frozen map iterator (read-only).
+ */
+extern const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_FROZEN;
+
+/**
+ * 'cutil_IteratorType' for a frozen map iterator (cannot remove).
+ */
+extern const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_FROZEN;
+
+/**
+ * Returns a frozen map holding copies of the entries of `map`.
+ *
+ * Building the perfect hash function takes expected O(n log n) time, so
+ * freezing pays off for maps that are queried far more often than built.
+ *
+ * @param[in] map cutil_Map of any type to freeze
+ *
+ * @return newly malloc'd cutil_Map of type CUTIL_MAP_TYPE_FROZEN, or NULL if
+ *   `map` is NULL or its iterator yields fewer keys than its count
+ */
+cutil_Map *
+cutil_Map_freeze(const cutil_Map *map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_MAP_FROZENMAP_H_INCLUDED */
@@ -6,15 +6,67 @@
 #ifndef CUTIL_GENERIC_MAP_HASHMAP_H_INCLUDED
 #define CUTIL_GENERIC_MAP_HASHMAP_H_INCLUDED
 
+#include <cutil/data/generic/array.h>
 #include <cutil/data/generic/map.h>
 #include <cutil/data/generic/type.h>
+#include <cutil/status.h>
+#include <cutil/std/stdbool.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/**
+ * Number of buckets of the probe length histogram in 'cutil_HashMapStats'.
+ */
+#define CUTIL_HASHMAP_PROBE_HISTOGRAM_SIZE 16
+
+/**
+ * Layout statistics of a hash map. The probe length of an entry is the number
+ * of groups of slots a lookup of its key loads, 1 if the entry sits in the
+ * group its hash points to. Entries stored inline have probe length 1.
+ *
+ * The lookup counters are only maintained if the library is compiled with
+ * CUTIL_ENABLE_HASHMAP_COUNTERS defined, and are 0 otherwise. Maps declared
+ * via 'cutil_HashMap_set_concurrent_reads' do not count lookups.
+ */
+typedef struct {
+    size_t capacity;         /**< number of slots of the table */
+    size_t num_entries;      /**< number of entries */
+    size_t num_tombstones;   /**< slots of removed entries not yet reused */
+    double load_factor;      /**< share of used slots, incl. tombstones */
+    size_t num_rehashes;     /**< times the entries moved to a new table */
+    double avg_probe_length; /**< mean probe length of entries, 0 if empty */
+    size_t max_probe_length; /**< longest probe length of entries */
+    /** entries per probe length 1, 2, ..., the last bucket counting all
+     * longer ones as well */
+    size_t probe_histogram[CUTIL_HASHMAP_PROBE_HISTOGRAM_SIZE];
+    size_t num_lookups;      /**< key searches, including insertions */
+    size_t num_hits;         /**< searches that found their key */
+    size_t num_misses;       /**< searches that did not find their key */
+    size_t num_comparisons;  /**< key comparisons performed by searches */
+} cutil_HashMapStats;
+
 /**
  * 'cutil_MapType' for a hash map.
+ *
+ * After the first call to 'cutil_Map_hash', the map maintains its content hash
+ * on every modification, so that further calls, and 'cutil_Map_deep_equals' on
+ * maps with different contents, return without iterating. Since values may be
+ * modified through the pointer returned by 'cutil_Map_get_or_insert', that
+ * call suspends maintenance until the content hash is requested again.
+ *
+ * Maps with at most 8 entries are kept in a single block of inline slots and
+ * searched linearly; a hashed table replaces the block once a 9th entry is
+ * inserted, and 'cutil_Map_shrink_to_fit' returns to inline slots once the map
+ * fits there.
+ *
+ * Every map hashes its keys under a seed drawn from a random key of the
+ * process, see 'cutil_GenericType_apply_hash_seeded', so that its iteration
+ * order differs from other maps holding the same keys and key sets crafted to
+ * collide cannot be reused against other maps. Keys whose type lacks a seeded
+ * hash function still collide if their unseeded hashes are equal. Copies share
+ * the seed of their source.
  */
 extern const cutil_MapType *const CUTIL_MAP_TYPE_HASHMAP;
 
@@ -42,6 +94,158 @@ cutil_HashMap_alloc(
   const cutil_GenericType *key_type, const cutil_GenericType *val_type
 );
 
+/**
+ * Constructor for 'cutil_Map' with key type and value type that can hold
+ * `capacity` entries without rehashing. The table is expanded once
+ * `max_load_factor` of its slots are in use.
+ *
+ * @param[in] key_type cutil_GenericType of keys
+ * @param[in] val_type cutil_GenericType of vals
+ * @param[in] capacity number of entries to reserve space for
+ * @param[in] max_load_factor maximum share of used slots, in (0, 7/8]
+ *
+ * @return newly malloc'd cutil_Map object, or NULL on invalid arguments
+ */
+cutil_Map *
+cutil_HashMap_alloc_with_capacity(
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type,
+  size_t capacity,
+  double max_load_factor
+);
+
+/**
+ * Returns number of slots in the table of `map`. Only part of them, given by
+ * the maximum load factor, can be filled before the table is expanded.
+ * While the map is stored inline, this is the number of inline slots (8).
+ *
+ * @param[in] map cutil_Map backed by a HashMap
+ *
+ * @return number of slots, or 0 if map is NULL
+ */
+size_t
+cutil_HashMap_get_capacity(const cutil_Map *map);
+
+/**
+ * Configures how the hash map grows. With `step` 0 (default), all entries are
+ * rehashed at once when the load factor threshold is reached. Otherwise, the
+ * old table is kept alongside the new one and `step` of its slots are
+ * migrated on every insertion and removal, bounding the latency of single
+ * operations. If `on_lookup` is set, lookups perform migration steps as well,
+ * unless iterators of the map are alive.
+ *
+ * Switching to eager mode finishes any pending migration.
+ *
+ * @param[in] map cutil_Map backed by a HashMap
+ * @param[in] step number of slots migrated per operation, or 0 for eager
+ * @param[in] on_lookup whether lookups migrate slots as well
+ *
+ * @return error code
+ *
+ * @note `step` is raised to more than 1 / max load factor slots (2 for the
+ *       default), which guarantees that a migration finishes before the next
+ *       one is due.
+ */
+cutil_Status
+cutil_HashMap_set_incremental_resize(
+  cutil_Map *map, size_t step, cutil_Bool on_lookup
+);
+
+/**
+ * Declares whether `map` is read by several threads at once, for instance
+ * under a shared lock. Const operations on such a map never write to it:
+ * lookup counters are not updated, iterators are not tracked and lookups do
+ * not migrate entries, even if requested via
+ * 'cutil_HashMap_set_incremental_resize'.
+ *
+ * @param[in] map cutil_Map backed by a HashMap
+ * @param[in] enabled whether const operations may run concurrently
+ *
+ * @return error code
+ *
+ * @note Must not be changed while iterators of `map` are alive.
+ */
+cutil_Status
+cutil_HashMap_set_concurrent_reads(cutil_Map *map, cutil_Bool enabled);
+
+/**
+ * Returns whether an incremental resize of `map` is in progress.
+ *
+ * @param[in] map cutil_Map backed by a HashMap
+ *
+ * @return CUTIL_TRUE if entries remain to be migrated
+ */
+cutil_Bool
+cutil_HashMap_is_resizing(const cutil_Map *map);
+
+/**
+ * Writes layout statistics and lookup counters of `map` to `stats`. Probe
+ * lengths are recomputed from the table, which takes time linear in its
+ * capacity.
+ *
+ * @param[in] map cutil_Map backed by a HashMap
+ * @param[out] stats statistics of `map`
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_HashMap_get_stats(const cutil_Map *map, cutil_HashMapStats *stats);
+
+/**
+ * Sets the values of `num` keys at once, as if by 'cutil_Map_set' for each
+ * pair in order, so a later value replaces an earlier one for equal keys.
+ * The table is sized once for all new keys up front, and keys are hashed in
+ * batches whose slots are prefetched before they are probed.
+ *
+ * @param[in, out] map cutil_Map backed by a HashMap
+ * @param[in] keys contiguous array of `num` keys
+ * @param[in] vals contiguous array of `num` values
+ * @param[in] num number of entries to set
+ *
+ * @return error code
+ *
+ * @note Space is reserved for `num` new keys, so many duplicate keys leave
+ *       the table larger than needed; see 'cutil_Map_shrink_to_fit'.
+ */
+cutil_Status
+cutil_HashMap_set_mult(
+  cutil_Map *map, const void *keys, const void *vals, size_t num
+);
+
+/**
+ * Constructs a hash map from the parallel arrays `keys` and `vals`, see
+ * 'cutil_HashMap_set_mult'. Key and value types are taken from the arrays.
+ *
+ * @param[in] keys cutil_Array of keys
+ * @param[in] vals cutil_Array of values with the same capacity as `keys`
+ *
+ * @return newly malloc'd cutil_Map object, or NULL on invalid arguments
+ */
+cutil_Map *
+cutil_HashMap_from_arrays(const cutil_Array *keys, const cutil_Array *vals);
+
+/**
+ * Same as 'cutil_HashMap_from_arrays', but builds the map with up to
+ * `num_threads` threads. Keys are hashed and partitioned by the region of
+ * the table their probe sequence starts in, and the threads fill disjoint
+ * regions. The few entries that probe beyond their region are inserted
+ * sequentially afterwards.
+ *
+ * The hash, comparison and copy functions of the key and value types are
+ * called concurrently and must not modify shared state.
+ *
+ * @param[in] keys cutil_Array of keys
+ * @param[in] vals cutil_Array of values with the same capacity as `keys`
+ * @param[in] num_threads maximal number of threads to use, falls back to
+ *   'cutil_HashMap_from_arrays' if 1 or if there are too few entries
+ *
+ * @return newly malloc'd cutil_Map object, or NULL on invalid arguments
+ */
+cutil_Map *
+cutil_HashMap_from_arrays_parallel(
+  const cutil_Array *keys, const cutil_Array *vals, size_t num_threads
+);
+
 #ifdef __cplusplus
 }
 #endif
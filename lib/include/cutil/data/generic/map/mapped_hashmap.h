@@ -0,0 +1,89 @@
+/** cutil/generic/map/mapped_hashmap.h
+ *
+ * Header for a read-only hash map backed by a memory-mapped file.
+ */
+
+#ifndef CUTIL_GENERIC_MAP_MAPPED_HASHMAP_H_INCLUDED
+#define CUTIL_GENERIC_MAP_MAPPED_HASHMAP_H_INCLUDED
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/map.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_MapType' for a memory-mapped hash map.
+ *
+ * The map is a read-only view of a file written by
+ * 'cutil_MappedHashMap_write'. The file starts with a header describing the
+ * key and value types and the table layout, followed by the `hashes`, `keys`
+ * and `vals` arrays of an open-addressing table with linear probing, each at
+ * a cache-line aligned offset. Opening the file maps it into memory without
+ * reading it, so pages are only loaded when lookups touch them, and processes
+ * mapping the same file share its pages in the page cache.
+ *
+ * Operations that would modify the map (set, remove, get_or_insert and
+ * removal through iterators) fail.
+ */
+extern const cutil_MapType *const CUTIL_MAP_TYPE_MAPPED_HASHMAP;
+
+/**
+ * 'cutil_ConstIteratorType' for a memory-mapped hash map iterator
+ * (read-only).
+ */
+extern const cutil_ConstIteratorType
+  *const CUTIL_CONST_ITERATOR_TYPE_MAPPED_HASHMAP;
+
+/**
+ * 'cutil_IteratorType' for a memory-mapped hash map iterator (cannot
+ * remove).
+ */
+extern const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_MAPPED_HASHMAP;
+
+/**
+ * Writes the entries of `map` to the file at `path` in the format read by
+ * 'cutil_MappedHashMap_open'. The file is written under a temporary name and
+ * renamed to `path` afterwards, so processes that still map a previous
+ * version of the file keep a consistent view.
+ *
+ * The key and value types of `map` must be trivially copyable, and the hash
+ * function of the key type must yield the same hashes in every process.
+ *
+ * @param[in] map cutil_Map of any type to write
+ * @param[in] path file to write to
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_MappedHashMap_write(const cutil_Map *map, const char *path);
+
+/**
+ * Opens the file at `path` written by 'cutil_MappedHashMap_write' as a
+ * read-only 'cutil_Map'. Entries are neither read nor copied, lookups access
+ * the mapped file directly.
+ *
+ * @param[in] path file to open
+ * @param[in] key_type cutil_GenericType of keys, must match name and size
+ *   of the key type the file was written with
+ * @param[in] val_type cutil_GenericType of vals, must match name and size
+ *   of the value type the file was written with
+ *
+ * @return newly malloc'd cutil_Map, or NULL if the file could not be mapped
+ *   or does not match the types
+ */
+cutil_Map *
+cutil_MappedHashMap_open(
+  const char *path,
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_MAP_MAPPED_HASHMAP_H_INCLUDED */
@@ -0,0 +1,60 @@
+/** cutil/generic/map/persistent_hashmap.h
+ *
+ * Header for arbitrarily typed hash map with structural sharing.
+ */
+
+#ifndef CUTIL_GENERIC_MAP_PERSISTENT_HASHMAP_H_INCLUDED
+#define CUTIL_GENERIC_MAP_PERSISTENT_HASHMAP_H_INCLUDED
+
+#include <cutil/data/generic/map.h>
+#include <cutil/data/generic/type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_MapType' for a persistent hash map.
+ *
+ * Entries are stored in a hash array mapped trie whose nodes are reference
+ * counted and shared between maps. Duplicating or copying a map only shares
+ * the root in O(1). Modifying a map afterwards copies the O(log n) nodes on
+ * the path to the modified entry, while all other nodes stay shared.
+ *
+ * Iterators traverse the contents of the map at the time they were created
+ * or last rewound, so the map may be modified during iteration.
+ *
+ * Reference counts are not atomic, so maps sharing nodes must not be
+ * modified from different threads.
+ */
+extern const cutil_MapType *const CUTIL_MAP_TYPE_PERSISTENT_HASHMAP;
+
+/**
+ * 'cutil_ConstIteratorType' for a persistent hash map iterator (read-only).
+ */
+extern const cutil_ConstIteratorType
+  *const CUTIL_CONST_ITERATOR_TYPE_PERSISTENT_HASHMAP;
+
+/**
+ * 'cutil_IteratorType' for a persistent hash map iterator (read-write).
+ */
+extern const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_PERSISTENT_HASHMAP;
+
+/**
+ * Constructor for 'cutil_Map' with key type and value type.
+ *
+ * @param[in] key_type cutil_GenericType of keys
+ * @param[in] val_type cutil_GenericType of vals
+ *
+ * @return newly malloc'd cutil_Map object
+ */
+cutil_Map *
+cutil_PersistentHashMap_alloc(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_MAP_PERSISTENT_HASHMAP_H_INCLUDED */
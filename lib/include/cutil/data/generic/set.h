@@ -19,6 +19,16 @@
 extern "C" {
 #endif
 
+/**
+ * Operations combining two sets, see 'cutil_Set_combine'.
+ */
+typedef enum {
+    CUTIL_SET_OP_UNION,        /**< elements in either set */
+    CUTIL_SET_OP_INTERSECTION, /**< elements in both sets */
+    CUTIL_SET_OP_DIFFERENCE,   /**< elements in the first set only */
+    CUTIL_SET_OP_SYMDIFF,      /**< elements in exactly one of the sets */
+} cutil_SetOp;
+
 /**
  * Type (vtable) for cutil sets.
  */
@@ -30,11 +40,26 @@ typedef struct {
     void *(*const duplicate)(const void *data);
     size_t (*const get_count)(const void *data);
     cutil_Bool (*const contains)(const void *data, const void *elem);
+    cutil_Status (*const contains_batch)(
+      const void *data, const void *elems, size_t num_elems, cutil_Bool *res
+    );
     cutil_Status (*const add)(void *data, const void *elem);
+    cutil_Status (*const insert_if_absent)(
+      void *data, const void *elem, cutil_Bool *inserted
+    );
     cutil_Status (*const remove)(void *data, const void *elem);
+    cutil_Status (*const reserve)(void *data, size_t count);
+    cutil_Status (*const shrink_to_fit)(void *data);
     const cutil_GenericType *(*const get_elem_type)(const void *data);
     cutil_ConstIterator *(*const get_const_iterator)(const void *data);
     cutil_Iterator *(*const get_iterator)(void *data);
+    cutil_hash_t (*const hash)(const void *data); /**< optional */
+    cutil_Status (*const combine)(
+      void *dst, const void *src, cutil_SetOp op
+    ); /**< optional, `src` is of the same type */
+    void *(*const combine_new)(
+      const void *lhs, const void *rhs, cutil_SetOp op
+    ); /**< optional, `rhs` is of the same type */
 } cutil_SetType;
 
 /**
@@ -197,6 +222,24 @@ cutil_Set_contains(const cutil_Set *set, const void *elem)
     return set->vtable->contains(set->data, elem);
 }
 
+/**
+ * Checks for `num_elems` elements stored contiguously in `elems` whether they
+ * are contained in `set` and writes the results to `res`. Sets may overlap the
+ * memory accesses of several lookups; otherwise, this falls back to
+ * 'cutil_Set_contains' for each element.
+ *
+ * @param[in] set cutil_Set to search in
+ * @param[in] elems array of `num_elems` elements of the set's element type
+ * @param[in] num_elems number of elements to search for
+ * @param[out] res array of `num_elems` results
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_Set_contains_batch(
+  const cutil_Set *set, const void *elems, size_t num_elems, cutil_Bool *res
+);
+
 /**
  * Adds `elem` to `set`.
  *
@@ -214,6 +257,22 @@ cutil_Set_add(cutil_Set *set, const void *elem)
     return set->vtable->add(set->data, elem);
 }
 
+/**
+ * Adds `elem` to `set` unless it is already contained. Unlike 'cutil_Set_add',
+ * duplicates are not reported. Sets may do this with a single lookup;
+ * otherwise, this falls back to 'cutil_Set_contains' and 'cutil_Set_add'.
+ *
+ * @param[in] set cutil_Set to add element to
+ * @param[in] elem element to be added
+ * @param[out] inserted whether `elem` was added, may be NULL
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_Set_insert_if_absent(
+  cutil_Set *set, const void *elem, cutil_Bool *inserted
+);
+
 /**
  * Removes `elem` from `set`.
  *
@@ -231,6 +290,39 @@ cutil_Set_remove(cutil_Set *set, const void *elem)
     return set->vtable->remove(set->data, elem);
 }
 
+/**
+ * Prepares `set` to hold at least `count` elements without reallocating.
+ *
+ * @param[in] set cutil_Set to reserve space in
+ * @param[in] count number of elements to reserve space for
+ *
+ * @return error code
+ */
+inline cutil_Status
+cutil_Set_reserve(cutil_Set *set, size_t count)
+{
+    CUTIL_NULL_CHECKS_SET(set);
+    CUTIL_NULL_CHECK_VTABLE(set->vtable, reserve);
+    CUTIL_RETURN_VAL_IF_NULL(set->vtable->reserve, CUTIL_STATUS_FAILURE);
+    return set->vtable->reserve(set->data, count);
+}
+
+/**
+ * Releases memory of `set` that is not needed for its current elements.
+ *
+ * @param[in] set cutil_Set to shrink
+ *
+ * @return error code
+ */
+inline cutil_Status
+cutil_Set_shrink_to_fit(cutil_Set *set)
+{
+    CUTIL_NULL_CHECKS_SET(set);
+    CUTIL_NULL_CHECK_VTABLE(set->vtable, shrink_to_fit);
+    CUTIL_RETURN_VAL_IF_NULL(set->vtable->shrink_to_fit, CUTIL_STATUS_FAILURE);
+    return set->vtable->shrink_to_fit(set->data);
+}
+
 /**
  * Returns element type of `set`.
  *
@@ -284,6 +376,153 @@ cutil_Set_get_iterator(cutil_Set *set)
     return set->vtable->get_iterator(set->data);
 }
 
+/**
+ * Replaces `dst` with the result of applying `op` to `dst` and `src`, which
+ * must have the same element type. Sets of the same type may combine their
+ * tables directly, probing the smaller operand and sizing the result once;
+ * otherwise, this falls back to iterating one set and looking up its elements
+ * in the other. Iterators over `dst` are invalidated.
+ *
+ * @param[in] dst cutil_Set to combine into
+ * @param[in] src cutil_Set to combine with
+ * @param[in] op operation to apply
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_Set_combine(cutil_Set *dst, const cutil_Set *src, cutil_SetOp op);
+
+/**
+ * Returns a newly malloc'd set of the same type as `lhs` holding the result of
+ * applying `op` to `lhs` and `rhs`, which must have the same element type. See
+ * 'cutil_Set_combine'.
+ *
+ * @param[in] lhs left-hand operand
+ * @param[in] rhs right-hand operand
+ * @param[in] op operation to apply
+ *
+ * @return newly malloc'd cutil_Set, or NULL on failure
+ */
+cutil_Set *
+cutil_Set_combine_new(
+  const cutil_Set *lhs, const cutil_Set *rhs, cutil_SetOp op
+);
+
+/**
+ * Adds all elements of `src` to `dst`.
+ *
+ * @param[in] dst cutil_Set to add elements to
+ * @param[in] src cutil_Set whose elements are added
+ *
+ * @return error code
+ */
+inline cutil_Status
+cutil_Set_union(cutil_Set *dst, const cutil_Set *src)
+{
+    return cutil_Set_combine(dst, src, CUTIL_SET_OP_UNION);
+}
+
+/**
+ * Removes all elements from `dst` that are not contained in `src`.
+ *
+ * @param[in] dst cutil_Set to remove elements from
+ * @param[in] src cutil_Set whose elements are kept
+ *
+ * @return error code
+ */
+inline cutil_Status
+cutil_Set_intersect(cutil_Set *dst, const cutil_Set *src)
+{
+    return cutil_Set_combine(dst, src, CUTIL_SET_OP_INTERSECTION);
+}
+
+/**
+ * Removes all elements from `dst` that are contained in `src`.
+ *
+ * @param[in] dst cutil_Set to remove elements from
+ * @param[in] src cutil_Set whose elements are removed
+ *
+ * @return error code
+ */
+inline cutil_Status
+cutil_Set_difference(cutil_Set *dst, const cutil_Set *src)
+{
+    return cutil_Set_combine(dst, src, CUTIL_SET_OP_DIFFERENCE);
+}
+
+/**
+ * Removes all elements from `dst` that are contained in `src` and adds those
+ * of `src` that were not contained in `dst`.
+ *
+ * @param[in] dst cutil_Set to combine into
+ * @param[in] src cutil_Set whose elements are toggled
+ *
+ * @return error code
+ */
+inline cutil_Status
+cutil_Set_symdiff(cutil_Set *dst, const cutil_Set *src)
+{
+    return cutil_Set_combine(dst, src, CUTIL_SET_OP_SYMDIFF);
+}
+
+/**
+ * Returns a newly malloc'd set holding the elements of `lhs` and `rhs`.
+ *
+ * @param[in] lhs left-hand operand
+ * @param[in] rhs right-hand operand
+ *
+ * @return newly malloc'd cutil_Set, or NULL on failure
+ */
+inline cutil_Set *
+cutil_Set_union_new(const cutil_Set *lhs, const cutil_Set *rhs)
+{
+    return cutil_Set_combine_new(lhs, rhs, CUTIL_SET_OP_UNION);
+}
+
+/**
+ * Returns a newly malloc'd set holding the elements both in `lhs` and `rhs`.
+ *
+ * @param[in] lhs left-hand operand
+ * @param[in] rhs right-hand operand
+ *
+ * @return newly malloc'd cutil_Set, or NULL on failure
+ */
+inline cutil_Set *
+cutil_Set_intersect_new(const cutil_Set *lhs, const cutil_Set *rhs)
+{
+    return cutil_Set_combine_new(lhs, rhs, CUTIL_SET_OP_INTERSECTION);
+}
+
+/**
+ * Returns a newly malloc'd set holding the elements of `lhs` that are not in
+ * `rhs`.
+ *
+ * @param[in] lhs left-hand operand
+ * @param[in] rhs right-hand operand
+ *
+ * @return newly malloc'd cutil_Set, or NULL on failure
+ */
+inline cutil_Set *
+cutil_Set_difference_new(const cutil_Set *lhs, const cutil_Set *rhs)
+{
+    return cutil_Set_combine_new(lhs, rhs, CUTIL_SET_OP_DIFFERENCE);
+}
+
+/**
+ * Returns a newly malloc'd set holding the elements in exactly one of `lhs`
+ * and `rhs`.
+ *
+ * @param[in] lhs left-hand operand
+ * @param[in] rhs right-hand operand
+ *
+ * @return newly malloc'd cutil_Set, or NULL on failure
+ */
+inline cutil_Set *
+cutil_Set_symdiff_new(const cutil_Set *lhs, const cutil_Set *rhs)
+{
+    return cutil_Set_combine_new(lhs, rhs, CUTIL_SET_OP_SYMDIFF);
+}
+
 /**
  * Returns whether Sets `lhs` and `rhs` contain exactly the same elements, as
  * determined by `cutil_Set_contains`. Both NULL or the same pointer compare
@@ -312,7 +551,9 @@ cutil_Set_compare(const cutil_Set *lhs, const cutil_Set *rhs);
 
 /**
  * Computes an order-independent hash of `set` by XOR-folding the hash of
- * each element. Returns CUTIL_HASH_C(0) for NULL or an empty set.
+ * each element. Returns CUTIL_HASH_C(0) for NULL or an empty set. Sets whose
+ * type implements `hash` maintain this value on modification and return it
+ * without iterating.
  *
  * @param[in] set Set to hash
  *
@@ -0,0 +1,102 @@
+/** cutil/data/generic/set/bitset.h
+ *
+ * Header for sets of small unsigned integers stored as bit vectors.
+ */
+
+#ifndef CUTIL_GENERIC_SET_BITSET_H_INCLUDED
+#define CUTIL_GENERIC_SET_BITSET_H_INCLUDED
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/set.h>
+#include <cutil/data/generic/type.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_SetType' for a bit set.
+ *
+ * Elements are of an unsigned integer type, and element `i` is contained if
+ * bit `i` of a vector of 64-bit words is set. An element thus takes a single
+ * bit and is looked up in constant time, which suits dense elements under a
+ * known bound, such as IDs. Every set has a bound, and elements at or above it
+ * are rejected, as are combinations that would produce them. The vector grows
+ * to hold the largest element added so far, but never beyond the bound.
+ *
+ * Counting works on whole words via population counts, iteration skips to the
+ * next set bit of each word, and combining two bit sets via
+ * 'cutil_Set_combine' applies the operation word by word.
+ *
+ * 'cutil_Set_reserve' prepares the set to hold all elements smaller than the
+ * given count, which may not exceed the bound, without reallocating.
+ * Duplicates and copies take over the bound of their source.
+ */
+extern const cutil_SetType *const CUTIL_SET_TYPE_BITSET;
+
+/**
+ * 'cutil_ConstIteratorType' for a bit set iterator (read-only).
+ */
+extern const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_BITSET;
+
+/**
+ * 'cutil_IteratorType' for a bit set iterator (read-write).
+ */
+extern const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_BITSET;
+
+/**
+ * Constructor for 'cutil_Set' backed by a bit set with element type
+ * `elem_type`, which has to be one of the unsigned integer types. Elements
+ * have to be smaller than 2^24, or the number of values of `elem_type` if that
+ * is less, so that the vector takes at most 2 MiB; see
+ * 'cutil_BitSet_alloc_with_bound' for other bounds.
+ *
+ * @param[in] elem_type cutil_GenericType of elements
+ *
+ * @return newly malloc'd cutil_Set object, or NULL on invalid arguments
+ */
+cutil_Set *
+cutil_BitSet_alloc(const cutil_GenericType *elem_type);
+
+/**
+ * Constructor for 'cutil_Set' backed by a bit set with element type
+ * `elem_type` whose elements have to be smaller than `bound`. Space for all
+ * of them is allocated up front, so the set never reallocates when elements
+ * are added.
+ *
+ * @param[in] elem_type cutil_GenericType of elements
+ * @param[in] bound positive upper bound (exclusive) of elements, lowered to
+ *   the number of values of `elem_type` if that is less
+ *
+ * @return newly malloc'd cutil_Set object, or NULL on invalid arguments or if
+ *   the vector cannot be allocated
+ */
+cutil_Set *
+cutil_BitSet_alloc_with_bound(const cutil_GenericType *elem_type, size_t bound);
+
+/**
+ * Returns the exclusive upper bound of elements of `set`.
+ *
+ * @param[in] set cutil_Set backed by a bit set
+ *
+ * @return bound of elements, or 0 if set is NULL
+ */
+size_t
+cutil_BitSet_get_bound(const cutil_Set *set);
+
+/**
+ * Returns number of bits allocated for `set`, i.e., the exclusive upper bound
+ * of elements that can be added without reallocating.
+ *
+ * @param[in] set cutil_Set backed by a bit set
+ *
+ * @return number of bits, or 0 if set is NULL
+ */
+size_t
+cutil_BitSet_get_capacity(const cutil_Set *set);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_SET_BITSET_H_INCLUDED */
@@ -0,0 +1,66 @@
+/** cutil/data/generic/set/flatset.h
+ *
+ * Header for arbitrarily typed ordered set backed by a sorted array.
+ */
+
+#ifndef CUTIL_GENERIC_SET_FLATSET_H_INCLUDED
+#define CUTIL_GENERIC_SET_FLATSET_H_INCLUDED
+
+#include <cutil/data/generic/array.h>
+#include <cutil/data/generic/map/flatmap.h>
+#include <cutil/data/generic/set.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/status.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_SetType' for a flat set. It uses the sorted key array of
+ * 'CUTIL_MAP_TYPE_FLATMAP' without storing values, and shares its behavior
+ * otherwise. Combining two flat sets via 'cutil_Set_combine' merges their
+ * arrays in a single pass.
+ */
+extern const cutil_SetType *const CUTIL_SET_TYPE_FLATSET;
+
+/**
+ * Constructor for 'cutil_Set' with element type.
+ *
+ * @param[in] elem_type cutil_GenericType of elements
+ *
+ * @return newly malloc'd cutil_Set object, or NULL on invalid arguments
+ */
+cutil_Set *
+cutil_FlatSet_alloc(const cutil_GenericType *elem_type);
+
+/**
+ * Inserts the `num` elements of `elems` that are not yet in `set`. The
+ * elements are sorted and deduplicated once and merged with the elements of
+ * `set` in a single pass, see 'cutil_FlatMap_set_mult'.
+ *
+ * @param[in, out] set cutil_Set backed by a FlatSet
+ * @param[in] elems contiguous array of `num` elements
+ * @param[in] num number of elements to insert
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_FlatSet_add_mult(cutil_Set *set, const void *elems, size_t num);
+
+/**
+ * Constructs a flat set holding the elements of `elems`, ignoring duplicates,
+ * see 'cutil_FlatSet_add_mult'. The element type is taken from the array.
+ *
+ * @param[in] elems cutil_Array of elements
+ *
+ * @return newly malloc'd cutil_Set object, or NULL on invalid arguments
+ */
+cutil_Set *
+cutil_FlatSet_from_array(const cutil_Array *elems);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_SET_FLATSET_H_INCLUDED */
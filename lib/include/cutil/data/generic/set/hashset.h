@@ -6,6 +6,8 @@
 #ifndef CUTIL_GENERIC_SET_HASHSET_H_INCLUDED
 #define CUTIL_GENERIC_SET_HASHSET_H_INCLUDED
 
+#include <cutil/data/generic/list.h>
+#include <cutil/data/generic/map/hashmap.h>
 #include <cutil/data/generic/set.h>
 #include <cutil/data/generic/type.h>
 
@@ -14,7 +16,8 @@ extern "C" {
 #endif
 
 /**
- * 'cutil_SetType' for a hash set.
+ * 'cutil_SetType' for a hash set. It uses the table of 'CUTIL_MAP_TYPE_HASHMAP'
+ * without storing values, and shares its behavior otherwise.
  */
 extern const cutil_SetType *const CUTIL_SET_TYPE_HASHSET;
 
@@ -29,6 +32,70 @@ extern const cutil_SetType *const CUTIL_SET_TYPE_HASHSET;
 cutil_Set *
 cutil_HashSet_alloc(const cutil_GenericType *elem_type);
 
+/**
+ * Constructor for 'cutil_Set' with element type that can hold `capacity`
+ * elements without rehashing. The table is expanded once `max_load_factor` of
+ * its slots are in use.
+ *
+ * @param[in] elem_type cutil_GenericType of elements
+ * @param[in] capacity number of elements to reserve space for
+ * @param[in] max_load_factor maximum share of used slots, in (0, 7/8]
+ *
+ * @return newly malloc'd cutil_Set object, or NULL on invalid arguments
+ */
+cutil_Set *
+cutil_HashSet_alloc_with_capacity(
+  const cutil_GenericType *elem_type, size_t capacity, double max_load_factor
+);
+
+/**
+ * Returns number of slots in the table of `set`.
+ *
+ * @param[in] set cutil_Set backed by a HashSet
+ *
+ * @return number of slots, or 0 if set is NULL
+ */
+size_t
+cutil_HashSet_get_capacity(const cutil_Set *set);
+
+/**
+ * Writes layout statistics and lookup counters of `set` to `stats`, see
+ * 'cutil_HashMap_get_stats'.
+ *
+ * @param[in] set cutil_Set backed by a HashSet
+ * @param[out] stats statistics of `set`
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_HashSet_get_stats(const cutil_Set *set, cutil_HashMapStats *stats);
+
+/**
+ * Inserts the `num` elements of `elems` that are not yet in `set`. The table
+ * is sized once for all elements, and elements are hashed in batches whose
+ * slots are prefetched before they are probed, see 'cutil_HashMap_set_mult'.
+ *
+ * @param[in, out] set cutil_Set backed by a HashSet
+ * @param[in] elems contiguous array of `num` elements
+ * @param[in] num number of elements to insert
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_HashSet_add_mult(cutil_Set *set, const void *elems, size_t num);
+
+/**
+ * Constructs a hash set holding the elements of `list`, ignoring duplicates.
+ * The table is sized once for all elements, and elements of an ArrayList are
+ * inserted via 'cutil_HashSet_add_mult'.
+ *
+ * @param[in] list cutil_List to take elements from
+ *
+ * @return newly malloc'd cutil_Set object, or NULL on invalid arguments
+ */
+cutil_Set *
+cutil_HashSet_from_list(const cutil_List *list);
+
 /**
  * 'cutil_GenericType' instances for 'cutil_HashSet' with native element types.
  */
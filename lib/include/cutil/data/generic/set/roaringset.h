@@ -0,0 +1,103 @@
+/** cutil/data/generic/set/roaringset.h
+ *
+ * Header for compressed sets of 32-bit unsigned integers (Roaring bitmaps).
+ */
+
+#ifndef CUTIL_GENERIC_SET_ROARINGSET_H_INCLUDED
+#define CUTIL_GENERIC_SET_ROARINGSET_H_INCLUDED
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/set.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/status.h>
+#include <cutil/std/stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * 'cutil_SetType' for a Roaring bitmap with elements of type
+ * 'CUTIL_GENERIC_TYPE_U32'.
+ *
+ * Elements are partitioned by their upper 16 bits into chunks of 2^16 values,
+ * and the lower 16 bits of the elements of each chunk are stored in a
+ * container of one of three kinds, whichever is smaller: a sorted array of up
+ * to 4096 values, a bitmap of 2^16 bits, or a sorted array of runs of
+ * consecutive values. Containers of sparse chunks thus take 2 bytes per
+ * element, those of dense chunks at most 8 kB, and those of clustered chunks
+ * 4 bytes per run. Containers are only converted to runs by
+ * 'cutil_RoaringSet_run_optimize'.
+ *
+ * 'cutil_Set_combine' operates container by container. Containers present in
+ * only one operand are moved or copied as a whole, and intersections of
+ * arrays are vectorized where SSE2 is available.
+ *
+ * 'cutil_Set_reserve' has no effect, as containers are allocated by chunk.
+ */
+extern const cutil_SetType *const CUTIL_SET_TYPE_ROARING;
+
+/**
+ * 'cutil_ConstIteratorType' for a Roaring bitmap iterator (read-only). Elements
+ * are visited in ascending order.
+ */
+extern const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_ROARING;
+
+/**
+ * 'cutil_IteratorType' for a Roaring bitmap iterator (read-write). Elements
+ * are visited in ascending order.
+ */
+extern const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_ROARING;
+
+/**
+ * Constructor for an empty 'cutil_Set' backed by a Roaring bitmap.
+ *
+ * @return newly malloc'd cutil_Set object
+ */
+cutil_Set *
+cutil_RoaringSet_alloc(void);
+
+/**
+ * Converts the containers of `set` that are smaller as runs of consecutive
+ * values to run containers, and run containers that are not to array or
+ * bitmap containers.
+ *
+ * @param[in, out] set cutil_Set backed by a Roaring bitmap
+ *
+ * @return error code
+ */
+cutil_Status
+cutil_RoaringSet_run_optimize(cutil_Set *set);
+
+/**
+ * Serializes `set` into `buf` in the portable Roaring format shared with other
+ * Roaring implementations, with all integers in little-endian byte order.
+ * Pass buf=NULL with buflen=0 to query the required buffer size.
+ *
+ * @param[in] set cutil_Set backed by a Roaring bitmap
+ * @param[out] buf destination buffer, or NULL to query required size
+ * @param[in] buflen size of destination buffer in bytes, or 0 when querying
+ *
+ * @return number of bytes written, or required size when buf is NULL, or
+ *         CUTIL_ERROR_SIZE if buflen is too small
+ */
+size_t
+cutil_RoaringSet_serialize(const cutil_Set *set, void *buf, size_t buflen);
+
+/**
+ * Constructs a set from `buflen` bytes of `buf` in the portable Roaring format
+ * written by 'cutil_RoaringSet_serialize'.
+ *
+ * @param[in] buf serialized Roaring bitmap
+ * @param[in] buflen size of `buf` in bytes
+ *
+ * @return newly malloc'd cutil_Set object, or NULL if `buf` is malformed
+ */
+cutil_Set *
+cutil_RoaringSet_deserialize(const void *buf, size_t buflen);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_GENERIC_SET_ROARINGSET_H_INCLUDED */
@@ -84,6 +84,11 @@ cutil_void_memswap(void *a, void *b, size_t size)
  * special actions. 'copy' is then replaced by 'memcpy', while 'init' and
  * 'clear' are no-ops. For 'hash', 'comp', 'deep_equals', and 'to_string',
  * fallback implementations are used.
+ *
+ * 'hash_seeded' must agree with 'comp' like 'hash' does. Types whose 'hash'
+ * collides for many objects regardless of any seed mixed in afterwards (e.g.,
+ * 32-bit string hashes) should provide it, so that hash tables can make such
+ * collisions depend on their seed.
  */
 typedef struct {
     const char *const name;         /**< Name of the type */
@@ -97,6 +102,7 @@ typedef struct {
     cutil_HashFunc *const hash; /**< Hash function */
     /**< Serialization function */
     size_t (*const to_string)(const void *data, char *buf, size_t buflen);
+    cutil_SeededHashFunc *const hash_seeded; /**< Seeded hash function */
 } cutil_GenericType;
 
 /**
@@ -138,6 +144,22 @@ cutil_GenericType_get_size(const cutil_GenericType *type)
 cutil_Bool
 cutil_GenericType_is_valid(const cutil_GenericType *type);
 
+/**
+ * Returns whether objects of `type` are trivially copyable, i.e., if `type`
+ * has neither 'init', 'clear' nor 'copy' functions, so that objects can be
+ * copied bytewise and need no cleanup.
+ *
+ * @param[in] type cutil_GenericType to check
+ *
+ * @return is `type` trivially copyable?
+ */
+inline cutil_Bool
+cutil_GenericType_is_trivially_copyable(const cutil_GenericType *type)
+{
+    CUTIL_NULL_CHECK(type);
+    return type->init == NULL && type->clear == NULL && type->copy == NULL;
+}
+
 /**
  * Returns whether `lhs` is equal to `rhs`.
  *
@@ -361,6 +383,52 @@ cutil_GenericType_apply_hash(const cutil_GenericType *type, const void *data)
     return type->hash(data);
 }
 
+/**
+ * Returns hash of `data` that depends on `seed`. Applies the seeded hash
+ * function of `type` if specified, hashes the raw bytes of `data` with `seed`
+ * if `type` has no hash function, and combines the hash of `data` with `seed`
+ * otherwise.
+ *
+ * @param[in] type cutil_GenericType describing the object
+ * @param[in] data pointer to object to hash
+ * @param[in] seed seed to mix into the hash
+ *
+ * @return seeded hash value for `data`
+ *
+ * @note In the last case, objects with equal hashes still collide under
+ *       every seed; see 'cutil_GenericType_has_seeded_hash'.
+ */
+inline cutil_hash_t
+cutil_GenericType_apply_hash_seeded(
+  const cutil_GenericType *type, const void *data, cutil_hash_t seed
+)
+{
+    CUTIL_NULL_CHECK(type);
+    if (type->hash_seeded != NULL) {
+        return type->hash_seeded(data, seed);
+    }
+    if (type->hash == NULL) {
+        return cutil_hash_bytes(data, type->size, seed);
+    }
+    return type->hash(data) ^ seed;
+}
+
+/**
+ * Returns whether 'cutil_GenericType_apply_hash_seeded' mixes the seed into
+ * the hashing of objects of `type` itself, rather than combining it with
+ * their unseeded hash.
+ *
+ * @param[in] type cutil_GenericType to check
+ *
+ * @return CUTIL_TRUE if `type` has a seeded or no hash function
+ */
+inline cutil_Bool
+cutil_GenericType_has_seeded_hash(const cutil_GenericType *type)
+{
+    CUTIL_NULL_CHECK(type);
+    return type->hash_seeded != NULL || type->hash == NULL;
+}
+
 /**
  * Fallback serialization implementation for `type` that outputs 'name#hash'.
  * Follows the snprintf pattern: when `buf` is NULL with `buflen` 0, returns
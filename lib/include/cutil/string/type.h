@@ -175,6 +175,19 @@ cutil_String_compare_generic(const void *lhs, const void *rhs);
 cutil_hash_t
 cutil_String_hash_generic(const void *s);
 
+/**
+ * Seeded version of cutil_String_hash_generic, hashing the characters together
+ * with `seed`, so that strings colliding under one seed are unlikely to
+ * collide under another.
+ *
+ * @param[in] s cutil_String to hash
+ * @param[in] seed seed to mix into the hash
+ *
+ * @return hash value
+ */
+cutil_hash_t
+cutil_String_hash_seeded_generic(const void *s, cutil_hash_t seed);
+
 /**
  * Generic (void-argument) version of cutil_String_to_string.
  *
@@ -357,6 +370,19 @@ cutil_StringView_compare_generic(const void *lhs, const void *rhs);
 cutil_hash_t
 cutil_StringView_hash_generic(const void *sv);
 
+/**
+ * Seeded version of cutil_StringView_hash_generic, hashing the characters
+ * together with `seed`, so that strings colliding under one seed are unlikely
+ * to collide under another.
+ *
+ * @param[in] sv cutil_StringView to hash
+ * @param[in] seed seed to mix into the hash
+ *
+ * @return hash value
+ */
+cutil_hash_t
+cutil_StringView_hash_seeded_generic(const void *sv, cutil_hash_t seed);
+
 /**
  * Generic (void-argument) version of cutil_StringView_to_string.
  *
@@ -0,0 +1,100 @@
+/** cutil/util/bits.h
+ *
+ * Header for bit-manipulation utilities.
+ */
+
+#ifndef CUTIL_UTIL_BITS_H_INCLUDED
+#define CUTIL_UTIL_BITS_H_INCLUDED
+
+#include <cutil/std/inttypes.h>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include <intrin.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Returns number of trailing zero bits in `val`, i.e., the index of the lowest
+ * set bit. `val` may not be 0.
+ *
+ * @param[in] val value to count trailing zeros of
+ *
+ * @return number of trailing zero bits in `val`
+ */
+inline unsigned int
+cutil_bits_ctz_u64(uint64_t val)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned int) __builtin_ctzll(val);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanForward64(&idx, val);
+    return (unsigned int) idx;
+#else
+    unsigned int res = 0U;
+    while ((val & UINT64_C(1)) == 0U) {
+        val >>= 1;
+        ++res;
+    }
+    return res;
+#endif
+}
+
+/**
+ * Returns number of leading zero bits in `val`, i.e., 63 minus the index of
+ * the highest set bit. `val` may not be 0.
+ *
+ * @param[in] val value to count leading zeros of
+ *
+ * @return number of leading zero bits in `val`
+ */
+inline unsigned int
+cutil_bits_clz_u64(uint64_t val)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned int) __builtin_clzll(val);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long idx;
+    _BitScanReverse64(&idx, val);
+    return (unsigned int) (63UL - idx);
+#else
+    unsigned int res = 0U;
+    while ((val & (UINT64_C(1) << 63)) == 0U) {
+        val <<= 1;
+        ++res;
+    }
+    return res;
+#endif
+}
+
+/**
+ * Returns number of set bits in `val`.
+ *
+ * @param[in] val value to count set bits of
+ *
+ * @return number of set bits in `val`
+ */
+inline unsigned int
+cutil_bits_popcount_u64(uint64_t val)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned int) __builtin_popcountll(val);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return (unsigned int) __popcnt64(val);
+#else
+    val = val - ((val >> 1) & UINT64_C(0x5555555555555555));
+    val = (val & UINT64_C(0x3333333333333333))
+        + ((val >> 2) & UINT64_C(0x3333333333333333));
+    val = (val + (val >> 4)) & UINT64_C(0x0F0F0F0F0F0F0F0F);
+    return (unsigned int) ((val * UINT64_C(0x0101010101010101)) >> 56);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CUTIL_UTIL_BITS_H_INCLUDED */
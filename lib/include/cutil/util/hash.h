@@ -33,6 +33,12 @@ typedef uint64_t cutil_hash_t;
 typedef cutil_hash_t
 cutil_HashFunc(const void *ptr);
 
+/**
+ * Typedef for hash functions that mix a seed into the hashed object
+ */
+typedef cutil_hash_t
+cutil_SeededHashFunc(const void *ptr, cutil_hash_t seed);
+
 /**
  * Returns hash value for byte pattern of length `len` pointed to by `ptr` with
  * seed `seed`.
@@ -81,6 +87,28 @@ cutil_hash_combine(cutil_hash_t seed, cutil_hash_t hash)
     return res;
 }
 
+/**
+ * Scrambles the bits of `hash` so that every input bit affects every output
+ * bit. Useful to turn weak hashes (e.g., the identity hashes for integers)
+ * into ones whose low and high bits are both well distributed.
+ *
+ * @param[in] hash hash to be finalized
+ *
+ * @return finalized hash
+ *
+ * @note Stolen from MurmurHash3 (fmix64)
+ */
+inline cutil_hash_t
+cutil_hash_finalize(cutil_hash_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= CUTIL_HASH_C(0xff51afd7ed558ccd);
+    hash ^= hash >> 33;
+    hash *= CUTIL_HASH_C(0xc4ceb9fe1a85ec53);
+    hash ^= hash >> 33;
+    return hash;
+}
+
 /**
  * Trivial hash function definitions for INTEGER types TYPE. Each function has
  * the suffix ID.
@@ -136,6 +136,18 @@ extern "C" {
 #define CUTIL_STRINGIFY_VAL(MCR) CUTIL_STRINGIFY_VAL_AUX(MCR)
 #define CUTIL_STRINGIFY_VAL_AUX(MCR) #MCR
 
+/**
+ * MACRO for hinting that the memory at ADDR will be read soon. Expands to a
+ * no-op on compilers without prefetch support.
+ *
+ * @param[in] ADDR address to be prefetched
+ */
+#if defined(__GNUC__) || defined(__clang__)
+    #define CUTIL_PREFETCH(ADDR) __builtin_prefetch((ADDR), 0, 3)
+#else
+    #define CUTIL_PREFETCH(ADDR) ((void) (ADDR))
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,41 @@
+#include <cutil/data/generic/filter.h>
+
+#include <cutil/util/compare.h>
+
+cutil_Bool
+cutil_FilterType_equals(
+  const cutil_FilterType *lhs, const cutil_FilterType *rhs
+)
+{
+    return (cutil_compare_bytes(lhs, rhs, sizeof(cutil_FilterType)) == 0);
+}
+
+extern inline const cutil_FilterType *
+cutil_Filter_get_vtable(const cutil_Filter *filter);
+
+extern inline void
+cutil_Filter_clear(cutil_Filter *filter);
+
+extern inline void
+cutil_Filter_free(cutil_Filter *filter);
+
+extern inline void
+cutil_Filter_reset(cutil_Filter *filter);
+
+extern inline size_t
+cutil_Filter_get_count(const cutil_Filter *filter);
+
+extern inline cutil_Bool
+cutil_Filter_contains(const cutil_Filter *filter, const void *elem);
+
+extern inline cutil_Status
+cutil_Filter_add(cutil_Filter *filter, const void *elem);
+
+extern inline cutil_Status
+cutil_Filter_remove(cutil_Filter *filter, const void *elem);
+
+extern inline const cutil_GenericType *
+cutil_Filter_get_elem_type(const cutil_Filter *filter);
+
+extern inline size_t
+cutil_Filter_serialize(const cutil_Filter *filter, void *buf, size_t buflen);
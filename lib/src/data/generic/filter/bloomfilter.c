@@ -0,0 +1,386 @@
+#include <cutil/data/generic/filter/bloomfilter.h>
+
+#include <cutil/cutil.h>
+#include <cutil/io/log.h>
+#include <cutil/status.h>
+#include <cutil/std/inttypes.h>
+#include <cutil/std/math.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/util/hash.h>
+#include <cutil/util/macro.h>
+
+/*
+ * Blocks are tested and updated with one vector operation per half where SSE2
+ * is available.
+ *
+ * Define CUTIL_DISABLE_SIMD to force the portable implementation.
+ */
+#if !defined(CUTIL_DISABLE_SIMD)                                               \
+  && (defined(__SSE2__) || defined(_M_X64)                                     \
+      || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define BLOOM_BLOCK_SSE2
+    #include <emmintrin.h>
+#endif
+
+#define BLOOM_BLOCK_WORDS ((size_t) 8)
+#define BLOOM_BLOCK_BYTES (BLOOM_BLOCK_WORDS * sizeof(uint32_t))
+#define BLOOM_CACHE_LINE ((size_t) 64)
+#define BLOOM_WORD_BITS_LOG2 5
+#define BLOOM_MAX_BLOCKS                                                       \
+    CUTIL_MIN((size_t) UINT32_MAX, SIZE_MAX / (2 * BLOOM_BLOCK_BYTES))
+
+/* Bounds of the average number of elements per block searched when sizing */
+#define BLOOM_MIN_LOAD 1e-3
+#define BLOOM_MAX_LOAD 256.0
+
+#define BLOOM_SERIAL_MAGIC ((uint32_t) 0x4D4C4243) /* "CBLM" */
+#define BLOOM_SERIAL_HEADER_BYTES ((size_t) 20)
+
+/* Odd multipliers selecting the bit of each word of a block */
+static const uint32_t BLOOM_SALTS[BLOOM_BLOCK_WORDS] = {
+  UINT32_C(0x47b6137b), UINT32_C(0x44974d91), UINT32_C(0x8824ad5b),
+  UINT32_C(0xa2b7289d), UINT32_C(0x705495c7), UINT32_C(0x2df1424b),
+  UINT32_C(0x9efc4947), UINT32_C(0x5c6bfb31),
+};
+
+typedef struct {
+    const cutil_GenericType *elem_type;
+    size_t num_blocks;
+    size_t count;
+    void *mem;        /**< allocation holding `blocks` */
+    uint32_t *blocks; /**< `num_blocks` blocks aligned to a cache line */
+} _cutil_BloomFilter;
+
+/**
+ * Returns the expected rate of false positives of a filter whose blocks hold
+ * `load` elements on average. The number of elements in a block follows a
+ * Poisson distribution, and each element of a block sets a given bit of each
+ * of its words with probability 1/32.
+ */
+static double
+_cutil_BloomFilter_estimate_fpp(double load)
+{
+    const double max_elems = load + 10.0 * sqrt(load) + 10.0;
+    double prob = exp(-load);
+    double fpp = 0.0;
+    for (double i = 0.0; i <= max_elems; i += 1.0) {
+        if (i > 0.0) {
+            prob *= load / i;
+        }
+        const double bit_set = 1.0 - pow(31.0 / 32.0, i);
+        fpp += prob * pow(bit_set, (double) BLOOM_BLOCK_WORDS);
+    }
+    return fpp;
+}
+
+/**
+ * Returns the number of blocks needed for `capacity` elements at a rate of
+ * false positives of at most `fpp`, bisecting the largest feasible load.
+ */
+static size_t
+_cutil_BloomFilter_get_num_blocks(size_t capacity, double fpp)
+{
+    double lo = BLOOM_MIN_LOAD;
+    double hi = BLOOM_MAX_LOAD;
+    for (int i = 0; i < 64; ++i) {
+        const double mid = (lo + hi) / 2.0;
+        if (_cutil_BloomFilter_estimate_fpp(mid) <= fpp) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    const double num_blocks = ceil((double) CUTIL_MAX(capacity, 1UL) / lo);
+    return num_blocks >= (double) BLOOM_MAX_BLOCKS ? BLOOM_MAX_BLOCKS
+                                                   : (size_t) num_blocks;
+}
+
+static _cutil_BloomFilter *
+_cutil_BloomFilter_create(const cutil_GenericType *elem_type, size_t num_blocks)
+{
+    _cutil_BloomFilter *const bloom = CUTIL_MALLOC_OBJECT(bloom);
+    bloom->elem_type = elem_type;
+    bloom->num_blocks = num_blocks;
+    bloom->count = 0UL;
+    bloom->mem = calloc(num_blocks * BLOOM_BLOCK_BYTES + BLOOM_CACHE_LINE, 1UL);
+    const uintptr_t addr = (uintptr_t) bloom->mem;
+    const uintptr_t offset
+      = (BLOOM_CACHE_LINE - addr % BLOOM_CACHE_LINE) % BLOOM_CACHE_LINE;
+    bloom->blocks = (uint32_t *) ((unsigned char *) bloom->mem + offset);
+    return bloom;
+}
+
+static cutil_Filter *
+_cutil_BloomFilter_wrap(_cutil_BloomFilter *bloom)
+{
+    cutil_Filter *const filter = CUTIL_MALLOC_OBJECT(filter);
+    filter->vtable = CUTIL_FILTER_TYPE_BLOOM;
+    filter->data = bloom;
+    return filter;
+}
+
+cutil_Filter *
+cutil_BloomFilter_alloc(
+  const cutil_GenericType *elem_type, size_t capacity, double fpp
+)
+{
+    if (elem_type == NULL) {
+        cutil_log_warn("BloomFilter: element type is NULL");
+        return NULL;
+    }
+    if (!(fpp > 0.0 && fpp < 1.0)) {
+        cutil_log_warn("BloomFilter: rate of false positives not in (0, 1)");
+        return NULL;
+    }
+    const size_t num_blocks = _cutil_BloomFilter_get_num_blocks(capacity, fpp);
+    return _cutil_BloomFilter_wrap(
+      _cutil_BloomFilter_create(elem_type, num_blocks)
+    );
+}
+
+/**
+ * Returns the block of `bloom` selected by `hash`, mapping its upper half
+ * onto the blocks by multiplication rather than modulo.
+ */
+static inline uint32_t *
+_cutil_BloomFilter_get_block(const _cutil_BloomFilter *bloom, cutil_hash_t hash)
+{
+    const uint64_t idx = ((hash >> 32U) * (uint64_t) bloom->num_blocks) >> 32U;
+    return bloom->blocks + (size_t) idx * BLOOM_BLOCK_WORDS;
+}
+
+/**
+ * Writes the bit of each word of a block that `hash` sets to `mask`.
+ */
+static inline void
+_cutil_BloomFilter_make_mask(
+  cutil_hash_t hash, uint32_t mask[BLOOM_BLOCK_WORDS]
+)
+{
+    const uint32_t key = (uint32_t) hash;
+    for (size_t i = 0; i < BLOOM_BLOCK_WORDS; ++i) {
+        const uint32_t bit
+          = (key * BLOOM_SALTS[i]) >> (32 - BLOOM_WORD_BITS_LOG2);
+        mask[i] = UINT32_C(1) << bit;
+    }
+}
+
+static inline cutil_hash_t
+_cutil_BloomFilter_hash(const _cutil_BloomFilter *bloom, const void *elem)
+{
+    return cutil_hash_finalize(
+      cutil_GenericType_apply_hash(bloom->elem_type, elem)
+    );
+}
+
+#if defined(BLOOM_BLOCK_SSE2)
+
+static inline cutil_Bool
+_cutil_BloomFilter_block_contains(
+  const uint32_t *block, const uint32_t mask[BLOOM_BLOCK_WORDS]
+)
+{
+    const __m128i *const vblock = (const __m128i *) block;
+    const __m128i *const vmask = (const __m128i *) mask;
+    /* Bits of the mask that are not set in the block */
+    const __m128i missing = _mm_or_si128(
+      _mm_andnot_si128(_mm_load_si128(vblock), _mm_loadu_si128(vmask)),
+      _mm_andnot_si128(_mm_load_si128(vblock + 1), _mm_loadu_si128(vmask + 1))
+    );
+    return CUTIL_BOOLIFY(
+      _mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128()))
+      == 0xFFFF
+    );
+}
+
+static inline void
+_cutil_BloomFilter_block_insert(
+  uint32_t *block, const uint32_t mask[BLOOM_BLOCK_WORDS]
+)
+{
+    __m128i *const vblock = (__m128i *) block;
+    const __m128i *const vmask = (const __m128i *) mask;
+    _mm_store_si128(
+      vblock, _mm_or_si128(_mm_load_si128(vblock), _mm_loadu_si128(vmask))
+    );
+    _mm_store_si128(
+      vblock + 1,
+      _mm_or_si128(_mm_load_si128(vblock + 1), _mm_loadu_si128(vmask + 1))
+    );
+}
+
+#else
+
+static inline cutil_Bool
+_cutil_BloomFilter_block_contains(
+  const uint32_t *block, const uint32_t mask[BLOOM_BLOCK_WORDS]
+)
+{
+    uint32_t missing = 0U;
+    for (size_t i = 0; i < BLOOM_BLOCK_WORDS; ++i) {
+        missing |= mask[i] & ~block[i];
+    }
+    return CUTIL_BOOLIFY(missing == 0U);
+}
+
+static inline void
+_cutil_BloomFilter_block_insert(
+  uint32_t *block, const uint32_t mask[BLOOM_BLOCK_WORDS]
+)
+{
+    for (size_t i = 0; i < BLOOM_BLOCK_WORDS; ++i) {
+        block[i] |= mask[i];
+    }
+}
+
+#endif
+
+static void
+_cutil_BloomFilter_free(void *data)
+{
+    _cutil_BloomFilter *const bloom = data;
+    CUTIL_RETURN_IF_NULL(bloom);
+    free(bloom->mem);
+    free(bloom);
+}
+
+static void
+_cutil_BloomFilter_reset(void *data)
+{
+    _cutil_BloomFilter *const bloom = data;
+    memset(bloom->blocks, 0, bloom->num_blocks * BLOOM_BLOCK_BYTES);
+    bloom->count = 0UL;
+}
+
+static size_t
+_cutil_BloomFilter_get_count(const void *data)
+{
+    const _cutil_BloomFilter *const bloom = data;
+    return bloom->count;
+}
+
+static cutil_Bool
+_cutil_BloomFilter_contains(const void *data, const void *elem)
+{
+    const _cutil_BloomFilter *const bloom = data;
+    const cutil_hash_t hash = _cutil_BloomFilter_hash(bloom, elem);
+    uint32_t mask[BLOOM_BLOCK_WORDS];
+    _cutil_BloomFilter_make_mask(hash, mask);
+    return _cutil_BloomFilter_block_contains(
+      _cutil_BloomFilter_get_block(bloom, hash), mask
+    );
+}
+
+static cutil_Status
+_cutil_BloomFilter_add(void *data, const void *elem)
+{
+    _cutil_BloomFilter *const bloom = data;
+    const cutil_hash_t hash = _cutil_BloomFilter_hash(bloom, elem);
+    uint32_t mask[BLOOM_BLOCK_WORDS];
+    _cutil_BloomFilter_make_mask(hash, mask);
+    _cutil_BloomFilter_block_insert(
+      _cutil_BloomFilter_get_block(bloom, hash), mask
+    );
+    ++bloom->count;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static const cutil_GenericType *
+_cutil_BloomFilter_get_elem_type(const void *data)
+{
+    const _cutil_BloomFilter *const bloom = data;
+    return bloom->elem_type;
+}
+
+static void
+_cutil_BloomFilter_write_le(unsigned char *buf, uint64_t val, size_t num_bytes)
+{
+    for (size_t i = 0; i < num_bytes; ++i) {
+        buf[i] = (unsigned char) (val >> (8U * i));
+    }
+}
+
+static uint64_t
+_cutil_BloomFilter_read_le(const unsigned char *buf, size_t num_bytes)
+{
+    uint64_t val = 0U;
+    for (size_t i = 0; i < num_bytes; ++i) {
+        val |= (uint64_t) buf[i] << (8U * i);
+    }
+    return val;
+}
+
+/*
+ * Serialized format: magic (4 bytes), number of blocks (8 bytes), number of
+ * elements (8 bytes), followed by the words of all blocks (4 bytes each).
+ */
+static size_t
+_cutil_BloomFilter_serialize(const void *data, void *buf, size_t buflen)
+{
+    const _cutil_BloomFilter *const bloom = data;
+    const size_t num_words = bloom->num_blocks * BLOOM_BLOCK_WORDS;
+    const size_t len = BLOOM_SERIAL_HEADER_BYTES + num_words * sizeof(uint32_t);
+    CUTIL_RETURN_VAL_IF_NULL(buf, len);
+    if (buflen < len) {
+        return CUTIL_ERROR_SIZE;
+    }
+
+    unsigned char *out = buf;
+    _cutil_BloomFilter_write_le(out, BLOOM_SERIAL_MAGIC, 4U);
+    _cutil_BloomFilter_write_le(out + 4U, bloom->num_blocks, 8U);
+    _cutil_BloomFilter_write_le(out + 12U, bloom->count, 8U);
+    out += BLOOM_SERIAL_HEADER_BYTES;
+    for (size_t i = 0; i < num_words; ++i, out += sizeof(uint32_t)) {
+        _cutil_BloomFilter_write_le(out, bloom->blocks[i], sizeof(uint32_t));
+    }
+    return len;
+}
+
+cutil_Filter *
+cutil_BloomFilter_deserialize(
+  const cutil_GenericType *elem_type, const void *buf, size_t buflen
+)
+{
+    CUTIL_RETURN_NULL_IF_NULL(elem_type);
+    CUTIL_RETURN_NULL_IF_NULL(buf);
+    const unsigned char *in = buf;
+    if (buflen < BLOOM_SERIAL_HEADER_BYTES
+        || _cutil_BloomFilter_read_le(in, 4U) != BLOOM_SERIAL_MAGIC) {
+        cutil_log_warn("BloomFilter deserialize: malformed input");
+        return NULL;
+    }
+    const uint64_t num_blocks = _cutil_BloomFilter_read_le(in + 4U, 8U);
+    if (num_blocks == 0U || num_blocks > BLOOM_MAX_BLOCKS
+        || (buflen - BLOOM_SERIAL_HEADER_BYTES) / BLOOM_BLOCK_BYTES
+             < num_blocks) {
+        cutil_log_warn("BloomFilter deserialize: malformed input");
+        return NULL;
+    }
+
+    _cutil_BloomFilter *const bloom
+      = _cutil_BloomFilter_create(elem_type, (size_t) num_blocks);
+    bloom->count = (size_t) _cutil_BloomFilter_read_le(in + 12U, 8U);
+    in += BLOOM_SERIAL_HEADER_BYTES;
+    const size_t num_words = bloom->num_blocks * BLOOM_BLOCK_WORDS;
+    for (size_t i = 0; i < num_words; ++i, in += sizeof(uint32_t)) {
+        bloom->blocks[i]
+          = (uint32_t) _cutil_BloomFilter_read_le(in, sizeof(uint32_t));
+    }
+    return _cutil_BloomFilter_wrap(bloom);
+}
+
+static const cutil_FilterType CUTIL_FILTER_TYPE_BLOOM_OBJECT = {
+  .name = "cutil_BloomFilter",
+  .free = &_cutil_BloomFilter_free,
+  .reset = &_cutil_BloomFilter_reset,
+  .get_count = &_cutil_BloomFilter_get_count,
+  .contains = &_cutil_BloomFilter_contains,
+  .add = &_cutil_BloomFilter_add,
+  .remove = NULL,
+  .get_elem_type = &_cutil_BloomFilter_get_elem_type,
+  .serialize = &_cutil_BloomFilter_serialize,
+};
+
+const cutil_FilterType *const CUTIL_FILTER_TYPE_BLOOM
+  = &CUTIL_FILTER_TYPE_BLOOM_OBJECT;
@@ -0,0 +1,517 @@
+#include <cutil/data/generic/filter/cuckoofilter.h>
+
+#include <cutil/io/log.h>
+#include <cutil/status.h>
+#include <cutil/std/inttypes.h>
+#include <cutil/std/math.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/util/bits.h>
+#include <cutil/util/hash.h>
+#include <cutil/util/macro.h>
+
+#define CUCKOO_BUCKET_SLOTS 4U
+#define CUCKOO_MIN_FP_BITS 4U
+#define CUCKOO_MAX_FP_BITS 16U
+#define CUCKOO_MAX_LOAD 0.95
+#define CUCKOO_MAX_KICKS ((size_t) 500)
+#define CUCKOO_MAX_BUCKETS                                                     \
+    CUTIL_MIN((size_t) UINT32_MAX, SIZE_MAX / (2 * sizeof(uint64_t)))
+#define CUCKOO_RANDOM_SEED UINT64_C(0x9E3779B97F4A7C15)
+
+/* Buckets are read and written as 8 bytes, which may run past the last one */
+#define CUCKOO_TABLE_PADDING sizeof(uint64_t)
+
+#define CUCKOO_SERIAL_MAGIC ((uint32_t) 0x4B434343) /* "CCCK" */
+#define CUCKOO_SERIAL_HEADER_BYTES ((size_t) 36)
+
+typedef struct {
+    const cutil_GenericType *elem_type;
+    size_t num_buckets;
+    size_t count;
+    unsigned int fp_bits;
+    uint32_t fp_mask;
+    uint64_t lane_low;     /**< lowest bit of every slot of a bucket */
+    uint64_t lane_high;    /**< highest bit of every slot of a bucket */
+    uint64_t bucket_mask;  /**< all bits of a bucket */
+    unsigned char *table;  /**< buckets of `4 * fp_bits` bits, little-endian */
+    size_t victim_bucket;  /**< bucket of the fingerprint left homeless */
+    uint32_t victim_fp;    /**< fingerprint left homeless, or 0 */
+    uint64_t random_state; /**< xorshift state choosing slots to evict */
+} _cutil_CuckooFilter;
+
+static size_t
+_cutil_CuckooFilter_get_table_bytes(size_t num_buckets, unsigned int fp_bits)
+{
+    return (num_buckets * CUCKOO_BUCKET_SLOTS * fp_bits + 7U) / 8U;
+}
+
+static _cutil_CuckooFilter *
+_cutil_CuckooFilter_create(
+  const cutil_GenericType *elem_type, size_t num_buckets, unsigned int fp_bits
+)
+{
+    _cutil_CuckooFilter *const cf = CUTIL_MALLOC_OBJECT(cf);
+    cf->elem_type = elem_type;
+    cf->num_buckets = num_buckets;
+    cf->count = 0UL;
+    cf->fp_bits = fp_bits;
+    cf->fp_mask = (UINT32_C(1) << fp_bits) - 1U;
+    cf->lane_low = 0U;
+    for (unsigned int i = 0; i < CUCKOO_BUCKET_SLOTS; ++i) {
+        cf->lane_low |= UINT64_C(1) << (i * fp_bits);
+    }
+    cf->lane_high = cf->lane_low << (fp_bits - 1U);
+    cf->bucket_mask = cf->lane_low * cf->fp_mask;
+    cf->table = calloc(
+      _cutil_CuckooFilter_get_table_bytes(num_buckets, fp_bits)
+        + CUCKOO_TABLE_PADDING,
+      1UL
+    );
+    cf->victim_bucket = 0UL;
+    cf->victim_fp = 0U;
+    cf->random_state = CUCKOO_RANDOM_SEED;
+    return cf;
+}
+
+static cutil_Filter *
+_cutil_CuckooFilter_wrap(_cutil_CuckooFilter *cf)
+{
+    cutil_Filter *const filter = CUTIL_MALLOC_OBJECT(filter);
+    filter->vtable = CUTIL_FILTER_TYPE_CUCKOO;
+    filter->data = cf;
+    return filter;
+}
+
+cutil_Filter *
+cutil_CuckooFilter_alloc(
+  const cutil_GenericType *elem_type, size_t capacity, double fpp
+)
+{
+    if (elem_type == NULL) {
+        cutil_log_warn("CuckooFilter: element type is NULL");
+        return NULL;
+    }
+    if (!(fpp > 0.0 && fpp < 1.0)) {
+        cutil_log_warn("CuckooFilter: rate of false positives not in (0, 1)");
+        return NULL;
+    }
+    /* A lookup compares against 2 buckets of 4 slots, each matching with
+     * probability 2^-f */
+    unsigned int fp_bits = CUCKOO_MIN_FP_BITS;
+    while (fp_bits < CUCKOO_MAX_FP_BITS
+           && ldexp(2.0 * CUCKOO_BUCKET_SLOTS, -(int) fp_bits) > fpp) {
+        ++fp_bits;
+    }
+    const double num_buckets
+      = ceil((double) CUTIL_MAX(capacity, 1UL) / CUCKOO_BUCKET_SLOTS
+             / CUCKOO_MAX_LOAD);
+    return _cutil_CuckooFilter_wrap(_cutil_CuckooFilter_create(
+      elem_type,
+      num_buckets >= (double) CUCKOO_MAX_BUCKETS ? CUCKOO_MAX_BUCKETS
+                                                 : (size_t) num_buckets,
+      fp_bits
+    ));
+}
+
+/**
+ * Maps the low 32 bits of `hash` onto [0, range) by multiplication rather
+ * than modulo.
+ */
+static inline size_t
+_cutil_CuckooFilter_reduce(uint64_t hash, size_t range)
+{
+    return (size_t) (((hash & UINT32_MAX) * (uint64_t) range) >> 32U);
+}
+
+/**
+ * Returns the other bucket of fingerprint `fp` stored in `bucket`. The
+ * mapping (H(fp) - bucket) mod n is its own inverse, so a fingerprint can be
+ * moved between its buckets without knowing the element.
+ */
+static inline size_t
+_cutil_CuckooFilter_get_alt_bucket(
+  const _cutil_CuckooFilter *cf, size_t bucket, uint32_t fp
+)
+{
+    const size_t offset = _cutil_CuckooFilter_reduce(
+      cutil_hash_finalize((cutil_hash_t) fp), cf->num_buckets
+    );
+    return offset >= bucket ? offset - bucket
+                            : offset + cf->num_buckets - bucket;
+}
+
+/**
+ * Computes the primary bucket and the nonzero fingerprint of `elem` from
+ * independent halves of its hash.
+ */
+static inline void
+_cutil_CuckooFilter_locate(
+  const _cutil_CuckooFilter *cf, const void *elem, size_t *bucket, uint32_t *fp
+)
+{
+    const cutil_hash_t hash = cutil_hash_finalize(
+      cutil_GenericType_apply_hash(cf->elem_type, elem)
+    );
+    *bucket = _cutil_CuckooFilter_reduce(hash, cf->num_buckets);
+    *fp = (uint32_t) _cutil_CuckooFilter_reduce(hash >> 32U, cf->fp_mask) + 1U;
+}
+
+static inline uint64_t
+_cutil_CuckooFilter_load_bucket(const _cutil_CuckooFilter *cf, size_t bucket)
+{
+    const size_t bit = bucket * CUCKOO_BUCKET_SLOTS * cf->fp_bits;
+    const unsigned char *const bytes = cf->table + bit / 8U;
+    uint64_t word = 0U;
+    for (size_t i = 0; i < sizeof(word); ++i) {
+        word |= (uint64_t) bytes[i] << (8U * i);
+    }
+    return (word >> (bit % 8U)) & cf->bucket_mask;
+}
+
+static inline void
+_cutil_CuckooFilter_store_bucket(
+  _cutil_CuckooFilter *cf, size_t bucket, uint64_t val
+)
+{
+    const size_t bit = bucket * CUCKOO_BUCKET_SLOTS * cf->fp_bits;
+    const unsigned int shift = (unsigned int) (bit % 8U);
+    unsigned char *const bytes = cf->table + bit / 8U;
+    uint64_t word = 0U;
+    for (size_t i = 0; i < sizeof(word); ++i) {
+        word |= (uint64_t) bytes[i] << (8U * i);
+    }
+    word = (word & ~(cf->bucket_mask << shift)) | (val << shift);
+    for (size_t i = 0; i < sizeof(word); ++i) {
+        bytes[i] = (unsigned char) (word >> (8U * i));
+    }
+}
+
+/**
+ * Returns the highest bits of the slots of `word` equal to `fp`, compared all
+ * at once within the word. The lowest returned bit always marks a matching
+ * slot; bits above it may be spurious.
+ */
+static inline uint64_t
+_cutil_CuckooFilter_match(
+  const _cutil_CuckooFilter *cf, uint64_t word, uint32_t fp
+)
+{
+    const uint64_t diff = word ^ (cf->lane_low * fp);
+    return (diff - cf->lane_low) & ~diff & cf->lane_high;
+}
+
+/**
+ * Returns the slot of the lowest highest bit in `matches`.
+ */
+static inline unsigned int
+_cutil_CuckooFilter_get_slot(const _cutil_CuckooFilter *cf, uint64_t matches)
+{
+    return cutil_bits_ctz_u64(matches) / cf->fp_bits;
+}
+
+static inline cutil_Bool
+_cutil_CuckooFilter_bucket_contains(
+  const _cutil_CuckooFilter *cf, size_t bucket, uint32_t fp
+)
+{
+    return CUTIL_BOOLIFY(_cutil_CuckooFilter_match(
+      cf, _cutil_CuckooFilter_load_bucket(cf, bucket), fp
+    ));
+}
+
+/**
+ * Stores `fp` in an empty slot of `bucket`, if any.
+ */
+static cutil_Bool
+_cutil_CuckooFilter_bucket_insert(
+  _cutil_CuckooFilter *cf, size_t bucket, uint32_t fp
+)
+{
+    const uint64_t word = _cutil_CuckooFilter_load_bucket(cf, bucket);
+    const uint64_t empty = _cutil_CuckooFilter_match(cf, word, 0U);
+    if (!empty) {
+        return false;
+    }
+    const unsigned int slot = _cutil_CuckooFilter_get_slot(cf, empty);
+    _cutil_CuckooFilter_store_bucket(
+      cf, bucket, word | ((uint64_t) fp << (slot * cf->fp_bits))
+    );
+    return true;
+}
+
+/**
+ * Clears one slot of `bucket` holding `fp`, if any.
+ */
+static cutil_Bool
+_cutil_CuckooFilter_bucket_remove(
+  _cutil_CuckooFilter *cf, size_t bucket, uint32_t fp
+)
+{
+    const uint64_t word = _cutil_CuckooFilter_load_bucket(cf, bucket);
+    const uint64_t matches = _cutil_CuckooFilter_match(cf, word, fp);
+    if (!matches) {
+        return false;
+    }
+    const unsigned int slot = _cutil_CuckooFilter_get_slot(cf, matches);
+    _cutil_CuckooFilter_store_bucket(
+      cf, bucket, word & ~((uint64_t) cf->fp_mask << (slot * cf->fp_bits))
+    );
+    return true;
+}
+
+static inline uint64_t
+_cutil_CuckooFilter_next_random(_cutil_CuckooFilter *cf)
+{
+    uint64_t x = cf->random_state;
+    x ^= x << 13U;
+    x ^= x >> 7U;
+    x ^= x << 17U;
+    cf->random_state = x;
+    return x;
+}
+
+static void
+_cutil_CuckooFilter_free(void *data)
+{
+    _cutil_CuckooFilter *const cf = data;
+    CUTIL_RETURN_IF_NULL(cf);
+    free(cf->table);
+    free(cf);
+}
+
+static void
+_cutil_CuckooFilter_reset(void *data)
+{
+    _cutil_CuckooFilter *const cf = data;
+    memset(
+      cf->table, 0,
+      _cutil_CuckooFilter_get_table_bytes(cf->num_buckets, cf->fp_bits)
+    );
+    cf->count = 0UL;
+    cf->victim_fp = 0U;
+}
+
+static size_t
+_cutil_CuckooFilter_get_count(const void *data)
+{
+    const _cutil_CuckooFilter *const cf = data;
+    return cf->count;
+}
+
+static cutil_Bool
+_cutil_CuckooFilter_contains(const void *data, const void *elem)
+{
+    const _cutil_CuckooFilter *const cf = data;
+    size_t bucket;
+    uint32_t fp;
+    _cutil_CuckooFilter_locate(cf, elem, &bucket, &fp);
+    if (_cutil_CuckooFilter_bucket_contains(cf, bucket, fp)) {
+        return true;
+    }
+    const size_t alt = _cutil_CuckooFilter_get_alt_bucket(cf, bucket, fp);
+    if (_cutil_CuckooFilter_bucket_contains(cf, alt, fp)) {
+        return true;
+    }
+    return CUTIL_BOOLIFY(
+      cf->victim_fp == fp
+      && (cf->victim_bucket == bucket || cf->victim_bucket == alt)
+    );
+}
+
+static cutil_Status
+_cutil_CuckooFilter_add(void *data, const void *elem)
+{
+    _cutil_CuckooFilter *const cf = data;
+    size_t bucket;
+    uint32_t fp;
+    _cutil_CuckooFilter_locate(cf, elem, &bucket, &fp);
+    const size_t alt = _cutil_CuckooFilter_get_alt_bucket(cf, bucket, fp);
+    if (_cutil_CuckooFilter_bucket_insert(cf, bucket, fp)
+        || _cutil_CuckooFilter_bucket_insert(cf, alt, fp)) {
+        ++cf->count;
+        return CUTIL_STATUS_SUCCESS;
+    }
+    if (cf->victim_fp != 0U) {
+        cutil_log_warn("CuckooFilter add: filter is full");
+        return CUTIL_STATUS_FAILURE;
+    }
+
+    /* Evict random fingerprints to their other bucket until one fits */
+    if (_cutil_CuckooFilter_next_random(cf) & 1U) {
+        bucket = alt;
+    }
+    for (size_t kick = 0; kick < CUCKOO_MAX_KICKS; ++kick) {
+        const unsigned int shift
+          = (unsigned int) (_cutil_CuckooFilter_next_random(cf)
+                            % CUCKOO_BUCKET_SLOTS)
+            * cf->fp_bits;
+        const uint64_t word = _cutil_CuckooFilter_load_bucket(cf, bucket);
+        const uint32_t evicted = (uint32_t) (word >> shift) & cf->fp_mask;
+        _cutil_CuckooFilter_store_bucket(
+          cf, bucket,
+          (word & ~((uint64_t) cf->fp_mask << shift))
+            | ((uint64_t) fp << shift)
+        );
+        fp = evicted;
+        bucket = _cutil_CuckooFilter_get_alt_bucket(cf, bucket, fp);
+        if (_cutil_CuckooFilter_bucket_insert(cf, bucket, fp)) {
+            ++cf->count;
+            return CUTIL_STATUS_SUCCESS;
+        }
+    }
+    /* Keep the last evicted fingerprint aside rather than losing it */
+    cf->victim_bucket = bucket;
+    cf->victim_fp = fp;
+    ++cf->count;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_CuckooFilter_remove(void *data, const void *elem)
+{
+    _cutil_CuckooFilter *const cf = data;
+    size_t bucket;
+    uint32_t fp;
+    _cutil_CuckooFilter_locate(cf, elem, &bucket, &fp);
+    const size_t alt = _cutil_CuckooFilter_get_alt_bucket(cf, bucket, fp);
+    if (cf->victim_fp == fp
+        && (cf->victim_bucket == bucket || cf->victim_bucket == alt)) {
+        cf->victim_fp = 0U;
+        --cf->count;
+        return CUTIL_STATUS_SUCCESS;
+    }
+    if (!_cutil_CuckooFilter_bucket_remove(cf, bucket, fp)
+        && !_cutil_CuckooFilter_bucket_remove(cf, alt, fp)) {
+        cutil_log_warn("CuckooFilter remove: element not found");
+        return CUTIL_STATUS_FAILURE;
+    }
+    --cf->count;
+
+    /* The freed slot may take the homeless fingerprint back */
+    if (cf->victim_fp != 0U) {
+        const size_t victim_alt = _cutil_CuckooFilter_get_alt_bucket(
+          cf, cf->victim_bucket, cf->victim_fp
+        );
+        if (_cutil_CuckooFilter_bucket_insert(
+              cf, cf->victim_bucket, cf->victim_fp
+            )
+            || _cutil_CuckooFilter_bucket_insert(
+              cf, victim_alt, cf->victim_fp
+            )) {
+            cf->victim_fp = 0U;
+        }
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static const cutil_GenericType *
+_cutil_CuckooFilter_get_elem_type(const void *data)
+{
+    const _cutil_CuckooFilter *const cf = data;
+    return cf->elem_type;
+}
+
+static void
+_cutil_CuckooFilter_write_le(unsigned char *buf, uint64_t val, size_t num_bytes)
+{
+    for (size_t i = 0; i < num_bytes; ++i) {
+        buf[i] = (unsigned char) (val >> (8U * i));
+    }
+}
+
+static uint64_t
+_cutil_CuckooFilter_read_le(const unsigned char *buf, size_t num_bytes)
+{
+    uint64_t val = 0U;
+    for (size_t i = 0; i < num_bytes; ++i) {
+        val |= (uint64_t) buf[i] << (8U * i);
+    }
+    return val;
+}
+
+/*
+ * Serialized format: magic (4 bytes), fingerprint bits (4 bytes), number of
+ * buckets (8 bytes), number of elements (8 bytes), homeless fingerprint or 0
+ * (4 bytes) and its bucket (8 bytes), followed by the packed buckets as held
+ * in memory.
+ */
+static size_t
+_cutil_CuckooFilter_serialize(const void *data, void *buf, size_t buflen)
+{
+    const _cutil_CuckooFilter *const cf = data;
+    const size_t table_bytes
+      = _cutil_CuckooFilter_get_table_bytes(cf->num_buckets, cf->fp_bits);
+    const size_t len = CUCKOO_SERIAL_HEADER_BYTES + table_bytes;
+    CUTIL_RETURN_VAL_IF_NULL(buf, len);
+    if (buflen < len) {
+        return CUTIL_ERROR_SIZE;
+    }
+
+    unsigned char *const out = buf;
+    _cutil_CuckooFilter_write_le(out, CUCKOO_SERIAL_MAGIC, 4U);
+    _cutil_CuckooFilter_write_le(out + 4U, cf->fp_bits, 4U);
+    _cutil_CuckooFilter_write_le(out + 8U, cf->num_buckets, 8U);
+    _cutil_CuckooFilter_write_le(out + 16U, cf->count, 8U);
+    _cutil_CuckooFilter_write_le(out + 24U, cf->victim_fp, 4U);
+    _cutil_CuckooFilter_write_le(out + 28U, cf->victim_bucket, 8U);
+    memcpy(out + CUCKOO_SERIAL_HEADER_BYTES, cf->table, table_bytes);
+    return len;
+}
+
+cutil_Filter *
+cutil_CuckooFilter_deserialize(
+  const cutil_GenericType *elem_type, const void *buf, size_t buflen
+)
+{
+    CUTIL_RETURN_NULL_IF_NULL(elem_type);
+    CUTIL_RETURN_NULL_IF_NULL(buf);
+    const unsigned char *const in = buf;
+    if (buflen < CUCKOO_SERIAL_HEADER_BYTES
+        || _cutil_CuckooFilter_read_le(in, 4U) != CUCKOO_SERIAL_MAGIC) {
+        cutil_log_warn("CuckooFilter deserialize: malformed input");
+        return NULL;
+    }
+    const uint64_t fp_bits = _cutil_CuckooFilter_read_le(in + 4U, 4U);
+    const uint64_t num_buckets = _cutil_CuckooFilter_read_le(in + 8U, 8U);
+    const uint64_t victim_fp = _cutil_CuckooFilter_read_le(in + 24U, 4U);
+    const uint64_t victim_bucket = _cutil_CuckooFilter_read_le(in + 28U, 8U);
+    if (fp_bits < CUCKOO_MIN_FP_BITS || fp_bits > CUCKOO_MAX_FP_BITS
+        || num_buckets == 0U || num_buckets > CUCKOO_MAX_BUCKETS
+        || victim_fp >> fp_bits != 0U
+        || (victim_fp != 0U && victim_bucket >= num_buckets)
+        || buflen - CUCKOO_SERIAL_HEADER_BYTES
+             < _cutil_CuckooFilter_get_table_bytes(
+               (size_t) num_buckets, (unsigned int) fp_bits
+             )) {
+        cutil_log_warn("CuckooFilter deserialize: malformed input");
+        return NULL;
+    }
+
+    _cutil_CuckooFilter *const cf = _cutil_CuckooFilter_create(
+      elem_type, (size_t) num_buckets, (unsigned int) fp_bits
+    );
+    cf->count = (size_t) _cutil_CuckooFilter_read_le(in + 16U, 8U);
+    cf->victim_fp = (uint32_t) victim_fp;
+    cf->victim_bucket = victim_fp != 0U ? (size_t) victim_bucket : 0UL;
+    memcpy(
+      cf->table, in + CUCKOO_SERIAL_HEADER_BYTES,
+      _cutil_CuckooFilter_get_table_bytes(cf->num_buckets, cf->fp_bits)
+    );
+    return _cutil_CuckooFilter_wrap(cf);
+}
+
+static const cutil_FilterType CUTIL_FILTER_TYPE_CUCKOO_OBJECT = {
+  .name = "cutil_CuckooFilter",
+  .free = &_cutil_CuckooFilter_free,
+  .reset = &_cutil_CuckooFilter_reset,
+  .get_count = &_cutil_CuckooFilter_get_count,
+  .contains = &_cutil_CuckooFilter_contains,
+  .add = &_cutil_CuckooFilter_add,
+  .remove = &_cutil_CuckooFilter_remove,
+  .get_elem_type = &_cutil_CuckooFilter_get_elem_type,
+  .serialize = &_cutil_CuckooFilter_serialize,
+};
+
+const cutil_FilterType *const CUTIL_FILTER_TYPE_CUCKOO
+  = &CUTIL_FILTER_TYPE_CUCKOO_OBJECT;
@@ -46,9 +46,62 @@ cutil_Map_get(const cutil_Map *map, const void *key, void *val);
 extern inline const void *
 cutil_Map_get_ptr(const cutil_Map *map, const void *key);
 
+cutil_Status
+cutil_Map_get_ptr_batch(
+  const cutil_Map *map, const void *keys, size_t num_keys, const void **vals
+)
+{
+    CUTIL_RETURN_VAL_IF_NULL(map, CUTIL_STATUS_FAILURE);
+    CUTIL_NULL_CHECK(map->vtable);
+    if (map->vtable->get_ptr_batch != NULL) {
+        return map->vtable->get_ptr_batch(map->data, keys, num_keys, vals);
+    }
+
+    const cutil_GenericType *const key_type = cutil_Map_get_key_type(map);
+    CUTIL_RETURN_VAL_IF_NULL(key_type, CUTIL_STATUS_FAILURE);
+    CUTIL_NULL_CHECK_VTABLE(map->vtable, get_ptr);
+    CUTIL_RETURN_VAL_IF_NULL(map->vtable->get_ptr, CUTIL_STATUS_FAILURE);
+    for (size_t i = 0; i < num_keys; ++i) {
+        const void *const key
+          = cutil_void_array_get_elem_const(key_type->size, keys, i);
+        vals[i] = map->vtable->get_ptr(map->data, key);
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
 extern inline cutil_Status
 cutil_Map_set(cutil_Map *map, const void *key, const void *val);
 
+void *
+cutil_Map_get_or_insert(
+  cutil_Map *map, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    CUTIL_RETURN_NULL_IF_NULL(map);
+    CUTIL_NULL_CHECK(map->vtable);
+    if (map->vtable->get_or_insert != NULL) {
+        return map->vtable->get_or_insert(map->data, key, val, inserted);
+    }
+
+    cutil_Bool res = false;
+    if (!cutil_Map_contains(map, key)) {
+        CUTIL_RETURN_VAL_IF_VAL(
+          cutil_Map_set(map, key, val), CUTIL_STATUS_FAILURE, NULL
+        );
+        res = true;
+    }
+    if (inserted != NULL) {
+        *inserted = res;
+    }
+    return CUTIL_CONST_CAST(cutil_Map_get_ptr(map, key));
+}
+
+extern inline cutil_Status
+cutil_Map_reserve(cutil_Map *map, size_t count);
+
+extern inline cutil_Status
+cutil_Map_shrink_to_fit(cutil_Map *map);
+
 extern inline const cutil_GenericType *
 cutil_Map_get_key_type(const cutil_Map *map);
 
@@ -91,6 +144,19 @@ cutil_Map_clear_generic(void *obj);
 extern inline void
 cutil_Map_copy_generic(void *dst, const void *src);
 
+/**
+ * Looks up `key` like 'cutil_Map_get_ptr', but without counting as an access
+ * on maps that implement `peek_ptr`.
+ */
+static const void *
+_cutil_Map_peek_ptr(const cutil_Map *map, const void *key)
+{
+    if (map->vtable->peek_ptr != NULL) {
+        return map->vtable->peek_ptr(map->data, key);
+    }
+    return cutil_Map_get_ptr(map, key);
+}
+
 cutil_Bool
 cutil_Map_deep_equals_generic(const void *vlhs, const void *vrhs)
 {
@@ -118,6 +184,11 @@ cutil_Map_deep_equals_generic(const void *vlhs, const void *vrhs)
     if (cutil_Map_get_count(lhs) != cutil_Map_get_count(rhs)) {
         return false;
     }
+    /* Maintained content hashes reject most unequal maps without iterating */
+    if (lhs->vtable->hash != NULL
+        && lhs->vtable->hash(lhs->data) != rhs->vtable->hash(rhs->data)) {
+        return false;
+    }
     cutil_Bool result = true;
     cutil_ConstIterator *const it = cutil_Map_get_const_iterator(lhs);
     while (cutil_ConstIterator_next(it)) {
@@ -126,8 +197,8 @@ cutil_Map_deep_equals_generic(const void *vlhs, const void *vrhs)
             result = false;
             break;
         }
-        const void *const lhs_val = cutil_Map_get_ptr(lhs, key);
-        const void *const rhs_val = cutil_Map_get_ptr(rhs, key);
+        const void *const lhs_val = _cutil_Map_peek_ptr(lhs, key);
+        const void *const rhs_val = _cutil_Map_peek_ptr(rhs, key);
         if (!cutil_GenericType_apply_deep_equals(
               lhs_val_type, lhs_val, rhs_val
             ))
@@ -182,13 +253,16 @@ cutil_Map_hash_generic(const void *vmap)
     if (map == NULL || cutil_Map_get_count(map) == 0UL) {
         return CUTIL_HASH_C(0);
     }
+    if (map->vtable->hash != NULL) {
+        return map->vtable->hash(map->data);
+    }
     const cutil_GenericType *const key_type = cutil_Map_get_key_type(map);
     const cutil_GenericType *const val_type = cutil_Map_get_val_type(map);
     cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
     cutil_hash_t res = CUTIL_HASH_C(0);
     while (cutil_ConstIterator_next(it)) {
         const void *const key = cutil_ConstIterator_get_ptr(it);
-        const void *const val = cutil_Map_get_ptr(map, key);
+        const void *const val = _cutil_Map_peek_ptr(map, key);
         const cutil_hash_t hk = cutil_GenericType_apply_hash(key_type, key);
         const cutil_hash_t hv = cutil_GenericType_apply_hash(val_type, val);
         res ^= (hk ^ hv);
@@ -207,7 +281,7 @@ _map_entry_to_string(const void *key, char *buf, size_t buflen, const void *ctx)
     const cutil_Map *const map = ctx;
     const cutil_GenericType *const key_type = cutil_Map_get_key_type(map);
     const cutil_GenericType *const val_type = cutil_Map_get_val_type(map);
-    const void *const val = cutil_Map_get_ptr(map, key);
+    const void *const val = _cutil_Map_peek_ptr(map, key);
 
     const size_t key_len
       = cutil_GenericType_apply_to_string(key_type, key, NULL, 0UL);
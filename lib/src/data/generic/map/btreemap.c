@@ -0,0 +1,1029 @@
+#include <cutil/data/generic/map/btreemap.h>
+
+#include <cutil/io/log.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/util/macro.h>
+
+/*
+ * Every node stores up to 2t - 1 keys and, if it is an internal node, up to
+ * 2t children, where t is the minimal degree of the tree. All nodes except
+ * the root hold at least t - 1 keys. Keys, values and child pointers of a
+ * node live in a single allocation, and t is chosen such that the keys of a
+ * node fill BTREEMAP_NODE_KEY_BYTES, i.e., a few cache lines. Searching a
+ * node thus touches few lines, while the tree stays shallow.
+ */
+#define BTREEMAP_NODE_KEY_BYTES ((size_t) 256)
+#define BTREEMAP_MIN_DEGREE ((size_t) 3)
+#define BTREEMAP_MAX_DEGREE ((size_t) 64)
+#define BTREEMAP_NODE_ALIGN ((size_t) 16)
+
+#ifndef NDEBUG
+    /**
+     * MACRO for checking if a cutil_Map is a BTreeMap. If not, function and
+     * type names are logged.
+     */
+    #define CUTIL_BTREEMAP_TYPE_CHECK(MAP)                                     \
+        do {                                                                   \
+            if (MAP->vtable != CUTIL_MAP_TYPE_BTREEMAP) {                      \
+                cutil_log_warn(                                                \
+                  "%s: expected map of type %s, got %s", __func__,             \
+                  CUTIL_MAP_TYPE_BTREEMAP->name, MAP->vtable->name             \
+                );                                                             \
+            }                                                                  \
+        } while (0)
+#else
+    #define CUTIL_BTREEMAP_TYPE_CHECK(MAP) ((void) (MAP))
+#endif /* NDEBUG */
+
+typedef struct _cutil_BTreeMapNode _cutil_BTreeMapNode;
+
+struct _cutil_BTreeMapNode {
+    _cutil_BTreeMapNode *parent;    /**< NULL for the root */
+    size_t pos;                     /**< index in children of parent */
+    size_t num_keys;                /**< number of entries */
+    _cutil_BTreeMapNode **children; /**< NULL for leaves */
+    unsigned char *keys;
+    unsigned char *vals;
+};
+
+typedef struct {
+    const cutil_GenericType *key_type;
+    const cutil_GenericType *val_type;
+    size_t count;
+    size_t max_keys; /**< 2t - 1 */
+    size_t min_keys; /**< t - 1 */
+    _cutil_BTreeMapNode *root; /**< NULL if empty */
+} _cutil_BTreeMap;
+
+/**
+ * Position of an entry. A NULL node denotes the position past the last entry.
+ */
+typedef struct {
+    _cutil_BTreeMapNode *node;
+    size_t idx;
+} _cutil_BTreeMapPos;
+
+static const _cutil_BTreeMapPos BTREEMAP_POS_END = {NULL, 0UL};
+
+static inline size_t
+_cutil_BTreeMap_align(size_t num_bytes)
+{
+    return (num_bytes + BTREEMAP_NODE_ALIGN - 1U) & ~(BTREEMAP_NODE_ALIGN - 1U);
+}
+
+static inline void *
+_cutil_BTreeMap_key(
+  const _cutil_BTreeMap *btree, const _cutil_BTreeMapNode *node, size_t idx
+)
+{
+    return node->keys + idx * btree->key_type->size;
+}
+
+static inline void *
+_cutil_BTreeMap_val(
+  const _cutil_BTreeMap *btree, const _cutil_BTreeMapNode *node, size_t idx
+)
+{
+    return node->vals + idx * btree->val_type->size;
+}
+
+static _cutil_BTreeMapNode *
+_cutil_BTreeMap_alloc_node(const _cutil_BTreeMap *btree, cutil_Bool is_leaf)
+{
+    const size_t header_size
+      = _cutil_BTreeMap_align(sizeof(_cutil_BTreeMapNode));
+    const size_t children_size = is_leaf ? 0UL
+                                         : _cutil_BTreeMap_align(
+                                             (btree->max_keys + 1UL)
+                                             * sizeof(_cutil_BTreeMapNode *)
+                                           );
+    const size_t keys_offset = header_size + children_size;
+    const size_t vals_offset = keys_offset
+                             + _cutil_BTreeMap_align(
+                                 btree->max_keys * btree->key_type->size
+                               );
+    const size_t num_bytes
+      = vals_offset + btree->max_keys * btree->val_type->size;
+
+    unsigned char *const mem = malloc(num_bytes);
+    _cutil_BTreeMapNode *const node = (_cutil_BTreeMapNode *) (void *) mem;
+    node->parent = NULL;
+    node->pos = 0UL;
+    node->num_keys = 0UL;
+    node->children
+      = is_leaf ? NULL : (_cutil_BTreeMapNode **) (void *) (mem + header_size);
+    node->keys = mem + keys_offset;
+    node->vals = mem + vals_offset;
+    return node;
+}
+
+static void
+_cutil_BTreeMap_free_node(
+  const _cutil_BTreeMap *btree, _cutil_BTreeMapNode *node
+)
+{
+    cutil_GenericType_apply_clear_mult(
+      btree->key_type, node->keys, node->num_keys
+    );
+    cutil_GenericType_apply_clear_mult(
+      btree->val_type, node->vals, node->num_keys
+    );
+    if (node->children != NULL) {
+        for (size_t i = 0; i <= node->num_keys; ++i) {
+            _cutil_BTreeMap_free_node(btree, node->children[i]);
+        }
+    }
+    free(node);
+}
+
+static _cutil_BTreeMapNode *
+_cutil_BTreeMap_clone_node(
+  const _cutil_BTreeMap *btree, const _cutil_BTreeMapNode *src
+)
+{
+    _cutil_BTreeMapNode *const node
+      = _cutil_BTreeMap_alloc_node(btree, src->children == NULL);
+    node->num_keys = src->num_keys;
+    cutil_GenericType_apply_init_mult(
+      btree->key_type, node->keys, src->num_keys
+    );
+    cutil_GenericType_apply_copy_mult(
+      btree->key_type, node->keys, src->keys, src->num_keys
+    );
+    cutil_GenericType_apply_init_mult(
+      btree->val_type, node->vals, src->num_keys
+    );
+    cutil_GenericType_apply_copy_mult(
+      btree->val_type, node->vals, src->vals, src->num_keys
+    );
+    if (src->children != NULL) {
+        for (size_t i = 0; i <= src->num_keys; ++i) {
+            _cutil_BTreeMapNode *const child
+              = _cutil_BTreeMap_clone_node(btree, src->children[i]);
+            child->parent = node;
+            child->pos = i;
+            node->children[i] = child;
+        }
+    }
+    return node;
+}
+
+/**
+ * Moves `num` entries from `src` starting at `src_idx` to `dst` starting at
+ * `dst_idx`. Entries are relocated bytewise, so ownership moves along.
+ */
+static void
+_cutil_BTreeMap_move_entries(
+  const _cutil_BTreeMap *btree,
+  _cutil_BTreeMapNode *dst,
+  size_t dst_idx,
+  const _cutil_BTreeMapNode *src,
+  size_t src_idx,
+  size_t num
+)
+{
+    memmove(
+      _cutil_BTreeMap_key(btree, dst, dst_idx),
+      _cutil_BTreeMap_key(btree, src, src_idx), num * btree->key_type->size
+    );
+    memmove(
+      _cutil_BTreeMap_val(btree, dst, dst_idx),
+      _cutil_BTreeMap_val(btree, src, src_idx), num * btree->val_type->size
+    );
+}
+
+/**
+ * Moves `num` children from `src` starting at `src_idx` to `dst` starting at
+ * `dst_idx` and updates their parent links.
+ */
+static void
+_cutil_BTreeMap_move_children(
+  _cutil_BTreeMapNode *dst,
+  size_t dst_idx,
+  const _cutil_BTreeMapNode *src,
+  size_t src_idx,
+  size_t num
+)
+{
+    memmove(
+      dst->children + dst_idx, src->children + src_idx,
+      num * sizeof *dst->children
+    );
+    for (size_t i = dst_idx; i < dst_idx + num; ++i) {
+        dst->children[i]->parent = dst;
+        dst->children[i]->pos = i;
+    }
+}
+
+/**
+ * Returns index of the first key of `node` that is not less than `key` and
+ * stores in `found` whether that key equals `key`.
+ */
+static size_t
+_cutil_BTreeMap_search_node(
+  const _cutil_BTreeMap *btree,
+  const _cutil_BTreeMapNode *node,
+  const void *key,
+  cutil_Bool *found
+)
+{
+    size_t lo = 0UL;
+    size_t hi = node->num_keys;
+    *found = CUTIL_FALSE;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2U;
+        const int cmp = cutil_GenericType_apply_compare(
+          btree->key_type, _cutil_BTreeMap_key(btree, node, mid), key
+        );
+        if (cmp < 0) {
+            lo = mid + 1U;
+        } else {
+            *found = *found || cmp == 0;
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static _cutil_BTreeMapPos
+_cutil_BTreeMap_find(const _cutil_BTreeMap *btree, const void *key)
+{
+    _cutil_BTreeMapNode *node = btree->root;
+    while (node != NULL) {
+        cutil_Bool found;
+        const size_t idx
+          = _cutil_BTreeMap_search_node(btree, node, key, &found);
+        if (found) {
+            const _cutil_BTreeMapPos pos = {node, idx};
+            return pos;
+        }
+        node = node->children != NULL ? node->children[idx] : NULL;
+    }
+    return BTREEMAP_POS_END;
+}
+
+/**
+ * Returns position of the first key that is not less than `key` or, if
+ * `strict` is set, greater than `key`.
+ */
+static _cutil_BTreeMapPos
+_cutil_BTreeMap_bound(
+  const _cutil_BTreeMap *btree, const void *key, cutil_Bool strict
+)
+{
+    _cutil_BTreeMapPos res = BTREEMAP_POS_END;
+    _cutil_BTreeMapNode *node = btree->root;
+    while (node != NULL) {
+        cutil_Bool found;
+        size_t idx = _cutil_BTreeMap_search_node(btree, node, key, &found);
+        if (found) {
+            if (!strict) {
+                res.node = node;
+                res.idx = idx;
+                return res;
+            }
+            ++idx;
+        }
+        if (idx < node->num_keys) {
+            res.node = node;
+            res.idx = idx;
+        }
+        node = node->children != NULL ? node->children[idx] : NULL;
+    }
+    return res;
+}
+
+static _cutil_BTreeMapNode *
+_cutil_BTreeMap_leftmost(_cutil_BTreeMapNode *node)
+{
+    while (node->children != NULL) {
+        node = node->children[0];
+    }
+    return node;
+}
+
+static _cutil_BTreeMapNode *
+_cutil_BTreeMap_rightmost(_cutil_BTreeMapNode *node)
+{
+    while (node->children != NULL) {
+        node = node->children[node->num_keys];
+    }
+    return node;
+}
+
+static _cutil_BTreeMapPos
+_cutil_BTreeMap_first(const _cutil_BTreeMap *btree)
+{
+    CUTIL_RETURN_VAL_IF_NULL(btree->root, BTREEMAP_POS_END);
+    const _cutil_BTreeMapPos pos = {_cutil_BTreeMap_leftmost(btree->root), 0UL};
+    return pos;
+}
+
+/**
+ * Returns position of the entry following the one at `pos` in key order.
+ */
+static _cutil_BTreeMapPos
+_cutil_BTreeMap_successor(_cutil_BTreeMapPos pos)
+{
+    _cutil_BTreeMapNode *node = pos.node;
+    if (node->children != NULL) {
+        pos.node = _cutil_BTreeMap_leftmost(node->children[pos.idx + 1U]);
+        pos.idx = 0UL;
+        return pos;
+    }
+    if (pos.idx + 1U < node->num_keys) {
+        ++pos.idx;
+        return pos;
+    }
+    while (node->parent != NULL && node->pos == node->parent->num_keys) {
+        node = node->parent;
+    }
+    CUTIL_RETURN_VAL_IF_NULL(node->parent, BTREEMAP_POS_END);
+    pos.node = node->parent;
+    pos.idx = node->pos;
+    return pos;
+}
+
+/**
+ * Splits the full child `idx` of `parent` in two, moving its median entry up
+ * into `parent`, which must not be full.
+ */
+static void
+_cutil_BTreeMap_split_child(
+  const _cutil_BTreeMap *btree, _cutil_BTreeMapNode *parent, size_t idx
+)
+{
+    const size_t min_keys = btree->min_keys;
+    _cutil_BTreeMapNode *const child = parent->children[idx];
+    _cutil_BTreeMapNode *const sibling
+      = _cutil_BTreeMap_alloc_node(btree, child->children == NULL);
+
+    _cutil_BTreeMap_move_entries(
+      btree, sibling, 0UL, child, min_keys + 1U, min_keys
+    );
+    if (child->children != NULL) {
+        _cutil_BTreeMap_move_children(
+          sibling, 0UL, child, min_keys + 1U, min_keys + 1U
+        );
+    }
+    sibling->num_keys = min_keys;
+
+    _cutil_BTreeMap_move_children(
+      parent, idx + 2U, parent, idx + 1U, parent->num_keys - idx
+    );
+    parent->children[idx + 1U] = sibling;
+    sibling->parent = parent;
+    sibling->pos = idx + 1U;
+    _cutil_BTreeMap_move_entries(
+      btree, parent, idx + 1U, parent, idx, parent->num_keys - idx
+    );
+    _cutil_BTreeMap_move_entries(btree, parent, idx, child, min_keys, 1UL);
+    ++parent->num_keys;
+    child->num_keys = min_keys;
+}
+
+/**
+ * Returns position of `key`, inserting it with value `val` if not present.
+ * Full nodes are split on the way down, so the leaf always has room.
+ */
+static _cutil_BTreeMapPos
+_cutil_BTreeMap_find_or_insert(
+  _cutil_BTreeMap *btree, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    *inserted = CUTIL_FALSE;
+    if (btree->root == NULL) {
+        btree->root = _cutil_BTreeMap_alloc_node(btree, CUTIL_TRUE);
+    }
+    if (btree->root->num_keys == btree->max_keys) {
+        _cutil_BTreeMapNode *const root
+          = _cutil_BTreeMap_alloc_node(btree, CUTIL_FALSE);
+        root->children[0] = btree->root;
+        btree->root->parent = root;
+        btree->root->pos = 0UL;
+        btree->root = root;
+        _cutil_BTreeMap_split_child(btree, root, 0UL);
+    }
+
+    _cutil_BTreeMapPos pos = {btree->root, 0UL};
+    for (;;) {
+        cutil_Bool found;
+        pos.idx = _cutil_BTreeMap_search_node(btree, pos.node, key, &found);
+        if (found) {
+            return pos;
+        }
+        if (pos.node->children == NULL) {
+            break;
+        }
+        if (pos.node->children[pos.idx]->num_keys == btree->max_keys) {
+            _cutil_BTreeMap_split_child(btree, pos.node, pos.idx);
+            const int cmp = cutil_GenericType_apply_compare(
+              btree->key_type, _cutil_BTreeMap_key(btree, pos.node, pos.idx),
+              key
+            );
+            if (cmp == 0) {
+                return pos;
+            }
+            if (cmp < 0) {
+                ++pos.idx;
+            }
+        }
+        pos.node = pos.node->children[pos.idx];
+    }
+
+    _cutil_BTreeMapNode *const leaf = pos.node;
+    _cutil_BTreeMap_move_entries(
+      btree, leaf, pos.idx + 1U, leaf, pos.idx, leaf->num_keys - pos.idx
+    );
+    void *const key_slot = _cutil_BTreeMap_key(btree, leaf, pos.idx);
+    void *const val_slot = _cutil_BTreeMap_val(btree, leaf, pos.idx);
+    cutil_GenericType_apply_init(btree->key_type, key_slot);
+    cutil_GenericType_apply_copy(btree->key_type, key_slot, key);
+    cutil_GenericType_apply_init(btree->val_type, val_slot);
+    cutil_GenericType_apply_copy(btree->val_type, val_slot, val);
+    ++leaf->num_keys;
+    ++btree->count;
+    *inserted = CUTIL_TRUE;
+    return pos;
+}
+
+/**
+ * Moves the last entry of the left child of separator `sep` up into `parent`
+ * and the separator down into the right child.
+ */
+static void
+_cutil_BTreeMap_rotate_right(
+  const _cutil_BTreeMap *btree, _cutil_BTreeMapNode *parent, size_t sep
+)
+{
+    _cutil_BTreeMapNode *const left = parent->children[sep];
+    _cutil_BTreeMapNode *const right = parent->children[sep + 1U];
+    _cutil_BTreeMap_move_entries(
+      btree, right, 1UL, right, 0UL, right->num_keys
+    );
+    _cutil_BTreeMap_move_entries(btree, right, 0UL, parent, sep, 1UL);
+    _cutil_BTreeMap_move_entries(
+      btree, parent, sep, left, left->num_keys - 1U, 1UL
+    );
+    if (right->children != NULL) {
+        _cutil_BTreeMap_move_children(
+          right, 1UL, right, 0UL, right->num_keys + 1U
+        );
+        _cutil_BTreeMap_move_children(right, 0UL, left, left->num_keys, 1UL);
+    }
+    --left->num_keys;
+    ++right->num_keys;
+}
+
+/**
+ * Moves the first entry of the right child of separator `sep` up into
+ * `parent` and the separator down into the left child.
+ */
+static void
+_cutil_BTreeMap_rotate_left(
+  const _cutil_BTreeMap *btree, _cutil_BTreeMapNode *parent, size_t sep
+)
+{
+    _cutil_BTreeMapNode *const left = parent->children[sep];
+    _cutil_BTreeMapNode *const right = parent->children[sep + 1U];
+    _cutil_BTreeMap_move_entries(btree, left, left->num_keys, parent, sep, 1UL);
+    _cutil_BTreeMap_move_entries(btree, parent, sep, right, 0UL, 1UL);
+    _cutil_BTreeMap_move_entries(
+      btree, right, 0UL, right, 1UL, right->num_keys - 1U
+    );
+    if (left->children != NULL) {
+        _cutil_BTreeMap_move_children(
+          left, left->num_keys + 1U, right, 0UL, 1UL
+        );
+        _cutil_BTreeMap_move_children(right, 0UL, right, 1UL, right->num_keys);
+    }
+    ++left->num_keys;
+    --right->num_keys;
+}
+
+/**
+ * Merges the right child of separator `sep` and the separator itself into
+ * the left child.
+ */
+static void
+_cutil_BTreeMap_merge(
+  const _cutil_BTreeMap *btree, _cutil_BTreeMapNode *parent, size_t sep
+)
+{
+    _cutil_BTreeMapNode *const left = parent->children[sep];
+    _cutil_BTreeMapNode *const right = parent->children[sep + 1U];
+    _cutil_BTreeMap_move_entries(btree, left, left->num_keys, parent, sep, 1UL);
+    _cutil_BTreeMap_move_entries(
+      btree, left, left->num_keys + 1U, right, 0UL, right->num_keys
+    );
+    if (left->children != NULL) {
+        _cutil_BTreeMap_move_children(
+          left, left->num_keys + 1U, right, 0UL, right->num_keys + 1U
+        );
+    }
+    left->num_keys += right->num_keys + 1U;
+    free(right);
+
+    _cutil_BTreeMap_move_entries(
+      btree, parent, sep, parent, sep + 1U, parent->num_keys - sep - 1U
+    );
+    _cutil_BTreeMap_move_children(
+      parent, sep + 1U, parent, sep + 2U, parent->num_keys - sep - 1U
+    );
+    --parent->num_keys;
+}
+
+/**
+ * Restores the minimal fill of `node` and its ancestors after an entry has
+ * been removed from `node`.
+ */
+static void
+_cutil_BTreeMap_rebalance(_cutil_BTreeMap *btree, _cutil_BTreeMapNode *node)
+{
+    while (node->parent != NULL && node->num_keys < btree->min_keys) {
+        _cutil_BTreeMapNode *const parent = node->parent;
+        const size_t pos = node->pos;
+        if (pos > 0U
+            && parent->children[pos - 1U]->num_keys > btree->min_keys) {
+            _cutil_BTreeMap_rotate_right(btree, parent, pos - 1U);
+            return;
+        }
+        if (pos < parent->num_keys
+            && parent->children[pos + 1U]->num_keys > btree->min_keys) {
+            _cutil_BTreeMap_rotate_left(btree, parent, pos);
+            return;
+        }
+        _cutil_BTreeMap_merge(btree, parent, pos > 0U ? pos - 1U : pos);
+        node = parent;
+    }
+    if (node->parent == NULL && node->num_keys == 0U) {
+        btree->root = node->children != NULL ? node->children[0] : NULL;
+        if (btree->root != NULL) {
+            btree->root->parent = NULL;
+            btree->root->pos = 0UL;
+        }
+        free(node);
+    }
+}
+
+static void
+_cutil_BTreeMap_erase(_cutil_BTreeMap *btree, _cutil_BTreeMapPos pos)
+{
+    _cutil_BTreeMapNode *node = pos.node;
+    cutil_GenericType_apply_clear(
+      btree->key_type, _cutil_BTreeMap_key(btree, node, pos.idx)
+    );
+    cutil_GenericType_apply_clear(
+      btree->val_type, _cutil_BTreeMap_val(btree, node, pos.idx)
+    );
+    if (node->children != NULL) {
+        /* Replace entry by its predecessor, which resides in a leaf */
+        _cutil_BTreeMapNode *const leaf
+          = _cutil_BTreeMap_rightmost(node->children[pos.idx]);
+        _cutil_BTreeMap_move_entries(
+          btree, node, pos.idx, leaf, leaf->num_keys - 1U, 1UL
+        );
+        node = leaf;
+    } else {
+        _cutil_BTreeMap_move_entries(
+          btree, node, pos.idx, node, pos.idx + 1U,
+          node->num_keys - pos.idx - 1U
+        );
+    }
+    --node->num_keys;
+    --btree->count;
+    _cutil_BTreeMap_rebalance(btree, node);
+}
+
+/**
+ * Returns newly malloc'd copy of `key`.
+ */
+static void *
+_cutil_BTreeMap_dup_key(const _cutil_BTreeMap *btree, const void *key)
+{
+    void *const res = malloc(btree->key_type->size);
+    cutil_GenericType_apply_init(btree->key_type, res);
+    cutil_GenericType_apply_copy(btree->key_type, res, key);
+    return res;
+}
+
+static void
+_cutil_BTreeMap_free_key(const _cutil_BTreeMap *btree, void *key)
+{
+    CUTIL_RETURN_IF_NULL(key);
+    cutil_GenericType_apply_clear(btree->key_type, key);
+    free(key);
+}
+
+cutil_Map *
+cutil_BTreeMap_alloc(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+)
+{
+    if (!cutil_GenericType_is_valid(key_type)) {
+        cutil_log_warn("Key type is not valid");
+        return NULL;
+    }
+    if (!cutil_GenericType_is_valid(val_type)) {
+        cutil_log_warn("Value type is not valid");
+        return NULL;
+    }
+
+    cutil_Map *const map = CUTIL_MALLOC_OBJECT(map);
+
+    map->vtable = CUTIL_MAP_TYPE_BTREEMAP;
+    _cutil_BTreeMap *const btree = map->data = CUTIL_MALLOC_OBJECT(btree);
+
+    const size_t degree = CUTIL_CLAMP(
+      BTREEMAP_NODE_KEY_BYTES / (2U * key_type->size), BTREEMAP_MIN_DEGREE,
+      BTREEMAP_MAX_DEGREE
+    );
+    btree->key_type = key_type;
+    btree->val_type = val_type;
+    btree->count = 0UL;
+    btree->max_keys = 2U * degree - 1U;
+    btree->min_keys = degree - 1U;
+    btree->root = NULL;
+
+    return map;
+}
+
+static void
+_cutil_BTreeMap_reset(void *data)
+{
+    _cutil_BTreeMap *const btree = data;
+    if (btree->root != NULL) {
+        _cutil_BTreeMap_free_node(btree, btree->root);
+        btree->root = NULL;
+    }
+    btree->count = 0UL;
+}
+
+static void
+_cutil_BTreeMap_free(void *data)
+{
+    CUTIL_RETURN_IF_NULL(data);
+    _cutil_BTreeMap_reset(data);
+    free(data);
+}
+
+static void
+_cutil_BTreeMap_copy(void *dst, const void *src)
+{
+    _cutil_BTreeMap *const dst_btree = dst;
+    const _cutil_BTreeMap *const src_btree = src;
+    CUTIL_RETURN_IF_VAL(dst_btree, src_btree);
+
+    _cutil_BTreeMap_reset(dst_btree);
+    if (src_btree->root != NULL) {
+        dst_btree->root
+          = _cutil_BTreeMap_clone_node(src_btree, src_btree->root);
+    }
+    dst_btree->count = src_btree->count;
+}
+
+static void *
+_cutil_BTreeMap_duplicate(const void *data)
+{
+    const _cutil_BTreeMap *const src = data;
+    _cutil_BTreeMap *const dst = CUTIL_MALLOC_OBJECT(dst);
+    *dst = *src;
+    if (src->root != NULL) {
+        dst->root = _cutil_BTreeMap_clone_node(src, src->root);
+    }
+    return dst;
+}
+
+static size_t
+_cutil_BTreeMap_get_count(const void *data)
+{
+    const _cutil_BTreeMap *const btree = data;
+    return btree->count;
+}
+
+static cutil_Status
+_cutil_BTreeMap_remove(void *data, const void *key)
+{
+    _cutil_BTreeMap *const btree = data;
+    const _cutil_BTreeMapPos pos = _cutil_BTreeMap_find(btree, key);
+    CUTIL_RETURN_VAL_IF_NULL(pos.node, CUTIL_STATUS_FAILURE);
+    _cutil_BTreeMap_erase(btree, pos);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Bool
+_cutil_BTreeMap_contains(const void *data, const void *key)
+{
+    const _cutil_BTreeMap *const btree = data;
+    return CUTIL_BOOLIFY(_cutil_BTreeMap_find(btree, key).node != NULL);
+}
+
+static const void *
+_cutil_BTreeMap_get_ptr(const void *data, const void *key)
+{
+    const _cutil_BTreeMap *const btree = data;
+    const _cutil_BTreeMapPos pos = _cutil_BTreeMap_find(btree, key);
+    CUTIL_RETURN_NULL_IF_NULL(pos.node);
+    return _cutil_BTreeMap_val(btree, pos.node, pos.idx);
+}
+
+static cutil_Status
+_cutil_BTreeMap_get(const void *data, const void *key, void *val)
+{
+    const _cutil_BTreeMap *const btree = data;
+    const void *const p = _cutil_BTreeMap_get_ptr(data, key);
+    CUTIL_RETURN_VAL_IF_NULL(p, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(btree->val_type, val, p);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_BTreeMap_set(void *data, const void *key, const void *val)
+{
+    _cutil_BTreeMap *const btree = data;
+    cutil_Bool inserted;
+    const _cutil_BTreeMapPos pos
+      = _cutil_BTreeMap_find_or_insert(btree, key, val, &inserted);
+    if (!inserted) {
+        cutil_GenericType_apply_copy(
+          btree->val_type, _cutil_BTreeMap_val(btree, pos.node, pos.idx), val
+        );
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static void *
+_cutil_BTreeMap_get_or_insert(
+  void *data, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    _cutil_BTreeMap *const btree = data;
+    cutil_Bool res;
+    const _cutil_BTreeMapPos pos
+      = _cutil_BTreeMap_find_or_insert(btree, key, val, &res);
+    if (inserted != NULL) {
+        *inserted = res;
+    }
+    return _cutil_BTreeMap_val(btree, pos.node, pos.idx);
+}
+
+static const cutil_GenericType *
+_cutil_BTreeMap_get_key_type(const void *data)
+{
+    const _cutil_BTreeMap *const btree = data;
+    return btree->key_type;
+}
+
+static const cutil_GenericType *
+_cutil_BTreeMap_get_val_type(const void *data)
+{
+    const _cutil_BTreeMap *const btree = data;
+    return btree->val_type;
+}
+
+cutil_Status
+cutil_BTreeMap_get_min(const cutil_Map *map, void *key)
+{
+    CUTIL_RETURN_VAL_IF_NULL(map, CUTIL_STATUS_FAILURE);
+    CUTIL_BTREEMAP_TYPE_CHECK(map);
+
+    const _cutil_BTreeMap *const btree = map->data;
+    CUTIL_RETURN_VAL_IF_NULL(btree->root, CUTIL_STATUS_FAILURE);
+    const _cutil_BTreeMapNode *const node
+      = _cutil_BTreeMap_leftmost(btree->root);
+    cutil_GenericType_apply_copy(
+      btree->key_type, key, _cutil_BTreeMap_key(btree, node, 0UL)
+    );
+    return CUTIL_STATUS_SUCCESS;
+}
+
+cutil_Status
+cutil_BTreeMap_get_max(const cutil_Map *map, void *key)
+{
+    CUTIL_RETURN_VAL_IF_NULL(map, CUTIL_STATUS_FAILURE);
+    CUTIL_BTREEMAP_TYPE_CHECK(map);
+
+    const _cutil_BTreeMap *const btree = map->data;
+    CUTIL_RETURN_VAL_IF_NULL(btree->root, CUTIL_STATUS_FAILURE);
+    const _cutil_BTreeMapNode *const node
+      = _cutil_BTreeMap_rightmost(btree->root);
+    cutil_GenericType_apply_copy(
+      btree->key_type, key,
+      _cutil_BTreeMap_key(btree, node, node->num_keys - 1U)
+    );
+    return CUTIL_STATUS_SUCCESS;
+}
+
+typedef enum {
+    BTREEMAP_BOUND_NONE,
+    BTREEMAP_BOUND_LOWER, /**< keys not less than bound */
+    BTREEMAP_BOUND_UPPER, /**< keys greater than bound */
+} _cutil_BTreeMapBound;
+
+typedef struct {
+    const _cutil_BTreeMap *btree;
+    _cutil_BTreeMapPos pos;
+    cutil_Bool pending; /**< whether `pos` is yet to be visited by next */
+    _cutil_BTreeMapBound bound;
+    void *bound_key; /**< copy of bound key, NULL if unbounded */
+} _cutil_BTreeMapIter;
+
+static void
+_cutil_BTreeMapIter_rewind(void *data)
+{
+    _cutil_BTreeMapIter *const iter = data;
+    iter->pos = iter->bound == BTREEMAP_BOUND_NONE
+                ? _cutil_BTreeMap_first(iter->btree)
+                : _cutil_BTreeMap_bound(
+                    iter->btree, iter->bound_key,
+                    iter->bound == BTREEMAP_BOUND_UPPER
+                  );
+    iter->pending = CUTIL_TRUE;
+}
+
+static void
+_cutil_BTreeMapIter_free(void *data)
+{
+    _cutil_BTreeMapIter *const iter = data;
+    CUTIL_RETURN_IF_NULL(iter);
+    _cutil_BTreeMap_free_key(iter->btree, iter->bound_key);
+    free(iter);
+}
+
+static cutil_Bool
+_cutil_BTreeMapIter_next(void *data)
+{
+    _cutil_BTreeMapIter *const iter = data;
+    if (iter->pending) {
+        iter->pending = CUTIL_FALSE;
+    } else if (iter->pos.node != NULL) {
+        iter->pos = _cutil_BTreeMap_successor(iter->pos);
+    }
+    return CUTIL_BOOLIFY(iter->pos.node != NULL);
+}
+
+static const void *
+_cutil_BTreeMapIter_get_ptr(const void *data)
+{
+    const _cutil_BTreeMapIter *const iter = data;
+    if (iter->pending || iter->pos.node == NULL) {
+        return NULL;
+    }
+    return _cutil_BTreeMap_key(iter->btree, iter->pos.node, iter->pos.idx);
+}
+
+static cutil_Status
+_cutil_BTreeMapIter_get(const void *data, void *out)
+{
+    const _cutil_BTreeMapIter *const iter = data;
+    const void *const p = _cutil_BTreeMapIter_get_ptr(data);
+    CUTIL_RETURN_VAL_IF_NULL(p, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(iter->btree->key_type, out, p);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+/**
+ * Removes the current entry. Since removal restructures the tree, the
+ * iterator continues at the first key greater than the removed one.
+ */
+static cutil_Status
+_cutil_BTreeMapIter_remove(void *data)
+{
+    _cutil_BTreeMapIter *const iter = data;
+    const void *const p = _cutil_BTreeMapIter_get_ptr(data);
+    CUTIL_RETURN_VAL_IF_NULL(p, CUTIL_STATUS_FAILURE);
+
+    _cutil_BTreeMap *const btree = CUTIL_CONST_CAST(iter->btree);
+    void *const key = _cutil_BTreeMap_dup_key(btree, p);
+    _cutil_BTreeMap_erase(btree, iter->pos);
+    iter->pos = _cutil_BTreeMap_bound(btree, key, CUTIL_TRUE);
+    iter->pending = CUTIL_TRUE;
+    _cutil_BTreeMap_free_key(btree, key);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static _cutil_BTreeMapIter *
+_cutil_BTreeMapIter_alloc(
+  const _cutil_BTreeMap *btree, _cutil_BTreeMapBound bound, const void *key
+)
+{
+    _cutil_BTreeMapIter *const iter = CUTIL_MALLOC_OBJECT(iter);
+    iter->btree = btree;
+    iter->bound = bound;
+    iter->bound_key = bound == BTREEMAP_BOUND_NONE
+                      ? NULL
+                      : _cutil_BTreeMap_dup_key(btree, key);
+    _cutil_BTreeMapIter_rewind(iter);
+    return iter;
+}
+
+static const cutil_ConstIteratorType CUTIL_CONST_ITERATOR_TYPE_BTREEMAP_OBJECT
+  = {
+    .name = "cutil_ConstIterator<cutil_BTreeMap>",
+    .free = &_cutil_BTreeMapIter_free,
+    .rewind = &_cutil_BTreeMapIter_rewind,
+    .next = &_cutil_BTreeMapIter_next,
+    .get = &_cutil_BTreeMapIter_get,
+    .get_ptr = &_cutil_BTreeMapIter_get_ptr,
+};
+
+const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_BTREEMAP
+  = &CUTIL_CONST_ITERATOR_TYPE_BTREEMAP_OBJECT;
+
+static const cutil_IteratorType CUTIL_ITERATOR_TYPE_BTREEMAP_OBJECT = {
+  .name = "cutil_Iterator<cutil_BTreeMap>",
+  .free = &_cutil_BTreeMapIter_free,
+  .rewind = &_cutil_BTreeMapIter_rewind,
+  .next = &_cutil_BTreeMapIter_next,
+  .get = &_cutil_BTreeMapIter_get,
+  .get_ptr = &_cutil_BTreeMapIter_get_ptr,
+  .set = NULL,
+  .remove = &_cutil_BTreeMapIter_remove,
+};
+
+const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_BTREEMAP
+  = &CUTIL_ITERATOR_TYPE_BTREEMAP_OBJECT;
+
+static cutil_ConstIterator *
+_cutil_BTreeMap_alloc_const_iterator(
+  const _cutil_BTreeMap *btree, _cutil_BTreeMapBound bound, const void *key
+)
+{
+    cutil_ConstIterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_CONST_ITERATOR_TYPE_BTREEMAP;
+    it->data = _cutil_BTreeMapIter_alloc(btree, bound, key);
+    return it;
+}
+
+static cutil_ConstIterator *
+_cutil_BTreeMap_get_const_iterator(const void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_ConstIterator *const it = _cutil_BTreeMap_alloc_const_iterator(
+      data, BTREEMAP_BOUND_NONE, NULL
+    );
+
+    cutil_log_debug("BTreeMap: created const iterator");
+    return it;
+}
+
+static cutil_Iterator *
+_cutil_BTreeMap_get_iterator(void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_Iterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_ITERATOR_TYPE_BTREEMAP;
+    it->data = _cutil_BTreeMapIter_alloc(data, BTREEMAP_BOUND_NONE, NULL);
+
+    cutil_log_debug("BTreeMap: created iterator");
+    return it;
+}
+
+cutil_ConstIterator *
+cutil_BTreeMap_lower_bound(const cutil_Map *map, const void *key)
+{
+    CUTIL_RETURN_NULL_IF_NULL(map);
+    CUTIL_RETURN_NULL_IF_NULL(key);
+    CUTIL_BTREEMAP_TYPE_CHECK(map);
+
+    return _cutil_BTreeMap_alloc_const_iterator(
+      map->data, BTREEMAP_BOUND_LOWER, key
+    );
+}
+
+cutil_ConstIterator *
+cutil_BTreeMap_upper_bound(const cutil_Map *map, const void *key)
+{
+    CUTIL_RETURN_NULL_IF_NULL(map);
+    CUTIL_RETURN_NULL_IF_NULL(key);
+    CUTIL_BTREEMAP_TYPE_CHECK(map);
+
+    return _cutil_BTreeMap_alloc_const_iterator(
+      map->data, BTREEMAP_BOUND_UPPER, key
+    );
+}
+
+static const cutil_MapType CUTIL_MAP_TYPE_BTREEMAP_OBJECT = {
+  .name = "cutil_BTreeMap",
+  .free = &_cutil_BTreeMap_free,
+  .reset = &_cutil_BTreeMap_reset,
+  .copy = &_cutil_BTreeMap_copy,
+  .duplicate = &_cutil_BTreeMap_duplicate,
+  .get_count = &_cutil_BTreeMap_get_count,
+  .remove = &_cutil_BTreeMap_remove,
+  .contains = &_cutil_BTreeMap_contains,
+  .get = &_cutil_BTreeMap_get,
+  .get_ptr = &_cutil_BTreeMap_get_ptr,
+  .set = &_cutil_BTreeMap_set,
+  .get_or_insert = &_cutil_BTreeMap_get_or_insert,
+  .get_key_type = &_cutil_BTreeMap_get_key_type,
+  .get_val_type = &_cutil_BTreeMap_get_val_type,
+  .get_const_iterator = &_cutil_BTreeMap_get_const_iterator,
+  .get_iterator = &_cutil_BTreeMap_get_iterator,
+};
+
+const cutil_MapType *const CUTIL_MAP_TYPE_BTREEMAP
+  = &CUTIL_MAP_TYPE_BTREEMAP_OBJECT;
@@ -0,0 +1,1340 @@
+#include <cutil/data/generic/map/cachemap.h>
+
+#include <cutil/io/log.h>
+#include <cutil/status.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/util/hash.h>
+#include <cutil/util/macro.h>
+
+#ifndef NDEBUG
+    /**
+     * MACRO for checking if a cutil_Map is a CacheMap. If not, function and
+     * type names are logged.
+     */
+    #define CUTIL_CACHEMAP_TYPE_CHECK(MAP)                                     \
+        do {                                                                   \
+            if (MAP->vtable != CUTIL_MAP_TYPE_CACHE) {                         \
+                cutil_log_warn(                                                \
+                  "%s: expected map of type %s, got %s", __func__,             \
+                  CUTIL_MAP_TYPE_CACHE->name, MAP->vtable->name                \
+                );                                                             \
+            }                                                                  \
+        } while (0)
+#else
+    #define CUTIL_CACHEMAP_TYPE_CHECK(MAP) ((void) (MAP))
+#endif /* NDEBUG */
+
+/*
+ * Entries live in dense arrays and are threaded onto intrusive doubly linked
+ * lists, one per segment, from most to least recently used. Free entries are
+ * chained through `next`. A linear-probing index maps hashes to entry
+ * numbers; at most half of its slots refer to entries, and removed entries
+ * leave dummy slots behind until the index is rebuilt.
+ */
+#define CACHE_MIN_NUM_SLOTS ((size_t) 16)
+#define CACHE_INDEX_EMPTY CUTIL_ERROR_INDEX
+#define CACHE_INDEX_DUMMY (CUTIL_ERROR_INDEX - 1U)
+#define CACHE_NO_ENTRY CUTIL_ERROR_INDEX
+
+#define CACHE_SEGMENT_WINDOW 0U /* the only segment used by LRU */
+#define CACHE_SEGMENT_PROBATION 1U
+#define CACHE_SEGMENT_PROTECTED 2U
+#define CACHE_NUM_SEGMENTS 3U
+#define CACHE_SEGMENT_FREE CACHE_NUM_SEGMENTS
+
+/* W-TinyLFU shares of the budget and of the main region, in percent */
+#define CACHE_WINDOW_PERCENT 1U
+#define CACHE_PROTECTED_PERCENT 80U
+
+#define CACHE_SKETCH_DEPTH 4U
+#define CACHE_SKETCH_COUNTERS_PER_WORD 16U
+#define CACHE_SKETCH_MAX_COUNT 15U
+#define CACHE_SKETCH_MIN_NUM_COUNTERS ((size_t) 64)
+/* Counters per entry, and increments per entry after which all are halved */
+#define CACHE_SKETCH_WIDTH_FACTOR 4U
+#define CACHE_SKETCH_SAMPLE_FACTOR 10U
+#define CACHE_SKETCH_HALVE_MASK UINT64_C(0x7777777777777777)
+
+typedef struct {
+    size_t head;   /**< most recently used entry, or CACHE_NO_ENTRY */
+    size_t tail;   /**< least recently used entry, or CACHE_NO_ENTRY */
+    size_t weight; /**< total weight of entries */
+} _cutil_CacheList;
+
+/**
+ * Count-min sketch of 4-bit counters, packed 16 to a word.
+ */
+typedef struct {
+    uint64_t *words;
+    size_t mask;        /**< number of counters - 1 */
+    size_t num_samples; /**< increments since counters were last halved */
+    size_t sample_size; /**< increments after which counters are halved */
+} _cutil_CacheSketch;
+
+typedef struct {
+    const cutil_GenericType *key_type;
+    const cutil_GenericType *val_type;
+    const cutil_CachePolicy *policy;
+    cutil_CacheWeigher *weigher; /**< NULL if all entries weigh the same */
+    size_t fixed_weight;         /**< weight of entries without `weigher` */
+    size_t max_weight;
+    size_t max_window_weight;
+    size_t max_protected_weight;
+    size_t count;
+    size_t num_used;         /**< number of entries, free ones included */
+    size_t entry_capacity;   /**< number of entries before a resize */
+    size_t free_entry;       /**< first free entry, or CACHE_NO_ENTRY */
+    cutil_hash_t *hashes;    /**< hash of every entry */
+    size_t *weights;         /**< weight of every entry */
+    size_t *prev;            /**< more recently used entry in segment */
+    size_t *next;            /**< less recently used entry, or next free */
+    unsigned char *segments; /**< segment of every entry, or SEGMENT_FREE */
+    void *keys;
+    void *vals;
+    size_t index_mask;  /**< number of index slots - 1 */
+    size_t num_dummies; /**< number of dummy index slots */
+    size_t *index;      /**< entry numbers, or INDEX_EMPTY or INDEX_DUMMY */
+    _cutil_CacheList lists[CACHE_NUM_SEGMENTS];
+    _cutil_CacheSketch sketch; /**< only allocated by W-TinyLFU */
+    cutil_CacheStats stats;
+} _cutil_CacheMap;
+
+/**
+ * Eviction policies place new entries into segments and reorder entries on
+ * access. Afterwards, least recently used entries are evicted until the
+ * budget is met.
+ */
+struct _cutil_CachePolicy {
+    const char *const name;
+    const cutil_Bool uses_sketch;
+    void (*const on_access)(_cutil_CacheMap *cache, size_t entry);
+    void (*const on_insert)(_cutil_CacheMap *cache, size_t entry);
+};
+
+static inline void *
+_cutil_CacheMap_get_key_ptr(const _cutil_CacheMap *cache, size_t entry)
+{
+    return cutil_void_array_get_elem(cache->key_type->size, cache->keys, entry);
+}
+
+static inline void *
+_cutil_CacheMap_get_val_ptr(const _cutil_CacheMap *cache, size_t entry)
+{
+    return cutil_void_array_get_elem(cache->val_type->size, cache->vals, entry);
+}
+
+static inline cutil_hash_t
+_cutil_CacheMap_hash_key(const _cutil_CacheMap *cache, const void *key)
+{
+    return cutil_hash_finalize(
+      cutil_GenericType_apply_hash(cache->key_type, key)
+    );
+}
+
+static inline size_t
+_cutil_CacheMap_weigh(
+  const _cutil_CacheMap *cache, const void *key, const void *val
+)
+{
+    if (cache->weigher != NULL) {
+        return cache->weigher(key, val);
+    }
+    return cache->fixed_weight;
+}
+
+static inline size_t
+_cutil_CacheMap_get_total_weight(const _cutil_CacheMap *cache)
+{
+    size_t weight = 0UL;
+    for (size_t i = 0; i < CACHE_NUM_SEGMENTS; ++i) {
+        weight += cache->lists[i].weight;
+    }
+    return weight;
+}
+
+/**
+ * Inserts `entry` as the most recently used entry of segment `segment`.
+ */
+static void
+_cutil_CacheMap_link(_cutil_CacheMap *cache, unsigned segment, size_t entry)
+{
+    _cutil_CacheList *const list = &cache->lists[segment];
+    cache->segments[entry] = (unsigned char) segment;
+    cache->prev[entry] = CACHE_NO_ENTRY;
+    cache->next[entry] = list->head;
+    if (list->head != CACHE_NO_ENTRY) {
+        cache->prev[list->head] = entry;
+    } else {
+        list->tail = entry;
+    }
+    list->head = entry;
+    list->weight += cache->weights[entry];
+}
+
+/**
+ * Removes `entry` from the list of its segment.
+ */
+static void
+_cutil_CacheMap_unlink(_cutil_CacheMap *cache, size_t entry)
+{
+    _cutil_CacheList *const list = &cache->lists[cache->segments[entry]];
+    const size_t prev = cache->prev[entry];
+    const size_t next = cache->next[entry];
+    if (prev != CACHE_NO_ENTRY) {
+        cache->next[prev] = next;
+    } else {
+        list->head = next;
+    }
+    if (next != CACHE_NO_ENTRY) {
+        cache->prev[next] = prev;
+    } else {
+        list->tail = prev;
+    }
+    list->weight -= cache->weights[entry];
+}
+
+static inline void
+_cutil_CacheMap_move_to_front(
+  _cutil_CacheMap *cache, unsigned segment, size_t entry
+)
+{
+    _cutil_CacheMap_unlink(cache, entry);
+    _cutil_CacheMap_link(cache, segment, entry);
+}
+
+/**
+ * Makes sure `sketch` has enough counters for `num_entries` entries. Counters
+ * are reset if the sketch has to grow.
+ */
+static void
+_cutil_CacheSketch_ensure(_cutil_CacheSketch *sketch, size_t num_entries)
+{
+    size_t num_counters = CACHE_SKETCH_MIN_NUM_COUNTERS;
+    while (num_counters / CACHE_SKETCH_WIDTH_FACTOR < num_entries
+           && num_counters <= CUTIL_ERROR_INDEX / 4U) {
+        num_counters *= 2U;
+    }
+    sketch->sample_size = CACHE_SKETCH_SAMPLE_FACTOR * num_entries;
+    if (sketch->words != NULL && num_counters <= sketch->mask + 1U) {
+        return;
+    }
+    free(sketch->words);
+    sketch->words = CUTIL_CALLOC_MULT(
+      sketch->words, num_counters / CACHE_SKETCH_COUNTERS_PER_WORD
+    );
+    sketch->mask = num_counters - 1U;
+    sketch->num_samples = 0UL;
+}
+
+/**
+ * Writes the counter numbers of `hash`, one per row, to `counters`.
+ */
+static inline void
+_cutil_CacheSketch_get_counters(
+  const _cutil_CacheSketch *sketch, cutil_hash_t hash, size_t *counters
+)
+{
+    const cutil_hash_t step = (hash >> 32U) | 1U;
+    for (size_t i = 0; i < CACHE_SKETCH_DEPTH; ++i) {
+        counters[i] = (size_t) ((hash + i * step) & sketch->mask);
+    }
+}
+
+static inline unsigned
+_cutil_CacheSketch_get(const _cutil_CacheSketch *sketch, size_t counter)
+{
+    const uint64_t word
+      = sketch->words[counter / CACHE_SKETCH_COUNTERS_PER_WORD];
+    const unsigned shift
+      = (unsigned) (counter % CACHE_SKETCH_COUNTERS_PER_WORD) * 4U;
+    return (unsigned) (word >> shift) & CACHE_SKETCH_MAX_COUNT;
+}
+
+/**
+ * Returns estimated number of recent accesses of the key with `hash`.
+ */
+static unsigned
+_cutil_CacheSketch_estimate(const _cutil_CacheSketch *sketch, cutil_hash_t hash)
+{
+    size_t counters[CACHE_SKETCH_DEPTH];
+    _cutil_CacheSketch_get_counters(sketch, hash, counters);
+    unsigned res = CACHE_SKETCH_MAX_COUNT;
+    for (size_t i = 0; i < CACHE_SKETCH_DEPTH; ++i) {
+        res = CUTIL_MIN(res, _cutil_CacheSketch_get(sketch, counters[i]));
+    }
+    return res;
+}
+
+/**
+ * Records an access of the key with `hash`. Only the smallest of its counters
+ * are incremented (conservative update), and once enough accesses have been
+ * sampled, all counters are halved.
+ */
+static void
+_cutil_CacheSketch_increment(_cutil_CacheSketch *sketch, cutil_hash_t hash)
+{
+    size_t counters[CACHE_SKETCH_DEPTH];
+    _cutil_CacheSketch_get_counters(sketch, hash, counters);
+    const unsigned min = _cutil_CacheSketch_estimate(sketch, hash);
+    if (min < CACHE_SKETCH_MAX_COUNT) {
+        for (size_t i = 0; i < CACHE_SKETCH_DEPTH; ++i) {
+            /* Re-read, since rows may share a counter */
+            if (_cutil_CacheSketch_get(sketch, counters[i]) != min) {
+                continue;
+            }
+            const size_t counter = counters[i];
+            const unsigned shift
+              = (unsigned) (counter % CACHE_SKETCH_COUNTERS_PER_WORD) * 4U;
+            sketch->words[counter / CACHE_SKETCH_COUNTERS_PER_WORD]
+              += UINT64_C(1) << shift;
+        }
+    }
+
+    if (++sketch->num_samples < sketch->sample_size) {
+        return;
+    }
+    const size_t num_words
+      = (sketch->mask + 1U) / CACHE_SKETCH_COUNTERS_PER_WORD;
+    for (size_t i = 0; i < num_words; ++i) {
+        sketch->words[i] = (sketch->words[i] >> 1U) & CACHE_SKETCH_HALVE_MASK;
+    }
+    sketch->num_samples /= 2U;
+}
+
+/**
+ * Returns index slot that refers to the entry with `key`. If there is none,
+ * returns CUTIL_ERROR_INDEX and, if `insert_slot` is not NULL, writes the
+ * first empty or dummy slot in the probe sequence of `hash` to it.
+ */
+static size_t
+_cutil_CacheMap_find_slot(
+  const _cutil_CacheMap *cache,
+  cutil_hash_t hash,
+  const void *key,
+  size_t *insert_slot
+)
+{
+    size_t free_slot = CUTIL_ERROR_INDEX;
+    for (size_t slot = hash & cache->index_mask;;
+         slot = (slot + 1U) & cache->index_mask) {
+        const size_t entry = cache->index[slot];
+        if (entry == CACHE_INDEX_EMPTY) {
+            if (insert_slot != NULL) {
+                *insert_slot = (free_slot == CUTIL_ERROR_INDEX) ? slot
+                                                                : free_slot;
+            }
+            return CUTIL_ERROR_INDEX;
+        }
+        if (entry == CACHE_INDEX_DUMMY) {
+            if (free_slot == CUTIL_ERROR_INDEX) {
+                free_slot = slot;
+            }
+            continue;
+        }
+        if (cache->hashes[entry] == hash
+            && cutil_GenericType_apply_compare(
+                 cache->key_type, key, _cutil_CacheMap_get_key_ptr(cache, entry)
+               ) == 0) {
+            return slot;
+        }
+    }
+}
+
+/**
+ * Returns number of the entry with `key`, or CUTIL_ERROR_INDEX.
+ */
+static size_t
+_cutil_CacheMap_find_entry(const _cutil_CacheMap *cache, const void *key)
+{
+    const cutil_hash_t hash = _cutil_CacheMap_hash_key(cache, key);
+    const size_t slot = _cutil_CacheMap_find_slot(cache, hash, key, NULL);
+    CUTIL_RETURN_VAL_IF_VAL(slot, CUTIL_ERROR_INDEX, CUTIL_ERROR_INDEX);
+    return cache->index[slot];
+}
+
+/**
+ * Returns index slot that refers to entry `entry`, which is not free.
+ */
+static size_t
+_cutil_CacheMap_find_slot_of_entry(const _cutil_CacheMap *cache, size_t entry)
+{
+    size_t slot = cache->hashes[entry] & cache->index_mask;
+    while (cache->index[slot] != entry) {
+        slot = (slot + 1U) & cache->index_mask;
+    }
+    return slot;
+}
+
+/**
+ * Returns smallest number of index slots for `count` entries, or 0 if no
+ * such number exists.
+ */
+static size_t
+_cutil_CacheMap_get_num_slots_for(size_t count)
+{
+    size_t num_slots = CACHE_MIN_NUM_SLOTS;
+    while (num_slots / 2U < count) {
+        if (num_slots > CUTIL_ERROR_INDEX / 4U) {
+            return 0UL;
+        }
+        num_slots *= 2U;
+    }
+    return num_slots;
+}
+
+static inline size_t
+_cutil_CacheMap_renumber(const size_t *renumber, size_t entry)
+{
+    return (entry == CACHE_NO_ENTRY) ? CACHE_NO_ENTRY : renumber[entry];
+}
+
+/**
+ * Moves the entries that are not free to the front, keeping the order of all
+ * segment lists. Entries are relocated bytewise.
+ */
+static void
+_cutil_CacheMap_compact(_cutil_CacheMap *cache)
+{
+    const size_t key_size = cache->key_type->size;
+    const size_t val_size = cache->val_type->size;
+    size_t *const renumber = CUTIL_MALLOC_MULT(renumber, cache->num_used);
+    size_t num = 0UL;
+    for (size_t i = 0; i < cache->num_used; ++i) {
+        if (cache->segments[i] == CACHE_SEGMENT_FREE) {
+            renumber[i] = CACHE_NO_ENTRY;
+            continue;
+        }
+        renumber[i] = num;
+        if (i != num) {
+            cache->hashes[num] = cache->hashes[i];
+            cache->weights[num] = cache->weights[i];
+            cache->prev[num] = cache->prev[i];
+            cache->next[num] = cache->next[i];
+            cache->segments[num] = cache->segments[i];
+            memcpy(
+              _cutil_CacheMap_get_key_ptr(cache, num),
+              _cutil_CacheMap_get_key_ptr(cache, i), key_size
+            );
+            memcpy(
+              _cutil_CacheMap_get_val_ptr(cache, num),
+              _cutil_CacheMap_get_val_ptr(cache, i), val_size
+            );
+        }
+        ++num;
+    }
+    for (size_t i = 0; i < num; ++i) {
+        cache->prev[i] = _cutil_CacheMap_renumber(renumber, cache->prev[i]);
+        cache->next[i] = _cutil_CacheMap_renumber(renumber, cache->next[i]);
+    }
+    for (size_t i = 0; i < CACHE_NUM_SEGMENTS; ++i) {
+        _cutil_CacheList *const list = &cache->lists[i];
+        list->head = _cutil_CacheMap_renumber(renumber, list->head);
+        list->tail = _cutil_CacheMap_renumber(renumber, list->tail);
+    }
+    free(renumber);
+    cache->num_used = num;
+    cache->free_entry = CACHE_NO_ENTRY;
+}
+
+/**
+ * Adds entry `entry` to an index without dummy slots.
+ */
+static void
+_cutil_CacheMap_index_entry(_cutil_CacheMap *cache, size_t entry)
+{
+    size_t slot = cache->hashes[entry] & cache->index_mask;
+    while (cache->index[slot] != CACHE_INDEX_EMPTY) {
+        slot = (slot + 1U) & cache->index_mask;
+    }
+    cache->index[slot] = entry;
+}
+
+/**
+ * Replaces the index by one of `num_slots` slots referring to all entries,
+ * none of which may be free, and resizes the entry arrays accordingly.
+ */
+static void
+_cutil_CacheMap_rebuild(_cutil_CacheMap *cache, size_t num_slots)
+{
+    const size_t capacity = num_slots / 2U;
+    cache->entry_capacity = capacity;
+    cache->hashes = realloc(cache->hashes, capacity * sizeof *cache->hashes);
+    cache->weights
+      = realloc(cache->weights, capacity * sizeof *cache->weights);
+    cache->prev = realloc(cache->prev, capacity * sizeof *cache->prev);
+    cache->next = realloc(cache->next, capacity * sizeof *cache->next);
+    cache->segments
+      = realloc(cache->segments, capacity * sizeof *cache->segments);
+    cache->keys = realloc(cache->keys, capacity * cache->key_type->size);
+    cache->vals = realloc(cache->vals, capacity * cache->val_type->size);
+
+    free(cache->index);
+    cache->index_mask = num_slots - 1U;
+    cache->num_dummies = 0UL;
+    cache->index = CUTIL_MALLOC_MULT(cache->index, num_slots);
+    memset(cache->index, 0xFF, num_slots * sizeof *cache->index);
+    for (size_t i = 0; i < cache->num_used; ++i) {
+        _cutil_CacheMap_index_entry(cache, i);
+    }
+
+    if (cache->policy->uses_sketch) {
+        _cutil_CacheSketch_ensure(&cache->sketch, capacity);
+    }
+}
+
+/**
+ * Compacts the entries and rebuilds the index for room for `count` entries.
+ */
+static cutil_Status
+_cutil_CacheMap_resize(_cutil_CacheMap *cache, size_t count)
+{
+    const size_t num_slots
+      = _cutil_CacheMap_get_num_slots_for(CUTIL_MAX(count, cache->count));
+    if (num_slots == 0UL) {
+        cutil_log_warn("CacheMap: capacity %zu is too large", count);
+        return CUTIL_STATUS_FAILURE;
+    }
+    cutil_log_debug(
+      "CacheMap: resizing index to %zu slots, dropping %zu free entries",
+      num_slots, cache->num_used - cache->count
+    );
+    if (cache->num_used != cache->count) {
+        _cutil_CacheMap_compact(cache);
+    }
+    _cutil_CacheMap_rebuild(cache, num_slots);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+/**
+ * Initializes `cache`, whose types and policy are set, without entries and
+ * with room for `count` of them.
+ */
+static void
+_cutil_CacheMap_init(_cutil_CacheMap *cache, size_t count)
+{
+    cache->count = 0UL;
+    cache->num_used = 0UL;
+    cache->free_entry = CACHE_NO_ENTRY;
+    cache->hashes = NULL;
+    cache->weights = NULL;
+    cache->prev = NULL;
+    cache->next = NULL;
+    cache->segments = NULL;
+    cache->keys = NULL;
+    cache->vals = NULL;
+    cache->index = NULL;
+    for (size_t i = 0; i < CACHE_NUM_SEGMENTS; ++i) {
+        cache->lists[i].head = CACHE_NO_ENTRY;
+        cache->lists[i].tail = CACHE_NO_ENTRY;
+        cache->lists[i].weight = 0UL;
+    }
+    memset(&cache->sketch, 0, sizeof cache->sketch);
+    memset(&cache->stats, 0, sizeof cache->stats);
+    _cutil_CacheMap_rebuild(cache, _cutil_CacheMap_get_num_slots_for(count));
+}
+
+/**
+ * Removes the entry referred to by index slot `slot`.
+ */
+static void
+_cutil_CacheMap_erase(_cutil_CacheMap *cache, size_t slot)
+{
+    const size_t entry = cache->index[slot];
+    cache->index[slot] = CACHE_INDEX_DUMMY;
+    ++cache->num_dummies;
+    _cutil_CacheMap_unlink(cache, entry);
+    cutil_GenericType_apply_clear(
+      cache->key_type, _cutil_CacheMap_get_key_ptr(cache, entry)
+    );
+    cutil_GenericType_apply_clear(
+      cache->val_type, _cutil_CacheMap_get_val_ptr(cache, entry)
+    );
+    cache->segments[entry] = CACHE_SEGMENT_FREE;
+    cache->next[entry] = cache->free_entry;
+    cache->free_entry = entry;
+    --cache->count;
+}
+
+static inline void
+_cutil_CacheMap_erase_entry(_cutil_CacheMap *cache, size_t entry)
+{
+    _cutil_CacheMap_erase(
+      cache, _cutil_CacheMap_find_slot_of_entry(cache, entry)
+    );
+}
+
+/**
+ * Evicts least recently used entries, from probation first, until the total
+ * weight is within the budget. Entry `pinned`, which is being inserted or
+ * updated, is never evicted.
+ */
+static void
+_cutil_CacheMap_enforce_budget(_cutil_CacheMap *cache, size_t pinned)
+{
+    static const unsigned order[CACHE_NUM_SEGMENTS] = {
+      CACHE_SEGMENT_PROBATION, CACHE_SEGMENT_PROTECTED, CACHE_SEGMENT_WINDOW
+    };
+    for (size_t i = 0; i < CACHE_NUM_SEGMENTS; ++i) {
+        size_t entry = cache->lists[order[i]].tail;
+        while (entry != CACHE_NO_ENTRY
+               && _cutil_CacheMap_get_total_weight(cache) > cache->max_weight) {
+            const size_t prev = cache->prev[entry];
+            if (entry != pinned) {
+                _cutil_CacheMap_erase_entry(cache, entry);
+                ++cache->stats.evictions;
+            }
+            entry = prev;
+        }
+    }
+}
+
+static void
+_cutil_CacheMap_lru_on_access(_cutil_CacheMap *cache, size_t entry)
+{
+    _cutil_CacheMap_move_to_front(cache, CACHE_SEGMENT_WINDOW, entry);
+}
+
+static void
+_cutil_CacheMap_lru_on_insert(_cutil_CacheMap *cache, size_t entry)
+{
+    _cutil_CacheMap_link(cache, CACHE_SEGMENT_WINDOW, entry);
+}
+
+static void
+_cutil_CacheMap_tinylfu_on_access(_cutil_CacheMap *cache, size_t entry)
+{
+    _cutil_CacheSketch_increment(&cache->sketch, cache->hashes[entry]);
+    if (cache->segments[entry] == CACHE_SEGMENT_WINDOW) {
+        _cutil_CacheMap_move_to_front(cache, CACHE_SEGMENT_WINDOW, entry);
+        return;
+    }
+
+    /* Entries on probation are promoted, which may demote protected ones */
+    _cutil_CacheMap_move_to_front(cache, CACHE_SEGMENT_PROTECTED, entry);
+    const _cutil_CacheList *const protected_list
+      = &cache->lists[CACHE_SEGMENT_PROTECTED];
+    while (protected_list->weight > cache->max_protected_weight
+           && protected_list->tail != entry) {
+        _cutil_CacheMap_move_to_front(
+          cache, CACHE_SEGMENT_PROBATION, protected_list->tail
+        );
+    }
+}
+
+/**
+ * Moves `candidate`, which left the window, to probation. If this exceeds the
+ * budget, the candidate competes with the least recently used entries of the
+ * main region: whichever is estimated to be accessed less often is evicted.
+ */
+static void
+_cutil_CacheMap_tinylfu_admit(_cutil_CacheMap *cache, size_t candidate)
+{
+    _cutil_CacheMap_link(cache, CACHE_SEGMENT_PROBATION, candidate);
+    const unsigned freq
+      = _cutil_CacheSketch_estimate(&cache->sketch, cache->hashes[candidate]);
+    while (_cutil_CacheMap_get_total_weight(cache) > cache->max_weight) {
+        size_t victim = cache->lists[CACHE_SEGMENT_PROBATION].tail;
+        if (victim == candidate) {
+            victim = cache->lists[CACHE_SEGMENT_PROTECTED].tail;
+        }
+        CUTIL_RETURN_IF_VAL(victim, CACHE_NO_ENTRY);
+        const unsigned victim_freq
+          = _cutil_CacheSketch_estimate(&cache->sketch, cache->hashes[victim]);
+        if (freq <= victim_freq) {
+            _cutil_CacheMap_erase_entry(cache, candidate);
+            ++cache->stats.rejections;
+            return;
+        }
+        _cutil_CacheMap_erase_entry(cache, victim);
+        ++cache->stats.evictions;
+    }
+}
+
+static void
+_cutil_CacheMap_tinylfu_on_insert(_cutil_CacheMap *cache, size_t entry)
+{
+    _cutil_CacheSketch_increment(&cache->sketch, cache->hashes[entry]);
+    _cutil_CacheMap_link(cache, CACHE_SEGMENT_WINDOW, entry);
+    const _cutil_CacheList *const window = &cache->lists[CACHE_SEGMENT_WINDOW];
+    while (window->weight > cache->max_window_weight && window->tail != entry) {
+        const size_t candidate = window->tail;
+        _cutil_CacheMap_unlink(cache, candidate);
+        _cutil_CacheMap_tinylfu_admit(cache, candidate);
+    }
+}
+
+static const cutil_CachePolicy CUTIL_CACHE_POLICY_LRU_OBJECT = {
+  .name = "LRU",
+  .uses_sketch = false,
+  .on_access = &_cutil_CacheMap_lru_on_access,
+  .on_insert = &_cutil_CacheMap_lru_on_insert,
+};
+
+const cutil_CachePolicy *const CUTIL_CACHE_POLICY_LRU
+  = &CUTIL_CACHE_POLICY_LRU_OBJECT;
+
+static const cutil_CachePolicy CUTIL_CACHE_POLICY_TINYLFU_OBJECT = {
+  .name = "W-TinyLFU",
+  .uses_sketch = true,
+  .on_access = &_cutil_CacheMap_tinylfu_on_access,
+  .on_insert = &_cutil_CacheMap_tinylfu_on_insert,
+};
+
+const cutil_CachePolicy *const CUTIL_CACHE_POLICY_TINYLFU
+  = &CUTIL_CACHE_POLICY_TINYLFU_OBJECT;
+
+/**
+ * Returns a free entry, or CUTIL_ERROR_INDEX if the entry arrays are full.
+ */
+static size_t
+_cutil_CacheMap_alloc_entry(_cutil_CacheMap *cache)
+{
+    const size_t entry = cache->free_entry;
+    if (entry != CACHE_NO_ENTRY) {
+        cache->free_entry = cache->next[entry];
+        return entry;
+    }
+    CUTIL_RETURN_VAL_IF_VAL(
+      cache->num_used, cache->entry_capacity, CUTIL_ERROR_INDEX
+    );
+    return cache->num_used++;
+}
+
+/**
+ * Inserts [`key`, `val`] with hash `hash` into index slot `insert_slot`, as
+ * found by '_cutil_CacheMap_find_slot', and evicts entries to stay within the
+ * budget. Returns the new entry, or CUTIL_ERROR_INDEX if it is not inserted.
+ */
+static size_t
+_cutil_CacheMap_insert(
+  _cutil_CacheMap *cache,
+  cutil_hash_t hash,
+  const void *key,
+  const void *val,
+  size_t insert_slot
+)
+{
+    const size_t weight = _cutil_CacheMap_weigh(cache, key, val);
+    if (weight > cache->max_weight) {
+        cutil_log_warn(
+          "CacheMap: entry weight %zu exceeds budget %zu", weight,
+          cache->max_weight
+        );
+        ++cache->stats.rejections;
+        return CUTIL_ERROR_INDEX;
+    }
+
+    const cutil_Bool is_full = cache->free_entry == CACHE_NO_ENTRY
+                            && cache->num_used == cache->entry_capacity;
+    const size_t num_slots = cache->index_mask + 1U;
+    if (is_full || (cache->count + cache->num_dummies) * 4U >= num_slots * 3U) {
+        /* Leaves room for the new entry once dummies are dropped */
+        const size_t count
+          = is_full ? 2U * cache->count + 1U : cache->count + 1U;
+        if (_cutil_CacheMap_resize(cache, count) != CUTIL_STATUS_SUCCESS) {
+            return CUTIL_ERROR_INDEX;
+        }
+        _cutil_CacheMap_find_slot(cache, hash, key, &insert_slot);
+    }
+
+    const size_t entry = _cutil_CacheMap_alloc_entry(cache);
+    if (entry == CUTIL_ERROR_INDEX) {
+        cutil_log_warn("CacheMap: no free entry after resizing");
+        return CUTIL_ERROR_INDEX;
+    }
+    void *const key_ptr = _cutil_CacheMap_get_key_ptr(cache, entry);
+    void *const val_ptr = _cutil_CacheMap_get_val_ptr(cache, entry);
+    cutil_GenericType_apply_init(cache->key_type, key_ptr);
+    cutil_GenericType_apply_copy(cache->key_type, key_ptr, key);
+    cutil_GenericType_apply_init(cache->val_type, val_ptr);
+    cutil_GenericType_apply_copy(cache->val_type, val_ptr, val);
+    cache->hashes[entry] = hash;
+    cache->weights[entry] = weight;
+    if (cache->index[insert_slot] == CACHE_INDEX_DUMMY) {
+        --cache->num_dummies;
+    }
+    cache->index[insert_slot] = entry;
+    ++cache->count;
+
+    cache->policy->on_insert(cache, entry);
+    _cutil_CacheMap_enforce_budget(cache, entry);
+    return entry;
+}
+
+/**
+ * Returns the entry with `key`, or CUTIL_ERROR_INDEX, and records the lookup.
+ * Lookups take `cache` by const pointer, which is cast away here.
+ */
+static size_t
+_cutil_CacheMap_access(const _cutil_CacheMap *cache, const void *key)
+{
+    _cutil_CacheMap *const mut_cache = CUTIL_CONST_CAST(cache);
+    const size_t entry = _cutil_CacheMap_find_entry(cache, key);
+    if (entry == CUTIL_ERROR_INDEX) {
+        ++mut_cache->stats.misses;
+        return CUTIL_ERROR_INDEX;
+    }
+    ++mut_cache->stats.hits;
+    cache->policy->on_access(mut_cache, entry);
+    return entry;
+}
+
+/**
+ * Allocates a cache map in which every entry weighs 1 unless changed.
+ */
+static cutil_Map *
+_cutil_CacheMap_alloc(
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type,
+  size_t max_weight,
+  cutil_CacheWeigher *weigher,
+  const cutil_CachePolicy *policy
+)
+{
+    if (!cutil_GenericType_is_valid(key_type)) {
+        cutil_log_warn("Key type is not valid");
+        return NULL;
+    }
+    if (!cutil_GenericType_is_valid(val_type)) {
+        cutil_log_warn("Value type is not valid");
+        return NULL;
+    }
+    if (max_weight == 0UL) {
+        cutil_log_warn("CacheMap: budget must not be 0");
+        return NULL;
+    }
+    if (policy == NULL) {
+        cutil_log_warn("CacheMap: eviction policy is NULL");
+        return NULL;
+    }
+
+    cutil_Map *const map = CUTIL_MALLOC_OBJECT(map);
+
+    map->vtable = CUTIL_MAP_TYPE_CACHE;
+    _cutil_CacheMap *const cache = map->data = CUTIL_MALLOC_OBJECT(cache);
+
+    cache->key_type = key_type;
+    cache->val_type = val_type;
+    cache->policy = policy;
+    cache->weigher = weigher;
+    cache->fixed_weight = 1UL;
+    cache->max_weight = max_weight;
+    cache->max_window_weight = max_weight;
+    cache->max_protected_weight = 0UL;
+    if (policy->uses_sketch) {
+        const size_t window = CUTIL_MAX(
+          max_weight / 100U * CACHE_WINDOW_PERCENT
+            + max_weight % 100U * CACHE_WINDOW_PERCENT / 100U,
+          1UL
+        );
+        const size_t main = max_weight - CUTIL_MIN(window, max_weight);
+        cache->max_window_weight = window;
+        cache->max_protected_weight
+          = main / 100U * CACHE_PROTECTED_PERCENT
+          + main % 100U * CACHE_PROTECTED_PERCENT / 100U;
+    }
+    _cutil_CacheMap_init(cache, 0UL);
+
+    return map;
+}
+
+cutil_Map *
+cutil_CacheMap_alloc(
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type,
+  size_t max_entries,
+  const cutil_CachePolicy *policy
+)
+{
+    return _cutil_CacheMap_alloc(
+      key_type, val_type, max_entries, NULL, policy
+    );
+}
+
+cutil_Map *
+cutil_CacheMap_alloc_with_budget(
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type,
+  size_t max_weight,
+  cutil_CacheWeigher *weigher,
+  const cutil_CachePolicy *policy
+)
+{
+    cutil_Map *const map
+      = _cutil_CacheMap_alloc(key_type, val_type, max_weight, weigher, policy);
+    CUTIL_RETURN_NULL_IF_NULL(map);
+    _cutil_CacheMap *const cache = map->data;
+    cache->fixed_weight = key_type->size + val_type->size;
+    return map;
+}
+
+size_t
+cutil_CacheMap_get_weight(const cutil_Map *map)
+{
+    CUTIL_RETURN_VAL_IF_NULL(map, 0UL);
+    CUTIL_CACHEMAP_TYPE_CHECK(map);
+
+    return _cutil_CacheMap_get_total_weight(map->data);
+}
+
+cutil_Status
+cutil_CacheMap_get_stats(const cutil_Map *map, cutil_CacheStats *stats)
+{
+    CUTIL_NULL_CHECK(map);
+    CUTIL_NULL_CHECK(stats);
+    CUTIL_CACHEMAP_TYPE_CHECK(map);
+
+    const _cutil_CacheMap *const cache = map->data;
+    *stats = cache->stats;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+void
+cutil_CacheMap_reset_stats(cutil_Map *map)
+{
+    CUTIL_RETURN_IF_NULL(map);
+    CUTIL_CACHEMAP_TYPE_CHECK(map);
+
+    _cutil_CacheMap *const cache = map->data;
+    memset(&cache->stats, 0, sizeof cache->stats);
+}
+
+double
+cutil_CacheStats_get_hit_rate(const cutil_CacheStats *stats)
+{
+    CUTIL_RETURN_VAL_IF_NULL(stats, 0.0);
+    const size_t num_lookups = stats->hits + stats->misses;
+    CUTIL_RETURN_VAL_IF_VAL(num_lookups, 0UL, 0.0);
+    return (double) stats->hits / (double) num_lookups;
+}
+
+static void
+_cutil_CacheMap_free_entries(_cutil_CacheMap *cache)
+{
+    for (size_t i = 0; i < cache->num_used; ++i) {
+        if (cache->segments[i] == CACHE_SEGMENT_FREE) {
+            continue;
+        }
+        cutil_GenericType_apply_clear(
+          cache->key_type, _cutil_CacheMap_get_key_ptr(cache, i)
+        );
+        cutil_GenericType_apply_clear(
+          cache->val_type, _cutil_CacheMap_get_val_ptr(cache, i)
+        );
+    }
+    free(cache->hashes);
+    free(cache->weights);
+    free(cache->prev);
+    free(cache->next);
+    free(cache->segments);
+    free(cache->keys);
+    free(cache->vals);
+    free(cache->index);
+    free(cache->sketch.words);
+}
+
+static void
+_cutil_CacheMap_free(void *data)
+{
+    _cutil_CacheMap *const cache = data;
+    CUTIL_RETURN_IF_NULL(cache);
+    _cutil_CacheMap_free_entries(cache);
+    free(cache);
+}
+
+static void
+_cutil_CacheMap_reset(void *data)
+{
+    _cutil_CacheMap *const cache = data;
+    _cutil_CacheMap_free_entries(cache);
+    _cutil_CacheMap_init(cache, 0UL);
+}
+
+static void
+_cutil_CacheMap_copy(void *dst, const void *src)
+{
+    _cutil_CacheMap *const dst_cache = dst;
+    const _cutil_CacheMap *const src_cache = src;
+    CUTIL_RETURN_IF_VAL(dst_cache, src_cache);
+
+    _cutil_CacheMap_free_entries(dst_cache);
+    dst_cache->policy = src_cache->policy;
+    dst_cache->weigher = src_cache->weigher;
+    dst_cache->fixed_weight = src_cache->fixed_weight;
+    dst_cache->max_weight = src_cache->max_weight;
+    dst_cache->max_window_weight = src_cache->max_window_weight;
+    dst_cache->max_protected_weight = src_cache->max_protected_weight;
+    _cutil_CacheMap_init(dst_cache, src_cache->num_used);
+
+    /* Entries keep their numbers, so that the lists carry over */
+    const size_t num = src_cache->num_used;
+    for (size_t i = 0; i < num; ++i) {
+        dst_cache->segments[i] = src_cache->segments[i];
+        if (src_cache->segments[i] == CACHE_SEGMENT_FREE) {
+            continue;
+        }
+        void *const key = _cutil_CacheMap_get_key_ptr(dst_cache, i);
+        void *const val = _cutil_CacheMap_get_val_ptr(dst_cache, i);
+        cutil_GenericType_apply_init(dst_cache->key_type, key);
+        cutil_GenericType_apply_copy(
+          dst_cache->key_type, key, _cutil_CacheMap_get_key_ptr(src_cache, i)
+        );
+        cutil_GenericType_apply_init(dst_cache->val_type, val);
+        cutil_GenericType_apply_copy(
+          dst_cache->val_type, val, _cutil_CacheMap_get_val_ptr(src_cache, i)
+        );
+        dst_cache->hashes[i] = src_cache->hashes[i];
+        _cutil_CacheMap_index_entry(dst_cache, i);
+    }
+    memcpy(dst_cache->weights, src_cache->weights, num * sizeof(size_t));
+    memcpy(dst_cache->prev, src_cache->prev, num * sizeof(size_t));
+    memcpy(dst_cache->next, src_cache->next, num * sizeof(size_t));
+    memcpy(dst_cache->lists, src_cache->lists, sizeof src_cache->lists);
+    dst_cache->count = src_cache->count;
+    dst_cache->num_used = num;
+    dst_cache->free_entry = src_cache->free_entry;
+
+    if (src_cache->policy->uses_sketch) {
+        const size_t num_words
+          = (src_cache->sketch.mask + 1U) / CACHE_SKETCH_COUNTERS_PER_WORD;
+        free(dst_cache->sketch.words);
+        dst_cache->sketch = src_cache->sketch;
+        dst_cache->sketch.words = CUTIL_MALLOC_MULT(
+          dst_cache->sketch.words, num_words
+        );
+        memcpy(
+          dst_cache->sketch.words, src_cache->sketch.words,
+          num_words * sizeof *src_cache->sketch.words
+        );
+    }
+    dst_cache->stats = src_cache->stats;
+}
+
+static void *
+_cutil_CacheMap_duplicate(const void *data)
+{
+    const _cutil_CacheMap *const src = data;
+    _cutil_CacheMap *const dst = CUTIL_MALLOC_OBJECT(dst);
+    dst->key_type = src->key_type;
+    dst->val_type = src->val_type;
+    dst->policy = src->policy;
+    _cutil_CacheMap_init(dst, 0UL);
+    _cutil_CacheMap_copy(dst, src);
+    return dst;
+}
+
+static size_t
+_cutil_CacheMap_get_count(const void *data)
+{
+    const _cutil_CacheMap *const cache = data;
+    return cache->count;
+}
+
+static cutil_Status
+_cutil_CacheMap_remove(void *data, const void *key)
+{
+    _cutil_CacheMap *const cache = data;
+    const cutil_hash_t hash = _cutil_CacheMap_hash_key(cache, key);
+    const size_t slot = _cutil_CacheMap_find_slot(cache, hash, key, NULL);
+    if (slot == CUTIL_ERROR_INDEX) {
+        cutil_log_warn("CacheMap remove: key not found");
+        return CUTIL_STATUS_FAILURE;
+    }
+    _cutil_CacheMap_erase(cache, slot);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Bool
+_cutil_CacheMap_contains(const void *data, const void *key)
+{
+    const size_t entry = _cutil_CacheMap_find_entry(data, key);
+    return CUTIL_BOOLIFY(entry != CUTIL_ERROR_INDEX);
+}
+
+static const void *
+_cutil_CacheMap_get_ptr(const void *data, const void *key)
+{
+    const _cutil_CacheMap *const cache = data;
+    const size_t entry = _cutil_CacheMap_access(cache, key);
+    CUTIL_RETURN_VAL_IF_VAL(entry, CUTIL_ERROR_INDEX, NULL);
+    return _cutil_CacheMap_get_val_ptr(cache, entry);
+}
+
+static const void *
+_cutil_CacheMap_peek_ptr(const void *data, const void *key)
+{
+    const _cutil_CacheMap *const cache = data;
+    const size_t entry = _cutil_CacheMap_find_entry(cache, key);
+    CUTIL_RETURN_VAL_IF_VAL(entry, CUTIL_ERROR_INDEX, NULL);
+    return _cutil_CacheMap_get_val_ptr(cache, entry);
+}
+
+static cutil_Status
+_cutil_CacheMap_get(const void *data, const void *key, void *val)
+{
+    const _cutil_CacheMap *const cache = data;
+    const void *const p = _cutil_CacheMap_get_ptr(cache, key);
+    if (p == NULL) {
+        cutil_log_debug("CacheMap get: key not found");
+        return CUTIL_STATUS_FAILURE;
+    }
+    cutil_GenericType_apply_copy(cache->val_type, val, p);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static void *
+_cutil_CacheMap_get_or_insert(
+  void *data, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    _cutil_CacheMap *const cache = data;
+    if (inserted != NULL) {
+        *inserted = CUTIL_FALSE;
+    }
+    const cutil_hash_t hash = _cutil_CacheMap_hash_key(cache, key);
+    size_t insert_slot;
+    const size_t slot
+      = _cutil_CacheMap_find_slot(cache, hash, key, &insert_slot);
+    if (slot != CUTIL_ERROR_INDEX) {
+        const size_t entry = cache->index[slot];
+        ++cache->stats.hits;
+        cache->policy->on_access(cache, entry);
+        return _cutil_CacheMap_get_val_ptr(cache, entry);
+    }
+
+    ++cache->stats.misses;
+    const size_t entry
+      = _cutil_CacheMap_insert(cache, hash, key, val, insert_slot);
+    CUTIL_RETURN_VAL_IF_VAL(entry, CUTIL_ERROR_INDEX, NULL);
+    if (inserted != NULL) {
+        *inserted = CUTIL_TRUE;
+    }
+    return _cutil_CacheMap_get_val_ptr(cache, entry);
+}
+
+static cutil_Status
+_cutil_CacheMap_set(void *data, const void *key, const void *val)
+{
+    _cutil_CacheMap *const cache = data;
+    const cutil_hash_t hash = _cutil_CacheMap_hash_key(cache, key);
+    size_t insert_slot;
+    const size_t slot
+      = _cutil_CacheMap_find_slot(cache, hash, key, &insert_slot);
+    if (slot == CUTIL_ERROR_INDEX) {
+        const size_t entry
+          = _cutil_CacheMap_insert(cache, hash, key, val, insert_slot);
+        CUTIL_RETURN_VAL_IF_VAL(entry, CUTIL_ERROR_INDEX, CUTIL_STATUS_FAILURE);
+        return CUTIL_STATUS_SUCCESS;
+    }
+
+    const size_t entry = cache->index[slot];
+    const size_t weight = _cutil_CacheMap_weigh(cache, key, val);
+    if (weight > cache->max_weight) {
+        cutil_log_warn(
+          "CacheMap: entry weight %zu exceeds budget %zu", weight,
+          cache->max_weight
+        );
+        return CUTIL_STATUS_FAILURE;
+    }
+    cutil_GenericType_apply_copy(
+      cache->val_type, _cutil_CacheMap_get_val_ptr(cache, entry), val
+    );
+    _cutil_CacheList *const list = &cache->lists[cache->segments[entry]];
+    list->weight = list->weight - cache->weights[entry] + weight;
+    cache->weights[entry] = weight;
+    cache->policy->on_access(cache, entry);
+    _cutil_CacheMap_enforce_budget(cache, entry);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_CacheMap_reserve(void *data, size_t count)
+{
+    _cutil_CacheMap *const cache = data;
+    if (count <= cache->entry_capacity) {
+        return CUTIL_STATUS_SUCCESS;
+    }
+    return _cutil_CacheMap_resize(cache, count);
+}
+
+static cutil_Status
+_cutil_CacheMap_shrink_to_fit(void *data)
+{
+    _cutil_CacheMap *const cache = data;
+    const size_t num_slots = _cutil_CacheMap_get_num_slots_for(cache->count);
+    if (num_slots == cache->index_mask + 1U
+        && cache->num_used == cache->count) {
+        return CUTIL_STATUS_SUCCESS;
+    }
+    return _cutil_CacheMap_resize(cache, cache->count);
+}
+
+static const cutil_GenericType *
+_cutil_CacheMap_get_key_type(const void *data)
+{
+    const _cutil_CacheMap *const cache = data;
+    return cache->key_type;
+}
+
+static const cutil_GenericType *
+_cutil_CacheMap_get_val_type(const void *data)
+{
+    const _cutil_CacheMap *const cache = data;
+    return cache->val_type;
+}
+
+/**
+ * Iterates over the entries in storage order. Since removals only free
+ * entries, removing the current key keeps the iterator valid.
+ */
+typedef struct {
+    _cutil_CacheMap *cache;
+    size_t pos;   /**< next entry to visit */
+    size_t entry; /**< current entry, or CUTIL_ERROR_INDEX */
+} _cutil_CacheMapIter;
+
+static void
+_cutil_CacheMapIter_rewind(void *data)
+{
+    _cutil_CacheMapIter *const iter = data;
+    iter->pos = 0UL;
+    iter->entry = CUTIL_ERROR_INDEX;
+}
+
+static void
+_cutil_CacheMapIter_free(void *data)
+{
+    free(data);
+}
+
+static cutil_Bool
+_cutil_CacheMapIter_next(void *data)
+{
+    _cutil_CacheMapIter *const iter = data;
+    const _cutil_CacheMap *const cache = iter->cache;
+    while (iter->pos < cache->num_used) {
+        const size_t entry = iter->pos++;
+        if (cache->segments[entry] != CACHE_SEGMENT_FREE) {
+            iter->entry = entry;
+            return CUTIL_TRUE;
+        }
+    }
+    iter->entry = CUTIL_ERROR_INDEX;
+    return CUTIL_FALSE;
+}
+
+static const void *
+_cutil_CacheMapIter_get_ptr(const void *data)
+{
+    const _cutil_CacheMapIter *const iter = data;
+    CUTIL_RETURN_VAL_IF_VAL(iter->entry, CUTIL_ERROR_INDEX, NULL);
+    return _cutil_CacheMap_get_key_ptr(iter->cache, iter->entry);
+}
+
+static cutil_Status
+_cutil_CacheMapIter_get(const void *data, void *out)
+{
+    const _cutil_CacheMapIter *const iter = data;
+    const void *const p = _cutil_CacheMapIter_get_ptr(data);
+    CUTIL_RETURN_VAL_IF_NULL(p, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(iter->cache->key_type, out, p);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_CacheMapIter_remove(void *data)
+{
+    _cutil_CacheMapIter *const iter = data;
+    CUTIL_RETURN_VAL_IF_VAL(
+      iter->entry, CUTIL_ERROR_INDEX, CUTIL_STATUS_FAILURE
+    );
+    _cutil_CacheMap_erase_entry(iter->cache, iter->entry);
+    iter->entry = CUTIL_ERROR_INDEX;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static _cutil_CacheMapIter *
+_cutil_CacheMapIter_alloc(const _cutil_CacheMap *cache)
+{
+    _cutil_CacheMapIter *const iter = CUTIL_MALLOC_OBJECT(iter);
+    iter->cache = CUTIL_CONST_CAST(cache);
+    _cutil_CacheMapIter_rewind(iter);
+    return iter;
+}
+
+static const cutil_ConstIteratorType CUTIL_CONST_ITERATOR_TYPE_CACHE_OBJECT = {
+  .name = "cutil_ConstIterator<cutil_CacheMap>",
+  .free = &_cutil_CacheMapIter_free,
+  .rewind = &_cutil_CacheMapIter_rewind,
+  .next = &_cutil_CacheMapIter_next,
+  .get = &_cutil_CacheMapIter_get,
+  .get_ptr = &_cutil_CacheMapIter_get_ptr,
+};
+
+const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_CACHE
+  = &CUTIL_CONST_ITERATOR_TYPE_CACHE_OBJECT;
+
+static const cutil_IteratorType CUTIL_ITERATOR_TYPE_CACHE_OBJECT = {
+  .name = "cutil_Iterator<cutil_CacheMap>",
+  .free = &_cutil_CacheMapIter_free,
+  .rewind = &_cutil_CacheMapIter_rewind,
+  .next = &_cutil_CacheMapIter_next,
+  .get = &_cutil_CacheMapIter_get,
+  .get_ptr = &_cutil_CacheMapIter_get_ptr,
+  .set = NULL,
+  .remove = &_cutil_CacheMapIter_remove,
+};
+
+const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_CACHE
+  = &CUTIL_ITERATOR_TYPE_CACHE_OBJECT;
+
+static cutil_ConstIterator *
+_cutil_CacheMap_get_const_iterator(const void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_ConstIterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_CONST_ITERATOR_TYPE_CACHE;
+    it->data = _cutil_CacheMapIter_alloc(data);
+
+    cutil_log_debug("CacheMap: created const iterator");
+    return it;
+}
+
+static cutil_Iterator *
+_cutil_CacheMap_get_iterator(void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_Iterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_ITERATOR_TYPE_CACHE;
+    it->data = _cutil_CacheMapIter_alloc(data);
+
+    cutil_log_debug("CacheMap: created iterator");
+    return it;
+}
+
+static const cutil_MapType CUTIL_MAP_TYPE_CACHE_OBJECT = {
+  .name = "cutil_CacheMap",
+  .free = &_cutil_CacheMap_free,
+  .reset = &_cutil_CacheMap_reset,
+  .copy = &_cutil_CacheMap_copy,
+  .duplicate = &_cutil_CacheMap_duplicate,
+  .get_count = &_cutil_CacheMap_get_count,
+  .remove = &_cutil_CacheMap_remove,
+  .contains = &_cutil_CacheMap_contains,
+  .get = &_cutil_CacheMap_get,
+  .get_ptr = &_cutil_CacheMap_get_ptr,
+  .set = &_cutil_CacheMap_set,
+  .get_or_insert = &_cutil_CacheMap_get_or_insert,
+  .reserve = &_cutil_CacheMap_reserve,
+  .shrink_to_fit = &_cutil_CacheMap_shrink_to_fit,
+  .get_key_type = &_cutil_CacheMap_get_key_type,
+  .get_val_type = &_cutil_CacheMap_get_val_type,
+  .get_const_iterator = &_cutil_CacheMap_get_const_iterator,
+  .get_iterator = &_cutil_CacheMap_get_iterator,
+  .peek_ptr = &_cutil_CacheMap_peek_ptr,
+};
+
+const cutil_MapType *const CUTIL_MAP_TYPE_CACHE = &CUTIL_MAP_TYPE_CACHE_OBJECT;
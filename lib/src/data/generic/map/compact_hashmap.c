@@ -0,0 +1,758 @@
+#include <cutil/data/generic/map/compact_hashmap.h>
+
+#include <cutil/io/log.h>
+#include <cutil/status.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/util/hash.h>
+#include <cutil/util/macro.h>
+
+/*
+ * Layout of CPython's dict. Entries (hash, key, value) are appended to dense
+ * arrays, and removed entries are only marked until the next resize compacts
+ * them. The index is a linear-probing table of entry numbers whose slot
+ * width depends on its size. At most two thirds of the index slots refer to
+ * entries, removed ones included, so every probe ends at an empty slot.
+ */
+#define COMPACT_HASHMAP_MIN_NUM_SLOTS ((size_t) 8)
+#define COMPACT_HASHMAP_INDEX_EMPTY CUTIL_ERROR_INDEX
+#define COMPACT_HASHMAP_INDEX_DUMMY (CUTIL_ERROR_INDEX - 1U)
+/* Hash of removed entries; other hashes equal to it are remapped */
+#define COMPACT_HASHMAP_HASH_REMOVED ((cutil_hash_t) 0)
+
+typedef struct {
+    const cutil_GenericType *key_type;
+    const cutil_GenericType *val_type;
+    size_t count;          /**< number of entries that are not removed */
+    size_t num_used;       /**< number of entries, removed ones included */
+    size_t entry_capacity; /**< number of entries before a resize */
+    cutil_hash_t *hashes;  /**< hash of every entry */
+    void *keys;
+    void *vals;
+    size_t index_mask;  /**< number of index slots - 1 */
+    size_t index_width; /**< bytes per index slot */
+    void *index;        /**< entry numbers, or INDEX_EMPTY or INDEX_DUMMY */
+} _cutil_CompactHashMap;
+
+static inline size_t
+_cutil_CompactHashMap_get_entry_capacity(size_t num_slots)
+{
+    return 2U * num_slots / 3U;
+}
+
+/**
+ * Returns smallest number of index slots for `count` entries, or 0 if no
+ * such number exists.
+ */
+static size_t
+_cutil_CompactHashMap_get_num_slots_for(size_t count)
+{
+    size_t num_slots = COMPACT_HASHMAP_MIN_NUM_SLOTS;
+    while (_cutil_CompactHashMap_get_entry_capacity(num_slots) < count) {
+        if (num_slots > CUTIL_ERROR_INDEX / 4U) {
+            return 0UL;
+        }
+        num_slots *= 2U;
+    }
+    return num_slots;
+}
+
+static inline size_t
+_cutil_CompactHashMap_get_index_width(size_t num_slots)
+{
+    if (num_slots <= (size_t) UINT8_MAX + 1U) {
+        return sizeof(uint8_t);
+    }
+    if (num_slots <= (size_t) UINT16_MAX + 1U) {
+        return sizeof(uint16_t);
+    }
+    if (num_slots - 1U <= (size_t) UINT32_MAX) {
+        return sizeof(uint32_t);
+    }
+    return sizeof(uint64_t);
+}
+
+static inline size_t
+_cutil_CompactHashMap_index_get(const _cutil_CompactHashMap *cm, size_t slot)
+{
+    uint64_t raw;
+    uint64_t max;
+    switch (cm->index_width) {
+    case sizeof(uint8_t):
+        raw = ((const uint8_t *) cm->index)[slot];
+        max = UINT8_MAX;
+        break;
+    case sizeof(uint16_t):
+        raw = ((const uint16_t *) cm->index)[slot];
+        max = UINT16_MAX;
+        break;
+    case sizeof(uint32_t):
+        raw = ((const uint32_t *) cm->index)[slot];
+        max = UINT32_MAX;
+        break;
+    default:
+        raw = ((const uint64_t *) cm->index)[slot];
+        max = UINT64_MAX;
+        break;
+    }
+    if (raw >= max - 1U) {
+        return (raw == max) ? COMPACT_HASHMAP_INDEX_EMPTY
+                            : COMPACT_HASHMAP_INDEX_DUMMY;
+    }
+    return (size_t) raw;
+}
+
+/**
+ * Sets index slot `slot` to `entry`. INDEX_EMPTY and INDEX_DUMMY are stored
+ * as the largest two values of the slot width.
+ */
+static inline void
+_cutil_CompactHashMap_index_set(
+  _cutil_CompactHashMap *cm, size_t slot, size_t entry
+)
+{
+    uint64_t raw = entry;
+    if (entry == COMPACT_HASHMAP_INDEX_EMPTY) {
+        raw = UINT64_MAX;
+    } else if (entry == COMPACT_HASHMAP_INDEX_DUMMY) {
+        raw = UINT64_MAX - 1U;
+    }
+    switch (cm->index_width) {
+    case sizeof(uint8_t):
+        ((uint8_t *) cm->index)[slot] = (uint8_t) raw;
+        break;
+    case sizeof(uint16_t):
+        ((uint16_t *) cm->index)[slot] = (uint16_t) raw;
+        break;
+    case sizeof(uint32_t):
+        ((uint32_t *) cm->index)[slot] = (uint32_t) raw;
+        break;
+    default:
+        ((uint64_t *) cm->index)[slot] = raw;
+        break;
+    }
+}
+
+static inline cutil_hash_t
+_cutil_CompactHashMap_hash_key(const _cutil_CompactHashMap *cm, const void *key)
+{
+    const cutil_hash_t hash
+      = cutil_hash_finalize(cutil_GenericType_apply_hash(cm->key_type, key));
+    return (hash == COMPACT_HASHMAP_HASH_REMOVED) ? hash + 1U : hash;
+}
+
+static inline void *
+_cutil_CompactHashMap_get_key_ptr(const _cutil_CompactHashMap *cm, size_t idx)
+{
+    return cutil_void_array_get_elem(cm->key_type->size, cm->keys, idx);
+}
+
+static inline void *
+_cutil_CompactHashMap_get_val_ptr(const _cutil_CompactHashMap *cm, size_t idx)
+{
+    return cutil_void_array_get_elem(cm->val_type->size, cm->vals, idx);
+}
+
+static inline cutil_Bool
+_cutil_CompactHashMap_is_removed(const _cutil_CompactHashMap *cm, size_t idx)
+{
+    return CUTIL_BOOLIFY(cm->hashes[idx] == COMPACT_HASHMAP_HASH_REMOVED);
+}
+
+/**
+ * Returns index slot that refers to the entry with `key`. If there is none,
+ * returns CUTIL_ERROR_INDEX and, if `insert_slot` is not NULL, writes the
+ * first empty or dummy slot in the probe sequence of `hash` to it.
+ */
+static size_t
+_cutil_CompactHashMap_find_slot(
+  const _cutil_CompactHashMap *cm,
+  cutil_hash_t hash,
+  const void *key,
+  size_t *insert_slot
+)
+{
+    size_t free_slot = CUTIL_ERROR_INDEX;
+    for (size_t slot = hash & cm->index_mask;;
+         slot = (slot + 1U) & cm->index_mask) {
+        const size_t entry = _cutil_CompactHashMap_index_get(cm, slot);
+        if (entry == COMPACT_HASHMAP_INDEX_EMPTY) {
+            if (insert_slot != NULL) {
+                *insert_slot = (free_slot == CUTIL_ERROR_INDEX) ? slot
+                                                                : free_slot;
+            }
+            return CUTIL_ERROR_INDEX;
+        }
+        if (entry == COMPACT_HASHMAP_INDEX_DUMMY) {
+            if (free_slot == CUTIL_ERROR_INDEX) {
+                free_slot = slot;
+            }
+            continue;
+        }
+        if (cm->hashes[entry] == hash
+            && cutil_GenericType_apply_compare(
+                 cm->key_type, key, _cutil_CompactHashMap_get_key_ptr(cm, entry)
+               ) == 0) {
+            return slot;
+        }
+    }
+}
+
+/**
+ * Returns number of the entry with `key`, or CUTIL_ERROR_INDEX.
+ */
+static size_t
+_cutil_CompactHashMap_find_entry(
+  const _cutil_CompactHashMap *cm, const void *key
+)
+{
+    const cutil_hash_t hash = _cutil_CompactHashMap_hash_key(cm, key);
+    const size_t slot = _cutil_CompactHashMap_find_slot(cm, hash, key, NULL);
+    CUTIL_RETURN_VAL_IF_VAL(slot, CUTIL_ERROR_INDEX, CUTIL_ERROR_INDEX);
+    return _cutil_CompactHashMap_index_get(cm, slot);
+}
+
+/**
+ * Returns index slot that refers to entry `entry`, which is not removed.
+ */
+static size_t
+_cutil_CompactHashMap_find_slot_of_entry(
+  const _cutil_CompactHashMap *cm, size_t entry
+)
+{
+    size_t slot = cm->hashes[entry] & cm->index_mask;
+    while (_cutil_CompactHashMap_index_get(cm, slot) != entry) {
+        slot = (slot + 1U) & cm->index_mask;
+    }
+    return slot;
+}
+
+/**
+ * Moves the entries that are not removed to the front, keeping their order.
+ * Entries are relocated bytewise.
+ */
+static void
+_cutil_CompactHashMap_compact(_cutil_CompactHashMap *cm)
+{
+    const size_t key_size = cm->key_type->size;
+    const size_t val_size = cm->val_type->size;
+    size_t num = 0UL;
+    for (size_t i = 0; i < cm->num_used; ++i) {
+        if (_cutil_CompactHashMap_is_removed(cm, i)) {
+            continue;
+        }
+        if (i != num) {
+            cm->hashes[num] = cm->hashes[i];
+            memcpy(
+              _cutil_CompactHashMap_get_key_ptr(cm, num),
+              _cutil_CompactHashMap_get_key_ptr(cm, i), key_size
+            );
+            memcpy(
+              _cutil_CompactHashMap_get_val_ptr(cm, num),
+              _cutil_CompactHashMap_get_val_ptr(cm, i), val_size
+            );
+        }
+        ++num;
+    }
+    cm->num_used = num;
+}
+
+/**
+ * Adds entry `entry` to an index without dummy slots.
+ */
+static void
+_cutil_CompactHashMap_index_entry(_cutil_CompactHashMap *cm, size_t entry)
+{
+    size_t slot = cm->hashes[entry] & cm->index_mask;
+    while (_cutil_CompactHashMap_index_get(cm, slot)
+           != COMPACT_HASHMAP_INDEX_EMPTY) {
+        slot = (slot + 1U) & cm->index_mask;
+    }
+    _cutil_CompactHashMap_index_set(cm, slot, entry);
+}
+
+/**
+ * Replaces the index by one of `num_slots` slots referring to all entries,
+ * none of which may be removed, and resizes the entry arrays accordingly.
+ */
+static void
+_cutil_CompactHashMap_rebuild(_cutil_CompactHashMap *cm, size_t num_slots)
+{
+    cm->entry_capacity = _cutil_CompactHashMap_get_entry_capacity(num_slots);
+    cm->hashes = realloc(cm->hashes, cm->entry_capacity * sizeof *cm->hashes);
+    cm->keys = realloc(cm->keys, cm->entry_capacity * cm->key_type->size);
+    cm->vals = realloc(cm->vals, cm->entry_capacity * cm->val_type->size);
+
+    free(cm->index);
+    cm->index_mask = num_slots - 1U;
+    cm->index_width = _cutil_CompactHashMap_get_index_width(num_slots);
+    cm->index = malloc(num_slots * cm->index_width);
+    memset(cm->index, 0xFF, num_slots * cm->index_width);
+
+    for (size_t i = 0; i < cm->num_used; ++i) {
+        _cutil_CompactHashMap_index_entry(cm, i);
+    }
+}
+
+/**
+ * Compacts the entries and rebuilds the index for room for `count` entries.
+ */
+static cutil_Status
+_cutil_CompactHashMap_resize(_cutil_CompactHashMap *cm, size_t count)
+{
+    const size_t num_slots
+      = _cutil_CompactHashMap_get_num_slots_for(CUTIL_MAX(count, cm->count));
+    if (num_slots == 0UL) {
+        cutil_log_warn("CompactHashMap: capacity %zu is too large", count);
+        return CUTIL_STATUS_FAILURE;
+    }
+    cutil_log_debug(
+      "CompactHashMap: resizing index to %zu slots, dropping %zu entries",
+      num_slots, cm->num_used - cm->count
+    );
+    _cutil_CompactHashMap_compact(cm);
+    _cutil_CompactHashMap_rebuild(cm, num_slots);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+/**
+ * Initializes `cm` without entries and with room for `count` of them.
+ */
+static void
+_cutil_CompactHashMap_init(_cutil_CompactHashMap *cm, size_t count)
+{
+    cm->count = 0UL;
+    cm->num_used = 0UL;
+    cm->hashes = NULL;
+    cm->keys = NULL;
+    cm->vals = NULL;
+    cm->index = NULL;
+    _cutil_CompactHashMap_rebuild(
+      cm, _cutil_CompactHashMap_get_num_slots_for(count)
+    );
+}
+
+/**
+ * Removes entry referred to by index slot `slot`.
+ */
+static void
+_cutil_CompactHashMap_erase(_cutil_CompactHashMap *cm, size_t slot)
+{
+    const size_t entry = _cutil_CompactHashMap_index_get(cm, slot);
+    _cutil_CompactHashMap_index_set(cm, slot, COMPACT_HASHMAP_INDEX_DUMMY);
+    cutil_GenericType_apply_clear(
+      cm->key_type, _cutil_CompactHashMap_get_key_ptr(cm, entry)
+    );
+    cutil_GenericType_apply_clear(
+      cm->val_type, _cutil_CompactHashMap_get_val_ptr(cm, entry)
+    );
+    cm->hashes[entry] = COMPACT_HASHMAP_HASH_REMOVED;
+    --cm->count;
+}
+
+cutil_Map *
+cutil_CompactHashMap_alloc(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+)
+{
+    if (!cutil_GenericType_is_valid(key_type)) {
+        cutil_log_warn("Key type is not valid");
+        return NULL;
+    }
+    if (!cutil_GenericType_is_valid(val_type)) {
+        cutil_log_warn("Value type is not valid");
+        return NULL;
+    }
+
+    cutil_Map *const map = CUTIL_MALLOC_OBJECT(map);
+
+    map->vtable = CUTIL_MAP_TYPE_COMPACT_HASHMAP;
+    _cutil_CompactHashMap *const cm = map->data = CUTIL_MALLOC_OBJECT(cm);
+
+    cm->key_type = key_type;
+    cm->val_type = val_type;
+    _cutil_CompactHashMap_init(cm, 0UL);
+
+    return map;
+}
+
+static void
+_cutil_CompactHashMap_free_entries(_cutil_CompactHashMap *cm)
+{
+    for (size_t i = 0; i < cm->num_used; ++i) {
+        if (_cutil_CompactHashMap_is_removed(cm, i)) {
+            continue;
+        }
+        cutil_GenericType_apply_clear(
+          cm->key_type, _cutil_CompactHashMap_get_key_ptr(cm, i)
+        );
+        cutil_GenericType_apply_clear(
+          cm->val_type, _cutil_CompactHashMap_get_val_ptr(cm, i)
+        );
+    }
+    free(cm->hashes);
+    free(cm->keys);
+    free(cm->vals);
+    free(cm->index);
+}
+
+static void
+_cutil_CompactHashMap_free(void *data)
+{
+    _cutil_CompactHashMap *const cm = data;
+    CUTIL_RETURN_IF_NULL(cm);
+    _cutil_CompactHashMap_free_entries(cm);
+    free(cm);
+}
+
+static void
+_cutil_CompactHashMap_reset(void *data)
+{
+    _cutil_CompactHashMap *const cm = data;
+    _cutil_CompactHashMap_free_entries(cm);
+    _cutil_CompactHashMap_init(cm, 0UL);
+}
+
+static void
+_cutil_CompactHashMap_copy(void *dst, const void *src)
+{
+    _cutil_CompactHashMap *const dst_cm = dst;
+    const _cutil_CompactHashMap *const src_cm = src;
+    CUTIL_RETURN_IF_VAL(dst_cm, src_cm);
+
+    _cutil_CompactHashMap_free_entries(dst_cm);
+    _cutil_CompactHashMap_init(dst_cm, src_cm->count);
+    for (size_t i = 0; i < src_cm->num_used; ++i) {
+        if (_cutil_CompactHashMap_is_removed(src_cm, i)) {
+            continue;
+        }
+        const size_t entry = dst_cm->num_used++;
+        void *const key = _cutil_CompactHashMap_get_key_ptr(dst_cm, entry);
+        void *const val = _cutil_CompactHashMap_get_val_ptr(dst_cm, entry);
+        cutil_GenericType_apply_init(dst_cm->key_type, key);
+        cutil_GenericType_apply_copy(
+          dst_cm->key_type, key, _cutil_CompactHashMap_get_key_ptr(src_cm, i)
+        );
+        cutil_GenericType_apply_init(dst_cm->val_type, val);
+        cutil_GenericType_apply_copy(
+          dst_cm->val_type, val, _cutil_CompactHashMap_get_val_ptr(src_cm, i)
+        );
+        dst_cm->hashes[entry] = src_cm->hashes[i];
+        _cutil_CompactHashMap_index_entry(dst_cm, entry);
+    }
+    dst_cm->count = dst_cm->num_used;
+}
+
+static void *
+_cutil_CompactHashMap_duplicate(const void *data)
+{
+    const _cutil_CompactHashMap *const src = data;
+    _cutil_CompactHashMap *const dst = CUTIL_MALLOC_OBJECT(dst);
+    dst->key_type = src->key_type;
+    dst->val_type = src->val_type;
+    _cutil_CompactHashMap_init(dst, 0UL);
+    _cutil_CompactHashMap_copy(dst, src);
+    return dst;
+}
+
+static size_t
+_cutil_CompactHashMap_get_count(const void *data)
+{
+    const _cutil_CompactHashMap *const cm = data;
+    return cm->count;
+}
+
+static cutil_Status
+_cutil_CompactHashMap_remove(void *data, const void *key)
+{
+    _cutil_CompactHashMap *const cm = data;
+    const cutil_hash_t hash = _cutil_CompactHashMap_hash_key(cm, key);
+    const size_t slot = _cutil_CompactHashMap_find_slot(cm, hash, key, NULL);
+    if (slot == CUTIL_ERROR_INDEX) {
+        cutil_log_warn("CompactHashMap remove: key not found");
+        return CUTIL_STATUS_FAILURE;
+    }
+    _cutil_CompactHashMap_erase(cm, slot);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Bool
+_cutil_CompactHashMap_contains(const void *data, const void *key)
+{
+    const size_t entry = _cutil_CompactHashMap_find_entry(data, key);
+    return CUTIL_BOOLIFY(entry != CUTIL_ERROR_INDEX);
+}
+
+static const void *
+_cutil_CompactHashMap_get_ptr(const void *data, const void *key)
+{
+    const _cutil_CompactHashMap *const cm = data;
+    const size_t entry = _cutil_CompactHashMap_find_entry(cm, key);
+    CUTIL_RETURN_VAL_IF_VAL(entry, CUTIL_ERROR_INDEX, NULL);
+    return _cutil_CompactHashMap_get_val_ptr(cm, entry);
+}
+
+static cutil_Status
+_cutil_CompactHashMap_get(const void *data, const void *key, void *val)
+{
+    const _cutil_CompactHashMap *const cm = data;
+    const void *const p = _cutil_CompactHashMap_get_ptr(cm, key);
+    if (p == NULL) {
+        cutil_log_warn("CompactHashMap get: key not found");
+        return CUTIL_STATUS_FAILURE;
+    }
+    cutil_GenericType_apply_copy(cm->val_type, val, p);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static void *
+_cutil_CompactHashMap_get_or_insert(
+  void *data, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    _cutil_CompactHashMap *const cm = data;
+    const cutil_hash_t hash = _cutil_CompactHashMap_hash_key(cm, key);
+    size_t insert_slot;
+    const size_t slot
+      = _cutil_CompactHashMap_find_slot(cm, hash, key, &insert_slot);
+    if (inserted != NULL) {
+        *inserted = CUTIL_BOOLIFY(slot == CUTIL_ERROR_INDEX);
+    }
+    if (slot != CUTIL_ERROR_INDEX) {
+        return _cutil_CompactHashMap_get_val_ptr(
+          cm, _cutil_CompactHashMap_index_get(cm, slot)
+        );
+    }
+
+    if (cm->num_used == cm->entry_capacity) {
+        if (_cutil_CompactHashMap_resize(cm, 2U * cm->count + 1U)
+            != CUTIL_STATUS_SUCCESS) {
+            if (inserted != NULL) {
+                *inserted = CUTIL_FALSE;
+            }
+            return NULL;
+        }
+        _cutil_CompactHashMap_find_slot(cm, hash, key, &insert_slot);
+    }
+
+    const size_t entry = cm->num_used++;
+    void *const key_ptr = _cutil_CompactHashMap_get_key_ptr(cm, entry);
+    void *const val_ptr = _cutil_CompactHashMap_get_val_ptr(cm, entry);
+    cutil_GenericType_apply_init(cm->key_type, key_ptr);
+    cutil_GenericType_apply_copy(cm->key_type, key_ptr, key);
+    cutil_GenericType_apply_init(cm->val_type, val_ptr);
+    cutil_GenericType_apply_copy(cm->val_type, val_ptr, val);
+    cm->hashes[entry] = hash;
+    _cutil_CompactHashMap_index_set(cm, insert_slot, entry);
+    ++cm->count;
+    return val_ptr;
+}
+
+static cutil_Status
+_cutil_CompactHashMap_set(void *data, const void *key, const void *val)
+{
+    _cutil_CompactHashMap *const cm = data;
+    cutil_Bool inserted;
+    void *const val_ptr
+      = _cutil_CompactHashMap_get_or_insert(cm, key, val, &inserted);
+    CUTIL_RETURN_VAL_IF_NULL(val_ptr, CUTIL_STATUS_FAILURE);
+    if (!inserted) {
+        cutil_GenericType_apply_copy(cm->val_type, val_ptr, val);
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_CompactHashMap_reserve(void *data, size_t count)
+{
+    _cutil_CompactHashMap *const cm = data;
+    if (count <= cm->entry_capacity) {
+        return CUTIL_STATUS_SUCCESS;
+    }
+    return _cutil_CompactHashMap_resize(cm, count);
+}
+
+static cutil_Status
+_cutil_CompactHashMap_shrink_to_fit(void *data)
+{
+    _cutil_CompactHashMap *const cm = data;
+    const size_t num_slots = _cutil_CompactHashMap_get_num_slots_for(cm->count);
+    if (num_slots == cm->index_mask + 1U && cm->num_used == cm->count) {
+        return CUTIL_STATUS_SUCCESS;
+    }
+    return _cutil_CompactHashMap_resize(cm, cm->count);
+}
+
+static const cutil_GenericType *
+_cutil_CompactHashMap_get_key_type(const void *data)
+{
+    const _cutil_CompactHashMap *const cm = data;
+    return cm->key_type;
+}
+
+static const cutil_GenericType *
+_cutil_CompactHashMap_get_val_type(const void *data)
+{
+    const _cutil_CompactHashMap *const cm = data;
+    return cm->val_type;
+}
+
+/**
+ * Iterates over the entries in insertion order. Since removals only mark
+ * entries, removing the current key keeps the iterator valid.
+ */
+typedef struct {
+    _cutil_CompactHashMap *cm;
+    size_t pos;   /**< next entry to visit */
+    size_t entry; /**< current entry, or CUTIL_ERROR_INDEX */
+} _cutil_CompactHashMapIter;
+
+static void
+_cutil_CompactHashMapIter_rewind(void *data)
+{
+    _cutil_CompactHashMapIter *const iter = data;
+    iter->pos = 0UL;
+    iter->entry = CUTIL_ERROR_INDEX;
+}
+
+static void
+_cutil_CompactHashMapIter_free(void *data)
+{
+    free(data);
+}
+
+static cutil_Bool
+_cutil_CompactHashMapIter_next(void *data)
+{
+    _cutil_CompactHashMapIter *const iter = data;
+    const _cutil_CompactHashMap *const cm = iter->cm;
+    while (iter->pos < cm->num_used) {
+        const size_t entry = iter->pos++;
+        if (!_cutil_CompactHashMap_is_removed(cm, entry)) {
+            iter->entry = entry;
+            return CUTIL_TRUE;
+        }
+    }
+    iter->entry = CUTIL_ERROR_INDEX;
+    return CUTIL_FALSE;
+}
+
+static const void *
+_cutil_CompactHashMapIter_get_ptr(const void *data)
+{
+    const _cutil_CompactHashMapIter *const iter = data;
+    CUTIL_RETURN_VAL_IF_VAL(iter->entry, CUTIL_ERROR_INDEX, NULL);
+    return _cutil_CompactHashMap_get_key_ptr(iter->cm, iter->entry);
+}
+
+static cutil_Status
+_cutil_CompactHashMapIter_get(const void *data, void *out)
+{
+    const _cutil_CompactHashMapIter *const iter = data;
+    const void *const p = _cutil_CompactHashMapIter_get_ptr(data);
+    CUTIL_RETURN_VAL_IF_NULL(p, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(iter->cm->key_type, out, p);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_CompactHashMapIter_remove(void *data)
+{
+    _cutil_CompactHashMapIter *const iter = data;
+    CUTIL_RETURN_VAL_IF_VAL(
+      iter->entry, CUTIL_ERROR_INDEX, CUTIL_STATUS_FAILURE
+    );
+    _cutil_CompactHashMap *const cm = iter->cm;
+    _cutil_CompactHashMap_erase(
+      cm, _cutil_CompactHashMap_find_slot_of_entry(cm, iter->entry)
+    );
+    iter->entry = CUTIL_ERROR_INDEX;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static _cutil_CompactHashMapIter *
+_cutil_CompactHashMapIter_alloc(const _cutil_CompactHashMap *cm)
+{
+    _cutil_CompactHashMapIter *const iter = CUTIL_MALLOC_OBJECT(iter);
+    iter->cm = CUTIL_CONST_CAST(cm);
+    _cutil_CompactHashMapIter_rewind(iter);
+    return iter;
+}
+
+static const cutil_ConstIteratorType
+  CUTIL_CONST_ITERATOR_TYPE_COMPACT_HASHMAP_OBJECT
+  = {
+    .name = "cutil_ConstIterator<cutil_CompactHashMap>",
+    .free = &_cutil_CompactHashMapIter_free,
+    .rewind = &_cutil_CompactHashMapIter_rewind,
+    .next = &_cutil_CompactHashMapIter_next,
+    .get = &_cutil_CompactHashMapIter_get,
+    .get_ptr = &_cutil_CompactHashMapIter_get_ptr,
+};
+
+const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_COMPACT_HASHMAP
+  = &CUTIL_CONST_ITERATOR_TYPE_COMPACT_HASHMAP_OBJECT;
+
+static const cutil_IteratorType CUTIL_ITERATOR_TYPE_COMPACT_HASHMAP_OBJECT = {
+  .name = "cutil_Iterator<cutil_CompactHashMap>",
+  .free = &_cutil_CompactHashMapIter_free,
+  .rewind = &_cutil_CompactHashMapIter_rewind,
+  .next = &_cutil_CompactHashMapIter_next,
+  .get = &_cutil_CompactHashMapIter_get,
+  .get_ptr = &_cutil_CompactHashMapIter_get_ptr,
+  .set = NULL,
+  .remove = &_cutil_CompactHashMapIter_remove,
+};
+
+const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_COMPACT_HASHMAP
+  = &CUTIL_ITERATOR_TYPE_COMPACT_HASHMAP_OBJECT;
+
+static cutil_ConstIterator *
+_cutil_CompactHashMap_get_const_iterator(const void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_ConstIterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_CONST_ITERATOR_TYPE_COMPACT_HASHMAP;
+    it->data = _cutil_CompactHashMapIter_alloc(data);
+
+    cutil_log_debug("CompactHashMap: created const iterator");
+    return it;
+}
+
+static cutil_Iterator *
+_cutil_CompactHashMap_get_iterator(void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_Iterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_ITERATOR_TYPE_COMPACT_HASHMAP;
+    it->data = _cutil_CompactHashMapIter_alloc(data);
+
+    cutil_log_debug("CompactHashMap: created iterator");
+    return it;
+}
+
+static const cutil_MapType CUTIL_MAP_TYPE_COMPACT_HASHMAP_OBJECT = {
+  .name = "cutil_CompactHashMap",
+  .free = &_cutil_CompactHashMap_free,
+  .reset = &_cutil_CompactHashMap_reset,
+  .copy = &_cutil_CompactHashMap_copy,
+  .duplicate = &_cutil_CompactHashMap_duplicate,
+  .get_count = &_cutil_CompactHashMap_get_count,
+  .remove = &_cutil_CompactHashMap_remove,
+  .contains = &_cutil_CompactHashMap_contains,
+  .get = &_cutil_CompactHashMap_get,
+  .get_ptr = &_cutil_CompactHashMap_get_ptr,
+  .set = &_cutil_CompactHashMap_set,
+  .get_or_insert = &_cutil_CompactHashMap_get_or_insert,
+  .reserve = &_cutil_CompactHashMap_reserve,
+  .shrink_to_fit = &_cutil_CompactHashMap_shrink_to_fit,
+  .get_key_type = &_cutil_CompactHashMap_get_key_type,
+  .get_val_type = &_cutil_CompactHashMap_get_val_type,
+  .get_const_iterator = &_cutil_CompactHashMap_get_const_iterator,
+  .get_iterator = &_cutil_CompactHashMap_get_iterator,
+};
+
+const cutil_MapType *const CUTIL_MAP_TYPE_COMPACT_HASHMAP
+  = &CUTIL_MAP_TYPE_COMPACT_HASHMAP_OBJECT;
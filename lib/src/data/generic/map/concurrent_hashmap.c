@@ -0,0 +1,695 @@
+#if !defined(_WIN32)
+    /* pthread_rwlock_t requires POSIX.1-2001 */
+    #undef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200112L
+#endif
+
+#include <cutil/data/generic/map/concurrent_hashmap.h>
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/map/hashmap.h>
+#include <cutil/io/log.h>
+#include <cutil/status.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/util/hash.h>
+#include <cutil/util/macro.h>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+#define CONCURRENT_HASHMAP_DEFAULT_NUM_SHARDS ((size_t) 32)
+#define CONCURRENT_HASHMAP_MAX_NUM_SHARDS ((size_t) 1 << 16)
+/* Keeps locks of neighboring shards on different cache lines */
+#define CONCURRENT_HASHMAP_SHARD_ALIGN ((size_t) 128)
+
+#ifndef NDEBUG
+    /**
+     * MACRO for checking if a cutil_Map is a ConcurrentHashMap. If not,
+     * function and type names are logged.
+     */
+    #define CUTIL_CONCURRENT_HASHMAP_TYPE_CHECK(MAP)                           \
+        do {                                                                   \
+            if (MAP->vtable != CUTIL_MAP_TYPE_CONCURRENT_HASHMAP) {            \
+                cutil_log_warn(                                                \
+                  "%s: expected map of type %s, got %s", __func__,             \
+                  CUTIL_MAP_TYPE_CONCURRENT_HASHMAP->name, MAP->vtable->name   \
+                );                                                             \
+            }                                                                  \
+        } while (0)
+#else
+    #define CUTIL_CONCURRENT_HASHMAP_TYPE_CHECK(MAP) ((void) (MAP))
+#endif /* NDEBUG */
+
+/*
+ * Reader-writer lock
+ */
+#if defined(_WIN32)
+typedef SRWLOCK _cutil_RWLock;
+
+static void
+_cutil_RWLock_init(_cutil_RWLock *lock)
+{
+    InitializeSRWLock(lock);
+}
+
+static void
+_cutil_RWLock_destroy(_cutil_RWLock *lock)
+{
+    CUTIL_UNUSED(lock);
+}
+
+static void
+_cutil_RWLock_read_lock(_cutil_RWLock *lock)
+{
+    AcquireSRWLockShared(lock);
+}
+
+static void
+_cutil_RWLock_read_unlock(_cutil_RWLock *lock)
+{
+    ReleaseSRWLockShared(lock);
+}
+
+static void
+_cutil_RWLock_write_lock(_cutil_RWLock *lock)
+{
+    AcquireSRWLockExclusive(lock);
+}
+
+static void
+_cutil_RWLock_write_unlock(_cutil_RWLock *lock)
+{
+    ReleaseSRWLockExclusive(lock);
+}
+#else
+typedef pthread_rwlock_t _cutil_RWLock;
+
+static void
+_cutil_RWLock_init(_cutil_RWLock *lock)
+{
+    if (pthread_rwlock_init(lock, NULL) != 0) {
+        cutil_log_error("Could not initialize reader-writer lock");
+        abort();
+    }
+}
+
+static void
+_cutil_RWLock_destroy(_cutil_RWLock *lock)
+{
+    pthread_rwlock_destroy(lock);
+}
+
+static void
+_cutil_RWLock_read_lock(_cutil_RWLock *lock)
+{
+    pthread_rwlock_rdlock(lock);
+}
+
+static void
+_cutil_RWLock_read_unlock(_cutil_RWLock *lock)
+{
+    pthread_rwlock_unlock(lock);
+}
+
+static void
+_cutil_RWLock_write_lock(_cutil_RWLock *lock)
+{
+    pthread_rwlock_wrlock(lock);
+}
+
+static void
+_cutil_RWLock_write_unlock(_cutil_RWLock *lock)
+{
+    pthread_rwlock_unlock(lock);
+}
+#endif
+
+typedef struct {
+    _cutil_RWLock lock;
+    cutil_Map *map; /**< HashMap holding the entries of this shard */
+} _cutil_ConcurrentHashMapShard;
+
+typedef union {
+    _cutil_ConcurrentHashMapShard shard;
+    unsigned char padding[(sizeof(_cutil_ConcurrentHashMapShard)
+                           + CONCURRENT_HASHMAP_SHARD_ALIGN - 1)
+                          / CONCURRENT_HASHMAP_SHARD_ALIGN
+                          * CONCURRENT_HASHMAP_SHARD_ALIGN];
+} _cutil_ConcurrentHashMapShardSlot;
+
+typedef struct {
+    const cutil_GenericType *key_type;
+    const cutil_GenericType *val_type;
+    size_t num_shards;
+    unsigned int shard_bits; /**< log2(num_shards) */
+    _cutil_ConcurrentHashMapShardSlot *shards;
+} _cutil_ConcurrentHashMap;
+
+static inline _cutil_ConcurrentHashMapShard *
+_cutil_ConcurrentHashMap_get_shard(
+  const _cutil_ConcurrentHashMap *cmap, size_t idx
+)
+{
+    return &cmap->shards[idx].shard;
+}
+
+/**
+ * Returns shard responsible for `key`. Shards are selected by the high bits
+ * of the finalized hash, while the HashMap of each shard indexes its slots by
+ * the lower bits.
+ */
+static _cutil_ConcurrentHashMapShard *
+_cutil_ConcurrentHashMap_locate_shard(
+  const _cutil_ConcurrentHashMap *cmap, const void *key
+)
+{
+    CUTIL_RETURN_VAL_IF_VAL(
+      cmap->shard_bits, 0U, _cutil_ConcurrentHashMap_get_shard(cmap, 0UL)
+    );
+    const cutil_hash_t hash = cutil_hash_finalize(
+      cutil_GenericType_apply_hash(cmap->key_type, key)
+    );
+    const size_t idx = (size_t) (hash >> (64U - cmap->shard_bits));
+    return _cutil_ConcurrentHashMap_get_shard(cmap, idx);
+}
+
+cutil_Map *
+cutil_ConcurrentHashMap_alloc(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+)
+{
+    return cutil_ConcurrentHashMap_alloc_with_shards(
+      key_type, val_type, CONCURRENT_HASHMAP_DEFAULT_NUM_SHARDS
+    );
+}
+
+cutil_Map *
+cutil_ConcurrentHashMap_alloc_with_shards(
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type,
+  size_t num_shards
+)
+{
+    if (!cutil_GenericType_is_valid(key_type)) {
+        cutil_log_warn("Key type is not valid");
+        return NULL;
+    }
+    if (!cutil_GenericType_is_valid(val_type)) {
+        cutil_log_warn("Value type is not valid");
+        return NULL;
+    }
+    if (num_shards > CONCURRENT_HASHMAP_MAX_NUM_SHARDS) {
+        cutil_log_warn("Number of shards %zu is too large", num_shards);
+        return NULL;
+    }
+    if (num_shards == 0UL) {
+        num_shards = CONCURRENT_HASHMAP_DEFAULT_NUM_SHARDS;
+    }
+
+    cutil_Map *const map = CUTIL_MALLOC_OBJECT(map);
+
+    map->vtable = CUTIL_MAP_TYPE_CONCURRENT_HASHMAP;
+    _cutil_ConcurrentHashMap *const cmap = map->data
+      = CUTIL_MALLOC_OBJECT(cmap);
+
+    cmap->key_type = key_type;
+    cmap->val_type = val_type;
+    cmap->num_shards = 1UL;
+    cmap->shard_bits = 0U;
+    while (cmap->num_shards < num_shards) {
+        cmap->num_shards <<= 1U;
+        ++cmap->shard_bits;
+    }
+    cmap->shards = CUTIL_MALLOC_MULT(cmap->shards, cmap->num_shards);
+    for (size_t i = 0; i < cmap->num_shards; ++i) {
+        _cutil_ConcurrentHashMapShard *const shard
+          = _cutil_ConcurrentHashMap_get_shard(cmap, i);
+        _cutil_RWLock_init(&shard->lock);
+        shard->map = cutil_HashMap_alloc(key_type, val_type);
+        /* Lookups of a shard run in parallel under its shared lock */
+        cutil_HashMap_set_concurrent_reads(shard->map, CUTIL_TRUE);
+    }
+
+    return map;
+}
+
+size_t
+cutil_ConcurrentHashMap_get_num_shards(const cutil_Map *map)
+{
+    CUTIL_RETURN_VAL_IF_NULL(map, 0UL);
+    CUTIL_CONCURRENT_HASHMAP_TYPE_CHECK(map);
+
+    const _cutil_ConcurrentHashMap *const cmap = map->data;
+    return cmap->num_shards;
+}
+
+static void
+_cutil_ConcurrentHashMap_free(void *data)
+{
+    _cutil_ConcurrentHashMap *const cmap = data;
+    CUTIL_RETURN_IF_NULL(cmap);
+
+    for (size_t i = 0; i < cmap->num_shards; ++i) {
+        _cutil_ConcurrentHashMapShard *const shard
+          = _cutil_ConcurrentHashMap_get_shard(cmap, i);
+        cutil_Map_free(shard->map);
+        _cutil_RWLock_destroy(&shard->lock);
+    }
+    free(cmap->shards);
+
+    free(cmap);
+}
+
+static void
+_cutil_ConcurrentHashMap_reset(void *data)
+{
+    _cutil_ConcurrentHashMap *const cmap = data;
+    for (size_t i = 0; i < cmap->num_shards; ++i) {
+        _cutil_ConcurrentHashMapShard *const shard
+          = _cutil_ConcurrentHashMap_get_shard(cmap, i);
+        _cutil_RWLock_write_lock(&shard->lock);
+        cutil_Map_reset(shard->map);
+        _cutil_RWLock_write_unlock(&shard->lock);
+    }
+}
+
+/**
+ * Copies entries of `src` to `dst` shard by shard. Both maps must have the
+ * same number of shards, so that every entry stays in its shard.
+ */
+static void
+_cutil_ConcurrentHashMap_copy_shards(
+  _cutil_ConcurrentHashMap *dst, const _cutil_ConcurrentHashMap *src
+)
+{
+    for (size_t i = 0; i < src->num_shards; ++i) {
+        _cutil_ConcurrentHashMapShard *const dst_shard
+          = _cutil_ConcurrentHashMap_get_shard(dst, i);
+        _cutil_ConcurrentHashMapShard *const src_shard
+          = _cutil_ConcurrentHashMap_get_shard(src, i);
+        _cutil_RWLock_read_lock(&src_shard->lock);
+        _cutil_RWLock_write_lock(&dst_shard->lock);
+        cutil_Map_copy(dst_shard->map, src_shard->map);
+        _cutil_RWLock_write_unlock(&dst_shard->lock);
+        _cutil_RWLock_read_unlock(&src_shard->lock);
+    }
+}
+
+static void
+_cutil_ConcurrentHashMap_copy(void *dst, const void *src)
+{
+    _cutil_ConcurrentHashMap *const dst_cmap = dst;
+    const _cutil_ConcurrentHashMap *const src_cmap = src;
+    CUTIL_RETURN_IF_VAL(dst_cmap, src_cmap);
+
+    if (dst_cmap->num_shards == src_cmap->num_shards) {
+        _cutil_ConcurrentHashMap_copy_shards(dst_cmap, src_cmap);
+        return;
+    }
+
+    /* Shard layouts differ, so entries have to be redistributed */
+    _cutil_ConcurrentHashMap_reset(dst_cmap);
+    for (size_t i = 0; i < src_cmap->num_shards; ++i) {
+        _cutil_ConcurrentHashMapShard *const src_shard
+          = _cutil_ConcurrentHashMap_get_shard(src_cmap, i);
+        _cutil_RWLock_read_lock(&src_shard->lock);
+        cutil_ConstIterator *const it
+          = cutil_Map_get_const_iterator(src_shard->map);
+        while (cutil_ConstIterator_next(it)) {
+            const void *const key = cutil_ConstIterator_get_ptr(it);
+            const void *const val = cutil_Map_get_ptr(src_shard->map, key);
+            _cutil_ConcurrentHashMapShard *const dst_shard
+              = _cutil_ConcurrentHashMap_locate_shard(dst_cmap, key);
+            _cutil_RWLock_write_lock(&dst_shard->lock);
+            cutil_Map_set(dst_shard->map, key, val);
+            _cutil_RWLock_write_unlock(&dst_shard->lock);
+        }
+        cutil_ConstIterator_free(it);
+        _cutil_RWLock_read_unlock(&src_shard->lock);
+    }
+}
+
+static void *
+_cutil_ConcurrentHashMap_duplicate(const void *data)
+{
+    const _cutil_ConcurrentHashMap *const src = data;
+
+    cutil_Map *const new_map = cutil_ConcurrentHashMap_alloc_with_shards(
+      src->key_type, src->val_type, src->num_shards
+    );
+    CUTIL_RETURN_NULL_IF_NULL(new_map);
+
+    _cutil_ConcurrentHashMap *const dst_raw = new_map->data;
+    _cutil_ConcurrentHashMap_copy_shards(dst_raw, src);
+
+    free(new_map);
+    return dst_raw;
+}
+
+static size_t
+_cutil_ConcurrentHashMap_get_count(const void *data)
+{
+    const _cutil_ConcurrentHashMap *const cmap = data;
+    size_t count = 0UL;
+    for (size_t i = 0; i < cmap->num_shards; ++i) {
+        _cutil_ConcurrentHashMapShard *const shard
+          = _cutil_ConcurrentHashMap_get_shard(cmap, i);
+        _cutil_RWLock_read_lock(&shard->lock);
+        count += cutil_Map_get_count(shard->map);
+        _cutil_RWLock_read_unlock(&shard->lock);
+    }
+    return count;
+}
+
+static cutil_Status
+_cutil_ConcurrentHashMap_remove(void *data, const void *key)
+{
+    _cutil_ConcurrentHashMap *const cmap = data;
+    _cutil_ConcurrentHashMapShard *const shard
+      = _cutil_ConcurrentHashMap_locate_shard(cmap, key);
+    _cutil_RWLock_write_lock(&shard->lock);
+    const cutil_Status status = cutil_Map_remove(shard->map, key);
+    _cutil_RWLock_write_unlock(&shard->lock);
+    return status;
+}
+
+static cutil_Bool
+_cutil_ConcurrentHashMap_contains(const void *data, const void *key)
+{
+    const _cutil_ConcurrentHashMap *const cmap = data;
+    _cutil_ConcurrentHashMapShard *const shard
+      = _cutil_ConcurrentHashMap_locate_shard(cmap, key);
+    _cutil_RWLock_read_lock(&shard->lock);
+    const cutil_Bool res = cutil_Map_contains(shard->map, key);
+    _cutil_RWLock_read_unlock(&shard->lock);
+    return res;
+}
+
+static cutil_Status
+_cutil_ConcurrentHashMap_get(const void *data, const void *key, void *val)
+{
+    const _cutil_ConcurrentHashMap *const cmap = data;
+    _cutil_ConcurrentHashMapShard *const shard
+      = _cutil_ConcurrentHashMap_locate_shard(cmap, key);
+    _cutil_RWLock_read_lock(&shard->lock);
+    const cutil_Status status = cutil_Map_get(shard->map, key, val);
+    _cutil_RWLock_read_unlock(&shard->lock);
+    return status;
+}
+
+static const void *
+_cutil_ConcurrentHashMap_get_ptr(const void *data, const void *key)
+{
+    const _cutil_ConcurrentHashMap *const cmap = data;
+    _cutil_ConcurrentHashMapShard *const shard
+      = _cutil_ConcurrentHashMap_locate_shard(cmap, key);
+    _cutil_RWLock_read_lock(&shard->lock);
+    const void *const res = cutil_Map_get_ptr(shard->map, key);
+    _cutil_RWLock_read_unlock(&shard->lock);
+    return res;
+}
+
+static cutil_Status
+_cutil_ConcurrentHashMap_set(void *data, const void *key, const void *val)
+{
+    _cutil_ConcurrentHashMap *const cmap = data;
+    _cutil_ConcurrentHashMapShard *const shard
+      = _cutil_ConcurrentHashMap_locate_shard(cmap, key);
+    _cutil_RWLock_write_lock(&shard->lock);
+    const cutil_Status status = cutil_Map_set(shard->map, key, val);
+    _cutil_RWLock_write_unlock(&shard->lock);
+    return status;
+}
+
+static void *
+_cutil_ConcurrentHashMap_get_or_insert(
+  void *data, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    _cutil_ConcurrentHashMap *const cmap = data;
+    _cutil_ConcurrentHashMapShard *const shard
+      = _cutil_ConcurrentHashMap_locate_shard(cmap, key);
+    _cutil_RWLock_write_lock(&shard->lock);
+    void *const res = cutil_Map_get_or_insert(shard->map, key, val, inserted);
+    _cutil_RWLock_write_unlock(&shard->lock);
+    return res;
+}
+
+static cutil_Status
+_cutil_ConcurrentHashMap_reserve(void *data, size_t count)
+{
+    _cutil_ConcurrentHashMap *const cmap = data;
+    /* Leave some headroom, since keys are not spread perfectly evenly */
+    const size_t shard_count = count / cmap->num_shards + count / 8UL
+                             / cmap->num_shards + 1UL;
+    cutil_Status status = CUTIL_STATUS_SUCCESS;
+    for (size_t i = 0; i < cmap->num_shards; ++i) {
+        _cutil_ConcurrentHashMapShard *const shard
+          = _cutil_ConcurrentHashMap_get_shard(cmap, i);
+        _cutil_RWLock_write_lock(&shard->lock);
+        if (cutil_Map_reserve(shard->map, shard_count)
+            != CUTIL_STATUS_SUCCESS) {
+            status = CUTIL_STATUS_FAILURE;
+        }
+        _cutil_RWLock_write_unlock(&shard->lock);
+    }
+    return status;
+}
+
+static cutil_Status
+_cutil_ConcurrentHashMap_shrink_to_fit(void *data)
+{
+    _cutil_ConcurrentHashMap *const cmap = data;
+    cutil_Status status = CUTIL_STATUS_SUCCESS;
+    for (size_t i = 0; i < cmap->num_shards; ++i) {
+        _cutil_ConcurrentHashMapShard *const shard
+          = _cutil_ConcurrentHashMap_get_shard(cmap, i);
+        _cutil_RWLock_write_lock(&shard->lock);
+        if (cutil_Map_shrink_to_fit(shard->map) != CUTIL_STATUS_SUCCESS) {
+            status = CUTIL_STATUS_FAILURE;
+        }
+        _cutil_RWLock_write_unlock(&shard->lock);
+    }
+    return status;
+}
+
+static const cutil_GenericType *
+_cutil_ConcurrentHashMap_get_key_type(const void *data)
+{
+    const _cutil_ConcurrentHashMap *const cmap = data;
+    return cmap->key_type;
+}
+
+static const cutil_GenericType *
+_cutil_ConcurrentHashMap_get_val_type(const void *data)
+{
+    const _cutil_ConcurrentHashMap *const cmap = data;
+    return cmap->val_type;
+}
+
+/**
+ * Iterates over the shards one after another, using a HashMap iterator for
+ * the current shard. The lock of the current shard is held while the
+ * iterator is on it: shared for const iterators, exclusive for iterators
+ * that may remove entries.
+ */
+typedef struct {
+    const _cutil_ConcurrentHashMap *cmap;
+    size_t shard;       /**< current shard, num_shards once exhausted */
+    cutil_Iterator *it; /**< iterator of current shard, NULL if none */
+    cutil_Bool exclusive; /**< write lock instead of read lock? */
+} _cutil_ConcurrentHashMapIter;
+
+/**
+ * Frees the HashMap iterator of the current shard and releases its lock.
+ */
+static void
+_cutil_ConcurrentHashMapIter_leave_shard(_cutil_ConcurrentHashMapIter *iter)
+{
+    CUTIL_RETURN_IF_NULL(iter->it);
+    _cutil_ConcurrentHashMapShard *const shard
+      = _cutil_ConcurrentHashMap_get_shard(iter->cmap, iter->shard);
+    cutil_Iterator_free(iter->it);
+    iter->it = NULL;
+    if (iter->exclusive) {
+        _cutil_RWLock_write_unlock(&shard->lock);
+    } else {
+        _cutil_RWLock_read_unlock(&shard->lock);
+    }
+}
+
+/**
+ * Takes the lock of the current shard and creates a HashMap iterator for it.
+ */
+static void
+_cutil_ConcurrentHashMapIter_enter_shard(_cutil_ConcurrentHashMapIter *iter)
+{
+    _cutil_ConcurrentHashMapShard *const shard
+      = _cutil_ConcurrentHashMap_get_shard(iter->cmap, iter->shard);
+    if (iter->exclusive) {
+        _cutil_RWLock_write_lock(&shard->lock);
+    } else {
+        _cutil_RWLock_read_lock(&shard->lock);
+    }
+    iter->it = cutil_Map_get_iterator(shard->map);
+}
+
+static void
+_cutil_ConcurrentHashMapIter_rewind(void *data)
+{
+    _cutil_ConcurrentHashMapIter *const iter = data;
+    _cutil_ConcurrentHashMapIter_leave_shard(iter);
+    iter->shard = 0UL;
+}
+
+static void
+_cutil_ConcurrentHashMapIter_free(void *data)
+{
+    _cutil_ConcurrentHashMapIter_rewind(data);
+    free(data);
+}
+
+static cutil_Bool
+_cutil_ConcurrentHashMapIter_next(void *data)
+{
+    _cutil_ConcurrentHashMapIter *const iter = data;
+    const _cutil_ConcurrentHashMap *const cmap = iter->cmap;
+    for (;;) {
+        if (iter->it == NULL) {
+            if (iter->shard >= cmap->num_shards) {
+                return CUTIL_FALSE;
+            }
+            _cutil_ConcurrentHashMapIter_enter_shard(iter);
+        }
+        if (cutil_Iterator_next(iter->it)) {
+            return CUTIL_TRUE;
+        }
+        _cutil_ConcurrentHashMapIter_leave_shard(iter);
+        ++iter->shard;
+    }
+}
+
+static const void *
+_cutil_ConcurrentHashMapIter_get_ptr(const void *data)
+{
+    const _cutil_ConcurrentHashMapIter *const iter = data;
+    CUTIL_RETURN_NULL_IF_NULL(iter->it);
+    return cutil_Iterator_get_ptr(iter->it);
+}
+
+static cutil_Status
+_cutil_ConcurrentHashMapIter_get(const void *data, void *out)
+{
+    const _cutil_ConcurrentHashMapIter *const iter = data;
+    CUTIL_RETURN_VAL_IF_NULL(iter->it, CUTIL_STATUS_FAILURE);
+    return cutil_Iterator_get(iter->it, out);
+}
+
+/**
+ * Removes the current entry. Iterators that may remove entries hold the
+ * write lock of the current shard already.
+ */
+static cutil_Status
+_cutil_ConcurrentHashMapIter_remove(void *data)
+{
+    _cutil_ConcurrentHashMapIter *const iter = data;
+    CUTIL_RETURN_VAL_IF_NULL(iter->it, CUTIL_STATUS_FAILURE);
+    return cutil_Iterator_remove(iter->it);
+}
+
+static const cutil_ConstIteratorType
+  CUTIL_CONST_ITERATOR_TYPE_CONCURRENT_HASHMAP_OBJECT
+  = {
+    .name = "cutil_ConstIterator<cutil_ConcurrentHashMap>",
+    .free = &_cutil_ConcurrentHashMapIter_free,
+    .rewind = &_cutil_ConcurrentHashMapIter_rewind,
+    .next = &_cutil_ConcurrentHashMapIter_next,
+    .get = &_cutil_ConcurrentHashMapIter_get,
+    .get_ptr = &_cutil_ConcurrentHashMapIter_get_ptr,
+};
+
+const cutil_ConstIteratorType
+  *const CUTIL_CONST_ITERATOR_TYPE_CONCURRENT_HASHMAP
+  = &CUTIL_CONST_ITERATOR_TYPE_CONCURRENT_HASHMAP_OBJECT;
+
+static const cutil_IteratorType CUTIL_ITERATOR_TYPE_CONCURRENT_HASHMAP_OBJECT
+  = {
+    .name = "cutil_Iterator<cutil_ConcurrentHashMap>",
+    .free = &_cutil_ConcurrentHashMapIter_free,
+    .rewind = &_cutil_ConcurrentHashMapIter_rewind,
+    .next = &_cutil_ConcurrentHashMapIter_next,
+    .get = &_cutil_ConcurrentHashMapIter_get,
+    .get_ptr = &_cutil_ConcurrentHashMapIter_get_ptr,
+    .set = NULL,
+    .remove = &_cutil_ConcurrentHashMapIter_remove,
+};
+
+const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_CONCURRENT_HASHMAP
+  = &CUTIL_ITERATOR_TYPE_CONCURRENT_HASHMAP_OBJECT;
+
+static _cutil_ConcurrentHashMapIter *
+_cutil_ConcurrentHashMapIter_alloc(
+  const _cutil_ConcurrentHashMap *cmap, cutil_Bool exclusive
+)
+{
+    _cutil_ConcurrentHashMapIter *const it_data = CUTIL_MALLOC_OBJECT(it_data);
+    it_data->cmap = cmap;
+    it_data->shard = 0UL;
+    it_data->it = NULL;
+    it_data->exclusive = exclusive;
+    return it_data;
+}
+
+static cutil_ConstIterator *
+_cutil_ConcurrentHashMap_get_const_iterator(const void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_ConstIterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_CONST_ITERATOR_TYPE_CONCURRENT_HASHMAP;
+    it->data = _cutil_ConcurrentHashMapIter_alloc(data, CUTIL_FALSE);
+
+    cutil_log_debug("ConcurrentHashMap: created const iterator");
+    return it;
+}
+
+static cutil_Iterator *
+_cutil_ConcurrentHashMap_get_iterator(void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_Iterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_ITERATOR_TYPE_CONCURRENT_HASHMAP;
+    it->data = _cutil_ConcurrentHashMapIter_alloc(data, CUTIL_TRUE);
+
+    cutil_log_debug("ConcurrentHashMap: created iterator");
+    return it;
+}
+
+static const cutil_MapType CUTIL_MAP_TYPE_CONCURRENT_HASHMAP_OBJECT = {
+  .name = "cutil_ConcurrentHashMap",
+  .free = &_cutil_ConcurrentHashMap_free,
+  .reset = &_cutil_ConcurrentHashMap_reset,
+  .copy = &_cutil_ConcurrentHashMap_copy,
+  .duplicate = &_cutil_ConcurrentHashMap_duplicate,
+  .get_count = &_cutil_ConcurrentHashMap_get_count,
+  .remove = &_cutil_ConcurrentHashMap_remove,
+  .contains = &_cutil_ConcurrentHashMap_contains,
+  .get = &_cutil_ConcurrentHashMap_get,
+  .get_ptr = &_cutil_ConcurrentHashMap_get_ptr,
+  .set = &_cutil_ConcurrentHashMap_set,
+  .get_or_insert = &_cutil_ConcurrentHashMap_get_or_insert,
+  .reserve = &_cutil_ConcurrentHashMap_reserve,
+  .shrink_to_fit = &_cutil_ConcurrentHashMap_shrink_to_fit,
+  .get_key_type = &_cutil_ConcurrentHashMap_get_key_type,
+  .get_val_type = &_cutil_ConcurrentHashMap_get_val_type,
+  .get_const_iterator = &_cutil_ConcurrentHashMap_get_const_iterator,
+  .get_iterator = &_cutil_ConcurrentHashMap_get_iterator,
+};
+
+const cutil_MapType *const CUTIL_MAP_TYPE_CONCURRENT_HASHMAP
+  = &CUTIL_MAP_TYPE_CONCURRENT_HASHMAP_OBJECT;
@@ -0,0 +1,975 @@
+#include <cutil/data/generic/map/flatmap.h>
+#include <cutil/data/generic/set/flatset.h>
+
+#include <cutil/io/log.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/util/macro.h>
+
+#define FLATMAP_MIN_CAPACITY ((size_t) 8)
+#define FLATMAP_EXPAND_FACTOR ((size_t) 2)
+
+#ifndef NDEBUG
+    /**
+     * MACRO for checking if a cutil_Map or cutil_Set has vtable `VTABLE`. If
+     * not, function and type names are logged.
+     */
+    #define CUTIL_FLATMAP_TYPE_CHECK(OBJ, VTABLE)                              \
+        do {                                                                   \
+            if (OBJ->vtable != VTABLE) {                                       \
+                cutil_log_warn(                                                \
+                  "%s: expected object of type %s, got %s", __func__,          \
+                  VTABLE->name, OBJ->vtable->name                              \
+                );                                                             \
+            }                                                                  \
+        } while (0)
+#else
+    #define CUTIL_FLATMAP_TYPE_CHECK(OBJ, VTABLE) ((void) (OBJ))
+#endif /* NDEBUG */
+
+/*
+ * Entries [0, count) of `keys` and `vals` hold the entries in ascending key
+ * order. Slots from `count` up to the capacity of the arrays are initialized
+ * but hold no resources, so entries are relocated bytewise when the arrays are
+ * shifted, and vacated slots are initialized again.
+ */
+typedef struct {
+    const cutil_GenericType *key_type;
+    const cutil_GenericType *val_type; /**< NULL for a FlatSet, see below */
+    size_t count;
+    cutil_Array *keys;
+    cutil_Array *vals; /**< NULL for a FlatSet */
+} _cutil_FlatMap;
+
+static inline void *
+_cutil_FlatMap_key(const _cutil_FlatMap *flat, size_t idx)
+{
+    return cutil_void_array_get_elem(
+      flat->key_type->size, flat->keys->data, idx
+    );
+}
+
+static inline void *
+_cutil_FlatMap_val(const _cutil_FlatMap *flat, size_t idx)
+{
+    return cutil_void_array_get_elem(
+      flat->val_type->size, flat->vals->data, idx
+    );
+}
+
+static inline int
+_cutil_FlatMap_compare(
+  const _cutil_FlatMap *flat, const void *lhs, const void *rhs
+)
+{
+    return cutil_GenericType_apply_compare(flat->key_type, lhs, rhs);
+}
+
+static _cutil_FlatMap *
+_cutil_FlatMap_create(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+)
+{
+    if (!cutil_GenericType_is_valid(key_type)) {
+        cutil_log_warn("Key type is not valid");
+        return NULL;
+    }
+    if (val_type != NULL && !cutil_GenericType_is_valid(val_type)) {
+        cutil_log_warn("Value type is not valid");
+        return NULL;
+    }
+
+    _cutil_FlatMap *const flat = CUTIL_MALLOC_OBJECT(flat);
+    flat->key_type = key_type;
+    flat->val_type = val_type;
+    flat->count = 0UL;
+    flat->keys = cutil_Array_alloc(key_type, 0UL);
+    flat->vals = val_type != NULL ? cutil_Array_alloc(val_type, 0UL) : NULL;
+    return flat;
+}
+
+static size_t
+_cutil_FlatMap_get_capacity(const _cutil_FlatMap *flat)
+{
+    return cutil_Array_get_capacity(flat->keys);
+}
+
+static void
+_cutil_FlatMap_resize(_cutil_FlatMap *flat, size_t capacity)
+{
+    cutil_Array_resize(flat->keys, capacity);
+    if (flat->vals != NULL) {
+        cutil_Array_resize(flat->vals, capacity);
+    }
+}
+
+/**
+ * Grows the arrays of `flat` to hold `count` entries, at least doubling them
+ * to amortize consecutive insertions.
+ */
+static void
+_cutil_FlatMap_grow_to(_cutil_FlatMap *flat, size_t count)
+{
+    const size_t capacity = _cutil_FlatMap_get_capacity(flat);
+    if (count <= capacity) {
+        return;
+    }
+    const size_t expanded
+      = CUTIL_MAX(capacity * FLATMAP_EXPAND_FACTOR, FLATMAP_MIN_CAPACITY);
+    _cutil_FlatMap_resize(flat, CUTIL_MAX(count, expanded));
+}
+
+/**
+ * Returns index of the first key of `flat` that is not less than `key`. The
+ * search range is halved without branching on the comparison, so that the
+ * loop runs the same number of iterations for every key.
+ */
+static size_t
+_cutil_FlatMap_lower_bound(const _cutil_FlatMap *flat, const void *key)
+{
+    size_t base = 0UL;
+    size_t len = flat->count;
+    while (len > 1U) {
+        const size_t half = len / 2U;
+        const int cmp = _cutil_FlatMap_compare(
+          flat, _cutil_FlatMap_key(flat, base + half), key
+        );
+        base = (cmp < 0) ? base + half : base;
+        len -= half;
+    }
+    if (len == 1U
+        && _cutil_FlatMap_compare(flat, _cutil_FlatMap_key(flat, base), key)
+             < 0) {
+        ++base;
+    }
+    return base;
+}
+
+/**
+ * Returns index of the first key of `flat` that is not less than `key` and
+ * stores in `found` whether that key equals `key`.
+ */
+static size_t
+_cutil_FlatMap_find(
+  const _cutil_FlatMap *flat, const void *key, cutil_Bool *found
+)
+{
+    const size_t idx = _cutil_FlatMap_lower_bound(flat, key);
+    *found = CUTIL_BOOLIFY(
+      idx < flat->count
+      && _cutil_FlatMap_compare(flat, _cutil_FlatMap_key(flat, idx), key) == 0
+    );
+    return idx;
+}
+
+/**
+ * Shifts the entries from `idx` on by one slot towards the back and leaves
+ * slot `idx` initialized. The arrays must have room for another entry.
+ */
+static void
+_cutil_FlatMap_open_slot(_cutil_FlatMap *flat, size_t idx)
+{
+    const size_t num = flat->count - idx;
+    void *const key = _cutil_FlatMap_key(flat, idx);
+    memmove(
+      _cutil_FlatMap_key(flat, idx + 1U), key, num * flat->key_type->size
+    );
+    cutil_GenericType_apply_init(flat->key_type, key);
+    if (flat->vals != NULL) {
+        void *const val = _cutil_FlatMap_val(flat, idx);
+        memmove(
+          _cutil_FlatMap_val(flat, idx + 1U), val, num * flat->val_type->size
+        );
+        cutil_GenericType_apply_init(flat->val_type, val);
+    }
+}
+
+/**
+ * Clears the entry at `idx` and shifts the entries after it by one slot
+ * towards the front.
+ */
+static void
+_cutil_FlatMap_erase(_cutil_FlatMap *flat, size_t idx)
+{
+    const size_t num = flat->count - idx - 1U;
+    const size_t last = flat->count - 1U;
+    void *const key = _cutil_FlatMap_key(flat, idx);
+    cutil_GenericType_apply_clear(flat->key_type, key);
+    memmove(
+      key, _cutil_FlatMap_key(flat, idx + 1U), num * flat->key_type->size
+    );
+    cutil_GenericType_apply_init(
+      flat->key_type, _cutil_FlatMap_key(flat, last)
+    );
+    if (flat->vals != NULL) {
+        void *const val = _cutil_FlatMap_val(flat, idx);
+        cutil_GenericType_apply_clear(flat->val_type, val);
+        memmove(
+          val, _cutil_FlatMap_val(flat, idx + 1U), num * flat->val_type->size
+        );
+        cutil_GenericType_apply_init(
+          flat->val_type, _cutil_FlatMap_val(flat, last)
+        );
+    }
+    --flat->count;
+}
+
+/**
+ * Returns index of `key`, inserting it with value `val` if not present. `val`
+ * is ignored for a FlatSet.
+ */
+static size_t
+_cutil_FlatMap_find_or_insert(
+  _cutil_FlatMap *flat, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    const size_t idx = _cutil_FlatMap_find(flat, key, inserted);
+    if (*inserted) {
+        *inserted = CUTIL_FALSE;
+        return idx;
+    }
+    _cutil_FlatMap_grow_to(flat, flat->count + 1U);
+    _cutil_FlatMap_open_slot(flat, idx);
+    cutil_GenericType_apply_copy(
+      flat->key_type, _cutil_FlatMap_key(flat, idx), key
+    );
+    if (flat->vals != NULL) {
+        cutil_GenericType_apply_copy(
+          flat->val_type, _cutil_FlatMap_val(flat, idx), val
+        );
+    }
+    ++flat->count;
+    *inserted = CUTIL_TRUE;
+    return idx;
+}
+
+/**
+ * Merges the runs [lo, mid) and [mid, hi) of `src` into `dst`. Runs that are
+ * in order already are copied after a single comparison.
+ */
+static void
+_cutil_FlatMap_merge_runs(
+  const cutil_GenericType *type,
+  const void *keys,
+  const size_t *src,
+  size_t *dst,
+  size_t lo,
+  size_t mid,
+  size_t hi
+)
+{
+    const size_t size = type->size;
+#define FLATMAP_RUN_KEY(IDX) cutil_void_array_get_elem_const(size, keys, IDX)
+    if (mid == hi
+        || cutil_GenericType_apply_compare(
+             type, FLATMAP_RUN_KEY(src[mid - 1U]), FLATMAP_RUN_KEY(src[mid])
+           ) <= 0) {
+        memcpy(dst + lo, src + lo, (hi - lo) * sizeof *dst);
+        return;
+    }
+    size_t i = lo;
+    size_t j = mid;
+    size_t k = lo;
+    while (i < mid && j < hi) {
+        const int cmp = cutil_GenericType_apply_compare(
+          type, FLATMAP_RUN_KEY(src[j]), FLATMAP_RUN_KEY(src[i])
+        );
+        dst[k++] = (cmp < 0) ? src[j++] : src[i++];
+    }
+#undef FLATMAP_RUN_KEY
+    memcpy(dst + k, src + i, (mid - i) * sizeof *dst);
+    k += mid - i;
+    memcpy(dst + k, src + j, (hi - j) * sizeof *dst);
+}
+
+/**
+ * Sorts the `num` indices of `order` stably by the keys of `keys` they refer
+ * to, merging runs bottom-up with `tmp` as scratch space. Only indices move,
+ * so keys of any type are compared in place and never copied.
+ */
+static void
+_cutil_FlatMap_sort(
+  const cutil_GenericType *type,
+  const void *keys,
+  size_t *order,
+  size_t *tmp,
+  size_t num
+)
+{
+    size_t *src = order;
+    size_t *dst = tmp;
+    for (size_t width = 1UL; width < num; width *= 2U) {
+        for (size_t lo = 0; lo < num; lo += 2U * width) {
+            const size_t mid = CUTIL_MIN(lo + width, num);
+            const size_t hi = CUTIL_MIN(lo + 2U * width, num);
+            _cutil_FlatMap_merge_runs(type, keys, src, dst, lo, mid, hi);
+        }
+        size_t *const swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != order) {
+        memcpy(order, src, num * sizeof *order);
+    }
+}
+
+/**
+ * Moves the entry at `src` to slot `dst`, which holds no resources, and
+ * leaves the bytes of `src` behind to be overwritten.
+ */
+static void
+_cutil_FlatMap_relocate(_cutil_FlatMap *flat, size_t dst, size_t src)
+{
+    CUTIL_RETURN_IF_VAL(dst, src);
+    memcpy(
+      _cutil_FlatMap_key(flat, dst), _cutil_FlatMap_key(flat, src),
+      flat->key_type->size
+    );
+    if (flat->vals != NULL) {
+        memcpy(
+          _cutil_FlatMap_val(flat, dst), _cutil_FlatMap_val(flat, src),
+          flat->val_type->size
+        );
+    }
+}
+
+/**
+ * Sets `num` entries of `keys` and `vals` (NULL for a FlatSet). The entries
+ * are sorted by index once, of equal keys only the last one is kept, and the
+ * new keys are counted in a forward pass over both sorted sequences. The
+ * arrays are then grown once and merged from the back, so that every
+ * existing entry moves at most once.
+ */
+static cutil_Status
+_cutil_FlatMap_set_mult(
+  _cutil_FlatMap *flat, const void *keys, const void *vals, size_t num
+)
+{
+    CUTIL_RETURN_VAL_IF_VAL(num, 0UL, CUTIL_STATUS_SUCCESS);
+    const size_t key_size = flat->key_type->size;
+    size_t *const order = CUTIL_MALLOC_MULT(order, num);
+    size_t *const tmp = CUTIL_MALLOC_MULT(tmp, num);
+    for (size_t i = 0; i < num; ++i) {
+        order[i] = i;
+    }
+    _cutil_FlatMap_sort(flat->key_type, keys, order, tmp, num);
+    free(tmp);
+
+#define FLATMAP_INPUT_KEY(IDX)                                                 \
+    cutil_void_array_get_elem_const(key_size, keys, IDX)
+    size_t num_unique = 0UL;
+    for (size_t i = 0; i < num; ++i) {
+        if (i + 1U < num
+            && _cutil_FlatMap_compare(
+                 flat, FLATMAP_INPUT_KEY(order[i]),
+                 FLATMAP_INPUT_KEY(order[i + 1U])
+               ) == 0) {
+            continue;
+        }
+        order[num_unique++] = order[i];
+    }
+
+    size_t num_new = 0UL;
+    for (size_t i = 0, j = 0; j < num_unique;) {
+        const int cmp = (i < flat->count)
+                        ? _cutil_FlatMap_compare(
+                            flat, _cutil_FlatMap_key(flat, i),
+                            FLATMAP_INPUT_KEY(order[j])
+                          )
+                        : 1;
+        if (cmp < 0) {
+            ++i;
+            continue;
+        }
+        num_new += (cmp > 0);
+        i += (cmp == 0);
+        ++j;
+    }
+
+    _cutil_FlatMap_grow_to(flat, flat->count + num_new);
+    size_t i = flat->count;
+    size_t j = num_unique;
+    size_t out = flat->count + num_new;
+    while (j > 0U) {
+        const void *const key = FLATMAP_INPUT_KEY(order[j - 1U]);
+        const void *const val = (flat->vals != NULL)
+                                ? cutil_void_array_get_elem_const(
+                                    flat->val_type->size, vals, order[j - 1U]
+                                  )
+                                : NULL;
+        const int cmp = (i > 0U) ? _cutil_FlatMap_compare(
+                                     flat, _cutil_FlatMap_key(flat, i - 1U), key
+                                   )
+                                 : -1;
+        --out;
+        if (cmp >= 0) {
+            if (cmp == 0) {
+                if (val != NULL) {
+                    cutil_GenericType_apply_copy(
+                      flat->val_type, _cutil_FlatMap_val(flat, i - 1U), val
+                    );
+                }
+                --j;
+            }
+            _cutil_FlatMap_relocate(flat, out, i - 1U);
+            --i;
+            continue;
+        }
+        cutil_GenericType_apply_init(
+          flat->key_type, _cutil_FlatMap_key(flat, out)
+        );
+        cutil_GenericType_apply_copy(
+          flat->key_type, _cutil_FlatMap_key(flat, out), key
+        );
+        if (val != NULL) {
+            void *const slot = _cutil_FlatMap_val(flat, out);
+            cutil_GenericType_apply_init(flat->val_type, slot);
+            cutil_GenericType_apply_copy(flat->val_type, slot, val);
+        }
+        --j;
+    }
+#undef FLATMAP_INPUT_KEY
+    flat->count += num_new;
+    free(order);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+cutil_Map *
+cutil_FlatMap_alloc(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+)
+{
+    CUTIL_RETURN_NULL_IF_NULL(val_type);
+    _cutil_FlatMap *const flat = _cutil_FlatMap_create(key_type, val_type);
+    CUTIL_RETURN_NULL_IF_NULL(flat);
+
+    cutil_Map *const map = CUTIL_MALLOC_OBJECT(map);
+    map->vtable = CUTIL_MAP_TYPE_FLATMAP;
+    map->data = flat;
+    return map;
+}
+
+cutil_Status
+cutil_FlatMap_set_mult(
+  cutil_Map *map, const void *keys, const void *vals, size_t num
+)
+{
+    CUTIL_NULL_CHECK(map);
+    CUTIL_FLATMAP_TYPE_CHECK(map, CUTIL_MAP_TYPE_FLATMAP);
+    CUTIL_RETURN_VAL_IF_VAL(num, 0UL, CUTIL_STATUS_SUCCESS);
+    CUTIL_NULL_CHECK(keys);
+    CUTIL_NULL_CHECK(vals);
+    return _cutil_FlatMap_set_mult(map->data, keys, vals, num);
+}
+
+cutil_Map *
+cutil_FlatMap_from_arrays(const cutil_Array *keys, const cutil_Array *vals)
+{
+    CUTIL_RETURN_NULL_IF_NULL(keys);
+    CUTIL_RETURN_NULL_IF_NULL(vals);
+    const size_t num = cutil_Array_get_capacity(keys);
+    if (cutil_Array_get_capacity(vals) != num) {
+        cutil_log_warn(
+          "FlatMap from_arrays: got %zu keys but %zu values", num,
+          cutil_Array_get_capacity(vals)
+        );
+        return NULL;
+    }
+
+    cutil_Map *const map = cutil_FlatMap_alloc(
+      cutil_Array_get_type(keys), cutil_Array_get_type(vals)
+    );
+    CUTIL_RETURN_NULL_IF_NULL(map);
+    if (cutil_FlatMap_set_mult(map, keys->data, vals->data, num)
+        != CUTIL_STATUS_SUCCESS) {
+        cutil_Map_free(map);
+        return NULL;
+    }
+    return map;
+}
+
+static void
+_cutil_FlatMap_free(void *data)
+{
+    _cutil_FlatMap *const flat = data;
+    CUTIL_RETURN_IF_NULL(flat);
+    cutil_Array_free(flat->keys);
+    cutil_Array_free(flat->vals);
+    free(flat);
+}
+
+static void
+_cutil_FlatMap_reset(void *data)
+{
+    _cutil_FlatMap *const flat = data;
+    CUTIL_RETURN_IF_VAL(flat->count, 0UL);
+    cutil_GenericType_apply_clear_mult(
+      flat->key_type, flat->keys->data, flat->count
+    );
+    cutil_GenericType_apply_init_mult(
+      flat->key_type, flat->keys->data, flat->count
+    );
+    if (flat->vals != NULL) {
+        cutil_GenericType_apply_clear_mult(
+          flat->val_type, flat->vals->data, flat->count
+        );
+        cutil_GenericType_apply_init_mult(
+          flat->val_type, flat->vals->data, flat->count
+        );
+    }
+    flat->count = 0UL;
+}
+
+static void
+_cutil_FlatMap_copy(void *dst, const void *src)
+{
+    _cutil_FlatMap *const dst_flat = dst;
+    const _cutil_FlatMap *const src_flat = src;
+    CUTIL_RETURN_IF_VAL(dst_flat, src_flat);
+
+    _cutil_FlatMap_reset(dst_flat);
+    CUTIL_RETURN_IF_VAL(src_flat->count, 0UL);
+    _cutil_FlatMap_grow_to(dst_flat, src_flat->count);
+    cutil_GenericType_apply_copy_mult(
+      dst_flat->key_type, dst_flat->keys->data, src_flat->keys->data,
+      src_flat->count
+    );
+    if (dst_flat->vals != NULL) {
+        cutil_GenericType_apply_copy_mult(
+          dst_flat->val_type, dst_flat->vals->data, src_flat->vals->data,
+          src_flat->count
+        );
+    }
+    dst_flat->count = src_flat->count;
+}
+
+static void *
+_cutil_FlatMap_duplicate(const void *data)
+{
+    const _cutil_FlatMap *const src = data;
+    _cutil_FlatMap *const dst
+      = _cutil_FlatMap_create(src->key_type, src->val_type);
+    CUTIL_RETURN_NULL_IF_NULL(dst);
+    _cutil_FlatMap_copy(dst, src);
+    return dst;
+}
+
+static size_t
+_cutil_FlatMap_get_count(const void *data)
+{
+    const _cutil_FlatMap *const flat = data;
+    return flat->count;
+}
+
+static cutil_Status
+_cutil_FlatMap_remove(void *data, const void *key)
+{
+    _cutil_FlatMap *const flat = data;
+    cutil_Bool found;
+    const size_t idx = _cutil_FlatMap_find(flat, key, &found);
+    if (!found) {
+        return CUTIL_STATUS_FAILURE;
+    }
+    _cutil_FlatMap_erase(flat, idx);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Bool
+_cutil_FlatMap_contains(const void *data, const void *key)
+{
+    cutil_Bool found;
+    (void) _cutil_FlatMap_find(data, key, &found);
+    return found;
+}
+
+static const void *
+_cutil_FlatMap_get_ptr(const void *data, const void *key)
+{
+    const _cutil_FlatMap *const flat = data;
+    cutil_Bool found;
+    const size_t idx = _cutil_FlatMap_find(flat, key, &found);
+    return found ? _cutil_FlatMap_val(flat, idx) : NULL;
+}
+
+static cutil_Status
+_cutil_FlatMap_get(const void *data, const void *key, void *val)
+{
+    const _cutil_FlatMap *const flat = data;
+    const void *const p = _cutil_FlatMap_get_ptr(data, key);
+    CUTIL_RETURN_VAL_IF_NULL(p, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(flat->val_type, val, p);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_FlatMap_set(void *data, const void *key, const void *val)
+{
+    _cutil_FlatMap *const flat = data;
+    cutil_Bool inserted;
+    const size_t idx
+      = _cutil_FlatMap_find_or_insert(flat, key, val, &inserted);
+    if (!inserted) {
+        cutil_GenericType_apply_copy(
+          flat->val_type, _cutil_FlatMap_val(flat, idx), val
+        );
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static void *
+_cutil_FlatMap_get_or_insert(
+  void *data, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    _cutil_FlatMap *const flat = data;
+    cutil_Bool res;
+    const size_t idx = _cutil_FlatMap_find_or_insert(flat, key, val, &res);
+    if (inserted != NULL) {
+        *inserted = res;
+    }
+    return _cutil_FlatMap_val(flat, idx);
+}
+
+static cutil_Status
+_cutil_FlatMap_reserve(void *data, size_t count)
+{
+    _cutil_FlatMap *const flat = data;
+    if (count > _cutil_FlatMap_get_capacity(flat)) {
+        _cutil_FlatMap_resize(flat, count);
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_FlatMap_shrink_to_fit(void *data)
+{
+    _cutil_FlatMap *const flat = data;
+    _cutil_FlatMap_resize(flat, flat->count);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static const cutil_GenericType *
+_cutil_FlatMap_get_key_type(const void *data)
+{
+    const _cutil_FlatMap *const flat = data;
+    return flat->key_type;
+}
+
+static const cutil_GenericType *
+_cutil_FlatMap_get_val_type(const void *data)
+{
+    const _cutil_FlatMap *const flat = data;
+    return flat->val_type;
+}
+
+typedef struct {
+    _cutil_FlatMap *flat;
+    size_t idx;         /**< index of the current entry */
+    cutil_Bool pending; /**< whether `idx` is yet to be visited by next */
+} _cutil_FlatMapIter;
+
+static void
+_cutil_FlatMapIter_free(void *data)
+{
+    free(data);
+}
+
+static void
+_cutil_FlatMapIter_rewind(void *data)
+{
+    _cutil_FlatMapIter *const iter = data;
+    iter->idx = 0UL;
+    iter->pending = CUTIL_TRUE;
+}
+
+static cutil_Bool
+_cutil_FlatMapIter_next(void *data)
+{
+    _cutil_FlatMapIter *const iter = data;
+    if (iter->pending) {
+        iter->pending = CUTIL_FALSE;
+    } else if (iter->idx < iter->flat->count) {
+        ++iter->idx;
+    }
+    return CUTIL_BOOLIFY(iter->idx < iter->flat->count);
+}
+
+static const void *
+_cutil_FlatMapIter_get_ptr(const void *data)
+{
+    const _cutil_FlatMapIter *const iter = data;
+    if (iter->pending || iter->idx >= iter->flat->count) {
+        return NULL;
+    }
+    return _cutil_FlatMap_key(iter->flat, iter->idx);
+}
+
+static cutil_Status
+_cutil_FlatMapIter_get(const void *data, void *out)
+{
+    const _cutil_FlatMapIter *const iter = data;
+    const void *const p = _cutil_FlatMapIter_get_ptr(data);
+    CUTIL_RETURN_VAL_IF_NULL(p, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(iter->flat->key_type, out, p);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+/**
+ * Removes the current entry. The following entries move into its slot, so
+ * the iterator visits the same index again on the next call to next.
+ */
+static cutil_Status
+_cutil_FlatMapIter_remove(void *data)
+{
+    _cutil_FlatMapIter *const iter = data;
+    CUTIL_RETURN_VAL_IF_NULL(
+      _cutil_FlatMapIter_get_ptr(data), CUTIL_STATUS_FAILURE
+    );
+    _cutil_FlatMap_erase(iter->flat, iter->idx);
+    iter->pending = CUTIL_TRUE;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static _cutil_FlatMapIter *
+_cutil_FlatMapIter_alloc(const _cutil_FlatMap *flat)
+{
+    _cutil_FlatMapIter *const iter = CUTIL_MALLOC_OBJECT(iter);
+    iter->flat = CUTIL_CONST_CAST(flat);
+    _cutil_FlatMapIter_rewind(iter);
+    return iter;
+}
+
+static const cutil_ConstIteratorType CUTIL_CONST_ITERATOR_TYPE_FLATMAP_OBJECT
+  = {
+    .name = "cutil_ConstIterator<cutil_FlatMap>",
+    .free = &_cutil_FlatMapIter_free,
+    .rewind = &_cutil_FlatMapIter_rewind,
+    .next = &_cutil_FlatMapIter_next,
+    .get = &_cutil_FlatMapIter_get,
+    .get_ptr = &_cutil_FlatMapIter_get_ptr,
+};
+
+const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_FLATMAP
+  = &CUTIL_CONST_ITERATOR_TYPE_FLATMAP_OBJECT;
+
+static const cutil_IteratorType CUTIL_ITERATOR_TYPE_FLATMAP_OBJECT = {
+  .name = "cutil_Iterator<cutil_FlatMap>",
+  .free = &_cutil_FlatMapIter_free,
+  .rewind = &_cutil_FlatMapIter_rewind,
+  .next = &_cutil_FlatMapIter_next,
+  .get = &_cutil_FlatMapIter_get,
+  .get_ptr = &_cutil_FlatMapIter_get_ptr,
+  .set = NULL,
+  .remove = &_cutil_FlatMapIter_remove,
+};
+
+const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_FLATMAP
+  = &CUTIL_ITERATOR_TYPE_FLATMAP_OBJECT;
+
+static cutil_ConstIterator *
+_cutil_FlatMap_get_const_iterator(const void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+    cutil_ConstIterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_CONST_ITERATOR_TYPE_FLATMAP;
+    it->data = _cutil_FlatMapIter_alloc(data);
+    return it;
+}
+
+static cutil_Iterator *
+_cutil_FlatMap_get_iterator(void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+    cutil_Iterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_ITERATOR_TYPE_FLATMAP;
+    it->data = _cutil_FlatMapIter_alloc(data);
+    return it;
+}
+
+static const cutil_MapType CUTIL_MAP_TYPE_FLATMAP_OBJECT = {
+  .name = "cutil_FlatMap",
+  .free = &_cutil_FlatMap_free,
+  .reset = &_cutil_FlatMap_reset,
+  .copy = &_cutil_FlatMap_copy,
+  .duplicate = &_cutil_FlatMap_duplicate,
+  .get_count = &_cutil_FlatMap_get_count,
+  .remove = &_cutil_FlatMap_remove,
+  .contains = &_cutil_FlatMap_contains,
+  .get = &_cutil_FlatMap_get,
+  .get_ptr = &_cutil_FlatMap_get_ptr,
+  .set = &_cutil_FlatMap_set,
+  .get_or_insert = &_cutil_FlatMap_get_or_insert,
+  .reserve = &_cutil_FlatMap_reserve,
+  .shrink_to_fit = &_cutil_FlatMap_shrink_to_fit,
+  .get_key_type = &_cutil_FlatMap_get_key_type,
+  .get_val_type = &_cutil_FlatMap_get_val_type,
+  .get_const_iterator = &_cutil_FlatMap_get_const_iterator,
+  .get_iterator = &_cutil_FlatMap_get_iterator,
+};
+
+const cutil_MapType *const CUTIL_MAP_TYPE_FLATMAP
+  = &CUTIL_MAP_TYPE_FLATMAP_OBJECT;
+
+/*
+ * FlatSet. A set is the key array of a FlatMap without values: its data is a
+ * _cutil_FlatMap whose `val_type` is NULL, and its vtable calls into the
+ * arrays directly rather than through a cutil_Map.
+ */
+
+cutil_Set *
+cutil_FlatSet_alloc(const cutil_GenericType *elem_type)
+{
+    _cutil_FlatMap *const flat = _cutil_FlatMap_create(elem_type, NULL);
+    CUTIL_RETURN_NULL_IF_NULL(flat);
+
+    cutil_Set *const set = CUTIL_MALLOC_OBJECT(set);
+    set->vtable = CUTIL_SET_TYPE_FLATSET;
+    set->data = flat;
+    return set;
+}
+
+cutil_Status
+cutil_FlatSet_add_mult(cutil_Set *set, const void *elems, size_t num)
+{
+    CUTIL_NULL_CHECK(set);
+    CUTIL_FLATMAP_TYPE_CHECK(set, CUTIL_SET_TYPE_FLATSET);
+    CUTIL_RETURN_VAL_IF_VAL(num, 0UL, CUTIL_STATUS_SUCCESS);
+    CUTIL_NULL_CHECK(elems);
+    return _cutil_FlatMap_set_mult(set->data, elems, NULL, num);
+}
+
+cutil_Set *
+cutil_FlatSet_from_array(const cutil_Array *elems)
+{
+    CUTIL_RETURN_NULL_IF_NULL(elems);
+    cutil_Set *const set = cutil_FlatSet_alloc(cutil_Array_get_type(elems));
+    CUTIL_RETURN_NULL_IF_NULL(set);
+    if (cutil_FlatSet_add_mult(
+          set, elems->data, cutil_Array_get_capacity(elems)
+        )
+        != CUTIL_STATUS_SUCCESS) {
+        cutil_Set_free(set);
+        return NULL;
+    }
+    return set;
+}
+
+static cutil_Status
+_cutil_FlatSet_insert_if_absent(
+  void *data, const void *elem, cutil_Bool *inserted
+)
+{
+    cutil_Bool res;
+    (void) _cutil_FlatMap_find_or_insert(data, elem, NULL, &res);
+    if (inserted != NULL) {
+        *inserted = res;
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_FlatSet_add(void *data, const void *elem)
+{
+    cutil_Bool inserted = CUTIL_FALSE;
+    const cutil_Status status
+      = _cutil_FlatSet_insert_if_absent(data, elem, &inserted);
+    if (status == CUTIL_STATUS_SUCCESS && !inserted) {
+        cutil_log_warn("FlatSet add: element already in set, skipping");
+    }
+    return status;
+}
+
+/**
+ * Combines the sorted arrays of `dst` and `src` in a single merge pass into a
+ * new array. Elements of `dst` are moved rather than copied.
+ */
+static cutil_Status
+_cutil_FlatSet_combine(void *dst, const void *src, cutil_SetOp op)
+{
+    _cutil_FlatMap *const flat = dst;
+    const _cutil_FlatMap *const other = src;
+    if (flat == other) {
+        if (op == CUTIL_SET_OP_DIFFERENCE || op == CUTIL_SET_OP_SYMDIFF) {
+            _cutil_FlatMap_reset(flat);
+        }
+        return CUTIL_STATUS_SUCCESS;
+    }
+
+    /* Which elements to keep: only in `dst`, only in `src`, in both */
+    const cutil_Bool keep_dst = op != CUTIL_SET_OP_INTERSECTION;
+    const cutil_Bool keep_src
+      = op == CUTIL_SET_OP_UNION || op == CUTIL_SET_OP_SYMDIFF;
+    const cutil_Bool keep_both
+      = op == CUTIL_SET_OP_UNION || op == CUTIL_SET_OP_INTERSECTION;
+    const size_t capacity = keep_src ? flat->count + other->count
+                          : keep_dst ? flat->count
+                                     : CUTIL_MIN(flat->count, other->count);
+    cutil_Array *const keys = cutil_Array_alloc(flat->key_type, capacity);
+    const size_t size = flat->key_type->size;
+
+    size_t count = 0UL;
+    size_t i = 0UL;
+    size_t j = 0UL;
+    while (i < flat->count && (j < other->count || keep_dst)) {
+        const int cmp = (j < other->count)
+                        ? _cutil_FlatMap_compare(
+                            flat, _cutil_FlatMap_key(flat, i),
+                            _cutil_FlatMap_key(other, j)
+                          )
+                        : -1;
+        if (cmp > 0) {
+            if (keep_src) {
+                cutil_GenericType_apply_copy(
+                  flat->key_type,
+                  cutil_void_array_get_elem(size, keys->data, count++),
+                  _cutil_FlatMap_key(other, j)
+                );
+            }
+            ++j;
+            continue;
+        }
+        if (cmp < 0 ? keep_dst : keep_both) {
+            void *const elem = _cutil_FlatMap_key(flat, i);
+            memcpy(
+              cutil_void_array_get_elem(size, keys->data, count++), elem, size
+            );
+            cutil_GenericType_apply_init(flat->key_type, elem);
+        }
+        ++i;
+        j += (cmp == 0);
+    }
+    for (; keep_src && j < other->count; ++j) {
+        cutil_GenericType_apply_copy(
+          flat->key_type, cutil_void_array_get_elem(size, keys->data, count++),
+          _cutil_FlatMap_key(other, j)
+        );
+    }
+
+    /* Moved elements were initialized again, so this frees the rest */
+    cutil_Array_free(flat->keys);
+    flat->keys = keys;
+    flat->count = count;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static const cutil_SetType CUTIL_SET_TYPE_FLATSET_OBJECT = {
+  .name = "cutil_FlatSet",
+  .free = &_cutil_FlatMap_free,
+  .reset = &_cutil_FlatMap_reset,
+  .copy = &_cutil_FlatMap_copy,
+  .duplicate = &_cutil_FlatMap_duplicate,
+  .get_count = &_cutil_FlatMap_get_count,
+  .contains = &_cutil_FlatMap_contains,
+  .add = &_cutil_FlatSet_add,
+  .insert_if_absent = &_cutil_FlatSet_insert_if_absent,
+  .remove = &_cutil_FlatMap_remove,
+  .reserve = &_cutil_FlatMap_reserve,
+  .shrink_to_fit = &_cutil_FlatMap_shrink_to_fit,
+  .get_elem_type = &_cutil_FlatMap_get_key_type,
+  .get_const_iterator = &_cutil_FlatMap_get_const_iterator,
+  .get_iterator = &_cutil_FlatMap_get_iterator,
+  .combine = &_cutil_FlatSet_combine,
+};
+
+const cutil_SetType *const CUTIL_SET_TYPE_FLATSET
+  = &CUTIL_SET_TYPE_FLATSET_OBJECT;
@@ -0,0 +1,799 @@
+#include <cutil/data/generic/map/frozenmap.h>
+
+#include <cutil/io/log.h>
+#include <cutil/status.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/util/hash.h>
+#include <cutil/util/macro.h>
+
+/*
+ * Minimal perfect hashing via hash-and-displace (CHD/PTHash). Keys are
+ * distributed over about n / FROZENMAP_BUCKET_LOAD buckets by their hash.
+ * Every bucket stores a pilot value, and the slot of a key is derived from
+ * its hash mixed with the pilot of its bucket. During construction, buckets
+ * are processed from largest to smallest, and for each bucket the smallest
+ * pilot is searched for which all of its keys land in distinct free slots.
+ * A lookup thus costs one hash, one pilot load and one key comparison.
+ *
+ * Keys whose hash equals that of another key land in the same slot for every
+ * pilot. Only the first key of each such group takes part in the perfect
+ * hash; the others are stored behind its slots, sorted by hash and key, and
+ * binary searched when the comparison in the primary slot fails.
+ */
+#define FROZENMAP_BUCKET_LOAD ((size_t) 4)
+#define FROZENMAP_PILOT_MULT CUTIL_HASH_C(0x9e3779b97f4a7c15)
+#define FROZENMAP_BATCH_SIZE ((size_t) 16)
+
+typedef struct {
+    const cutil_GenericType *key_type;
+    const cutil_GenericType *val_type;
+    size_t count;       /**< number of entries and slots */
+    size_t num_slots;   /**< slots addressed by the perfect hash */
+    size_t num_buckets; /**< number of pilots */
+    uint32_t *pilots;
+    void *keys;
+    void *vals;
+    /** hashes of the overflow entries in slots [num_slots, count) */
+    cutil_hash_t *overflow_hashes;
+} _cutil_FrozenMap;
+
+/**
+ * Maps `hash` to [0, `num`) without a division if `num` fits into 32 bits.
+ */
+static inline size_t
+_cutil_FrozenMap_reduce(cutil_hash_t hash, size_t num)
+{
+    if (num <= UINT32_MAX) {
+        return (size_t) (((hash >> 32U) * (uint64_t) num) >> 32U);
+    }
+    return (size_t) (hash % num);
+}
+
+static inline cutil_hash_t
+_cutil_FrozenMap_hash_key(const _cutil_FrozenMap *fm, const void *key)
+{
+    return cutil_hash_finalize(
+      cutil_GenericType_apply_hash(fm->key_type, key)
+    );
+}
+
+static inline size_t
+_cutil_FrozenMap_get_bucket(const _cutil_FrozenMap *fm, cutil_hash_t hash)
+{
+    return _cutil_FrozenMap_reduce(hash, fm->num_buckets);
+}
+
+static inline size_t
+_cutil_FrozenMap_get_slot(
+  const _cutil_FrozenMap *fm, cutil_hash_t hash, uint32_t pilot
+)
+{
+    return _cutil_FrozenMap_reduce(
+      cutil_hash_finalize(hash ^ (pilot * FROZENMAP_PILOT_MULT)), fm->num_slots
+    );
+}
+
+static inline void *
+_cutil_FrozenMap_get_key_ptr(const _cutil_FrozenMap *fm, size_t idx)
+{
+    return cutil_void_array_get_elem(fm->key_type->size, fm->keys, idx);
+}
+
+static inline void *
+_cutil_FrozenMap_get_val_ptr(const _cutil_FrozenMap *fm, size_t idx)
+{
+    return cutil_void_array_get_elem(fm->val_type->size, fm->vals, idx);
+}
+
+/**
+ * Returns slot of `key` with `hash` among the overflow entries of `fm`, or
+ * CUTIL_ERROR_INDEX if `key` is not present.
+ */
+static size_t
+_cutil_FrozenMap_find_overflow(
+  const _cutil_FrozenMap *fm, cutil_hash_t hash, const void *key
+)
+{
+    const size_t num_overflow = fm->count - fm->num_slots;
+    CUTIL_RETURN_VAL_IF_VAL(num_overflow, 0UL, CUTIL_ERROR_INDEX);
+
+    /* Bound the run of entries with `hash`, then search it by key */
+    size_t lo = 0UL;
+    size_t hi = num_overflow;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2U;
+        if (fm->overflow_hashes[mid] < hash) {
+            lo = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+    hi = num_overflow;
+    for (size_t end = lo; end < hi;) {
+        const size_t mid = end + (hi - end) / 2U;
+        if (fm->overflow_hashes[mid] == hash) {
+            end = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2U;
+        const int cmp = cutil_GenericType_apply_compare(
+          fm->key_type, _cutil_FrozenMap_get_key_ptr(fm, fm->num_slots + mid),
+          key
+        );
+        if (cmp == 0) {
+            return fm->num_slots + mid;
+        }
+        if (cmp < 0) {
+            lo = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+    return CUTIL_ERROR_INDEX;
+}
+
+/**
+ * Returns slot of `key` in `fm` if `hash` belongs to `key`, or
+ * CUTIL_ERROR_INDEX if `key` is not present.
+ */
+static inline size_t
+_cutil_FrozenMap_find(
+  const _cutil_FrozenMap *fm, cutil_hash_t hash, const void *key
+)
+{
+    if (fm->count == 0U) {
+        return CUTIL_ERROR_INDEX;
+    }
+    const uint32_t pilot = fm->pilots[_cutil_FrozenMap_get_bucket(fm, hash)];
+    const size_t idx = _cutil_FrozenMap_get_slot(fm, hash, pilot);
+    if (cutil_GenericType_apply_compare(
+          fm->key_type, _cutil_FrozenMap_get_key_ptr(fm, idx), key
+        )
+        != 0) {
+        return _cutil_FrozenMap_find_overflow(fm, hash, key);
+    }
+    return idx;
+}
+
+/**
+ * Compares the keys with indices `lhs` and `rhs` by hash first and by the
+ * comparison function of the key type second.
+ */
+static int
+_cutil_FrozenMap_compare_overflow(
+  const _cutil_FrozenMap *fm,
+  const cutil_hash_t *hashes,
+  const void *const *keys,
+  size_t lhs,
+  size_t rhs
+)
+{
+    if (hashes[lhs] != hashes[rhs]) {
+        return (hashes[lhs] < hashes[rhs]) ? -1 : 1;
+    }
+    return cutil_GenericType_apply_compare(fm->key_type, keys[lhs], keys[rhs]);
+}
+
+/**
+ * Sorts the `num` key indices of `order` by hash and key, using `tmp` as
+ * scratch space.
+ */
+static void
+_cutil_FrozenMap_sort_overflow(
+  const _cutil_FrozenMap *fm,
+  const cutil_hash_t *hashes,
+  const void *const *keys,
+  size_t *order,
+  size_t *tmp,
+  size_t num
+)
+{
+    if (num < 2U) {
+        return;
+    }
+    const size_t half = num / 2U;
+    _cutil_FrozenMap_sort_overflow(fm, hashes, keys, order, tmp, half);
+    _cutil_FrozenMap_sort_overflow(
+      fm, hashes, keys, order + half, tmp, num - half
+    );
+    size_t i = 0UL;
+    size_t j = half;
+    size_t k = 0UL;
+    while (i < half && j < num) {
+        tmp[k++] = (_cutil_FrozenMap_compare_overflow(
+                      fm, hashes, keys, order[j], order[i]
+                    )
+                    < 0)
+                   ? order[j++]
+                   : order[i++];
+    }
+    while (i < half) {
+        tmp[k++] = order[i++];
+    }
+    memcpy(order, tmp, k * sizeof *order);
+}
+
+/**
+ * Searches a pilot for every bucket such that the `fm->count` keys with
+ * `hashes` are mapped to distinct slots, and stores the slot of each key in
+ * `slots`. Keys with the hash of another key of their bucket are placed in
+ * the overflow slots behind the perfect hash instead.
+ *
+ * @return CUTIL_STATUS_FAILURE if no pilot was found for some bucket
+ */
+static cutil_Status
+_cutil_FrozenMap_build_pilots(
+  _cutil_FrozenMap *fm,
+  const cutil_hash_t *hashes,
+  const void *const *keys,
+  size_t *slots
+)
+{
+    const size_t n = fm->count;
+    const size_t num_buckets = fm->num_buckets;
+    cutil_Status status = CUTIL_STATUS_SUCCESS;
+
+    /* Group keys by bucket */
+    size_t *const offsets = calloc(num_buckets + 1U, sizeof *offsets);
+    size_t *const members = malloc(n * sizeof *members);
+    for (size_t i = 0; i < n; ++i) {
+        ++offsets[_cutil_FrozenMap_get_bucket(fm, hashes[i]) + 1U];
+    }
+    for (size_t b = 0; b < num_buckets; ++b) {
+        offsets[b + 1U] += offsets[b];
+    }
+    size_t *const fill = malloc(num_buckets * sizeof *fill);
+    memcpy(fill, offsets, num_buckets * sizeof *fill);
+    for (size_t i = 0; i < n; ++i) {
+        members[fill[_cutil_FrozenMap_get_bucket(fm, hashes[i])]++] = i;
+    }
+
+    /*
+     * Keys with equal hashes end up in the same slot for every pilot, and
+     * equal hashes share a bucket. Move all but the first key of each hash
+     * to `overflow`, keeping the primary keys at the front of their bucket.
+     */
+    size_t *const sizes = malloc(num_buckets * sizeof *sizes);
+    size_t *const overflow = malloc(n * sizeof *overflow);
+    size_t num_overflow = 0UL;
+    size_t max_bucket_size = 0UL;
+    for (size_t b = 0; b < num_buckets; ++b) {
+        size_t *const bucket = members + offsets[b];
+        size_t num_primary = 0UL;
+        for (size_t i = 0; i < offsets[b + 1U] - offsets[b]; ++i) {
+            const size_t key_idx = bucket[i];
+            size_t j = 0UL;
+            while (j < num_primary && hashes[bucket[j]] != hashes[key_idx]) {
+                ++j;
+            }
+            if (j < num_primary) {
+                overflow[num_overflow++] = key_idx;
+            } else {
+                bucket[num_primary++] = key_idx;
+            }
+        }
+        sizes[b] = num_primary;
+        max_bucket_size = CUTIL_MAX(max_bucket_size, num_primary);
+    }
+    fm->num_slots = n - num_overflow;
+
+    /* Order buckets by size, largest first (reusing `fill`) */
+    size_t *const size_offsets
+      = calloc(max_bucket_size + 2U, sizeof *size_offsets);
+    for (size_t b = 0; b < num_buckets; ++b) {
+        ++size_offsets[max_bucket_size - sizes[b] + 1U];
+    }
+    for (size_t s = 0; s <= max_bucket_size; ++s) {
+        size_offsets[s + 1U] += size_offsets[s];
+    }
+    size_t *const order = fill;
+    for (size_t b = 0; b < num_buckets; ++b) {
+        order[size_offsets[max_bucket_size - sizes[b]]++] = b;
+    }
+    free(size_offsets);
+
+    unsigned char *const taken = calloc(fm->num_slots, sizeof *taken);
+    for (size_t ob = 0; ob < num_buckets; ++ob) {
+        const size_t b = order[ob];
+        const size_t *const bucket = members + offsets[b];
+        const size_t bucket_size = sizes[b];
+        fm->pilots[b] = 0U;
+        if (bucket_size == 0U) {
+            /* Buckets are ordered by size, so all remaining ones are empty */
+            for (size_t rest = ob + 1U; rest < num_buckets; ++rest) {
+                fm->pilots[order[rest]] = 0U;
+            }
+            break;
+        }
+
+        for (uint32_t pilot = 0;; ++pilot) {
+            size_t num_placed = 0UL;
+            for (; num_placed < bucket_size; ++num_placed) {
+                const size_t key_idx = bucket[num_placed];
+                const size_t slot
+                  = _cutil_FrozenMap_get_slot(fm, hashes[key_idx], pilot);
+                if (taken[slot]) {
+                    break;
+                }
+                taken[slot] = 1U;
+                slots[key_idx] = slot;
+            }
+            if (num_placed == bucket_size) {
+                fm->pilots[b] = pilot;
+                break;
+            }
+            for (size_t i = 0; i < num_placed; ++i) {
+                taken[slots[bucket[i]]] = 0U;
+            }
+            if (pilot == UINT32_MAX) {
+                cutil_log_warn("FrozenMap: no pilot found for bucket %zu", b);
+                status = CUTIL_STATUS_FAILURE;
+                break;
+            }
+        }
+        if (status == CUTIL_STATUS_FAILURE) {
+            break;
+        }
+    }
+
+    free(taken);
+
+    if (status == CUTIL_STATUS_SUCCESS && num_overflow > 0U) {
+        _cutil_FrozenMap_sort_overflow(
+          fm, hashes, keys, overflow, members, num_overflow
+        );
+        fm->overflow_hashes
+          = malloc(num_overflow * sizeof *fm->overflow_hashes);
+        for (size_t i = 0; i < num_overflow; ++i) {
+            slots[overflow[i]] = fm->num_slots + i;
+            fm->overflow_hashes[i] = hashes[overflow[i]];
+        }
+    }
+
+    free(overflow);
+    free(sizes);
+    free(order);
+    free(members);
+    free(offsets);
+    return status;
+}
+
+static void
+_cutil_FrozenMap_reset(void *data)
+{
+    _cutil_FrozenMap *const fm = data;
+    if (fm->count > 0U) {
+        cutil_GenericType_apply_clear_mult(fm->key_type, fm->keys, fm->count);
+        cutil_GenericType_apply_clear_mult(fm->val_type, fm->vals, fm->count);
+    }
+    free(fm->pilots);
+    free(fm->keys);
+    free(fm->vals);
+    free(fm->overflow_hashes);
+    fm->pilots = NULL;
+    fm->keys = NULL;
+    fm->vals = NULL;
+    fm->overflow_hashes = NULL;
+    fm->count = 0UL;
+    fm->num_slots = 0UL;
+    fm->num_buckets = 0UL;
+}
+
+static void
+_cutil_FrozenMap_free(void *data)
+{
+    CUTIL_RETURN_IF_NULL(data);
+    _cutil_FrozenMap_reset(data);
+    free(data);
+}
+
+/**
+ * Allocates pilots and slots of `dst` for `count` entries, all of them
+ * addressed by the perfect hash until overflow entries are split off.
+ */
+static void
+_cutil_FrozenMap_alloc_slots(_cutil_FrozenMap *dst, size_t count)
+{
+    dst->count = count;
+    dst->num_slots = count;
+    dst->num_buckets = count / FROZENMAP_BUCKET_LOAD + 1U;
+    dst->pilots = malloc(dst->num_buckets * sizeof *dst->pilots);
+    dst->keys = malloc(count * dst->key_type->size);
+    dst->vals = malloc(count * dst->val_type->size);
+    cutil_GenericType_apply_init_mult(dst->key_type, dst->keys, count);
+    cutil_GenericType_apply_init_mult(dst->val_type, dst->vals, count);
+}
+
+static void
+_cutil_FrozenMap_copy(void *dst, const void *src)
+{
+    _cutil_FrozenMap *const dst_fm = dst;
+    const _cutil_FrozenMap *const src_fm = src;
+    CUTIL_RETURN_IF_VAL(dst_fm, src_fm);
+
+    _cutil_FrozenMap_reset(dst_fm);
+    CUTIL_RETURN_IF_VAL(src_fm->count, 0U);
+    _cutil_FrozenMap_alloc_slots(dst_fm, src_fm->count);
+    memcpy(
+      dst_fm->pilots, src_fm->pilots,
+      src_fm->num_buckets * sizeof *src_fm->pilots
+    );
+    dst_fm->num_slots = src_fm->num_slots;
+    const size_t num_overflow = src_fm->count - src_fm->num_slots;
+    if (num_overflow > 0U) {
+        dst_fm->overflow_hashes
+          = malloc(num_overflow * sizeof *dst_fm->overflow_hashes);
+        memcpy(
+          dst_fm->overflow_hashes, src_fm->overflow_hashes,
+          num_overflow * sizeof *dst_fm->overflow_hashes
+        );
+    }
+    cutil_GenericType_apply_copy_mult(
+      dst_fm->key_type, dst_fm->keys, src_fm->keys, src_fm->count
+    );
+    cutil_GenericType_apply_copy_mult(
+      dst_fm->val_type, dst_fm->vals, src_fm->vals, src_fm->count
+    );
+}
+
+static void *
+_cutil_FrozenMap_duplicate(const void *data)
+{
+    const _cutil_FrozenMap *const src = data;
+    _cutil_FrozenMap *const dst = CUTIL_MALLOC_OBJECT(dst);
+    dst->key_type = src->key_type;
+    dst->val_type = src->val_type;
+    dst->count = 0UL;
+    dst->num_slots = 0UL;
+    dst->num_buckets = 0UL;
+    dst->pilots = NULL;
+    dst->keys = NULL;
+    dst->vals = NULL;
+    dst->overflow_hashes = NULL;
+    _cutil_FrozenMap_copy(dst, src);
+    return dst;
+}
+
+static size_t
+_cutil_FrozenMap_get_count(const void *data)
+{
+    const _cutil_FrozenMap *const fm = data;
+    return fm->count;
+}
+
+static cutil_Status
+_cutil_FrozenMap_remove(void *data, const void *key)
+{
+    CUTIL_UNUSED(data);
+    CUTIL_UNUSED(key);
+    cutil_log_warn("FrozenMap remove: map is read-only");
+    return CUTIL_STATUS_FAILURE;
+}
+
+static cutil_Bool
+_cutil_FrozenMap_contains(const void *data, const void *key)
+{
+    const _cutil_FrozenMap *const fm = data;
+    const cutil_hash_t hash = _cutil_FrozenMap_hash_key(fm, key);
+    return CUTIL_BOOLIFY(
+      _cutil_FrozenMap_find(fm, hash, key) != CUTIL_ERROR_INDEX
+    );
+}
+
+static const void *
+_cutil_FrozenMap_get_ptr(const void *data, const void *key)
+{
+    const _cutil_FrozenMap *const fm = data;
+    const cutil_hash_t hash = _cutil_FrozenMap_hash_key(fm, key);
+    const size_t idx = _cutil_FrozenMap_find(fm, hash, key);
+    return (idx == CUTIL_ERROR_INDEX) ? NULL
+                                      : _cutil_FrozenMap_get_val_ptr(fm, idx);
+}
+
+static cutil_Status
+_cutil_FrozenMap_get(const void *data, const void *key, void *val)
+{
+    const _cutil_FrozenMap *const fm = data;
+    const void *const ptr = _cutil_FrozenMap_get_ptr(fm, key);
+    CUTIL_RETURN_VAL_IF_NULL(ptr, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(fm->val_type, val, ptr);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_FrozenMap_get_ptr_batch(
+  const void *data, const void *keys, size_t num_keys, const void **vals
+)
+{
+    const _cutil_FrozenMap *const fm = data;
+    const size_t key_size = fm->key_type->size;
+    if (fm->count == 0U) {
+        for (size_t i = 0; i < num_keys; ++i) {
+            vals[i] = NULL;
+        }
+        return CUTIL_STATUS_SUCCESS;
+    }
+
+    cutil_hash_t hashes[FROZENMAP_BATCH_SIZE];
+    size_t slots[FROZENMAP_BATCH_SIZE];
+    for (size_t start = 0; start < num_keys; start += FROZENMAP_BATCH_SIZE) {
+        const size_t num_batch
+          = CUTIL_MIN(FROZENMAP_BATCH_SIZE, num_keys - start);
+        const void *const batch
+          = cutil_void_array_get_elem_const(key_size, keys, start);
+
+        /* Overlap the cache misses on pilots, then on slots */
+        for (size_t i = 0; i < num_batch; ++i) {
+            const void *const key
+              = cutil_void_array_get_elem_const(key_size, batch, i);
+            hashes[i] = _cutil_FrozenMap_hash_key(fm, key);
+            CUTIL_PREFETCH(
+              fm->pilots + _cutil_FrozenMap_get_bucket(fm, hashes[i])
+            );
+        }
+        for (size_t i = 0; i < num_batch; ++i) {
+            const uint32_t pilot
+              = fm->pilots[_cutil_FrozenMap_get_bucket(fm, hashes[i])];
+            slots[i] = _cutil_FrozenMap_get_slot(fm, hashes[i], pilot);
+            CUTIL_PREFETCH(_cutil_FrozenMap_get_key_ptr(fm, slots[i]));
+        }
+        for (size_t i = 0; i < num_batch; ++i) {
+            const void *const key
+              = cutil_void_array_get_elem_const(key_size, batch, i);
+            const size_t idx
+              = (cutil_GenericType_apply_compare(
+                   fm->key_type, _cutil_FrozenMap_get_key_ptr(fm, slots[i]),
+                   key
+                 )
+                 == 0)
+                ? slots[i]
+                : _cutil_FrozenMap_find_overflow(fm, hashes[i], key);
+            vals[start + i] = (idx == CUTIL_ERROR_INDEX)
+                              ? NULL
+                              : _cutil_FrozenMap_get_val_ptr(fm, idx);
+        }
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_FrozenMap_set(void *data, const void *key, const void *val)
+{
+    CUTIL_UNUSED(data);
+    CUTIL_UNUSED(key);
+    CUTIL_UNUSED(val);
+    cutil_log_warn("FrozenMap set: map is read-only");
+    return CUTIL_STATUS_FAILURE;
+}
+
+static void *
+_cutil_FrozenMap_get_or_insert(
+  void *data, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    CUTIL_UNUSED(data);
+    CUTIL_UNUSED(key);
+    CUTIL_UNUSED(val);
+    if (inserted != NULL) {
+        *inserted = CUTIL_FALSE;
+    }
+    cutil_log_warn("FrozenMap get_or_insert: map is read-only");
+    return NULL;
+}
+
+static const cutil_GenericType *
+_cutil_FrozenMap_get_key_type(const void *data)
+{
+    const _cutil_FrozenMap *const fm = data;
+    return fm->key_type;
+}
+
+static const cutil_GenericType *
+_cutil_FrozenMap_get_val_type(const void *data)
+{
+    const _cutil_FrozenMap *const fm = data;
+    return fm->val_type;
+}
+
+typedef struct {
+    const _cutil_FrozenMap *fm;
+    size_t pos; /**< one past the current slot, 0 before the first */
+} _cutil_FrozenMapIter;
+
+static void
+_cutil_FrozenMapIter_free(void *data)
+{
+    free(data);
+}
+
+static void
+_cutil_FrozenMapIter_rewind(void *data)
+{
+    _cutil_FrozenMapIter *const iter = data;
+    iter->pos = 0UL;
+}
+
+static cutil_Bool
+_cutil_FrozenMapIter_next(void *data)
+{
+    _cutil_FrozenMapIter *const iter = data;
+    if (iter->pos >= iter->fm->count) {
+        iter->pos = iter->fm->count + 1U;
+        return CUTIL_FALSE;
+    }
+    ++iter->pos;
+    return CUTIL_TRUE;
+}
+
+static const void *
+_cutil_FrozenMapIter_get_ptr(const void *data)
+{
+    const _cutil_FrozenMapIter *const iter = data;
+    if (iter->pos == 0U || iter->pos > iter->fm->count) {
+        return NULL;
+    }
+    return _cutil_FrozenMap_get_key_ptr(iter->fm, iter->pos - 1U);
+}
+
+static cutil_Status
+_cutil_FrozenMapIter_get(const void *data, void *out)
+{
+    const _cutil_FrozenMapIter *const iter = data;
+    const void *const ptr = _cutil_FrozenMapIter_get_ptr(data);
+    CUTIL_RETURN_VAL_IF_NULL(ptr, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(iter->fm->key_type, out, ptr);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static const cutil_ConstIteratorType CUTIL_CONST_ITERATOR_TYPE_FROZEN_OBJECT
+  = {
+  .name = "cutil_ConstIterator<cutil_FrozenMap>",
+  .free = &_cutil_FrozenMapIter_free,
+  .rewind = &_cutil_FrozenMapIter_rewind,
+  .next = &_cutil_FrozenMapIter_next,
+  .get = &_cutil_FrozenMapIter_get,
+  .get_ptr = &_cutil_FrozenMapIter_get_ptr,
+};
+
+const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_FROZEN
+  = &CUTIL_CONST_ITERATOR_TYPE_FROZEN_OBJECT;
+
+static const cutil_IteratorType CUTIL_ITERATOR_TYPE_FROZEN_OBJECT = {
+  .name = "cutil_Iterator<cutil_FrozenMap>",
+  .free = &_cutil_FrozenMapIter_free,
+  .rewind = &_cutil_FrozenMapIter_rewind,
+  .next = &_cutil_FrozenMapIter_next,
+  .get = &_cutil_FrozenMapIter_get,
+  .get_ptr = &_cutil_FrozenMapIter_get_ptr,
+  .set = NULL,
+  .remove = NULL,
+};
+
+const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_FROZEN
+  = &CUTIL_ITERATOR_TYPE_FROZEN_OBJECT;
+
+static _cutil_FrozenMapIter *
+_cutil_FrozenMapIter_alloc(const _cutil_FrozenMap *fm)
+{
+    _cutil_FrozenMapIter *const iter = CUTIL_MALLOC_OBJECT(iter);
+    iter->fm = fm;
+    iter->pos = 0UL;
+    return iter;
+}
+
+static cutil_ConstIterator *
+_cutil_FrozenMap_get_const_iterator(const void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_ConstIterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_CONST_ITERATOR_TYPE_FROZEN;
+    it->data = _cutil_FrozenMapIter_alloc(data);
+
+    cutil_log_debug("FrozenMap: created const iterator");
+    return it;
+}
+
+static cutil_Iterator *
+_cutil_FrozenMap_get_iterator(void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_Iterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_ITERATOR_TYPE_FROZEN;
+    it->data = _cutil_FrozenMapIter_alloc(data);
+
+    cutil_log_debug("FrozenMap: created iterator");
+    return it;
+}
+
+static const cutil_MapType CUTIL_MAP_TYPE_FROZEN_OBJECT = {
+  .name = "cutil_FrozenMap",
+  .free = &_cutil_FrozenMap_free,
+  .reset = &_cutil_FrozenMap_reset,
+  .copy = &_cutil_FrozenMap_copy,
+  .duplicate = &_cutil_FrozenMap_duplicate,
+  .get_count = &_cutil_FrozenMap_get_count,
+  .remove = &_cutil_FrozenMap_remove,
+  .contains = &_cutil_FrozenMap_contains,
+  .get = &_cutil_FrozenMap_get,
+  .get_ptr = &_cutil_FrozenMap_get_ptr,
+  .get_ptr_batch = &_cutil_FrozenMap_get_ptr_batch,
+  .set = &_cutil_FrozenMap_set,
+  .get_or_insert = &_cutil_FrozenMap_get_or_insert,
+  .get_key_type = &_cutil_FrozenMap_get_key_type,
+  .get_val_type = &_cutil_FrozenMap_get_val_type,
+  .get_const_iterator = &_cutil_FrozenMap_get_const_iterator,
+  .get_iterator = &_cutil_FrozenMap_get_iterator,
+};
+
+const cutil_MapType *const CUTIL_MAP_TYPE_FROZEN
+  = &CUTIL_MAP_TYPE_FROZEN_OBJECT;
+
+cutil_Map *
+cutil_Map_freeze(const cutil_Map *map)
+{
+    CUTIL_RETURN_NULL_IF_NULL(map);
+
+    _cutil_FrozenMap *const fm = CUTIL_MALLOC_OBJECT(fm);
+    fm->key_type = cutil_Map_get_key_type(map);
+    fm->val_type = cutil_Map_get_val_type(map);
+    fm->count = 0UL;
+    fm->num_slots = 0UL;
+    fm->num_buckets = 0UL;
+    fm->pilots = NULL;
+    fm->keys = NULL;
+    fm->vals = NULL;
+    fm->overflow_hashes = NULL;
+
+    const size_t count = cutil_Map_get_count(map);
+    if (count > 0U) {
+        /* Keys of `map` are referenced in place while building */
+        const void **const src_keys = malloc(count * sizeof *src_keys);
+        cutil_hash_t *const hashes = malloc(count * sizeof *hashes);
+        size_t *const slots = malloc(count * sizeof *slots);
+        cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+        size_t num_keys = 0UL;
+        while (num_keys < count && cutil_ConstIterator_next(it)) {
+            src_keys[num_keys] = cutil_ConstIterator_get_ptr(it);
+            hashes[num_keys]
+              = _cutil_FrozenMap_hash_key(fm, src_keys[num_keys]);
+            ++num_keys;
+        }
+        cutil_ConstIterator_free(it);
+
+        _cutil_FrozenMap_alloc_slots(fm, num_keys);
+        const cutil_Status status
+          = (num_keys == count)
+              ? _cutil_FrozenMap_build_pilots(fm, hashes, src_keys, slots)
+              : CUTIL_STATUS_FAILURE;
+        if (status == CUTIL_STATUS_SUCCESS) {
+            for (size_t i = 0; i < count; ++i) {
+                cutil_GenericType_apply_copy(
+                  fm->key_type, _cutil_FrozenMap_get_key_ptr(fm, slots[i]),
+                  src_keys[i]
+                );
+                cutil_GenericType_apply_copy(
+                  fm->val_type, _cutil_FrozenMap_get_val_ptr(fm, slots[i]),
+                  cutil_Map_get_ptr(map, src_keys[i])
+                );
+            }
+        }
+        free(slots);
+        free(hashes);
+        free(src_keys);
+        if (status == CUTIL_STATUS_FAILURE) {
+            _cutil_FrozenMap_free(fm);
+            return NULL;
+        }
+    }
+
+    cutil_Map *const frozen = CUTIL_MALLOC_OBJECT(frozen);
+    frozen->vtable = CUTIL_MAP_TYPE_FROZEN;
+    frozen->data = fm;
+    return frozen;
+}
@@ -1,319 +1,2395 @@
+#if !defined(_WIN32)
+    /* pthreads require POSIX.1c */
+    #undef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200112L
+#else
+    /* rand_s, see '_cutil_HashMap_init_process_key' */
+    #define _CRT_RAND_S
+#endif
+
 #include <cutil/data/generic/map/hashmap.h>
+#include <cutil/data/generic/set/hashset.h>
+
+#include <limits.h>
+#include <time.h>
 
 #include <cutil/data/generic/array.h>
 #include <cutil/data/generic/iterator.h>
-#include <cutil/data/native/bitarray.h>
+#include <cutil/data/generic/list/arraylist.h>
 #include <cutil/io/log.h>
 #include <cutil/status.h>
+#include <cutil/std/inttypes.h>
+#include <cutil/std/stdio.h>
 #include <cutil/std/stdlib.h>
 #include <cutil/std/string.h>
+#include <cutil/util/bits.h>
+#include <cutil/util/hash.h>
 #include <cutil/util/macro.h>
 
-#define HASHMAP_INITIAL_CAPACITY 8
-#define HASHMAP_RESIZE_CAPACITY (2.0 / 3.0)
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <pthread.h>
+#endif
+
+/*
+ * Control-byte group matching. Each slot of the table owns one control byte
+ * which is either EMPTY, DELETED or, if the slot is occupied, the lowest seven
+ * bits of the (finalized) hash of its key. Probing loads a whole group of
+ * control bytes at once and matches all of them against the fingerprint in
+ * parallel, so the key comparison only runs on fingerprint hits.
+ *
+ * Define CUTIL_DISABLE_SIMD to force the portable implementation.
+ */
+#if !defined(CUTIL_DISABLE_SIMD)                                               \
+  && (defined(__SSE2__) || defined(_M_X64)                                     \
+      || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define HASHMAP_GROUP_SSE2
+    #include <emmintrin.h>
+#elif !defined(CUTIL_DISABLE_SIMD)                                             \
+  && (defined(__ARM_NEON) || defined(__ARM_NEON__))                            \
+  && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    #define HASHMAP_GROUP_NEON
+    #include <arm_neon.h>
+#else
+    #define HASHMAP_GROUP_PORTABLE
+#endif
+
+#if defined(HASHMAP_GROUP_SSE2)
+    #define HASHMAP_GROUP_WIDTH ((size_t) 16)
+    #define HASHMAP_GROUP_SHIFT 0
+typedef __m128i _cutil_HashMapGroup;
+#elif defined(HASHMAP_GROUP_NEON)
+    #define HASHMAP_GROUP_WIDTH ((size_t) 16)
+    #define HASHMAP_GROUP_SHIFT 2
+typedef uint8x16_t _cutil_HashMapGroup;
+#else
+    #define HASHMAP_GROUP_WIDTH ((size_t) 8)
+    #define HASHMAP_GROUP_SHIFT 3
+typedef uint64_t _cutil_HashMapGroup;
+#endif
+
+/* Must be a power of two no smaller than HASHMAP_GROUP_WIDTH */
+#define HASHMAP_INITIAL_CAPACITY ((size_t) 16)
+/* Entries stored inline before a table is allocated */
+#define HASHMAP_SMALL_CAPACITY ((size_t) 8)
+#define HASHMAP_SMALL_ALIGNMENT ((size_t) 16)
+#define HASHMAP_DEFAULT_MAX_LOAD_FACTOR (2.0 / 3.0)
+/* Leaves at least two empty slots in the smallest table */
+#define HASHMAP_MAX_MAX_LOAD_FACTOR (7.0 / 8.0)
 #define HASHMAP_EXPAND_FACTOR ((size_t) 2)
-#define HASHMAP_PERTURB_SHIFT 5
+#define HASHMAP_EAGER_RESIZE ((size_t) 0)
+/* Number of keys whose home slots are prefetched ahead in batched lookups */
+#define HASHMAP_BATCH_SIZE ((size_t) 16)
+/* Regions per worker of a parallel build, for load balancing */
+#define HASHMAP_BUILD_REGIONS_PER_WORKER ((size_t) 8)
+/* Minimal number of groups per region of a parallel build */
+#define HASHMAP_BUILD_MIN_REGION_GROUPS ((size_t) 64)
+
+#define HASHMAP_CTRL_EMPTY ((unsigned char) 0x80)
+#define HASHMAP_CTRL_DELETED ((unsigned char) 0xFE)
+#define HASHMAP_H2_BITS 7
+#define HASHMAP_H2_MASK ((cutil_hash_t) 0x7F)
 
 #define ITER_REWOUND_SENTINEL CUTIL_ERROR_INDEX
 
+/*
+ * Adds `NUM` to the lookup counter `COUNTER` of `HASHMAP` if counters are
+ * compiled in. Lookups take the map by const pointer, which is cast away here,
+ * so maps read concurrently are skipped.
+ */
+#ifdef CUTIL_ENABLE_HASHMAP_COUNTERS
+    #define HASHMAP_COUNT(HASHMAP, COUNTER, NUM)                               \
+        do {                                                                   \
+            if (!(HASHMAP)->concurrent_reads) {                                \
+                ((_cutil_HashMap *) CUTIL_CONST_CAST(HASHMAP))->COUNTER        \
+                  += (NUM);                                                    \
+            }                                                                  \
+        } while (0)
+#else
+    #define HASHMAP_COUNT(HASHMAP, COUNTER, NUM) ((void) 0)
+#endif
+
+#ifndef NDEBUG
+    /**
+     * MACRO for checking if a cutil_Map is a HashMap. If not, function and
+     * type names are logged.
+     */
+    #define CUTIL_HASHMAP_TYPE_CHECK(MAP)                                      \
+        do {                                                                   \
+            if (MAP->vtable != CUTIL_MAP_TYPE_HASHMAP) {                       \
+                cutil_log_warn(                                                \
+                  "%s: expected map of type %s, got %s", __func__,             \
+                  CUTIL_MAP_TYPE_HASHMAP->name, MAP->vtable->name              \
+                );                                                             \
+            }                                                                  \
+        } while (0)
+#else
+    #define CUTIL_HASHMAP_TYPE_CHECK(MAP) ((void) (MAP))
+#endif /* NDEBUG */
+
+/**
+ * Bit mask with one (group-specific) bit per matching slot of a group.
+ */
+typedef uint64_t _cutil_HashMapBitMask;
+
+static inline _cutil_HashMapGroup
+_cutil_HashMapGroup_load(const unsigned char *ctrl)
+{
+#if defined(HASHMAP_GROUP_SSE2)
+    return _mm_loadu_si128((const __m128i *) ctrl);
+#elif defined(HASHMAP_GROUP_NEON)
+    return vld1q_u8(ctrl);
+#else
+    uint64_t res = 0U;
+    for (size_t i = 0; i < HASHMAP_GROUP_WIDTH; ++i) {
+        res |= (uint64_t) ctrl[i] << (CHAR_BIT * i);
+    }
+    return res;
+#endif
+}
+
+#if defined(HASHMAP_GROUP_NEON)
+static inline _cutil_HashMapBitMask
+_cutil_HashMapGroup_neon_mask(uint8x16_t cmp)
+{
+    const uint8x8_t nibbles = vshrn_n_u16(vreinterpretq_u16_u8(cmp), 4);
+    const uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(nibbles), 0);
+    return mask & UINT64_C(0x8888888888888888);
+}
+#endif
+
+#if defined(HASHMAP_GROUP_PORTABLE)
+    #define HASHMAP_GROUP_LSBS UINT64_C(0x0101010101010101)
+    #define HASHMAP_GROUP_MSBS UINT64_C(0x8080808080808080)
+#endif
+
+/**
+ * Returns slots of `group` whose control byte equals fingerprint `h2`. The
+ * portable version may report false positives, which are filtered out by the
+ * subsequent hash and key comparison.
+ */
+static inline _cutil_HashMapBitMask
+_cutil_HashMapGroup_match(_cutil_HashMapGroup group, unsigned char h2)
+{
+#if defined(HASHMAP_GROUP_SSE2)
+    const __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char) h2), group);
+    return (_cutil_HashMapBitMask) (unsigned int) _mm_movemask_epi8(cmp);
+#elif defined(HASHMAP_GROUP_NEON)
+    return _cutil_HashMapGroup_neon_mask(vceqq_u8(group, vdupq_n_u8(h2)));
+#else
+    const uint64_t x = group ^ (HASHMAP_GROUP_LSBS * h2);
+    return (x - HASHMAP_GROUP_LSBS) & ~x & HASHMAP_GROUP_MSBS;
+#endif
+}
+
+static inline _cutil_HashMapBitMask
+_cutil_HashMapGroup_match_empty(_cutil_HashMapGroup group)
+{
+#if defined(HASHMAP_GROUP_SSE2)
+    const __m128i empty = _mm_set1_epi8((char) HASHMAP_CTRL_EMPTY);
+    const __m128i cmp = _mm_cmpeq_epi8(empty, group);
+    return (_cutil_HashMapBitMask) (unsigned int) _mm_movemask_epi8(cmp);
+#elif defined(HASHMAP_GROUP_NEON)
+    const uint8x16_t empty = vdupq_n_u8(HASHMAP_CTRL_EMPTY);
+    return _cutil_HashMapGroup_neon_mask(vceqq_u8(group, empty));
+#else
+    /* EMPTY is the only special value with bit 1 unset */
+    return group & ~(group << 6) & HASHMAP_GROUP_MSBS;
+#endif
+}
+
+static inline _cutil_HashMapBitMask
+_cutil_HashMapGroup_match_empty_or_deleted(_cutil_HashMapGroup group)
+{
+#if defined(HASHMAP_GROUP_SSE2)
+    return (_cutil_HashMapBitMask) (unsigned int) _mm_movemask_epi8(group);
+#elif defined(HASHMAP_GROUP_NEON)
+    const uint8x16_t msb = vdupq_n_u8(0x80);
+    return _cutil_HashMapGroup_neon_mask(vtstq_u8(group, msb));
+#else
+    return group & HASHMAP_GROUP_MSBS;
+#endif
+}
+
+static inline size_t
+_cutil_HashMapBitMask_lowest(_cutil_HashMapBitMask mask)
+{
+    return cutil_bits_ctz_u64(mask) >> HASHMAP_GROUP_SHIFT;
+}
+
+/**
+ * Returns number of slots at the end of the group that are not set in `mask`.
+ * `mask` may not be 0.
+ */
+static inline size_t
+_cutil_HashMapBitMask_leading(_cutil_HashMapBitMask mask)
+{
+    const unsigned int num_bits = HASHMAP_GROUP_WIDTH << HASHMAP_GROUP_SHIFT;
+    const unsigned int num_unused = 64U - num_bits;
+    return (cutil_bits_clz_u64(mask) - num_unused) >> HASHMAP_GROUP_SHIFT;
+}
+
+static inline _cutil_HashMapBitMask
+_cutil_HashMapBitMask_next(_cutil_HashMapBitMask mask)
+{
+    return mask & (mask - 1U);
+}
+
+static inline cutil_Bool
+_cutil_HashMap_ctrl_is_full(unsigned char ctrl)
+{
+    return CUTIL_BOOLIFY((ctrl & 0x80) == 0);
+}
+
+static inline unsigned char
+_cutil_HashMap_h2(cutil_hash_t hash)
+{
+    return (unsigned char) (hash & HASHMAP_H2_MASK);
+}
+
+static inline size_t
+_cutil_HashMap_h1(cutil_hash_t hash)
+{
+    return (size_t) (hash >> HASHMAP_H2_BITS);
+}
+
+/**
+ * Triangular probe sequence over groups. Since the number of group-sized
+ * strides in the table is a power of two, every slot is visited eventually.
+ */
+typedef struct {
+    size_t mask;
+    size_t pos;
+    size_t stride;
+} _cutil_HashMapProbe;
+
+static inline void
+_cutil_HashMapProbe_init(
+  _cutil_HashMapProbe *probe, cutil_hash_t hash, size_t capacity
+)
+{
+    probe->mask = capacity - 1UL;
+    probe->pos = _cutil_HashMap_h1(hash) & probe->mask;
+    probe->stride = 0UL;
+}
+
+static inline void
+_cutil_HashMapProbe_next(_cutil_HashMapProbe *probe)
+{
+    probe->stride += HASHMAP_GROUP_WIDTH;
+    probe->pos = (probe->pos + probe->stride) & probe->mask;
+}
+
+static inline size_t
+_cutil_HashMapProbe_offset(const _cutil_HashMapProbe *probe, size_t i)
+{
+    return (probe->pos + i) & probe->mask;
+}
+
+/**
+ * Open-addressing table. Every slot of `keys` and `vals` holds an initialized
+ * object; only slots whose control byte is full hold an entry.
+ */
 typedef struct {
-    const cutil_GenericType *key_type;
-    const cutil_GenericType *val_type;
     size_t capacity;
+    size_t max_load; /**< entries + tombstones that trigger a rehash */
     size_t num_entries;
     size_t num_tombstones;
     cutil_Array *keys;
     cutil_Array *vals;
     cutil_hash_t *hashes;
-    cutil_BitArray *is_set;
-    cutil_BitArray *tombstones;
+    unsigned char *ctrl; /**< capacity + HASHMAP_GROUP_WIDTH control bytes */
+} _cutil_HashMapTable;
+
+/**
+ * During an incremental resize, entries live in either `table` or `old`. Slots
+ * are addressed by a single index: [0, table.capacity) refers to `table`,
+ * the following old.capacity indices to `old`.
+ *
+ * While `table` has capacity 0, the map is small: up to HASHMAP_SMALL_CAPACITY
+ * entries are stored in `small_slots`, a single block of inline slots, and
+ * found by a linear scan. Indices [0, HASHMAP_SMALL_CAPACITY) then refer to
+ * inline slots, which, like table slots, always hold initialized objects.
+ * Maps with a table hold no inline slots.
+ */
+typedef struct {
+    const cutil_GenericType *key_type;
+    const cutil_GenericType *val_type; /**< NULL for a HashSet, see below */
+    double max_load_factor;
+    _cutil_HashMapTable table; /**< current table */
+    _cutil_HashMapTable old;   /**< table being migrated, capacity 0 if none */
+    size_t migrate_pos;        /**< next slot of `old` to be migrated */
+    size_t migrate_step;       /**< slots migrated per operation, 0 if eager */
+    cutil_Bool migrate_on_lookup;
+    size_t num_iterators; /**< live iterators, which suspend lookup migration */
+    cutil_Bool concurrent_reads; /**< const operations must not write */
+    cutil_hash_t content_hash;     /**< see '_cutil_HashMap_hash' */
+    cutil_Bool content_hash_valid; /**< is `content_hash` maintained? */
+    unsigned char *small_slots;    /**< NULL unless the map is small */
+    size_t small_count;            /**< entries in inline slots */
+    unsigned small_used; /**< bit mask of inline slots holding an entry */
+    cutil_hash_t seed;   /**< see '_cutil_HashMap_hash_key' */
+    size_t num_rehashes; /**< times entries were moved to a new table */
+#ifdef CUTIL_ENABLE_HASHMAP_COUNTERS
+    size_t num_lookups;
+    size_t num_hits;
+    size_t num_misses;
+    size_t num_comparisons;
+#endif
 } _cutil_HashMap;
 
-static void
-_cutil_HashMap_alloc_arrays(_cutil_HashMap *hashmap)
+/**
+ * Returns whether `key` equals the key at `p`, counting the comparison.
+ */
+static inline cutil_Bool
+_cutil_HashMap_key_equals(
+  const _cutil_HashMap *hashmap, const void *key, const void *p
+)
 {
-    hashmap->keys = cutil_Array_alloc(hashmap->key_type, hashmap->capacity);
-    hashmap->vals = cutil_Array_alloc(hashmap->val_type, hashmap->capacity);
-    hashmap->hashes = CUTIL_MALLOC_MULT(hashmap->hashes, hashmap->capacity);
-    hashmap->is_set = cutil_BitArray_alloc(hashmap->capacity);
-    hashmap->tombstones = cutil_BitArray_alloc(hashmap->capacity);
+    HASHMAP_COUNT(hashmap, num_comparisons, 1UL);
+    return cutil_GenericType_apply_compare(hashmap->key_type, key, p) == 0;
 }
 
 static void
-_cutil_HashMap_reinit(_cutil_HashMap *hashmap)
+_cutil_HashMapTable_alloc(
+  const _cutil_HashMap *hashmap, _cutil_HashMapTable *table, size_t capacity
+)
 {
-    hashmap->capacity = HASHMAP_INITIAL_CAPACITY;
-    hashmap->num_entries = 0UL;
-    hashmap->num_tombstones = 0UL;
-
-    _cutil_HashMap_alloc_arrays(hashmap);
+    const size_t num_ctrl = capacity + HASHMAP_GROUP_WIDTH;
+    table->capacity = capacity;
+    table->max_load = (size_t) (capacity * hashmap->max_load_factor);
+    table->num_entries = 0UL;
+    table->num_tombstones = 0UL;
+    table->keys = cutil_Array_alloc(hashmap->key_type, capacity);
+    table->vals = (hashmap->val_type != NULL)
+                  ? cutil_Array_alloc(hashmap->val_type, capacity)
+                  : NULL;
+    table->hashes = CUTIL_MALLOC_MULT(table->hashes, capacity);
+    table->ctrl = CUTIL_MALLOC_MULT(table->ctrl, num_ctrl);
+    memset(table->ctrl, HASHMAP_CTRL_EMPTY, num_ctrl);
 }
 
 static void
-_cutil_HashMap_free_arrays(_cutil_HashMap *hashmap)
+_cutil_HashMapTable_free(_cutil_HashMapTable *table)
 {
-    cutil_Array_free(hashmap->keys);
-    cutil_Array_free(hashmap->vals);
-    free(hashmap->hashes);
-    cutil_BitArray_free(hashmap->is_set);
-    cutil_BitArray_free(hashmap->tombstones);
+    cutil_Array_free(table->keys);
+    cutil_Array_free(table->vals);
+    free(table->hashes);
+    free(table->ctrl);
+    memset(table, 0, sizeof *table);
 }
 
-static size_t
-_cutil_HashMap_locate_key(const _cutil_HashMap *hashmap, const void *key)
+static inline cutil_Bool
+_cutil_HashMapTable_is_full(const _cutil_HashMapTable *table, size_t idx)
 {
-    const cutil_GenericType *const key_type = hashmap->key_type;
+    return _cutil_HashMap_ctrl_is_full(table->ctrl[idx]);
+}
 
-    const size_t hash = cutil_GenericType_apply_hash(key_type, key);
-    const size_t mask = hashmap->capacity - 1;
+/**
+ * Sets control byte at `idx` to `ctrl`. The first HASHMAP_GROUP_WIDTH control
+ * bytes are mirrored behind the end of the table so that groups can be loaded
+ * at any position without wrapping around.
+ */
+static inline void
+_cutil_HashMapTable_set_ctrl(
+  _cutil_HashMapTable *table, size_t idx, unsigned char ctrl
+)
+{
+    table->ctrl[idx] = ctrl;
+    if (idx < HASHMAP_GROUP_WIDTH) {
+        table->ctrl[table->capacity + idx] = ctrl;
+    }
+}
 
-    size_t index = hash & mask;
-    size_t perturb = hash;
-    size_t i = 0;
-    cutil_Bool is_set;
+static size_t
+_cutil_HashMapTable_find(
+  const _cutil_HashMap *hashmap,
+  const _cutil_HashMapTable *table,
+  cutil_hash_t hash,
+  const void *key
+)
+{
+    const unsigned char h2 = _cutil_HashMap_h2(hash);
+
+    _cutil_HashMapProbe probe;
+    _cutil_HashMapProbe_init(&probe, hash, table->capacity);
+    for (;;) {
+        const _cutil_HashMapGroup group
+          = _cutil_HashMapGroup_load(table->ctrl + probe.pos);
+        _cutil_HashMapBitMask match = _cutil_HashMapGroup_match(group, h2);
+        while (match != 0U) {
+            const size_t i = _cutil_HashMapBitMask_lowest(match);
+            const size_t index = _cutil_HashMapProbe_offset(&probe, i);
+            const void *const p = cutil_Array_get_ptr(table->keys, index);
+            if (_cutil_HashMap_key_equals(hashmap, key, p)) {
+                return index;
+            }
+            match = _cutil_HashMapBitMask_next(match);
+        }
+        if (_cutil_HashMapGroup_match_empty(group) != 0U) {
+            return CUTIL_ERROR_INDEX;
+        }
+        _cutil_HashMapProbe_next(&probe);
+    }
+}
 
-    while ((is_set = cutil_BitArray_get(hashmap->is_set, index))
-           || cutil_BitArray_get(hashmap->tombstones, index))
-    {
-        if (is_set) {
-            const void *const p = cutil_Array_get_ptr(hashmap->keys, index);
-            if (cutil_GenericType_apply_compare(key_type, key, p) == 0) {
+/**
+ * Same as '_cutil_HashMapTable_find', but if `key` is not present, also writes
+ * the index of the first empty or deleted slot in the probe sequence of `hash`
+ * to `insert_slot`.
+ */
+static size_t
+_cutil_HashMapTable_find_or_prepare_insert(
+  const _cutil_HashMap *hashmap,
+  const _cutil_HashMapTable *table,
+  cutil_hash_t hash,
+  const void *key,
+  size_t *insert_slot
+)
+{
+    const unsigned char h2 = _cutil_HashMap_h2(hash);
+    size_t slot = CUTIL_ERROR_INDEX;
+
+    _cutil_HashMapProbe probe;
+    _cutil_HashMapProbe_init(&probe, hash, table->capacity);
+    for (;;) {
+        const _cutil_HashMapGroup group
+          = _cutil_HashMapGroup_load(table->ctrl + probe.pos);
+        _cutil_HashMapBitMask match = _cutil_HashMapGroup_match(group, h2);
+        while (match != 0U) {
+            const size_t i = _cutil_HashMapBitMask_lowest(match);
+            const size_t index = _cutil_HashMapProbe_offset(&probe, i);
+            const void *const p = cutil_Array_get_ptr(table->keys, index);
+            if (_cutil_HashMap_key_equals(hashmap, key, p)) {
                 return index;
             }
+            match = _cutil_HashMapBitMask_next(match);
+        }
+        if (slot == CUTIL_ERROR_INDEX) {
+            const _cutil_HashMapBitMask free_mask
+              = _cutil_HashMapGroup_match_empty_or_deleted(group);
+            if (free_mask != 0U) {
+                const size_t i = _cutil_HashMapBitMask_lowest(free_mask);
+                slot = _cutil_HashMapProbe_offset(&probe, i);
+            }
+        }
+        if (_cutil_HashMapGroup_match_empty(group) != 0U) {
+            *insert_slot = slot;
+            return CUTIL_ERROR_INDEX;
         }
-        perturb >>= HASHMAP_PERTURB_SHIFT;
-        i = (i << 2) + i + perturb + 1;
-        index = i & mask;
+        _cutil_HashMapProbe_next(&probe);
     }
+}
 
-    return CUTIL_ERROR_INDEX;
+/**
+ * Same as '_cutil_HashMapTable_find_or_prepare_insert', but only loads groups
+ * that lie within the slots [`begin`, `end`) and returns CUTIL_FALSE as soon
+ * as the probe sequence of `hash` leaves them. Otherwise, writes the index of
+ * `key` or CUTIL_ERROR_INDEX to `idx`.
+ */
+static cutil_Bool
+_cutil_HashMapTable_find_or_prepare_insert_within(
+  const _cutil_HashMapTable *table,
+  const cutil_GenericType *key_type,
+  cutil_hash_t hash,
+  const void *key,
+  size_t begin,
+  size_t end,
+  size_t *idx,
+  size_t *insert_slot
+)
+{
+    const unsigned char h2 = _cutil_HashMap_h2(hash);
+    size_t slot = CUTIL_ERROR_INDEX;
+
+    _cutil_HashMapProbe probe;
+    _cutil_HashMapProbe_init(&probe, hash, table->capacity);
+    for (;;) {
+        if (probe.pos < begin || probe.pos + HASHMAP_GROUP_WIDTH > end) {
+            return CUTIL_FALSE;
+        }
+        const _cutil_HashMapGroup group
+          = _cutil_HashMapGroup_load(table->ctrl + probe.pos);
+        _cutil_HashMapBitMask match = _cutil_HashMapGroup_match(group, h2);
+        while (match != 0U) {
+            const size_t index = _cutil_HashMapProbe_offset(
+              &probe, _cutil_HashMapBitMask_lowest(match)
+            );
+            const void *const p = cutil_Array_get_ptr(table->keys, index);
+            if (cutil_GenericType_apply_compare(key_type, key, p) == 0) {
+                *idx = index;
+                return CUTIL_TRUE;
+            }
+            match = _cutil_HashMapBitMask_next(match);
+        }
+        if (slot == CUTIL_ERROR_INDEX) {
+            const _cutil_HashMapBitMask free_mask
+              = _cutil_HashMapGroup_match_empty_or_deleted(group);
+            if (free_mask != 0U) {
+                const size_t i = _cutil_HashMapBitMask_lowest(free_mask);
+                slot = _cutil_HashMapProbe_offset(&probe, i);
+            }
+        }
+        if (_cutil_HashMapGroup_match_empty(group) != 0U) {
+            *idx = CUTIL_ERROR_INDEX;
+            *insert_slot = slot;
+            return CUTIL_TRUE;
+        }
+        _cutil_HashMapProbe_next(&probe);
+    }
 }
 
-static cutil_Status
-_cutil_HashMap_set_entry_unchecked(
-  _cutil_HashMap *hashmap, size_t hash, const void *key, const void *val
-);
+/**
+ * Returns index of first empty or deleted slot in probe sequence of `hash`.
+ * Requires at least one such slot, which is ensured by the load factor.
+ */
+static size_t
+_cutil_HashMapTable_find_insert_slot(
+  const _cutil_HashMapTable *table, cutil_hash_t hash
+)
+{
+    _cutil_HashMapProbe probe;
+    _cutil_HashMapProbe_init(&probe, hash, table->capacity);
+    for (;;) {
+        const _cutil_HashMapGroup group
+          = _cutil_HashMapGroup_load(table->ctrl + probe.pos);
+        const _cutil_HashMapBitMask mask
+          = _cutil_HashMapGroup_match_empty_or_deleted(group);
+        if (mask != 0U) {
+            const size_t i = _cutil_HashMapBitMask_lowest(mask);
+            return _cutil_HashMapProbe_offset(&probe, i);
+        }
+        _cutil_HashMapProbe_next(&probe);
+    }
+}
 
-static inline unsigned char
-_cutil_HashMap_key_is_set(const _cutil_HashMap *hashmap, size_t idx)
+static void
+_cutil_HashMapTable_insert_at(
+  _cutil_HashMapTable *table,
+  size_t index,
+  cutil_hash_t hash,
+  const void *key,
+  const void *val
+)
 {
-    return cutil_BitArray_get(hashmap->is_set, idx)
-      && !cutil_BitArray_get(hashmap->tombstones, idx);
+    if (table->ctrl[index] == HASHMAP_CTRL_DELETED) {
+        --table->num_tombstones;
+    }
+    ++table->num_entries;
+    cutil_Array_set(table->keys, index, key);
+    if (table->vals != NULL) {
+        cutil_Array_set(table->vals, index, val);
+    }
+    table->hashes[index] = hash;
+    _cutil_HashMapTable_set_ctrl(table, index, _cutil_HashMap_h2(hash));
 }
 
-static cutil_Status
-_cutil_HashMap_expand(_cutil_HashMap *hashmap)
+/**
+ * Returns whether every group-sized window covering slot `index` contains an
+ * empty slot. In that case no probe sequence has ever continued past `index`,
+ * so the slot can be emptied on removal instead of becoming a tombstone.
+ */
+static cutil_Bool
+_cutil_HashMapTable_was_never_full(
+  const _cutil_HashMapTable *table, size_t index
+)
 {
-    const size_t new_capacity = hashmap->capacity * HASHMAP_EXPAND_FACTOR;
-    if (new_capacity < hashmap->capacity || new_capacity >= CUTIL_ERROR_INDEX) {
-        return CUTIL_STATUS_FAILURE;
+    const size_t index_before
+      = (index - HASHMAP_GROUP_WIDTH) & (table->capacity - 1U);
+    const _cutil_HashMapBitMask empty_after = _cutil_HashMapGroup_match_empty(
+      _cutil_HashMapGroup_load(table->ctrl + index)
+    );
+    const _cutil_HashMapBitMask empty_before = _cutil_HashMapGroup_match_empty(
+      _cutil_HashMapGroup_load(table->ctrl + index_before)
+    );
+    if (empty_after == 0U || empty_before == 0U) {
+        return CUTIL_FALSE;
     }
+    const size_t num_full = _cutil_HashMapBitMask_lowest(empty_after)
+                          + _cutil_HashMapBitMask_leading(empty_before);
+    return CUTIL_BOOLIFY(num_full < HASHMAP_GROUP_WIDTH);
+}
 
-    _cutil_HashMap tmp_hashmap = *hashmap;
+static void
+_cutil_HashMapTable_erase_at(_cutil_HashMapTable *table, size_t index)
+{
+    --table->num_entries;
+    if (_cutil_HashMapTable_was_never_full(table, index)) {
+        _cutil_HashMapTable_set_ctrl(table, index, HASHMAP_CTRL_EMPTY);
+        return;
+    }
+    ++table->num_tombstones;
+    _cutil_HashMapTable_set_ctrl(table, index, HASHMAP_CTRL_DELETED);
+}
 
-    hashmap->capacity = new_capacity;
-    _cutil_HashMap_alloc_arrays(hashmap);
+static inline cutil_Bool
+_cutil_HashMapTable_needs_resize(const _cutil_HashMapTable *table)
+{
+    const size_t num_total = table->num_entries + table->num_tombstones;
+    return CUTIL_BOOLIFY(num_total >= table->max_load);
+}
 
-    for (size_t index = 0; index < tmp_hashmap.capacity; ++index) {
-        if (cutil_BitArray_get(tmp_hashmap.is_set, index)) {
-            const size_t hash = tmp_hashmap.hashes[index];
-            const void *const key
-              = cutil_Array_get_ptr(tmp_hashmap.keys, index);
-            const void *const val
-              = cutil_Array_get_ptr(tmp_hashmap.vals, index);
-            _cutil_HashMap_set_entry_unchecked(hashmap, hash, key, val);
+/**
+ * Copies all entries of `src` into `dst`, which must be allocated with the
+ * same capacity. Since hashes are equal, every entry keeps its slot.
+ */
+static void
+_cutil_HashMapTable_copy(
+  _cutil_HashMapTable *dst, const _cutil_HashMapTable *src
+)
+{
+    const size_t capacity = src->capacity;
+    memcpy(dst->ctrl, src->ctrl, capacity + HASHMAP_GROUP_WIDTH);
+    for (size_t i = 0; i < capacity; ++i) {
+        if (!_cutil_HashMapTable_is_full(src, i)) {
+            continue;
+        }
+        cutil_Array_set(dst->keys, i, cutil_Array_get_ptr(src->keys, i));
+        if (src->vals != NULL) {
+            cutil_Array_set(dst->vals, i, cutil_Array_get_ptr(src->vals, i));
         }
+        dst->hashes[i] = src->hashes[i];
     }
+    dst->num_entries = src->num_entries;
+    dst->num_tombstones = src->num_tombstones;
+}
 
-    _cutil_HashMap_free_arrays(&tmp_hashmap);
+static inline size_t
+_cutil_HashMap_align(size_t size)
+{
+    return (size + HASHMAP_SMALL_ALIGNMENT - 1U)
+         & ~(HASHMAP_SMALL_ALIGNMENT - 1U);
+}
 
-    return CUTIL_STATUS_SUCCESS;
+/**
+ * Returns offset of the inline keys from the start of the inline slots.
+ * Inline hashes come first, then keys, then values.
+ */
+static inline size_t
+_cutil_HashMap_get_small_keys_offset(void)
+{
+    return _cutil_HashMap_align(HASHMAP_SMALL_CAPACITY * sizeof(cutil_hash_t));
 }
 
-static cutil_Status
-_cutil_HashMap_set_entry_aux(
-  _cutil_HashMap *hashmap,
-  size_t hash,
-  const void *key,
-  const void *val,
-  cutil_Bool check
+static inline size_t
+_cutil_HashMap_get_small_vals_offset(const cutil_GenericType *key_type)
+{
+    return _cutil_HashMap_get_small_keys_offset()
+         + _cutil_HashMap_align(HASHMAP_SMALL_CAPACITY * key_type->size);
+}
+
+/**
+ * Returns size of the inline slots, which hold no values if `val_type` is
+ * NULL.
+ */
+static inline size_t
+_cutil_HashMap_get_small_size(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
 )
 {
-    const cutil_GenericType *const key_type = hashmap->key_type;
+    const size_t val_size = (val_type != NULL) ? val_type->size : 0UL;
+    return _cutil_HashMap_get_small_vals_offset(key_type)
+         + HASHMAP_SMALL_CAPACITY * val_size;
+}
 
-    hash = cutil_GenericType_apply_hash(key_type, key);
+static inline cutil_Bool
+_cutil_HashMap_is_small(const _cutil_HashMap *hashmap)
+{
+    return CUTIL_BOOLIFY(hashmap->table.capacity == 0UL);
+}
 
-    if (check) {
-        const size_t num_total = hashmap->num_entries + hashmap->num_tombstones;
-        if (num_total >= hashmap->capacity * HASHMAP_RESIZE_CAPACITY) {
-            cutil_log_debug(
-              "HashMap: load factor threshold reached (%zu/%zu), rehashing",
-              num_total, hashmap->capacity
-            );
-            const cutil_Status status = _cutil_HashMap_expand(hashmap);
-            if (status != CUTIL_STATUS_SUCCESS) {
-                return status;
-            }
-        }
-    }
+static inline cutil_hash_t *
+_cutil_HashMap_get_small_hashes(const _cutil_HashMap *hashmap)
+{
+    return (cutil_hash_t *) hashmap->small_slots;
+}
 
-    const size_t mask = hashmap->capacity - 1;
+static inline void *
+_cutil_HashMap_get_small_key_ptr(const _cutil_HashMap *hashmap, size_t idx)
+{
+    return cutil_void_array_get_elem(
+      hashmap->key_type->size,
+      hashmap->small_slots + _cutil_HashMap_get_small_keys_offset(), idx
+    );
+}
 
-    size_t index = hash & mask;
-    size_t perturb = hash;
-    size_t i = 0;
+static inline void *
+_cutil_HashMap_get_small_val_ptr(const _cutil_HashMap *hashmap, size_t idx)
+{
+    if (hashmap->val_type == NULL) {
+        return CUTIL_CONST_CAST(&CUTIL_UNIT_VALUE);
+    }
+    return cutil_void_array_get_elem(
+      hashmap->val_type->size,
+      hashmap->small_slots
+        + _cutil_HashMap_get_small_vals_offset(hashmap->key_type),
+      idx
+    );
+}
 
-    while (cutil_BitArray_get(hashmap->is_set, index)) {
-        if (check && hashmap->hashes[index] == hash) {
-            const void *const p = cutil_Array_get_ptr(hashmap->keys, index);
-            if (cutil_GenericType_apply_compare(key_type, key, p) == 0) {
-                cutil_Array_set(hashmap->vals, index, val);
-                return CUTIL_STATUS_SUCCESS;
-            }
-        }
-        perturb >>= HASHMAP_PERTURB_SHIFT;
-        i = (i << 2) + i + perturb + 1;
-        index = i & mask;
+static void
+_cutil_HashMap_init_small_slot(_cutil_HashMap *hashmap, size_t idx)
+{
+    cutil_GenericType_apply_init(
+      hashmap->key_type, _cutil_HashMap_get_small_key_ptr(hashmap, idx)
+    );
+    if (hashmap->val_type != NULL) {
+        cutil_GenericType_apply_init(
+          hashmap->val_type, _cutil_HashMap_get_small_val_ptr(hashmap, idx)
+        );
     }
+}
 
-    ++hashmap->num_entries;
-    cutil_Array_set(hashmap->keys, index, key);
-    cutil_Array_set(hashmap->vals, index, val);
-    hashmap->hashes[index] = (cutil_hash_t) hash;
-    cutil_BitArray_set(hashmap->is_set, index);
-    if (cutil_BitArray_get(hashmap->tombstones, index)) {
-        --hashmap->num_tombstones;
-        cutil_BitArray_unset(hashmap->tombstones, index);
+static void
+_cutil_HashMap_clear_small_slot(_cutil_HashMap *hashmap, size_t idx)
+{
+    cutil_GenericType_apply_clear(
+      hashmap->key_type, _cutil_HashMap_get_small_key_ptr(hashmap, idx)
+    );
+    if (hashmap->val_type != NULL) {
+        cutil_GenericType_apply_clear(
+          hashmap->val_type, _cutil_HashMap_get_small_val_ptr(hashmap, idx)
+        );
     }
+}
 
-    return CUTIL_STATUS_SUCCESS;
+/**
+ * Releases whatever the inline slot `idx` holds, leaving it initialized, once
+ * its entry has been removed or moved to a table.
+ */
+static inline void
+_cutil_HashMap_vacate_small_slot(_cutil_HashMap *hashmap, size_t idx)
+{
+    _cutil_HashMap_clear_small_slot(hashmap, idx);
+    _cutil_HashMap_init_small_slot(hashmap, idx);
 }
 
-static inline cutil_Status
-_cutil_HashMap_set_entry_unchecked(
-  _cutil_HashMap *hashmap, size_t hash, const void *key, const void *val
-)
+/**
+ * Allocates empty inline slots, which the map holds only while it is small.
+ */
+static void
+_cutil_HashMap_alloc_small(_cutil_HashMap *hashmap)
 {
-    return _cutil_HashMap_set_entry_aux(hashmap, hash, key, val, false);
+    hashmap->small_slots = malloc(
+      _cutil_HashMap_get_small_size(hashmap->key_type, hashmap->val_type)
+    );
+    for (size_t i = 0; i < HASHMAP_SMALL_CAPACITY; ++i) {
+        _cutil_HashMap_init_small_slot(hashmap, i);
+    }
+    hashmap->small_count = 0UL;
+    hashmap->small_used = 0U;
 }
 
-static inline cutil_Status
-_cutil_HashMap_set_entry(
-  _cutil_HashMap *hashmap, const void *key, const void *val
+static void
+_cutil_HashMap_free_small(_cutil_HashMap *hashmap)
+{
+    CUTIL_RETURN_IF_NULL(hashmap->small_slots);
+    for (size_t i = 0; i < HASHMAP_SMALL_CAPACITY; ++i) {
+        _cutil_HashMap_clear_small_slot(hashmap, i);
+    }
+    free(hashmap->small_slots);
+    hashmap->small_slots = NULL;
+    hashmap->small_count = 0UL;
+    hashmap->small_used = 0U;
+}
+
+static size_t
+_cutil_HashMap_find_small(
+  const _cutil_HashMap *hashmap, cutil_hash_t hash, const void *key
 )
 {
-    return _cutil_HashMap_set_entry_aux(hashmap, 0, key, val, true);
+    const cutil_hash_t *const hashes = _cutil_HashMap_get_small_hashes(hashmap);
+    for (unsigned used = hashmap->small_used; used != 0U; used &= used - 1U) {
+        const size_t i = cutil_bits_ctz_u64(used);
+        if (hashes[i] == hash
+            && _cutil_HashMap_key_equals(
+              hashmap, key, _cutil_HashMap_get_small_key_ptr(hashmap, i)
+            )) {
+            return i;
+        }
+    }
+    return CUTIL_ERROR_INDEX;
 }
 
-cutil_Map *
-cutil_HashMap_alloc(
-  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+/**
+ * Inserts [`key`, `val`] into a free inline slot, of which there must be one,
+ * and returns its index.
+ */
+static size_t
+_cutil_HashMap_insert_small(
+  _cutil_HashMap *hashmap, cutil_hash_t hash, const void *key, const void *val
 )
 {
-    if (!cutil_GenericType_is_valid(key_type)) {
-        cutil_log_warn("Key type is not valid");
-        return NULL;
+    const size_t i = cutil_bits_ctz_u64(~hashmap->small_used);
+    _cutil_HashMap_get_small_hashes(hashmap)[i] = hash;
+    cutil_GenericType_apply_copy(
+      hashmap->key_type, _cutil_HashMap_get_small_key_ptr(hashmap, i), key
+    );
+    if (hashmap->val_type != NULL) {
+        cutil_GenericType_apply_copy(
+          hashmap->val_type, _cutil_HashMap_get_small_val_ptr(hashmap, i), val
+        );
     }
-    if (!cutil_GenericType_is_valid(val_type)) {
-        cutil_log_warn("Value type is not valid");
-        return NULL;
+    hashmap->small_used |= 1U << i;
+    ++hashmap->small_count;
+    return i;
+}
+
+/**
+ * Returns a map whose storage has been released to small mode.
+ */
+static void
+_cutil_HashMap_reinit(_cutil_HashMap *hashmap)
+{
+    _cutil_HashMap_alloc_small(hashmap);
+    hashmap->migrate_pos = 0UL;
+}
+
+static void
+_cutil_HashMap_free_arrays(_cutil_HashMap *hashmap)
+{
+    _cutil_HashMapTable_free(&hashmap->table);
+    _cutil_HashMapTable_free(&hashmap->old);
+    _cutil_HashMap_free_small(hashmap);
+}
+
+/* Random key of the process, see '_cutil_HashMap_make_seed' */
+static cutil_hash_t _cutil_HashMap_process_key;
+
+/**
+ * Draws the key of the process from the random source of the operating system.
+ * Without one, it is derived from the address of a static object, which
+ * differs between runs under address space layout randomization, and the
+ * current time.
+ */
+static void
+_cutil_HashMap_init_process_key(void)
+{
+    cutil_hash_t key = CUTIL_HASH_C(0);
+#if defined(_WIN32)
+    unsigned int high;
+    unsigned int low;
+    if (rand_s(&high) == 0 && rand_s(&low) == 0) {
+        key = ((cutil_hash_t) high << 32) | (cutil_hash_t) low;
+    }
+#else
+    FILE *const file = fopen("/dev/urandom", "rb");
+    if (file != NULL) {
+        if (fread(&key, sizeof key, 1UL, file) != 1UL) {
+            key = CUTIL_HASH_C(0);
+        }
+        fclose(file);
+    }
+#endif
+    if (key == CUTIL_HASH_C(0)) {
+        static const char anchor = 0;
+        cutil_log_warn("HashMap: no random source, deriving seeds from time");
+        key = cutil_hash_finalize((cutil_hash_t) (uintptr_t) &anchor);
+        cutil_hash_combine_inplace(&key, (cutil_hash_t) time(NULL));
     }
+    _cutil_HashMap_process_key = key;
+}
 
-    cutil_Map *const map = CUTIL_MALLOC_OBJECT(map);
+#if defined(_WIN32)
+static INIT_ONCE _cutil_HashMap_process_key_once = INIT_ONCE_STATIC_INIT;
 
-    map->vtable = CUTIL_MAP_TYPE_HASHMAP;
-    _cutil_HashMap *const hashmap = map->data = CUTIL_MALLOC_OBJECT(hashmap);
+static BOOL CALLBACK
+_cutil_HashMap_init_process_key_once(
+  PINIT_ONCE once, PVOID param, PVOID *context
+)
+{
+    (void) once;
+    (void) param;
+    (void) context;
+    _cutil_HashMap_init_process_key();
+    return TRUE;
+}
+#else
+static pthread_once_t _cutil_HashMap_process_key_once = PTHREAD_ONCE_INIT;
+#endif
+
+/**
+ * Returns a seed for `hashmap`, derived from the random key of the process,
+ * which is drawn once, and the address of the map, which differs between live
+ * maps, so that key sets colliding in one map are unlikely to collide in
+ * another.
+ */
+static cutil_hash_t
+_cutil_HashMap_make_seed(const _cutil_HashMap *hashmap)
+{
+#if defined(_WIN32)
+    InitOnceExecuteOnce(
+      &_cutil_HashMap_process_key_once, &_cutil_HashMap_init_process_key_once,
+      NULL, NULL
+    );
+#else
+    pthread_once(
+      &_cutil_HashMap_process_key_once, &_cutil_HashMap_init_process_key
+    );
+#endif
+    return cutil_hash_finalize(
+      _cutil_HashMap_process_key ^ (cutil_hash_t) (uintptr_t) hashmap
+    );
+}
 
-    hashmap->key_type = key_type;
-    hashmap->val_type = val_type;
+/**
+ * Returns hash of `key` as used for probing. The seed of the map is mixed into
+ * the hashing of the key, see 'cutil_GenericType_apply_hash_seeded', so that
+ * keys with equal hashes (e.g., strings under a 32-bit hash) only collide
+ * under some seeds, and finalized, so that keys whose hashes share low bits
+ * (e.g., multiples of the capacity under the identity hash for integers) are
+ * spread over the table, differently so in every map.
+ */
+static inline cutil_hash_t
+_cutil_HashMap_hash_key(const _cutil_HashMap *hashmap, const void *key)
+{
+    return cutil_hash_finalize(cutil_GenericType_apply_hash_seeded(
+      hashmap->key_type, key, hashmap->seed
+    ));
+}
 
-    _cutil_HashMap_reinit(hashmap);
+static inline cutil_Bool
+_cutil_HashMap_is_resizing(const _cutil_HashMap *hashmap)
+{
+    return CUTIL_BOOLIFY(hashmap->old.capacity != 0UL);
+}
 
-    return map;
+static inline size_t
+_cutil_HashMap_get_num_slots(const _cutil_HashMap *hashmap)
+{
+    if (_cutil_HashMap_is_small(hashmap)) {
+        return HASHMAP_SMALL_CAPACITY;
+    }
+    return hashmap->table.capacity + hashmap->old.capacity;
 }
 
-static void
-_cutil_HashMap_free(void *data)
+/**
+ * Returns table that contains slot `*idx` and converts `*idx` to an index
+ * into that table.
+ */
+static inline _cutil_HashMapTable *
+_cutil_HashMap_resolve(_cutil_HashMap *hashmap, size_t *idx)
 {
-    _cutil_HashMap *const hashmap = data;
-    CUTIL_RETURN_IF_NULL(hashmap);
+    if (*idx < hashmap->table.capacity) {
+        return &hashmap->table;
+    }
+    *idx -= hashmap->table.capacity;
+    return &hashmap->old;
+}
 
-    _cutil_HashMap_free_arrays(hashmap);
+static inline const _cutil_HashMapTable *
+_cutil_HashMap_resolve_const(const _cutil_HashMap *hashmap, size_t *idx)
+{
+    if (*idx < hashmap->table.capacity) {
+        return &hashmap->table;
+    }
+    *idx -= hashmap->table.capacity;
+    return &hashmap->old;
+}
 
-    free(hashmap);
+static inline cutil_Bool
+_cutil_HashMap_key_is_set(const _cutil_HashMap *hashmap, size_t idx)
+{
+    if (_cutil_HashMap_is_small(hashmap)) {
+        return CUTIL_BOOLIFY((hashmap->small_used >> idx & 1U) != 0U);
+    }
+    const _cutil_HashMapTable *const table
+      = _cutil_HashMap_resolve_const(hashmap, &idx);
+    return _cutil_HashMapTable_is_full(table, idx);
 }
 
-static void
-_cutil_HashMap_reset(void *data)
+static inline const void *
+_cutil_HashMap_get_key_ptr(const _cutil_HashMap *hashmap, size_t idx)
 {
-    _cutil_HashMap *const hashmap = data;
-    _cutil_HashMap_free_arrays(hashmap);
-    _cutil_HashMap_reinit(hashmap);
+    if (_cutil_HashMap_is_small(hashmap)) {
+        return _cutil_HashMap_get_small_key_ptr(hashmap, idx);
+    }
+    const _cutil_HashMapTable *const table
+      = _cutil_HashMap_resolve_const(hashmap, &idx);
+    return cutil_Array_get_ptr(table->keys, idx);
 }
 
-static size_t
-_cutil_HashMap_get_count(const void *data)
+static inline const void *
+_cutil_HashMap_get_val_ptr(const _cutil_HashMap *hashmap, size_t idx)
 {
-    const _cutil_HashMap *const hashmap = data;
-    return hashmap->num_entries;
+    if (_cutil_HashMap_is_small(hashmap) || hashmap->val_type == NULL) {
+        return _cutil_HashMap_get_small_val_ptr(hashmap, idx);
+    }
+    const _cutil_HashMapTable *const table
+      = _cutil_HashMap_resolve_const(hashmap, &idx);
+    return cutil_Array_get_ptr(table->vals, idx);
 }
 
-static cutil_Status
-_cutil_HashMap_remove(void *data, const void *key)
+/**
+ * Returns contribution of the entry in slot `idx` to the content hash, which
+ * matches the per-entry term of 'cutil_Map_hash_generic', or, without values,
+ * that of 'cutil_Set_hash_generic'.
+ */
+static cutil_hash_t
+_cutil_HashMap_hash_entry(const _cutil_HashMap *hashmap, size_t idx)
+{
+    const void *const key = _cutil_HashMap_get_key_ptr(hashmap, idx);
+    const cutil_hash_t hash
+      = cutil_GenericType_apply_hash(hashmap->key_type, key);
+    CUTIL_RETURN_VAL_IF_NULL(hashmap->val_type, hash);
+    const void *const val = _cutil_HashMap_get_val_ptr(hashmap, idx);
+    return hash ^ cutil_GenericType_apply_hash(hashmap->val_type, val);
+}
+
+/**
+ * Adds the entry in slot `idx` to the content hash, or removes it again, if
+ * the content hash is maintained.
+ */
+static inline void
+_cutil_HashMap_toggle_content_hash(_cutil_HashMap *hashmap, size_t idx)
+{
+    CUTIL_RETURN_IF_VAL(hashmap->content_hash_valid, false);
+    hashmap->content_hash ^= _cutil_HashMap_hash_entry(hashmap, idx);
+}
+
+static inline void
+_cutil_HashMap_set_val(_cutil_HashMap *hashmap, size_t idx, const void *val)
+{
+    _cutil_HashMap_toggle_content_hash(hashmap, idx);
+    if (_cutil_HashMap_is_small(hashmap)) {
+        cutil_GenericType_apply_copy(
+          hashmap->val_type, _cutil_HashMap_get_small_val_ptr(hashmap, idx), val
+        );
+    } else {
+        size_t table_idx = idx;
+        _cutil_HashMapTable *const table
+          = _cutil_HashMap_resolve(hashmap, &table_idx);
+        cutil_Array_set(table->vals, table_idx, val);
+    }
+    _cutil_HashMap_toggle_content_hash(hashmap, idx);
+}
+
+static inline void
+_cutil_HashMap_erase_at(_cutil_HashMap *hashmap, size_t idx)
+{
+    _cutil_HashMap_toggle_content_hash(hashmap, idx);
+    if (_cutil_HashMap_is_small(hashmap)) {
+        _cutil_HashMap_vacate_small_slot(hashmap, idx);
+        hashmap->small_used &= ~(1U << idx);
+        --hashmap->small_count;
+        return;
+    }
+    _cutil_HashMapTable *const table = _cutil_HashMap_resolve(hashmap, &idx);
+    _cutil_HashMapTable_erase_at(table, idx);
+}
+
+static size_t
+_cutil_HashMap_find_uncounted(
+  const _cutil_HashMap *hashmap, cutil_hash_t hash, const void *key
+)
+{
+    if (_cutil_HashMap_is_small(hashmap)) {
+        return _cutil_HashMap_find_small(hashmap, hash, key);
+    }
+    const size_t idx
+      = _cutil_HashMapTable_find(hashmap, &hashmap->table, hash, key);
+    if (idx != CUTIL_ERROR_INDEX || !_cutil_HashMap_is_resizing(hashmap)) {
+        return idx;
+    }
+    const size_t old_idx
+      = _cutil_HashMapTable_find(hashmap, &hashmap->old, hash, key);
+    CUTIL_RETURN_VAL_IF_VAL(old_idx, CUTIL_ERROR_INDEX, CUTIL_ERROR_INDEX);
+    return hashmap->table.capacity + old_idx;
+}
+
+static inline size_t
+_cutil_HashMap_find(
+  const _cutil_HashMap *hashmap, cutil_hash_t hash, const void *key
+)
+{
+    const size_t idx = _cutil_HashMap_find_uncounted(hashmap, hash, key);
+    HASHMAP_COUNT(hashmap, num_lookups, 1UL);
+    HASHMAP_COUNT(hashmap, num_hits, idx != CUTIL_ERROR_INDEX);
+    HASHMAP_COUNT(hashmap, num_misses, idx == CUTIL_ERROR_INDEX);
+    return idx;
+}
+
+static size_t
+_cutil_HashMap_locate_key(const _cutil_HashMap *hashmap, const void *key)
+{
+    const cutil_hash_t hash = _cutil_HashMap_hash_key(hashmap, key);
+    return _cutil_HashMap_find(hashmap, hash, key);
+}
+
+/**
+ * Moves up to `num_slots` slots of the old table into the current one and
+ * releases the old table once it has been drained.
+ */
+static void
+_cutil_HashMap_migrate(_cutil_HashMap *hashmap, size_t num_slots)
+{
+    _cutil_HashMapTable *const old = &hashmap->old;
+    _cutil_HashMapTable *const table = &hashmap->table;
+    CUTIL_RETURN_IF_VAL(old->capacity, 0UL);
+
+    const size_t remaining = old->capacity - hashmap->migrate_pos;
+    const size_t end = hashmap->migrate_pos + CUTIL_MIN(num_slots, remaining);
+    for (size_t i = hashmap->migrate_pos; i < end; ++i) {
+        if (!_cutil_HashMapTable_is_full(old, i)) {
+            continue;
+        }
+        const cutil_hash_t hash = old->hashes[i];
+        const void *const key = cutil_Array_get_ptr(old->keys, i);
+        const void *const val
+          = (old->vals != NULL) ? cutil_Array_get_ptr(old->vals, i) : NULL;
+        const size_t index = _cutil_HashMapTable_find_insert_slot(table, hash);
+        _cutil_HashMapTable_insert_at(table, index, hash, key, val);
+        _cutil_HashMapTable_erase_at(old, i);
+    }
+    hashmap->migrate_pos = end;
+
+    if (end == old->capacity || old->num_entries == 0UL) {
+        cutil_log_debug("HashMap: incremental resize finished");
+        _cutil_HashMapTable_free(old);
+        hashmap->migrate_pos = 0UL;
+    }
+}
+
+static inline void
+_cutil_HashMap_migrate_step(_cutil_HashMap *hashmap)
+{
+    if (_cutil_HashMap_is_resizing(hashmap)) {
+        _cutil_HashMap_migrate(hashmap, hashmap->migrate_step);
+    }
+}
+
+/**
+ * Performs a migration step on lookups if requested. Lookups take `hashmap` by
+ * const pointer, which is cast away here; iterators suspend lookup migration
+ * so that mixing iteration and lookups stays valid.
+ */
+static inline void
+_cutil_HashMap_migrate_on_lookup(const _cutil_HashMap *hashmap)
+{
+    if (hashmap->migrate_on_lookup && hashmap->num_iterators == 0UL) {
+        _cutil_HashMap_migrate_step(CUTIL_CONST_CAST(hashmap));
+    }
+}
+
+/**
+ * Rehashes all entries into a new table of `new_capacity` slots, either at
+ * once or incrementally depending on `eager`.
+ */
+static void
+_cutil_HashMap_rehash(
+  _cutil_HashMap *hashmap, size_t new_capacity, cutil_Bool eager
+)
+{
+    const size_t capacity = hashmap->table.capacity;
+
+    /* Only one migration can be pending at a time */
+    _cutil_HashMap_migrate(hashmap, hashmap->old.capacity);
+
+    hashmap->old = hashmap->table;
+    hashmap->migrate_pos = 0UL;
+    _cutil_HashMapTable_alloc(hashmap, &hashmap->table, new_capacity);
+    ++hashmap->num_rehashes;
+
+    if (eager) {
+        _cutil_HashMap_migrate(hashmap, capacity);
+    }
+}
+
+/**
+ * Returns minimal number of slots migrated per operation. An expanded table
+ * reaches its threshold after at least capacity * max_load_factor operations,
+ * so migrating more than 1 / max_load_factor slots per operation always
+ * drains the old table first.
+ */
+static inline size_t
+_cutil_HashMap_get_min_migrate_step(const _cutil_HashMap *hashmap)
+{
+    return (size_t) (1.0 / hashmap->max_load_factor) + 1UL;
+}
+
+/**
+ * Returns share of entries up to which a table reaching its threshold is
+ * rehashed at the same capacity to drop its tombstones. An incremental
+ * migration takes capacity / step operations, which must fit into the room
+ * left below the threshold.
+ */
+static inline double
+_cutil_HashMap_get_drop_tombstones_factor(const _cutil_HashMap *hashmap)
+{
+    if (hashmap->migrate_step == HASHMAP_EAGER_RESIZE) {
+        return hashmap->max_load_factor / 2.0;
+    }
+    return hashmap->max_load_factor - 1.0 / (double) hashmap->migrate_step;
+}
+
+/**
+ * Returns smallest capacity that holds `count` entries without rehashing, or
+ * 0 if no such capacity exists.
+ */
+static size_t
+_cutil_HashMap_get_capacity_for(const _cutil_HashMap *hashmap, size_t count)
+{
+    size_t capacity = HASHMAP_INITIAL_CAPACITY;
+    while (count > (size_t) (capacity * hashmap->max_load_factor)) {
+        const size_t new_capacity = capacity * HASHMAP_EXPAND_FACTOR;
+        if (new_capacity < capacity || new_capacity >= CUTIL_ERROR_INDEX) {
+            return 0UL;
+        }
+        capacity = new_capacity;
+    }
+    return capacity;
+}
+
+/**
+ * Moves the inline entries into a newly allocated table of `capacity` slots
+ * and releases the inline slots.
+ */
+static void
+_cutil_HashMap_leave_small(_cutil_HashMap *hashmap, size_t capacity)
+{
+    cutil_log_debug(
+      "HashMap: moving %zu inline entries to %zu slots", hashmap->small_count,
+      capacity
+    );
+    _cutil_HashMapTable *const table = &hashmap->table;
+    const cutil_hash_t *const hashes = _cutil_HashMap_get_small_hashes(hashmap);
+    _cutil_HashMapTable_alloc(hashmap, table, capacity);
+    ++hashmap->num_rehashes;
+    for (unsigned used = hashmap->small_used; used != 0U; used &= used - 1U) {
+        const size_t i = cutil_bits_ctz_u64(used);
+        const size_t index
+          = _cutil_HashMapTable_find_insert_slot(table, hashes[i]);
+        _cutil_HashMapTable_insert_at(
+          table, index, hashes[i], _cutil_HashMap_get_small_key_ptr(hashmap, i),
+          _cutil_HashMap_get_small_val_ptr(hashmap, i)
+        );
+    }
+    _cutil_HashMap_free_small(hashmap);
+}
+
+/**
+ * Moves all entries, of which there are at most HASHMAP_SMALL_CAPACITY, into
+ * newly allocated inline slots and releases the tables.
+ */
+static void
+_cutil_HashMap_enter_small(_cutil_HashMap *hashmap)
+{
+    _cutil_HashMap_migrate(hashmap, hashmap->old.capacity);
+    _cutil_HashMap_alloc_small(hashmap);
+    const _cutil_HashMapTable *const table = &hashmap->table;
+    cutil_hash_t *const hashes = _cutil_HashMap_get_small_hashes(hashmap);
+    size_t num = 0UL;
+    for (size_t i = 0; i < table->capacity; ++i) {
+        if (!_cutil_HashMapTable_is_full(table, i)) {
+            continue;
+        }
+        hashes[num] = table->hashes[i];
+        cutil_GenericType_apply_copy(
+          hashmap->key_type, _cutil_HashMap_get_small_key_ptr(hashmap, num),
+          cutil_Array_get_ptr(table->keys, i)
+        );
+        if (hashmap->val_type != NULL) {
+            cutil_GenericType_apply_copy(
+              hashmap->val_type, _cutil_HashMap_get_small_val_ptr(hashmap, num),
+              cutil_Array_get_ptr(table->vals, i)
+            );
+        }
+        ++num;
+    }
+    _cutil_HashMapTable_free(&hashmap->table);
+    ++hashmap->num_rehashes;
+    hashmap->small_count = num;
+    hashmap->small_used = (1U << num) - 1U;
+}
+
+/**
+ * Makes room in the current table once the load factor threshold is reached.
+ * If tombstones make up most of the load, the table is rehashed at the same
+ * capacity, otherwise it is expanded.
+ */
+static cutil_Status
+_cutil_HashMap_grow(_cutil_HashMap *hashmap)
+{
+    const _cutil_HashMapTable *const table = &hashmap->table;
+    const size_t capacity = table->capacity;
+    const cutil_Bool eager = hashmap->migrate_step == HASHMAP_EAGER_RESIZE;
+    const double drop_tombstones_factor
+      = _cutil_HashMap_get_drop_tombstones_factor(hashmap);
+    if (table->num_entries <= capacity * drop_tombstones_factor) {
+        cutil_log_debug(
+          "HashMap: dropping %zu tombstones", table->num_tombstones
+        );
+        _cutil_HashMap_rehash(hashmap, capacity, eager);
+        return CUTIL_STATUS_SUCCESS;
+    }
+
+    const size_t new_capacity = capacity * HASHMAP_EXPAND_FACTOR;
+    if (new_capacity < capacity || new_capacity >= CUTIL_ERROR_INDEX) {
+        return CUTIL_STATUS_FAILURE;
+    }
+    _cutil_HashMap_rehash(hashmap, new_capacity, eager);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_HashMap_find_or_insert_uncounted(
+  _cutil_HashMap *hashmap,
+  cutil_hash_t hash,
+  const void *key,
+  const void *val,
+  size_t *idx,
+  cutil_Bool *inserted
+)
+{
+    _cutil_HashMapTable *const table = &hashmap->table;
+    size_t slot = CUTIL_ERROR_INDEX;
+    *inserted = false;
+    if (_cutil_HashMap_is_small(hashmap)) {
+        *idx = _cutil_HashMap_find_small(hashmap, hash, key);
+        if (*idx != CUTIL_ERROR_INDEX) {
+            return CUTIL_STATUS_SUCCESS;
+        }
+        if (hashmap->small_count < HASHMAP_SMALL_CAPACITY) {
+            *idx = _cutil_HashMap_insert_small(hashmap, hash, key, val);
+            _cutil_HashMap_toggle_content_hash(hashmap, *idx);
+            *inserted = true;
+            return CUTIL_STATUS_SUCCESS;
+        }
+        _cutil_HashMap_leave_small(
+          hashmap,
+          _cutil_HashMap_get_capacity_for(hashmap, HASHMAP_SMALL_CAPACITY + 1U)
+        );
+    }
+    *idx = _cutil_HashMapTable_find_or_prepare_insert(
+      hashmap, table, hash, key, &slot
+    );
+    if (*idx != CUTIL_ERROR_INDEX) {
+        return CUTIL_STATUS_SUCCESS;
+    }
+    if (_cutil_HashMap_is_resizing(hashmap)) {
+        const size_t old_idx
+          = _cutil_HashMapTable_find(hashmap, &hashmap->old, hash, key);
+        if (old_idx != CUTIL_ERROR_INDEX) {
+            *idx = table->capacity + old_idx;
+            return CUTIL_STATUS_SUCCESS;
+        }
+    }
+
+    if (_cutil_HashMapTable_needs_resize(table)) {
+        cutil_log_debug(
+          "HashMap: load factor threshold reached (%zu/%zu), rehashing",
+          table->num_entries + table->num_tombstones, table->capacity
+        );
+        const cutil_Status status = _cutil_HashMap_grow(hashmap);
+        if (status != CUTIL_STATUS_SUCCESS) {
+            return status;
+        }
+        slot = _cutil_HashMapTable_find_insert_slot(table, hash);
+    }
+
+    _cutil_HashMapTable_insert_at(table, slot, hash, key, val);
+    _cutil_HashMap_toggle_content_hash(hashmap, slot);
+    *idx = slot;
+    *inserted = true;
+
+    return CUTIL_STATUS_SUCCESS;
+}
+
+/**
+ * Looks up `key` with hash `hash` and writes its slot to `idx`. If `key` is
+ * not present, [`key`, `val`] is inserted in the same pass, reusing the
+ * insertion slot found while probing unless the table has to grow first.
+ */
+static inline cutil_Status
+_cutil_HashMap_find_or_insert(
+  _cutil_HashMap *hashmap,
+  cutil_hash_t hash,
+  const void *key,
+  const void *val,
+  size_t *idx,
+  cutil_Bool *inserted
+)
+{
+    const cutil_Status status = _cutil_HashMap_find_or_insert_uncounted(
+      hashmap, hash, key, val, idx, inserted
+    );
+    HASHMAP_COUNT(hashmap, num_lookups, 1UL);
+    HASHMAP_COUNT(
+      hashmap, num_hits, status == CUTIL_STATUS_SUCCESS && !*inserted
+    );
+    HASHMAP_COUNT(
+      hashmap, num_misses, status != CUTIL_STATUS_SUCCESS || *inserted
+    );
+    return status;
+}
+
+cutil_Map *
+cutil_HashMap_alloc(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+)
+{
+    return cutil_HashMap_alloc_with_capacity(
+      key_type, val_type, 0UL, HASHMAP_DEFAULT_MAX_LOAD_FACTOR
+    );
+}
+
+/**
+ * Allocates the data of a hash map, or of a hash set if `val_type` is NULL, in
+ * which case no values are stored.
+ */
+static _cutil_HashMap *
+_cutil_HashMap_create(
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type,
+  size_t capacity,
+  double max_load_factor
+)
+{
+    if (!(max_load_factor > 0.0
+          && max_load_factor <= HASHMAP_MAX_MAX_LOAD_FACTOR)) {
+        cutil_log_warn("Max load factor %f is not valid", max_load_factor);
+        return NULL;
+    }
+    if (!cutil_GenericType_is_valid(key_type)) {
+        cutil_log_warn("Key type is not valid");
+        return NULL;
+    }
+
+    _cutil_HashMap *const hashmap = CUTIL_MALLOC_OBJECT(hashmap);
+
+    hashmap->key_type = key_type;
+    hashmap->val_type = val_type;
+    hashmap->max_load_factor = max_load_factor;
+    hashmap->migrate_step = HASHMAP_EAGER_RESIZE;
+    hashmap->migrate_on_lookup = false;
+    hashmap->num_iterators = 0UL;
+    hashmap->concurrent_reads = false;
+    hashmap->content_hash = CUTIL_HASH_C(0);
+    hashmap->content_hash_valid = false;
+    hashmap->small_slots = NULL;
+    hashmap->small_count = 0UL;
+    hashmap->small_used = 0U;
+    hashmap->seed = _cutil_HashMap_make_seed(hashmap);
+    hashmap->num_rehashes = 0UL;
+#ifdef CUTIL_ENABLE_HASHMAP_COUNTERS
+    hashmap->num_lookups = 0UL;
+    hashmap->num_hits = 0UL;
+    hashmap->num_misses = 0UL;
+    hashmap->num_comparisons = 0UL;
+#endif
+
+    const size_t initial_capacity
+      = _cutil_HashMap_get_capacity_for(hashmap, capacity);
+    if (initial_capacity == 0UL) {
+        cutil_log_warn("HashMap: capacity %zu is too large", capacity);
+        free(hashmap);
+        return NULL;
+    }
+    memset(&hashmap->table, 0, sizeof hashmap->table);
+    memset(&hashmap->old, 0, sizeof hashmap->old);
+    hashmap->migrate_pos = 0UL;
+    if (capacity > HASHMAP_SMALL_CAPACITY) {
+        _cutil_HashMapTable_alloc(hashmap, &hashmap->table, initial_capacity);
+    } else {
+        _cutil_HashMap_alloc_small(hashmap);
+    }
+
+    return hashmap;
+}
+
+cutil_Map *
+cutil_HashMap_alloc_with_capacity(
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type,
+  size_t capacity,
+  double max_load_factor
+)
+{
+    if (!cutil_GenericType_is_valid(val_type)) {
+        cutil_log_warn("Value type is not valid");
+        return NULL;
+    }
+    _cutil_HashMap *const hashmap
+      = _cutil_HashMap_create(key_type, val_type, capacity, max_load_factor);
+    CUTIL_RETURN_NULL_IF_NULL(hashmap);
+
+    cutil_Map *const map = CUTIL_MALLOC_OBJECT(map);
+    map->vtable = CUTIL_MAP_TYPE_HASHMAP;
+    map->data = hashmap;
+    return map;
+}
+
+static size_t
+_cutil_HashMap_get_capacity(const _cutil_HashMap *hashmap)
+{
+    if (_cutil_HashMap_is_small(hashmap)) {
+        return HASHMAP_SMALL_CAPACITY;
+    }
+    return hashmap->table.capacity;
+}
+
+size_t
+cutil_HashMap_get_capacity(const cutil_Map *map)
+{
+    CUTIL_RETURN_VAL_IF_NULL(map, 0UL);
+    CUTIL_HASHMAP_TYPE_CHECK(map);
+
+    return _cutil_HashMap_get_capacity(map->data);
+}
+
+cutil_Status
+cutil_HashMap_set_incremental_resize(
+  cutil_Map *map, size_t step, cutil_Bool on_lookup
+)
+{
+    CUTIL_NULL_CHECK(map);
+    CUTIL_HASHMAP_TYPE_CHECK(map);
+
+    _cutil_HashMap *const hashmap = map->data;
+    const size_t min_step = _cutil_HashMap_get_min_migrate_step(hashmap);
+    if (step != HASHMAP_EAGER_RESIZE && step < min_step) {
+        step = min_step;
+    }
+    hashmap->migrate_step = step;
+    hashmap->migrate_on_lookup
+      = CUTIL_BOOLIFY(on_lookup && step > 0UL && !hashmap->concurrent_reads);
+    if (step == HASHMAP_EAGER_RESIZE) {
+        _cutil_HashMap_migrate(hashmap, hashmap->old.capacity);
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+cutil_Status
+cutil_HashMap_set_concurrent_reads(cutil_Map *map, cutil_Bool enabled)
+{
+    CUTIL_NULL_CHECK(map);
+    CUTIL_HASHMAP_TYPE_CHECK(map);
+
+    _cutil_HashMap *const hashmap = map->data;
+    if (hashmap->num_iterators != 0UL) {
+        cutil_log_warn("HashMap: concurrent reads changed while iterated");
+        return CUTIL_STATUS_FAILURE;
+    }
+    hashmap->concurrent_reads = CUTIL_BOOLIFY(enabled);
+    if (hashmap->concurrent_reads) {
+        hashmap->migrate_on_lookup = false;
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+cutil_Bool
+cutil_HashMap_is_resizing(const cutil_Map *map)
+{
+    CUTIL_NULL_CHECK(map);
+    CUTIL_HASHMAP_TYPE_CHECK(map);
+
+    const _cutil_HashMap *const hashmap = map->data;
+    return _cutil_HashMap_is_resizing(hashmap);
+}
+
+static size_t
+_cutil_HashMap_get_count(const void *data)
+{
+    const _cutil_HashMap *const hashmap = data;
+    return hashmap->table.num_entries + hashmap->old.num_entries
+         + hashmap->small_count;
+}
+
+/**
+ * Returns number of groups a lookup of the entry in slot `idx` of `table`
+ * loads, i.e., the position of the first group of its probe sequence that
+ * contains `idx`, plus 1.
+ */
+static size_t
+_cutil_HashMapTable_get_probe_length(
+  const _cutil_HashMapTable *table, size_t idx
+)
+{
+    _cutil_HashMapProbe probe;
+    _cutil_HashMapProbe_init(&probe, table->hashes[idx], table->capacity);
+    size_t length = 1UL;
+    while (((idx - probe.pos) & probe.mask) >= HASHMAP_GROUP_WIDTH) {
+        _cutil_HashMapProbe_next(&probe);
+        ++length;
+    }
+    return length;
+}
+
+static void
+_cutil_HashMapTable_add_probe_lengths(
+  const _cutil_HashMapTable *table, cutil_HashMapStats *stats, size_t *total
+)
+{
+    for (size_t i = 0; i < table->capacity; ++i) {
+        if (!_cutil_HashMapTable_is_full(table, i)) {
+            continue;
+        }
+        const size_t length = _cutil_HashMapTable_get_probe_length(table, i);
+        const size_t bucket
+          = CUTIL_MIN(length, CUTIL_HASHMAP_PROBE_HISTOGRAM_SIZE) - 1UL;
+        ++stats->probe_histogram[bucket];
+        stats->max_probe_length = CUTIL_MAX(stats->max_probe_length, length);
+        *total += length;
+    }
+}
+
+static void
+_cutil_HashMap_get_stats(
+  const _cutil_HashMap *hashmap, cutil_HashMapStats *stats
+)
+{
+    memset(stats, 0, sizeof *stats);
+    stats->num_entries = _cutil_HashMap_get_count(hashmap);
+    stats->num_rehashes = hashmap->num_rehashes;
+#ifdef CUTIL_ENABLE_HASHMAP_COUNTERS
+    stats->num_lookups = hashmap->num_lookups;
+    stats->num_hits = hashmap->num_hits;
+    stats->num_misses = hashmap->num_misses;
+    stats->num_comparisons = hashmap->num_comparisons;
+#endif
+
+    if (_cutil_HashMap_is_small(hashmap)) {
+        /* A linear scan is a single probe */
+        stats->capacity = HASHMAP_SMALL_CAPACITY;
+        stats->load_factor
+          = (double) hashmap->small_count / (double) HASHMAP_SMALL_CAPACITY;
+        stats->probe_histogram[0] = hashmap->small_count;
+        stats->max_probe_length = hashmap->small_count != 0UL;
+        stats->avg_probe_length = (double) stats->max_probe_length;
+        return;
+    }
+
+    const _cutil_HashMapTable *const table = &hashmap->table;
+    stats->capacity = table->capacity;
+    stats->num_tombstones = table->num_tombstones + hashmap->old.num_tombstones;
+    stats->load_factor
+      = (double) (table->num_entries + table->num_tombstones)
+      / (double) table->capacity;
+
+    size_t total = 0UL;
+    _cutil_HashMapTable_add_probe_lengths(table, stats, &total);
+    _cutil_HashMapTable_add_probe_lengths(&hashmap->old, stats, &total);
+    if (stats->num_entries != 0UL) {
+        stats->avg_probe_length
+          = (double) total / (double) stats->num_entries;
+    }
+}
+
+cutil_Status
+cutil_HashMap_get_stats(const cutil_Map *map, cutil_HashMapStats *stats)
+{
+    CUTIL_NULL_CHECK(map);
+    CUTIL_NULL_CHECK(stats);
+    CUTIL_HASHMAP_TYPE_CHECK(map);
+
+    _cutil_HashMap_get_stats(map->data, stats);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static void
+_cutil_HashMap_free(void *data)
 {
     _cutil_HashMap *const hashmap = data;
+    CUTIL_RETURN_IF_NULL(hashmap);
+
+    _cutil_HashMap_free_arrays(hashmap);
+
+    free(hashmap);
+}
+
+static void
+_cutil_HashMap_reset(void *data)
+{
+    _cutil_HashMap *const hashmap = data;
+    _cutil_HashMap_free_arrays(hashmap);
+    _cutil_HashMap_reinit(hashmap);
+    hashmap->content_hash = CUTIL_HASH_C(0);
+}
+
+static cutil_Status
+_cutil_HashMap_remove(void *data, const void *key)
+{
+    _cutil_HashMap *const hashmap = data;
+    _cutil_HashMap_migrate_step(hashmap);
     const size_t idx = _cutil_HashMap_locate_key(hashmap, key);
     if (idx == CUTIL_ERROR_INDEX) {
         cutil_log_warn("HashMap remove: key not found");
         return CUTIL_STATUS_FAILURE;
     }
-    --hashmap->num_entries;
-    cutil_BitArray_unset(hashmap->is_set, idx);
-    ++hashmap->num_tombstones;
-    cutil_BitArray_set(hashmap->tombstones, idx);
-    return CUTIL_STATUS_SUCCESS;
+    _cutil_HashMap_erase_at(hashmap, idx);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Bool
+_cutil_HashMap_contains(const void *data, const void *key)
+{
+    const _cutil_HashMap *const hashmap = data;
+    _cutil_HashMap_migrate_on_lookup(hashmap);
+    const size_t idx = _cutil_HashMap_locate_key(hashmap, key);
+    return CUTIL_BOOLIFY(idx != CUTIL_ERROR_INDEX);
+}
+
+static cutil_Status
+_cutil_HashMap_get(const void *data, const void *key, void *val)
+{
+    const _cutil_HashMap *const hashmap = data;
+    _cutil_HashMap_migrate_on_lookup(hashmap);
+    const size_t idx = _cutil_HashMap_locate_key(hashmap, key);
+    if (idx == CUTIL_ERROR_INDEX) {
+        cutil_log_warn("HashMap get: key not found");
+        return CUTIL_STATUS_FAILURE;
+    }
+    const void *const p = _cutil_HashMap_get_val_ptr(hashmap, idx);
+    cutil_GenericType_apply_copy(hashmap->val_type, val, p);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static const void *
+_cutil_HashMap_get_ptr(const void *data, const void *key)
+{
+    const _cutil_HashMap *const hashmap = data;
+    _cutil_HashMap_migrate_on_lookup(hashmap);
+    const size_t idx = _cutil_HashMap_locate_key(hashmap, key);
+    CUTIL_RETURN_VAL_IF_VAL(idx, CUTIL_ERROR_INDEX, NULL);
+    return _cutil_HashMap_get_val_ptr(hashmap, idx);
+}
+
+/**
+ * Prefetches the first group of control bytes and the first key probed for
+ * `hash` in `table`, unless the map is small and has no table.
+ */
+static inline void
+_cutil_HashMapTable_prefetch(
+  const _cutil_HashMapTable *table, cutil_hash_t hash
+)
+{
+    CUTIL_RETURN_IF_VAL(table->capacity, 0UL);
+    const size_t pos = _cutil_HashMap_h1(hash) & (table->capacity - 1UL);
+    CUTIL_PREFETCH(table->ctrl + pos);
+    CUTIL_PREFETCH(cutil_Array_get_ptr(table->keys, pos));
+}
+
+/**
+ * Writes the slots of the `num_keys` keys in `keys`, of which there are at most
+ * HASHMAP_BATCH_SIZE, to `idxs`.
+ */
+static void
+_cutil_HashMap_find_batch(
+  const _cutil_HashMap *hashmap,
+  const void *keys,
+  size_t num_keys,
+  size_t *idxs
+)
+{
+    const size_t key_size = hashmap->key_type->size;
+    cutil_hash_t hashes[HASHMAP_BATCH_SIZE];
+
+    /* Hash all keys first so that their cache misses overlap */
+    for (size_t i = 0; i < num_keys; ++i) {
+        const void *const key
+          = cutil_void_array_get_elem_const(key_size, keys, i);
+        hashes[i] = _cutil_HashMap_hash_key(hashmap, key);
+        _cutil_HashMapTable_prefetch(&hashmap->table, hashes[i]);
+    }
+
+    for (size_t i = 0; i < num_keys; ++i) {
+        const void *const key
+          = cutil_void_array_get_elem_const(key_size, keys, i);
+        idxs[i] = _cutil_HashMap_find(hashmap, hashes[i], key);
+    }
+}
+
+static cutil_Status
+_cutil_HashMap_get_ptr_batch(
+  const void *data, const void *keys, size_t num_keys, const void **vals
+)
+{
+    const _cutil_HashMap *const hashmap = data;
+    const size_t key_size = hashmap->key_type->size;
+    _cutil_HashMap_migrate_on_lookup(hashmap);
+
+    size_t idxs[HASHMAP_BATCH_SIZE];
+    for (size_t start = 0; start < num_keys; start += HASHMAP_BATCH_SIZE) {
+        const size_t num_batch
+          = CUTIL_MIN(HASHMAP_BATCH_SIZE, num_keys - start);
+        const void *const batch
+          = cutil_void_array_get_elem_const(key_size, keys, start);
+        _cutil_HashMap_find_batch(hashmap, batch, num_batch, idxs);
+        for (size_t i = 0; i < num_batch; ++i) {
+            vals[start + i] = (idxs[i] == CUTIL_ERROR_INDEX)
+                              ? NULL
+                              : _cutil_HashMap_get_val_ptr(hashmap, idxs[i]);
+        }
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_HashMap_set(void *data, const void *key, const void *val)
+{
+    _cutil_HashMap *const hashmap = data;
+    _cutil_HashMap_migrate_step(hashmap);
+    const cutil_hash_t hash = _cutil_HashMap_hash_key(hashmap, key);
+    size_t idx;
+    cutil_Bool inserted;
+    const cutil_Status status
+      = _cutil_HashMap_find_or_insert(hashmap, hash, key, val, &idx, &inserted);
+    if (status == CUTIL_STATUS_SUCCESS && !inserted) {
+        _cutil_HashMap_set_val(hashmap, idx, val);
+    }
+    return status;
+}
+
+static void *
+_cutil_HashMap_get_or_insert(
+  void *data, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    _cutil_HashMap *const hashmap = data;
+    _cutil_HashMap_migrate_step(hashmap);
+    const cutil_hash_t hash = _cutil_HashMap_hash_key(hashmap, key);
+    size_t idx;
+    cutil_Bool res;
+    const cutil_Status status
+      = _cutil_HashMap_find_or_insert(hashmap, hash, key, val, &idx, &res);
+    CUTIL_RETURN_VAL_IF_VAL(status, CUTIL_STATUS_FAILURE, NULL);
+    if (inserted != NULL) {
+        *inserted = res;
+    }
+    /* The value may be modified through the returned pointer */
+    hashmap->content_hash_valid = false;
+    return CUTIL_CONST_CAST(_cutil_HashMap_get_val_ptr(hashmap, idx));
+}
+
+static cutil_Status
+_cutil_HashMap_reserve(void *data, size_t count)
+{
+    _cutil_HashMap *const hashmap = data;
+    const size_t capacity = _cutil_HashMap_get_capacity_for(hashmap, count);
+    if (capacity == 0UL) {
+        cutil_log_warn("HashMap reserve: capacity %zu is too large", count);
+        return CUTIL_STATUS_FAILURE;
+    }
+    if (_cutil_HashMap_is_small(hashmap)) {
+        if (count > HASHMAP_SMALL_CAPACITY) {
+            _cutil_HashMap_leave_small(hashmap, capacity);
+        }
+        return CUTIL_STATUS_SUCCESS;
+    }
+    if (capacity > hashmap->table.capacity) {
+        _cutil_HashMap_rehash(hashmap, capacity, true);
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_HashMap_shrink_to_fit(void *data)
+{
+    _cutil_HashMap *const hashmap = data;
+    if (_cutil_HashMap_is_small(hashmap)) {
+        return CUTIL_STATUS_SUCCESS;
+    }
+    const size_t count = _cutil_HashMap_get_count(hashmap);
+    if (count <= HASHMAP_SMALL_CAPACITY) {
+        _cutil_HashMap_enter_small(hashmap);
+        return CUTIL_STATUS_SUCCESS;
+    }
+    const size_t capacity = _cutil_HashMap_get_capacity_for(hashmap, count);
+    if (capacity != hashmap->table.capacity
+        || hashmap->table.num_tombstones != 0UL
+        || _cutil_HashMap_is_resizing(hashmap)) {
+        _cutil_HashMap_rehash(hashmap, capacity, true);
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+/**
+ * Sets the values of the `num` keys in `keys` to those in `vals`, or, without
+ * values, inserts the keys, see 'cutil_HashMap_set_mult'.
+ */
+static cutil_Status
+_cutil_HashMap_set_mult(
+  _cutil_HashMap *hashmap, const void *keys, const void *vals, size_t num
+)
+{
+    const size_t key_size = hashmap->key_type->size;
+    const size_t val_size
+      = (hashmap->val_type != NULL) ? hashmap->val_type->size : 0UL;
+    const size_t count = _cutil_HashMap_get_count(hashmap);
+    if (count + num < count) {
+        cutil_log_warn("HashMap set_mult: %zu entries are too many", num);
+        return CUTIL_STATUS_FAILURE;
+    }
+    const cutil_Status status = _cutil_HashMap_reserve(hashmap, count + num);
+    if (status != CUTIL_STATUS_SUCCESS) {
+        return status;
+    }
+
+    cutil_hash_t hashes[HASHMAP_BATCH_SIZE];
+    for (size_t start = 0; start < num; start += HASHMAP_BATCH_SIZE) {
+        const size_t num_batch = CUTIL_MIN(HASHMAP_BATCH_SIZE, num - start);
+
+        /* Hash all keys first so that their cache misses overlap */
+        for (size_t i = 0; i < num_batch; ++i) {
+            const void *const key
+              = cutil_void_array_get_elem_const(key_size, keys, start + i);
+            hashes[i] = _cutil_HashMap_hash_key(hashmap, key);
+            _cutil_HashMapTable_prefetch(&hashmap->table, hashes[i]);
+        }
+
+        for (size_t i = 0; i < num_batch; ++i) {
+            const void *const key
+              = cutil_void_array_get_elem_const(key_size, keys, start + i);
+            const void *const val
+              = (vals != NULL)
+                ? cutil_void_array_get_elem_const(val_size, vals, start + i)
+                : NULL;
+            size_t idx;
+            cutil_Bool inserted;
+            const cutil_Status insert_status = _cutil_HashMap_find_or_insert(
+              hashmap, hashes[i], key, val, &idx, &inserted
+            );
+            if (insert_status != CUTIL_STATUS_SUCCESS) {
+                return insert_status;
+            }
+            if (!inserted && vals != NULL) {
+                _cutil_HashMap_set_val(hashmap, idx, val);
+            }
+        }
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+cutil_Status
+cutil_HashMap_set_mult(
+  cutil_Map *map, const void *keys, const void *vals, size_t num
+)
+{
+    CUTIL_NULL_CHECK(map);
+    CUTIL_HASHMAP_TYPE_CHECK(map);
+    CUTIL_RETURN_VAL_IF_VAL(num, 0UL, CUTIL_STATUS_SUCCESS);
+    CUTIL_NULL_CHECK(keys);
+    CUTIL_NULL_CHECK(vals);
+
+    return _cutil_HashMap_set_mult(map->data, keys, vals, num);
+}
+
+cutil_Map *
+cutil_HashMap_from_arrays(const cutil_Array *keys, const cutil_Array *vals)
+{
+    CUTIL_RETURN_NULL_IF_NULL(keys);
+    CUTIL_RETURN_NULL_IF_NULL(vals);
+    const size_t num = cutil_Array_get_capacity(keys);
+    if (cutil_Array_get_capacity(vals) != num) {
+        cutil_log_warn(
+          "HashMap from_arrays: got %zu keys but %zu values", num,
+          cutil_Array_get_capacity(vals)
+        );
+        return NULL;
+    }
+
+    cutil_Map *const map = cutil_HashMap_alloc_with_capacity(
+      cutil_Array_get_type(keys), cutil_Array_get_type(vals), num,
+      HASHMAP_DEFAULT_MAX_LOAD_FACTOR
+    );
+    CUTIL_RETURN_NULL_IF_NULL(map);
+    if (cutil_HashMap_set_mult(map, keys->data, vals->data, num)
+        != CUTIL_STATUS_SUCCESS) {
+        cutil_Map_free(map);
+        return NULL;
+    }
+    return map;
+}
+
+/*
+ * Parallel build. Entries are partitioned by the region of the table their
+ * probe sequence starts in, and workers fill disjoint sets of regions. An
+ * entry whose probe sequence leaves its region is deferred and inserted
+ * sequentially afterwards. Since slots are only ever filled, every entry
+ * stays reachable from the start of its probe sequence.
+ */
+typedef struct _cutil_HashMapBuild _cutil_HashMapBuild;
+
+typedef struct {
+    _cutil_HashMapBuild *build;
+    size_t id;
+    size_t num_inserted; /**< entries inserted into the worker's regions */
+} _cutil_HashMapBuildWorker;
+
+struct _cutil_HashMapBuild {
+    _cutil_HashMap *hashmap;
+    const void *keys;
+    const void *vals;
+    size_t num;
+    size_t num_workers;
+    size_t num_regions;
+    unsigned int region_shift; /**< log2 of slots per region */
+    cutil_hash_t *hashes;      /**< hash of every entry */
+    size_t *order;             /**< entries ordered by region */
+    size_t *offsets;    /**< per worker and region, counts, then positions */
+    size_t *region_end; /**< end of every region in `order` */
+    size_t *num_deferred; /**< deferred entries at the start of every region */
+    void (*phase)(_cutil_HashMapBuildWorker *worker);
+};
+
+static inline size_t
+_cutil_HashMapBuild_get_region(
+  const _cutil_HashMapBuild *build, cutil_hash_t hash
+)
+{
+    const size_t mask = build->hashmap->table.capacity - 1UL;
+    return (_cutil_HashMap_h1(hash) & mask) >> build->region_shift;
+}
+
+static inline size_t
+_cutil_HashMapBuild_get_chunk_begin(
+  const _cutil_HashMapBuild *build, size_t id
+)
+{
+    const size_t num_workers = build->num_workers;
+    return build->num / num_workers * id
+         + build->num % num_workers * id / num_workers;
+}
+
+/**
+ * Hashes the worker's chunk of entries and counts them per region.
+ */
+static void
+_cutil_HashMapBuild_hash(_cutil_HashMapBuildWorker *worker)
+{
+    _cutil_HashMapBuild *const build = worker->build;
+    const size_t key_size = build->hashmap->key_type->size;
+    size_t *const counts = build->offsets + worker->id * build->num_regions;
+    const size_t end
+      = _cutil_HashMapBuild_get_chunk_begin(build, worker->id + 1UL);
+    for (size_t i = _cutil_HashMapBuild_get_chunk_begin(build, worker->id);
+         i < end; ++i) {
+        const void *const key
+          = cutil_void_array_get_elem_const(key_size, build->keys, i);
+        build->hashes[i] = _cutil_HashMap_hash_key(build->hashmap, key);
+        ++counts[_cutil_HashMapBuild_get_region(build, build->hashes[i])];
+    }
+}
+
+/**
+ * Writes the worker's chunk of entries to their positions in `order`.
+ */
+static void
+_cutil_HashMapBuild_scatter(_cutil_HashMapBuildWorker *worker)
+{
+    _cutil_HashMapBuild *const build = worker->build;
+    size_t *const pos = build->offsets + worker->id * build->num_regions;
+    const size_t end
+      = _cutil_HashMapBuild_get_chunk_begin(build, worker->id + 1UL);
+    for (size_t i = _cutil_HashMapBuild_get_chunk_begin(build, worker->id);
+         i < end; ++i) {
+        const size_t region
+          = _cutil_HashMapBuild_get_region(build, build->hashes[i]);
+        build->order[pos[region]++] = i;
+    }
+}
+
+/**
+ * Inserts the entries of `region` whose probe sequences stay within it and
+ * moves the others to the start of the region in `order`.
+ */
+static void
+_cutil_HashMapBuild_insert_region(
+  _cutil_HashMapBuildWorker *worker, size_t region
+)
+{
+    _cutil_HashMapBuild *const build = worker->build;
+    _cutil_HashMap *const hashmap = build->hashmap;
+    _cutil_HashMapTable *const table = &hashmap->table;
+    const size_t key_size = hashmap->key_type->size;
+    const size_t val_size = hashmap->val_type->size;
+    const size_t begin_slot = region << build->region_shift;
+    const size_t end_slot = (region + 1UL) << build->region_shift;
+    const size_t begin = (region == 0UL) ? 0UL : build->region_end[region - 1];
+
+    size_t num_deferred = 0UL;
+    for (size_t j = begin; j < build->region_end[region]; ++j) {
+        const size_t i = build->order[j];
+        const cutil_hash_t hash = build->hashes[i];
+        const void *const key
+          = cutil_void_array_get_elem_const(key_size, build->keys, i);
+        const void *const val
+          = cutil_void_array_get_elem_const(val_size, build->vals, i);
+        size_t idx;
+        size_t slot;
+        if (!_cutil_HashMapTable_find_or_prepare_insert_within(
+              table, hashmap->key_type, hash, key, begin_slot, end_slot, &idx,
+              &slot
+            )) {
+            build->order[begin + num_deferred++] = i;
+        } else if (idx != CUTIL_ERROR_INDEX) {
+            cutil_Array_set(table->vals, idx, val);
+        } else {
+            /* Counted per worker, see '_cutil_HashMapTable_insert_at' */
+            cutil_Array_set(table->keys, slot, key);
+            cutil_Array_set(table->vals, slot, val);
+            table->hashes[slot] = hash;
+            _cutil_HashMapTable_set_ctrl(table, slot, _cutil_HashMap_h2(hash));
+            ++worker->num_inserted;
+        }
+    }
+    build->num_deferred[region] = num_deferred;
+}
+
+static void
+_cutil_HashMapBuild_insert(_cutil_HashMapBuildWorker *worker)
+{
+    const _cutil_HashMapBuild *const build = worker->build;
+    for (size_t region = worker->id; region < build->num_regions;
+         region += build->num_workers) {
+        _cutil_HashMapBuild_insert_region(worker, region);
+    }
+}
+
+#if defined(_WIN32)
+typedef HANDLE _cutil_HashMapThread;
+
+static DWORD WINAPI
+_cutil_HashMapThread_main(LPVOID arg)
+{
+    _cutil_HashMapBuildWorker *const worker = arg;
+    worker->build->phase(worker);
+    return 0;
+}
+
+static cutil_Bool
+_cutil_HashMapThread_start(
+  _cutil_HashMapThread *thread, _cutil_HashMapBuildWorker *worker
+)
+{
+    *thread
+      = CreateThread(NULL, 0, &_cutil_HashMapThread_main, worker, 0, NULL);
+    return CUTIL_BOOLIFY(*thread != NULL);
+}
+
+static void
+_cutil_HashMapThread_join(_cutil_HashMapThread *thread)
+{
+    WaitForSingleObject(*thread, INFINITE);
+    CloseHandle(*thread);
+}
+#else
+typedef pthread_t _cutil_HashMapThread;
+
+static void *
+_cutil_HashMapThread_main(void *arg)
+{
+    _cutil_HashMapBuildWorker *const worker = arg;
+    worker->build->phase(worker);
+    return NULL;
+}
+
+static cutil_Bool
+_cutil_HashMapThread_start(
+  _cutil_HashMapThread *thread, _cutil_HashMapBuildWorker *worker
+)
+{
+    const int res
+      = pthread_create(thread, NULL, &_cutil_HashMapThread_main, worker);
+    return CUTIL_BOOLIFY(res == 0);
+}
+
+static void
+_cutil_HashMapThread_join(_cutil_HashMapThread *thread)
+{
+    pthread_join(*thread, NULL);
+}
+#endif
+
+/**
+ * Runs `phase` on all workers, the first one on the calling thread. Workers
+ * whose thread cannot be started run on the calling thread as well.
+ */
+static void
+_cutil_HashMapBuild_run(
+  _cutil_HashMapBuild *build,
+  _cutil_HashMapBuildWorker *workers,
+  _cutil_HashMapThread *threads,
+  void (*phase)(_cutil_HashMapBuildWorker *worker)
+)
+{
+    build->phase = phase;
+    cutil_Bool *const started
+      = CUTIL_CALLOC_MULT(started, build->num_workers);
+    for (size_t i = 1; i < build->num_workers; ++i) {
+        started[i] = _cutil_HashMapThread_start(&threads[i], &workers[i]);
+        if (!started[i]) {
+            cutil_log_warn("HashMap: failed to start build thread %zu", i);
+        }
+    }
+    for (size_t i = 0; i < build->num_workers; ++i) {
+        if (!started[i]) {
+            phase(&workers[i]);
+        }
+    }
+    for (size_t i = 1; i < build->num_workers; ++i) {
+        if (started[i]) {
+            _cutil_HashMapThread_join(&threads[i]);
+        }
+    }
+    free(started);
 }
 
-static cutil_Bool
-_cutil_HashMap_contains(const void *data, const void *key)
+/**
+ * Turns the per-worker region counts in `offsets` into the positions of the
+ * workers' entries in `order`. Within a region, entries keep their order.
+ */
+static void
+_cutil_HashMapBuild_compute_offsets(_cutil_HashMapBuild *build)
 {
-    const _cutil_HashMap *const hashmap = data;
-    const size_t idx = _cutil_HashMap_locate_key(hashmap, key);
-    return CUTIL_BOOLIFY(idx != CUTIL_ERROR_INDEX);
+    size_t pos = 0UL;
+    for (size_t region = 0; region < build->num_regions; ++region) {
+        for (size_t id = 0; id < build->num_workers; ++id) {
+            size_t *const offset
+              = &build->offsets[id * build->num_regions + region];
+            const size_t count = *offset;
+            *offset = pos;
+            pos += count;
+        }
+        build->region_end[region] = pos;
+    }
 }
 
+/**
+ * Inserts the deferred entries of all regions sequentially. The table was
+ * sized for all entries, so it does not grow.
+ */
 static cutil_Status
-_cutil_HashMap_get(const void *data, const void *key, void *val)
+_cutil_HashMapBuild_insert_deferred(_cutil_HashMapBuild *build)
 {
-    const _cutil_HashMap *const hashmap = data;
-    const size_t idx = _cutil_HashMap_locate_key(hashmap, key);
-    if (idx == CUTIL_ERROR_INDEX) {
-        cutil_log_warn("HashMap get: key not found");
-        return CUTIL_STATUS_FAILURE;
+    _cutil_HashMap *const hashmap = build->hashmap;
+    const size_t key_size = hashmap->key_type->size;
+    const size_t val_size = hashmap->val_type->size;
+    for (size_t region = 0; region < build->num_regions; ++region) {
+        const size_t begin
+          = (region == 0UL) ? 0UL : build->region_end[region - 1];
+        for (size_t j = 0; j < build->num_deferred[region]; ++j) {
+            const size_t i = build->order[begin + j];
+            const void *const key
+              = cutil_void_array_get_elem_const(key_size, build->keys, i);
+            const void *const val
+              = cutil_void_array_get_elem_const(val_size, build->vals, i);
+            size_t idx;
+            cutil_Bool inserted;
+            const cutil_Status status = _cutil_HashMap_find_or_insert(
+              hashmap, build->hashes[i], key, val, &idx, &inserted
+            );
+            if (status != CUTIL_STATUS_SUCCESS) {
+                return status;
+            }
+            if (!inserted) {
+                _cutil_HashMap_set_val(hashmap, idx, val);
+            }
+        }
     }
-    cutil_Array_get(hashmap->vals, idx, val);
     return CUTIL_STATUS_SUCCESS;
 }
 
-static const void *
-_cutil_HashMap_get_ptr(const void *data, const void *key)
+static cutil_Status
+_cutil_HashMapBuild_execute(_cutil_HashMapBuild *build)
 {
-    const _cutil_HashMap *const hashmap = data;
-    const size_t idx = _cutil_HashMap_locate_key(hashmap, key);
-    CUTIL_RETURN_VAL_IF_VAL(idx, CUTIL_ERROR_INDEX, NULL);
-    return cutil_Array_get_ptr(hashmap->vals, idx);
+    const size_t num_workers = build->num_workers;
+    const size_t num_regions = build->num_regions;
+    build->hashes = CUTIL_MALLOC_MULT(build->hashes, build->num);
+    build->order = CUTIL_MALLOC_MULT(build->order, build->num);
+    build->offsets
+      = CUTIL_CALLOC_MULT(build->offsets, num_workers * num_regions);
+    build->region_end = CUTIL_MALLOC_MULT(build->region_end, num_regions);
+    build->num_deferred = CUTIL_MALLOC_MULT(build->num_deferred, num_regions);
+    _cutil_HashMapBuildWorker *const workers
+      = CUTIL_MALLOC_MULT(workers, num_workers);
+    _cutil_HashMapThread *const threads
+      = CUTIL_MALLOC_MULT(threads, num_workers);
+    for (size_t id = 0; id < num_workers; ++id) {
+        workers[id].build = build;
+        workers[id].id = id;
+        workers[id].num_inserted = 0UL;
+    }
+
+    _cutil_HashMapBuild_run(
+      build, workers, threads, &_cutil_HashMapBuild_hash
+    );
+    _cutil_HashMapBuild_compute_offsets(build);
+    _cutil_HashMapBuild_run(
+      build, workers, threads, &_cutil_HashMapBuild_scatter
+    );
+    _cutil_HashMapBuild_run(
+      build, workers, threads, &_cutil_HashMapBuild_insert
+    );
+    for (size_t id = 0; id < num_workers; ++id) {
+        build->hashmap->table.num_entries += workers[id].num_inserted;
+    }
+    const cutil_Status status = _cutil_HashMapBuild_insert_deferred(build);
+
+    free(threads);
+    free(workers);
+    free(build->num_deferred);
+    free(build->region_end);
+    free(build->offsets);
+    free(build->order);
+    free(build->hashes);
+    return status;
 }
 
-static cutil_Status
-_cutil_HashMap_set(void *data, const void *key, const void *val)
+cutil_Map *
+cutil_HashMap_from_arrays_parallel(
+  const cutil_Array *keys, const cutil_Array *vals, size_t num_threads
+)
 {
-    _cutil_HashMap *const hashmap = data;
-    const size_t idx = _cutil_HashMap_locate_key(hashmap, key);
-    if (idx == CUTIL_ERROR_INDEX) {
-        return _cutil_HashMap_set_entry(hashmap, key, val);
+    CUTIL_RETURN_NULL_IF_NULL(keys);
+    CUTIL_RETURN_NULL_IF_NULL(vals);
+    const size_t num = cutil_Array_get_capacity(keys);
+    if (cutil_Array_get_capacity(vals) != num) {
+        cutil_log_warn(
+          "HashMap from_arrays_parallel: got %zu keys but %zu values", num,
+          cutil_Array_get_capacity(vals)
+        );
+        return NULL;
     }
-    cutil_Array_set(hashmap->vals, idx, val);
-    return CUTIL_STATUS_SUCCESS;
+
+    cutil_Map *const map = cutil_HashMap_alloc_with_capacity(
+      cutil_Array_get_type(keys), cutil_Array_get_type(vals), num,
+      HASHMAP_DEFAULT_MAX_LOAD_FACTOR
+    );
+    CUTIL_RETURN_NULL_IF_NULL(map);
+    _cutil_HashMap *const hashmap = map->data;
+    const size_t capacity = hashmap->table.capacity;
+
+    /* Regions must be large enough for most probe sequences to stay within */
+    size_t num_regions = 1UL;
+    while (num_regions < num_threads * HASHMAP_BUILD_REGIONS_PER_WORKER
+           && capacity / (num_regions * 2UL)
+                >= HASHMAP_BUILD_MIN_REGION_GROUPS * HASHMAP_GROUP_WIDTH) {
+        num_regions *= 2UL;
+    }
+
+    cutil_Status status;
+    if (num_threads <= 1UL || num_regions <= 1UL) {
+        status = cutil_HashMap_set_mult(map, keys->data, vals->data, num);
+    } else {
+        _cutil_HashMapBuild build = {
+          .hashmap = hashmap,
+          .keys = keys->data,
+          .vals = vals->data,
+          .num = num,
+          .num_workers = CUTIL_MIN(num_threads, num_regions),
+          .num_regions = num_regions,
+          .region_shift = cutil_bits_ctz_u64(capacity / num_regions),
+        };
+        status = _cutil_HashMapBuild_execute(&build);
+    }
+    if (status != CUTIL_STATUS_SUCCESS) {
+        cutil_Map_free(map);
+        return NULL;
+    }
+    return map;
 }
 
 static void
@@ -321,16 +2397,54 @@ _cutil_HashMap_copy(void *dst, const void *src)
 {
     _cutil_HashMap *const dst_hashmap = dst;
     const _cutil_HashMap *const src_hashmap = src;
-
-    _cutil_HashMap_reset(dst_hashmap);
-
-    for (size_t i = 0; i < src_hashmap->capacity; ++i) {
-        if (!_cutil_HashMap_key_is_set(src_hashmap, i)) {
-            continue;
+    CUTIL_RETURN_IF_VAL(dst_hashmap, src_hashmap);
+
+    _cutil_HashMap_free_arrays(dst_hashmap);
+    /* Stored hashes are only valid under the seed they were computed with */
+    dst_hashmap->seed = src_hashmap->seed;
+    dst_hashmap->content_hash = src_hashmap->content_hash;
+    dst_hashmap->content_hash_valid = src_hashmap->content_hash_valid;
+    if (_cutil_HashMap_is_small(src_hashmap)) {
+        _cutil_HashMap_alloc_small(dst_hashmap);
+        const cutil_hash_t *const src_hashes
+          = _cutil_HashMap_get_small_hashes(src_hashmap);
+        cutil_hash_t *const dst_hashes
+          = _cutil_HashMap_get_small_hashes(dst_hashmap);
+        for (unsigned used = src_hashmap->small_used; used != 0U;
+             used &= used - 1U) {
+            const size_t i = cutil_bits_ctz_u64(used);
+            dst_hashes[i] = src_hashes[i];
+            cutil_GenericType_apply_copy(
+              dst_hashmap->key_type,
+              _cutil_HashMap_get_small_key_ptr(dst_hashmap, i),
+              _cutil_HashMap_get_small_key_ptr(src_hashmap, i)
+            );
+            if (dst_hashmap->val_type != NULL) {
+                cutil_GenericType_apply_copy(
+                  dst_hashmap->val_type,
+                  _cutil_HashMap_get_small_val_ptr(dst_hashmap, i),
+                  _cutil_HashMap_get_small_val_ptr(src_hashmap, i)
+                );
+            }
         }
-        const void *const key = cutil_Array_get_ptr(src_hashmap->keys, i);
-        const void *const val = cutil_Array_get_ptr(src_hashmap->vals, i);
-        _cutil_HashMap_set_entry(dst_hashmap, key, val);
+        dst_hashmap->small_count = src_hashmap->small_count;
+        dst_hashmap->small_used = src_hashmap->small_used;
+        return;
+    }
+
+    _cutil_HashMapTable_alloc(
+      dst_hashmap, &dst_hashmap->table, src_hashmap->table.capacity
+    );
+    _cutil_HashMapTable_copy(&dst_hashmap->table, &src_hashmap->table);
+    if (_cutil_HashMap_is_resizing(src_hashmap)) {
+        _cutil_HashMapTable_alloc(
+          dst_hashmap, &dst_hashmap->old, src_hashmap->old.capacity
+        );
+        _cutil_HashMapTable_copy(&dst_hashmap->old, &src_hashmap->old);
+    }
+    dst_hashmap->migrate_pos = src_hashmap->migrate_pos;
+    if (dst_hashmap->migrate_step == HASHMAP_EAGER_RESIZE) {
+        _cutil_HashMap_migrate(dst_hashmap, dst_hashmap->old.capacity);
     }
 }
 
@@ -339,15 +2453,16 @@ _cutil_HashMap_duplicate(const void *data)
 {
     const _cutil_HashMap *const src = data;
 
-    cutil_Map *const new_map
-      = cutil_HashMap_alloc(src->key_type, src->val_type);
-    CUTIL_RETURN_NULL_IF_NULL(new_map);
-
-    _cutil_HashMap *const dst_raw = new_map->data;
-    _cutil_HashMap_copy(dst_raw, src);
+    _cutil_HashMap *const dst = _cutil_HashMap_create(
+      src->key_type, src->val_type, 0UL, src->max_load_factor
+    );
+    CUTIL_RETURN_NULL_IF_NULL(dst);
 
-    free(new_map);
-    return dst_raw;
+    dst->migrate_step = src->migrate_step;
+    dst->migrate_on_lookup = src->migrate_on_lookup;
+    dst->concurrent_reads = src->concurrent_reads;
+    _cutil_HashMap_copy(dst, src);
+    return dst;
 }
 
 static const cutil_GenericType *
@@ -364,14 +2479,59 @@ _cutil_HashMap_get_val_type(const void *data)
     return hashmap->val_type;
 }
 
+/**
+ * Returns the content hash, computing it on first use. From then on, it is
+ * maintained in O(1) by every modification until 'cutil_Map_get_or_insert'
+ * hands out a mutable value pointer. Like migration on lookups, this writes
+ * to `hashmap` through a const pointer.
+ */
+static cutil_hash_t
+_cutil_HashMap_hash(const void *data)
+{
+    const _cutil_HashMap *const hashmap = data;
+    if (!hashmap->content_hash_valid) {
+        _cutil_HashMap *const mut_hashmap = CUTIL_CONST_CAST(hashmap);
+        const size_t num_slots = _cutil_HashMap_get_num_slots(hashmap);
+        cutil_hash_t hash = CUTIL_HASH_C(0);
+        for (size_t i = 0; i < num_slots; ++i) {
+            if (_cutil_HashMap_key_is_set(hashmap, i)) {
+                hash ^= _cutil_HashMap_hash_entry(hashmap, i);
+            }
+        }
+        mut_hashmap->content_hash = hash;
+        mut_hashmap->content_hash_valid = true;
+    }
+    return hashmap->content_hash;
+}
+
 typedef struct {
     const _cutil_HashMap *hashmap;
     size_t idx;
+    cutil_Bool tracked; /**< counted in `num_iterators` of `hashmap`? */
 } _cutil_HashMapConstIter;
 
+/**
+ * Counts `iter` as a live iterator of its map, unless the map is read
+ * concurrently, in which case lookups never migrate and the count is unused.
+ */
+static void
+_cutil_HashMapConstIter_track(void *data)
+{
+    _cutil_HashMapConstIter *const iter = data;
+    iter->tracked = !iter->hashmap->concurrent_reads;
+    if (iter->tracked) {
+        ++((_cutil_HashMap *) CUTIL_CONST_CAST(iter->hashmap))->num_iterators;
+    }
+}
+
 static void
 _cutil_HashMapConstIter_free(void *data)
 {
+    _cutil_HashMapConstIter *const iter = data;
+    if (iter->tracked) {
+        _cutil_HashMap *const hashmap = CUTIL_CONST_CAST(iter->hashmap);
+        --hashmap->num_iterators;
+    }
     free(data);
 }
 
@@ -380,18 +2540,19 @@ _cutil_HashMapConstIter_next(void *data)
 {
     _cutil_HashMapConstIter *const iter = data;
     const _cutil_HashMap *const hashmap = iter->hashmap;
-    if (iter->idx != ITER_REWOUND_SENTINEL && iter->idx >= hashmap->capacity) {
+    const size_t num_slots = _cutil_HashMap_get_num_slots(hashmap);
+    if (iter->idx != ITER_REWOUND_SENTINEL && iter->idx >= num_slots) {
         return CUTIL_FALSE;
     }
     size_t i = iter->idx + 1; /* (size_t)-1 + 1 == 0 on first call */
-    while (i < hashmap->capacity) {
+    while (i < num_slots) {
         if (_cutil_HashMap_key_is_set(hashmap, i)) {
             iter->idx = i;
             return CUTIL_TRUE;
         }
         ++i;
     }
-    iter->idx = hashmap->capacity;
+    iter->idx = num_slots;
     return CUTIL_FALSE;
 }
 
@@ -400,10 +2561,10 @@ _cutil_HashMapConstIter_get_ptr(const void *data)
 {
     const _cutil_HashMapConstIter *const iter = data;
     const _cutil_HashMap *const hashmap = iter->hashmap;
-    if (iter->idx >= hashmap->capacity) {
+    if (iter->idx >= _cutil_HashMap_get_num_slots(hashmap)) {
         return NULL;
     }
-    return cutil_Array_get_ptr(hashmap->keys, iter->idx);
+    return _cutil_HashMap_get_key_ptr(hashmap, iter->idx);
 }
 
 static cutil_Status
@@ -411,10 +2572,11 @@ _cutil_HashMapConstIter_get(const void *data, void *out)
 {
     const _cutil_HashMapConstIter *const iter = data;
     const _cutil_HashMap *const hashmap = iter->hashmap;
-    if (iter->idx >= hashmap->capacity) {
+    if (iter->idx >= _cutil_HashMap_get_num_slots(hashmap)) {
         return CUTIL_STATUS_FAILURE;
     }
-    cutil_Array_get(hashmap->keys, iter->idx, out);
+    const void *const p = _cutil_HashMap_get_key_ptr(hashmap, iter->idx);
+    cutil_GenericType_apply_copy(hashmap->key_type, out, p);
     return CUTIL_STATUS_SUCCESS;
 }
 
@@ -448,6 +2610,7 @@ _cutil_HashMap_get_const_iterator(const void *data)
     const _cutil_HashMap *const hashmap = data;
     it_data->hashmap = hashmap;
     _cutil_HashMapConstIter_rewind(it_data);
+    _cutil_HashMapConstIter_track(it_data);
 
     cutil_ConstIterator *const it = CUTIL_MALLOC_OBJECT(it);
     it->vtable = CUTIL_CONST_ITERATOR_TYPE_HASHMAP;
@@ -460,6 +2623,7 @@ _cutil_HashMap_get_const_iterator(const void *data)
 typedef struct {
     _cutil_HashMap *hashmap;
     size_t idx;
+    cutil_Bool tracked;
 } _cutil_HashMapIter;
 
 static cutil_Status
@@ -467,11 +2631,13 @@ _cutil_HashMapIter_remove(void *data)
 {
     _cutil_HashMapIter *const iter = data;
     _cutil_HashMap *const hashmap = iter->hashmap;
-    if (iter->idx >= hashmap->capacity) {
+    if (iter->idx >= _cutil_HashMap_get_num_slots(hashmap)) {
+        return CUTIL_STATUS_FAILURE;
+    }
+    if (!_cutil_HashMap_key_is_set(hashmap, iter->idx)) {
         return CUTIL_STATUS_FAILURE;
     }
-    const void *const key = cutil_Array_get_ptr(hashmap->keys, iter->idx);
-    _cutil_HashMap_remove(hashmap, key);
+    _cutil_HashMap_erase_at(hashmap, iter->idx);
     return CUTIL_STATUS_SUCCESS;
 }
 
@@ -499,6 +2665,7 @@ _cutil_HashMap_get_iterator(void *data)
     _cutil_HashMap *const hashmap = data;
     it_data->hashmap = hashmap;
     _cutil_HashMapConstIter_rewind(it_data);
+    _cutil_HashMapConstIter_track(it_data);
 
     cutil_Iterator *const it = CUTIL_MALLOC_OBJECT(it);
     it->vtable = CUTIL_ITERATOR_TYPE_HASHMAP;
@@ -519,12 +2686,663 @@ static const cutil_MapType CUTIL_MAP_TYPE_HASHMAP_OBJECT = {
   .contains = &_cutil_HashMap_contains,
   .get = &_cutil_HashMap_get,
   .get_ptr = &_cutil_HashMap_get_ptr,
+  .get_ptr_batch = &_cutil_HashMap_get_ptr_batch,
   .set = &_cutil_HashMap_set,
+  .get_or_insert = &_cutil_HashMap_get_or_insert,
+  .reserve = &_cutil_HashMap_reserve,
+  .shrink_to_fit = &_cutil_HashMap_shrink_to_fit,
   .get_key_type = &_cutil_HashMap_get_key_type,
   .get_val_type = &_cutil_HashMap_get_val_type,
   .get_const_iterator = &_cutil_HashMap_get_const_iterator,
   .get_iterator = &_cutil_HashMap_get_iterator,
+  .hash = &_cutil_HashMap_hash,
 };
 
 const cutil_MapType *const CUTIL_MAP_TYPE_HASHMAP
   = &CUTIL_MAP_TYPE_HASHMAP_OBJECT;
+
+/*
+ * HashSet. A set is the table of a HashMap without values: its data is a
+ * _cutil_HashMap whose `val_type` is NULL, so that only keys are stored, and
+ * its vtable calls into the table directly rather than through a cutil_Map.
+ */
+
+cutil_Set *
+cutil_HashSet_alloc(const cutil_GenericType *elem_type)
+{
+    return cutil_HashSet_alloc_with_capacity(
+      elem_type, 0UL, HASHMAP_DEFAULT_MAX_LOAD_FACTOR
+    );
+}
+
+cutil_Set *
+cutil_HashSet_alloc_with_capacity(
+  const cutil_GenericType *elem_type, size_t capacity, double max_load_factor
+)
+{
+    _cutil_HashMap *const hashmap
+      = _cutil_HashMap_create(elem_type, NULL, capacity, max_load_factor);
+    CUTIL_RETURN_NULL_IF_NULL(hashmap);
+
+    cutil_Set *const set = CUTIL_MALLOC_OBJECT(set);
+    set->vtable = CUTIL_SET_TYPE_HASHSET;
+    set->data = hashmap;
+    return set;
+}
+
+size_t
+cutil_HashSet_get_capacity(const cutil_Set *set)
+{
+    CUTIL_RETURN_VAL_IF_NULL(set, 0UL);
+    return _cutil_HashMap_get_capacity(set->data);
+}
+
+cutil_Status
+cutil_HashSet_get_stats(const cutil_Set *set, cutil_HashMapStats *stats)
+{
+    CUTIL_NULL_CHECK(set);
+    CUTIL_NULL_CHECK(stats);
+    _cutil_HashMap_get_stats(set->data, stats);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+cutil_Status
+cutil_HashSet_add_mult(cutil_Set *set, const void *elems, size_t num)
+{
+    CUTIL_NULL_CHECK(set);
+    CUTIL_RETURN_VAL_IF_VAL(num, 0UL, CUTIL_STATUS_SUCCESS);
+    CUTIL_NULL_CHECK(elems);
+    return _cutil_HashMap_set_mult(set->data, elems, NULL, num);
+}
+
+cutil_Set *
+cutil_HashSet_from_list(const cutil_List *list)
+{
+    CUTIL_RETURN_NULL_IF_NULL(list);
+    cutil_Set *const set = cutil_HashSet_alloc(cutil_List_get_elem_type(list));
+    CUTIL_RETURN_NULL_IF_NULL(set);
+
+    const size_t count = cutil_List_get_count(list);
+    cutil_Status status = CUTIL_STATUS_SUCCESS;
+    if (cutil_List_get_vtable(list) == CUTIL_LIST_TYPE_ARRAYLIST) {
+        /* Elements of an ArrayList are stored contiguously */
+        status = cutil_HashSet_add_mult(
+          set, (count != 0UL) ? cutil_List_get_ptr(list, 0UL) : NULL, count
+        );
+    } else {
+        status = _cutil_HashMap_reserve(set->data, count);
+        for (size_t i = 0; i < count && status == CUTIL_STATUS_SUCCESS; ++i) {
+            status = cutil_Set_insert_if_absent(
+              set, cutil_List_get_ptr(list, i), NULL
+            );
+        }
+    }
+    if (status != CUTIL_STATUS_SUCCESS) {
+        cutil_Set_free(set);
+        return NULL;
+    }
+    return set;
+}
+
+static cutil_Status
+_cutil_HashSet_contains_batch(
+  const void *data, const void *elems, size_t num_elems, cutil_Bool *res
+)
+{
+    const _cutil_HashMap *const hashmap = data;
+    const size_t elem_size = hashmap->key_type->size;
+    _cutil_HashMap_migrate_on_lookup(hashmap);
+
+    size_t idxs[HASHMAP_BATCH_SIZE];
+    for (size_t start = 0; start < num_elems; start += HASHMAP_BATCH_SIZE) {
+        const size_t num_batch
+          = CUTIL_MIN(HASHMAP_BATCH_SIZE, num_elems - start);
+        const void *const batch
+          = cutil_void_array_get_elem_const(elem_size, elems, start);
+        _cutil_HashMap_find_batch(hashmap, batch, num_batch, idxs);
+        for (size_t i = 0; i < num_batch; ++i) {
+            res[start + i] = CUTIL_BOOLIFY(idxs[i] != CUTIL_ERROR_INDEX);
+        }
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_HashSet_insert_if_absent(
+  void *data, const void *elem, cutil_Bool *inserted
+)
+{
+    _cutil_HashMap *const hashmap = data;
+    _cutil_HashMap_migrate_step(hashmap);
+    const cutil_hash_t hash = _cutil_HashMap_hash_key(hashmap, elem);
+    size_t idx;
+    cutil_Bool res;
+    const cutil_Status status
+      = _cutil_HashMap_find_or_insert(hashmap, hash, elem, NULL, &idx, &res);
+    if (status == CUTIL_STATUS_SUCCESS && inserted != NULL) {
+        *inserted = res;
+    }
+    return status;
+}
+
+static cutil_Status
+_cutil_HashSet_add(void *data, const void *elem)
+{
+    cutil_Bool inserted = false;
+    const cutil_Status status
+      = _cutil_HashSet_insert_if_absent(data, elem, &inserted);
+    if (status == CUTIL_STATUS_SUCCESS && !inserted) {
+        cutil_log_warn("HashSet add: element already in set, skipping");
+    }
+    return status;
+}
+
+/**
+ * Set algebra. Operands of the same element type hash their elements under
+ * different seeds. Unless the type mixes the seed into hashing itself, the
+ * hash stored for an element of one operand is carried over to another by
+ * undoing the finalization and the seed of the first and applying those of
+ * the second, without hashing the element again.
+ */
+
+/**
+ * Inverse of 'cutil_hash_finalize': the xor-shifts by 33 bits undo themselves,
+ * and the multiplications are undone by the inverses of their factors modulo
+ * 2^64.
+ */
+static inline cutil_hash_t
+_cutil_HashSet_unfinalize(cutil_hash_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= CUTIL_HASH_C(0x9cb4b2f8129337db);
+    hash ^= hash >> 33;
+    hash *= CUTIL_HASH_C(0x4f74430c22a54005);
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * Returns hash stored for the entry in slot `idx` of `from`, converted to the
+ * hash of the same element in `to`, or recomputed if the element type mixes
+ * the seed into hashing itself.
+ */
+static inline cutil_hash_t
+_cutil_HashSet_get_hash(
+  const _cutil_HashMap *from, size_t idx, const _cutil_HashMap *to
+)
+{
+    if (from->seed != to->seed
+        && cutil_GenericType_has_seeded_hash(from->key_type)) {
+        const void *const elem = _cutil_HashMap_get_key_ptr(from, idx);
+        return _cutil_HashMap_hash_key(to, elem);
+    }
+    cutil_hash_t hash;
+    if (_cutil_HashMap_is_small(from)) {
+        hash = _cutil_HashMap_get_small_hashes(from)[idx];
+    } else {
+        const _cutil_HashMapTable *const table
+          = _cutil_HashMap_resolve_const(from, &idx);
+        hash = table->hashes[idx];
+    }
+    if (from->seed == to->seed) {
+        return hash;
+    }
+    return cutil_hash_finalize(
+      _cutil_HashSet_unfinalize(hash) ^ from->seed ^ to->seed
+    );
+}
+
+/**
+ * Entries of one set gathered to be probed for in another one.
+ */
+typedef struct {
+    size_t num;
+    size_t idxs[HASHMAP_BATCH_SIZE];         /**< slots in the walked set */
+    cutil_hash_t hashes[HASHMAP_BATCH_SIZE]; /**< hashes in the probed set */
+} _cutil_HashSetBatch;
+
+/**
+ * Gathers up to HASHMAP_BATCH_SIZE entries of `walked` from slot `*pos` on and
+ * prefetches where they are probed for in `probed`, so that the cache misses
+ * of a batch overlap. Advances `*pos` and returns the number of entries.
+ */
+static size_t
+_cutil_HashSet_gather(
+  const _cutil_HashMap *walked,
+  const _cutil_HashMap *probed,
+  size_t *pos,
+  _cutil_HashSetBatch *batch
+)
+{
+    const size_t num_slots = _cutil_HashMap_get_num_slots(walked);
+    batch->num = 0UL;
+    for (; *pos < num_slots && batch->num < HASHMAP_BATCH_SIZE; ++*pos) {
+        if (!_cutil_HashMap_key_is_set(walked, *pos)) {
+            continue;
+        }
+        const cutil_hash_t hash = _cutil_HashSet_get_hash(walked, *pos, probed);
+        _cutil_HashMapTable_prefetch(&probed->table, hash);
+        batch->idxs[batch->num] = *pos;
+        batch->hashes[batch->num] = hash;
+        ++batch->num;
+    }
+    return batch->num;
+}
+
+/**
+ * Removes the entries of `hashset` whose membership in `other` differs from
+ * `keep_contained`.
+ */
+static void
+_cutil_HashSet_retain(
+  _cutil_HashMap *hashset,
+  const _cutil_HashMap *other,
+  cutil_Bool keep_contained
+)
+{
+    _cutil_HashSetBatch batch;
+    size_t pos = 0UL;
+    while (_cutil_HashSet_gather(hashset, other, &pos, &batch) != 0UL) {
+        for (size_t i = 0; i < batch.num; ++i) {
+            const void *const key
+              = _cutil_HashMap_get_key_ptr(hashset, batch.idxs[i]);
+            const cutil_Bool contained = CUTIL_BOOLIFY(
+              _cutil_HashMap_find(other, batch.hashes[i], key)
+              != CUTIL_ERROR_INDEX
+            );
+            if (contained != keep_contained) {
+                _cutil_HashMap_erase_at(hashset, batch.idxs[i]);
+            }
+        }
+    }
+}
+
+/**
+ * Removes the entries of `other` from `hashset`.
+ */
+static void
+_cutil_HashSet_erase_all(_cutil_HashMap *hashset, const _cutil_HashMap *other)
+{
+    _cutil_HashSetBatch batch;
+    size_t pos = 0UL;
+    while (_cutil_HashSet_gather(other, hashset, &pos, &batch) != 0UL) {
+        for (size_t i = 0; i < batch.num; ++i) {
+            const void *const key
+              = _cutil_HashMap_get_key_ptr(other, batch.idxs[i]);
+            const size_t idx
+              = _cutil_HashMap_find(hashset, batch.hashes[i], key);
+            if (idx != CUTIL_ERROR_INDEX) {
+                _cutil_HashMap_erase_at(hashset, idx);
+            }
+        }
+    }
+}
+
+/**
+ * Adds the entries of `other` to `hashset`. If `toggle` is set, entries that
+ * were already contained are removed instead.
+ */
+static cutil_Status
+_cutil_HashSet_insert_all(
+  _cutil_HashMap *hashset, const _cutil_HashMap *other, cutil_Bool toggle
+)
+{
+    _cutil_HashSetBatch batch;
+    size_t pos = 0UL;
+    while (_cutil_HashSet_gather(other, hashset, &pos, &batch) != 0UL) {
+        for (size_t i = 0; i < batch.num; ++i) {
+            const void *const key
+              = _cutil_HashMap_get_key_ptr(other, batch.idxs[i]);
+            size_t idx;
+            cutil_Bool inserted;
+            const cutil_Status status = _cutil_HashMap_find_or_insert(
+              hashset, batch.hashes[i], key, NULL, &idx, &inserted
+            );
+            if (status != CUTIL_STATUS_SUCCESS) {
+                return status;
+            }
+            if (toggle && !inserted) {
+                _cutil_HashMap_erase_at(hashset, idx);
+            }
+        }
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+/**
+ * Adds the entries of `walked` whose membership in `probed` equals
+ * `keep_contained` to `hashset`.
+ */
+static cutil_Status
+_cutil_HashSet_insert_matching(
+  _cutil_HashMap *hashset,
+  const _cutil_HashMap *walked,
+  const _cutil_HashMap *probed,
+  cutil_Bool keep_contained
+)
+{
+    _cutil_HashSetBatch batch;
+    size_t pos = 0UL;
+    while (_cutil_HashSet_gather(walked, probed, &pos, &batch) != 0UL) {
+        for (size_t i = 0; i < batch.num; ++i) {
+            const void *const key
+              = _cutil_HashMap_get_key_ptr(walked, batch.idxs[i]);
+            const cutil_Bool contained = CUTIL_BOOLIFY(
+              _cutil_HashMap_find(probed, batch.hashes[i], key)
+              != CUTIL_ERROR_INDEX
+            );
+            if (contained != keep_contained) {
+                continue;
+            }
+            const cutil_hash_t hash
+              = (hashset->seed == probed->seed)
+                ? batch.hashes[i]
+                : _cutil_HashSet_get_hash(walked, batch.idxs[i], hashset);
+            size_t idx;
+            cutil_Bool inserted;
+            const cutil_Status status = _cutil_HashMap_find_or_insert(
+              hashset, hash, key, NULL, &idx, &inserted
+            );
+            if (status != CUTIL_STATUS_SUCCESS) {
+                return status;
+            }
+        }
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+/**
+ * Allocates an empty set with the settings of `like`, sized for `capacity`
+ * elements, whose seed is that of `seed_from` so that entries copied from it
+ * keep their stored hashes.
+ */
+static _cutil_HashMap *
+_cutil_HashSet_create_result(
+  const _cutil_HashMap *like, const _cutil_HashMap *seed_from, size_t capacity
+)
+{
+    _cutil_HashMap *const hashset = _cutil_HashMap_create(
+      like->key_type, NULL, capacity, like->max_load_factor
+    );
+    CUTIL_RETURN_NULL_IF_NULL(hashset);
+    hashset->migrate_step = like->migrate_step;
+    hashset->migrate_on_lookup = like->migrate_on_lookup;
+    hashset->concurrent_reads = like->concurrent_reads;
+    hashset->seed = seed_from->seed;
+    return hashset;
+}
+
+/**
+ * Replaces the entries of `hashset` by those of `res`, which must share its
+ * seed, and frees `res` along with the previous entries.
+ */
+static void
+_cutil_HashSet_take_entries(_cutil_HashMap *hashset, _cutil_HashMap *res)
+{
+    const _cutil_HashMapTable table = hashset->table;
+    const _cutil_HashMapTable old = hashset->old;
+    unsigned char *const small_slots = hashset->small_slots;
+    hashset->table = res->table;
+    hashset->old = res->old;
+    hashset->migrate_pos = res->migrate_pos;
+    hashset->small_slots = res->small_slots;
+    hashset->small_count = res->small_count;
+    hashset->small_used = res->small_used;
+    ++hashset->num_rehashes;
+    res->table = table;
+    res->old = old;
+    res->small_slots = small_slots;
+    _cutil_HashMap_free(res);
+
+    if (hashset->content_hash_valid) {
+        hashset->content_hash_valid = false;
+        (void) _cutil_HashMap_hash(hashset);
+    }
+}
+
+/**
+ * Intersects `hashset` with the smaller `other` by walking `other` and
+ * probing `hashset`, collecting the common entries in a new table.
+ */
+static cutil_Status
+_cutil_HashSet_intersect_smaller(
+  _cutil_HashMap *hashset, const _cutil_HashMap *other
+)
+{
+    _cutil_HashMap *const res = _cutil_HashSet_create_result(
+      hashset, hashset, _cutil_HashMap_get_count(other)
+    );
+    if (res == NULL) {
+        return CUTIL_STATUS_FAILURE;
+    }
+    const cutil_Status status
+      = _cutil_HashSet_insert_matching(res, other, hashset, true);
+    if (status != CUTIL_STATUS_SUCCESS) {
+        _cutil_HashMap_free(res);
+        return status;
+    }
+    _cutil_HashSet_take_entries(hashset, res);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_HashSet_combine(void *dst, const void *src, cutil_SetOp op)
+{
+    _cutil_HashMap *const hashset = dst;
+    const _cutil_HashMap *const other = src;
+    const size_t count = _cutil_HashMap_get_count(hashset);
+    const size_t other_count = _cutil_HashMap_get_count(other);
+
+    if (op == CUTIL_SET_OP_INTERSECTION) {
+        /* Walk the smaller operand, probing the larger one */
+        if (count > other_count) {
+            return _cutil_HashSet_intersect_smaller(hashset, other);
+        }
+        _cutil_HashSet_retain(hashset, other, true);
+        return CUTIL_STATUS_SUCCESS;
+    }
+    if (op == CUTIL_SET_OP_DIFFERENCE) {
+        /* Walk the smaller operand, probing the larger one */
+        if (count <= other_count) {
+            _cutil_HashSet_retain(hashset, other, false);
+        } else {
+            _cutil_HashSet_erase_all(hashset, other);
+        }
+        return CUTIL_STATUS_SUCCESS;
+    }
+
+    const cutil_Status status
+      = _cutil_HashMap_reserve(hashset, count + other_count);
+    if (status != CUTIL_STATUS_SUCCESS) {
+        return status;
+    }
+    return _cutil_HashSet_insert_all(
+      hashset, other, CUTIL_BOOLIFY(op == CUTIL_SET_OP_SYMDIFF)
+    );
+}
+
+static void *
+_cutil_HashSet_combine_new(const void *lhs, const void *rhs, cutil_SetOp op)
+{
+    const _cutil_HashMap *const lhs_set = lhs;
+    const _cutil_HashMap *const rhs_set = rhs;
+    const size_t lhs_count = _cutil_HashMap_get_count(lhs_set);
+    const size_t rhs_count = _cutil_HashMap_get_count(rhs_set);
+    const cutil_Bool lhs_is_smaller = CUTIL_BOOLIFY(lhs_count <= rhs_count);
+    const _cutil_HashMap *const smaller = lhs_is_smaller ? lhs_set : rhs_set;
+    const _cutil_HashMap *const larger = lhs_is_smaller ? rhs_set : lhs_set;
+
+    _cutil_HashMap *res = NULL;
+    cutil_Status status = CUTIL_STATUS_SUCCESS;
+    if (op == CUTIL_SET_OP_INTERSECTION) {
+        res = _cutil_HashSet_create_result(
+          lhs_set, smaller, CUTIL_MIN(lhs_count, rhs_count)
+        );
+        CUTIL_RETURN_NULL_IF_NULL(res);
+        status = _cutil_HashSet_insert_matching(res, smaller, larger, true);
+    } else if (op == CUTIL_SET_OP_DIFFERENCE && lhs_is_smaller) {
+        res = _cutil_HashSet_create_result(lhs_set, lhs_set, lhs_count);
+        CUTIL_RETURN_NULL_IF_NULL(res);
+        status = _cutil_HashSet_insert_matching(res, lhs_set, rhs_set, false);
+    } else if (op == CUTIL_SET_OP_DIFFERENCE) {
+        res = _cutil_HashMap_duplicate(lhs_set);
+        CUTIL_RETURN_NULL_IF_NULL(res);
+        _cutil_HashSet_erase_all(res, rhs_set);
+    } else {
+        /* Take over the larger operand, then walk the smaller one */
+        res = _cutil_HashSet_create_result(
+          lhs_set, larger, lhs_count + rhs_count
+        );
+        CUTIL_RETURN_NULL_IF_NULL(res);
+        status = _cutil_HashSet_insert_all(res, larger, false);
+        if (status == CUTIL_STATUS_SUCCESS) {
+            status = _cutil_HashSet_insert_all(
+              res, smaller, CUTIL_BOOLIFY(op == CUTIL_SET_OP_SYMDIFF)
+            );
+        }
+    }
+
+    if (status != CUTIL_STATUS_SUCCESS) {
+        _cutil_HashMap_free(res);
+        return NULL;
+    }
+    return res;
+}
+
+static const cutil_SetType CUTIL_SET_TYPE_HASHSET_OBJECT = {
+  .name = "cutil_HashSet",
+  .free = &_cutil_HashMap_free,
+  .reset = &_cutil_HashMap_reset,
+  .copy = &_cutil_HashMap_copy,
+  .duplicate = &_cutil_HashMap_duplicate,
+  .get_count = &_cutil_HashMap_get_count,
+  .contains = &_cutil_HashMap_contains,
+  .contains_batch = &_cutil_HashSet_contains_batch,
+  .add = &_cutil_HashSet_add,
+  .insert_if_absent = &_cutil_HashSet_insert_if_absent,
+  .remove = &_cutil_HashMap_remove,
+  .reserve = &_cutil_HashMap_reserve,
+  .shrink_to_fit = &_cutil_HashMap_shrink_to_fit,
+  .get_elem_type = &_cutil_HashMap_get_key_type,
+  .get_const_iterator = &_cutil_HashMap_get_const_iterator,
+  .get_iterator = &_cutil_HashMap_get_iterator,
+  .hash = &_cutil_HashMap_hash,
+  .combine = &_cutil_HashSet_combine,
+  .combine_new = &_cutil_HashSet_combine_new,
+};
+
+const cutil_SetType *const CUTIL_SET_TYPE_HASHSET
+  = &CUTIL_SET_TYPE_HASHSET_OBJECT;
+
+#define CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(                    \
+  TYPE, ID_UPPER, ID_LOWER                                                     \
+)                                                                              \
+    static void _cutil_HashSet_init_##ID_LOWER(void *obj)                      \
+    {                                                                          \
+        cutil_Set *const set = obj;                                            \
+        set->vtable = CUTIL_SET_TYPE_HASHSET;                                  \
+        set->data = _cutil_HashMap_create(                                     \
+          CUTIL_GENERIC_TYPE_##ID_UPPER, NULL, 0UL,                            \
+          HASHMAP_DEFAULT_MAX_LOAD_FACTOR                                      \
+        );                                                                     \
+    }                                                                          \
+                                                                               \
+    static const cutil_GenericType                                             \
+      CUTIL_GENERIC_TYPE_HASHSET_##ID_UPPER##_INSTANCE = {                     \
+        .name = "cutil_HashSet<" #ID_LOWER ">",                                \
+        .size = sizeof(cutil_Set),                                             \
+        .init = &_cutil_HashSet_init_##ID_LOWER,                               \
+        .clear = &cutil_Set_clear_generic,                                     \
+        .copy = &cutil_Set_copy_generic,                                       \
+        .deep_equals = &cutil_Set_deep_equals_generic,                         \
+        .comp = &cutil_Set_compare_generic,                                    \
+        .hash = &cutil_Set_hash_generic,                                       \
+        .to_string = &cutil_Set_to_string_generic                              \
+    }
+
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(char, CHAR, char);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(short, SHORT, short);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(int, INT, int);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(long, LONG, long);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(long long, LLONG, llong);
+
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(unsigned char, UCHAR, uchar);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(
+  unsigned short, USHORT, ushort
+);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(unsigned int, UINT, uint);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(unsigned long, ULONG, ulong);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(
+  unsigned long long, ULLONG, ullong
+);
+
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(int8_t, I8, i8);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(int16_t, I16, i16);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(int32_t, I32, i32);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(int64_t, I64, i64);
+
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(uint8_t, U8, u8);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(uint16_t, U16, u16);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(uint32_t, U32, u32);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(uint64_t, U64, u64);
+
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(size_t, SIZET, size_t);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(cutil_hash_t, HASHT, hash_t);
+
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(float, FLOAT, float);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(double, DOUBLE, double);
+CUTIL_TEMPLATE_DEFINE_GENERIC_NATIVE_TYPE_INSTANCE(
+  long double, LDOUBLE, ldouble
+);
+
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_CHAR
+  = &CUTIL_GENERIC_TYPE_HASHSET_CHAR_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_SHORT
+  = &CUTIL_GENERIC_TYPE_HASHSET_SHORT_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_INT
+  = &CUTIL_GENERIC_TYPE_HASHSET_INT_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_LONG
+  = &CUTIL_GENERIC_TYPE_HASHSET_LONG_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_LLONG
+  = &CUTIL_GENERIC_TYPE_HASHSET_LLONG_INSTANCE;
+
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_UCHAR
+  = &CUTIL_GENERIC_TYPE_HASHSET_UCHAR_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_USHORT
+  = &CUTIL_GENERIC_TYPE_HASHSET_USHORT_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_UINT
+  = &CUTIL_GENERIC_TYPE_HASHSET_UINT_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_ULONG
+  = &CUTIL_GENERIC_TYPE_HASHSET_ULONG_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_ULLONG
+  = &CUTIL_GENERIC_TYPE_HASHSET_ULLONG_INSTANCE;
+
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_I8
+  = &CUTIL_GENERIC_TYPE_HASHSET_I8_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_I16
+  = &CUTIL_GENERIC_TYPE_HASHSET_I16_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_I32
+  = &CUTIL_GENERIC_TYPE_HASHSET_I32_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_I64
+  = &CUTIL_GENERIC_TYPE_HASHSET_I64_INSTANCE;
+
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_U8
+  = &CUTIL_GENERIC_TYPE_HASHSET_U8_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_U16
+  = &CUTIL_GENERIC_TYPE_HASHSET_U16_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_U32
+  = &CUTIL_GENERIC_TYPE_HASHSET_U32_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_U64
+  = &CUTIL_GENERIC_TYPE_HASHSET_U64_INSTANCE;
+
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_SIZET
+  = &CUTIL_GENERIC_TYPE_HASHSET_SIZET_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_HASHT
+  = &CUTIL_GENERIC_TYPE_HASHSET_HASHT_INSTANCE;
+
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_FLOAT
+  = &CUTIL_GENERIC_TYPE_HASHSET_FLOAT_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_DOUBLE
+  = &CUTIL_GENERIC_TYPE_HASHSET_DOUBLE_INSTANCE;
+const cutil_GenericType *const CUTIL_GENERIC_TYPE_HASHSET_LDOUBLE
+  = &CUTIL_GENERIC_TYPE_HASHSET_LDOUBLE_INSTANCE;
@@ -0,0 +1,731 @@
+/* ftruncate and posix_madvise require POSIX.1-2001 */
+#undef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 200112L
+
+#include <cutil/data/generic/map/mapped_hashmap.h>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cutil/io/log.h>
+#include <cutil/std/stdio.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/util/hash.h>
+#include <cutil/util/macro.h>
+
+#define MAPPED_HASHMAP_MAGIC "CUTILHM"
+#define MAPPED_HASHMAP_VERSION UINT32_C(1)
+#define MAPPED_HASHMAP_BYTE_ORDER UINT32_C(0x01020304)
+#define MAPPED_HASHMAP_TYPE_NAME_SIZE ((size_t) 64)
+/* Offsets of the arrays in the file are multiples of a cache line */
+#define MAPPED_HASHMAP_ALIGN ((size_t) 64)
+#define MAPPED_HASHMAP_MIN_CAPACITY ((size_t) 8)
+/* Marks an empty slot in `hashes`; hashes of keys are never 0 */
+#define MAPPED_HASHMAP_EMPTY_HASH ((cutil_hash_t) 0)
+#define MAPPED_HASHMAP_BATCH_SIZE ((size_t) 16)
+
+/**
+ * File header. All members have fixed width, and the byte order is checked
+ * on opening, so files can be shared between hosts of the same architecture.
+ */
+typedef struct {
+    char magic[8];        /**< MAPPED_HASHMAP_MAGIC */
+    uint32_t version;     /**< MAPPED_HASHMAP_VERSION */
+    uint32_t byte_order;  /**< MAPPED_HASHMAP_BYTE_ORDER as written */
+    uint64_t key_size;    /**< size of each key in bytes */
+    uint64_t val_size;    /**< size of each value in bytes */
+    char key_type_name[MAPPED_HASHMAP_TYPE_NAME_SIZE];
+    char val_type_name[MAPPED_HASHMAP_TYPE_NAME_SIZE];
+    uint64_t count;       /**< number of entries */
+    uint64_t capacity;    /**< number of slots, a power of two */
+    uint64_t hashes_offset;
+    uint64_t keys_offset;
+    uint64_t vals_offset;
+    uint64_t file_size;
+} _cutil_MappedHashMapHeader;
+
+typedef struct {
+    const cutil_GenericType *key_type;
+    const cutil_GenericType *val_type;
+    int fd;       /**< descriptor of the mapped file, -1 if none */
+    void *addr;   /**< start of the mapping, NULL if none */
+    size_t length;
+    size_t count;
+    size_t mask;  /**< capacity - 1 */
+    const cutil_hash_t *hashes;
+    const unsigned char *keys;
+    const unsigned char *vals;
+} _cutil_MappedHashMap;
+
+static inline size_t
+_cutil_MappedHashMap_align(size_t offset)
+{
+    return (offset + MAPPED_HASHMAP_ALIGN - 1U) & ~(MAPPED_HASHMAP_ALIGN - 1U);
+}
+
+/**
+ * Returns hash of `key` as stored in the file, which is never
+ * MAPPED_HASHMAP_EMPTY_HASH.
+ */
+static inline cutil_hash_t
+_cutil_MappedHashMap_hash_key(
+  const cutil_GenericType *key_type, const void *key
+)
+{
+    const cutil_hash_t hash
+      = cutil_hash_finalize(cutil_GenericType_apply_hash(key_type, key));
+    return (hash == MAPPED_HASHMAP_EMPTY_HASH) ? CUTIL_HASH_C(1) : hash;
+}
+
+static inline const void *
+_cutil_MappedHashMap_get_key_ptr(const _cutil_MappedHashMap *mhm, size_t idx)
+{
+    return mhm->keys + idx * mhm->key_type->size;
+}
+
+static inline const void *
+_cutil_MappedHashMap_get_val_ptr(const _cutil_MappedHashMap *mhm, size_t idx)
+{
+    return mhm->vals + idx * mhm->val_type->size;
+}
+
+static size_t
+_cutil_MappedHashMap_find(
+  const _cutil_MappedHashMap *mhm, cutil_hash_t hash, const void *key
+)
+{
+    if (mhm->count == 0U) {
+        return CUTIL_ERROR_INDEX;
+    }
+    size_t idx = hash & mhm->mask;
+    for (size_t num_probed = 0; num_probed <= mhm->mask; ++num_probed) {
+        const cutil_hash_t slot_hash = mhm->hashes[idx];
+        if (slot_hash == MAPPED_HASHMAP_EMPTY_HASH) {
+            break;
+        }
+        if (slot_hash == hash
+            && cutil_GenericType_apply_compare(
+                 mhm->key_type, _cutil_MappedHashMap_get_key_ptr(mhm, idx), key
+               ) == 0) {
+            return idx;
+        }
+        idx = (idx + 1U) & mhm->mask;
+    }
+    return CUTIL_ERROR_INDEX;
+}
+
+/**
+ * Returns whether `name` of a type stored in a header matches `type`.
+ */
+static cutil_Bool
+_cutil_MappedHashMap_type_matches(
+  const char *name, uint64_t size, const cutil_GenericType *type
+)
+{
+    return CUTIL_BOOLIFY(
+      size == type->size
+      && strncmp(name, type->name, MAPPED_HASHMAP_TYPE_NAME_SIZE - 1U) == 0
+    );
+}
+
+/**
+ * Checks that the header at the start of the `length` bytes at `addr`
+ * describes a table of `mhm`'s types that lies within the mapping.
+ */
+static cutil_Status
+_cutil_MappedHashMap_check_header(
+  const _cutil_MappedHashMap *mhm, const void *addr, size_t length
+)
+{
+    if (length < sizeof(_cutil_MappedHashMapHeader)) {
+        cutil_log_warn("MappedHashMap: file too small for header");
+        return CUTIL_STATUS_FAILURE;
+    }
+    const _cutil_MappedHashMapHeader *const header = addr;
+    if (memcmp(header->magic, MAPPED_HASHMAP_MAGIC, sizeof header->magic) != 0
+        || header->version != MAPPED_HASHMAP_VERSION
+        || header->byte_order != MAPPED_HASHMAP_BYTE_ORDER) {
+        cutil_log_warn("MappedHashMap: unsupported file format");
+        return CUTIL_STATUS_FAILURE;
+    }
+    if (!_cutil_MappedHashMap_type_matches(
+          header->key_type_name, header->key_size, mhm->key_type
+        )
+        || !_cutil_MappedHashMap_type_matches(
+          header->val_type_name, header->val_size, mhm->val_type
+        )) {
+        cutil_log_warn(
+          "MappedHashMap: file holds '%.63s' -> '%.63s', expected '%s' -> '%s'",
+          header->key_type_name, header->val_type_name, mhm->key_type->name,
+          mhm->val_type->name
+        );
+        return CUTIL_STATUS_FAILURE;
+    }
+
+    const uint64_t capacity = header->capacity;
+    if (header->file_size != length || capacity == 0U
+        || (capacity & (capacity - 1U)) != 0U || header->count >= capacity
+        || capacity > length / sizeof(cutil_hash_t)) {
+        cutil_log_warn("MappedHashMap: corrupt table layout");
+        return CUTIL_STATUS_FAILURE;
+    }
+    const uint64_t offsets[] = {
+      header->hashes_offset, header->keys_offset, header->vals_offset
+    };
+    const uint64_t sizes[] = {
+      capacity * sizeof(cutil_hash_t), capacity * header->key_size,
+      capacity * header->val_size
+    };
+    for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(offsets); ++i) {
+        if (offsets[i] % MAPPED_HASHMAP_ALIGN != 0U
+            || offsets[i] < sizeof(_cutil_MappedHashMapHeader)
+            || offsets[i] > length || sizes[i] > length - offsets[i]) {
+            cutil_log_warn("MappedHashMap: corrupt table layout");
+            return CUTIL_STATUS_FAILURE;
+        }
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+/**
+ * Maps the file behind `fd` into `mhm`, which takes ownership of `fd`.
+ */
+static cutil_Status
+_cutil_MappedHashMap_map(_cutil_MappedHashMap *mhm, int fd)
+{
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        cutil_log_warn("MappedHashMap: could not stat file");
+        close(fd);
+        return CUTIL_STATUS_FAILURE;
+    }
+    const size_t length = (size_t) st.st_size;
+    void *const addr = mmap(NULL, length, PROT_READ, MAP_SHARED, fd, 0);
+    if (addr == MAP_FAILED) {
+        cutil_log_warn("MappedHashMap: could not map file");
+        close(fd);
+        return CUTIL_STATUS_FAILURE;
+    }
+    if (_cutil_MappedHashMap_check_header(mhm, addr, length)
+        == CUTIL_STATUS_FAILURE) {
+        munmap(addr, length);
+        close(fd);
+        return CUTIL_STATUS_FAILURE;
+    }
+    /* Lookups access slots at random, so read-ahead would only waste I/O */
+    posix_madvise(addr, length, POSIX_MADV_RANDOM);
+
+    const _cutil_MappedHashMapHeader *const header = addr;
+    const unsigned char *const base = addr;
+    mhm->fd = fd;
+    mhm->addr = addr;
+    mhm->length = length;
+    mhm->count = (size_t) header->count;
+    mhm->mask = (size_t) header->capacity - 1U;
+    mhm->hashes = (const void *) (base + header->hashes_offset);
+    mhm->keys = base + header->keys_offset;
+    mhm->vals = base + header->vals_offset;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static void
+_cutil_MappedHashMap_reset(void *data)
+{
+    _cutil_MappedHashMap *const mhm = data;
+    if (mhm->addr != NULL) {
+        munmap(mhm->addr, mhm->length);
+        close(mhm->fd);
+    }
+    mhm->fd = -1;
+    mhm->addr = NULL;
+    mhm->length = 0UL;
+    mhm->count = 0UL;
+    mhm->mask = 0UL;
+    mhm->hashes = NULL;
+    mhm->keys = NULL;
+    mhm->vals = NULL;
+}
+
+static _cutil_MappedHashMap *
+_cutil_MappedHashMap_alloc_data(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+)
+{
+    _cutil_MappedHashMap *const mhm = CUTIL_MALLOC_OBJECT(mhm);
+    mhm->key_type = key_type;
+    mhm->val_type = val_type;
+    mhm->addr = NULL;
+    _cutil_MappedHashMap_reset(mhm);
+    return mhm;
+}
+
+static void
+_cutil_MappedHashMap_free(void *data)
+{
+    CUTIL_RETURN_IF_NULL(data);
+    _cutil_MappedHashMap_reset(data);
+    free(data);
+}
+
+static void
+_cutil_MappedHashMap_copy(void *dst, const void *src)
+{
+    _cutil_MappedHashMap *const dst_mhm = dst;
+    const _cutil_MappedHashMap *const src_mhm = src;
+    CUTIL_RETURN_IF_VAL(dst_mhm, src_mhm);
+
+    _cutil_MappedHashMap_reset(dst_mhm);
+    dst_mhm->key_type = src_mhm->key_type;
+    dst_mhm->val_type = src_mhm->val_type;
+    CUTIL_RETURN_IF_NULL(src_mhm->addr);
+    /* Map the file again; the page cache is shared by both mappings */
+    const int fd = dup(src_mhm->fd);
+    if (fd == -1 || _cutil_MappedHashMap_map(dst_mhm, fd)
+                      == CUTIL_STATUS_FAILURE) {
+        cutil_log_warn("MappedHashMap copy: could not map file again");
+    }
+}
+
+static void *
+_cutil_MappedHashMap_duplicate(const void *data)
+{
+    const _cutil_MappedHashMap *const src = data;
+    _cutil_MappedHashMap *const dst
+      = _cutil_MappedHashMap_alloc_data(src->key_type, src->val_type);
+    _cutil_MappedHashMap_copy(dst, src);
+    return dst;
+}
+
+static size_t
+_cutil_MappedHashMap_get_count(const void *data)
+{
+    const _cutil_MappedHashMap *const mhm = data;
+    return mhm->count;
+}
+
+static cutil_Status
+_cutil_MappedHashMap_remove(void *data, const void *key)
+{
+    CUTIL_UNUSED(data);
+    CUTIL_UNUSED(key);
+    cutil_log_warn("MappedHashMap remove: map is read-only");
+    return CUTIL_STATUS_FAILURE;
+}
+
+static const void *
+_cutil_MappedHashMap_get_ptr(const void *data, const void *key)
+{
+    const _cutil_MappedHashMap *const mhm = data;
+    const cutil_hash_t hash
+      = _cutil_MappedHashMap_hash_key(mhm->key_type, key);
+    const size_t idx = _cutil_MappedHashMap_find(mhm, hash, key);
+    return (idx == CUTIL_ERROR_INDEX)
+           ? NULL
+           : _cutil_MappedHashMap_get_val_ptr(mhm, idx);
+}
+
+static cutil_Bool
+_cutil_MappedHashMap_contains(const void *data, const void *key)
+{
+    return CUTIL_BOOLIFY(_cutil_MappedHashMap_get_ptr(data, key) != NULL);
+}
+
+static cutil_Status
+_cutil_MappedHashMap_get(const void *data, const void *key, void *val)
+{
+    const _cutil_MappedHashMap *const mhm = data;
+    const void *const ptr = _cutil_MappedHashMap_get_ptr(mhm, key);
+    CUTIL_RETURN_VAL_IF_NULL(ptr, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(mhm->val_type, val, ptr);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_MappedHashMap_get_ptr_batch(
+  const void *data, const void *keys, size_t num_keys, const void **vals
+)
+{
+    const _cutil_MappedHashMap *const mhm = data;
+    const size_t key_size = mhm->key_type->size;
+    cutil_hash_t hashes[MAPPED_HASHMAP_BATCH_SIZE];
+    for (size_t start = 0; start < num_keys;
+         start += MAPPED_HASHMAP_BATCH_SIZE) {
+        const size_t num_batch
+          = CUTIL_MIN(MAPPED_HASHMAP_BATCH_SIZE, num_keys - start);
+        const void *const batch
+          = cutil_void_array_get_elem_const(key_size, keys, start);
+
+        /* Hash all keys first so that their page faults and misses overlap */
+        for (size_t i = 0; i < num_batch; ++i) {
+            const void *const key
+              = cutil_void_array_get_elem_const(key_size, batch, i);
+            hashes[i] = _cutil_MappedHashMap_hash_key(mhm->key_type, key);
+            if (mhm->count > 0U) {
+                CUTIL_PREFETCH(mhm->hashes + (hashes[i] & mhm->mask));
+            }
+        }
+
+        for (size_t i = 0; i < num_batch; ++i) {
+            const void *const key
+              = cutil_void_array_get_elem_const(key_size, batch, i);
+            const size_t idx = _cutil_MappedHashMap_find(mhm, hashes[i], key);
+            vals[start + i] = (idx == CUTIL_ERROR_INDEX)
+                              ? NULL
+                              : _cutil_MappedHashMap_get_val_ptr(mhm, idx);
+        }
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_MappedHashMap_set(void *data, const void *key, const void *val)
+{
+    CUTIL_UNUSED(data);
+    CUTIL_UNUSED(key);
+    CUTIL_UNUSED(val);
+    cutil_log_warn("MappedHashMap set: map is read-only");
+    return CUTIL_STATUS_FAILURE;
+}
+
+static void *
+_cutil_MappedHashMap_get_or_insert(
+  void *data, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    CUTIL_UNUSED(data);
+    CUTIL_UNUSED(key);
+    CUTIL_UNUSED(val);
+    if (inserted != NULL) {
+        *inserted = CUTIL_FALSE;
+    }
+    cutil_log_warn("MappedHashMap get_or_insert: map is read-only");
+    return NULL;
+}
+
+static const cutil_GenericType *
+_cutil_MappedHashMap_get_key_type(const void *data)
+{
+    const _cutil_MappedHashMap *const mhm = data;
+    return mhm->key_type;
+}
+
+static const cutil_GenericType *
+_cutil_MappedHashMap_get_val_type(const void *data)
+{
+    const _cutil_MappedHashMap *const mhm = data;
+    return mhm->val_type;
+}
+
+typedef struct {
+    const _cutil_MappedHashMap *mhm;
+    size_t idx; /**< current slot, CUTIL_ERROR_INDEX before the first */
+    cutil_Bool done;
+} _cutil_MappedHashMapIter;
+
+static void
+_cutil_MappedHashMapIter_free(void *data)
+{
+    free(data);
+}
+
+static void
+_cutil_MappedHashMapIter_rewind(void *data)
+{
+    _cutil_MappedHashMapIter *const iter = data;
+    iter->idx = CUTIL_ERROR_INDEX;
+    iter->done = CUTIL_FALSE;
+}
+
+static cutil_Bool
+_cutil_MappedHashMapIter_next(void *data)
+{
+    _cutil_MappedHashMapIter *const iter = data;
+    const _cutil_MappedHashMap *const mhm = iter->mhm;
+    if (iter->done || mhm->count == 0U) {
+        iter->done = CUTIL_TRUE;
+        return CUTIL_FALSE;
+    }
+    for (size_t idx = iter->idx + 1U; idx <= mhm->mask; ++idx) {
+        if (mhm->hashes[idx] != MAPPED_HASHMAP_EMPTY_HASH) {
+            iter->idx = idx;
+            return CUTIL_TRUE;
+        }
+    }
+    iter->done = CUTIL_TRUE;
+    return CUTIL_FALSE;
+}
+
+static const void *
+_cutil_MappedHashMapIter_get_ptr(const void *data)
+{
+    const _cutil_MappedHashMapIter *const iter = data;
+    if (iter->done || iter->idx == CUTIL_ERROR_INDEX) {
+        return NULL;
+    }
+    return _cutil_MappedHashMap_get_key_ptr(iter->mhm, iter->idx);
+}
+
+static cutil_Status
+_cutil_MappedHashMapIter_get(const void *data, void *out)
+{
+    const _cutil_MappedHashMapIter *const iter = data;
+    const void *const ptr = _cutil_MappedHashMapIter_get_ptr(data);
+    CUTIL_RETURN_VAL_IF_NULL(ptr, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(iter->mhm->key_type, out, ptr);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static const cutil_ConstIteratorType
+  CUTIL_CONST_ITERATOR_TYPE_MAPPED_HASHMAP_OBJECT
+  = {
+    .name = "cutil_ConstIterator<cutil_MappedHashMap>",
+    .free = &_cutil_MappedHashMapIter_free,
+    .rewind = &_cutil_MappedHashMapIter_rewind,
+    .next = &_cutil_MappedHashMapIter_next,
+    .get = &_cutil_MappedHashMapIter_get,
+    .get_ptr = &_cutil_MappedHashMapIter_get_ptr,
+};
+
+const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_MAPPED_HASHMAP
+  = &CUTIL_CONST_ITERATOR_TYPE_MAPPED_HASHMAP_OBJECT;
+
+static const cutil_IteratorType CUTIL_ITERATOR_TYPE_MAPPED_HASHMAP_OBJECT = {
+  .name = "cutil_Iterator<cutil_MappedHashMap>",
+  .free = &_cutil_MappedHashMapIter_free,
+  .rewind = &_cutil_MappedHashMapIter_rewind,
+  .next = &_cutil_MappedHashMapIter_next,
+  .get = &_cutil_MappedHashMapIter_get,
+  .get_ptr = &_cutil_MappedHashMapIter_get_ptr,
+  .set = NULL,
+  .remove = NULL,
+};
+
+const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_MAPPED_HASHMAP
+  = &CUTIL_ITERATOR_TYPE_MAPPED_HASHMAP_OBJECT;
+
+static _cutil_MappedHashMapIter *
+_cutil_MappedHashMapIter_alloc(const _cutil_MappedHashMap *mhm)
+{
+    _cutil_MappedHashMapIter *const iter = CUTIL_MALLOC_OBJECT(iter);
+    iter->mhm = mhm;
+    _cutil_MappedHashMapIter_rewind(iter);
+    return iter;
+}
+
+static cutil_ConstIterator *
+_cutil_MappedHashMap_get_const_iterator(const void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_ConstIterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_CONST_ITERATOR_TYPE_MAPPED_HASHMAP;
+    it->data = _cutil_MappedHashMapIter_alloc(data);
+
+    cutil_log_debug("MappedHashMap: created const iterator");
+    return it;
+}
+
+static cutil_Iterator *
+_cutil_MappedHashMap_get_iterator(void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_Iterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_ITERATOR_TYPE_MAPPED_HASHMAP;
+    it->data = _cutil_MappedHashMapIter_alloc(data);
+
+    cutil_log_debug("MappedHashMap: created iterator");
+    return it;
+}
+
+static const cutil_MapType CUTIL_MAP_TYPE_MAPPED_HASHMAP_OBJECT = {
+  .name = "cutil_MappedHashMap",
+  .free = &_cutil_MappedHashMap_free,
+  .reset = &_cutil_MappedHashMap_reset,
+  .copy = &_cutil_MappedHashMap_copy,
+  .duplicate = &_cutil_MappedHashMap_duplicate,
+  .get_count = &_cutil_MappedHashMap_get_count,
+  .remove = &_cutil_MappedHashMap_remove,
+  .contains = &_cutil_MappedHashMap_contains,
+  .get = &_cutil_MappedHashMap_get,
+  .get_ptr = &_cutil_MappedHashMap_get_ptr,
+  .get_ptr_batch = &_cutil_MappedHashMap_get_ptr_batch,
+  .set = &_cutil_MappedHashMap_set,
+  .get_or_insert = &_cutil_MappedHashMap_get_or_insert,
+  .get_key_type = &_cutil_MappedHashMap_get_key_type,
+  .get_val_type = &_cutil_MappedHashMap_get_val_type,
+  .get_const_iterator = &_cutil_MappedHashMap_get_const_iterator,
+  .get_iterator = &_cutil_MappedHashMap_get_iterator,
+};
+
+const cutil_MapType *const CUTIL_MAP_TYPE_MAPPED_HASHMAP
+  = &CUTIL_MAP_TYPE_MAPPED_HASHMAP_OBJECT;
+
+/**
+ * Fills header and table of the zero-initialized `file` with the entries of
+ * `map`.
+ */
+static void
+_cutil_MappedHashMap_fill(
+  const cutil_Map *map,
+  unsigned char *file,
+  const _cutil_MappedHashMapHeader *header
+)
+{
+    const cutil_GenericType *const key_type = cutil_Map_get_key_type(map);
+    const size_t key_size = key_type->size;
+    const size_t val_size = cutil_Map_get_val_type(map)->size;
+    const size_t mask = (size_t) header->capacity - 1U;
+    cutil_hash_t *const hashes = (void *) (file + header->hashes_offset);
+    unsigned char *const keys = file + header->keys_offset;
+    unsigned char *const vals = file + header->vals_offset;
+
+    memcpy(file, header, sizeof *header);
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    while (cutil_ConstIterator_next(it)) {
+        const void *const key = cutil_ConstIterator_get_ptr(it);
+        const cutil_hash_t hash = _cutil_MappedHashMap_hash_key(key_type, key);
+        size_t idx = hash & mask;
+        while (hashes[idx] != MAPPED_HASHMAP_EMPTY_HASH) {
+            idx = (idx + 1U) & mask;
+        }
+        hashes[idx] = hash;
+        memcpy(keys + idx * key_size, key, key_size);
+        memcpy(vals + idx * val_size, cutil_Map_get_ptr(map, key), val_size);
+    }
+    cutil_ConstIterator_free(it);
+}
+
+/**
+ * Returns header for a file holding `count` entries of the types of `map`.
+ */
+static _cutil_MappedHashMapHeader
+_cutil_MappedHashMap_make_header(const cutil_Map *map, size_t count)
+{
+    const cutil_GenericType *const key_type = cutil_Map_get_key_type(map);
+    const cutil_GenericType *const val_type = cutil_Map_get_val_type(map);
+
+    /* Keeps the load factor at most 3/4, so probe sequences stay short */
+    size_t capacity = MAPPED_HASHMAP_MIN_CAPACITY;
+    while (capacity - capacity / 4U <= count) {
+        capacity *= 2U;
+    }
+
+    _cutil_MappedHashMapHeader header;
+    memset(&header, 0, sizeof header);
+    memcpy(header.magic, MAPPED_HASHMAP_MAGIC, sizeof header.magic);
+    header.version = MAPPED_HASHMAP_VERSION;
+    header.byte_order = MAPPED_HASHMAP_BYTE_ORDER;
+    header.key_size = key_type->size;
+    header.val_size = val_type->size;
+    strncpy(
+      header.key_type_name, key_type->name, MAPPED_HASHMAP_TYPE_NAME_SIZE - 1U
+    );
+    strncpy(
+      header.val_type_name, val_type->name, MAPPED_HASHMAP_TYPE_NAME_SIZE - 1U
+    );
+    header.count = count;
+    header.capacity = capacity;
+    header.hashes_offset = _cutil_MappedHashMap_align(sizeof header);
+    header.keys_offset = _cutil_MappedHashMap_align(
+      header.hashes_offset + capacity * sizeof(cutil_hash_t)
+    );
+    header.vals_offset = _cutil_MappedHashMap_align(
+      header.keys_offset + capacity * key_type->size
+    );
+    header.file_size = _cutil_MappedHashMap_align(
+      header.vals_offset + capacity * val_type->size
+    );
+    return header;
+}
+
+cutil_Status
+cutil_MappedHashMap_write(const cutil_Map *map, const char *path)
+{
+    CUTIL_RETURN_VAL_IF_NULL(map, CUTIL_STATUS_FAILURE);
+    CUTIL_RETURN_VAL_IF_NULL(path, CUTIL_STATUS_FAILURE);
+    if (!cutil_GenericType_is_trivially_copyable(cutil_Map_get_key_type(map))
+        || !cutil_GenericType_is_trivially_copyable(
+          cutil_Map_get_val_type(map)
+        )) {
+        cutil_log_warn("MappedHashMap write: types are not trivially copyable");
+        return CUTIL_STATUS_FAILURE;
+    }
+
+    const _cutil_MappedHashMapHeader header
+      = _cutil_MappedHashMap_make_header(map, cutil_Map_get_count(map));
+    const size_t length = (size_t) header.file_size;
+    const size_t path_len = strlen(path);
+    char *const tmp_path = malloc(path_len + sizeof ".tmp");
+    memcpy(tmp_path, path, path_len);
+    memcpy(tmp_path + path_len, ".tmp", sizeof ".tmp");
+
+    cutil_Status status = CUTIL_STATUS_FAILURE;
+    const int fd = open(tmp_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        cutil_log_warn("MappedHashMap write: could not create '%s'", tmp_path);
+        free(tmp_path);
+        return CUTIL_STATUS_FAILURE;
+    }
+    /* The file is filled in place, so it never has to fit into the heap */
+    if (ftruncate(fd, (off_t) length) == 0) {
+        void *const addr
+          = mmap(NULL, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            _cutil_MappedHashMap_fill(map, addr, &header);
+            if (munmap(addr, length) == 0 && fsync(fd) == 0) {
+                status = CUTIL_STATUS_SUCCESS;
+            }
+        }
+    }
+    if (close(fd) != 0) {
+        status = CUTIL_STATUS_FAILURE;
+    }
+    if (status == CUTIL_STATUS_SUCCESS && rename(tmp_path, path) != 0) {
+        status = CUTIL_STATUS_FAILURE;
+    }
+    if (status == CUTIL_STATUS_FAILURE) {
+        cutil_log_warn("MappedHashMap write: could not write '%s'", path);
+        unlink(tmp_path);
+    }
+    free(tmp_path);
+    return status;
+}
+
+cutil_Map *
+cutil_MappedHashMap_open(
+  const char *path,
+  const cutil_GenericType *key_type,
+  const cutil_GenericType *val_type
+)
+{
+    CUTIL_RETURN_NULL_IF_NULL(path);
+    if (!cutil_GenericType_is_valid(key_type)) {
+        cutil_log_warn("Key type is not valid");
+        return NULL;
+    }
+    if (!cutil_GenericType_is_valid(val_type)) {
+        cutil_log_warn("Value type is not valid");
+        return NULL;
+    }
+
+    const int fd = open(path, O_RDONLY);
+    if (fd == -1) {
+        cutil_log_warn("MappedHashMap open: could not open '%s'", path);
+        return NULL;
+    }
+    _cutil_MappedHashMap *const mhm
+      = _cutil_MappedHashMap_alloc_data(key_type, val_type);
+    if (_cutil_MappedHashMap_map(mhm, fd) == CUTIL_STATUS_FAILURE) {
+        free(mhm);
+        return NULL;
+    }
+
+    cutil_Map *const map = CUTIL_MALLOC_OBJECT(map);
+    map->vtable = CUTIL_MAP_TYPE_MAPPED_HASHMAP;
+    map->data = mhm;
+    return map;
+}
@@ -0,0 +1,1087 @@
+#include <cutil/data/generic/map/persistent_hashmap.h>
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/io/log.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/util/bits.h>
+#include <cutil/util/hash.h>
+#include <cutil/util/macro.h>
+
+/*
+ * Every trie level consumes PERSISTENT_HASHMAP_BITS bits of the (finalized)
+ * hash. A node holds a bitmap of slots storing an entry inline and a bitmap
+ * of slots pointing to a subnode; entries and subnodes are packed densely in
+ * slot order, so a slot's position is the popcount of the lower bits. Once
+ * all hash bits are consumed, keys with equal hashes are kept in a
+ * collision node that is searched linearly.
+ *
+ * Nodes are reference counted. Before a node is modified, it is copied if
+ * another map (or iterator) still references it, which yields the path
+ * copying of persistent data structures. Nodes referenced only once are
+ * modified without copying their entries.
+ */
+#define PERSISTENT_HASHMAP_BITS 5U
+#define PERSISTENT_HASHMAP_SLOT_MASK ((1U << PERSISTENT_HASHMAP_BITS) - 1U)
+#define PERSISTENT_HASHMAP_HASH_BITS 64U
+#define PERSISTENT_HASHMAP_MAX_DEPTH                                           \
+    ((PERSISTENT_HASHMAP_HASH_BITS + PERSISTENT_HASHMAP_BITS - 1U)             \
+       / PERSISTENT_HASHMAP_BITS                                               \
+     + 1U)
+#define PERSISTENT_HASHMAP_NODE_ALIGN ((size_t) 16)
+
+typedef struct _cutil_PersistentHashMapNode _cutil_PersistentHashMapNode;
+
+/**
+ * Node header. Child pointers, hashes, keys and values of the entries follow
+ * in the same allocation.
+ */
+struct _cutil_PersistentHashMapNode {
+    size_t refcount;
+    uint32_t datamap;      /**< slots holding an entry */
+    uint32_t nodemap;      /**< slots holding a subnode */
+    uint32_t num_entries;  /**< popcount of datamap (unless collision node) */
+    uint32_t num_children; /**< popcount of nodemap */
+};
+
+typedef struct {
+    const cutil_GenericType *key_type;
+    const cutil_GenericType *val_type;
+    size_t count;
+    _cutil_PersistentHashMapNode *root; /**< NULL if empty */
+} _cutil_PersistentHashMap;
+
+static inline size_t
+_cutil_PersistentHashMap_align(size_t num_bytes)
+{
+    return (num_bytes + PERSISTENT_HASHMAP_NODE_ALIGN - 1U)
+         & ~(PERSISTENT_HASHMAP_NODE_ALIGN - 1U);
+}
+
+static inline cutil_hash_t
+_cutil_PersistentHashMap_hash_key(
+  const _cutil_PersistentHashMap *phm, const void *key
+)
+{
+    return cutil_hash_finalize(
+      cutil_GenericType_apply_hash(phm->key_type, key)
+    );
+}
+
+static inline uint32_t
+_cutil_PersistentHashMap_bit(cutil_hash_t hash, unsigned int shift)
+{
+    return UINT32_C(1) << ((hash >> shift) & PERSISTENT_HASHMAP_SLOT_MASK);
+}
+
+static inline size_t
+_cutil_PersistentHashMap_index(uint32_t bitmap, uint32_t bit)
+{
+    return cutil_bits_popcount_u64(bitmap & (bit - 1U));
+}
+
+static inline cutil_Bool
+_cutil_PersistentHashMap_is_collision(unsigned int shift)
+{
+    return CUTIL_BOOLIFY(shift >= PERSISTENT_HASHMAP_HASH_BITS);
+}
+
+static inline _cutil_PersistentHashMapNode **
+_cutil_PersistentHashMapNode_children(const _cutil_PersistentHashMapNode *node)
+{
+    return (_cutil_PersistentHashMapNode **) (void *) ((unsigned char *) node
+           + _cutil_PersistentHashMap_align(sizeof *node));
+}
+
+static inline cutil_hash_t *
+_cutil_PersistentHashMapNode_hashes(const _cutil_PersistentHashMapNode *node)
+{
+    _cutil_PersistentHashMapNode **const children
+      = _cutil_PersistentHashMapNode_children(node);
+    return (cutil_hash_t *) (void *) (children + node->num_children);
+}
+
+static inline unsigned char *
+_cutil_PersistentHashMapNode_keys(const _cutil_PersistentHashMapNode *node)
+{
+    const size_t offset = _cutil_PersistentHashMap_align(
+      (size_t) ((unsigned char *) (_cutil_PersistentHashMapNode_hashes(node)
+                                   + node->num_entries)
+                - (const unsigned char *) node)
+    );
+    return (unsigned char *) node + offset;
+}
+
+static inline void *
+_cutil_PersistentHashMapNode_key(
+  const _cutil_PersistentHashMap *phm,
+  const _cutil_PersistentHashMapNode *node,
+  size_t idx
+)
+{
+    return _cutil_PersistentHashMapNode_keys(node) + idx * phm->key_type->size;
+}
+
+static inline void *
+_cutil_PersistentHashMapNode_val(
+  const _cutil_PersistentHashMap *phm,
+  const _cutil_PersistentHashMapNode *node,
+  size_t idx
+)
+{
+    unsigned char *const vals
+      = _cutil_PersistentHashMapNode_keys(node)
+      + _cutil_PersistentHashMap_align(node->num_entries * phm->key_type->size);
+    return vals + idx * phm->val_type->size;
+}
+
+static _cutil_PersistentHashMapNode *
+_cutil_PersistentHashMapNode_alloc(
+  const _cutil_PersistentHashMap *phm,
+  uint32_t num_entries,
+  uint32_t num_children
+)
+{
+    size_t num_bytes
+      = _cutil_PersistentHashMap_align(sizeof(_cutil_PersistentHashMapNode))
+      + num_children * sizeof(_cutil_PersistentHashMapNode *)
+      + num_entries * sizeof(cutil_hash_t);
+    num_bytes = _cutil_PersistentHashMap_align(num_bytes)
+              + _cutil_PersistentHashMap_align(
+                  num_entries * phm->key_type->size
+                )
+              + num_entries * phm->val_type->size;
+
+    _cutil_PersistentHashMapNode *const node = malloc(num_bytes);
+    node->refcount = 1UL;
+    node->datamap = 0U;
+    node->nodemap = 0U;
+    node->num_entries = num_entries;
+    node->num_children = num_children;
+    return node;
+}
+
+static inline _cutil_PersistentHashMapNode *
+_cutil_PersistentHashMapNode_retain(_cutil_PersistentHashMapNode *node)
+{
+    if (node != NULL) {
+        ++node->refcount;
+    }
+    return node;
+}
+
+/**
+ * Drops a reference to `node` and frees it along with its entries once no
+ * references are left.
+ */
+static void
+_cutil_PersistentHashMapNode_release(
+  const _cutil_PersistentHashMap *phm, _cutil_PersistentHashMapNode *node
+)
+{
+    if (node == NULL || --node->refcount > 0U) {
+        return;
+    }
+    cutil_GenericType_apply_clear_mult(
+      phm->key_type, _cutil_PersistentHashMapNode_key(phm, node, 0UL),
+      node->num_entries
+    );
+    cutil_GenericType_apply_clear_mult(
+      phm->val_type, _cutil_PersistentHashMapNode_val(phm, node, 0UL),
+      node->num_entries
+    );
+    _cutil_PersistentHashMapNode **const children
+      = _cutil_PersistentHashMapNode_children(node);
+    for (uint32_t i = 0; i < node->num_children; ++i) {
+        _cutil_PersistentHashMapNode_release(phm, children[i]);
+    }
+    free(node);
+}
+
+/**
+ * Initializes entry `idx` of `node` with copies of `key` and `val`.
+ */
+static void
+_cutil_PersistentHashMapNode_init_entry(
+  const _cutil_PersistentHashMap *phm,
+  _cutil_PersistentHashMapNode *node,
+  size_t idx,
+  cutil_hash_t hash,
+  const void *key,
+  const void *val
+)
+{
+    void *const key_slot = _cutil_PersistentHashMapNode_key(phm, node, idx);
+    void *const val_slot = _cutil_PersistentHashMapNode_val(phm, node, idx);
+    _cutil_PersistentHashMapNode_hashes(node)[idx] = hash;
+    cutil_GenericType_apply_init(phm->key_type, key_slot);
+    cutil_GenericType_apply_copy(phm->key_type, key_slot, key);
+    cutil_GenericType_apply_init(phm->val_type, val_slot);
+    cutil_GenericType_apply_copy(phm->val_type, val_slot, val);
+}
+
+/**
+ * Moves `num` entries from `src` starting at `src_idx` to `dst` starting at
+ * `dst_idx`. Entries are relocated bytewise, so ownership moves along.
+ */
+static void
+_cutil_PersistentHashMapNode_move_entries(
+  const _cutil_PersistentHashMap *phm,
+  _cutil_PersistentHashMapNode *dst,
+  size_t dst_idx,
+  const _cutil_PersistentHashMapNode *src,
+  size_t src_idx,
+  size_t num
+)
+{
+    memcpy(
+      _cutil_PersistentHashMapNode_hashes(dst) + dst_idx,
+      _cutil_PersistentHashMapNode_hashes(src) + src_idx,
+      num * sizeof(cutil_hash_t)
+    );
+    memcpy(
+      _cutil_PersistentHashMapNode_key(phm, dst, dst_idx),
+      _cutil_PersistentHashMapNode_key(phm, src, src_idx),
+      num * phm->key_type->size
+    );
+    memcpy(
+      _cutil_PersistentHashMapNode_val(phm, dst, dst_idx),
+      _cutil_PersistentHashMapNode_val(phm, src, src_idx),
+      num * phm->val_type->size
+    );
+}
+
+static void
+_cutil_PersistentHashMapNode_move_children(
+  _cutil_PersistentHashMapNode *dst,
+  size_t dst_idx,
+  const _cutil_PersistentHashMapNode *src,
+  size_t src_idx,
+  size_t num
+)
+{
+    memcpy(
+      _cutil_PersistentHashMapNode_children(dst) + dst_idx,
+      _cutil_PersistentHashMapNode_children(src) + src_idx,
+      num * sizeof(_cutil_PersistentHashMapNode *)
+    );
+}
+
+/**
+ * Returns a copy of `node` that shares its subnodes and holds copies of its
+ * entries.
+ */
+static _cutil_PersistentHashMapNode *
+_cutil_PersistentHashMapNode_clone(
+  const _cutil_PersistentHashMap *phm, const _cutil_PersistentHashMapNode *node
+)
+{
+    _cutil_PersistentHashMapNode *const res
+      = _cutil_PersistentHashMapNode_alloc(
+        phm, node->num_entries, node->num_children
+      );
+    res->datamap = node->datamap;
+    res->nodemap = node->nodemap;
+
+    _cutil_PersistentHashMapNode_move_children(
+      res, 0UL, node, 0UL, node->num_children
+    );
+    _cutil_PersistentHashMapNode **const children
+      = _cutil_PersistentHashMapNode_children(res);
+    for (uint32_t i = 0; i < res->num_children; ++i) {
+        _cutil_PersistentHashMapNode_retain(children[i]);
+    }
+
+    memcpy(
+      _cutil_PersistentHashMapNode_hashes(res),
+      _cutil_PersistentHashMapNode_hashes(node),
+      node->num_entries * sizeof(cutil_hash_t)
+    );
+    void *const keys = _cutil_PersistentHashMapNode_key(phm, res, 0UL);
+    void *const vals = _cutil_PersistentHashMapNode_val(phm, res, 0UL);
+    cutil_GenericType_apply_init_mult(phm->key_type, keys, node->num_entries);
+    cutil_GenericType_apply_copy_mult(
+      phm->key_type, keys, _cutil_PersistentHashMapNode_key(phm, node, 0UL),
+      node->num_entries
+    );
+    cutil_GenericType_apply_init_mult(phm->val_type, vals, node->num_entries);
+    cutil_GenericType_apply_copy_mult(
+      phm->val_type, vals, _cutil_PersistentHashMapNode_val(phm, node, 0UL),
+      node->num_entries
+    );
+    return res;
+}
+
+/**
+ * Makes the node referenced by `pnode` exclusively owned by the caller,
+ * copying it if it is shared, and returns it.
+ */
+static _cutil_PersistentHashMapNode *
+_cutil_PersistentHashMapNode_make_unique(
+  const _cutil_PersistentHashMap *phm, _cutil_PersistentHashMapNode **pnode
+)
+{
+    _cutil_PersistentHashMapNode *const node = *pnode;
+    if (node->refcount == 1U) {
+        return node;
+    }
+    --node->refcount;
+    *pnode = _cutil_PersistentHashMapNode_clone(phm, node);
+    return *pnode;
+}
+
+/**
+ * Returns a copy of the exclusively owned `node` with a new entry at `idx`
+ * and frees `node`.
+ */
+static _cutil_PersistentHashMapNode *
+_cutil_PersistentHashMapNode_insert_entry(
+  const _cutil_PersistentHashMap *phm,
+  _cutil_PersistentHashMapNode *node,
+  uint32_t bit,
+  size_t idx,
+  cutil_hash_t hash,
+  const void *key,
+  const void *val
+)
+{
+    _cutil_PersistentHashMapNode *const res
+      = _cutil_PersistentHashMapNode_alloc(
+        phm, node->num_entries + 1U, node->num_children
+      );
+    res->datamap = node->datamap | bit;
+    res->nodemap = node->nodemap;
+    _cutil_PersistentHashMapNode_move_children(
+      res, 0UL, node, 0UL, node->num_children
+    );
+    _cutil_PersistentHashMapNode_move_entries(phm, res, 0UL, node, 0UL, idx);
+    _cutil_PersistentHashMapNode_move_entries(
+      phm, res, idx + 1U, node, idx, node->num_entries - idx
+    );
+    _cutil_PersistentHashMapNode_init_entry(phm, res, idx, hash, key, val);
+    free(node);
+    return res;
+}
+
+/**
+ * Returns a copy of the exclusively owned `node` without the (already
+ * cleared) entry at `idx` and frees `node`. Returns NULL if nothing is left.
+ */
+static _cutil_PersistentHashMapNode *
+_cutil_PersistentHashMapNode_remove_entry(
+  const _cutil_PersistentHashMap *phm,
+  _cutil_PersistentHashMapNode *node,
+  uint32_t bit,
+  size_t idx
+)
+{
+    if (node->num_entries == 1U && node->num_children == 0U) {
+        free(node);
+        return NULL;
+    }
+    _cutil_PersistentHashMapNode *const res
+      = _cutil_PersistentHashMapNode_alloc(
+        phm, node->num_entries - 1U, node->num_children
+      );
+    res->datamap = node->datamap & ~bit;
+    res->nodemap = node->nodemap;
+    _cutil_PersistentHashMapNode_move_children(
+      res, 0UL, node, 0UL, node->num_children
+    );
+    _cutil_PersistentHashMapNode_move_entries(phm, res, 0UL, node, 0UL, idx);
+    _cutil_PersistentHashMapNode_move_entries(
+      phm, res, idx, node, idx + 1U, node->num_entries - idx - 1U
+    );
+    free(node);
+    return res;
+}
+
+/**
+ * Returns a copy of the exclusively owned `node` in which the entry at `idx`
+ * has been replaced by `child` (the slot is given by `bit`) and frees `node`.
+ * The entry itself must already have been moved out.
+ */
+static _cutil_PersistentHashMapNode *
+_cutil_PersistentHashMapNode_entry_to_child(
+  const _cutil_PersistentHashMap *phm,
+  _cutil_PersistentHashMapNode *node,
+  uint32_t bit,
+  size_t idx,
+  _cutil_PersistentHashMapNode *child
+)
+{
+    const size_t child_idx = _cutil_PersistentHashMap_index(node->nodemap, bit);
+    _cutil_PersistentHashMapNode *const res
+      = _cutil_PersistentHashMapNode_alloc(
+        phm, node->num_entries - 1U, node->num_children + 1U
+      );
+    res->datamap = node->datamap & ~bit;
+    res->nodemap = node->nodemap | bit;
+    _cutil_PersistentHashMapNode_move_children(
+      res, 0UL, node, 0UL, child_idx
+    );
+    _cutil_PersistentHashMapNode_children(res)[child_idx] = child;
+    _cutil_PersistentHashMapNode_move_children(
+      res, child_idx + 1U, node, child_idx, node->num_children - child_idx
+    );
+    _cutil_PersistentHashMapNode_move_entries(phm, res, 0UL, node, 0UL, idx);
+    _cutil_PersistentHashMapNode_move_entries(
+      phm, res, idx, node, idx + 1U, node->num_entries - idx - 1U
+    );
+    free(node);
+    return res;
+}
+
+/**
+ * Returns a copy of the exclusively owned `node` in which the subnode in slot
+ * `bit` has been replaced by the single entry of that (exclusively owned)
+ * subnode and frees both.
+ */
+static _cutil_PersistentHashMapNode *
+_cutil_PersistentHashMapNode_child_to_entry(
+  const _cutil_PersistentHashMap *phm,
+  _cutil_PersistentHashMapNode *node,
+  uint32_t bit
+)
+{
+    const size_t child_idx = _cutil_PersistentHashMap_index(node->nodemap, bit);
+    const size_t idx = _cutil_PersistentHashMap_index(node->datamap, bit);
+    _cutil_PersistentHashMapNode *const child
+      = _cutil_PersistentHashMapNode_children(node)[child_idx];
+    _cutil_PersistentHashMapNode *const res
+      = _cutil_PersistentHashMapNode_alloc(
+        phm, node->num_entries + 1U, node->num_children - 1U
+      );
+    res->datamap = node->datamap | bit;
+    res->nodemap = node->nodemap & ~bit;
+    _cutil_PersistentHashMapNode_move_children(
+      res, 0UL, node, 0UL, child_idx
+    );
+    _cutil_PersistentHashMapNode_move_children(
+      res, child_idx, node, child_idx + 1U, node->num_children - child_idx - 1U
+    );
+    _cutil_PersistentHashMapNode_move_entries(phm, res, 0UL, node, 0UL, idx);
+    _cutil_PersistentHashMapNode_move_entries(phm, res, idx, child, 0UL, 1UL);
+    _cutil_PersistentHashMapNode_move_entries(
+      phm, res, idx + 1U, node, idx, node->num_entries - idx
+    );
+    free(child);
+    free(node);
+    return res;
+}
+
+/**
+ * Returns a new node at `shift` holding entry `idx` of `src`, which is moved
+ * out, and a new entry for `key`. Stores the value slot of the new entry in
+ * `val_slot`.
+ */
+static _cutil_PersistentHashMapNode *
+_cutil_PersistentHashMapNode_alloc_pair(
+  const _cutil_PersistentHashMap *phm,
+  const _cutil_PersistentHashMapNode *src,
+  size_t idx,
+  cutil_hash_t hash,
+  const void *key,
+  const void *val,
+  unsigned int shift,
+  void **val_slot
+)
+{
+    const cutil_hash_t src_hash = _cutil_PersistentHashMapNode_hashes(src)[idx];
+    if (_cutil_PersistentHashMap_is_collision(shift)) {
+        _cutil_PersistentHashMapNode *const res
+          = _cutil_PersistentHashMapNode_alloc(phm, 2U, 0U);
+        _cutil_PersistentHashMapNode_move_entries(phm, res, 0UL, src, idx, 1UL);
+        _cutil_PersistentHashMapNode_init_entry(phm, res, 1UL, hash, key, val);
+        *val_slot = _cutil_PersistentHashMapNode_val(phm, res, 1UL);
+        return res;
+    }
+
+    const uint32_t src_bit = _cutil_PersistentHashMap_bit(src_hash, shift);
+    const uint32_t bit = _cutil_PersistentHashMap_bit(hash, shift);
+    if (src_bit == bit) {
+        _cutil_PersistentHashMapNode *const res
+          = _cutil_PersistentHashMapNode_alloc(phm, 0U, 1U);
+        res->nodemap = bit;
+        _cutil_PersistentHashMapNode_children(res)[0]
+          = _cutil_PersistentHashMapNode_alloc_pair(
+            phm, src, idx, hash, key, val, shift + PERSISTENT_HASHMAP_BITS,
+            val_slot
+          );
+        return res;
+    }
+
+    _cutil_PersistentHashMapNode *const res
+      = _cutil_PersistentHashMapNode_alloc(phm, 2U, 0U);
+    res->datamap = src_bit | bit;
+    const size_t src_pos = src_bit < bit ? 0UL : 1UL;
+    _cutil_PersistentHashMapNode_move_entries(phm, res, src_pos, src, idx, 1UL);
+    _cutil_PersistentHashMapNode_init_entry(
+      phm, res, 1U - src_pos, hash, key, val
+    );
+    *val_slot = _cutil_PersistentHashMapNode_val(phm, res, 1U - src_pos);
+    return res;
+}
+
+/**
+ * Returns position of the entry with `key` in `node` at `shift`, or -1 if
+ * there is no such entry in the subtrie of `node`. `node` is updated to the
+ * node holding the entry.
+ */
+static ptrdiff_t
+_cutil_PersistentHashMap_find(
+  const _cutil_PersistentHashMap *phm,
+  const _cutil_PersistentHashMapNode **pnode,
+  cutil_hash_t hash,
+  const void *key
+)
+{
+    const _cutil_PersistentHashMapNode *node = *pnode;
+    unsigned int shift = 0U;
+    while (node != NULL) {
+        const cutil_hash_t *const hashes
+          = _cutil_PersistentHashMapNode_hashes(node);
+        if (_cutil_PersistentHashMap_is_collision(shift)) {
+            for (size_t i = 0; i < node->num_entries; ++i) {
+                if (hashes[i] == hash
+                    && cutil_GenericType_apply_compare(
+                         phm->key_type,
+                         _cutil_PersistentHashMapNode_key(phm, node, i), key
+                       ) == 0) {
+                    *pnode = node;
+                    return (ptrdiff_t) i;
+                }
+            }
+            return -1;
+        }
+        const uint32_t bit = _cutil_PersistentHashMap_bit(hash, shift);
+        if ((node->datamap & bit) != 0U) {
+            const size_t idx
+              = _cutil_PersistentHashMap_index(node->datamap, bit);
+            if (hashes[idx] == hash
+                && cutil_GenericType_apply_compare(
+                     phm->key_type,
+                     _cutil_PersistentHashMapNode_key(phm, node, idx), key
+                   ) == 0) {
+                *pnode = node;
+                return (ptrdiff_t) idx;
+            }
+            return -1;
+        }
+        if ((node->nodemap & bit) == 0U) {
+            return -1;
+        }
+        node = _cutil_PersistentHashMapNode_children(
+          node
+        )[_cutil_PersistentHashMap_index(node->nodemap, bit)];
+        shift += PERSISTENT_HASHMAP_BITS;
+    }
+    return -1;
+}
+
+static const void *
+_cutil_PersistentHashMap_find_val(
+  const _cutil_PersistentHashMap *phm, const void *key
+)
+{
+    const _cutil_PersistentHashMapNode *node = phm->root;
+    const cutil_hash_t hash = _cutil_PersistentHashMap_hash_key(phm, key);
+    const ptrdiff_t idx = _cutil_PersistentHashMap_find(phm, &node, hash, key);
+    if (idx == -1) {
+        return NULL;
+    }
+    return _cutil_PersistentHashMapNode_val(phm, node, (size_t) idx);
+}
+
+/**
+ * Returns value slot of `key` in the subtrie referenced by `pnode`, inserting
+ * `key` with `val` if not present. Copies every shared node on the path, so
+ * the returned slot may be modified.
+ */
+static void *
+_cutil_PersistentHashMap_insert(
+  _cutil_PersistentHashMap *phm,
+  _cutil_PersistentHashMapNode **pnode,
+  unsigned int shift,
+  cutil_hash_t hash,
+  const void *key,
+  const void *val,
+  cutil_Bool *inserted
+)
+{
+    _cutil_PersistentHashMapNode *const node
+      = _cutil_PersistentHashMapNode_make_unique(phm, pnode);
+    const cutil_hash_t *const hashes
+      = _cutil_PersistentHashMapNode_hashes(node);
+
+    if (_cutil_PersistentHashMap_is_collision(shift)) {
+        for (size_t i = 0; i < node->num_entries; ++i) {
+            if (hashes[i] == hash
+                && cutil_GenericType_apply_compare(
+                     phm->key_type,
+                     _cutil_PersistentHashMapNode_key(phm, node, i), key
+                   ) == 0) {
+                return _cutil_PersistentHashMapNode_val(phm, node, i);
+            }
+        }
+        const size_t idx = node->num_entries;
+        *pnode = _cutil_PersistentHashMapNode_insert_entry(
+          phm, node, 0U, idx, hash, key, val
+        );
+        *inserted = CUTIL_TRUE;
+        return _cutil_PersistentHashMapNode_val(phm, *pnode, idx);
+    }
+
+    const uint32_t bit = _cutil_PersistentHashMap_bit(hash, shift);
+    const size_t idx = _cutil_PersistentHashMap_index(node->datamap, bit);
+    if ((node->datamap & bit) != 0U) {
+        if (hashes[idx] == hash
+            && cutil_GenericType_apply_compare(
+                 phm->key_type,
+                 _cutil_PersistentHashMapNode_key(phm, node, idx), key
+               ) == 0) {
+            return _cutil_PersistentHashMapNode_val(phm, node, idx);
+        }
+        /* Push existing entry down into a new subnode along with the key */
+        void *val_slot;
+        _cutil_PersistentHashMapNode *const child
+          = _cutil_PersistentHashMapNode_alloc_pair(
+            phm, node, idx, hash, key, val, shift + PERSISTENT_HASHMAP_BITS,
+            &val_slot
+          );
+        *pnode = _cutil_PersistentHashMapNode_entry_to_child(
+          phm, node, bit, idx, child
+        );
+        *inserted = CUTIL_TRUE;
+        return val_slot;
+    }
+    if ((node->nodemap & bit) != 0U) {
+        const size_t child_idx
+          = _cutil_PersistentHashMap_index(node->nodemap, bit);
+        return _cutil_PersistentHashMap_insert(
+          phm, _cutil_PersistentHashMapNode_children(node) + child_idx,
+          shift + PERSISTENT_HASHMAP_BITS, hash, key, val, inserted
+        );
+    }
+    *pnode = _cutil_PersistentHashMapNode_insert_entry(
+      phm, node, bit, idx, hash, key, val
+    );
+    *inserted = CUTIL_TRUE;
+    return _cutil_PersistentHashMapNode_val(phm, *pnode, idx);
+}
+
+/**
+ * Removes `key`, which must be present, from the subtrie referenced by
+ * `pnode`. Subnodes that are left with a single entry are inlined into their
+ * parent, so the trie stays as shallow as possible.
+ */
+static void
+_cutil_PersistentHashMap_erase(
+  _cutil_PersistentHashMap *phm,
+  _cutil_PersistentHashMapNode **pnode,
+  unsigned int shift,
+  cutil_hash_t hash,
+  const void *key
+)
+{
+    _cutil_PersistentHashMapNode *const node
+      = _cutil_PersistentHashMapNode_make_unique(phm, pnode);
+
+    uint32_t bit = 0U;
+    size_t idx = 0UL;
+    if (_cutil_PersistentHashMap_is_collision(shift)) {
+        const cutil_hash_t *const hashes
+          = _cutil_PersistentHashMapNode_hashes(node);
+        while (hashes[idx] != hash
+               || cutil_GenericType_apply_compare(
+                    phm->key_type,
+                    _cutil_PersistentHashMapNode_key(phm, node, idx), key
+                  ) != 0) {
+            ++idx;
+        }
+    } else {
+        bit = _cutil_PersistentHashMap_bit(hash, shift);
+        if ((node->datamap & bit) == 0U) {
+            const size_t child_idx
+              = _cutil_PersistentHashMap_index(node->nodemap, bit);
+            _cutil_PersistentHashMapNode **const pchild
+              = _cutil_PersistentHashMapNode_children(node) + child_idx;
+            _cutil_PersistentHashMap_erase(
+              phm, pchild, shift + PERSISTENT_HASHMAP_BITS, hash, key
+            );
+            if ((*pchild)->num_entries == 1U && (*pchild)->num_children == 0U) {
+                *pnode = _cutil_PersistentHashMapNode_child_to_entry(
+                  phm, node, bit
+                );
+            }
+            return;
+        }
+        idx = _cutil_PersistentHashMap_index(node->datamap, bit);
+    }
+
+    cutil_GenericType_apply_clear(
+      phm->key_type, _cutil_PersistentHashMapNode_key(phm, node, idx)
+    );
+    cutil_GenericType_apply_clear(
+      phm->val_type, _cutil_PersistentHashMapNode_val(phm, node, idx)
+    );
+    *pnode = _cutil_PersistentHashMapNode_remove_entry(phm, node, bit, idx);
+}
+
+cutil_Map *
+cutil_PersistentHashMap_alloc(
+  const cutil_GenericType *key_type, const cutil_GenericType *val_type
+)
+{
+    if (!cutil_GenericType_is_valid(key_type)) {
+        cutil_log_warn("Key type is not valid");
+        return NULL;
+    }
+    if (!cutil_GenericType_is_valid(val_type)) {
+        cutil_log_warn("Value type is not valid");
+        return NULL;
+    }
+
+    cutil_Map *const map = CUTIL_MALLOC_OBJECT(map);
+
+    map->vtable = CUTIL_MAP_TYPE_PERSISTENT_HASHMAP;
+    _cutil_PersistentHashMap *const phm = map->data = CUTIL_MALLOC_OBJECT(phm);
+
+    phm->key_type = key_type;
+    phm->val_type = val_type;
+    phm->count = 0UL;
+    phm->root = NULL;
+
+    return map;
+}
+
+static void
+_cutil_PersistentHashMap_reset(void *data)
+{
+    _cutil_PersistentHashMap *const phm = data;
+    _cutil_PersistentHashMapNode_release(phm, phm->root);
+    phm->root = NULL;
+    phm->count = 0UL;
+}
+
+static void
+_cutil_PersistentHashMap_free(void *data)
+{
+    CUTIL_RETURN_IF_NULL(data);
+    _cutil_PersistentHashMap_reset(data);
+    free(data);
+}
+
+static void
+_cutil_PersistentHashMap_copy(void *dst, const void *src)
+{
+    _cutil_PersistentHashMap *const dst_phm = dst;
+    const _cutil_PersistentHashMap *const src_phm = src;
+    CUTIL_RETURN_IF_VAL(dst_phm, src_phm);
+
+    _cutil_PersistentHashMapNode *const root
+      = _cutil_PersistentHashMapNode_retain(src_phm->root);
+    _cutil_PersistentHashMap_reset(dst_phm);
+    dst_phm->root = root;
+    dst_phm->count = src_phm->count;
+}
+
+static void *
+_cutil_PersistentHashMap_duplicate(const void *data)
+{
+    const _cutil_PersistentHashMap *const src = data;
+    _cutil_PersistentHashMap *const dst = CUTIL_MALLOC_OBJECT(dst);
+    *dst = *src;
+    _cutil_PersistentHashMapNode_retain(dst->root);
+    return dst;
+}
+
+static size_t
+_cutil_PersistentHashMap_get_count(const void *data)
+{
+    const _cutil_PersistentHashMap *const phm = data;
+    return phm->count;
+}
+
+static cutil_Status
+_cutil_PersistentHashMap_remove(void *data, const void *key)
+{
+    _cutil_PersistentHashMap *const phm = data;
+    const cutil_hash_t hash = _cutil_PersistentHashMap_hash_key(phm, key);
+
+    /* Look up first, so that no nodes are copied if key is absent */
+    const _cutil_PersistentHashMapNode *node = phm->root;
+    if (_cutil_PersistentHashMap_find(phm, &node, hash, key) == -1) {
+        return CUTIL_STATUS_FAILURE;
+    }
+    _cutil_PersistentHashMap_erase(phm, &phm->root, 0U, hash, key);
+    --phm->count;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Bool
+_cutil_PersistentHashMap_contains(const void *data, const void *key)
+{
+    return CUTIL_BOOLIFY(_cutil_PersistentHashMap_find_val(data, key) != NULL);
+}
+
+static const void *
+_cutil_PersistentHashMap_get_ptr(const void *data, const void *key)
+{
+    return _cutil_PersistentHashMap_find_val(data, key);
+}
+
+static cutil_Status
+_cutil_PersistentHashMap_get(const void *data, const void *key, void *val)
+{
+    const _cutil_PersistentHashMap *const phm = data;
+    const void *const p = _cutil_PersistentHashMap_find_val(phm, key);
+    CUTIL_RETURN_VAL_IF_NULL(p, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(phm->val_type, val, p);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static void *
+_cutil_PersistentHashMap_get_or_insert(
+  void *data, const void *key, const void *val, cutil_Bool *inserted
+)
+{
+    _cutil_PersistentHashMap *const phm = data;
+    const cutil_hash_t hash = _cutil_PersistentHashMap_hash_key(phm, key);
+    cutil_Bool res = CUTIL_FALSE;
+    void *val_slot;
+    if (phm->root == NULL) {
+        phm->root = _cutil_PersistentHashMapNode_alloc(phm, 1U, 0U);
+        phm->root->datamap = _cutil_PersistentHashMap_bit(hash, 0U);
+        _cutil_PersistentHashMapNode_init_entry(
+          phm, phm->root, 0UL, hash, key, val
+        );
+        val_slot = _cutil_PersistentHashMapNode_val(phm, phm->root, 0UL);
+        res = CUTIL_TRUE;
+    } else {
+        val_slot = _cutil_PersistentHashMap_insert(
+          phm, &phm->root, 0U, hash, key, val, &res
+        );
+    }
+    if (res) {
+        ++phm->count;
+    }
+    if (inserted != NULL) {
+        *inserted = res;
+    }
+    return val_slot;
+}
+
+static cutil_Status
+_cutil_PersistentHashMap_set(void *data, const void *key, const void *val)
+{
+    _cutil_PersistentHashMap *const phm = data;
+    cutil_Bool inserted;
+    void *const val_slot
+      = _cutil_PersistentHashMap_get_or_insert(phm, key, val, &inserted);
+    if (!inserted) {
+        cutil_GenericType_apply_copy(phm->val_type, val_slot, val);
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static const cutil_GenericType *
+_cutil_PersistentHashMap_get_key_type(const void *data)
+{
+    const _cutil_PersistentHashMap *const phm = data;
+    return phm->key_type;
+}
+
+static const cutil_GenericType *
+_cutil_PersistentHashMap_get_val_type(const void *data)
+{
+    const _cutil_PersistentHashMap *const phm = data;
+    return phm->val_type;
+}
+
+typedef struct {
+    const _cutil_PersistentHashMapNode *node;
+    size_t pos; /**< next entry, then next child (offset by num_entries) */
+} _cutil_PersistentHashMapIterFrame;
+
+/**
+ * Depth-first traversal of a snapshot of the trie. The iterator holds a
+ * reference to the root it traverses, so the map may change meanwhile.
+ */
+typedef struct {
+    _cutil_PersistentHashMap *phm;
+    _cutil_PersistentHashMapNode *root; /**< snapshot being traversed */
+    size_t depth;
+    _cutil_PersistentHashMapIterFrame stack[PERSISTENT_HASHMAP_MAX_DEPTH];
+    const _cutil_PersistentHashMapNode *node; /**< node of current entry */
+    size_t idx; /**< index of current entry */
+} _cutil_PersistentHashMapIter;
+
+static void
+_cutil_PersistentHashMapIter_rewind(void *data)
+{
+    _cutil_PersistentHashMapIter *const iter = data;
+    _cutil_PersistentHashMapNode_release(iter->phm, iter->root);
+    iter->root = _cutil_PersistentHashMapNode_retain(iter->phm->root);
+    iter->depth = 0UL;
+    if (iter->root != NULL) {
+        iter->stack[0].node = iter->root;
+        iter->stack[0].pos = 0UL;
+        iter->depth = 1UL;
+    }
+    iter->node = NULL;
+    iter->idx = 0UL;
+}
+
+static void
+_cutil_PersistentHashMapIter_free(void *data)
+{
+    _cutil_PersistentHashMapIter *const iter = data;
+    CUTIL_RETURN_IF_NULL(iter);
+    _cutil_PersistentHashMapNode_release(iter->phm, iter->root);
+    free(iter);
+}
+
+static cutil_Bool
+_cutil_PersistentHashMapIter_next(void *data)
+{
+    _cutil_PersistentHashMapIter *const iter = data;
+    while (iter->depth > 0U) {
+        _cutil_PersistentHashMapIterFrame *const frame
+          = &iter->stack[iter->depth - 1U];
+        const _cutil_PersistentHashMapNode *const node = frame->node;
+        if (frame->pos < node->num_entries) {
+            iter->node = node;
+            iter->idx = frame->pos++;
+            return CUTIL_TRUE;
+        }
+        const size_t child_idx = frame->pos - node->num_entries;
+        if (child_idx < node->num_children) {
+            ++frame->pos;
+            iter->stack[iter->depth].node
+              = _cutil_PersistentHashMapNode_children(node)[child_idx];
+            iter->stack[iter->depth].pos = 0UL;
+            ++iter->depth;
+            continue;
+        }
+        --iter->depth;
+    }
+    iter->node = NULL;
+    return CUTIL_FALSE;
+}
+
+static const void *
+_cutil_PersistentHashMapIter_get_ptr(const void *data)
+{
+    const _cutil_PersistentHashMapIter *const iter = data;
+    CUTIL_RETURN_NULL_IF_NULL(iter->node);
+    return _cutil_PersistentHashMapNode_key(iter->phm, iter->node, iter->idx);
+}
+
+static cutil_Status
+_cutil_PersistentHashMapIter_get(const void *data, void *out)
+{
+    const _cutil_PersistentHashMapIter *const iter = data;
+    const void *const p = _cutil_PersistentHashMapIter_get_ptr(data);
+    CUTIL_RETURN_VAL_IF_NULL(p, CUTIL_STATUS_FAILURE);
+    cutil_GenericType_apply_copy(iter->phm->key_type, out, p);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_PersistentHashMapIter_remove(void *data)
+{
+    _cutil_PersistentHashMapIter *const iter = data;
+    const void *const p = _cutil_PersistentHashMapIter_get_ptr(data);
+    CUTIL_RETURN_VAL_IF_NULL(p, CUTIL_STATUS_FAILURE);
+    /* The snapshot keeps the current node alive, so `p` stays valid */
+    return _cutil_PersistentHashMap_remove(iter->phm, p);
+}
+
+static _cutil_PersistentHashMapIter *
+_cutil_PersistentHashMapIter_alloc(const _cutil_PersistentHashMap *phm)
+{
+    _cutil_PersistentHashMapIter *const iter = CUTIL_MALLOC_OBJECT(iter);
+    iter->phm = CUTIL_CONST_CAST(phm);
+    iter->root = NULL;
+    _cutil_PersistentHashMapIter_rewind(iter);
+    return iter;
+}
+
+static const cutil_ConstIteratorType
+  CUTIL_CONST_ITERATOR_TYPE_PERSISTENT_HASHMAP_OBJECT
+  = {
+    .name = "cutil_ConstIterator<cutil_PersistentHashMap>",
+    .free = &_cutil_PersistentHashMapIter_free,
+    .rewind = &_cutil_PersistentHashMapIter_rewind,
+    .next = &_cutil_PersistentHashMapIter_next,
+    .get = &_cutil_PersistentHashMapIter_get,
+    .get_ptr = &_cutil_PersistentHashMapIter_get_ptr,
+};
+
+const cutil_ConstIteratorType
+  *const CUTIL_CONST_ITERATOR_TYPE_PERSISTENT_HASHMAP
+  = &CUTIL_CONST_ITERATOR_TYPE_PERSISTENT_HASHMAP_OBJECT;
+
+static const cutil_IteratorType CUTIL_ITERATOR_TYPE_PERSISTENT_HASHMAP_OBJECT
+  = {
+    .name = "cutil_Iterator<cutil_PersistentHashMap>",
+    .free = &_cutil_PersistentHashMapIter_free,
+    .rewind = &_cutil_PersistentHashMapIter_rewind,
+    .next = &_cutil_PersistentHashMapIter_next,
+    .get = &_cutil_PersistentHashMapIter_get,
+    .get_ptr = &_cutil_PersistentHashMapIter_get_ptr,
+    .set = NULL,
+    .remove = &_cutil_PersistentHashMapIter_remove,
+};
+
+const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_PERSISTENT_HASHMAP
+  = &CUTIL_ITERATOR_TYPE_PERSISTENT_HASHMAP_OBJECT;
+
+static cutil_ConstIterator *
+_cutil_PersistentHashMap_get_const_iterator(const void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_ConstIterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_CONST_ITERATOR_TYPE_PERSISTENT_HASHMAP;
+    it->data = _cutil_PersistentHashMapIter_alloc(data);
+
+    cutil_log_debug("PersistentHashMap: created const iterator");
+    return it;
+}
+
+static cutil_Iterator *
+_cutil_PersistentHashMap_get_iterator(void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+
+    cutil_Iterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_ITERATOR_TYPE_PERSISTENT_HASHMAP;
+    it->data = _cutil_PersistentHashMapIter_alloc(data);
+
+    cutil_log_debug("PersistentHashMap: created iterator");
+    return it;
+}
+
+static const cutil_MapType CUTIL_MAP_TYPE_PERSISTENT_HASHMAP_OBJECT = {
+  .name = "cutil_PersistentHashMap",
+  .free = &_cutil_PersistentHashMap_free,
+  .reset = &_cutil_PersistentHashMap_reset,
+  .copy = &_cutil_PersistentHashMap_copy,
+  .duplicate = &_cutil_PersistentHashMap_duplicate,
+  .get_count = &_cutil_PersistentHashMap_get_count,
+  .remove = &_cutil_PersistentHashMap_remove,
+  .contains = &_cutil_PersistentHashMap_contains,
+  .get = &_cutil_PersistentHashMap_get,
+  .get_ptr = &_cutil_PersistentHashMap_get_ptr,
+  .set = &_cutil_PersistentHashMap_set,
+  .get_or_insert = &_cutil_PersistentHashMap_get_or_insert,
+  .get_key_type = &_cutil_PersistentHashMap_get_key_type,
+  .get_val_type = &_cutil_PersistentHashMap_get_val_type,
+  .get_const_iterator = &_cutil_PersistentHashMap_get_const_iterator,
+  .get_iterator = &_cutil_PersistentHashMap_get_iterator,
+};
+
+const cutil_MapType *const CUTIL_MAP_TYPE_PERSISTENT_HASHMAP
+  = &CUTIL_MAP_TYPE_PERSISTENT_HASHMAP_OBJECT;
@@ -34,12 +34,66 @@ cutil_Set_get_count(const cutil_Set *set);
 extern inline cutil_Bool
 cutil_Set_contains(const cutil_Set *set, const void *elem);
 
+cutil_Status
+cutil_Set_contains_batch(
+  const cutil_Set *set, const void *elems, size_t num_elems, cutil_Bool *res
+)
+{
+    CUTIL_RETURN_VAL_IF_NULL(set, CUTIL_STATUS_FAILURE);
+    CUTIL_NULL_CHECK(set->vtable);
+    if (set->vtable->contains_batch != NULL) {
+        return set->vtable->contains_batch(set->data, elems, num_elems, res);
+    }
+
+    const cutil_GenericType *const elem_type = cutil_Set_get_elem_type(set);
+    CUTIL_RETURN_VAL_IF_NULL(elem_type, CUTIL_STATUS_FAILURE);
+    CUTIL_NULL_CHECK_VTABLE(set->vtable, contains);
+    CUTIL_RETURN_VAL_IF_NULL(set->vtable->contains, CUTIL_STATUS_FAILURE);
+    for (size_t i = 0; i < num_elems; ++i) {
+        const void *const elem
+          = cutil_void_array_get_elem_const(elem_type->size, elems, i);
+        res[i] = set->vtable->contains(set->data, elem);
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
 extern inline cutil_Status
 cutil_Set_add(cutil_Set *set, const void *elem);
 
+cutil_Status
+cutil_Set_insert_if_absent(
+  cutil_Set *set, const void *elem, cutil_Bool *inserted
+)
+{
+    CUTIL_RETURN_VAL_IF_NULL(set, CUTIL_STATUS_FAILURE);
+    CUTIL_NULL_CHECK(set->vtable);
+    if (set->vtable->insert_if_absent != NULL) {
+        return set->vtable->insert_if_absent(set->data, elem, inserted);
+    }
+
+    cutil_Bool res = false;
+    if (!cutil_Set_contains(set, elem)) {
+        const cutil_Status status = cutil_Set_add(set, elem);
+        if (status != CUTIL_STATUS_SUCCESS) {
+            return status;
+        }
+        res = true;
+    }
+    if (inserted != NULL) {
+        *inserted = res;
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
 extern inline cutil_Status
 cutil_Set_remove(cutil_Set *set, const void *elem);
 
+extern inline cutil_Status
+cutil_Set_reserve(cutil_Set *set, size_t count);
+
+extern inline cutil_Status
+cutil_Set_shrink_to_fit(cutil_Set *set);
+
 extern inline const cutil_GenericType *
 cutil_Set_get_elem_type(const cutil_Set *set);
 
@@ -49,6 +103,200 @@ cutil_Set_get_const_iterator(const cutil_Set *set);
 extern inline cutil_Iterator *
 cutil_Set_get_iterator(cutil_Set *set);
 
+/**
+ * Returns whether `lhs` and `rhs` hold elements of the same type.
+ */
+static cutil_Bool
+_cutil_Set_are_combinable(const cutil_Set *lhs, const cutil_Set *rhs)
+{
+    const cutil_GenericType *const lhs_type = cutil_Set_get_elem_type(lhs);
+    const cutil_GenericType *const rhs_type = cutil_Set_get_elem_type(rhs);
+    if (lhs_type == NULL || !cutil_GenericType_equals(lhs_type, rhs_type)) {
+        cutil_log_warn(
+          "Incompatible set element types: '%s' vs. '%s'",
+          (lhs_type != NULL) ? lhs_type->name : "NULL",
+          (rhs_type != NULL) ? rhs_type->name : "NULL"
+        );
+        return false;
+    }
+    return true;
+}
+
+/**
+ * Returns whether applying `op` to `dst` in place has to walk the larger of
+ * `dst` and `src`, so that building the result from the smaller one probes
+ * less.
+ */
+static cutil_Bool
+_cutil_Set_walks_larger(
+  const cutil_Set *dst, const cutil_Set *src, cutil_SetOp op
+)
+{
+    const size_t dst_count = cutil_Set_get_count(dst);
+    const size_t src_count = cutil_Set_get_count(src);
+    if (op == CUTIL_SET_OP_INTERSECTION) {
+        return CUTIL_BOOLIFY(dst_count > src_count);
+    }
+    if (op == CUTIL_SET_OP_DIFFERENCE) {
+        return false;
+    }
+    return CUTIL_BOOLIFY(src_count > dst_count);
+}
+
+/**
+ * Removes the elements of `dst` whose membership in `src` differs from
+ * `keep_contained`.
+ */
+static cutil_Status
+_cutil_Set_retain_generic(
+  cutil_Set *dst, const cutil_Set *src, cutil_Bool keep_contained
+)
+{
+    cutil_Iterator *const it = cutil_Set_get_iterator(dst);
+    CUTIL_RETURN_VAL_IF_NULL(it, CUTIL_STATUS_FAILURE);
+    cutil_Status status = CUTIL_STATUS_SUCCESS;
+    while (status == CUTIL_STATUS_SUCCESS && cutil_Iterator_next(it)) {
+        const void *const p = cutil_Iterator_get_ptr(it);
+        if (cutil_Set_contains(src, p) != keep_contained) {
+            status = cutil_Iterator_remove(it);
+        }
+    }
+    cutil_Iterator_free(it);
+    return status;
+}
+
+/**
+ * Fallback of 'cutil_Set_combine' for sets of different types, using only
+ * iterators and element-wise operations.
+ */
+static cutil_Status
+_cutil_Set_combine_generic(
+  cutil_Set *dst, const cutil_Set *src, cutil_SetOp op
+)
+{
+    const size_t dst_count = cutil_Set_get_count(dst);
+    const size_t src_count = cutil_Set_get_count(src);
+    if (op == CUTIL_SET_OP_INTERSECTION) {
+        return _cutil_Set_retain_generic(dst, src, true);
+    }
+    if (op == CUTIL_SET_OP_DIFFERENCE && dst_count <= src_count) {
+        return _cutil_Set_retain_generic(dst, src, false);
+    }
+    if (op != CUTIL_SET_OP_DIFFERENCE && dst->vtable->reserve != NULL) {
+        /* Size for the largest possible result; a failure is not fatal */
+        (void) dst->vtable->reserve(dst->data, dst_count + src_count);
+    }
+
+    cutil_ConstIterator *const it = cutil_Set_get_const_iterator(src);
+    CUTIL_RETURN_VAL_IF_NULL(it, CUTIL_STATUS_FAILURE);
+    cutil_Status status = CUTIL_STATUS_SUCCESS;
+    while (status == CUTIL_STATUS_SUCCESS && cutil_ConstIterator_next(it)) {
+        const void *const p = cutil_ConstIterator_get_ptr(it);
+        if (op == CUTIL_SET_OP_DIFFERENCE) {
+            if (cutil_Set_contains(dst, p)) {
+                status = cutil_Set_remove(dst, p);
+            }
+            continue;
+        }
+        cutil_Bool inserted = false;
+        status = cutil_Set_insert_if_absent(dst, p, &inserted);
+        if (status == CUTIL_STATUS_SUCCESS && !inserted
+            && op == CUTIL_SET_OP_SYMDIFF) {
+            status = cutil_Set_remove(dst, p);
+        }
+    }
+    cutil_ConstIterator_free(it);
+    return status;
+}
+
+cutil_Status
+cutil_Set_combine(cutil_Set *dst, const cutil_Set *src, cutil_SetOp op)
+{
+    CUTIL_RETURN_VAL_IF_NULL(dst, CUTIL_STATUS_FAILURE);
+    CUTIL_RETURN_VAL_IF_NULL(src, CUTIL_STATUS_FAILURE);
+    CUTIL_NULL_CHECK(dst->vtable);
+    CUTIL_NULL_CHECK(src->vtable);
+    if (!_cutil_Set_are_combinable(dst, src)) {
+        return CUTIL_STATUS_FAILURE;
+    }
+    if (dst == src) {
+        if (op == CUTIL_SET_OP_DIFFERENCE || op == CUTIL_SET_OP_SYMDIFF) {
+            cutil_Set_reset(dst);
+        }
+        return CUTIL_STATUS_SUCCESS;
+    }
+    if (!cutil_SetType_equals(dst->vtable, src->vtable)
+        || dst->vtable->combine == NULL) {
+        return _cutil_Set_combine_generic(dst, src, op);
+    }
+
+    if (dst->vtable->combine_new != NULL
+        && _cutil_Set_walks_larger(dst, src, op)) {
+        void *const data = dst->vtable->combine_new(dst->data, src->data, op);
+        CUTIL_RETURN_VAL_IF_NULL(data, CUTIL_STATUS_FAILURE);
+        dst->vtable->free(dst->data);
+        dst->data = data;
+        return CUTIL_STATUS_SUCCESS;
+    }
+    return dst->vtable->combine(dst->data, src->data, op);
+}
+
+cutil_Set *
+cutil_Set_combine_new(
+  const cutil_Set *lhs, const cutil_Set *rhs, cutil_SetOp op
+)
+{
+    CUTIL_RETURN_NULL_IF_NULL(lhs);
+    CUTIL_RETURN_NULL_IF_NULL(rhs);
+    CUTIL_NULL_CHECK(lhs->vtable);
+    CUTIL_NULL_CHECK(rhs->vtable);
+    if (!_cutil_Set_are_combinable(lhs, rhs)) {
+        return NULL;
+    }
+
+    if (cutil_SetType_equals(lhs->vtable, rhs->vtable)
+        && lhs->vtable->combine_new != NULL) {
+        void *const data = lhs->vtable->combine_new(lhs->data, rhs->data, op);
+        CUTIL_RETURN_NULL_IF_NULL(data);
+        cutil_Set *const set = CUTIL_MALLOC_OBJECT(set);
+        set->vtable = lhs->vtable;
+        set->data = data;
+        return set;
+    }
+
+    cutil_Set *const set = cutil_Set_duplicate(lhs);
+    CUTIL_RETURN_NULL_IF_NULL(set);
+    if (cutil_Set_combine(set, rhs, op) != CUTIL_STATUS_SUCCESS) {
+        cutil_Set_free(set);
+        return NULL;
+    }
+    return set;
+}
+
+extern inline cutil_Status
+cutil_Set_union(cutil_Set *dst, const cutil_Set *src);
+
+extern inline cutil_Status
+cutil_Set_intersect(cutil_Set *dst, const cutil_Set *src);
+
+extern inline cutil_Status
+cutil_Set_difference(cutil_Set *dst, const cutil_Set *src);
+
+extern inline cutil_Status
+cutil_Set_symdiff(cutil_Set *dst, const cutil_Set *src);
+
+extern inline cutil_Set *
+cutil_Set_union_new(const cutil_Set *lhs, const cutil_Set *rhs);
+
+extern inline cutil_Set *
+cutil_Set_intersect_new(const cutil_Set *lhs, const cutil_Set *rhs);
+
+extern inline cutil_Set *
+cutil_Set_difference_new(const cutil_Set *lhs, const cutil_Set *rhs);
+
+extern inline cutil_Set *
+cutil_Set_symdiff_new(const cutil_Set *lhs, const cutil_Set *rhs);
+
 cutil_Bool
 cutil_Set_deep_equals(const cutil_Set *lhs, const cutil_Set *rhs)
 {
@@ -101,6 +349,11 @@ cutil_Set_deep_equals_generic(const void *vlhs, const void *vrhs)
     if (cutil_Set_get_count(lhs) != cutil_Set_get_count(rhs)) {
         return false;
     }
+    /* Maintained content hashes reject most unequal sets without iterating */
+    if (lhs->vtable->hash != NULL
+        && lhs->vtable->hash(lhs->data) != rhs->vtable->hash(rhs->data)) {
+        return false;
+    }
     cutil_Bool result = true;
     cutil_ConstIterator *const it = cutil_Set_get_const_iterator(lhs);
     while (cutil_ConstIterator_next(it)) {
@@ -149,6 +402,9 @@ cutil_Set_hash_generic(const void *vset)
     if (set == NULL || cutil_Set_get_count(set) == 0UL) {
         return CUTIL_HASH_C(0);
     }
+    if (set->vtable->hash != NULL) {
+        return set->vtable->hash(set->data);
+    }
     const cutil_GenericType *const type = cutil_Set_get_elem_type(set);
     cutil_ConstIterator *const it = cutil_Set_get_const_iterator(set);
     cutil_hash_t res = CUTIL_HASH_C(0);
@@ -0,0 +1,665 @@
+#include <cutil/data/generic/set/bitset.h>
+
+#include <limits.h>
+
+#include <cutil/cutil.h>
+#include <cutil/io/log.h>
+#include <cutil/status.h>
+#include <cutil/std/inttypes.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/util/bits.h>
+#include <cutil/util/macro.h>
+
+#define BITSET_WORD_BITS ((size_t) 64)
+#define BITSET_MIN_WORDS ((size_t) 1)
+#define BITSET_EXPAND_FACTOR ((size_t) 2)
+/* Bound of sets allocated without one, taking up to 2 MiB of words */
+#define BITSET_DEFAULT_BOUND (UINT64_C(1) << 24)
+
+typedef struct {
+    const cutil_GenericType *elem_type;
+    uint64_t bound; /**< elements have to be smaller */
+    size_t num_words;
+    uint64_t *words; /**< bit `i % 64` of word `i / 64` is set if `i` is */
+} _cutil_BitSet;
+
+/**
+ * Storage for an element of any of the supported element types, so that
+ * iterators can hand out pointers to elements.
+ */
+typedef union {
+    uint8_t u8;
+    uint16_t u16;
+    uint32_t u32;
+    uint64_t u64;
+} _cutil_BitSetElem;
+
+/**
+ * Returns whether `type` is an unsigned integer type that fits into 64 bits.
+ */
+static cutil_Bool
+_cutil_BitSet_is_valid_elem_type(const cutil_GenericType *type)
+{
+    const cutil_GenericType *const valid_types[] = {
+      CUTIL_GENERIC_TYPE_UCHAR,  CUTIL_GENERIC_TYPE_USHORT,
+      CUTIL_GENERIC_TYPE_UINT,   CUTIL_GENERIC_TYPE_ULONG,
+      CUTIL_GENERIC_TYPE_ULLONG, CUTIL_GENERIC_TYPE_U8,
+      CUTIL_GENERIC_TYPE_U16,    CUTIL_GENERIC_TYPE_U32,
+      CUTIL_GENERIC_TYPE_U64,    CUTIL_GENERIC_TYPE_SIZET,
+    };
+    CUTIL_RETURN_VAL_IF_NULL(type, false);
+    for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(valid_types); ++i) {
+        if (cutil_GenericType_equals(type, valid_types[i])) {
+            return CUTIL_BOOLIFY(type->size <= sizeof(uint64_t));
+        }
+    }
+    return false;
+}
+
+static uint64_t
+_cutil_BitSet_load_elem(const _cutil_BitSet *bitset, const void *elem)
+{
+    _cutil_BitSetElem val;
+    switch (bitset->elem_type->size) {
+    case sizeof(uint8_t):
+        memcpy(&val.u8, elem, sizeof val.u8);
+        return val.u8;
+    case sizeof(uint16_t):
+        memcpy(&val.u16, elem, sizeof val.u16);
+        return val.u16;
+    case sizeof(uint32_t):
+        memcpy(&val.u32, elem, sizeof val.u32);
+        return val.u32;
+    default:
+        memcpy(&val.u64, elem, sizeof val.u64);
+        return val.u64;
+    }
+}
+
+static void
+_cutil_BitSet_store_elem(
+  const _cutil_BitSet *bitset, uint64_t val, _cutil_BitSetElem *elem
+)
+{
+    switch (bitset->elem_type->size) {
+    case sizeof(uint8_t):
+        elem->u8 = (uint8_t) val;
+        break;
+    case sizeof(uint16_t):
+        elem->u16 = (uint16_t) val;
+        break;
+    case sizeof(uint32_t):
+        elem->u32 = (uint32_t) val;
+        break;
+    default:
+        elem->u64 = val;
+        break;
+    }
+}
+
+static inline uint64_t
+_cutil_BitSet_get_mask(uint64_t val)
+{
+    return UINT64_C(1) << (val % BITSET_WORD_BITS);
+}
+
+static inline cutil_Bool
+_cutil_BitSet_test(const _cutil_BitSet *bitset, uint64_t val)
+{
+    const uint64_t word = val / BITSET_WORD_BITS;
+    if (word >= bitset->num_words) {
+        return false;
+    }
+    return CUTIL_BOOLIFY(bitset->words[word] & _cutil_BitSet_get_mask(val));
+}
+
+/**
+ * Returns number of words that hold all elements smaller than `bound`.
+ */
+static inline uint64_t
+_cutil_BitSet_get_num_words(uint64_t bound)
+{
+    return bound / BITSET_WORD_BITS + CUTIL_BOOLIFY(bound % BITSET_WORD_BITS);
+}
+
+/**
+ * Resizes the word vector of `bitset` to `num_words` words. New words are
+ * cleared. On failure, the vector is left unchanged.
+ */
+static cutil_Status
+_cutil_BitSet_resize(_cutil_BitSet *bitset, size_t num_words)
+{
+    CUTIL_RETURN_VAL_IF_VAL(
+      bitset->num_words, num_words, CUTIL_STATUS_SUCCESS
+    );
+    if (num_words == 0UL) {
+        free(bitset->words);
+        bitset->words = NULL;
+        bitset->num_words = 0UL;
+        return CUTIL_STATUS_SUCCESS;
+    }
+    uint64_t *const words = CUTIL_REALLOC_MULT(bitset->words, num_words);
+    if (words == NULL) {
+        cutil_log_warn("BitSet: cannot allocate %zu words", num_words);
+        return CUTIL_STATUS_FAILURE;
+    }
+    bitset->words = words;
+    if (num_words > bitset->num_words) {
+        memset(
+          bitset->words + bitset->num_words, 0,
+          (num_words - bitset->num_words) * sizeof *bitset->words
+        );
+    }
+    bitset->num_words = num_words;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+/**
+ * Grows the word vector of `bitset` so that it holds all elements smaller than
+ * `bound`, at least doubling it to amortize consecutive additions, but never
+ * beyond the bound of the set.
+ */
+static cutil_Status
+_cutil_BitSet_grow_to(_cutil_BitSet *bitset, uint64_t bound)
+{
+    if (bound > bitset->bound) {
+        cutil_log_warn(
+          "BitSet: %" PRIu64 " elements exceed bound %" PRIu64, bound,
+          bitset->bound
+        );
+        return CUTIL_STATUS_FAILURE;
+    }
+    const size_t num_words = (size_t) _cutil_BitSet_get_num_words(bound);
+    if (num_words <= bitset->num_words) {
+        return CUTIL_STATUS_SUCCESS;
+    }
+    const size_t max_words
+      = (size_t) _cutil_BitSet_get_num_words(bitset->bound);
+    const size_t expanded = bitset->num_words * BITSET_EXPAND_FACTOR;
+    const size_t capacity = CUTIL_MAX(num_words, expanded);
+    return _cutil_BitSet_resize(
+      bitset, CUTIL_MIN(CUTIL_MAX(capacity, BITSET_MIN_WORDS), max_words)
+    );
+}
+
+/**
+ * Returns exclusive upper bound of the values of `elem_type`.
+ */
+static inline uint64_t
+_cutil_BitSet_get_type_bound(const cutil_GenericType *elem_type)
+{
+    if (elem_type->size >= sizeof(uint64_t)) {
+        return UINT64_MAX;
+    }
+    return UINT64_C(1) << (elem_type->size * CHAR_BIT);
+}
+
+/**
+ * Allocates an empty set whose elements have to be smaller than `bound`,
+ * which is lowered to the values `elem_type` can take. No words are allocated
+ * yet.
+ */
+static _cutil_BitSet *
+_cutil_BitSet_create(const cutil_GenericType *elem_type, uint64_t bound)
+{
+    if (!_cutil_BitSet_is_valid_elem_type(elem_type)) {
+        cutil_log_warn("BitSet: element type is not an unsigned integer type");
+        return NULL;
+    }
+    if (bound == 0U) {
+        cutil_log_warn("BitSet: bound must be positive");
+        return NULL;
+    }
+    bound = CUTIL_MIN(bound, _cutil_BitSet_get_type_bound(elem_type));
+    if (_cutil_BitSet_get_num_words(bound) > SIZE_MAX / sizeof(uint64_t)) {
+        cutil_log_warn("BitSet: bound %" PRIu64 " is too large", bound);
+        return NULL;
+    }
+    _cutil_BitSet *const bitset = CUTIL_MALLOC_OBJECT(bitset);
+    bitset->elem_type = elem_type;
+    bitset->bound = bound;
+    bitset->num_words = 0UL;
+    bitset->words = NULL;
+    return bitset;
+}
+
+static cutil_Set *
+_cutil_BitSet_wrap(_cutil_BitSet *bitset)
+{
+    cutil_Set *const set = CUTIL_MALLOC_OBJECT(set);
+    set->vtable = CUTIL_SET_TYPE_BITSET;
+    set->data = bitset;
+    return set;
+}
+
+cutil_Set *
+cutil_BitSet_alloc(const cutil_GenericType *elem_type)
+{
+    _cutil_BitSet *const bitset
+      = _cutil_BitSet_create(elem_type, BITSET_DEFAULT_BOUND);
+    CUTIL_RETURN_NULL_IF_NULL(bitset);
+    return _cutil_BitSet_wrap(bitset);
+}
+
+cutil_Set *
+cutil_BitSet_alloc_with_bound(const cutil_GenericType *elem_type, size_t bound)
+{
+    _cutil_BitSet *const bitset = _cutil_BitSet_create(elem_type, bound);
+    CUTIL_RETURN_NULL_IF_NULL(bitset);
+    if (_cutil_BitSet_grow_to(bitset, bitset->bound) != CUTIL_STATUS_SUCCESS) {
+        free(bitset);
+        return NULL;
+    }
+    return _cutil_BitSet_wrap(bitset);
+}
+
+size_t
+cutil_BitSet_get_bound(const cutil_Set *set)
+{
+    CUTIL_RETURN_VAL_IF_NULL(set, 0UL);
+    const _cutil_BitSet *const bitset = set->data;
+    return (size_t) CUTIL_MIN(bitset->bound, (uint64_t) SIZE_MAX);
+}
+
+size_t
+cutil_BitSet_get_capacity(const cutil_Set *set)
+{
+    CUTIL_RETURN_VAL_IF_NULL(set, 0UL);
+    const _cutil_BitSet *const bitset = set->data;
+    return bitset->num_words * BITSET_WORD_BITS;
+}
+
+static void
+_cutil_BitSet_free(void *data)
+{
+    _cutil_BitSet *const bitset = data;
+    CUTIL_RETURN_IF_NULL(bitset);
+    free(bitset->words);
+    free(bitset);
+}
+
+static void
+_cutil_BitSet_reset(void *data)
+{
+    _cutil_BitSet *const bitset = data;
+    CUTIL_RETURN_IF_VAL(bitset->num_words, 0UL);
+    memset(bitset->words, 0, bitset->num_words * sizeof *bitset->words);
+}
+
+static void
+_cutil_BitSet_copy(void *dst, const void *src)
+{
+    _cutil_BitSet *const dst_bitset = dst;
+    const _cutil_BitSet *const src_bitset = src;
+    CUTIL_RETURN_IF_VAL(dst_bitset, src_bitset);
+
+    if (_cutil_BitSet_resize(dst_bitset, src_bitset->num_words)
+        != CUTIL_STATUS_SUCCESS) {
+        return;
+    }
+    dst_bitset->bound = src_bitset->bound;
+    CUTIL_RETURN_IF_VAL(src_bitset->num_words, 0UL);
+    memcpy(
+      dst_bitset->words, src_bitset->words,
+      src_bitset->num_words * sizeof *src_bitset->words
+    );
+}
+
+static void *
+_cutil_BitSet_duplicate(const void *data)
+{
+    const _cutil_BitSet *const src = data;
+    _cutil_BitSet *const dst = _cutil_BitSet_create(src->elem_type, src->bound);
+    CUTIL_RETURN_NULL_IF_NULL(dst);
+    if (_cutil_BitSet_resize(dst, src->num_words) != CUTIL_STATUS_SUCCESS) {
+        free(dst);
+        return NULL;
+    }
+    _cutil_BitSet_copy(dst, src);
+    return dst;
+}
+
+static size_t
+_cutil_BitSet_get_count(const void *data)
+{
+    const _cutil_BitSet *const bitset = data;
+    size_t count = 0UL;
+    for (size_t i = 0; i < bitset->num_words; ++i) {
+        count += cutil_bits_popcount_u64(bitset->words[i]);
+    }
+    return count;
+}
+
+static cutil_Bool
+_cutil_BitSet_contains(const void *data, const void *elem)
+{
+    const _cutil_BitSet *const bitset = data;
+    return _cutil_BitSet_test(bitset, _cutil_BitSet_load_elem(bitset, elem));
+}
+
+static cutil_Status
+_cutil_BitSet_insert_if_absent(
+  void *data, const void *elem, cutil_Bool *inserted
+)
+{
+    _cutil_BitSet *const bitset = data;
+    const uint64_t val = _cutil_BitSet_load_elem(bitset, elem);
+    if (val >= bitset->bound) {
+        cutil_log_warn(
+          "BitSet: element %" PRIu64 " is not below bound %" PRIu64, val,
+          bitset->bound
+        );
+        return CUTIL_STATUS_FAILURE;
+    }
+    const cutil_Bool res = !_cutil_BitSet_test(bitset, val);
+    if (res) {
+        if (_cutil_BitSet_grow_to(bitset, val + 1U) != CUTIL_STATUS_SUCCESS) {
+            return CUTIL_STATUS_FAILURE;
+        }
+        bitset->words[val / BITSET_WORD_BITS] |= _cutil_BitSet_get_mask(val);
+    }
+    if (inserted != NULL) {
+        *inserted = res;
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_BitSet_add(void *data, const void *elem)
+{
+    cutil_Bool inserted = false;
+    const cutil_Status status
+      = _cutil_BitSet_insert_if_absent(data, elem, &inserted);
+    if (status == CUTIL_STATUS_SUCCESS && !inserted) {
+        cutil_log_warn("BitSet add: element already in set, skipping");
+    }
+    return status;
+}
+
+static cutil_Status
+_cutil_BitSet_remove(void *data, const void *elem)
+{
+    _cutil_BitSet *const bitset = data;
+    const uint64_t val = _cutil_BitSet_load_elem(bitset, elem);
+    if (!_cutil_BitSet_test(bitset, val)) {
+        cutil_log_warn("BitSet remove: element not found");
+        return CUTIL_STATUS_FAILURE;
+    }
+    bitset->words[val / BITSET_WORD_BITS] &= ~_cutil_BitSet_get_mask(val);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_BitSet_reserve(void *data, size_t count)
+{
+    return _cutil_BitSet_grow_to(data, count);
+}
+
+static cutil_Status
+_cutil_BitSet_shrink_to_fit(void *data)
+{
+    _cutil_BitSet *const bitset = data;
+    size_t num_words = bitset->num_words;
+    while (num_words > 0UL && bitset->words[num_words - 1UL] == 0U) {
+        --num_words;
+    }
+    return _cutil_BitSet_resize(bitset, num_words);
+}
+
+static const cutil_GenericType *
+_cutil_BitSet_get_elem_type(const void *data)
+{
+    const _cutil_BitSet *const bitset = data;
+    return bitset->elem_type;
+}
+
+/**
+ * Word-wise set operations. The loops are free of branches and aliasing, so
+ * that compilers vectorize them.
+ */
+
+static void
+_cutil_BitSet_or(
+  uint64_t *CUTIL_RESTRICT dst, const uint64_t *CUTIL_RESTRICT src, size_t num
+)
+{
+    for (size_t i = 0; i < num; ++i) {
+        dst[i] |= src[i];
+    }
+}
+
+static void
+_cutil_BitSet_and(
+  uint64_t *CUTIL_RESTRICT dst, const uint64_t *CUTIL_RESTRICT src, size_t num
+)
+{
+    for (size_t i = 0; i < num; ++i) {
+        dst[i] &= src[i];
+    }
+}
+
+static void
+_cutil_BitSet_and_not(
+  uint64_t *CUTIL_RESTRICT dst, const uint64_t *CUTIL_RESTRICT src, size_t num
+)
+{
+    for (size_t i = 0; i < num; ++i) {
+        dst[i] &= ~src[i];
+    }
+}
+
+static void
+_cutil_BitSet_xor(
+  uint64_t *CUTIL_RESTRICT dst, const uint64_t *CUTIL_RESTRICT src, size_t num
+)
+{
+    for (size_t i = 0; i < num; ++i) {
+        dst[i] ^= src[i];
+    }
+}
+
+static cutil_Status
+_cutil_BitSet_combine(void *dst, const void *src, cutil_SetOp op)
+{
+    _cutil_BitSet *const bitset = dst;
+    const _cutil_BitSet *const other = src;
+    const size_t num_common = CUTIL_MIN(bitset->num_words, other->num_words);
+
+    if (op == CUTIL_SET_OP_INTERSECTION) {
+        _cutil_BitSet_and(bitset->words, other->words, num_common);
+        if (bitset->num_words > num_common) {
+            memset(
+              bitset->words + num_common, 0,
+              (bitset->num_words - num_common) * sizeof *bitset->words
+            );
+        }
+        return CUTIL_STATUS_SUCCESS;
+    }
+    if (op == CUTIL_SET_OP_DIFFERENCE) {
+        _cutil_BitSet_and_not(bitset->words, other->words, num_common);
+        return CUTIL_STATUS_SUCCESS;
+    }
+
+    /* Only grow for words of `other` that hold elements */
+    size_t num_words = other->num_words;
+    while (num_words > 0UL && other->words[num_words - 1UL] == 0U) {
+        --num_words;
+    }
+    CUTIL_RETURN_VAL_IF_VAL(num_words, 0UL, CUTIL_STATUS_SUCCESS);
+    const uint64_t max_elem
+      = (uint64_t) num_words * BITSET_WORD_BITS - 1U
+      - cutil_bits_clz_u64(other->words[num_words - 1UL]);
+    if (max_elem >= bitset->bound) {
+        cutil_log_warn(
+          "BitSet: element %" PRIu64 " is not below bound %" PRIu64, max_elem,
+          bitset->bound
+        );
+        return CUTIL_STATUS_FAILURE;
+    }
+    if (num_words > bitset->num_words) {
+        const cutil_Status status = _cutil_BitSet_resize(bitset, num_words);
+        if (status != CUTIL_STATUS_SUCCESS) {
+            return status;
+        }
+    }
+    if (op == CUTIL_SET_OP_UNION) {
+        _cutil_BitSet_or(bitset->words, other->words, num_words);
+    } else {
+        _cutil_BitSet_xor(bitset->words, other->words, num_words);
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+typedef struct {
+    _cutil_BitSet *bitset;
+    size_t next_word;   /**< index of the next word to be scanned */
+    uint64_t rest;      /**< bits of the scanned word after the current one */
+    uint64_t val;       /**< current element */
+    cutil_Bool at_elem; /**< is there a current element? */
+    _cutil_BitSetElem elem;
+} _cutil_BitSetIter;
+
+static void
+_cutil_BitSetIter_free(void *data)
+{
+    free(data);
+}
+
+static void
+_cutil_BitSetIter_rewind(void *data)
+{
+    _cutil_BitSetIter *const iter = data;
+    iter->next_word = 0UL;
+    iter->rest = 0U;
+    iter->val = 0U;
+    iter->at_elem = false;
+}
+
+static cutil_Bool
+_cutil_BitSetIter_next(void *data)
+{
+    _cutil_BitSetIter *const iter = data;
+    const _cutil_BitSet *const bitset = iter->bitset;
+    while (iter->rest == 0U) {
+        if (iter->next_word >= bitset->num_words) {
+            iter->at_elem = false;
+            return false;
+        }
+        iter->rest = bitset->words[iter->next_word++];
+    }
+    const size_t bit = cutil_bits_ctz_u64(iter->rest);
+    iter->rest &= iter->rest - 1U;
+    iter->val = (uint64_t) (iter->next_word - 1UL) * BITSET_WORD_BITS + bit;
+    _cutil_BitSet_store_elem(bitset, iter->val, &iter->elem);
+    iter->at_elem = true;
+    return true;
+}
+
+static const void *
+_cutil_BitSetIter_get_ptr(const void *data)
+{
+    const _cutil_BitSetIter *const iter = data;
+    return iter->at_elem ? &iter->elem : NULL;
+}
+
+static cutil_Status
+_cutil_BitSetIter_get(const void *data, void *out)
+{
+    const _cutil_BitSetIter *const iter = data;
+    if (!iter->at_elem) {
+        return CUTIL_STATUS_FAILURE;
+    }
+    memcpy(out, &iter->elem, iter->bitset->elem_type->size);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_BitSetIter_remove(void *data)
+{
+    _cutil_BitSetIter *const iter = data;
+    _cutil_BitSet *const bitset = iter->bitset;
+    if (!iter->at_elem || !_cutil_BitSet_test(bitset, iter->val)) {
+        return CUTIL_STATUS_FAILURE;
+    }
+    bitset->words[iter->val / BITSET_WORD_BITS]
+      &= ~_cutil_BitSet_get_mask(iter->val);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static const cutil_ConstIteratorType CUTIL_CONST_ITERATOR_TYPE_BITSET_OBJECT = {
+  .name = "cutil_ConstIterator<cutil_BitSet>",
+  .free = &_cutil_BitSetIter_free,
+  .rewind = &_cutil_BitSetIter_rewind,
+  .next = &_cutil_BitSetIter_next,
+  .get = &_cutil_BitSetIter_get,
+  .get_ptr = &_cutil_BitSetIter_get_ptr,
+};
+
+const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_BITSET
+  = &CUTIL_CONST_ITERATOR_TYPE_BITSET_OBJECT;
+
+static const cutil_IteratorType CUTIL_ITERATOR_TYPE_BITSET_OBJECT = {
+  .name = "cutil_Iterator<cutil_BitSet>",
+  .free = &_cutil_BitSetIter_free,
+  .rewind = &_cutil_BitSetIter_rewind,
+  .next = &_cutil_BitSetIter_next,
+  .get = &_cutil_BitSetIter_get,
+  .get_ptr = &_cutil_BitSetIter_get_ptr,
+  .set = NULL,
+  .remove = &_cutil_BitSetIter_remove,
+};
+
+const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_BITSET
+  = &CUTIL_ITERATOR_TYPE_BITSET_OBJECT;
+
+static _cutil_BitSetIter *
+_cutil_BitSetIter_create(const _cutil_BitSet *bitset)
+{
+    _cutil_BitSetIter *const iter = CUTIL_MALLOC_OBJECT(iter);
+    iter->bitset = CUTIL_CONST_CAST(bitset);
+    _cutil_BitSetIter_rewind(iter);
+    return iter;
+}
+
+static cutil_ConstIterator *
+_cutil_BitSet_get_const_iterator(const void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+    cutil_ConstIterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_CONST_ITERATOR_TYPE_BITSET;
+    it->data = _cutil_BitSetIter_create(data);
+    return it;
+}
+
+static cutil_Iterator *
+_cutil_BitSet_get_iterator(void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+    cutil_Iterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_ITERATOR_TYPE_BITSET;
+    it->data = _cutil_BitSetIter_create(data);
+    return it;
+}
+
+static const cutil_SetType CUTIL_SET_TYPE_BITSET_OBJECT = {
+  .name = "cutil_BitSet",
+  .free = &_cutil_BitSet_free,
+  .reset = &_cutil_BitSet_reset,
+  .copy = &_cutil_BitSet_copy,
+  .duplicate = &_cutil_BitSet_duplicate,
+  .get_count = &_cutil_BitSet_get_count,
+  .contains = &_cutil_BitSet_contains,
+  .add = &_cutil_BitSet_add,
+  .insert_if_absent = &_cutil_BitSet_insert_if_absent,
+  .remove = &_cutil_BitSet_remove,
+  .reserve = &_cutil_BitSet_reserve,
+  .shrink_to_fit = &_cutil_BitSet_shrink_to_fit,
+  .get_elem_type = &_cutil_BitSet_get_elem_type,
+  .get_const_iterator = &_cutil_BitSet_get_const_iterator,
+  .get_iterator = &_cutil_BitSet_get_iterator,
+  .combine = &_cutil_BitSet_combine,
+};
+
+const cutil_SetType *const CUTIL_SET_TYPE_BITSET
+  = &CUTIL_SET_TYPE_BITSET_OBJECT;
@@ -0,0 +1,2061 @@
+#include <cutil/data/generic/set/roaringset.h>
+
+#include <cutil/cutil.h>
+#include <cutil/io/log.h>
+#include <cutil/status.h>
+#include <cutil/std/inttypes.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/util/bits.h>
+#include <cutil/util/macro.h>
+
+/*
+ * Intersections of array containers compare a block of eight values of either
+ * operand against each other at once where SSE2 is available.
+ *
+ * Define CUTIL_DISABLE_SIMD to force the portable implementation.
+ */
+#if !defined(CUTIL_DISABLE_SIMD)                                               \
+  && (defined(__SSE2__) || defined(_M_X64)                                     \
+      || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define ROARING_INTERSECT_SSE2
+    #include <emmintrin.h>
+#endif
+
+#define ROARING_CHUNK_BITS 16
+#define ROARING_WORD_BITS ((uint32_t) 64)
+#define ROARING_BITMAP_WORDS ((uint32_t) 1024)
+#define ROARING_MAX_ARRAY_CARDINALITY ((uint32_t) 4096)
+#define ROARING_MIN_ARRAY_CAPACITY ((uint32_t) 4)
+#define ROARING_MAX_RUNS ((uint32_t) 32768)
+#define ROARING_MAX_CONTAINERS ((size_t) 65536)
+#define ROARING_EXPAND_FACTOR ((uint32_t) 2)
+
+/* Gallop through the longer array if it is this many times longer */
+#define ROARING_GALLOP_RATIO ((uint32_t) 32)
+
+/* Sizes of containers as serialized, which are also their sizes in memory */
+#define ROARING_ARRAY_BYTES(CARD) ((size_t) (CARD) * sizeof(uint16_t))
+#define ROARING_BITMAP_BYTES                                                   \
+    ((size_t) ROARING_BITMAP_WORDS * sizeof(uint64_t))
+#define ROARING_RUN_BYTES(NUM_RUNS)                                            \
+    (sizeof(uint16_t) + (size_t) (NUM_RUNS) * 2U * sizeof(uint16_t))
+
+#define ROARING_SERIAL_COOKIE_NO_RUNS ((uint32_t) 12346)
+#define ROARING_SERIAL_COOKIE ((uint32_t) 12347)
+#define ROARING_NO_OFFSET_THRESHOLD ((size_t) 4)
+
+typedef enum {
+    ROARING_ARRAY,
+    ROARING_BITMAP,
+    ROARING_RUN,
+} _cutil_RoaringKind;
+
+typedef struct {
+    uint16_t start;
+    uint16_t length; /**< the run holds `start` through `start + length` */
+} _cutil_RoaringRun;
+
+/**
+ * Lower 16 bits of the elements of a chunk. Array containers hold at most
+ * 4096 elements and bitmap containers more, while run containers hold any
+ * number of elements.
+ */
+typedef struct {
+    _cutil_RoaringKind kind;
+    uint32_t cardinality;
+    uint32_t size;     /**< number of values (arrays) or runs (runs) */
+    uint32_t capacity; /**< allocated values or runs, unused for bitmaps */
+    union {
+        uint16_t *values; /**< sorted values of array containers */
+        uint64_t *words;  /**< bits of bitmap containers */
+        _cutil_RoaringRun *runs; /**< sorted, disjoint runs of run containers */
+    } data;
+} _cutil_RoaringContainer;
+
+typedef struct {
+    size_t num_containers;
+    size_t capacity;
+    uint16_t *keys; /**< sorted upper 16 bits of the elements of containers */
+    _cutil_RoaringContainer *containers; /**< non-empty containers */
+} _cutil_RoaringSet;
+
+static inline uint16_t
+_cutil_Roaring_high(uint32_t val)
+{
+    return (uint16_t) (val >> ROARING_CHUNK_BITS);
+}
+
+static inline uint16_t
+_cutil_Roaring_low(uint32_t val)
+{
+    return (uint16_t) (val & UINT32_C(0xFFFF));
+}
+
+static inline uint32_t
+_cutil_Roaring_run_end(const _cutil_RoaringRun *run)
+{
+    return (uint32_t) run->start + run->length;
+}
+
+/**
+ * Returns index of the first of the `num` sorted `vals` not smaller than `val`.
+ */
+static uint32_t
+_cutil_Roaring_lower_bound(const uint16_t *vals, uint32_t num, uint16_t val)
+{
+    uint32_t lo = 0U;
+    uint32_t hi = num;
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2U;
+        if (vals[mid] < val) {
+            lo = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * Returns number of the `num` sorted `runs` that start at or before `val`.
+ */
+static uint32_t
+_cutil_Roaring_runs_upper_bound(
+  const _cutil_RoaringRun *runs, uint32_t num, uint16_t val
+)
+{
+    uint32_t lo = 0U;
+    uint32_t hi = num;
+    while (lo < hi) {
+        const uint32_t mid = lo + (hi - lo) / 2U;
+        if (runs[mid].start <= val) {
+            lo = mid + 1U;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static inline cutil_Bool
+_cutil_Roaring_bitmap_test(const uint64_t *words, uint16_t val)
+{
+    const uint64_t mask = UINT64_C(1) << (val % ROARING_WORD_BITS);
+    return CUTIL_BOOLIFY(words[val / ROARING_WORD_BITS] & mask);
+}
+
+/**
+ * Sets bits `first` through `last` of the bitmap `words`.
+ */
+static void
+_cutil_Roaring_bitmap_set_range(uint64_t *words, uint32_t first, uint32_t last)
+{
+    const uint32_t first_word = first / ROARING_WORD_BITS;
+    const uint32_t last_word = last / ROARING_WORD_BITS;
+    const uint64_t first_mask = UINT64_MAX << (first % ROARING_WORD_BITS);
+    const uint64_t last_mask
+      = UINT64_MAX >> (ROARING_WORD_BITS - 1U - last % ROARING_WORD_BITS);
+    if (first_word == last_word) {
+        words[first_word] |= first_mask & last_mask;
+        return;
+    }
+    words[first_word] |= first_mask;
+    for (uint32_t i = first_word + 1U; i < last_word; ++i) {
+        words[i] = UINT64_MAX;
+    }
+    words[last_word] |= last_mask;
+}
+
+static uint32_t
+_cutil_Roaring_bitmap_count(const uint64_t *words)
+{
+    uint32_t count = 0U;
+    for (uint32_t i = 0U; i < ROARING_BITMAP_WORDS; ++i) {
+        count += cutil_bits_popcount_u64(words[i]);
+    }
+    return count;
+}
+
+/**
+ * Appends `val` to the `num` sorted `runs`, which have room for another run,
+ * extending the last run if `val` follows it.
+ */
+static void
+_cutil_Roaring_append_to_runs(
+  _cutil_RoaringRun *runs, uint32_t *num, uint16_t val
+)
+{
+    if (*num > 0U && _cutil_Roaring_run_end(&runs[*num - 1U]) + 1U == val) {
+        ++runs[*num - 1U].length;
+        return;
+    }
+    runs[*num].start = val;
+    runs[*num].length = 0U;
+    ++*num;
+}
+
+static void
+_cutil_RoaringContainer_init_array(
+  _cutil_RoaringContainer *container, uint32_t capacity
+)
+{
+    container->kind = ROARING_ARRAY;
+    container->cardinality = 0U;
+    container->size = 0U;
+    container->capacity = capacity;
+    container->data.values
+      = capacity == 0U ? NULL
+                       : CUTIL_MALLOC_MULT(container->data.values, capacity);
+}
+
+static void
+_cutil_RoaringContainer_init_bitmap(_cutil_RoaringContainer *container)
+{
+    container->kind = ROARING_BITMAP;
+    container->cardinality = 0U;
+    container->size = 0U;
+    container->capacity = 0U;
+    container->data.words
+      = CUTIL_CALLOC_MULT(container->data.words, ROARING_BITMAP_WORDS);
+}
+
+static void
+_cutil_RoaringContainer_init_runs(
+  _cutil_RoaringContainer *container, uint32_t capacity
+)
+{
+    container->kind = ROARING_RUN;
+    container->cardinality = 0U;
+    container->size = 0U;
+    container->capacity = capacity;
+    container->data.runs
+      = capacity == 0U ? NULL
+                       : CUTIL_MALLOC_MULT(container->data.runs, capacity);
+}
+
+static void
+_cutil_RoaringContainer_free(_cutil_RoaringContainer *container)
+{
+    switch (container->kind) {
+    case ROARING_ARRAY:
+        free(container->data.values);
+        break;
+    case ROARING_BITMAP:
+        free(container->data.words);
+        break;
+    default:
+        free(container->data.runs);
+        break;
+    }
+}
+
+/**
+ * Initializes `dst` to a copy of `src` without spare capacity.
+ */
+static void
+_cutil_RoaringContainer_copy(
+  _cutil_RoaringContainer *dst, const _cutil_RoaringContainer *src
+)
+{
+    switch (src->kind) {
+    case ROARING_ARRAY:
+        _cutil_RoaringContainer_init_array(dst, src->size);
+        if (src->size > 0U) {
+            memcpy(
+              dst->data.values, src->data.values,
+              ROARING_ARRAY_BYTES(src->size)
+            );
+        }
+        break;
+    case ROARING_BITMAP:
+        _cutil_RoaringContainer_init_bitmap(dst);
+        memcpy(dst->data.words, src->data.words, ROARING_BITMAP_BYTES);
+        break;
+    default:
+        _cutil_RoaringContainer_init_runs(dst, src->size);
+        if (src->size > 0U) {
+            memcpy(
+              dst->data.runs, src->data.runs, src->size * sizeof *src->data.runs
+            );
+        }
+        break;
+    }
+    dst->size = src->size;
+    dst->cardinality = src->cardinality;
+}
+
+static void
+_cutil_RoaringContainer_reserve_array(
+  _cutil_RoaringContainer *container, uint32_t num
+)
+{
+    if (num <= container->capacity) {
+        return;
+    }
+    const uint32_t expanded = CUTIL_MAX(
+      container->capacity * ROARING_EXPAND_FACTOR, ROARING_MIN_ARRAY_CAPACITY
+    );
+    const uint32_t capacity
+      = CUTIL_MIN(CUTIL_MAX(expanded, num), ROARING_MAX_ARRAY_CARDINALITY);
+    container->data.values
+      = CUTIL_REALLOC_MULT(container->data.values, capacity);
+    container->capacity = capacity;
+}
+
+static void
+_cutil_RoaringContainer_reserve_runs(
+  _cutil_RoaringContainer *container, uint32_t num
+)
+{
+    if (num <= container->capacity) {
+        return;
+    }
+    const uint32_t expanded = CUTIL_MAX(
+      container->capacity * ROARING_EXPAND_FACTOR, ROARING_MIN_ARRAY_CAPACITY
+    );
+    const uint32_t capacity
+      = CUTIL_MIN(CUTIL_MAX(expanded, num), ROARING_MAX_RUNS);
+    container->data.runs = CUTIL_REALLOC_MULT(container->data.runs, capacity);
+    container->capacity = capacity;
+}
+
+static void
+_cutil_RoaringContainer_shrink_to_fit(_cutil_RoaringContainer *container)
+{
+    CUTIL_RETURN_IF_VAL(container->size, container->capacity);
+    if (container->kind == ROARING_ARRAY) {
+        container->data.values
+          = CUTIL_REALLOC_MULT(container->data.values, container->size);
+    } else if (container->kind == ROARING_RUN) {
+        container->data.runs
+          = CUTIL_REALLOC_MULT(container->data.runs, container->size);
+    } else {
+        return;
+    }
+    container->capacity = container->size;
+}
+
+/**
+ * Converts the array or run container `container` to a bitmap container.
+ */
+static void
+_cutil_RoaringContainer_to_bitmap(_cutil_RoaringContainer *container)
+{
+    uint64_t *const words = CUTIL_CALLOC_MULT(words, ROARING_BITMAP_WORDS);
+    if (container->kind == ROARING_ARRAY) {
+        for (uint32_t i = 0U; i < container->size; ++i) {
+            const uint16_t val = container->data.values[i];
+            words[val / ROARING_WORD_BITS]
+              |= UINT64_C(1) << (val % ROARING_WORD_BITS);
+        }
+    } else {
+        for (uint32_t i = 0U; i < container->size; ++i) {
+            const _cutil_RoaringRun *const run = &container->data.runs[i];
+            _cutil_Roaring_bitmap_set_range(
+              words, run->start, _cutil_Roaring_run_end(run)
+            );
+        }
+    }
+    _cutil_RoaringContainer_free(container);
+    container->kind = ROARING_BITMAP;
+    container->size = 0U;
+    container->capacity = 0U;
+    container->data.words = words;
+}
+
+/**
+ * Converts the bitmap or run container `container`, which holds at most 4096
+ * elements, to an array container.
+ */
+static void
+_cutil_RoaringContainer_to_array(_cutil_RoaringContainer *container)
+{
+    const uint32_t cardinality = container->cardinality;
+    uint16_t *const values
+      = cardinality == 0U ? NULL : CUTIL_MALLOC_MULT(values, cardinality);
+    uint32_t num = 0U;
+    if (container->kind == ROARING_BITMAP) {
+        for (uint32_t i = 0U; i < ROARING_BITMAP_WORDS; ++i) {
+            uint64_t word = container->data.words[i];
+            while (word != 0U) {
+                values[num++] = (uint16_t) (i * ROARING_WORD_BITS
+                                            + cutil_bits_ctz_u64(word));
+                word &= word - 1U;
+            }
+        }
+    } else {
+        for (uint32_t i = 0U; i < container->size; ++i) {
+            const _cutil_RoaringRun *const run = &container->data.runs[i];
+            for (uint32_t val = run->start; val <= _cutil_Roaring_run_end(run);
+                 ++val) {
+                values[num++] = (uint16_t) val;
+            }
+        }
+    }
+    _cutil_RoaringContainer_free(container);
+    container->kind = ROARING_ARRAY;
+    container->size = num;
+    container->capacity = cardinality;
+    container->data.values = values;
+}
+
+/**
+ * Converts the array or bitmap container `container` to a run container with
+ * `num_runs` runs.
+ */
+static void
+_cutil_RoaringContainer_to_runs(
+  _cutil_RoaringContainer *container, uint32_t num_runs
+)
+{
+    _cutil_RoaringRun *const runs = CUTIL_MALLOC_MULT(runs, num_runs);
+    uint32_t num = 0U;
+    if (container->kind == ROARING_ARRAY) {
+        for (uint32_t i = 0U; i < container->size; ++i) {
+            _cutil_Roaring_append_to_runs(
+              runs, &num, container->data.values[i]
+            );
+        }
+    } else {
+        for (uint32_t i = 0U; i < ROARING_BITMAP_WORDS; ++i) {
+            uint64_t word = container->data.words[i];
+            while (word != 0U) {
+                const uint32_t val
+                  = i * ROARING_WORD_BITS + cutil_bits_ctz_u64(word);
+                _cutil_Roaring_append_to_runs(runs, &num, (uint16_t) val);
+                word &= word - 1U;
+            }
+        }
+    }
+    _cutil_RoaringContainer_free(container);
+    container->kind = ROARING_RUN;
+    container->size = num;
+    container->capacity = num_runs;
+    container->data.runs = runs;
+}
+
+/**
+ * Converts the run container `container` to an array or bitmap container,
+ * depending on its cardinality.
+ */
+static void
+_cutil_RoaringContainer_from_runs(_cutil_RoaringContainer *container)
+{
+    if (container->cardinality <= ROARING_MAX_ARRAY_CARDINALITY) {
+        _cutil_RoaringContainer_to_array(container);
+    } else {
+        _cutil_RoaringContainer_to_bitmap(container);
+    }
+}
+
+/**
+ * Converts the run container `container` to an array or bitmap container if
+ * its runs outgrew it.
+ */
+static void
+_cutil_RoaringContainer_check_runs(_cutil_RoaringContainer *container)
+{
+    const size_t other_bytes
+      = container->cardinality <= ROARING_MAX_ARRAY_CARDINALITY
+        ? ROARING_ARRAY_BYTES(container->cardinality)
+        : ROARING_BITMAP_BYTES;
+    if (ROARING_RUN_BYTES(container->size) > other_bytes) {
+        _cutil_RoaringContainer_from_runs(container);
+    }
+}
+
+static uint32_t
+_cutil_RoaringContainer_count_runs(const _cutil_RoaringContainer *container)
+{
+    uint32_t num = 0U;
+    if (container->kind == ROARING_ARRAY) {
+        const uint16_t *const values = container->data.values;
+        for (uint32_t i = 0U; i < container->size; ++i) {
+            num += CUTIL_BOOLIFY(i == 0U || values[i] != values[i - 1U] + 1U);
+        }
+    } else if (container->kind == ROARING_BITMAP) {
+        uint64_t carry = 0U;
+        for (uint32_t i = 0U; i < ROARING_BITMAP_WORDS; ++i) {
+            const uint64_t word = container->data.words[i];
+            num += cutil_bits_popcount_u64(word & ~((word << 1U) | carry));
+            carry = word >> (ROARING_WORD_BITS - 1U);
+        }
+    } else {
+        num = container->size;
+    }
+    return num;
+}
+
+static void
+_cutil_RoaringContainer_run_optimize(_cutil_RoaringContainer *container)
+{
+    if (container->kind == ROARING_RUN) {
+        _cutil_RoaringContainer_check_runs(container);
+        return;
+    }
+    const uint32_t num_runs = _cutil_RoaringContainer_count_runs(container);
+    const size_t bytes = container->kind == ROARING_ARRAY
+                         ? ROARING_ARRAY_BYTES(container->cardinality)
+                         : ROARING_BITMAP_BYTES;
+    if (ROARING_RUN_BYTES(num_runs) < bytes) {
+        _cutil_RoaringContainer_to_runs(container, num_runs);
+    }
+}
+
+static cutil_Bool
+_cutil_RoaringContainer_contains(
+  const _cutil_RoaringContainer *container, uint16_t val
+)
+{
+    switch (container->kind) {
+    case ROARING_ARRAY: {
+        const uint32_t idx = _cutil_Roaring_lower_bound(
+          container->data.values, container->size, val
+        );
+        return CUTIL_BOOLIFY(
+          idx < container->size && container->data.values[idx] == val
+        );
+    }
+    case ROARING_BITMAP:
+        return _cutil_Roaring_bitmap_test(container->data.words, val);
+    default: {
+        const _cutil_RoaringRun *const runs = container->data.runs;
+        const uint32_t idx
+          = _cutil_Roaring_runs_upper_bound(runs, container->size, val);
+        return CUTIL_BOOLIFY(
+          idx > 0U && val <= _cutil_Roaring_run_end(&runs[idx - 1U])
+        );
+    }
+    }
+}
+
+static cutil_Bool
+_cutil_RoaringContainer_add_to_runs(
+  _cutil_RoaringContainer *container, uint16_t val
+)
+{
+    _cutil_RoaringRun *runs = container->data.runs;
+    const uint32_t idx
+      = _cutil_Roaring_runs_upper_bound(runs, container->size, val);
+    if (idx > 0U && val <= _cutil_Roaring_run_end(&runs[idx - 1U])) {
+        return false;
+    }
+    const cutil_Bool extends_prev
+      = idx > 0U && _cutil_Roaring_run_end(&runs[idx - 1U]) + 1U == val;
+    const cutil_Bool extends_next
+      = idx < container->size && (uint32_t) val + 1U == runs[idx].start;
+    if (extends_prev && extends_next) {
+        runs[idx - 1U].length
+          = (uint16_t) (runs[idx - 1U].length + runs[idx].length + 2U);
+        memmove(
+          runs + idx, runs + idx + 1U,
+          (container->size - idx - 1U) * sizeof *runs
+        );
+        --container->size;
+    } else if (extends_prev) {
+        ++runs[idx - 1U].length;
+    } else if (extends_next) {
+        --runs[idx].start;
+        ++runs[idx].length;
+    } else {
+        _cutil_RoaringContainer_reserve_runs(container, container->size + 1U);
+        runs = container->data.runs;
+        memmove(
+          runs + idx + 1U, runs + idx, (container->size - idx) * sizeof *runs
+        );
+        runs[idx].start = val;
+        runs[idx].length = 0U;
+        ++container->size;
+    }
+    ++container->cardinality;
+    return true;
+}
+
+static cutil_Bool
+_cutil_RoaringContainer_remove_from_runs(
+  _cutil_RoaringContainer *container, uint16_t val
+)
+{
+    _cutil_RoaringRun *runs = container->data.runs;
+    const uint32_t idx
+      = _cutil_Roaring_runs_upper_bound(runs, container->size, val);
+    if (idx == 0U || val > _cutil_Roaring_run_end(&runs[idx - 1U])) {
+        return false;
+    }
+    const _cutil_RoaringRun run = runs[idx - 1U];
+    const uint32_t end = _cutil_Roaring_run_end(&run);
+    if (run.length == 0U) {
+        memmove(
+          runs + idx - 1U, runs + idx, (container->size - idx) * sizeof *runs
+        );
+        --container->size;
+    } else if (val == run.start) {
+        ++runs[idx - 1U].start;
+        --runs[idx - 1U].length;
+    } else if (val == end) {
+        --runs[idx - 1U].length;
+    } else {
+        /* Split the run around `val` */
+        _cutil_RoaringContainer_reserve_runs(container, container->size + 1U);
+        runs = container->data.runs;
+        memmove(
+          runs + idx + 1U, runs + idx, (container->size - idx) * sizeof *runs
+        );
+        runs[idx - 1U].length = (uint16_t) (val - run.start - 1U);
+        runs[idx].start = (uint16_t) (val + 1U);
+        runs[idx].length = (uint16_t) (end - val - 1U);
+        ++container->size;
+    }
+    --container->cardinality;
+    return true;
+}
+
+/**
+ * Adds `val` to `container`, converting it to a bitmap container if it is an
+ * array container that outgrows its kind.
+ *
+ * @return whether `val` was inserted
+ */
+static cutil_Bool
+_cutil_RoaringContainer_add(_cutil_RoaringContainer *container, uint16_t val)
+{
+    switch (container->kind) {
+    case ROARING_ARRAY: {
+        uint16_t *values = container->data.values;
+        const uint32_t idx
+          = _cutil_Roaring_lower_bound(values, container->size, val);
+        if (idx < container->size && values[idx] == val) {
+            return false;
+        }
+        if (container->size == ROARING_MAX_ARRAY_CARDINALITY) {
+            _cutil_RoaringContainer_to_bitmap(container);
+            return _cutil_RoaringContainer_add(container, val);
+        }
+        _cutil_RoaringContainer_reserve_array(container, container->size + 1U);
+        values = container->data.values;
+        memmove(
+          values + idx + 1U, values + idx,
+          ROARING_ARRAY_BYTES(container->size - idx)
+        );
+        values[idx] = val;
+        ++container->size;
+        ++container->cardinality;
+        return true;
+    }
+    case ROARING_BITMAP: {
+        uint64_t *const word = &container->data.words[val / ROARING_WORD_BITS];
+        const uint64_t mask = UINT64_C(1) << (val % ROARING_WORD_BITS);
+        if (*word & mask) {
+            return false;
+        }
+        *word |= mask;
+        ++container->cardinality;
+        return true;
+    }
+    default: {
+        const cutil_Bool added
+          = _cutil_RoaringContainer_add_to_runs(container, val);
+        _cutil_RoaringContainer_check_runs(container);
+        return added;
+    }
+    }
+}
+
+/**
+ * Removes `val` from `container`, converting it to an array container if it
+ * is a bitmap container that shrinks below its kind.
+ *
+ * @return whether `val` was removed
+ */
+static cutil_Bool
+_cutil_RoaringContainer_remove(_cutil_RoaringContainer *container, uint16_t val)
+{
+    switch (container->kind) {
+    case ROARING_ARRAY: {
+        uint16_t *const values = container->data.values;
+        const uint32_t idx
+          = _cutil_Roaring_lower_bound(values, container->size, val);
+        if (idx == container->size || values[idx] != val) {
+            return false;
+        }
+        memmove(
+          values + idx, values + idx + 1U,
+          ROARING_ARRAY_BYTES(container->size - idx - 1U)
+        );
+        --container->size;
+        --container->cardinality;
+        return true;
+    }
+    case ROARING_BITMAP: {
+        uint64_t *const word = &container->data.words[val / ROARING_WORD_BITS];
+        const uint64_t mask = UINT64_C(1) << (val % ROARING_WORD_BITS);
+        if (!(*word & mask)) {
+            return false;
+        }
+        *word &= ~mask;
+        if (--container->cardinality <= ROARING_MAX_ARRAY_CARDINALITY) {
+            _cutil_RoaringContainer_to_array(container);
+        }
+        return true;
+    }
+    default: {
+        const cutil_Bool removed
+          = _cutil_RoaringContainer_remove_from_runs(container, val);
+        _cutil_RoaringContainer_check_runs(container);
+        return removed;
+    }
+    }
+}
+
+/**
+ * Set operations on sorted arrays of values. All of them write to `out`,
+ * which has room for the largest possible result, and return the number of
+ * values written.
+ */
+
+static uint32_t
+_cutil_Roaring_intersect_scalar(
+  const uint16_t *a, uint32_t num_a, const uint16_t *b, uint32_t num_b,
+  uint16_t *out
+)
+{
+    uint32_t i = 0U;
+    uint32_t j = 0U;
+    uint32_t num = 0U;
+    while (i < num_a && j < num_b) {
+        if (a[i] < b[j]) {
+            ++i;
+        } else if (b[j] < a[i]) {
+            ++j;
+        } else {
+            out[num++] = a[i];
+            ++i;
+            ++j;
+        }
+    }
+    return num;
+}
+
+/**
+ * Returns index of the first of `vals[pos..num)` not smaller than `val`,
+ * probing in exponentially growing steps from `pos` before bisecting.
+ */
+static uint32_t
+_cutil_Roaring_gallop(
+  const uint16_t *vals, uint32_t num, uint32_t pos, uint16_t val
+)
+{
+    if (pos >= num || vals[pos] >= val) {
+        return pos;
+    }
+    uint32_t lo = pos;
+    uint32_t step = 1U;
+    while (lo + step < num && vals[lo + step] < val) {
+        lo += step;
+        step *= 2U;
+    }
+    const uint32_t hi = CUTIL_MIN(lo + step, num);
+    return lo + 1U
+         + _cutil_Roaring_lower_bound(vals + lo + 1U, hi - lo - 1U, val);
+}
+
+static uint32_t
+_cutil_Roaring_intersect_galloping(
+  const uint16_t *small, uint32_t num_small, const uint16_t *large,
+  uint32_t num_large, uint16_t *out
+)
+{
+    uint32_t pos = 0U;
+    uint32_t num = 0U;
+    for (uint32_t i = 0U; i < num_small; ++i) {
+        pos = _cutil_Roaring_gallop(large, num_large, pos, small[i]);
+        if (pos == num_large) {
+            break;
+        }
+        if (large[pos] == small[i]) {
+            out[num++] = small[i];
+            ++pos;
+        }
+    }
+    return num;
+}
+
+#if defined(ROARING_INTERSECT_SSE2)
+    /* Rotates the eight 16-bit lanes of V down by N lanes */
+    #define ROARING_ROTATE_LANES(V, N)                                         \
+        _mm_or_si128(                                                          \
+          _mm_srli_si128((V), 2 * (N)), _mm_slli_si128((V), 16 - 2 * (N))      \
+        )
+
+/**
+ * Compares blocks of eight values of `a` and `b` all-against-all, emitting the
+ * values of `a` that match in order, and advances past the block with the
+ * smaller maximum. The remainder is intersected scalarly.
+ */
+static uint32_t
+_cutil_Roaring_intersect_sse2(
+  const uint16_t *a, uint32_t num_a, const uint16_t *b, uint32_t num_b,
+  uint16_t *out
+)
+{
+    uint32_t i = 0U;
+    uint32_t j = 0U;
+    uint32_t num = 0U;
+    while (i + 8U <= num_a && j + 8U <= num_b) {
+        const __m128i va = _mm_loadu_si128((const __m128i *) (a + i));
+        const __m128i vb = _mm_loadu_si128((const __m128i *) (b + j));
+        __m128i eq = _mm_cmpeq_epi16(va, vb);
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi16(va, ROARING_ROTATE_LANES(vb, 1)));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi16(va, ROARING_ROTATE_LANES(vb, 2)));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi16(va, ROARING_ROTATE_LANES(vb, 3)));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi16(va, ROARING_ROTATE_LANES(vb, 4)));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi16(va, ROARING_ROTATE_LANES(vb, 5)));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi16(va, ROARING_ROTATE_LANES(vb, 6)));
+        eq = _mm_or_si128(eq, _mm_cmpeq_epi16(va, ROARING_ROTATE_LANES(vb, 7)));
+
+        /* Each matching 16-bit lane sets two bits of the mask */
+        unsigned int mask = (unsigned int) _mm_movemask_epi8(eq);
+        while (mask != 0U) {
+            const unsigned int lane = cutil_bits_ctz_u64(mask) / 2U;
+            out[num++] = a[i + lane];
+            mask &= ~(3U << (2U * lane));
+        }
+
+        const uint16_t max_a = a[i + 7U];
+        const uint16_t max_b = b[j + 7U];
+        i += max_a <= max_b ? 8U : 0U;
+        j += max_b <= max_a ? 8U : 0U;
+    }
+    return num
+         + _cutil_Roaring_intersect_scalar(
+           a + i, num_a - i, b + j, num_b - j, out + num
+         );
+}
+#endif
+
+static uint32_t
+_cutil_Roaring_intersect_arrays(
+  const uint16_t *a, uint32_t num_a, const uint16_t *b, uint32_t num_b,
+  uint16_t *out
+)
+{
+    if (num_a * ROARING_GALLOP_RATIO < num_b) {
+        return _cutil_Roaring_intersect_galloping(a, num_a, b, num_b, out);
+    }
+    if (num_b * ROARING_GALLOP_RATIO < num_a) {
+        return _cutil_Roaring_intersect_galloping(b, num_b, a, num_a, out);
+    }
+#if defined(ROARING_INTERSECT_SSE2)
+    return _cutil_Roaring_intersect_sse2(a, num_a, b, num_b, out);
+#else
+    return _cutil_Roaring_intersect_scalar(a, num_a, b, num_b, out);
+#endif
+}
+
+/**
+ * Merges `a` and `b`, emitting values only in `a` and, unless it is a
+ * difference, only in `b`, as well as values in both for unions.
+ */
+static uint32_t
+_cutil_Roaring_merge_arrays(
+  const uint16_t *a, uint32_t num_a, const uint16_t *b, uint32_t num_b,
+  cutil_SetOp op, uint16_t *out
+)
+{
+    uint32_t i = 0U;
+    uint32_t j = 0U;
+    uint32_t num = 0U;
+    while (i < num_a && j < num_b) {
+        if (a[i] < b[j]) {
+            out[num++] = a[i++];
+        } else if (b[j] < a[i]) {
+            if (op != CUTIL_SET_OP_DIFFERENCE) {
+                out[num++] = b[j];
+            }
+            ++j;
+        } else {
+            if (op == CUTIL_SET_OP_UNION) {
+                out[num++] = a[i];
+            }
+            ++i;
+            ++j;
+        }
+    }
+    if (i < num_a) {
+        memcpy(out + num, a + i, ROARING_ARRAY_BYTES(num_a - i));
+        num += num_a - i;
+    }
+    if (j < num_b && op != CUTIL_SET_OP_DIFFERENCE) {
+        memcpy(out + num, b + j, ROARING_ARRAY_BYTES(num_b - j));
+        num += num_b - j;
+    }
+    return num;
+}
+
+/**
+ * Applies the union, difference or symmetric difference `op` with the `num`
+ * `vals` to the bitmap `words`.
+ */
+static void
+_cutil_Roaring_bitmap_apply_values(
+  uint64_t *words, const uint16_t *vals, uint32_t num, cutil_SetOp op
+)
+{
+    for (uint32_t i = 0U; i < num; ++i) {
+        const uint64_t mask = UINT64_C(1) << (vals[i] % ROARING_WORD_BITS);
+        uint64_t *const word = &words[vals[i] / ROARING_WORD_BITS];
+        if (op == CUTIL_SET_OP_DIFFERENCE) {
+            *word &= ~mask;
+        } else if (op == CUTIL_SET_OP_SYMDIFF) {
+            *word ^= mask;
+        } else {
+            *word |= mask;
+        }
+    }
+}
+
+/**
+ * Applies `op` with the bitmap `src` to the bitmap `dst` word by word. The
+ * loops are free of branches and aliasing, so that compilers vectorize them.
+ */
+static void
+_cutil_Roaring_bitmap_apply_words(
+  uint64_t *CUTIL_RESTRICT dst, const uint64_t *CUTIL_RESTRICT src,
+  cutil_SetOp op
+)
+{
+    switch (op) {
+    case CUTIL_SET_OP_UNION:
+        for (uint32_t i = 0U; i < ROARING_BITMAP_WORDS; ++i) {
+            dst[i] |= src[i];
+        }
+        break;
+    case CUTIL_SET_OP_INTERSECTION:
+        for (uint32_t i = 0U; i < ROARING_BITMAP_WORDS; ++i) {
+            dst[i] &= src[i];
+        }
+        break;
+    case CUTIL_SET_OP_DIFFERENCE:
+        for (uint32_t i = 0U; i < ROARING_BITMAP_WORDS; ++i) {
+            dst[i] &= ~src[i];
+        }
+        break;
+    default:
+        for (uint32_t i = 0U; i < ROARING_BITMAP_WORDS; ++i) {
+            dst[i] ^= src[i];
+        }
+        break;
+    }
+}
+
+/**
+ * Initializes `res` to an array container with the values of the array
+ * container `array` that are (or, if `negate`, are not) in the bitmap `words`.
+ */
+static void
+_cutil_RoaringContainer_filter(
+  const _cutil_RoaringContainer *array, const uint64_t *words,
+  cutil_Bool negate, _cutil_RoaringContainer *res
+)
+{
+    _cutil_RoaringContainer_init_array(res, array->size);
+    for (uint32_t i = 0U; i < array->size; ++i) {
+        const uint16_t val = array->data.values[i];
+        res->data.values[res->size] = val;
+        res->size += CUTIL_BOOLIFY(
+          _cutil_Roaring_bitmap_test(words, val) != negate
+        );
+    }
+    res->cardinality = res->size;
+}
+
+/**
+ * Initializes `res` to the result of applying `op` to the array or bitmap
+ * containers `lhs` and `rhs`.
+ */
+static void
+_cutil_RoaringContainer_combine_materialized(
+  const _cutil_RoaringContainer *lhs, const _cutil_RoaringContainer *rhs,
+  cutil_SetOp op, _cutil_RoaringContainer *res
+)
+{
+    const cutil_Bool lhs_array = CUTIL_BOOLIFY(lhs->kind == ROARING_ARRAY);
+    const cutil_Bool rhs_array = CUTIL_BOOLIFY(rhs->kind == ROARING_ARRAY);
+
+    if (lhs_array && rhs_array) {
+        if (op == CUTIL_SET_OP_INTERSECTION) {
+            _cutil_RoaringContainer_init_array(
+              res, CUTIL_MIN(lhs->size, rhs->size)
+            );
+            res->size = _cutil_Roaring_intersect_arrays(
+              lhs->data.values, lhs->size, rhs->data.values, rhs->size,
+              res->data.values
+            );
+            res->cardinality = res->size;
+            return;
+        }
+        const uint32_t capacity = op == CUTIL_SET_OP_DIFFERENCE
+                                  ? lhs->size
+                                  : lhs->size + rhs->size;
+        if (capacity <= ROARING_MAX_ARRAY_CARDINALITY) {
+            _cutil_RoaringContainer_init_array(res, capacity);
+            res->size = _cutil_Roaring_merge_arrays(
+              lhs->data.values, lhs->size, rhs->data.values, rhs->size, op,
+              res->data.values
+            );
+            res->cardinality = res->size;
+            return;
+        }
+    } else if (op == CUTIL_SET_OP_INTERSECTION && lhs_array) {
+        _cutil_RoaringContainer_filter(lhs, rhs->data.words, false, res);
+        return;
+    } else if (op == CUTIL_SET_OP_INTERSECTION && rhs_array) {
+        _cutil_RoaringContainer_filter(rhs, lhs->data.words, false, res);
+        return;
+    } else if (op == CUTIL_SET_OP_DIFFERENCE && lhs_array) {
+        _cutil_RoaringContainer_filter(lhs, rhs->data.words, true, res);
+        return;
+    }
+
+    /* Large results are computed on a bitmap and shrunk if need be */
+    _cutil_RoaringContainer_init_bitmap(res);
+    if (lhs_array) {
+        _cutil_Roaring_bitmap_apply_values(
+          res->data.words, lhs->data.values, lhs->size, CUTIL_SET_OP_UNION
+        );
+    } else {
+        memcpy(res->data.words, lhs->data.words, ROARING_BITMAP_BYTES);
+    }
+    if (rhs_array) {
+        _cutil_Roaring_bitmap_apply_values(
+          res->data.words, rhs->data.values, rhs->size, op
+        );
+    } else {
+        _cutil_Roaring_bitmap_apply_words(res->data.words, rhs->data.words, op);
+    }
+    res->cardinality = _cutil_Roaring_bitmap_count(res->data.words);
+    if (res->cardinality <= ROARING_MAX_ARRAY_CARDINALITY) {
+        _cutil_RoaringContainer_to_array(res);
+    }
+}
+
+/**
+ * Returns `container`, or, if it is a run container, its converted copy
+ * stored in `tmp`.
+ */
+static const _cutil_RoaringContainer *
+_cutil_RoaringContainer_materialize(
+  const _cutil_RoaringContainer *container, _cutil_RoaringContainer *tmp
+)
+{
+    if (container->kind != ROARING_RUN) {
+        return container;
+    }
+    _cutil_RoaringContainer_copy(tmp, container);
+    _cutil_RoaringContainer_from_runs(tmp);
+    return tmp;
+}
+
+/**
+ * Initializes `res` to the result of applying `op` to `lhs` and `rhs`. Run
+ * containers are converted to array or bitmap containers first.
+ */
+static void
+_cutil_RoaringContainer_combine(
+  const _cutil_RoaringContainer *lhs, const _cutil_RoaringContainer *rhs,
+  cutil_SetOp op, _cutil_RoaringContainer *res
+)
+{
+    _cutil_RoaringContainer lhs_tmp;
+    _cutil_RoaringContainer rhs_tmp;
+    const _cutil_RoaringContainer *const lhs_mat
+      = _cutil_RoaringContainer_materialize(lhs, &lhs_tmp);
+    const _cutil_RoaringContainer *const rhs_mat
+      = _cutil_RoaringContainer_materialize(rhs, &rhs_tmp);
+
+    _cutil_RoaringContainer_combine_materialized(lhs_mat, rhs_mat, op, res);
+
+    if (lhs_mat == &lhs_tmp) {
+        _cutil_RoaringContainer_free(&lhs_tmp);
+    }
+    if (rhs_mat == &rhs_tmp) {
+        _cutil_RoaringContainer_free(&rhs_tmp);
+    }
+}
+
+static _cutil_RoaringSet *
+_cutil_RoaringSet_create(size_t capacity)
+{
+    _cutil_RoaringSet *const rs = CUTIL_MALLOC_OBJECT(rs);
+    rs->num_containers = 0UL;
+    rs->capacity = capacity;
+    rs->keys = capacity == 0UL ? NULL : CUTIL_MALLOC_MULT(rs->keys, capacity);
+    rs->containers = capacity == 0UL
+                     ? NULL
+                     : CUTIL_MALLOC_MULT(rs->containers, capacity);
+    return rs;
+}
+
+static void
+_cutil_RoaringSet_reserve_containers(_cutil_RoaringSet *rs, size_t num)
+{
+    if (num <= rs->capacity) {
+        return;
+    }
+    const size_t expanded = rs->capacity * ROARING_EXPAND_FACTOR;
+    const size_t capacity
+      = CUTIL_MIN(CUTIL_MAX(expanded, num), ROARING_MAX_CONTAINERS);
+    rs->keys = CUTIL_REALLOC_MULT(rs->keys, capacity);
+    rs->containers = CUTIL_REALLOC_MULT(rs->containers, capacity);
+    rs->capacity = capacity;
+}
+
+/**
+ * Returns index of the container of `rs` for chunk `key`, or of where it would
+ * be inserted, and stores whether it exists in `found`.
+ */
+static size_t
+_cutil_RoaringSet_find(
+  const _cutil_RoaringSet *rs, uint16_t key, cutil_Bool *found
+)
+{
+    size_t lo = 0UL;
+    size_t hi = rs->num_containers;
+    /* Elements are often added in ascending order */
+    if (hi > 0UL && rs->keys[hi - 1UL] < key) {
+        lo = hi;
+    }
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2UL;
+        if (rs->keys[mid] < key) {
+            lo = mid + 1UL;
+        } else {
+            hi = mid;
+        }
+    }
+    *found = CUTIL_BOOLIFY(lo < rs->num_containers && rs->keys[lo] == key);
+    return lo;
+}
+
+/**
+ * Moves `container` into `rs` at index `idx` for chunk `key`.
+ */
+static void
+_cutil_RoaringSet_insert_container(
+  _cutil_RoaringSet *rs, size_t idx, uint16_t key,
+  const _cutil_RoaringContainer *container
+)
+{
+    _cutil_RoaringSet_reserve_containers(rs, rs->num_containers + 1UL);
+    const size_t num_moved = rs->num_containers - idx;
+    memmove(rs->keys + idx + 1UL, rs->keys + idx, num_moved * sizeof *rs->keys);
+    memmove(
+      rs->containers + idx + 1UL, rs->containers + idx,
+      num_moved * sizeof *rs->containers
+    );
+    rs->keys[idx] = key;
+    rs->containers[idx] = *container;
+    ++rs->num_containers;
+}
+
+static void
+_cutil_RoaringSet_erase_container(_cutil_RoaringSet *rs, size_t idx)
+{
+    _cutil_RoaringContainer_free(&rs->containers[idx]);
+    const size_t num_moved = rs->num_containers - idx - 1UL;
+    memmove(rs->keys + idx, rs->keys + idx + 1UL, num_moved * sizeof *rs->keys);
+    memmove(
+      rs->containers + idx, rs->containers + idx + 1UL,
+      num_moved * sizeof *rs->containers
+    );
+    --rs->num_containers;
+}
+
+static cutil_Bool
+_cutil_RoaringSet_insert(_cutil_RoaringSet *rs, uint32_t val)
+{
+    const uint16_t key = _cutil_Roaring_high(val);
+    cutil_Bool found = false;
+    const size_t idx = _cutil_RoaringSet_find(rs, key, &found);
+    if (found) {
+        return _cutil_RoaringContainer_add(
+          &rs->containers[idx], _cutil_Roaring_low(val)
+        );
+    }
+    _cutil_RoaringContainer container;
+    _cutil_RoaringContainer_init_array(&container, ROARING_MIN_ARRAY_CAPACITY);
+    _cutil_RoaringContainer_add(&container, _cutil_Roaring_low(val));
+    _cutil_RoaringSet_insert_container(rs, idx, key, &container);
+    return true;
+}
+
+static cutil_Bool
+_cutil_RoaringSet_erase(_cutil_RoaringSet *rs, uint32_t val)
+{
+    cutil_Bool found = false;
+    const size_t idx
+      = _cutil_RoaringSet_find(rs, _cutil_Roaring_high(val), &found);
+    if (!found
+        || !_cutil_RoaringContainer_remove(
+          &rs->containers[idx], _cutil_Roaring_low(val)
+        )) {
+        return false;
+    }
+    if (rs->containers[idx].cardinality == 0U) {
+        _cutil_RoaringSet_erase_container(rs, idx);
+    }
+    return true;
+}
+
+cutil_Set *
+cutil_RoaringSet_alloc(void)
+{
+    cutil_Set *const set = CUTIL_MALLOC_OBJECT(set);
+    set->vtable = CUTIL_SET_TYPE_ROARING;
+    set->data = _cutil_RoaringSet_create(0UL);
+    return set;
+}
+
+cutil_Status
+cutil_RoaringSet_run_optimize(cutil_Set *set)
+{
+    CUTIL_RETURN_VAL_IF_NULL(set, CUTIL_STATUS_FAILURE);
+    _cutil_RoaringSet *const rs = set->data;
+    for (size_t i = 0; i < rs->num_containers; ++i) {
+        _cutil_RoaringContainer_run_optimize(&rs->containers[i]);
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static void
+_cutil_RoaringSet_reset(void *data)
+{
+    _cutil_RoaringSet *const rs = data;
+    for (size_t i = 0; i < rs->num_containers; ++i) {
+        _cutil_RoaringContainer_free(&rs->containers[i]);
+    }
+    rs->num_containers = 0UL;
+}
+
+static void
+_cutil_RoaringSet_free(void *data)
+{
+    _cutil_RoaringSet *const rs = data;
+    CUTIL_RETURN_IF_NULL(rs);
+    _cutil_RoaringSet_reset(rs);
+    free(rs->keys);
+    free(rs->containers);
+    free(rs);
+}
+
+static void
+_cutil_RoaringSet_copy(void *dst, const void *src)
+{
+    _cutil_RoaringSet *const dst_rs = dst;
+    const _cutil_RoaringSet *const src_rs = src;
+    CUTIL_RETURN_IF_VAL(dst_rs, src_rs);
+
+    _cutil_RoaringSet_reset(dst_rs);
+    _cutil_RoaringSet_reserve_containers(dst_rs, src_rs->num_containers);
+    for (size_t i = 0; i < src_rs->num_containers; ++i) {
+        dst_rs->keys[i] = src_rs->keys[i];
+        _cutil_RoaringContainer_copy(
+          &dst_rs->containers[i], &src_rs->containers[i]
+        );
+    }
+    dst_rs->num_containers = src_rs->num_containers;
+}
+
+static void *
+_cutil_RoaringSet_duplicate(const void *data)
+{
+    const _cutil_RoaringSet *const src = data;
+    _cutil_RoaringSet *const dst
+      = _cutil_RoaringSet_create(src->num_containers);
+    _cutil_RoaringSet_copy(dst, src);
+    return dst;
+}
+
+static size_t
+_cutil_RoaringSet_get_count(const void *data)
+{
+    const _cutil_RoaringSet *const rs = data;
+    size_t count = 0UL;
+    for (size_t i = 0; i < rs->num_containers; ++i) {
+        count += rs->containers[i].cardinality;
+    }
+    return count;
+}
+
+static cutil_Bool
+_cutil_RoaringSet_contains(const void *data, const void *elem)
+{
+    const _cutil_RoaringSet *const rs = data;
+    uint32_t val = 0U;
+    memcpy(&val, elem, sizeof val);
+    cutil_Bool found = false;
+    const size_t idx
+      = _cutil_RoaringSet_find(rs, _cutil_Roaring_high(val), &found);
+    return found
+        && _cutil_RoaringContainer_contains(
+          &rs->containers[idx], _cutil_Roaring_low(val)
+        );
+}
+
+static cutil_Status
+_cutil_RoaringSet_insert_if_absent(
+  void *data, const void *elem, cutil_Bool *inserted
+)
+{
+    uint32_t val = 0U;
+    memcpy(&val, elem, sizeof val);
+    const cutil_Bool res = _cutil_RoaringSet_insert(data, val);
+    if (inserted != NULL) {
+        *inserted = res;
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_RoaringSet_add(void *data, const void *elem)
+{
+    cutil_Bool inserted = false;
+    const cutil_Status status
+      = _cutil_RoaringSet_insert_if_absent(data, elem, &inserted);
+    if (status == CUTIL_STATUS_SUCCESS && !inserted) {
+        cutil_log_warn("RoaringSet add: element already in set, skipping");
+    }
+    return status;
+}
+
+static cutil_Status
+_cutil_RoaringSet_remove(void *data, const void *elem)
+{
+    uint32_t val = 0U;
+    memcpy(&val, elem, sizeof val);
+    if (!_cutil_RoaringSet_erase(data, val)) {
+        cutil_log_warn("RoaringSet remove: element not found");
+        return CUTIL_STATUS_FAILURE;
+    }
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_RoaringSet_reserve(void *data, size_t count)
+{
+    (void) data;
+    (void) count;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_RoaringSet_shrink_to_fit(void *data)
+{
+    _cutil_RoaringSet *const rs = data;
+    for (size_t i = 0; i < rs->num_containers; ++i) {
+        _cutil_RoaringContainer_shrink_to_fit(&rs->containers[i]);
+    }
+    CUTIL_RETURN_VAL_IF_VAL(
+      rs->num_containers, rs->capacity, CUTIL_STATUS_SUCCESS
+    );
+    if (rs->num_containers == 0UL) {
+        free(rs->keys);
+        free(rs->containers);
+        rs->keys = NULL;
+        rs->containers = NULL;
+    } else {
+        rs->keys = CUTIL_REALLOC_MULT(rs->keys, rs->num_containers);
+        rs->containers
+          = CUTIL_REALLOC_MULT(rs->containers, rs->num_containers);
+    }
+    rs->capacity = rs->num_containers;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static const cutil_GenericType *
+_cutil_RoaringSet_get_elem_type(const void *data)
+{
+    (void) data;
+    return CUTIL_GENERIC_TYPE_U32;
+}
+
+/**
+ * Moves `container` to the end of `rs` for chunk `key`.
+ */
+static void
+_cutil_RoaringSet_append(
+  _cutil_RoaringSet *rs, uint16_t key, const _cutil_RoaringContainer *container
+)
+{
+    _cutil_RoaringSet_reserve_containers(rs, rs->num_containers + 1UL);
+    rs->keys[rs->num_containers] = key;
+    rs->containers[rs->num_containers] = *container;
+    ++rs->num_containers;
+}
+
+/**
+ * Appends the result of applying `op` to `lhs` and `rhs` to the empty `res`,
+ * chunk by chunk. If `consume_lhs`, containers of `lhs` are moved to `res` or
+ * freed rather than copied, and `lhs` is left empty; otherwise, `lhs` is not
+ * modified.
+ */
+static void
+_cutil_RoaringSet_merge(
+  _cutil_RoaringSet *res, _cutil_RoaringSet *lhs, const _cutil_RoaringSet *rhs,
+  cutil_SetOp op, cutil_Bool consume_lhs
+)
+{
+    const cutil_Bool keep_lhs_only
+      = CUTIL_BOOLIFY(op != CUTIL_SET_OP_INTERSECTION);
+    const cutil_Bool keep_rhs_only = CUTIL_BOOLIFY(
+      op == CUTIL_SET_OP_UNION || op == CUTIL_SET_OP_SYMDIFF
+    );
+    if (op == CUTIL_SET_OP_INTERSECTION) {
+        _cutil_RoaringSet_reserve_containers(
+          res, CUTIL_MIN(lhs->num_containers, rhs->num_containers)
+        );
+    } else {
+        _cutil_RoaringSet_reserve_containers(
+          res, lhs->num_containers + (keep_rhs_only ? rhs->num_containers : 0UL)
+        );
+    }
+
+    size_t i = 0UL;
+    size_t j = 0UL;
+    while (i < lhs->num_containers || j < rhs->num_containers) {
+        _cutil_RoaringContainer container;
+        if (j == rhs->num_containers
+            || (i < lhs->num_containers && lhs->keys[i] < rhs->keys[j])) {
+            if (keep_lhs_only && consume_lhs) {
+                _cutil_RoaringSet_append(
+                  res, lhs->keys[i], &lhs->containers[i]
+                );
+            } else if (keep_lhs_only) {
+                _cutil_RoaringContainer_copy(&container, &lhs->containers[i]);
+                _cutil_RoaringSet_append(res, lhs->keys[i], &container);
+            } else if (consume_lhs) {
+                _cutil_RoaringContainer_free(&lhs->containers[i]);
+            }
+            ++i;
+        } else if (i == lhs->num_containers || rhs->keys[j] < lhs->keys[i]) {
+            if (keep_rhs_only) {
+                _cutil_RoaringContainer_copy(&container, &rhs->containers[j]);
+                _cutil_RoaringSet_append(res, rhs->keys[j], &container);
+            }
+            ++j;
+        } else {
+            _cutil_RoaringContainer_combine(
+              &lhs->containers[i], &rhs->containers[j], op, &container
+            );
+            if (container.cardinality > 0U) {
+                _cutil_RoaringSet_append(res, lhs->keys[i], &container);
+            } else {
+                _cutil_RoaringContainer_free(&container);
+            }
+            if (consume_lhs) {
+                _cutil_RoaringContainer_free(&lhs->containers[i]);
+            }
+            ++i;
+            ++j;
+        }
+    }
+    if (consume_lhs) {
+        lhs->num_containers = 0UL;
+    }
+}
+
+static cutil_Status
+_cutil_RoaringSet_combine(void *dst, const void *src, cutil_SetOp op)
+{
+    _cutil_RoaringSet *const rs = dst;
+    _cutil_RoaringSet res = {0UL, 0UL, NULL, NULL};
+    _cutil_RoaringSet_merge(&res, rs, src, op, true);
+    free(rs->keys);
+    free(rs->containers);
+    *rs = res;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static void *
+_cutil_RoaringSet_combine_new(const void *lhs, const void *rhs, cutil_SetOp op)
+{
+    _cutil_RoaringSet *const res = _cutil_RoaringSet_create(0UL);
+    _cutil_RoaringSet_merge(res, CUTIL_CONST_CAST(lhs), rhs, op, false);
+    return res;
+}
+
+typedef struct {
+    _cutil_RoaringSet *rs;
+    size_t container; /**< index of the container being scanned */
+    uint32_t pos;     /**< index of the value, bitmap word or run scanned */
+    uint64_t rest;    /**< unscanned bits of the bitmap word scanned */
+    uint16_t low;     /**< next value of the run scanned */
+    uint32_t val;     /**< current element */
+    cutil_Bool at_elem; /**< is there a current element? */
+    cutil_Bool removed; /**< was the current element removed? */
+} _cutil_RoaringSetIter;
+
+/**
+ * Starts scanning the container at index `iter->container`, if any.
+ */
+static void
+_cutil_RoaringSetIter_enter(_cutil_RoaringSetIter *iter)
+{
+    iter->pos = 0U;
+    iter->rest = 0U;
+    iter->low = 0U;
+    if (iter->container >= iter->rs->num_containers) {
+        return;
+    }
+    const _cutil_RoaringContainer *const container
+      = &iter->rs->containers[iter->container];
+    if (container->kind == ROARING_BITMAP) {
+        iter->rest = container->data.words[0];
+    } else if (container->kind == ROARING_RUN) {
+        iter->low = container->data.runs[0].start;
+    }
+}
+
+/**
+ * Moves `iter` to the first unscanned element, moving on to the next
+ * container whenever one is exhausted.
+ *
+ * @return whether there is such an element
+ */
+static cutil_Bool
+_cutil_RoaringSetIter_settle(_cutil_RoaringSetIter *iter)
+{
+    const _cutil_RoaringSet *const rs = iter->rs;
+    while (iter->container < rs->num_containers) {
+        const _cutil_RoaringContainer *const container
+          = &rs->containers[iter->container];
+        cutil_Bool found = false;
+        uint32_t low = 0U;
+        if (container->kind == ROARING_ARRAY) {
+            found = CUTIL_BOOLIFY(iter->pos < container->size);
+            low = found ? container->data.values[iter->pos] : 0U;
+        } else if (container->kind == ROARING_BITMAP) {
+            while (iter->rest == 0U && iter->pos + 1U < ROARING_BITMAP_WORDS) {
+                iter->rest = container->data.words[++iter->pos];
+            }
+            found = CUTIL_BOOLIFY(iter->rest != 0U);
+            low = found ? iter->pos * ROARING_WORD_BITS
+                            + cutil_bits_ctz_u64(iter->rest)
+                        : 0U;
+        } else {
+            found = CUTIL_BOOLIFY(iter->pos < container->size);
+            low = iter->low;
+        }
+        if (found) {
+            const uint32_t high = rs->keys[iter->container];
+            iter->val = high << ROARING_CHUNK_BITS | low;
+            iter->at_elem = true;
+            return true;
+        }
+        ++iter->container;
+        _cutil_RoaringSetIter_enter(iter);
+    }
+    iter->at_elem = false;
+    return false;
+}
+
+/**
+ * Moves `iter` past its current element.
+ */
+static void
+_cutil_RoaringSetIter_step(_cutil_RoaringSetIter *iter)
+{
+    const _cutil_RoaringContainer *const container
+      = &iter->rs->containers[iter->container];
+    if (container->kind == ROARING_ARRAY) {
+        ++iter->pos;
+    } else if (container->kind == ROARING_BITMAP) {
+        iter->rest &= iter->rest - 1U;
+    } else if (iter->low
+               < _cutil_Roaring_run_end(&container->data.runs[iter->pos])) {
+        ++iter->low;
+    } else if (++iter->pos < container->size) {
+        iter->low = container->data.runs[iter->pos].start;
+    }
+}
+
+/**
+ * Positions `iter` so that the element scanned next is the first one not
+ * smaller than `from`.
+ */
+static void
+_cutil_RoaringSetIter_seek(_cutil_RoaringSetIter *iter, uint64_t from)
+{
+    const _cutil_RoaringSet *const rs = iter->rs;
+    if (from > UINT32_MAX) {
+        iter->container = rs->num_containers;
+        return;
+    }
+    const uint16_t low = _cutil_Roaring_low((uint32_t) from);
+    cutil_Bool found = false;
+    const uint16_t key = _cutil_Roaring_high((uint32_t) from);
+    iter->container = _cutil_RoaringSet_find(rs, key, &found);
+    _cutil_RoaringSetIter_enter(iter);
+    if (!found) {
+        return;
+    }
+
+    const _cutil_RoaringContainer *const container
+      = &rs->containers[iter->container];
+    if (container->kind == ROARING_ARRAY) {
+        iter->pos = _cutil_Roaring_lower_bound(
+          container->data.values, container->size, low
+        );
+    } else if (container->kind == ROARING_BITMAP) {
+        iter->pos = low / ROARING_WORD_BITS;
+        iter->rest = container->data.words[iter->pos]
+                   & (UINT64_MAX << (low % ROARING_WORD_BITS));
+    } else {
+        const _cutil_RoaringRun *const runs = container->data.runs;
+        const uint32_t idx
+          = _cutil_Roaring_runs_upper_bound(runs, container->size, low);
+        if (idx > 0U && low <= _cutil_Roaring_run_end(&runs[idx - 1U])) {
+            iter->pos = idx - 1U;
+            iter->low = low;
+        } else {
+            iter->pos = idx;
+            iter->low = idx < container->size ? runs[idx].start : 0U;
+        }
+    }
+}
+
+static void
+_cutil_RoaringSetIter_free(void *data)
+{
+    free(data);
+}
+
+static void
+_cutil_RoaringSetIter_rewind(void *data)
+{
+    _cutil_RoaringSetIter *const iter = data;
+    iter->container = 0UL;
+    _cutil_RoaringSetIter_enter(iter);
+    iter->val = 0U;
+    iter->at_elem = false;
+    iter->removed = false;
+}
+
+static cutil_Bool
+_cutil_RoaringSetIter_next(void *data)
+{
+    _cutil_RoaringSetIter *const iter = data;
+    if (iter->removed) {
+        /* Containers may have changed kind or vanished */
+        _cutil_RoaringSetIter_seek(iter, (uint64_t) iter->val + 1U);
+        iter->removed = false;
+    } else if (iter->at_elem) {
+        _cutil_RoaringSetIter_step(iter);
+    }
+    return _cutil_RoaringSetIter_settle(iter);
+}
+
+static const void *
+_cutil_RoaringSetIter_get_ptr(const void *data)
+{
+    const _cutil_RoaringSetIter *const iter = data;
+    return iter->at_elem ? &iter->val : NULL;
+}
+
+static cutil_Status
+_cutil_RoaringSetIter_get(const void *data, void *out)
+{
+    const _cutil_RoaringSetIter *const iter = data;
+    if (!iter->at_elem) {
+        return CUTIL_STATUS_FAILURE;
+    }
+    memcpy(out, &iter->val, sizeof iter->val);
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static cutil_Status
+_cutil_RoaringSetIter_remove(void *data)
+{
+    _cutil_RoaringSetIter *const iter = data;
+    if (!iter->at_elem || iter->removed
+        || !_cutil_RoaringSet_erase(iter->rs, iter->val)) {
+        return CUTIL_STATUS_FAILURE;
+    }
+    iter->removed = true;
+    return CUTIL_STATUS_SUCCESS;
+}
+
+static const cutil_ConstIteratorType CUTIL_CONST_ITERATOR_TYPE_ROARING_OBJECT
+  = {
+    .name = "cutil_ConstIterator<cutil_RoaringSet>",
+    .free = &_cutil_RoaringSetIter_free,
+    .rewind = &_cutil_RoaringSetIter_rewind,
+    .next = &_cutil_RoaringSetIter_next,
+    .get = &_cutil_RoaringSetIter_get,
+    .get_ptr = &_cutil_RoaringSetIter_get_ptr,
+};
+
+const cutil_ConstIteratorType *const CUTIL_CONST_ITERATOR_TYPE_ROARING
+  = &CUTIL_CONST_ITERATOR_TYPE_ROARING_OBJECT;
+
+static const cutil_IteratorType CUTIL_ITERATOR_TYPE_ROARING_OBJECT = {
+  .name = "cutil_Iterator<cutil_RoaringSet>",
+  .free = &_cutil_RoaringSetIter_free,
+  .rewind = &_cutil_RoaringSetIter_rewind,
+  .next = &_cutil_RoaringSetIter_next,
+  .get = &_cutil_RoaringSetIter_get,
+  .get_ptr = &_cutil_RoaringSetIter_get_ptr,
+  .set = NULL,
+  .remove = &_cutil_RoaringSetIter_remove,
+};
+
+const cutil_IteratorType *const CUTIL_ITERATOR_TYPE_ROARING
+  = &CUTIL_ITERATOR_TYPE_ROARING_OBJECT;
+
+static _cutil_RoaringSetIter *
+_cutil_RoaringSetIter_create(const _cutil_RoaringSet *rs)
+{
+    _cutil_RoaringSetIter *const iter = CUTIL_MALLOC_OBJECT(iter);
+    iter->rs = CUTIL_CONST_CAST(rs);
+    _cutil_RoaringSetIter_rewind(iter);
+    return iter;
+}
+
+static cutil_ConstIterator *
+_cutil_RoaringSet_get_const_iterator(const void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+    cutil_ConstIterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_CONST_ITERATOR_TYPE_ROARING;
+    it->data = _cutil_RoaringSetIter_create(data);
+    return it;
+}
+
+static cutil_Iterator *
+_cutil_RoaringSet_get_iterator(void *data)
+{
+    CUTIL_RETURN_NULL_IF_NULL(data);
+    cutil_Iterator *const it = CUTIL_MALLOC_OBJECT(it);
+    it->vtable = CUTIL_ITERATOR_TYPE_ROARING;
+    it->data = _cutil_RoaringSetIter_create(data);
+    return it;
+}
+
+static const cutil_SetType CUTIL_SET_TYPE_ROARING_OBJECT = {
+  .name = "cutil_RoaringSet",
+  .free = &_cutil_RoaringSet_free,
+  .reset = &_cutil_RoaringSet_reset,
+  .copy = &_cutil_RoaringSet_copy,
+  .duplicate = &_cutil_RoaringSet_duplicate,
+  .get_count = &_cutil_RoaringSet_get_count,
+  .contains = &_cutil_RoaringSet_contains,
+  .add = &_cutil_RoaringSet_add,
+  .insert_if_absent = &_cutil_RoaringSet_insert_if_absent,
+  .remove = &_cutil_RoaringSet_remove,
+  .reserve = &_cutil_RoaringSet_reserve,
+  .shrink_to_fit = &_cutil_RoaringSet_shrink_to_fit,
+  .get_elem_type = &_cutil_RoaringSet_get_elem_type,
+  .get_const_iterator = &_cutil_RoaringSet_get_const_iterator,
+  .get_iterator = &_cutil_RoaringSet_get_iterator,
+  .combine = &_cutil_RoaringSet_combine,
+  .combine_new = &_cutil_RoaringSet_combine_new,
+};
+
+const cutil_SetType *const CUTIL_SET_TYPE_ROARING
+  = &CUTIL_SET_TYPE_ROARING_OBJECT;
+
+/*
+ * Serialization follows the portable Roaring format: a cookie that tells
+ * whether run containers are present, a bitset flagging them if so, the key
+ * and cardinality minus one of each container, the byte offsets of the
+ * containers unless runs are present and there are fewer than four
+ * containers, and finally the containers themselves. Array containers are
+ * written as values, bitmap containers as words, and run containers as their
+ * number of runs followed by the start and length of each run.
+ */
+
+static void
+_cutil_Roaring_write_le(unsigned char *buf, uint64_t val, size_t num_bytes)
+{
+    for (size_t i = 0; i < num_bytes; ++i) {
+        buf[i] = (unsigned char) (val >> (8U * i));
+    }
+}
+
+static uint64_t
+_cutil_Roaring_read_le(const unsigned char *buf, size_t num_bytes)
+{
+    uint64_t val = 0U;
+    for (size_t i = 0; i < num_bytes; ++i) {
+        val |= (uint64_t) buf[i] << (8U * i);
+    }
+    return val;
+}
+
+static cutil_Bool
+_cutil_RoaringSet_has_runs(const _cutil_RoaringSet *rs)
+{
+    for (size_t i = 0; i < rs->num_containers; ++i) {
+        if (rs->containers[i].kind == ROARING_RUN) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t
+_cutil_RoaringContainer_serialized_size(
+  const _cutil_RoaringContainer *container
+)
+{
+    switch (container->kind) {
+    case ROARING_ARRAY:
+        return ROARING_ARRAY_BYTES(container->cardinality);
+    case ROARING_BITMAP:
+        return ROARING_BITMAP_BYTES;
+    default:
+        return ROARING_RUN_BYTES(container->size);
+    }
+}
+
+static unsigned char *
+_cutil_RoaringContainer_serialize(
+  const _cutil_RoaringContainer *container, unsigned char *buf
+)
+{
+    switch (container->kind) {
+    case ROARING_ARRAY:
+        for (uint32_t i = 0U; i < container->size; ++i) {
+            _cutil_Roaring_write_le(buf, container->data.values[i], 2U);
+            buf += 2U;
+        }
+        break;
+    case ROARING_BITMAP:
+        for (uint32_t i = 0U; i < ROARING_BITMAP_WORDS; ++i) {
+            _cutil_Roaring_write_le(buf, container->data.words[i], 8U);
+            buf += 8U;
+        }
+        break;
+    default:
+        _cutil_Roaring_write_le(buf, container->size, 2U);
+        buf += 2U;
+        for (uint32_t i = 0U; i < container->size; ++i) {
+            _cutil_Roaring_write_le(buf, container->data.runs[i].start, 2U);
+            _cutil_Roaring_write_le(
+              buf + 2U, container->data.runs[i].length, 2U
+            );
+            buf += 4U;
+        }
+        break;
+    }
+    return buf;
+}
+
+size_t
+cutil_RoaringSet_serialize(const cutil_Set *set, void *buf, size_t buflen)
+{
+    CUTIL_RETURN_VAL_IF_NULL(set, CUTIL_ERROR_SIZE);
+    const _cutil_RoaringSet *const rs = set->data;
+    const size_t num = rs->num_containers;
+    const cutil_Bool has_runs = _cutil_RoaringSet_has_runs(rs);
+    const cutil_Bool has_offsets
+      = CUTIL_BOOLIFY(!has_runs || num >= ROARING_NO_OFFSET_THRESHOLD);
+    const size_t run_flags_len = has_runs ? (num + 7UL) / 8UL : 0UL;
+
+    size_t header_len = has_runs ? 4UL + run_flags_len : 8UL;
+    header_len += 4UL * num + (has_offsets ? 4UL * num : 0UL);
+    size_t len = header_len;
+    for (size_t i = 0; i < num; ++i) {
+        len += _cutil_RoaringContainer_serialized_size(&rs->containers[i]);
+    }
+    CUTIL_RETURN_VAL_IF_NULL(buf, len);
+    if (buflen < len) {
+        return CUTIL_ERROR_SIZE;
+    }
+
+    unsigned char *out = buf;
+    if (has_runs) {
+        _cutil_Roaring_write_le(
+          out, ROARING_SERIAL_COOKIE | (uint32_t) (num - 1UL) << 16U, 4U
+        );
+        out += 4U;
+        memset(out, 0, run_flags_len);
+        for (size_t i = 0; i < num; ++i) {
+            if (rs->containers[i].kind == ROARING_RUN) {
+                out[i / 8UL] |= (unsigned char) (1U << (i % 8UL));
+            }
+        }
+        out += run_flags_len;
+    } else {
+        _cutil_Roaring_write_le(out, ROARING_SERIAL_COOKIE_NO_RUNS, 4U);
+        _cutil_Roaring_write_le(out + 4U, num, 4U);
+        out += 8U;
+    }
+    for (size_t i = 0; i < num; ++i) {
+        _cutil_Roaring_write_le(out, rs->keys[i], 2U);
+        _cutil_Roaring_write_le(
+          out + 2U, rs->containers[i].cardinality - 1U, 2U
+        );
+        out += 4U;
+    }
+    if (has_offsets) {
+        size_t offset = header_len;
+        for (size_t i = 0; i < num; ++i) {
+            _cutil_Roaring_write_le(out, offset, 4U);
+            out += 4U;
+            offset
+              += _cutil_RoaringContainer_serialized_size(&rs->containers[i]);
+        }
+    }
+    for (size_t i = 0; i < num; ++i) {
+        out = _cutil_RoaringContainer_serialize(&rs->containers[i], out);
+    }
+    return len;
+}
+
+/**
+ * Initializes `container` from the serialized container at `*buf` holding
+ * `cardinality` elements, and advances `*buf` past it.
+ *
+ * @return whether the serialized container is well-formed and fits into the
+ *         buffer ending at `end`
+ */
+static cutil_Bool
+_cutil_RoaringContainer_deserialize(
+  _cutil_RoaringContainer *container, const unsigned char **buf,
+  const unsigned char *end, uint32_t cardinality, cutil_Bool is_run
+)
+{
+    const unsigned char *in = *buf;
+    const size_t avail = (size_t) (end - in);
+
+    if (is_run) {
+        if (avail < 2UL) {
+            return false;
+        }
+        const uint32_t num_runs = (uint32_t) _cutil_Roaring_read_le(in, 2U);
+        if (num_runs == 0U || avail - 2UL < ROARING_RUN_BYTES(num_runs) - 2UL) {
+            return false;
+        }
+        in += 2U;
+        _cutil_RoaringContainer_init_runs(container, num_runs);
+        uint32_t count = 0U;
+        uint32_t min_start = 0U;
+        for (uint32_t i = 0U; i < num_runs; ++i, in += 4U) {
+            _cutil_RoaringRun *const run = &container->data.runs[i];
+            run->start = (uint16_t) _cutil_Roaring_read_le(in, 2U);
+            run->length = (uint16_t) _cutil_Roaring_read_le(in + 2U, 2U);
+            /* Runs have to be sorted, disjoint and not adjacent */
+            if (run->start < min_start
+                || _cutil_Roaring_run_end(run) > UINT16_MAX) {
+                _cutil_RoaringContainer_free(container);
+                return false;
+            }
+            count += run->length + 1U;
+            min_start = _cutil_Roaring_run_end(run) + 2U;
+        }
+        container->size = num_runs;
+        container->cardinality = count;
+        if (count != cardinality) {
+            _cutil_RoaringContainer_free(container);
+            return false;
+        }
+    } else if (cardinality <= ROARING_MAX_ARRAY_CARDINALITY) {
+        if (avail < ROARING_ARRAY_BYTES(cardinality)) {
+            return false;
+        }
+        _cutil_RoaringContainer_init_array(container, cardinality);
+        for (uint32_t i = 0U; i < cardinality; ++i, in += 2U) {
+            const uint16_t val = (uint16_t) _cutil_Roaring_read_le(in, 2U);
+            if (i > 0U && val <= container->data.values[i - 1U]) {
+                _cutil_RoaringContainer_free(container);
+                return false;
+            }
+            container->data.values[i] = val;
+        }
+        container->size = cardinality;
+        container->cardinality = cardinality;
+    } else {
+        if (avail < ROARING_BITMAP_BYTES) {
+            return false;
+        }
+        _cutil_RoaringContainer_init_bitmap(container);
+        for (uint32_t i = 0U; i < ROARING_BITMAP_WORDS; ++i, in += 8U) {
+            container->data.words[i] = _cutil_Roaring_read_le(in, 8U);
+        }
+        container->cardinality
+          = _cutil_Roaring_bitmap_count(container->data.words);
+        if (container->cardinality != cardinality) {
+            _cutil_RoaringContainer_free(container);
+            return false;
+        }
+    }
+    *buf = in;
+    return true;
+}
+
+cutil_Set *
+cutil_RoaringSet_deserialize(const void *buf, size_t buflen)
+{
+    CUTIL_RETURN_NULL_IF_NULL(buf);
+    const unsigned char *in = buf;
+    const unsigned char *const end = in + buflen;
+    if (buflen < 4UL) {
+        cutil_log_warn("RoaringSet deserialize: malformed input");
+        return NULL;
+    }
+
+    const uint32_t cookie = (uint32_t) _cutil_Roaring_read_le(in, 4U);
+    const unsigned char *run_flags = NULL;
+    size_t num = 0UL;
+    if ((cookie & UINT32_C(0xFFFF)) == ROARING_SERIAL_COOKIE
+        && buflen >= 4UL + ((cookie >> 16U) + 8UL) / 8UL) {
+        num = (cookie >> 16U) + 1UL;
+        run_flags = in + 4U;
+        in += 4U + (num + 7UL) / 8UL;
+    } else if (cookie == ROARING_SERIAL_COOKIE_NO_RUNS && buflen >= 8UL) {
+        num = (size_t) _cutil_Roaring_read_le(in + 4U, 4U);
+        in += 8U;
+    } else {
+        cutil_log_warn("RoaringSet deserialize: malformed input");
+        return NULL;
+    }
+    const cutil_Bool has_offsets
+      = CUTIL_BOOLIFY(run_flags == NULL || num >= ROARING_NO_OFFSET_THRESHOLD);
+    const size_t header_len = 4UL * num + (has_offsets ? 4UL * num : 0UL);
+    if (num > ROARING_MAX_CONTAINERS || (size_t) (end - in) < header_len) {
+        cutil_log_warn("RoaringSet deserialize: malformed input");
+        return NULL;
+    }
+
+    /* Containers are stored back to back, so the offsets can be skipped */
+    const unsigned char *const descriptions = in;
+    in += header_len;
+    _cutil_RoaringSet *const rs = _cutil_RoaringSet_create(num);
+    for (size_t i = 0; i < num; ++i) {
+        const uint16_t key
+          = (uint16_t) _cutil_Roaring_read_le(descriptions + 4UL * i, 2U);
+        const uint32_t cardinality
+          = (uint32_t) _cutil_Roaring_read_le(descriptions + 4UL * i + 2U, 2U)
+          + 1U;
+        const cutil_Bool is_run = CUTIL_BOOLIFY(
+          run_flags != NULL && (run_flags[i / 8UL] >> (i % 8UL)) & 1U
+        );
+        if ((i > 0UL && key <= rs->keys[i - 1UL])
+            || !_cutil_RoaringContainer_deserialize(
+              &rs->containers[i], &in, end, cardinality, is_run
+            )) {
+            cutil_log_warn("RoaringSet deserialize: malformed input");
+            _cutil_RoaringSet_free(rs);
+            return NULL;
+        }
+        rs->keys[i] = key;
+        rs->num_containers = i + 1UL;
+    }
+
+    cutil_Set *const set = CUTIL_MALLOC_OBJECT(set);
+    set->vtable = CUTIL_SET_TYPE_ROARING;
+    set->data = rs;
+    return set;
+}
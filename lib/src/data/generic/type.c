@@ -37,6 +37,9 @@ cutil_GenericType_is_valid(const cutil_GenericType *type)
     return true;
 }
 
+extern inline cutil_Bool
+cutil_GenericType_is_trivially_copyable(const cutil_GenericType *type);
+
 cutil_Bool
 cutil_GenericType_equals(
   const cutil_GenericType *lhs, const cutil_GenericType *rhs
@@ -187,6 +190,14 @@ cutil_GenericType_fallback_hash(const cutil_GenericType *type, const void *data)
 extern inline cutil_hash_t
 cutil_GenericType_apply_hash(const cutil_GenericType *type, const void *data);
 
+extern inline cutil_hash_t
+cutil_GenericType_apply_hash_seeded(
+  const cutil_GenericType *type, const void *data, cutil_hash_t seed
+);
+
+extern inline cutil_Bool
+cutil_GenericType_has_seeded_hash(const cutil_GenericType *type);
+
 size_t
 cutil_GenericType_fallback_to_string(
   const cutil_GenericType *type, const void *data, char *buf, size_t buflen
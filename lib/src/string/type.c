@@ -162,6 +162,16 @@ cutil_String_hash_generic(const void *vs)
     return cutil_hash_str(s->str);
 }
 
+cutil_hash_t
+cutil_String_hash_seeded_generic(const void *vs, cutil_hash_t seed)
+{
+    const cutil_String *const s = vs;
+    if (s == NULL || s->length == 0) {
+        return cutil_hash_finalize(seed);
+    }
+    return cutil_hash_bytes(s->str, s->length, seed);
+}
+
 size_t
 cutil_String_to_string_generic(const void *vs, char *buf, size_t buflen)
 {
@@ -190,7 +200,8 @@ static const cutil_GenericType CUTIL_GENERIC_TYPE_STRING_INSTANCE = {
   .deep_equals = &cutil_String_deep_equals_generic,
   .comp = &cutil_String_compare_generic,
   .hash = &cutil_String_hash_generic,
-  .to_string = &cutil_String_to_string_generic
+  .to_string = &cutil_String_to_string_generic,
+  .hash_seeded = &cutil_String_hash_seeded_generic,
 };
 const cutil_GenericType *const CUTIL_GENERIC_TYPE_STRING
   = &CUTIL_GENERIC_TYPE_STRING_INSTANCE;
@@ -352,6 +363,16 @@ cutil_StringView_hash_generic(const void *vsv)
     return cutil_hash_str(sv->str);
 }
 
+cutil_hash_t
+cutil_StringView_hash_seeded_generic(const void *vsv, cutil_hash_t seed)
+{
+    const cutil_StringView *const sv = vsv;
+    if (sv == NULL || sv->length == 0) {
+        return cutil_hash_finalize(seed);
+    }
+    return cutil_hash_bytes(sv->str, sv->length, seed);
+}
+
 size_t
 cutil_StringView_to_string_generic(const void *vsv, char *buf, size_t buflen)
 {
@@ -380,7 +401,8 @@ static const cutil_GenericType CUTIL_GENERIC_TYPE_STRING_VIEW_INSTANCE = {
   .deep_equals = &cutil_StringView_deep_equals_generic,
   .comp = &cutil_StringView_compare_generic,
   .hash = &cutil_StringView_hash_generic,
-  .to_string = &cutil_StringView_to_string_generic
+  .to_string = &cutil_StringView_to_string_generic,
+  .hash_seeded = &cutil_StringView_hash_seeded_generic,
 };
 const cutil_GenericType *const CUTIL_GENERIC_TYPE_STRING_VIEW
   = &CUTIL_GENERIC_TYPE_STRING_VIEW_INSTANCE;
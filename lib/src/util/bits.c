@@ -0,0 +1,10 @@
+#include <cutil/util/bits.h>
+
+extern inline unsigned int
+cutil_bits_ctz_u64(uint64_t val);
+
+extern inline unsigned int
+cutil_bits_clz_u64(uint64_t val);
+
+extern inline unsigned int
+cutil_bits_popcount_u64(uint64_t val);
@@ -61,6 +61,9 @@ cutil_hash_combine_inplace(cutil_hash_t *seed, cutil_hash_t hash);
 extern inline cutil_hash_t
 cutil_hash_combine(cutil_hash_t seed, cutil_hash_t hash);
 
+extern inline cutil_hash_t
+cutil_hash_finalize(cutil_hash_t hash);
+
 /**
  * Trivial hash function declarations
  */
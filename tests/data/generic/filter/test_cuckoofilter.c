@@ -0,0 +1,332 @@
+#include "unity.h"
+#include <cutil/data/generic/filter/cuckoofilter.h>
+
+#include <cutil/data/generic/type.h>
+#include <cutil/status.h>
+#include <cutil/std/inttypes.h>
+#include <cutil/std/stdio.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/string/type.h>
+
+#define NUM_ELEMS ((uint64_t) 20000)
+#define NUM_PROBES ((uint64_t) 100000)
+
+static cutil_Filter *
+_alloc_cuckoo_with_range(uint64_t num, double fpp)
+{
+    cutil_Filter *const filter
+      = cutil_CuckooFilter_alloc(CUTIL_GENERIC_TYPE_U64, (size_t) num, fpp);
+    for (uint64_t i = 0U; i < num; ++i) {
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Filter_add(filter, &i)
+        );
+    }
+    return filter;
+}
+
+/**
+ * Returns the share of `NUM_PROBES` elements never added to `filter` that it
+ * reports as present.
+ */
+static double
+_measure_fpp(const cutil_Filter *filter)
+{
+    uint64_t num_false_positives = 0U;
+    for (uint64_t i = NUM_ELEMS; i < NUM_ELEMS + NUM_PROBES; ++i) {
+        num_false_positives += cutil_Filter_contains(filter, &i);
+    }
+    return (double) num_false_positives / (double) NUM_PROBES;
+}
+
+/* Tests for cutil_CuckooFilter_alloc */
+static void
+_should_allocateEmptyFilter_when_allocCalled(void)
+{
+    /* Act */
+    cutil_Filter *const filter
+      = cutil_CuckooFilter_alloc(CUTIL_GENERIC_TYPE_U64, 100UL, 0.01);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(filter);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_FILTER_TYPE_CUCKOO, filter->vtable);
+    TEST_ASSERT_EQUAL_PTR(
+      CUTIL_GENERIC_TYPE_U64, cutil_Filter_get_elem_type(filter)
+    );
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Filter_get_count(filter));
+    const uint64_t elem = 42U;
+    TEST_ASSERT_FALSE(cutil_Filter_contains(filter, &elem));
+
+    /* Cleanup */
+    cutil_Filter_free(filter);
+}
+
+static void
+_should_returnNull_when_allocArgumentsInvalid(void)
+{
+    /* Act & Assert */
+    TEST_ASSERT_NULL(cutil_CuckooFilter_alloc(NULL, 100UL, 0.01));
+    TEST_ASSERT_NULL(
+      cutil_CuckooFilter_alloc(CUTIL_GENERIC_TYPE_U64, 100UL, -0.5)
+    );
+    TEST_ASSERT_NULL(
+      cutil_CuckooFilter_alloc(CUTIL_GENERIC_TYPE_U64, 100UL, 1.5)
+    );
+}
+
+/* Tests for membership */
+static void
+_should_haveNoFalseNegativesAndTargetFpp_when_filledToCapacity(void)
+{
+    const double fpps[] = {0.1, 0.01, 0.001};
+    for (size_t i = 0; i < sizeof(fpps) / sizeof(fpps[0]); ++i) {
+        /* Arrange */
+        cutil_Filter *const filter
+          = _alloc_cuckoo_with_range(NUM_ELEMS, fpps[i]);
+
+        /* Act & Assert */
+        for (uint64_t j = 0U; j < NUM_ELEMS; ++j) {
+            TEST_ASSERT_TRUE(cutil_Filter_contains(filter, &j));
+        }
+        TEST_ASSERT_EQUAL_size_t(NUM_ELEMS, cutil_Filter_get_count(filter));
+        TEST_ASSERT_LESS_THAN_DOUBLE(2.0 * fpps[i], _measure_fpp(filter));
+
+        /* Cleanup */
+        cutil_Filter_free(filter);
+    }
+}
+
+static void
+_should_useFewBitsPerElement_when_sizedForFpp(void)
+{
+    /* Arrange */
+    cutil_Filter *const filter
+      = cutil_CuckooFilter_alloc(CUTIL_GENERIC_TYPE_U64, NUM_ELEMS, 0.01);
+
+    /* Act */
+    const size_t len = cutil_Filter_serialize(filter, NULL, 0UL);
+
+    /* Assert */
+    TEST_ASSERT_LESS_THAN_size_t(12UL * NUM_ELEMS / 8UL, len);
+
+    /* Cleanup */
+    cutil_Filter_free(filter);
+}
+
+static void
+_should_findStrings_when_stringsAdded(void)
+{
+    /* Arrange */
+    cutil_Filter *const filter
+      = cutil_CuckooFilter_alloc(CUTIL_GENERIC_TYPE_STRING, 500UL, 0.01);
+    char buf[32];
+    for (size_t i = 0; i < 500UL; ++i) {
+        (void) snprintf(buf, sizeof buf, "elem%zu", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        cutil_Filter_add(filter, str);
+        cutil_String_free(str);
+    }
+
+    /* Act & Assert */
+    for (size_t i = 0; i < 500UL; ++i) {
+        (void) snprintf(buf, sizeof buf, "elem%zu", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        TEST_ASSERT_TRUE(cutil_Filter_contains(filter, str));
+        cutil_String_free(str);
+    }
+
+    /* Cleanup */
+    cutil_Filter_free(filter);
+}
+
+/* Tests for cutil_Filter_remove */
+static void
+_should_forgetElements_when_removed(void)
+{
+    /* Arrange */
+    cutil_Filter *const filter = _alloc_cuckoo_with_range(NUM_ELEMS, 0.001);
+    const uint64_t missing = NUM_ELEMS + NUM_PROBES;
+
+    /* Act */
+    size_t num_still_found = 0UL;
+    for (uint64_t i = 0U; i < NUM_ELEMS; i += 2U) {
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Filter_remove(filter, &i)
+        );
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(NUM_ELEMS / 2U, cutil_Filter_get_count(filter));
+    for (uint64_t i = 0U; i < NUM_ELEMS; ++i) {
+        if (i % 2U) {
+            TEST_ASSERT_TRUE(cutil_Filter_contains(filter, &i));
+        } else {
+            num_still_found += cutil_Filter_contains(filter, &i);
+        }
+    }
+    TEST_ASSERT_LESS_THAN_size_t(NUM_ELEMS / 2U / 100U, num_still_found);
+    if (!cutil_Filter_contains(filter, &missing)) {
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_FAILURE, cutil_Filter_remove(filter, &missing)
+        );
+    }
+
+    /* Cleanup */
+    cutil_Filter_free(filter);
+}
+
+static void
+_should_keepCount_when_duplicatesAddedAndRemoved(void)
+{
+    /* Arrange */
+    cutil_Filter *const filter
+      = cutil_CuckooFilter_alloc(CUTIL_GENERIC_TYPE_U64, 100UL, 0.01);
+    const uint64_t elem = 5U;
+    cutil_Filter_add(filter, &elem);
+    cutil_Filter_add(filter, &elem);
+
+    /* Act & Assert */
+    TEST_ASSERT_EQUAL_size_t(2UL, cutil_Filter_get_count(filter));
+    cutil_Filter_remove(filter, &elem);
+    TEST_ASSERT_TRUE(cutil_Filter_contains(filter, &elem));
+    cutil_Filter_remove(filter, &elem);
+    TEST_ASSERT_FALSE(cutil_Filter_contains(filter, &elem));
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Filter_get_count(filter));
+
+    /* Cleanup */
+    cutil_Filter_free(filter);
+}
+
+static void
+_should_failAddWithoutLosingElements_when_full(void)
+{
+    /* Arrange */
+    cutil_Filter *const filter
+      = cutil_CuckooFilter_alloc(CUTIL_GENERIC_TYPE_U64, 1000UL, 0.01);
+    uint64_t num_added = 0U;
+
+    /* Act */
+    while (cutil_Filter_add(filter, &num_added) == CUTIL_STATUS_SUCCESS) {
+        ++num_added;
+    }
+
+    /* Assert */
+    TEST_ASSERT_GREATER_OR_EQUAL_size_t(1000UL, (size_t) num_added);
+    TEST_ASSERT_EQUAL_size_t(num_added, cutil_Filter_get_count(filter));
+    for (uint64_t i = 0U; i < num_added; ++i) {
+        TEST_ASSERT_TRUE(cutil_Filter_contains(filter, &i));
+    }
+
+    /* Removing an element keeps all others, including a homeless one */
+    const uint64_t first = 0U;
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_SUCCESS, cutil_Filter_remove(filter, &first)
+    );
+    for (uint64_t i = 1U; i < num_added; ++i) {
+        TEST_ASSERT_TRUE(cutil_Filter_contains(filter, &i));
+    }
+
+    /* Cleanup */
+    cutil_Filter_free(filter);
+}
+
+/* Tests for serialization */
+static void
+_should_restoreFilter_when_serializedAndDeserialized(void)
+{
+    /* Arrange */
+    cutil_Filter *const filter = _alloc_cuckoo_with_range(NUM_ELEMS, 0.01);
+    const size_t len = cutil_Filter_serialize(filter, NULL, 0UL);
+    unsigned char *const buf = malloc(len);
+
+    /* Act */
+    TEST_ASSERT_EQUAL_size_t(
+      CUTIL_ERROR_SIZE, cutil_Filter_serialize(filter, buf, len - 1UL)
+    );
+    TEST_ASSERT_EQUAL_size_t(len, cutil_Filter_serialize(filter, buf, len));
+    cutil_Filter *const restored
+      = cutil_CuckooFilter_deserialize(CUTIL_GENERIC_TYPE_U64, buf, len);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(restored);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_FILTER_TYPE_CUCKOO, restored->vtable);
+    TEST_ASSERT_EQUAL_size_t(NUM_ELEMS, cutil_Filter_get_count(restored));
+    for (uint64_t i = 0U; i < NUM_ELEMS + NUM_PROBES; ++i) {
+        TEST_ASSERT_EQUAL(
+          cutil_Filter_contains(filter, &i), cutil_Filter_contains(restored, &i)
+        );
+    }
+    for (uint64_t i = 0U; i < NUM_ELEMS; ++i) {
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Filter_remove(restored, &i)
+        );
+    }
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Filter_get_count(restored));
+
+    /* Cleanup */
+    cutil_Filter_free(restored);
+    free(buf);
+    cutil_Filter_free(filter);
+}
+
+static void
+_should_returnNull_when_deserializingMalformedInput(void)
+{
+    /* Arrange */
+    cutil_Filter *const filter = _alloc_cuckoo_with_range(100U, 0.01);
+    const size_t len = cutil_Filter_serialize(filter, NULL, 0UL);
+    unsigned char *const buf = malloc(len);
+    cutil_Filter_serialize(filter, buf, len);
+
+    /* Act & Assert */
+    TEST_ASSERT_NULL(
+      cutil_CuckooFilter_deserialize(CUTIL_GENERIC_TYPE_U64, buf, 35UL)
+    );
+    TEST_ASSERT_NULL(
+      cutil_CuckooFilter_deserialize(CUTIL_GENERIC_TYPE_U64, buf, len - 1UL)
+    );
+    /* Fingerprints wider than 16 bits */
+    buf[4] = 17U;
+    TEST_ASSERT_NULL(
+      cutil_CuckooFilter_deserialize(CUTIL_GENERIC_TYPE_U64, buf, len)
+    );
+    cutil_Filter_serialize(filter, buf, len);
+    buf[0] ^= 0xFFU;
+    TEST_ASSERT_NULL(
+      cutil_CuckooFilter_deserialize(CUTIL_GENERIC_TYPE_U64, buf, len)
+    );
+
+    /* Cleanup */
+    free(buf);
+    cutil_Filter_free(filter);
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_allocateEmptyFilter_when_allocCalled);
+    RUN_TEST(_should_returnNull_when_allocArgumentsInvalid);
+    RUN_TEST(_should_haveNoFalseNegativesAndTargetFpp_when_filledToCapacity);
+    RUN_TEST(_should_useFewBitsPerElement_when_sizedForFpp);
+    RUN_TEST(_should_findStrings_when_stringsAdded);
+
+    /* Removal tests */
+    RUN_TEST(_should_forgetElements_when_removed);
+    RUN_TEST(_should_keepCount_when_duplicatesAddedAndRemoved);
+    RUN_TEST(_should_failAddWithoutLosingElements_when_full);
+
+    /* Serialization tests */
+    RUN_TEST(_should_restoreFilter_when_serializedAndDeserialized);
+    RUN_TEST(_should_returnNull_when_deserializingMalformedInput);
+
+    return UNITY_END();
+}
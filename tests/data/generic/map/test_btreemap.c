@@ -0,0 +1,446 @@
+#include "unity.h"
+#include <cutil/data/generic/map/btreemap.h>
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/std/stdio.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/string/type.h>
+#include <cutil/util/macro.h>
+
+/**
+ * Returns a permutation of [0, num) that is scattered enough to exercise
+ * splits and merges everywhere in the tree.
+ */
+static int *
+_alloc_shuffled_keys(int num)
+{
+    int *const keys = malloc((size_t) num * sizeof *keys);
+    for (int i = 0; i < num; ++i) {
+        keys[i] = i;
+    }
+    unsigned long state = 12345UL;
+    for (int i = num - 1; i > 0; --i) {
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        const int j = (int) ((state >> 33U) % (unsigned long) (i + 1));
+        const int tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+    return keys;
+}
+
+/**
+ * Asserts that iterating `map` yields exactly the keys in [0, num) for which
+ * `present` is set, in ascending order.
+ */
+static void
+_assert_ordered_keys(const cutil_Map *map, const cutil_Bool *present, int num)
+{
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    int expected = 0;
+    size_t num_visited = 0UL;
+    while (cutil_ConstIterator_next(it)) {
+        while (expected < num && !present[expected]) {
+            ++expected;
+        }
+        const int key = *(const int *) cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_EQUAL_INT(expected, key);
+        ++expected;
+        ++num_visited;
+    }
+    TEST_ASSERT_EQUAL_size_t(num_visited, cutil_Map_get_count(map));
+    cutil_ConstIterator_free(it);
+}
+
+/* Tests for cutil_BTreeMap_alloc */
+static void
+_should_allocateBTreeMap_when_createdWithValidTypes(void)
+{
+    /* Arrange */
+    const cutil_GenericType *const key_type = CUTIL_GENERIC_TYPE_INT;
+    const cutil_GenericType *const val_type = CUTIL_GENERIC_TYPE_DOUBLE;
+
+    /* Act */
+    cutil_Map *const map = cutil_BTreeMap_alloc(key_type, val_type);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(map);
+    TEST_ASSERT_NOT_NULL(map->data);
+    TEST_ASSERT_EQUAL_STRING("cutil_BTreeMap", map->vtable->name);
+    TEST_ASSERT_EQUAL_PTR(key_type, cutil_Map_get_key_type(map));
+    TEST_ASSERT_EQUAL_PTR(val_type, cutil_Map_get_val_type(map));
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_returnFailure_when_emptyMapQueried(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_BTreeMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int key = 1;
+    int out = 0;
+
+    /* Act & Assert */
+    TEST_ASSERT_FALSE(cutil_Map_contains(map, &key));
+    TEST_ASSERT_NULL(cutil_Map_get_ptr(map, &key));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Map_remove(map, &key));
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_FAILURE, cutil_BTreeMap_get_min(map, &out)
+    );
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_FAILURE, cutil_BTreeMap_get_max(map, &out)
+    );
+    cutil_ConstIterator *const it = cutil_BTreeMap_lower_bound(map, &key);
+    TEST_ASSERT_FALSE(cutil_ConstIterator_next(it));
+
+    /* Cleanup */
+    cutil_ConstIterator_free(it);
+    cutil_Map_free(map);
+}
+
+/* Tests for insertion and ordering */
+static void
+_should_iterateInOrder_when_keysInsertedShuffled(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_BTreeMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int NUM_ENTRIES = 5000;
+    int *const keys = _alloc_shuffled_keys(NUM_ENTRIES);
+    cutil_Bool *const present = malloc((size_t) NUM_ENTRIES * sizeof *present);
+
+    /* Act */
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        const int val = 2 * keys[i];
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Map_set(map, &keys[i], &val)
+        );
+        present[i] = CUTIL_TRUE;
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(NUM_ENTRIES, cutil_Map_get_count(map));
+    _assert_ordered_keys(map, present, NUM_ENTRIES);
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        int val = -1;
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Map_get(map, &i, &val)
+        );
+        TEST_ASSERT_EQUAL_INT(2 * i, val);
+    }
+    int min = -1;
+    int max = -1;
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_SUCCESS, cutil_BTreeMap_get_min(map, &min)
+    );
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_SUCCESS, cutil_BTreeMap_get_max(map, &max)
+    );
+    TEST_ASSERT_EQUAL_INT(0, min);
+    TEST_ASSERT_EQUAL_INT(NUM_ENTRIES - 1, max);
+
+    /* Cleanup */
+    free(keys);
+    free(present);
+    cutil_Map_free(map);
+}
+
+static void
+_should_overwriteValue_when_keyAlreadyPresent(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_BTreeMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < 200; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    for (int i = 0; i < 200; ++i) {
+        const int val = -i;
+        cutil_Map_set(map, &i, &val);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(200UL, cutil_Map_get_count(map));
+    for (int i = 0; i < 200; ++i) {
+        TEST_ASSERT_EQUAL_INT(-i, *(const int *) cutil_Map_get_ptr(map, &i));
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_countOccurrences_when_valuesUpdatedInPlace(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_BTreeMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int zero = 0;
+    size_t num_inserted = 0UL;
+
+    /* Act */
+    for (int i = 0; i < 1000; ++i) {
+        const int key = (i * 37) % 101;
+        cutil_Bool inserted = CUTIL_FALSE;
+        int *const count = cutil_Map_get_or_insert(map, &key, &zero, &inserted);
+        TEST_ASSERT_NOT_NULL(count);
+        ++*count;
+        num_inserted += inserted ? 1UL : 0UL;
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(101UL, num_inserted);
+    int total = 0;
+    for (int key = 0; key < 101; ++key) {
+        total += *(const int *) cutil_Map_get_ptr(map, &key);
+    }
+    TEST_ASSERT_EQUAL_INT(1000, total);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for removal */
+static void
+_should_keepOrder_when_keysRemovedShuffled(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_BTreeMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int NUM_ENTRIES = 5000;
+    int *const keys = _alloc_shuffled_keys(NUM_ENTRIES);
+    cutil_Bool *const present = malloc((size_t) NUM_ENTRIES * sizeof *present);
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        cutil_Map_set(map, &i, &i);
+        present[i] = CUTIL_TRUE;
+    }
+
+    /* Act & Assert */
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &keys[i])
+        );
+        present[keys[i]] = CUTIL_FALSE;
+        if (i % 500 == 0) {
+            _assert_ordered_keys(map, present, NUM_ENTRIES);
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+    _assert_ordered_keys(map, present, NUM_ENTRIES);
+
+    /* Refill after the tree shrank back to nothing */
+    for (int i = 0; i < 100; ++i) {
+        cutil_Map_set(map, &keys[i], &i);
+        present[keys[i]] = CUTIL_TRUE;
+    }
+    _assert_ordered_keys(map, present, NUM_ENTRIES);
+
+    /* Cleanup */
+    free(keys);
+    free(present);
+    cutil_Map_free(map);
+}
+
+static void
+_should_releaseOwnedKeys_when_stringKeysRemoved(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_BTreeMap_alloc(CUTIL_GENERIC_TYPE_STRING, CUTIL_GENERIC_TYPE_INT);
+    char buf[32];
+    for (int i = 0; i < 500; ++i) {
+        snprintf(buf, sizeof buf, "key-%04d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        cutil_Map_set(map, str, &i);
+        cutil_String_free(str);
+    }
+
+    /* Act */
+    for (int i = 0; i < 500; i += 2) {
+        snprintf(buf, sizeof buf, "key-%04d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, str));
+        cutil_String_free(str);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(250UL, cutil_Map_get_count(map));
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    int expected = 1;
+    while (cutil_ConstIterator_next(it)) {
+        const cutil_String *const key = cutil_ConstIterator_get_ptr(it);
+        snprintf(buf, sizeof buf, "key-%04d", expected);
+        TEST_ASSERT_EQUAL_STRING(buf, key->str);
+        expected += 2;
+    }
+    cutil_ConstIterator_free(it);
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+
+    /* Cleanup */
+    cutil_Map_free(dup);
+    cutil_Map_free(map);
+}
+
+static void
+_should_removeEntries_when_removedThroughIterator(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_BTreeMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int NUM_ENTRIES = 1000;
+    cutil_Bool *const present = malloc((size_t) NUM_ENTRIES * sizeof *present);
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        cutil_Map_set(map, &i, &i);
+        present[i] = i % 3 != 0;
+    }
+
+    /* Act */
+    cutil_Iterator *const it = cutil_Map_get_iterator(map);
+    int expected = 0;
+    while (cutil_Iterator_next(it)) {
+        const int key = *(const int *) cutil_Iterator_get_ptr(it);
+        TEST_ASSERT_EQUAL_INT(expected++, key);
+        if (key % 3 == 0) {
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Iterator_remove(it)
+            );
+        }
+    }
+    cutil_Iterator_free(it);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(NUM_ENTRIES, expected);
+    _assert_ordered_keys(map, present, NUM_ENTRIES);
+
+    /* Cleanup */
+    free(present);
+    cutil_Map_free(map);
+}
+
+/* Tests for range iterators */
+static void
+_should_startAtBound_when_rangeIteratorsCreated(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_BTreeMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < 3000; i += 3) {
+        cutil_Map_set(map, &i, &i);
+    }
+    const int bounds[] = {-5, 0, 1, 3, 1499, 1500, 2997, 2998};
+    const size_t NUM_BOUNDS = CUTIL_GET_NATIVE_ARRAY_SIZE(bounds);
+
+    for (size_t i = 0; i < NUM_BOUNDS; ++i) {
+        const int bound = bounds[i];
+        int first_lower = bound < 0 ? 0 : (bound + 2) / 3 * 3;
+        int first_upper = bound < 0 ? 0 : bound / 3 * 3 + 3;
+
+        /* Act */
+        cutil_ConstIterator *const lower
+          = cutil_BTreeMap_lower_bound(map, &bound);
+        cutil_ConstIterator *const upper
+          = cutil_BTreeMap_upper_bound(map, &bound);
+
+        /* Assert */
+        for (int key = first_lower; key < 3000; key += 3) {
+            TEST_ASSERT_TRUE(cutil_ConstIterator_next(lower));
+            TEST_ASSERT_EQUAL_INT(
+              key, *(const int *) cutil_ConstIterator_get_ptr(lower)
+            );
+        }
+        TEST_ASSERT_FALSE(cutil_ConstIterator_next(lower));
+        for (int key = first_upper; key < 3000; key += 3) {
+            TEST_ASSERT_TRUE(cutil_ConstIterator_next(upper));
+            TEST_ASSERT_EQUAL_INT(
+              key, *(const int *) cutil_ConstIterator_get_ptr(upper)
+            );
+        }
+        TEST_ASSERT_FALSE(cutil_ConstIterator_next(upper));
+
+        /* Rewinding restarts at the bound */
+        cutil_ConstIterator_rewind(lower);
+        TEST_ASSERT_EQUAL(first_lower < 3000, cutil_ConstIterator_next(lower));
+
+        /* Cleanup */
+        cutil_ConstIterator_free(lower);
+        cutil_ConstIterator_free(upper);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for copy and duplicate */
+static void
+_should_preserveAllEntries_when_duplicatedAndCopied(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_BTreeMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < 2000; ++i) {
+        const int val = i * i;
+        cutil_Map_set(map, &i, &val);
+    }
+    cutil_Map *const copy
+      = cutil_BTreeMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int stale = -1;
+    cutil_Map_set(copy, &stale, &stale);
+
+    /* Act */
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    cutil_Map_copy(copy, map);
+
+    /* Assert */
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, copy));
+    TEST_ASSERT_FALSE(cutil_Map_contains(copy, &stale));
+
+    /* Duplicates are independent of the original */
+    const int key = 10;
+    cutil_Map_remove(dup, &key);
+    TEST_ASSERT_TRUE(cutil_Map_contains(map, &key));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_Map_free(dup);
+    cutil_Map_free(copy);
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_allocateBTreeMap_when_createdWithValidTypes);
+    RUN_TEST(_should_returnFailure_when_emptyMapQueried);
+
+    RUN_TEST(_should_iterateInOrder_when_keysInsertedShuffled);
+    RUN_TEST(_should_overwriteValue_when_keyAlreadyPresent);
+    RUN_TEST(_should_countOccurrences_when_valuesUpdatedInPlace);
+
+    RUN_TEST(_should_keepOrder_when_keysRemovedShuffled);
+    RUN_TEST(_should_releaseOwnedKeys_when_stringKeysRemoved);
+    RUN_TEST(_should_removeEntries_when_removedThroughIterator);
+
+    RUN_TEST(_should_startAtBound_when_rangeIteratorsCreated);
+
+    RUN_TEST(_should_preserveAllEntries_when_duplicatedAndCopied);
+
+    return UNITY_END();
+}
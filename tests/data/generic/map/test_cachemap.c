@@ -0,0 +1,375 @@
+#include "unity.h"
+#include <cutil/data/generic/map/cachemap.h>
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/std/stdio.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/string/type.h>
+#include <cutil/util/macro.h>
+
+/**
+ * Weighs entries by the length of their string value.
+ */
+static size_t
+_weigh_string_val(const void *key, const void *val)
+{
+    (void) key;
+    const cutil_String *const str = val;
+    return str->length;
+}
+
+/* Tests for cutil_CacheMap_alloc */
+static void
+_should_allocateEmptyMap_when_argumentsValid(void)
+{
+    /* Act */
+    cutil_Map *const map = cutil_CacheMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_DOUBLE, 10UL,
+      CUTIL_CACHE_POLICY_LRU
+    );
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(map);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_MAP_TYPE_CACHE, map->vtable);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_GENERIC_TYPE_INT, cutil_Map_get_key_type(map));
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_CacheMap_get_weight(map));
+    TEST_ASSERT_NULL(cutil_CacheMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 0UL,
+      CUTIL_CACHE_POLICY_LRU
+    ));
+    TEST_ASSERT_NULL(cutil_CacheMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 10UL, NULL
+    ));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for LRU eviction */
+static void
+_should_evictLeastRecentlyUsed_when_maxEntriesExceeded(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CacheMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 3UL,
+      CUTIL_CACHE_POLICY_LRU
+    );
+    for (int i = 0; i < 3; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    const int touched = 0;
+    TEST_ASSERT_NOT_NULL(cutil_Map_get_ptr(map, &touched));
+    const int key = 3;
+    cutil_Map_set(map, &key, &key);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(3UL, cutil_Map_get_count(map));
+    const int one = 1;
+    TEST_ASSERT_FALSE(cutil_Map_contains(map, &one));
+    for (int i = 0; i < 4; ++i) {
+        TEST_ASSERT_EQUAL(i != 1, cutil_Map_contains(map, &i));
+    }
+    cutil_CacheStats stats;
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_SUCCESS, cutil_CacheMap_get_stats(map, &stats)
+    );
+    TEST_ASSERT_EQUAL_size_t(1UL, stats.hits);
+    TEST_ASSERT_EQUAL_size_t(1UL, stats.evictions);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_stayWithinBudget_when_entriesWeighed(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CacheMap_alloc_with_budget(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_STRING, 20UL,
+      &_weigh_string_val, CUTIL_CACHE_POLICY_LRU
+    );
+    cutil_String *const small = cutil_String_from_string("12345");
+    cutil_String *const large = cutil_String_from_string("1234567890");
+    cutil_String *const huge
+      = cutil_String_from_string("123456789012345678901");
+
+    /* Act & Assert */
+    for (int i = 0; i < 4; ++i) {
+        cutil_Map_set(map, &i, small);
+    }
+    TEST_ASSERT_EQUAL_size_t(20UL, cutil_CacheMap_get_weight(map));
+    const int key = 10;
+    cutil_Map_set(map, &key, large);
+    TEST_ASSERT_EQUAL_size_t(3UL, cutil_Map_get_count(map));
+    TEST_ASSERT_EQUAL_size_t(20UL, cutil_CacheMap_get_weight(map));
+    const int first = 0;
+    TEST_ASSERT_FALSE(cutil_Map_contains(map, &first));
+
+    const int three = 3;
+    cutil_Map_set(map, &three, large);
+    TEST_ASSERT_EQUAL_size_t(2UL, cutil_Map_get_count(map));
+    TEST_ASSERT_EQUAL_size_t(20UL, cutil_CacheMap_get_weight(map));
+
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_FAILURE, cutil_Map_set(map, &first, huge)
+    );
+    TEST_ASSERT_EQUAL_size_t(2UL, cutil_Map_get_count(map));
+
+    /* Cleanup */
+    cutil_String_free(small);
+    cutil_String_free(large);
+    cutil_String_free(huge);
+    cutil_Map_free(map);
+}
+
+/* Tests for W-TinyLFU eviction */
+static void
+_should_keepFrequentKeys_when_scanned(void)
+{
+    /* Arrange */
+    const size_t max_entries = 100UL;
+    cutil_Map *const tinylfu = cutil_CacheMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, max_entries,
+      CUTIL_CACHE_POLICY_TINYLFU
+    );
+    cutil_Map *const lru = cutil_CacheMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, max_entries,
+      CUTIL_CACHE_POLICY_LRU
+    );
+    cutil_Map *const maps[] = {tinylfu, lru};
+
+    /* Act */
+    for (size_t m = 0; m < CUTIL_GET_NATIVE_ARRAY_SIZE(maps); ++m) {
+        for (int round = 0; round < 5; ++round) {
+            for (int i = 0; i < 50; ++i) {
+                cutil_Map_get_or_insert(maps[m], &i, &i, NULL);
+            }
+        }
+        for (int i = 1000; i < 11000; ++i) {
+            cutil_Map_get_or_insert(maps[m], &i, &i, NULL);
+            if (i % 100 == 0) {
+                for (int j = 0; j < 50; ++j) {
+                    cutil_Map_get_ptr(maps[m], &j);
+                }
+            }
+        }
+    }
+
+    /* Assert */
+    size_t num_hot_tinylfu = 0UL;
+    size_t num_hot_lru = 0UL;
+    for (int i = 0; i < 50; ++i) {
+        num_hot_tinylfu += cutil_Map_contains(tinylfu, &i);
+        num_hot_lru += cutil_Map_contains(lru, &i);
+    }
+    TEST_ASSERT_EQUAL_size_t(max_entries, cutil_Map_get_count(tinylfu));
+    TEST_ASSERT_EQUAL_size_t(max_entries, cutil_Map_get_count(lru));
+    TEST_ASSERT_GREATER_OR_EQUAL_size_t(45UL, num_hot_tinylfu);
+    TEST_ASSERT_LESS_THAN_size_t(num_hot_tinylfu, num_hot_lru);
+    cutil_CacheStats stats;
+    cutil_CacheMap_get_stats(tinylfu, &stats);
+    TEST_ASSERT_GREATER_THAN_size_t(0UL, stats.rejections);
+
+    /* Cleanup */
+    cutil_Map_free(tinylfu);
+    cutil_Map_free(lru);
+}
+
+/* Tests for counters */
+static void
+_should_countHitsAndMisses_when_lookedUp(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CacheMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 10UL,
+      CUTIL_CACHE_POLICY_TINYLFU
+    );
+    for (int i = 0; i < 5; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    int val;
+    for (int i = 0; i < 8; ++i) {
+        cutil_Map_get(map, &i, &val);
+    }
+    cutil_Bool inserted;
+    const int key = 7;
+    cutil_Map_get_or_insert(map, &key, &key, &inserted);
+    cutil_Map_contains(map, &key);
+
+    /* Assert */
+    TEST_ASSERT_TRUE(inserted);
+    cutil_CacheStats stats;
+    cutil_CacheMap_get_stats(map, &stats);
+    TEST_ASSERT_EQUAL_size_t(5UL, stats.hits);
+    TEST_ASSERT_EQUAL_size_t(4UL, stats.misses);
+    TEST_ASSERT_EQUAL_DOUBLE(5.0 / 9.0, cutil_CacheStats_get_hit_rate(&stats));
+    cutil_CacheMap_reset_stats(map);
+    cutil_CacheMap_get_stats(map, &stats);
+    TEST_ASSERT_EQUAL_size_t(0UL, stats.hits);
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, cutil_CacheStats_get_hit_rate(&stats));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_notCountAccesses_when_comparedHashedAndPrinted(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CacheMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 3UL,
+      CUTIL_CACHE_POLICY_TINYLFU
+    );
+    for (int i = 0; i < 3; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    char buf[64];
+
+    /* Act */
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+    TEST_ASSERT_EQUAL_INT(0, cutil_Map_compare(map, dup));
+    cutil_Map_hash(map);
+    cutil_Map_to_string(map, buf, sizeof buf);
+
+    /* Assert */
+    cutil_CacheStats stats;
+    cutil_CacheMap_get_stats(map, &stats);
+    TEST_ASSERT_EQUAL_size_t(0UL, stats.hits);
+    TEST_ASSERT_EQUAL_size_t(0UL, stats.misses);
+    const int key = 3;
+    cutil_Map_set(map, &key, &key);
+    cutil_Map_set(dup, &key, &key);
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_Map_free(dup);
+}
+
+/* Tests for iterators, copy and duplicate */
+static void
+_should_keepEvictionOrder_when_removedThroughIteratorAndCopied(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CacheMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 500UL,
+      CUTIL_CACHE_POLICY_LRU
+    );
+    for (int i = 0; i < 1000; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+    cutil_Iterator *const it = cutil_Map_get_iterator(map);
+    while (cutil_Iterator_next(it)) {
+        const int *const key = cutil_Iterator_get_ptr(it);
+        if (*key % 2 == 1) {
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Iterator_remove(it)
+            );
+        }
+    }
+    cutil_Iterator_free(it);
+    cutil_Map *const copy = cutil_CacheMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 10UL,
+      CUTIL_CACHE_POLICY_TINYLFU
+    );
+
+    /* Act */
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    cutil_Map_copy(copy, map);
+
+    /* Assert */
+    cutil_Map *const maps[] = {map, dup, copy};
+    for (size_t m = 0; m < CUTIL_GET_NATIVE_ARRAY_SIZE(maps); ++m) {
+        TEST_ASSERT_EQUAL_size_t(250UL, cutil_Map_get_count(maps[m]));
+        for (int i = 1000; i < 1251; ++i) {
+            cutil_Map_set(maps[m], &i, &i);
+        }
+        TEST_ASSERT_EQUAL_size_t(500UL, cutil_Map_get_count(maps[m]));
+        const int oldest = 500;
+        const int newest = 998;
+        TEST_ASSERT_FALSE(cutil_Map_contains(maps[m], &oldest));
+        TEST_ASSERT_TRUE(cutil_Map_contains(maps[m], &newest));
+    }
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, copy));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_Map_free(dup);
+    cutil_Map_free(copy);
+}
+
+static void
+_should_insertEntries_when_churnedPastDummyResize(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CacheMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 1000UL,
+      CUTIL_CACHE_POLICY_LRU
+    );
+    for (int i = 0; i < 9; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+    const int last = 8;
+    cutil_Map_remove(map, &last);
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+
+    /* Act & Assert */
+    cutil_Map *const maps[] = {map, dup};
+    for (size_t m = 0; m < CUTIL_GET_NATIVE_ARRAY_SIZE(maps); ++m) {
+        for (int i = 100; i < 200; ++i) {
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Map_set(maps[m], &i, &i)
+            );
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Map_remove(maps[m], &i)
+            );
+        }
+        TEST_ASSERT_EQUAL_size_t(8UL, cutil_Map_get_count(maps[m]));
+        for (int i = 0; i < 8; ++i) {
+            const int *const val = cutil_Map_get_ptr(maps[m], &i);
+            TEST_ASSERT_NOT_NULL(val);
+            TEST_ASSERT_EQUAL_INT(i, *val);
+        }
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_Map_free(dup);
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_allocateEmptyMap_when_argumentsValid);
+
+    RUN_TEST(_should_evictLeastRecentlyUsed_when_maxEntriesExceeded);
+    RUN_TEST(_should_stayWithinBudget_when_entriesWeighed);
+
+    RUN_TEST(_should_keepFrequentKeys_when_scanned);
+
+    RUN_TEST(_should_countHitsAndMisses_when_lookedUp);
+    RUN_TEST(_should_notCountAccesses_when_comparedHashedAndPrinted);
+
+    RUN_TEST(_should_keepEvictionOrder_when_removedThroughIteratorAndCopied);
+    RUN_TEST(_should_insertEntries_when_churnedPastDummyResize);
+
+    return UNITY_END();
+}
@@ -0,0 +1,311 @@
+#include "unity.h"
+#include <cutil/data/generic/map/compact_hashmap.h>
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/std/stdio.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/string/type.h>
+#include <cutil/util/macro.h>
+
+/**
+ * Asserts that the keys of `map` are visited in the order given by `keys`.
+ */
+static void
+_assert_key_order(const cutil_Map *map, const int *keys, size_t num)
+{
+    TEST_ASSERT_EQUAL_size_t(num, cutil_Map_get_count(map));
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    for (size_t i = 0; i < num; ++i) {
+        TEST_ASSERT_TRUE(cutil_ConstIterator_next(it));
+        TEST_ASSERT_EQUAL_INT(
+          keys[i], *(const int *) cutil_ConstIterator_get_ptr(it)
+        );
+    }
+    TEST_ASSERT_FALSE(cutil_ConstIterator_next(it));
+    TEST_ASSERT_NULL(cutil_ConstIterator_get_ptr(it));
+    cutil_ConstIterator_free(it);
+}
+
+/* Tests for cutil_CompactHashMap_alloc */
+static void
+_should_allocateEmptyMap_when_typesValid(void)
+{
+    /* Act */
+    cutil_Map *const map = cutil_CompactHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_DOUBLE
+    );
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(map);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_MAP_TYPE_COMPACT_HASHMAP, map->vtable);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_GENERIC_TYPE_INT, cutil_Map_get_key_type(map));
+    TEST_ASSERT_EQUAL_PTR(
+      CUTIL_GENERIC_TYPE_DOUBLE, cutil_Map_get_val_type(map)
+    );
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+    TEST_ASSERT_NULL(cutil_CompactHashMap_alloc(NULL, CUTIL_GENERIC_TYPE_INT));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for insertion order */
+static void
+_should_iterateInInsertionOrder_when_valuesUpdatedAndKeysReinserted(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CompactHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    const int keys[] = {42, 7, -3, 100, 0};
+    for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(keys); ++i) {
+        const int val = (int) i;
+        cutil_Map_set(map, &keys[i], &val);
+    }
+
+    /* Act */
+    const int val = 1000;
+    cutil_Map_set(map, &keys[0], &val);
+    cutil_Map_remove(map, &keys[1]);
+    cutil_Map_set(map, &keys[1], &val);
+
+    /* Assert */
+    const int expected[] = {42, -3, 100, 0, 7};
+    _assert_key_order(map, expected, CUTIL_GET_NATIVE_ARRAY_SIZE(expected));
+    const int *const val0 = cutil_Map_get_ptr(map, &keys[0]);
+    const int *const val2 = cutil_Map_get_ptr(map, &keys[2]);
+    TEST_ASSERT_EQUAL_INT(1000, *val0);
+    TEST_ASSERT_EQUAL_INT(2, *val2);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_keepEntriesAndOrder_when_manyKeysInsertedAndRemoved(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CompactHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    const int N = 100000;
+    int *const expected = malloc((size_t) N * sizeof *expected);
+    size_t num_expected = 0UL;
+
+    /* Act */
+    for (int i = 0; i < N; ++i) {
+        const int key = i * 31 % N;
+        const int val = -key;
+        cutil_Map_set(map, &key, &val);
+        if (i % 3 == 2) {
+            const int old = (i - 1) * 31 % N;
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &old)
+            );
+        }
+    }
+
+    /* Assert */
+    for (int i = 0; i < N; ++i) {
+        const int key = i * 31 % N;
+        const int *const val = cutil_Map_get_ptr(map, &key);
+        if (i % 3 == 1) {
+            TEST_ASSERT_NULL(val);
+            continue;
+        }
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT(-key, *val);
+        expected[num_expected++] = key;
+    }
+    _assert_key_order(map, expected, num_expected);
+
+    /* Cleanup */
+    free(expected);
+    cutil_Map_free(map);
+}
+
+/* Tests for iterators */
+static void
+_should_removeEveryOtherKey_when_removedThroughIterator(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CompactHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    for (int i = 0; i < 1000; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    cutil_Iterator *const it = cutil_Map_get_iterator(map);
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Iterator_remove(it));
+    int num = 0;
+    while (cutil_Iterator_next(it)) {
+        if (num++ % 2 == 0) {
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Iterator_remove(it)
+            );
+            TEST_ASSERT_NULL(cutil_Iterator_get_ptr(it));
+        }
+    }
+    cutil_Iterator_free(it);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(1000, num);
+    int expected[500];
+    for (int i = 0; i < 500; ++i) {
+        expected[i] = 2 * i + 1;
+    }
+    _assert_key_order(map, expected, 500UL);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_manageStringKeys_when_entriesRemovedAndResized(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CompactHashMap_alloc(
+      CUTIL_GENERIC_TYPE_STRING, CUTIL_GENERIC_TYPE_STRING
+    );
+    char buf[32];
+
+    /* Act */
+    for (int i = 0; i < 2000; ++i) {
+        snprintf(buf, sizeof buf, "key%d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        cutil_Map_set(map, str, str);
+        if (i % 2 == 1) {
+            cutil_Map_remove(map, str);
+        }
+        cutil_String_free(str);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(1000UL, cutil_Map_get_count(map));
+    for (int i = 0; i < 2000; ++i) {
+        snprintf(buf, sizeof buf, "key%d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        const cutil_String *const val = cutil_Map_get_ptr(map, str);
+        if (i % 2 == 1) {
+            TEST_ASSERT_NULL(val);
+        } else {
+            TEST_ASSERT_NOT_NULL(val);
+            TEST_ASSERT_EQUAL_STRING(buf, val->str);
+        }
+        cutil_String_free(str);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for copy, duplicate and capacity management */
+static void
+_should_preserveOrder_when_duplicatedAndCopied(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CompactHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    int expected[300];
+    size_t num_expected = 0UL;
+    for (int i = 0; i < 600; ++i) {
+        const int key = 599 - i;
+        cutil_Map_set(map, &key, &i);
+        if (key % 2 == 0) {
+            cutil_Map_remove(map, &key);
+        } else {
+            expected[num_expected++] = key;
+        }
+    }
+    cutil_Map *const copy = cutil_CompactHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    const int other = 12345;
+    cutil_Map_set(copy, &other, &other);
+
+    /* Act */
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    cutil_Map_copy(copy, map);
+
+    /* Assert */
+    _assert_key_order(dup, expected, num_expected);
+    _assert_key_order(copy, expected, num_expected);
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, copy));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_Map_free(dup);
+    cutil_Map_free(copy);
+}
+
+static void
+_should_keepEntries_when_reservedAndShrunk(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_CompactHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    int expected[100];
+    for (int i = 0; i < 100; ++i) {
+        expected[i] = i * 50;
+    }
+
+    /* Act & Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_reserve(map, 5000UL));
+    for (int i = 0; i < 5000; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+    for (int i = 0; i < 5000; ++i) {
+        if (i % 50 != 0) {
+            cutil_Map_remove(map, &i);
+        }
+    }
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_shrink_to_fit(map));
+    _assert_key_order(map, expected, 100UL);
+    for (int i = 0; i < 100; ++i) {
+        const int *const val = cutil_Map_get_ptr(map, &expected[i]);
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT(expected[i], *val);
+    }
+
+    cutil_Map_reset(map);
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+    TEST_ASSERT_FALSE(cutil_Map_contains(map, &expected[0]));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_allocateEmptyMap_when_typesValid);
+
+    RUN_TEST(
+      _should_iterateInInsertionOrder_when_valuesUpdatedAndKeysReinserted
+    );
+    RUN_TEST(_should_keepEntriesAndOrder_when_manyKeysInsertedAndRemoved);
+
+    RUN_TEST(_should_removeEveryOtherKey_when_removedThroughIterator);
+    RUN_TEST(_should_manageStringKeys_when_entriesRemovedAndResized);
+
+    RUN_TEST(_should_preserveOrder_when_duplicatedAndCopied);
+    RUN_TEST(_should_keepEntries_when_reservedAndShrunk);
+
+    return UNITY_END();
+}
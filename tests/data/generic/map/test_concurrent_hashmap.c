@@ -0,0 +1,509 @@
+#if !defined(_WIN32)
+    #undef _POSIX_C_SOURCE
+    #define _POSIX_C_SOURCE 200112L
+#endif
+
+#include "unity.h"
+#include <cutil/data/generic/map/concurrent_hashmap.h>
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/util/macro.h>
+
+#if !defined(_WIN32)
+    #include <pthread.h>
+#endif
+
+/* Tests for cutil_ConcurrentHashMap_alloc */
+static void
+_should_allocateConcurrentHashMap_when_createdWithValidTypes(void)
+{
+    /* Arrange */
+    const cutil_GenericType *const key_type = CUTIL_GENERIC_TYPE_INT;
+    const cutil_GenericType *const val_type = CUTIL_GENERIC_TYPE_DOUBLE;
+
+    /* Act */
+    cutil_Map *const map = cutil_ConcurrentHashMap_alloc(key_type, val_type);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(map);
+    TEST_ASSERT_NOT_NULL(map->data);
+    TEST_ASSERT_EQUAL_STRING("cutil_ConcurrentHashMap", map->vtable->name);
+    TEST_ASSERT_EQUAL_PTR(key_type, cutil_Map_get_key_type(map));
+    TEST_ASSERT_EQUAL_PTR(val_type, cutil_Map_get_val_type(map));
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_roundUpNumShards_when_notPowerOfTwo(void)
+{
+    /* Arrange */
+    const size_t requested[] = {1UL, 2UL, 3UL, 5UL, 17UL};
+    const size_t expected[] = {1UL, 2UL, 4UL, 8UL, 32UL};
+    const size_t NUM_CASES = CUTIL_GET_NATIVE_ARRAY_SIZE(requested);
+
+    for (size_t i = 0; i < NUM_CASES; ++i) {
+        /* Act */
+        cutil_Map *const map = cutil_ConcurrentHashMap_alloc_with_shards(
+          CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, requested[i]
+        );
+
+        /* Assert */
+        TEST_ASSERT_NOT_NULL(map);
+        TEST_ASSERT_EQUAL_size_t(
+          expected[i], cutil_ConcurrentHashMap_get_num_shards(map)
+        );
+
+        /* Cleanup */
+        cutil_Map_free(map);
+    }
+}
+
+/* Tests for single-entry operations */
+static void
+_should_retrieveAllValues_when_manyEntriesInserted(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_ConcurrentHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    const int NUM_ENTRIES = 2000;
+
+    /* Act */
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        const int val = 3 * i;
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Map_set(map, &i, &val)
+        );
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(NUM_ENTRIES, cutil_Map_get_count(map));
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        int val = -1;
+        TEST_ASSERT_TRUE(cutil_Map_contains(map, &i));
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Map_get(map, &i, &val)
+        );
+        TEST_ASSERT_EQUAL_INT(3 * i, val);
+        TEST_ASSERT_EQUAL_INT(3 * i, *(const int *) cutil_Map_get_ptr(map, &i));
+    }
+    const int missing = NUM_ENTRIES;
+    TEST_ASSERT_FALSE(cutil_Map_contains(map, &missing));
+    TEST_ASSERT_NULL(cutil_Map_get_ptr(map, &missing));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_keepRemainingEntries_when_everyOtherKeyRemoved(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_ConcurrentHashMap_alloc_with_shards(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 4UL
+    );
+    const int NUM_ENTRIES = 500;
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    for (int i = 0; i < NUM_ENTRIES; i += 2) {
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &i));
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(NUM_ENTRIES / 2, cutil_Map_get_count(map));
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        TEST_ASSERT_EQUAL(i % 2 == 1, cutil_Map_contains(map, &i));
+    }
+    const int removed = 0;
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_FAILURE, cutil_Map_remove(map, &removed)
+    );
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_countOccurrences_when_valuesUpdatedInPlace(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_ConcurrentHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    const int zero = 0;
+    size_t num_inserted = 0UL;
+
+    /* Act */
+    for (int i = 0; i < 300; ++i) {
+        const int key = i % 7;
+        cutil_Bool inserted = CUTIL_FALSE;
+        int *const count = cutil_Map_get_or_insert(map, &key, &zero, &inserted);
+        TEST_ASSERT_NOT_NULL(count);
+        ++*count;
+        num_inserted += inserted ? 1UL : 0UL;
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(7UL, num_inserted);
+    TEST_ASSERT_EQUAL_size_t(7UL, cutil_Map_get_count(map));
+    for (int key = 0; key < 7; ++key) {
+        int count = 0;
+        cutil_Map_get(map, &key, &count);
+        TEST_ASSERT_EQUAL_INT(300 / 7 + (key < 300 % 7 ? 1 : 0), count);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_beEmpty_when_reset(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_ConcurrentHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    for (int i = 0; i < 100; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    cutil_Map_reset(map);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+    const int key = 42;
+    TEST_ASSERT_FALSE(cutil_Map_contains(map, &key));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for copy and duplicate */
+static void
+_should_preserveAllEntries_when_duplicated(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_ConcurrentHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    for (int i = 0; i < 1000; ++i) {
+        const int val = -i;
+        cutil_Map_set(map, &i, &val);
+    }
+
+    /* Act */
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(dup);
+    TEST_ASSERT_EQUAL_size_t(
+      cutil_ConcurrentHashMap_get_num_shards(map),
+      cutil_ConcurrentHashMap_get_num_shards(dup)
+    );
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_Map_free(dup);
+}
+
+static void
+_should_redistributeEntries_when_copiedBetweenShardCounts(void)
+{
+    /* Arrange */
+    cutil_Map *const src = cutil_ConcurrentHashMap_alloc_with_shards(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 8UL
+    );
+    cutil_Map *const dst = cutil_ConcurrentHashMap_alloc_with_shards(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 2UL
+    );
+    for (int i = 0; i < 500; ++i) {
+        cutil_Map_set(src, &i, &i);
+    }
+    const int stale = -1;
+    cutil_Map_set(dst, &stale, &stale);
+
+    /* Act */
+    cutil_Map_copy(dst, src);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(2UL, cutil_ConcurrentHashMap_get_num_shards(dst));
+    TEST_ASSERT_FALSE(cutil_Map_contains(dst, &stale));
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(src, dst));
+
+    /* Cleanup */
+    cutil_Map_free(src);
+    cutil_Map_free(dst);
+}
+
+/* Tests for iterators */
+static void
+_should_visitEveryKeyOnce_when_iterated(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_ConcurrentHashMap_alloc_with_shards(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 16UL
+    );
+    enum { NUM_ENTRIES = 300 };
+    int visited[NUM_ENTRIES] = {0};
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    size_t num_visited = 0UL;
+    while (cutil_ConstIterator_next(it)) {
+        const int key = *(const int *) cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_TRUE(key >= 0 && key < NUM_ENTRIES);
+        ++visited[key];
+        ++num_visited;
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(NUM_ENTRIES, num_visited);
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        TEST_ASSERT_EQUAL_INT(1, visited[i]);
+    }
+    TEST_ASSERT_FALSE(cutil_ConstIterator_next(it));
+    cutil_ConstIterator_rewind(it);
+    TEST_ASSERT_TRUE(cutil_ConstIterator_next(it));
+
+    /* Cleanup */
+    cutil_ConstIterator_free(it);
+    cutil_Map_free(map);
+}
+
+static void
+_should_removeEntries_when_removedThroughIterator(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_ConcurrentHashMap_alloc_with_shards(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 4UL
+    );
+    for (int i = 0; i < 200; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    cutil_Iterator *const it = cutil_Map_get_iterator(map);
+    while (cutil_Iterator_next(it)) {
+        const int key = *(const int *) cutil_Iterator_get_ptr(it);
+        if (key % 3 == 0) {
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Iterator_remove(it)
+            );
+        }
+    }
+    cutil_Iterator_free(it);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(200UL - 67UL, cutil_Map_get_count(map));
+    for (int i = 0; i < 200; ++i) {
+        TEST_ASSERT_EQUAL(i % 3 != 0, cutil_Map_contains(map, &i));
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+#if !defined(_WIN32)
+/* Tests for concurrent access */
+    #define NUM_THREADS 4
+    #define NUM_KEYS_PER_THREAD 5000
+    #define NUM_SHARED_KEYS 64
+
+typedef struct {
+    cutil_Map *map;
+    int id;
+} _ThreadArgs;
+
+static void *
+_insert_and_count(void *arg)
+{
+    const _ThreadArgs *const args = arg;
+    const int zero = 0;
+    for (int i = 0; i < NUM_KEYS_PER_THREAD; ++i) {
+        /* Keys owned by this thread */
+        const int key = NUM_SHARED_KEYS + args->id * NUM_KEYS_PER_THREAD + i;
+        cutil_Map_set(args->map, &key, &args->id);
+
+        /* Keys contended by all threads */
+        const int shared = i % NUM_SHARED_KEYS;
+        cutil_Map_get_or_insert(args->map, &shared, &zero, NULL);
+
+        int val = -1;
+        if (cutil_Map_get(args->map, &key, &val) != CUTIL_STATUS_SUCCESS
+            || val != args->id) {
+            return arg;
+        }
+    }
+    return NULL;
+}
+
+static void
+_should_keepAllEntries_when_insertedFromMultipleThreads(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_ConcurrentHashMap_alloc_with_shards(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 8UL
+    );
+    pthread_t threads[NUM_THREADS];
+    _ThreadArgs args[NUM_THREADS];
+
+    /* Act */
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        args[t].map = map;
+        args[t].id = t;
+        TEST_ASSERT_EQUAL_INT(
+          0, pthread_create(&threads[t], NULL, &_insert_and_count, &args[t])
+        );
+    }
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        void *res = NULL;
+        pthread_join(threads[t], &res);
+        TEST_ASSERT_NULL(res);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(
+      NUM_SHARED_KEYS + NUM_THREADS * NUM_KEYS_PER_THREAD,
+      cutil_Map_get_count(map)
+    );
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        for (int i = 0; i < NUM_KEYS_PER_THREAD; ++i) {
+            const int key = NUM_SHARED_KEYS + t * NUM_KEYS_PER_THREAD + i;
+            int val = -1;
+            cutil_Map_get(map, &key, &val);
+            TEST_ASSERT_EQUAL_INT(t, val);
+        }
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+    #define NUM_STABLE_KEYS 1000
+    #define NUM_ROUNDS 50
+
+static void *
+_toggle_keys(void *arg)
+{
+    const _ThreadArgs *const args = arg;
+    const int first = NUM_STABLE_KEYS + args->id * NUM_KEYS_PER_THREAD;
+    for (int round = 0; round < NUM_ROUNDS; ++round) {
+        for (int key = first; key < first + NUM_KEYS_PER_THREAD / 10; ++key) {
+            cutil_Map_set(args->map, &key, &key);
+        }
+        for (int key = first; key < first + NUM_KEYS_PER_THREAD / 10; ++key) {
+            cutil_Map_remove(args->map, &key);
+        }
+    }
+    return NULL;
+}
+
+static void *
+_iterate_stable_keys(void *arg)
+{
+    const _ThreadArgs *const args = arg;
+    for (int round = 0; round < NUM_ROUNDS; ++round) {
+        int num_stable = 0;
+        cutil_ConstIterator *const it = cutil_Map_get_const_iterator(args->map);
+        while (cutil_ConstIterator_next(it)) {
+            const int key = *(const int *) cutil_ConstIterator_get_ptr(it);
+            const int *const val = cutil_Map_get_ptr(args->map, &key);
+            if (val == NULL || *val != key) {
+                cutil_ConstIterator_free(it);
+                return arg;
+            }
+            num_stable += (key < NUM_STABLE_KEYS);
+        }
+        cutil_ConstIterator_free(it);
+        if (num_stable != NUM_STABLE_KEYS) {
+            return arg;
+        }
+    }
+    return NULL;
+}
+
+static void
+_should_visitStableKeys_when_iteratedWhileOthersModify(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_ConcurrentHashMap_alloc_with_shards(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 4UL
+    );
+    for (int i = 0; i < NUM_STABLE_KEYS; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+    pthread_t threads[NUM_THREADS];
+    _ThreadArgs args[NUM_THREADS];
+
+    /* Act */
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        args[t].map = map;
+        args[t].id = t;
+        TEST_ASSERT_EQUAL_INT(
+          0, pthread_create(
+               &threads[t], NULL,
+               (t % 2 == 0) ? &_toggle_keys : &_iterate_stable_keys, &args[t]
+             )
+        );
+    }
+
+    /* Assert */
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        void *res = NULL;
+        pthread_join(threads[t], &res);
+        TEST_ASSERT_NULL(res);
+    }
+    TEST_ASSERT_EQUAL_size_t(NUM_STABLE_KEYS, cutil_Map_get_count(map));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+#endif
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_allocateConcurrentHashMap_when_createdWithValidTypes);
+    RUN_TEST(_should_roundUpNumShards_when_notPowerOfTwo);
+
+    RUN_TEST(_should_retrieveAllValues_when_manyEntriesInserted);
+    RUN_TEST(_should_keepRemainingEntries_when_everyOtherKeyRemoved);
+    RUN_TEST(_should_countOccurrences_when_valuesUpdatedInPlace);
+    RUN_TEST(_should_beEmpty_when_reset);
+
+    RUN_TEST(_should_preserveAllEntries_when_duplicated);
+    RUN_TEST(_should_redistributeEntries_when_copiedBetweenShardCounts);
+
+    RUN_TEST(_should_visitEveryKeyOnce_when_iterated);
+    RUN_TEST(_should_removeEntries_when_removedThroughIterator);
+
+#if !defined(_WIN32)
+    RUN_TEST(_should_keepAllEntries_when_insertedFromMultipleThreads);
+    RUN_TEST(_should_visitStableKeys_when_iteratedWhileOthersModify);
+#endif
+
+    return UNITY_END();
+}
@@ -0,0 +1,452 @@
+#include "unity.h"
+#include <cutil/data/generic/map/flatmap.h>
+
+#include <cutil/data/generic/array.h>
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/status.h>
+#include <cutil/std/stdio.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/string/type.h>
+#include <cutil/util/macro.h>
+
+/**
+ * Returns a permutation of [0, num) scattered enough that consecutive
+ * insertions land all over the arrays.
+ */
+static int *
+_alloc_shuffled_keys(int num)
+{
+    int *const keys = malloc((size_t) num * sizeof *keys);
+    for (int i = 0; i < num; ++i) {
+        keys[i] = i;
+    }
+    unsigned long state = 12345UL;
+    for (int i = num - 1; i > 0; --i) {
+        state = state * 6364136223846793005UL + 1442695040888963407UL;
+        const int j = (int) ((state >> 33U) % (unsigned long) (i + 1));
+        const int tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+    return keys;
+}
+
+/**
+ * Asserts that iterating `map` yields exactly the keys in [0, num) for which
+ * `present` is set, in ascending order, each mapped to its negation.
+ */
+static void
+_assert_ordered_entries(
+  const cutil_Map *map, const cutil_Bool *present, int num
+)
+{
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    int expected = 0;
+    size_t num_visited = 0UL;
+    while (cutil_ConstIterator_next(it)) {
+        while (expected < num && !present[expected]) {
+            ++expected;
+        }
+        const int key = *(const int *) cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_EQUAL_INT(expected, key);
+        TEST_ASSERT_EQUAL_INT(
+          -key, *(const int *) cutil_Map_get_ptr(map, &key)
+        );
+        ++expected;
+        ++num_visited;
+    }
+    TEST_ASSERT_EQUAL_size_t(num_visited, cutil_Map_get_count(map));
+    cutil_ConstIterator_free(it);
+}
+
+/* Tests for cutil_FlatMap_alloc */
+static void
+_should_allocateFlatMap_when_createdWithValidTypes(void)
+{
+    /* Act */
+    cutil_Map *const map
+      = cutil_FlatMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_DOUBLE);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(map);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_MAP_TYPE_FLATMAP, map->vtable);
+    TEST_ASSERT_EQUAL_STRING("cutil_FlatMap", map->vtable->name);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_GENERIC_TYPE_INT, cutil_Map_get_key_type(map));
+    TEST_ASSERT_EQUAL_PTR(
+      CUTIL_GENERIC_TYPE_DOUBLE, cutil_Map_get_val_type(map)
+    );
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+    const int key = 3;
+    TEST_ASSERT_FALSE(cutil_Map_contains(map, &key));
+    TEST_ASSERT_NULL(cutil_Map_get_ptr(map, &key));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Map_remove(map, &key));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_returnNull_when_typesInvalid(void)
+{
+    /* Act & Assert */
+    TEST_ASSERT_NULL(cutil_FlatMap_alloc(NULL, CUTIL_GENERIC_TYPE_INT));
+    TEST_ASSERT_NULL(cutil_FlatMap_alloc(CUTIL_GENERIC_TYPE_INT, NULL));
+}
+
+/* Tests for single-entry operations */
+static void
+_should_iterateInOrder_when_keysInsertedAndRemovedShuffled(void)
+{
+    /* Arrange */
+    const int NUM = 2000;
+    int *const keys = _alloc_shuffled_keys(NUM);
+    cutil_Bool *const present = calloc((size_t) NUM, sizeof *present);
+    cutil_Map *const map
+      = cutil_FlatMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+
+    /* Act & Assert */
+    for (int i = 0; i < NUM; ++i) {
+        const int val = -keys[i];
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Map_set(map, &keys[i], &val)
+        );
+        present[keys[i]] = CUTIL_TRUE;
+    }
+    _assert_ordered_entries(map, present, NUM);
+    for (int i = 0; i < NUM; i += 3) {
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &keys[i])
+        );
+        present[keys[i]] = CUTIL_FALSE;
+    }
+    _assert_ordered_entries(map, present, NUM);
+    for (int i = 0; i < NUM; ++i) {
+        TEST_ASSERT_EQUAL(present[i], cutil_Map_contains(map, &i));
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    free(present);
+    free(keys);
+}
+
+static void
+_should_overwriteValue_when_keyAlreadyPresent(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_FlatMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int key = 5;
+    const int vals[] = {1, 2};
+    cutil_Map_set(map, &key, &vals[0]);
+
+    /* Act */
+    cutil_Map_set(map, &key, &vals[1]);
+    cutil_Bool inserted = CUTIL_TRUE;
+    int *const counter
+      = cutil_Map_get_or_insert(map, &key, &vals[0], &inserted);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(1UL, cutil_Map_get_count(map));
+    TEST_ASSERT_FALSE(inserted);
+    TEST_ASSERT_EQUAL_INT(2, *counter);
+    int res = 0;
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_get(map, &key, &res));
+    TEST_ASSERT_EQUAL_INT(2, res);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_releaseOwnedEntries_when_stringEntriesRemoved(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_FlatMap_alloc(
+      CUTIL_GENERIC_TYPE_STRING, CUTIL_GENERIC_TYPE_STRING
+    );
+    char buf[32];
+    for (size_t i = 0; i < 100UL; ++i) {
+        (void) snprintf(buf, sizeof buf, "key%03zu", 99UL - i);
+        cutil_String *const key = cutil_String_from_string(buf);
+        (void) snprintf(buf, sizeof buf, "val%zu", 99UL - i);
+        cutil_String *const val = cutil_String_from_string(buf);
+        cutil_Map_set(map, key, val);
+        cutil_String_free(val);
+        cutil_String_free(key);
+    }
+
+    /* Act */
+    for (size_t i = 0; i < 100UL; i += 2UL) {
+        (void) snprintf(buf, sizeof buf, "key%03zu", i);
+        cutil_String *const key = cutil_String_from_string(buf);
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, key));
+        cutil_String_free(key);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(50UL, cutil_Map_get_count(map));
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    size_t expected = 1UL;
+    while (cutil_ConstIterator_next(it)) {
+        const cutil_String *const key = cutil_ConstIterator_get_ptr(it);
+        (void) snprintf(buf, sizeof buf, "key%03zu", expected);
+        TEST_ASSERT_EQUAL_STRING(buf, key->str);
+        const cutil_String *const val = cutil_Map_get_ptr(map, key);
+        (void) snprintf(buf, sizeof buf, "val%zu", expected);
+        TEST_ASSERT_EQUAL_STRING(buf, val->str);
+        expected += 2UL;
+    }
+    cutil_ConstIterator_free(it);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_removeEntries_when_removedThroughIterator(void)
+{
+    /* Arrange */
+    const int NUM = 100;
+    cutil_Bool present[100];
+    cutil_Map *const map
+      = cutil_FlatMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < NUM; ++i) {
+        const int val = -i;
+        cutil_Map_set(map, &i, &val);
+        present[i] = (i % 4 != 0);
+    }
+
+    /* Act */
+    cutil_Iterator *const it = cutil_Map_get_iterator(map);
+    while (cutil_Iterator_next(it)) {
+        const int key = *(const int *) cutil_Iterator_get_ptr(it);
+        if (key % 4 == 0) {
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Iterator_remove(it)
+            );
+            TEST_ASSERT_NULL(cutil_Iterator_get_ptr(it));
+        }
+    }
+    cutil_Iterator_free(it);
+
+    /* Assert */
+    _assert_ordered_entries(map, present, NUM);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for bulk loading */
+static void
+_should_keepLastValue_when_bulkLoadedWithDuplicates(void)
+{
+    /* Arrange */
+    const int NUM = 3000;
+    int *const keys = _alloc_shuffled_keys(NUM);
+    int *const all_keys = malloc(2UL * (size_t) NUM * sizeof *all_keys);
+    int *const all_vals = malloc(2UL * (size_t) NUM * sizeof *all_vals);
+    for (int i = 0; i < NUM; ++i) {
+        all_keys[i] = keys[i];
+        all_vals[i] = keys[i];
+        all_keys[NUM + i] = keys[NUM - 1 - i];
+        all_vals[NUM + i] = -keys[NUM - 1 - i];
+    }
+    cutil_Bool *const present = malloc((size_t) NUM * sizeof *present);
+    for (int i = 0; i < NUM; ++i) {
+        present[i] = CUTIL_TRUE;
+    }
+    cutil_Map *const map
+      = cutil_FlatMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+
+    /* Act */
+    const cutil_Status status = cutil_FlatMap_set_mult(
+      map, all_keys, all_vals, 2UL * (size_t) NUM
+    );
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    _assert_ordered_entries(map, present, NUM);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    free(present);
+    free(all_vals);
+    free(all_keys);
+    free(keys);
+}
+
+static void
+_should_mergeWithExistingEntries_when_bulkLoadedIntoNonEmptyMap(void)
+{
+    /* Arrange */
+    const int NUM = 1000;
+    cutil_Bool present[1000] = {CUTIL_FALSE};
+    cutil_Map *const map
+      = cutil_FlatMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < NUM; i += 3) {
+        const int val = 7;
+        cutil_Map_set(map, &i, &val);
+        present[i] = CUTIL_TRUE;
+    }
+    int keys[500];
+    int vals[500];
+    size_t num = 0UL;
+    for (int i = NUM - 1; i >= 0; i -= 2) {
+        keys[num] = i;
+        vals[num++] = -i;
+        present[i] = CUTIL_TRUE;
+    }
+
+    /* Act */
+    const cutil_Status status = cutil_FlatMap_set_mult(map, keys, vals, num);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    for (int i = 0; i < NUM; ++i) {
+        const int *const val = cutil_Map_get_ptr(map, &i);
+        if (!present[i]) {
+            TEST_ASSERT_NULL(val);
+            continue;
+        }
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT((i % 2 != 0) ? -i : 7, *val);
+    }
+    size_t expected = 0UL;
+    for (int i = 0; i < NUM; ++i) {
+        expected += present[i];
+    }
+    TEST_ASSERT_EQUAL_size_t(expected, cutil_Map_get_count(map));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_copyStrings_when_constructedFromArrays(void)
+{
+    /* Arrange */
+    const char *const names[] = {"pear", "apple", "fig", "apple", "kiwi"};
+    const size_t NUM = CUTIL_GET_NATIVE_ARRAY_SIZE(names);
+    cutil_Array *const keys = cutil_Array_alloc(CUTIL_GENERIC_TYPE_STRING, NUM);
+    cutil_Array *const vals = cutil_Array_alloc(CUTIL_GENERIC_TYPE_INT, NUM);
+    for (size_t i = 0; i < NUM; ++i) {
+        cutil_String *const key = cutil_String_from_string(names[i]);
+        const int val = (int) i;
+        cutil_Array_set(keys, i, key);
+        cutil_Array_set(vals, i, &val);
+        cutil_String_free(key);
+    }
+
+    /* Act */
+    cutil_Map *const map = cutil_FlatMap_from_arrays(keys, vals);
+    cutil_Array_free(vals);
+    cutil_Array_free(keys);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(map);
+    TEST_ASSERT_EQUAL_size_t(4UL, cutil_Map_get_count(map));
+    const char *const expected_keys[] = {"apple", "fig", "kiwi", "pear"};
+    const int expected_vals[] = {3, 2, 4, 0};
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(expected_keys); ++i) {
+        TEST_ASSERT_TRUE(cutil_ConstIterator_next(it));
+        const cutil_String *const key = cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_EQUAL_STRING(expected_keys[i], key->str);
+        TEST_ASSERT_EQUAL_INT(
+          expected_vals[i], *(const int *) cutil_Map_get_ptr(map, key)
+        );
+    }
+    TEST_ASSERT_FALSE(cutil_ConstIterator_next(it));
+    cutil_ConstIterator_free(it);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_returnNull_when_arraysHaveDifferentLengths(void)
+{
+    /* Arrange */
+    cutil_Array *const keys = cutil_Array_alloc(CUTIL_GENERIC_TYPE_INT, 3UL);
+    cutil_Array *const vals = cutil_Array_alloc(CUTIL_GENERIC_TYPE_INT, 2UL);
+
+    /* Act & Assert */
+    TEST_ASSERT_NULL(cutil_FlatMap_from_arrays(keys, vals));
+    TEST_ASSERT_NULL(cutil_FlatMap_from_arrays(NULL, vals));
+
+    /* Cleanup */
+    cutil_Array_free(vals);
+    cutil_Array_free(keys);
+}
+
+/* Tests for whole-map operations */
+static void
+_should_preserveAllEntries_when_duplicatedCopiedAndShrunk(void)
+{
+    /* Arrange */
+    const int NUM = 300;
+    cutil_Bool present[300];
+    cutil_Map *const map
+      = cutil_FlatMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    cutil_Map_reserve(map, (size_t) NUM);
+    for (int i = 0; i < NUM; ++i) {
+        const int val = -i;
+        cutil_Map_set(map, &i, &val);
+        present[i] = CUTIL_TRUE;
+    }
+    cutil_Map *const copy
+      = cutil_FlatMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int stale = 1000;
+    cutil_Map_set(copy, &stale, &stale);
+
+    /* Act */
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    cutil_Map_copy(copy, map);
+    cutil_Map_reset(map);
+    cutil_Map_shrink_to_fit(dup);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+    _assert_ordered_entries(dup, present, NUM);
+    _assert_ordered_entries(copy, present, NUM);
+    TEST_ASSERT_FALSE(cutil_Map_contains(copy, &stale));
+
+    /* Cleanup */
+    cutil_Map_free(copy);
+    cutil_Map_free(dup);
+    cutil_Map_free(map);
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_allocateFlatMap_when_createdWithValidTypes);
+    RUN_TEST(_should_returnNull_when_typesInvalid);
+
+    RUN_TEST(_should_iterateInOrder_when_keysInsertedAndRemovedShuffled);
+    RUN_TEST(_should_overwriteValue_when_keyAlreadyPresent);
+    RUN_TEST(_should_releaseOwnedEntries_when_stringEntriesRemoved);
+    RUN_TEST(_should_removeEntries_when_removedThroughIterator);
+
+    /* Bulk loading tests */
+    RUN_TEST(_should_keepLastValue_when_bulkLoadedWithDuplicates);
+    RUN_TEST(_should_mergeWithExistingEntries_when_bulkLoadedIntoNonEmptyMap);
+    RUN_TEST(_should_copyStrings_when_constructedFromArrays);
+    RUN_TEST(_should_returnNull_when_arraysHaveDifferentLengths);
+
+    RUN_TEST(_should_preserveAllEntries_when_duplicatedCopiedAndShrunk);
+
+    return UNITY_END();
+}
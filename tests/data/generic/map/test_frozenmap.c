@@ -0,0 +1,373 @@
+#include "unity.h"
+#include <cutil/data/generic/map/frozenmap.h>
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/map/btreemap.h>
+#include <cutil/data/generic/map/hashmap.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/std/stdio.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/std/string.h>
+#include <cutil/string/type.h>
+#include <cutil/util/hash.h>
+#include <cutil/util/macro.h>
+
+static cutil_hash_t
+_constant_hash(const void *obj)
+{
+    CUTIL_UNUSED(obj);
+    return CUTIL_HASH_C(42);
+}
+
+/** Key type whose hashes collide for all keys */
+static const cutil_GenericType CONSTANT_HASH_INT_TYPE = {
+  .name = "constant_hash_int",
+  .size = sizeof(int),
+  .hash = &_constant_hash,
+};
+
+/**
+ * Returns a map allocated by `alloc` holding keys i * 3 with value -i for all
+ * i in [0, num).
+ */
+static cutil_Map *
+_alloc_source_map(
+  cutil_Map *(*alloc)(const cutil_GenericType *, const cutil_GenericType *),
+  int num
+)
+{
+    cutil_Map *const map
+      = alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < num; ++i) {
+        const int key = i * 3;
+        const int val = -i;
+        cutil_Map_set(map, &key, &val);
+    }
+    return map;
+}
+
+/* Tests for cutil_Map_freeze */
+static void
+_should_findEveryKey_when_hashMapFrozen(void)
+{
+    const int sizes[] = {1, 2, 3, 7, 100, 4096, 50000};
+    for (size_t s = 0; s < CUTIL_GET_NATIVE_ARRAY_SIZE(sizes); ++s) {
+        /* Arrange */
+        const int num = sizes[s];
+        cutil_Map *const map = _alloc_source_map(&cutil_HashMap_alloc, num);
+
+        /* Act */
+        cutil_Map *const frozen = cutil_Map_freeze(map);
+
+        /* Assert */
+        TEST_ASSERT_NOT_NULL(frozen);
+        TEST_ASSERT_EQUAL_PTR(CUTIL_MAP_TYPE_FROZEN, frozen->vtable);
+        TEST_ASSERT_EQUAL_size_t((size_t) num, cutil_Map_get_count(frozen));
+        TEST_ASSERT_EQUAL_PTR(
+          CUTIL_GENERIC_TYPE_INT, cutil_Map_get_key_type(frozen)
+        );
+        TEST_ASSERT_EQUAL_PTR(
+          CUTIL_GENERIC_TYPE_INT, cutil_Map_get_val_type(frozen)
+        );
+        for (int key = -3; key < num * 3 + 3; ++key) {
+            const int *const val = cutil_Map_get_ptr(frozen, &key);
+            if (key >= 0 && key < num * 3 && key % 3 == 0) {
+                TEST_ASSERT_NOT_NULL(val);
+                TEST_ASSERT_EQUAL_INT(-key / 3, *val);
+            } else {
+                TEST_ASSERT_NULL(val);
+                TEST_ASSERT_FALSE(cutil_Map_contains(frozen, &key));
+            }
+        }
+
+        /* Cleanup */
+        cutil_Map_free(frozen);
+        cutil_Map_free(map);
+    }
+}
+
+static void
+_should_returnEmptyMap_when_emptyMapFrozen(void)
+{
+    /* Arrange */
+    cutil_Map *const map = _alloc_source_map(&cutil_BTreeMap_alloc, 0);
+
+    /* Act */
+    cutil_Map *const frozen = cutil_Map_freeze(map);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(frozen);
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(frozen));
+    const int key = 0;
+    int val = 1;
+    TEST_ASSERT_FALSE(cutil_Map_contains(frozen, &key));
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_FAILURE, cutil_Map_get(frozen, &key, &val)
+    );
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(frozen);
+    TEST_ASSERT_FALSE(cutil_ConstIterator_next(it));
+    cutil_ConstIterator_free(it);
+
+    /* Cleanup */
+    cutil_Map_free(frozen);
+    cutil_Map_free(map);
+}
+
+static void
+_should_findEveryKey_when_keyHashesCollide(void)
+{
+    const int sizes[] = {2, 3, 50};
+    for (size_t s = 0; s < CUTIL_GET_NATIVE_ARRAY_SIZE(sizes); ++s) {
+        /* Arrange */
+        cutil_Map *const map = cutil_HashMap_alloc(
+          &CONSTANT_HASH_INT_TYPE, CUTIL_GENERIC_TYPE_INT
+        );
+        for (int i = 0; i < sizes[s]; ++i) {
+            const int val = -i;
+            cutil_Map_set(map, &i, &val);
+        }
+
+        /* Act */
+        cutil_Map *const frozen = cutil_Map_freeze(map);
+        cutil_Map *const dup = cutil_Map_duplicate(frozen);
+
+        /* Assert */
+        TEST_ASSERT_NOT_NULL(frozen);
+        TEST_ASSERT_EQUAL_size_t((size_t) sizes[s], cutil_Map_get_count(dup));
+        int keys[52];
+        const void *vals[52];
+        for (int key = -1; key <= sizes[s]; ++key) {
+            keys[key + 1] = key;
+        }
+        cutil_Map_get_ptr_batch(dup, keys, (size_t) sizes[s] + 2U, vals);
+        for (int key = -1; key <= sizes[s]; ++key) {
+            const int *const val = cutil_Map_get_ptr(dup, &key);
+            TEST_ASSERT_EQUAL_PTR(val, vals[key + 1]);
+            if (key >= 0 && key < sizes[s]) {
+                TEST_ASSERT_NOT_NULL(val);
+                TEST_ASSERT_EQUAL_INT(-key, *val);
+            } else {
+                TEST_ASSERT_NULL(val);
+            }
+        }
+
+        /* Cleanup */
+        cutil_Map_free(dup);
+        cutil_Map_free(frozen);
+        cutil_Map_free(map);
+    }
+}
+
+static void
+_should_findEveryKey_when_stringHashesCollide(void)
+{
+    /* Arrange */
+    /* "ap" and "g6" hash alike, and so do all strings concatenated of them */
+    enum { NUM_BLOCKS = 10, NUM_KEYS = 1 << NUM_BLOCKS };
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_STRING, CUTIL_GENERIC_TYPE_INT);
+    char buf[2 * NUM_BLOCKS + 1];
+    for (int i = 0; i < NUM_KEYS; ++i) {
+        for (int b = 0; b < NUM_BLOCKS; ++b) {
+            memcpy(buf + 2 * b, ((i >> b) & 1) ? "g6" : "ap", 2U);
+        }
+        buf[2 * NUM_BLOCKS] = '\0';
+        cutil_String *const str = cutil_String_from_string(buf);
+        cutil_Map_set(map, str, &i);
+        cutil_String_free(str);
+    }
+
+    /* Act */
+    cutil_Map *const frozen = cutil_Map_freeze(map);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(frozen);
+    TEST_ASSERT_EQUAL_size_t(NUM_KEYS, cutil_Map_get_count(frozen));
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    while (cutil_ConstIterator_next(it)) {
+        const void *const key = cutil_ConstIterator_get_ptr(it);
+        const int *const val = cutil_Map_get_ptr(frozen, key);
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT(
+          *(const int *) cutil_Map_get_ptr(map, key), *val
+        );
+    }
+    cutil_ConstIterator_free(it);
+    cutil_String *const absent = cutil_String_from_string("apapg6g6");
+    TEST_ASSERT_FALSE(cutil_Map_contains(frozen, absent));
+    cutil_String_free(absent);
+
+    /* Cleanup */
+    cutil_Map_free(frozen);
+    cutil_Map_free(map);
+}
+
+static void
+_should_copyOwnedKeys_when_stringMapFrozen(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_BTreeMap_alloc(CUTIL_GENERIC_TYPE_STRING, CUTIL_GENERIC_TYPE_INT);
+    char buf[32];
+    for (int i = 0; i < 300; ++i) {
+        snprintf(buf, sizeof buf, "symbol-%d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        cutil_Map_set(map, str, &i);
+        cutil_String_free(str);
+    }
+
+    /* Act */
+    cutil_Map *const frozen = cutil_Map_freeze(map);
+    cutil_Map_free(map);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(frozen);
+    for (int i = 0; i < 300; ++i) {
+        snprintf(buf, sizeof buf, "symbol-%d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        int val = -1;
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Map_get(frozen, str, &val)
+        );
+        TEST_ASSERT_EQUAL_INT(i, val);
+        cutil_String_free(str);
+    }
+    cutil_String *const missing = cutil_String_from_string("symbol-300");
+    TEST_ASSERT_FALSE(cutil_Map_contains(frozen, missing));
+    cutil_String_free(missing);
+
+    /* Cleanup */
+    cutil_Map_free(frozen);
+}
+
+/* Tests for read-only operations */
+static void
+_should_rejectModifications_when_mapFrozen(void)
+{
+    /* Arrange */
+    cutil_Map *const map = _alloc_source_map(&cutil_HashMap_alloc, 10);
+    cutil_Map *const frozen = cutil_Map_freeze(map);
+    const int key = 3;
+    const int val = 100;
+    cutil_Bool inserted = CUTIL_TRUE;
+
+    /* Act & Assert */
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_FAILURE, cutil_Map_set(frozen, &key, &val)
+    );
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Map_remove(frozen, &key));
+    TEST_ASSERT_NULL(cutil_Map_get_or_insert(frozen, &key, &val, &inserted));
+    TEST_ASSERT_FALSE(inserted);
+    cutil_Iterator *const it = cutil_Map_get_iterator(frozen);
+    TEST_ASSERT_TRUE(cutil_Iterator_next(it));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Iterator_remove(it));
+    cutil_Iterator_free(it);
+    TEST_ASSERT_EQUAL_size_t(10UL, cutil_Map_get_count(frozen));
+    TEST_ASSERT_EQUAL_INT(-1, *(const int *) cutil_Map_get_ptr(frozen, &key));
+
+    /* Cleanup */
+    cutil_Map_free(frozen);
+    cutil_Map_free(map);
+}
+
+/* Tests for batched lookups */
+static void
+_should_matchSingleLookups_when_lookedUpInBatch(void)
+{
+    /* Arrange */
+    cutil_Map *const map = _alloc_source_map(&cutil_HashMap_alloc, 1000);
+    cutil_Map *const frozen = cutil_Map_freeze(map);
+    enum { N = 100 };
+    int keys[N];
+    const void *vals[N];
+    for (int i = 0; i < N; ++i) {
+        keys[i] = i * 7;
+    }
+
+    /* Act */
+    const cutil_Status status
+      = cutil_Map_get_ptr_batch(frozen, keys, (size_t) N, vals);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    for (int i = 0; i < N; ++i) {
+        TEST_ASSERT_EQUAL_PTR(cutil_Map_get_ptr(frozen, &keys[i]), vals[i]);
+        TEST_ASSERT_EQUAL(keys[i] % 3 == 0, vals[i] != NULL);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(frozen);
+    cutil_Map_free(map);
+}
+
+/* Tests for iteration, copy and duplicate */
+static void
+_should_preserveAllEntries_when_iteratedAndDuplicated(void)
+{
+    /* Arrange */
+    const int NUM_ENTRIES = 2000;
+    cutil_Map *const map = _alloc_source_map(&cutil_HashMap_alloc, NUM_ENTRIES);
+    cutil_Map *const frozen = cutil_Map_freeze(map);
+    cutil_Map *const other = _alloc_source_map(&cutil_HashMap_alloc, 5);
+    cutil_Map *const copy = cutil_Map_freeze(other);
+
+    /* Act */
+    cutil_Map *const dup = cutil_Map_duplicate(frozen);
+    cutil_Map_copy(copy, frozen);
+
+    /* Assert */
+    cutil_Bool *const visited
+      = calloc((size_t) NUM_ENTRIES, sizeof *visited);
+    size_t num_visited = 0UL;
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(frozen);
+    while (cutil_ConstIterator_next(it)) {
+        const int key = *(const int *) cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_EQUAL_INT(0, key % 3);
+        TEST_ASSERT_FALSE(visited[key / 3]);
+        visited[key / 3] = CUTIL_TRUE;
+        ++num_visited;
+    }
+    TEST_ASSERT_FALSE(cutil_ConstIterator_next(it));
+    TEST_ASSERT_NULL(cutil_ConstIterator_get_ptr(it));
+    cutil_ConstIterator_free(it);
+    free(visited);
+    TEST_ASSERT_EQUAL_size_t((size_t) NUM_ENTRIES, num_visited);
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(frozen, dup));
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(frozen, copy));
+    TEST_ASSERT_EQUAL_size_t((size_t) NUM_ENTRIES, cutil_Map_get_count(copy));
+
+    /* Cleanup */
+    cutil_Map_free(copy);
+    cutil_Map_free(other);
+    cutil_Map_free(dup);
+    cutil_Map_free(frozen);
+    cutil_Map_free(map);
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_findEveryKey_when_hashMapFrozen);
+    RUN_TEST(_should_returnEmptyMap_when_emptyMapFrozen);
+    RUN_TEST(_should_findEveryKey_when_keyHashesCollide);
+    RUN_TEST(_should_findEveryKey_when_stringHashesCollide);
+    RUN_TEST(_should_copyOwnedKeys_when_stringMapFrozen);
+
+    RUN_TEST(_should_rejectModifications_when_mapFrozen);
+
+    RUN_TEST(_should_matchSingleLookups_when_lookedUpInBatch);
+
+    RUN_TEST(_should_preserveAllEntries_when_iteratedAndDuplicated);
+
+    return UNITY_END();
+}
@@ -1,9 +1,12 @@
 #include "unity.h"
 #include <cutil/data/generic/map/hashmap.h>
 
+#include <cutil/data/generic/array.h>
 #include <cutil/data/generic/type.h>
+#include <cutil/std/stdio.h>
 #include <cutil/std/stdlib.h>
 #include <cutil/std/string.h>
+#include <cutil/string/type.h>
 #include <cutil/util/macro.h>
 
 /* Tests for cutil_HashMap_alloc */
@@ -616,6 +619,874 @@ _should_returnFalse_when_nextCalledAfterExhaustionOnIterator(void)
     cutil_Map_free(map);
 }
 
+/* Tests for probing */
+static void
+_should_retrieveAllValues_when_manyEntriesInserted(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int N = 5000;
+
+    /* Act */
+    for (int i = 0; i < N; ++i) {
+        const int val = 3 * i;
+        const cutil_Status status = cutil_Map_set(map, &i, &val);
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t((size_t) N, cutil_Map_get_count(map));
+    for (int i = 0; i < N; ++i) {
+        const int *const val = cutil_Map_get_ptr(map, &i);
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT(3 * i, *val);
+    }
+    for (int i = N; i < 2 * N; ++i) {
+        TEST_ASSERT_FALSE(cutil_Map_contains(map, &i));
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_findAllKeys_when_keysShareLowBits(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_U64, CUTIL_GENERIC_TYPE_INT);
+    const int N = 1000;
+
+    /* Act */
+    for (int i = 0; i < N; ++i) {
+        const uint64_t key = (uint64_t) i << 20;
+        cutil_Map_set(map, &key, &i);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t((size_t) N, cutil_Map_get_count(map));
+    for (int i = 0; i < N; ++i) {
+        const uint64_t key = (uint64_t) i << 20;
+        const int *const val = cutil_Map_get_ptr(map, &key);
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT(i, *val);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_keepRemainingEntries_when_everyOtherKeyRemoved(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int N = 2000;
+    for (int i = 0; i < N; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    for (int i = 0; i < N; i += 2) {
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &i));
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t((size_t) N / 2, cutil_Map_get_count(map));
+    for (int i = 0; i < N; ++i) {
+        TEST_ASSERT_EQUAL(i % 2 == 1, cutil_Map_contains(map, &i));
+    }
+    int count = 0;
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    while (cutil_ConstIterator_next(it)) {
+        const int *const key = cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_EQUAL_INT(1, *key % 2);
+        ++count;
+    }
+    TEST_ASSERT_EQUAL_INT(N / 2, count);
+
+    /* Cleanup */
+    cutil_ConstIterator_free(it);
+    cutil_Map_free(map);
+}
+
+static void
+_should_reinsertKeys_when_previouslyRemoved(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int N = 500;
+    for (int i = 0; i < N; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+    for (int i = 0; i < N; ++i) {
+        cutil_Map_remove(map, &i);
+    }
+
+    /* Act */
+    for (int i = 0; i < N; ++i) {
+        const int val = -i;
+        cutil_Map_set(map, &i, &val);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t((size_t) N, cutil_Map_get_count(map));
+    for (int i = 0; i < N; ++i) {
+        const int *const val = cutil_Map_get_ptr(map, &i);
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT(-i, *val);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_preserveAllEntries_when_largeMapDuplicated(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int N = 300;
+    for (int i = 0; i < N; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+    for (int i = 0; i < N; i += 3) {
+        cutil_Map_remove(map, &i);
+    }
+
+    /* Act */
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+
+    /* Assert */
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+    const int key = N + 1;
+    cutil_Map_set(dup, &key, &key);
+    TEST_ASSERT_TRUE(cutil_Map_contains(dup, &key));
+    TEST_ASSERT_FALSE(cutil_Map_contains(map, &key));
+
+    /* Cleanup */
+    cutil_Map_free(dup);
+    cutil_Map_free(map);
+}
+
+static void
+_should_keepEntries_when_keysChurnAtConstantSize(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int N = 100;
+    const int NUM_ROUNDS = 20000;
+    for (int i = 0; i < N; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    for (int i = 0; i < NUM_ROUNDS; ++i) {
+        const int key = i + N;
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &i));
+        cutil_Map_set(map, &key, &key);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t((size_t) N, cutil_Map_get_count(map));
+    for (int i = 0; i < NUM_ROUNDS + N; ++i) {
+        TEST_ASSERT_EQUAL(i >= NUM_ROUNDS, cutil_Map_contains(map, &i));
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_keepEntries_when_keysChurnDuringIncrementalResize(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    cutil_HashMap_set_incremental_resize(map, 2UL, false);
+    const int N = 30;
+    const int NUM_ROUNDS = 20000;
+    for (int i = 0; i < N; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    for (int i = 0; i < NUM_ROUNDS; ++i) {
+        const int key = i + N;
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &i));
+        cutil_Map_set(map, &key, &key);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t((size_t) N, cutil_Map_get_count(map));
+    for (int i = NUM_ROUNDS; i < NUM_ROUNDS + N; ++i) {
+        TEST_ASSERT_TRUE(cutil_Map_contains(map, &i));
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_resolveAllKeys_when_lookedUpInBatch(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int N = 1000;
+    for (int i = 0; i < N; i += 2) {
+        const int val = -i;
+        cutil_Map_set(map, &i, &val);
+    }
+    int *const keys = malloc((size_t) N * sizeof *keys);
+    const void **const vals = malloc((size_t) N * sizeof *vals);
+    for (int i = 0; i < N; ++i) {
+        keys[i] = N - 1 - i;
+    }
+
+    /* Act */
+    const cutil_Status status
+      = cutil_Map_get_ptr_batch(map, keys, (size_t) N, vals);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    for (int i = 0; i < N; ++i) {
+        TEST_ASSERT_EQUAL_PTR(cutil_Map_get_ptr(map, &keys[i]), vals[i]);
+        if (keys[i] % 2 == 0) {
+            TEST_ASSERT_NOT_NULL(vals[i]);
+            TEST_ASSERT_EQUAL_INT(-keys[i], *(const int *) vals[i]);
+        } else {
+            TEST_ASSERT_NULL(vals[i]);
+        }
+    }
+
+    /* Cleanup */
+    free(vals);
+    free(keys);
+    cutil_Map_free(map);
+}
+
+static void
+_should_countOccurrences_when_valuesUpdatedInPlace(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int N = 3000;
+    const int NUM_KEYS = 7;
+    const int zero = 0;
+
+    /* Act */
+    int num_inserted = 0;
+    for (int i = 0; i < N; ++i) {
+        const int key = i % NUM_KEYS;
+        cutil_Bool inserted = false;
+        int *const count = cutil_Map_get_or_insert(map, &key, &zero, &inserted);
+        TEST_ASSERT_NOT_NULL(count);
+        num_inserted += inserted;
+        ++*count;
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(NUM_KEYS, num_inserted);
+    TEST_ASSERT_EQUAL_size_t((size_t) NUM_KEYS, cutil_Map_get_count(map));
+    for (int key = 0; key < NUM_KEYS; ++key) {
+        const int *const count = cutil_Map_get_ptr(map, &key);
+        TEST_ASSERT_NOT_NULL(count);
+        TEST_ASSERT_EQUAL_INT(N / NUM_KEYS + (key < N % NUM_KEYS), *count);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_returnExistingValue_when_getOrInsertDuringResize(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    cutil_HashMap_set_incremental_resize(map, 2UL, false);
+    int n = 0;
+    while (!cutil_HashMap_is_resizing(map)) {
+        cutil_Map_set(map, &n, &n);
+        ++n;
+    }
+    const int dflt = -1;
+
+    /* Act & Assert */
+    for (int i = 0; i < 2 * n; ++i) {
+        cutil_Bool inserted = false;
+        const int *const val
+          = cutil_Map_get_or_insert(map, &i, &dflt, &inserted);
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL(i >= n, inserted);
+        TEST_ASSERT_EQUAL_INT(i < n ? i : -1, *val);
+    }
+    TEST_ASSERT_EQUAL_size_t((size_t) 2 * n, cutil_Map_get_count(map));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for capacity management */
+static void
+_should_returnNull_when_maxLoadFactorInvalid(void)
+{
+    /* Arrange */
+    const double FACTORS[] = {0.0, -0.5, 0.9, 1.0, 2.0};
+
+    for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(FACTORS); ++i) {
+        /* Act */
+        cutil_Map *const map = cutil_HashMap_alloc_with_capacity(
+          CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 0UL, FACTORS[i]
+        );
+
+        /* Assert */
+        TEST_ASSERT_NULL(map);
+    }
+}
+
+static void
+_should_notExpand_when_allocatedWithCapacity(void)
+{
+    /* Arrange */
+    const int N = 1000;
+    cutil_Map *const map = cutil_HashMap_alloc_with_capacity(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, (size_t) N, 0.5
+    );
+    TEST_ASSERT_NOT_NULL(map);
+    const size_t capacity = cutil_HashMap_get_capacity(map);
+
+    /* Act */
+    for (int i = 0; i < N; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t((size_t) 2048, capacity);
+    TEST_ASSERT_EQUAL_size_t(capacity, cutil_HashMap_get_capacity(map));
+    TEST_ASSERT_EQUAL_size_t((size_t) N, cutil_Map_get_count(map));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_keepEntries_when_reserved(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int N = 100;
+    for (int i = 0; i < N; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Act */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_reserve(map, 5000UL));
+    const size_t capacity = cutil_HashMap_get_capacity(map);
+    for (int i = N; i < 5000; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(capacity, cutil_HashMap_get_capacity(map));
+    for (int i = 0; i < 5000; ++i) {
+        const int *const val = cutil_Map_get_ptr(map, &i);
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT(i, *val);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_releaseCapacity_when_shrunkAfterRemovals(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+    for (int i = 10; i < N; ++i) {
+        cutil_Map_remove(map, &i);
+    }
+    const size_t capacity = cutil_HashMap_get_capacity(map);
+
+    /* Act */
+    const cutil_Status status = cutil_Map_shrink_to_fit(map);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    TEST_ASSERT_TRUE(cutil_HashMap_get_capacity(map) < capacity);
+    TEST_ASSERT_EQUAL_size_t((size_t) 16, cutil_HashMap_get_capacity(map));
+    TEST_ASSERT_EQUAL_size_t((size_t) 10, cutil_Map_get_count(map));
+    for (int i = 0; i < N; ++i) {
+        TEST_ASSERT_EQUAL(i < 10, cutil_Map_contains(map, &i));
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for incremental resizing */
+static void
+_should_keepAllEntriesReachable_when_resizingIncrementally(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_SUCCESS,
+      cutil_HashMap_set_incremental_resize(map, 2UL, false)
+    );
+    const int N = 3000;
+    cutil_Bool saw_resizing = false;
+
+    /* Act & Assert */
+    for (int i = 0; i < N; ++i) {
+        const int val = 2 * i;
+        cutil_Map_set(map, &i, &val);
+        saw_resizing |= cutil_HashMap_is_resizing(map);
+        TEST_ASSERT_EQUAL_size_t((size_t) i + 1, cutil_Map_get_count(map));
+    }
+    TEST_ASSERT_TRUE(saw_resizing);
+    for (int i = 0; i < N; ++i) {
+        const int *const val = cutil_Map_get_ptr(map, &i);
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT(2 * i, *val);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_visitEveryKeyOnce_when_iteratingDuringIncrementalResize(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    cutil_HashMap_set_incremental_resize(map, 2UL, true);
+    int n = 0;
+    while (!cutil_HashMap_is_resizing(map)) {
+        cutil_Map_set(map, &n, &n);
+        ++n;
+    }
+    int *const seen = calloc((size_t) n, sizeof *seen);
+
+    /* Act */
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    while (cutil_ConstIterator_next(it)) {
+        const int *const key = cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_TRUE(cutil_Map_contains(map, key));
+        ++seen[*key];
+    }
+
+    /* Assert */
+    TEST_ASSERT_TRUE(cutil_HashMap_is_resizing(map));
+    for (int i = 0; i < n; ++i) {
+        TEST_ASSERT_EQUAL_INT(1, seen[i]);
+    }
+
+    /* Cleanup */
+    cutil_ConstIterator_free(it);
+    free(seen);
+    cutil_Map_free(map);
+}
+
+static void
+_should_removeEntries_when_removedDuringIncrementalResize(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    cutil_HashMap_set_incremental_resize(map, 2UL, false);
+    int n = 0;
+    while (!cutil_HashMap_is_resizing(map)) {
+        cutil_Map_set(map, &n, &n);
+        ++n;
+    }
+
+    /* Act */
+    for (int i = 0; i < n; i += 2) {
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &i));
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t((size_t) n / 2, cutil_Map_get_count(map));
+    for (int i = 0; i < n; ++i) {
+        TEST_ASSERT_EQUAL(i % 2 == 1, cutil_Map_contains(map, &i));
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_finishResize_when_lookupsMigrate(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    cutil_HashMap_set_incremental_resize(map, 4UL, true);
+    int n = 0;
+    while (!cutil_HashMap_is_resizing(map)) {
+        cutil_Map_set(map, &n, &n);
+        ++n;
+    }
+
+    /* Act */
+    for (int i = 0; i < n && cutil_HashMap_is_resizing(map); ++i) {
+        TEST_ASSERT_TRUE(cutil_Map_contains(map, &i));
+    }
+
+    /* Assert */
+    TEST_ASSERT_FALSE(cutil_HashMap_is_resizing(map));
+    for (int i = 0; i < n; ++i) {
+        TEST_ASSERT_TRUE(cutil_Map_contains(map, &i));
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_finishResize_when_switchedToEagerMode(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    cutil_HashMap_set_incremental_resize(map, 2UL, false);
+    int n = 0;
+    while (!cutil_HashMap_is_resizing(map)) {
+        cutil_Map_set(map, &n, &n);
+        ++n;
+    }
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+
+    /* Act */
+    cutil_HashMap_set_incremental_resize(map, 0UL, false);
+
+    /* Assert */
+    TEST_ASSERT_FALSE(cutil_HashMap_is_resizing(map));
+    TEST_ASSERT_TRUE(cutil_HashMap_is_resizing(dup));
+    TEST_ASSERT_EQUAL_size_t((size_t) n, cutil_Map_get_count(map));
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+
+    /* Cleanup */
+    cutil_Map_free(dup);
+    cutil_Map_free(map);
+}
+
+/* Tests for bulk construction */
+static void
+_should_keepLastValue_when_constructedFromArraysWithDuplicates(void)
+{
+    /* Arrange */
+    const size_t N = 1000;
+    cutil_Array *const keys = cutil_Array_alloc(CUTIL_GENERIC_TYPE_INT, N);
+    cutil_Array *const vals = cutil_Array_alloc(CUTIL_GENERIC_TYPE_INT, N);
+    for (size_t i = 0; i < N; ++i) {
+        const int key = (int) (i % 300);
+        const int val = (int) i;
+        cutil_Array_set(keys, i, &key);
+        cutil_Array_set(vals, i, &val);
+    }
+
+    /* Act */
+    cutil_Map *const map = cutil_HashMap_from_arrays(keys, vals);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(map);
+    TEST_ASSERT_EQUAL_size_t(300UL, cutil_Map_get_count(map));
+    for (int key = 0; key < 300; ++key) {
+        const int *const val = cutil_Map_get_ptr(map, &key);
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT(key + 900 - (key >= 100 ? 300 : 0), *val);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_Array_free(keys);
+    cutil_Array_free(vals);
+}
+
+static void
+_should_returnNull_when_arraysDifferInLength(void)
+{
+    /* Arrange */
+    cutil_Array *const keys = cutil_Array_alloc(CUTIL_GENERIC_TYPE_INT, 3UL);
+    cutil_Array *const vals = cutil_Array_alloc(CUTIL_GENERIC_TYPE_INT, 4UL);
+
+    /* Act */
+    cutil_Map *const map = cutil_HashMap_from_arrays(keys, vals);
+
+    /* Assert */
+    TEST_ASSERT_NULL(map);
+
+    /* Cleanup */
+    cutil_Array_free(keys);
+    cutil_Array_free(vals);
+}
+
+static void
+_should_growOnce_when_setMultOnNonEmptyMap(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_STRING, CUTIL_GENERIC_TYPE_INT);
+    cutil_Array *const keys
+      = cutil_Array_alloc(CUTIL_GENERIC_TYPE_STRING, 2000UL);
+    cutil_Array *const vals = cutil_Array_alloc(CUTIL_GENERIC_TYPE_INT, 2000UL);
+    char buf[32];
+    for (int i = 0; i < 2000; ++i) {
+        snprintf(buf, sizeof buf, "key%d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        if (i < 10) {
+            cutil_Map_set(map, str, &i);
+        }
+        const int val = -i;
+        cutil_Array_set(keys, (size_t) i, str);
+        cutil_Array_set(vals, (size_t) i, &val);
+        cutil_String_free(str);
+    }
+
+    /* Act */
+    const cutil_Status status
+      = cutil_HashMap_set_mult(map, keys->data, vals->data, 2000UL);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_size_t(2000UL, cutil_Map_get_count(map));
+    TEST_ASSERT_EQUAL_size_t(4096UL, cutil_HashMap_get_capacity(map));
+    for (int i = 0; i < 2000; ++i) {
+        const int *const val
+          = cutil_Map_get_ptr(map, cutil_Array_get_ptr(keys, (size_t) i));
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT(-i, *val);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_Array_free(keys);
+    cutil_Array_free(vals);
+}
+
+static void
+_should_equalSequentialBuild_when_builtInParallel(void)
+{
+    const size_t nums[] = {0, 100, 200000};
+    const size_t num_threads[] = {1, 2, 3, 8};
+    for (size_t n = 0; n < CUTIL_GET_NATIVE_ARRAY_SIZE(nums); ++n) {
+        /* Arrange */
+        const size_t N = nums[n];
+        cutil_Array *const keys = cutil_Array_alloc(CUTIL_GENERIC_TYPE_INT, N);
+        cutil_Array *const vals = cutil_Array_alloc(CUTIL_GENERIC_TYPE_INT, N);
+        for (size_t i = 0; i < N; ++i) {
+            const int key = (int) (i * 7 % (N / 2 + 1));
+            const int val = (int) i;
+            cutil_Array_set(keys, i, &key);
+            cutil_Array_set(vals, i, &val);
+        }
+        cutil_Map *const expected = cutil_HashMap_from_arrays(keys, vals);
+
+        for (size_t t = 0; t < CUTIL_GET_NATIVE_ARRAY_SIZE(num_threads); ++t) {
+            /* Act */
+            cutil_Map *const map
+              = cutil_HashMap_from_arrays_parallel(keys, vals, num_threads[t]);
+
+            /* Assert */
+            TEST_ASSERT_NOT_NULL(map);
+            TEST_ASSERT_EQUAL_PTR(CUTIL_MAP_TYPE_HASHMAP, map->vtable);
+            TEST_ASSERT_EQUAL_size_t(
+              cutil_Map_get_count(expected), cutil_Map_get_count(map)
+            );
+            TEST_ASSERT_TRUE(cutil_Map_deep_equals(expected, map));
+            const int key = -1;
+            const int val = 1;
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Map_set(map, &key, &val)
+            );
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &key)
+            );
+
+            /* Cleanup */
+            cutil_Map_free(map);
+        }
+
+        /* Cleanup */
+        cutil_Map_free(expected);
+        cutil_Array_free(keys);
+        cutil_Array_free(vals);
+    }
+}
+
+static void
+_should_copyKeys_when_stringMapBuiltInParallel(void)
+{
+    /* Arrange */
+    const size_t N = 50000;
+    cutil_Array *const keys = cutil_Array_alloc(CUTIL_GENERIC_TYPE_STRING, N);
+    cutil_Array *const vals = cutil_Array_alloc(CUTIL_GENERIC_TYPE_INT, N);
+    char buf[32];
+    for (size_t i = 0; i < N; ++i) {
+        snprintf(buf, sizeof buf, "key%zu", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        const int val = (int) i;
+        cutil_Array_set(keys, i, str);
+        cutil_Array_set(vals, i, &val);
+        cutil_String_free(str);
+    }
+
+    /* Act */
+    cutil_Map *const map = cutil_HashMap_from_arrays_parallel(keys, vals, 4);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(map);
+    TEST_ASSERT_EQUAL_size_t(N, cutil_Map_get_count(map));
+    for (size_t i = 0; i < N; ++i) {
+        const int *const val
+          = cutil_Map_get_ptr(map, cutil_Array_get_ptr(keys, i));
+        TEST_ASSERT_NOT_NULL(val);
+        TEST_ASSERT_EQUAL_INT((int) i, *val);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_Array_free(keys);
+    cutil_Array_free(vals);
+}
+
+/**
+ * Returns XOR of `hash(key) ^ hash(val)` over all entries of `map`, computed
+ * by iteration.
+ */
+static cutil_hash_t
+_compute_content_hash(const cutil_Map *map)
+{
+    const cutil_GenericType *const key_type = cutil_Map_get_key_type(map);
+    const cutil_GenericType *const val_type = cutil_Map_get_val_type(map);
+    cutil_hash_t hash = CUTIL_HASH_C(0);
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    while (cutil_ConstIterator_next(it)) {
+        const void *const key = cutil_ConstIterator_get_ptr(it);
+        const void *const val = cutil_Map_get_ptr(map, key);
+        hash ^= cutil_GenericType_apply_hash(key_type, key)
+              ^ cutil_GenericType_apply_hash(val_type, val);
+    }
+    cutil_ConstIterator_free(it);
+    return hash;
+}
+
+/* Tests for content hash */
+static void
+_should_matchRecomputedHash_when_modifiedAfterHashing(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    cutil_HashMap_set_incremental_resize(map, 4UL, false);
+    for (int i = 0; i < 100; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+    TEST_ASSERT_EQUAL_UINT64(_compute_content_hash(map), cutil_Map_hash(map));
+
+    /* Act & Assert */
+    for (int i = 100; i < 1000; ++i) {
+        const int val = -i;
+        cutil_Map_set(map, &i, &val);
+        if (cutil_HashMap_is_resizing(map)) {
+            TEST_ASSERT_EQUAL_UINT64(
+              _compute_content_hash(map), cutil_Map_hash(map)
+            );
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT64(_compute_content_hash(map), cutil_Map_hash(map));
+
+    for (int i = 0; i < 1000; i += 3) {
+        const int val = i * 7;
+        cutil_Map_set(map, &i, &val);
+    }
+    for (int i = 1; i < 1000; i += 3) {
+        cutil_Map_remove(map, &i);
+    }
+    TEST_ASSERT_EQUAL_UINT64(_compute_content_hash(map), cutil_Map_hash(map));
+
+    cutil_Iterator *const it = cutil_Map_get_iterator(map);
+    while (cutil_Iterator_next(it)) {
+        if (*(const int *) cutil_Iterator_get_ptr(it) % 2 == 0) {
+            cutil_Iterator_remove(it);
+        }
+    }
+    cutil_Iterator_free(it);
+    TEST_ASSERT_EQUAL_UINT64(_compute_content_hash(map), cutil_Map_hash(map));
+
+    const int key = 3;
+    const int zero = 0;
+    int *const val = cutil_Map_get_or_insert(map, &key, &zero, NULL);
+    *val += 1;
+    TEST_ASSERT_EQUAL_UINT64(_compute_content_hash(map), cutil_Map_hash(map));
+
+    cutil_Map_reset(map);
+    TEST_ASSERT_EQUAL_UINT64(CUTIL_HASH_C(0), cutil_Map_hash(map));
+    cutil_Map_set(map, &key, &zero);
+    TEST_ASSERT_EQUAL_UINT64(_compute_content_hash(map), cutil_Map_hash(map));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_compareContents_when_contentHashesMaintained(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_HashMap_alloc(
+      CUTIL_GENERIC_TYPE_STRING, CUTIL_GENERIC_TYPE_INT
+    );
+    char buf[32];
+    for (int i = 0; i < 500; ++i) {
+        snprintf(buf, sizeof buf, "key%d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        cutil_Map_set(map, str, &i);
+        cutil_String_free(str);
+    }
+    const cutil_hash_t hash = cutil_Map_hash(map);
+
+    /* Act */
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    cutil_Map *const other = cutil_Map_duplicate(map);
+    cutil_String *const str = cutil_String_from_string("key42");
+    const int val = -1;
+    const int old_val = 42;
+    cutil_Map_set(other, str, &val);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_UINT64(hash, cutil_Map_hash(dup));
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+    TEST_ASSERT_FALSE(cutil_Map_deep_equals(map, other));
+    TEST_ASSERT_NOT_EQUAL(0, cutil_Map_compare(map, other));
+    cutil_Map_set(other, str, &old_val);
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, other));
+    TEST_ASSERT_EQUAL_INT(0, cutil_Map_compare(map, other));
+
+    /* Cleanup */
+    cutil_String_free(str);
+    cutil_Map_free(map);
+    cutil_Map_free(dup);
+    cutil_Map_free(other);
+}
+
 void
 setUp(void)
 {}
@@ -624,6 +1495,337 @@ void
 tearDown(void)
 {}
 
+/* Small map tests */
+static void
+_should_keepAllEntries_when_growingPastSmallCapacity(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_STRING, CUTIL_GENERIC_TYPE_INT);
+    char buf[32];
+
+    /* Act & Assert */
+    for (int i = 0; i < 20; ++i) {
+        (void) snprintf(buf, sizeof buf, "key-%d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        cutil_Map_set(map, str, &i);
+        cutil_String_free(str);
+        for (int j = 0; j <= i; ++j) {
+            (void) snprintf(buf, sizeof buf, "key-%d", j);
+            cutil_String *const key = cutil_String_from_string(buf);
+            int val = -1;
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Map_get(map, key, &val)
+            );
+            TEST_ASSERT_EQUAL_INT(j, val);
+            cutil_String_free(key);
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(20UL, cutil_Map_get_count(map));
+    TEST_ASSERT_GREATER_THAN_size_t(8UL, cutil_HashMap_get_capacity(map));
+
+    for (int i = 0; i < 15; ++i) {
+        (void) snprintf(buf, sizeof buf, "key-%d", i);
+        cutil_String *const key = cutil_String_from_string(buf);
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, key)
+        );
+        cutil_String_free(key);
+    }
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_shrink_to_fit(map));
+    TEST_ASSERT_EQUAL_size_t(8UL, cutil_HashMap_get_capacity(map));
+    TEST_ASSERT_EQUAL_size_t(5UL, cutil_Map_get_count(map));
+    for (int i = 15; i < 20; ++i) {
+        (void) snprintf(buf, sizeof buf, "key-%d", i);
+        cutil_String *const key = cutil_String_from_string(buf);
+        TEST_ASSERT_TRUE(cutil_Map_contains(map, key));
+        cutil_String_free(key);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_iterateAndCopy_when_mapIsSmall(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < 6; ++i) {
+        const int val = i * 10;
+        cutil_Map_set(map, &i, &val);
+    }
+    TEST_ASSERT_EQUAL_size_t(8UL, cutil_HashMap_get_capacity(map));
+
+    /* Act */
+    int sum = 0;
+    cutil_Iterator *const it = cutil_Map_get_iterator(map);
+    while (cutil_Iterator_next(it)) {
+        const int key = *(const int *) cutil_Iterator_get_ptr(it);
+        sum += key;
+        if (key % 2 == 0) {
+            cutil_Iterator_remove(it);
+        }
+    }
+    cutil_Iterator_free(it);
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    const int key = 100;
+    cutil_Map_set(map, &key, &key);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(15, sum);
+    TEST_ASSERT_EQUAL_size_t(4UL, cutil_Map_get_count(map));
+    TEST_ASSERT_EQUAL_size_t(3UL, cutil_Map_get_count(dup));
+    TEST_ASSERT_FALSE(cutil_Map_deep_equals(map, dup));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &key));
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+    for (int i = 1; i < 6; i += 2) {
+        int val = 0;
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Map_get(dup, &i, &val)
+        );
+        TEST_ASSERT_EQUAL_INT(i * 10, val);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(dup);
+    cutil_Map_free(map);
+}
+
+/* Number of boxes held by objects of _BOX_TYPE */
+static size_t _num_live_boxes = 0UL;
+
+static void
+_box_init(void *obj)
+{
+    *(int **) obj = NULL;
+}
+
+static void
+_box_clear(void *obj)
+{
+    int **const box = obj;
+    if (*box != NULL) {
+        --_num_live_boxes;
+    }
+    free(*box);
+    *box = NULL;
+}
+
+static void
+_box_copy(void *dst, const void *src)
+{
+    _box_clear(dst);
+    const int *const src_box = *(int *const *) src;
+    CUTIL_RETURN_IF_NULL(src_box);
+    int **const dst_box = dst;
+    *dst_box = CUTIL_MALLOC_OBJECT(*dst_box);
+    **dst_box = *src_box;
+    ++_num_live_boxes;
+}
+
+/* Values owning a heap-allocated int */
+static const cutil_GenericType _BOX_TYPE = {
+  .name = "box",
+  .size = sizeof(int *),
+  .init = &_box_init,
+  .clear = &_box_clear,
+  .copy = &_box_copy,
+};
+
+static void
+_should_releaseInlineValues_when_entriesRemovedOrMoved(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, &_BOX_TYPE);
+    int boxed = 0;
+    const int *const box = &boxed;
+    _num_live_boxes = 0UL;
+    for (int i = 0; i < 8; ++i) {
+        cutil_Map_set(map, &i, &box);
+    }
+
+    /* Act & Assert */
+    for (int i = 0; i < 8; i += 2) {
+        cutil_Map_remove(map, &i);
+    }
+    TEST_ASSERT_EQUAL_size_t(4UL, _num_live_boxes);
+    for (int i = 8; i < 16; ++i) {
+        cutil_Map_set(map, &i, &box);
+    }
+    TEST_ASSERT_GREATER_THAN_size_t(8UL, cutil_HashMap_get_capacity(map));
+    TEST_ASSERT_EQUAL_size_t(12UL, _num_live_boxes);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    TEST_ASSERT_EQUAL_size_t(0UL, _num_live_boxes);
+}
+
+/* Seeded hashing tests */
+static void
+_should_spreadKeys_when_keysAreMultiplesOfCapacity(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_HashMap_alloc_with_capacity(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 1000UL, 0.5
+    );
+    cutil_Map *const other = cutil_HashMap_alloc_with_capacity(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT, 1000UL, 0.5
+    );
+    const int stride = (int) cutil_HashMap_get_capacity(map);
+
+    /* Act */
+    for (int i = 0; i < 1000; ++i) {
+        const int key = i * stride;
+        cutil_Map_set(map, &key, &i);
+        cutil_Map_set(other, &key, &i);
+    }
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+
+    /* Assert */
+    for (int i = 0; i < 1000; ++i) {
+        const int key = i * stride;
+        int val = -1;
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Map_get(dup, &key, &val)
+        );
+        TEST_ASSERT_EQUAL_INT(i, val);
+    }
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, other));
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(map, dup));
+
+    cutil_Iterator *const it = cutil_Map_get_iterator(map);
+    cutil_Iterator *const other_it = cutil_Map_get_iterator(other);
+    cutil_Bool same_order = true;
+    while (cutil_Iterator_next(it) && cutil_Iterator_next(other_it)) {
+        if (*(const int *) cutil_Iterator_get_ptr(it)
+            != *(const int *) cutil_Iterator_get_ptr(other_it)) {
+            same_order = false;
+        }
+    }
+    TEST_ASSERT_FALSE(same_order);
+
+    /* Cleanup */
+    cutil_Iterator_free(other_it);
+    cutil_Iterator_free(it);
+    cutil_Map_free(dup);
+    cutil_Map_free(other);
+    cutil_Map_free(map);
+}
+
+static void
+_should_spreadKeys_when_stringHashesCollide(void)
+{
+    /* Arrange */
+    /* "ap" and "g6" hash alike, and so do all strings concatenated of them */
+    enum { NUM_BLOCKS = 13, NUM_KEYS = 1 << NUM_BLOCKS };
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_STRING, CUTIL_GENERIC_TYPE_INT);
+    char buf[2 * NUM_BLOCKS + 1];
+
+    /* Act */
+    for (int i = 0; i < NUM_KEYS; ++i) {
+        for (int b = 0; b < NUM_BLOCKS; ++b) {
+            memcpy(buf + 2 * b, ((i >> b) & 1) ? "g6" : "ap", 2U);
+        }
+        buf[2 * NUM_BLOCKS] = '\0';
+        cutil_String *const str = cutil_String_from_string(buf);
+        cutil_Map_set(map, str, &i);
+        cutil_String_free(str);
+    }
+    cutil_HashMapStats stats;
+    cutil_HashMap_get_stats(map, &stats);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(NUM_KEYS, cutil_Map_get_count(map));
+    TEST_ASSERT_LESS_OR_EQUAL_size_t(8UL, stats.max_probe_length);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for cutil_HashMap_get_stats */
+static void
+_should_describeTable_when_statsRequested(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    cutil_HashMapStats stats;
+
+    /* Act & Assert */
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_SUCCESS, cutil_HashMap_get_stats(map, &stats)
+    );
+    TEST_ASSERT_EQUAL_size_t(0UL, stats.num_entries);
+    TEST_ASSERT_EQUAL_size_t(0UL, stats.max_probe_length);
+    TEST_ASSERT_EQUAL_DOUBLE(0.0, stats.avg_probe_length);
+
+    for (int i = 0; i < 1000; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+    for (int i = 0; i < 1000; i += 2) {
+        cutil_Map_remove(map, &i);
+    }
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_SUCCESS, cutil_HashMap_get_stats(map, &stats)
+    );
+    TEST_ASSERT_EQUAL_size_t(cutil_HashMap_get_capacity(map), stats.capacity);
+    TEST_ASSERT_EQUAL_size_t(500UL, stats.num_entries);
+    TEST_ASSERT_GREATER_THAN_size_t(1UL, stats.num_rehashes);
+    TEST_ASSERT_EQUAL_DOUBLE(
+      (double) (stats.num_entries + stats.num_tombstones)
+        / (double) stats.capacity,
+      stats.load_factor
+    );
+
+    size_t num_entries = 0UL;
+    for (size_t i = 0; i < CUTIL_HASHMAP_PROBE_HISTOGRAM_SIZE; ++i) {
+        num_entries += stats.probe_histogram[i];
+    }
+    TEST_ASSERT_EQUAL_size_t(500UL, num_entries);
+    TEST_ASSERT_GREATER_OR_EQUAL_size_t(1UL, stats.max_probe_length);
+    TEST_ASSERT_TRUE(stats.avg_probe_length >= 1.0);
+    TEST_ASSERT_TRUE(stats.avg_probe_length <= stats.max_probe_length);
+    TEST_ASSERT_EQUAL_size_t(
+      stats.num_lookups, stats.num_hits + stats.num_misses
+    );
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_reportSingleProbes_when_mapIsSmall(void)
+{
+    /* Arrange */
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < 4; ++i) {
+        cutil_Map_set(map, &i, &i);
+    }
+    cutil_HashMapStats stats;
+
+    /* Act */
+    const cutil_Status status = cutil_HashMap_get_stats(map, &stats);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_size_t(8UL, stats.capacity);
+    TEST_ASSERT_EQUAL_size_t(4UL, stats.num_entries);
+    TEST_ASSERT_EQUAL_size_t(0UL, stats.num_tombstones);
+    TEST_ASSERT_EQUAL_size_t(0UL, stats.num_rehashes);
+    TEST_ASSERT_EQUAL_DOUBLE(0.5, stats.load_factor);
+    TEST_ASSERT_EQUAL_size_t(4UL, stats.probe_histogram[0]);
+    TEST_ASSERT_EQUAL_size_t(1UL, stats.max_probe_length);
+    TEST_ASSERT_EQUAL_DOUBLE(1.0, stats.avg_probe_length);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
 int
 main(void)
 {
@@ -652,5 +1854,54 @@ main(void)
     RUN_TEST(_should_returnFalse_when_nextCalledAfterExhaustionOnConstIterator);
     RUN_TEST(_should_returnFalse_when_nextCalledAfterExhaustionOnIterator);
 
+    /* Probing tests */
+    RUN_TEST(_should_retrieveAllValues_when_manyEntriesInserted);
+    RUN_TEST(_should_findAllKeys_when_keysShareLowBits);
+    RUN_TEST(_should_keepRemainingEntries_when_everyOtherKeyRemoved);
+    RUN_TEST(_should_reinsertKeys_when_previouslyRemoved);
+    RUN_TEST(_should_preserveAllEntries_when_largeMapDuplicated);
+    RUN_TEST(_should_keepEntries_when_keysChurnAtConstantSize);
+    RUN_TEST(_should_keepEntries_when_keysChurnDuringIncrementalResize);
+    RUN_TEST(_should_resolveAllKeys_when_lookedUpInBatch);
+    RUN_TEST(_should_countOccurrences_when_valuesUpdatedInPlace);
+    RUN_TEST(_should_returnExistingValue_when_getOrInsertDuringResize);
+
+    /* Capacity management tests */
+    RUN_TEST(_should_returnNull_when_maxLoadFactorInvalid);
+    RUN_TEST(_should_notExpand_when_allocatedWithCapacity);
+    RUN_TEST(_should_keepEntries_when_reserved);
+    RUN_TEST(_should_releaseCapacity_when_shrunkAfterRemovals);
+
+    /* Bulk construction tests */
+    RUN_TEST(_should_keepLastValue_when_constructedFromArraysWithDuplicates);
+    RUN_TEST(_should_returnNull_when_arraysDifferInLength);
+    RUN_TEST(_should_growOnce_when_setMultOnNonEmptyMap);
+    RUN_TEST(_should_equalSequentialBuild_when_builtInParallel);
+    RUN_TEST(_should_copyKeys_when_stringMapBuiltInParallel);
+
+    /* Incremental resize tests */
+    RUN_TEST(_should_keepAllEntriesReachable_when_resizingIncrementally);
+    RUN_TEST(_should_visitEveryKeyOnce_when_iteratingDuringIncrementalResize);
+    RUN_TEST(_should_removeEntries_when_removedDuringIncrementalResize);
+    RUN_TEST(_should_finishResize_when_lookupsMigrate);
+    RUN_TEST(_should_finishResize_when_switchedToEagerMode);
+
+    /* Content hash tests */
+    RUN_TEST(_should_matchRecomputedHash_when_modifiedAfterHashing);
+    RUN_TEST(_should_compareContents_when_contentHashesMaintained);
+
+    /* Small map tests */
+    RUN_TEST(_should_keepAllEntries_when_growingPastSmallCapacity);
+    RUN_TEST(_should_iterateAndCopy_when_mapIsSmall);
+    RUN_TEST(_should_releaseInlineValues_when_entriesRemovedOrMoved);
+
+    /* Seeded hashing tests */
+    RUN_TEST(_should_spreadKeys_when_keysAreMultiplesOfCapacity);
+    RUN_TEST(_should_spreadKeys_when_stringHashesCollide);
+
+    /* Tests for cutil_HashMap_get_stats */
+    RUN_TEST(_should_describeTable_when_statsRequested);
+    RUN_TEST(_should_reportSingleProbes_when_mapIsSmall);
+
     return UNITY_END();
 }
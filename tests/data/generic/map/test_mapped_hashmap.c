@@ -0,0 +1,297 @@
+#include "unity.h"
+#include <cutil/data/generic/map/mapped_hashmap.h>
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/map/hashmap.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/os/path.h>
+#include <cutil/std/stdio.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/string/type.h>
+#include <cutil/util/macro.h>
+
+#define PATH_BASE CUTIL_TEST_RESOURCE_DIR "/tmp"
+#define MAP_PATH PATH_BASE "/test_mapped_hashmap.bin"
+
+/**
+ * Returns a HashMap holding keys i * 3 with value -i for all i in [0, num).
+ */
+static cutil_Map *
+_alloc_source_map(int num)
+{
+    cutil_Map *const map
+      = cutil_HashMap_alloc(CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_LONG);
+    for (int i = 0; i < num; ++i) {
+        const int key = i * 3;
+        const long val = -i;
+        cutil_Map_set(map, &key, &val);
+    }
+    return map;
+}
+
+/**
+ * Writes the map returned by '_alloc_source_map' to MAP_PATH.
+ */
+static void
+_write_source_map(int num)
+{
+    cutil_Map *const map = _alloc_source_map(num);
+    cutil_mkdirp(PATH_BASE, 0755);
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_SUCCESS, cutil_MappedHashMap_write(map, MAP_PATH)
+    );
+    cutil_Map_free(map);
+}
+
+static cutil_Map *
+_open_source_map(void)
+{
+    return cutil_MappedHashMap_open(
+      MAP_PATH, CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_LONG
+    );
+}
+
+/**
+ * Asserts that `map` holds exactly the entries of '_alloc_source_map(num)'.
+ */
+static void
+_assert_source_entries(const cutil_Map *map, int num)
+{
+    TEST_ASSERT_EQUAL_size_t((size_t) num, cutil_Map_get_count(map));
+    for (int key = -3; key < num * 3 + 3; ++key) {
+        const long *const val = cutil_Map_get_ptr(map, &key);
+        if (key >= 0 && key < num * 3 && key % 3 == 0) {
+            TEST_ASSERT_NOT_NULL(val);
+            TEST_ASSERT_EQUAL_INT64(-key / 3, *val);
+        } else {
+            TEST_ASSERT_NULL(val);
+        }
+    }
+
+    size_t num_visited = 0UL;
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    while (cutil_ConstIterator_next(it)) {
+        const int key = *(const int *) cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_EQUAL_INT(0, key % 3);
+        TEST_ASSERT_TRUE(key >= 0 && key < num * 3);
+        ++num_visited;
+    }
+    TEST_ASSERT_FALSE(cutil_ConstIterator_next(it));
+    TEST_ASSERT_NULL(cutil_ConstIterator_get_ptr(it));
+    cutil_ConstIterator_free(it);
+    TEST_ASSERT_EQUAL_size_t((size_t) num, num_visited);
+}
+
+/* Tests for cutil_MappedHashMap_write and cutil_MappedHashMap_open */
+static void
+_should_findEveryKey_when_writtenAndOpened(void)
+{
+    const int sizes[] = {0, 1, 6, 7, 1000, 50000};
+    for (size_t s = 0; s < CUTIL_GET_NATIVE_ARRAY_SIZE(sizes); ++s) {
+        /* Arrange */
+        _write_source_map(sizes[s]);
+
+        /* Act */
+        cutil_Map *const map = _open_source_map();
+
+        /* Assert */
+        TEST_ASSERT_NOT_NULL(map);
+        TEST_ASSERT_EQUAL_PTR(CUTIL_MAP_TYPE_MAPPED_HASHMAP, map->vtable);
+        TEST_ASSERT_EQUAL_PTR(
+          CUTIL_GENERIC_TYPE_INT, cutil_Map_get_key_type(map)
+        );
+        TEST_ASSERT_EQUAL_PTR(
+          CUTIL_GENERIC_TYPE_LONG, cutil_Map_get_val_type(map)
+        );
+        _assert_source_entries(map, sizes[s]);
+
+        /* Cleanup */
+        cutil_Map_free(map);
+        cutil_rm(MAP_PATH, CUTIL_FALSE);
+    }
+}
+
+static void
+_should_returnNull_when_typesOrFileDoNotMatch(void)
+{
+    /* Arrange */
+    _write_source_map(10);
+    cutil_mkdirp(PATH_BASE, 0755);
+    FILE *const f = fopen(PATH_BASE "/test_mapped_hashmap.txt", "w");
+    fputs("not a map", f);
+    fclose(f);
+
+    /* Act & Assert */
+    TEST_ASSERT_NULL(cutil_MappedHashMap_open(
+      MAP_PATH, CUTIL_GENERIC_TYPE_UINT, CUTIL_GENERIC_TYPE_LONG
+    ));
+    TEST_ASSERT_NULL(cutil_MappedHashMap_open(
+      MAP_PATH, CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    ));
+    TEST_ASSERT_NULL(cutil_MappedHashMap_open(
+      PATH_BASE "/test_mapped_hashmap.txt", CUTIL_GENERIC_TYPE_INT,
+      CUTIL_GENERIC_TYPE_LONG
+    ));
+    TEST_ASSERT_NULL(cutil_MappedHashMap_open(
+      PATH_BASE "/does_not_exist.bin", CUTIL_GENERIC_TYPE_INT,
+      CUTIL_GENERIC_TYPE_LONG
+    ));
+
+    /* Cleanup */
+    cutil_rm(PATH_BASE "/test_mapped_hashmap.txt", CUTIL_FALSE);
+    cutil_rm(MAP_PATH, CUTIL_FALSE);
+}
+
+static void
+_should_returnFailure_when_typesNotTriviallyCopyable(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_HashMap_alloc(
+      CUTIL_GENERIC_TYPE_STRING, CUTIL_GENERIC_TYPE_INT
+    );
+
+    /* Act */
+    const cutil_Status status = cutil_MappedHashMap_write(map, MAP_PATH);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, status);
+    TEST_ASSERT_FALSE(cutil_isfile(MAP_PATH));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+static void
+_should_keepPreviousView_when_fileRewritten(void)
+{
+    /* Arrange */
+    _write_source_map(100);
+    cutil_Map *const old_map = _open_source_map();
+
+    /* Act */
+    _write_source_map(200);
+    cutil_Map *const new_map = _open_source_map();
+
+    /* Assert */
+    _assert_source_entries(old_map, 100);
+    _assert_source_entries(new_map, 200);
+
+    /* Cleanup */
+    cutil_Map_free(old_map);
+    cutil_Map_free(new_map);
+    cutil_rm(MAP_PATH, CUTIL_FALSE);
+}
+
+/* Tests for read-only operations */
+static void
+_should_rejectModifications_when_mapOpened(void)
+{
+    /* Arrange */
+    _write_source_map(10);
+    cutil_Map *const map = _open_source_map();
+    const int key = 3;
+    const long val = 100;
+    cutil_Bool inserted = CUTIL_TRUE;
+
+    /* Act & Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Map_set(map, &key, &val));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Map_remove(map, &key));
+    TEST_ASSERT_NULL(cutil_Map_get_or_insert(map, &key, &val, &inserted));
+    TEST_ASSERT_FALSE(inserted);
+    cutil_Iterator *const it = cutil_Map_get_iterator(map);
+    TEST_ASSERT_TRUE(cutil_Iterator_next(it));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Iterator_remove(it));
+    cutil_Iterator_free(it);
+    _assert_source_entries(map, 10);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_rm(MAP_PATH, CUTIL_FALSE);
+}
+
+/* Tests for batched lookups */
+static void
+_should_matchSingleLookups_when_lookedUpInBatch(void)
+{
+    /* Arrange */
+    _write_source_map(1000);
+    cutil_Map *const map = _open_source_map();
+    enum { N = 100 };
+    int keys[N];
+    const void *vals[N];
+    for (int i = 0; i < N; ++i) {
+        keys[i] = i * 7;
+    }
+
+    /* Act */
+    const cutil_Status status
+      = cutil_Map_get_ptr_batch(map, keys, (size_t) N, vals);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    for (int i = 0; i < N; ++i) {
+        TEST_ASSERT_EQUAL_PTR(cutil_Map_get_ptr(map, &keys[i]), vals[i]);
+        TEST_ASSERT_EQUAL(keys[i] % 3 == 0, vals[i] != NULL);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_rm(MAP_PATH, CUTIL_FALSE);
+}
+
+/* Tests for copy, duplicate and reset */
+static void
+_should_mapFileAgain_when_duplicatedAndCopied(void)
+{
+    /* Arrange */
+    _write_source_map(500);
+    cutil_Map *const map = _open_source_map();
+    cutil_Map *const copy = _open_source_map();
+    cutil_Map_reset(copy);
+
+    /* Act */
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    cutil_Map_copy(copy, map);
+    cutil_Map_reset(map);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+    const int key = 0;
+    TEST_ASSERT_FALSE(cutil_Map_contains(map, &key));
+    _assert_source_entries(dup, 500);
+    _assert_source_entries(copy, 500);
+    TEST_ASSERT_TRUE(cutil_Map_deep_equals(dup, copy));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_Map_free(dup);
+    cutil_Map_free(copy);
+    cutil_rm(MAP_PATH, CUTIL_FALSE);
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_findEveryKey_when_writtenAndOpened);
+    RUN_TEST(_should_returnNull_when_typesOrFileDoNotMatch);
+    RUN_TEST(_should_returnFailure_when_typesNotTriviallyCopyable);
+    RUN_TEST(_should_keepPreviousView_when_fileRewritten);
+
+    RUN_TEST(_should_rejectModifications_when_mapOpened);
+
+    RUN_TEST(_should_matchSingleLookups_when_lookedUpInBatch);
+
+    RUN_TEST(_should_mapFileAgain_when_duplicatedAndCopied);
+
+    return UNITY_END();
+}
@@ -0,0 +1,402 @@
+#include "unity.h"
+#include <cutil/data/generic/map/persistent_hashmap.h>
+
+#include <cutil/data/generic/iterator.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/std/stdio.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/string/type.h>
+#include <cutil/util/hash.h>
+#include <cutil/util/macro.h>
+
+static cutil_hash_t
+_colliding_hash(const void *obj)
+{
+    return (cutil_hash_t) (*(const int *) obj % 3);
+}
+
+/** Key type whose hashes collide for all keys congruent modulo 3 */
+static const cutil_GenericType COLLIDING_INT_TYPE = {
+  .name = "colliding_int",
+  .size = sizeof(int),
+  .hash = &_colliding_hash,
+};
+
+/**
+ * Asserts that `map` holds exactly the keys in [0, num) for which `present`
+ * is set, each mapped to its square, and that iterating visits each once.
+ */
+static void
+_assert_entries(const cutil_Map *map, const cutil_Bool *present, int num)
+{
+    size_t num_present = 0UL;
+    for (int i = 0; i < num; ++i) {
+        const int *const val = cutil_Map_get_ptr(map, &i);
+        if (present[i]) {
+            TEST_ASSERT_NOT_NULL(val);
+            TEST_ASSERT_EQUAL_INT(i * i, *val);
+            ++num_present;
+        } else {
+            TEST_ASSERT_NULL(val);
+        }
+    }
+    TEST_ASSERT_EQUAL_size_t(num_present, cutil_Map_get_count(map));
+
+    cutil_Bool *const visited = calloc((size_t) num, sizeof *visited);
+    size_t num_visited = 0UL;
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    while (cutil_ConstIterator_next(it)) {
+        const int key = *(const int *) cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_TRUE(key >= 0 && key < num);
+        TEST_ASSERT_TRUE(present[key]);
+        TEST_ASSERT_FALSE(visited[key]);
+        visited[key] = CUTIL_TRUE;
+        ++num_visited;
+    }
+    cutil_ConstIterator_free(it);
+    free(visited);
+    TEST_ASSERT_EQUAL_size_t(num_present, num_visited);
+}
+
+/* Tests for cutil_PersistentHashMap_alloc */
+static void
+_should_allocatePersistentHashMap_when_createdWithValidTypes(void)
+{
+    /* Arrange */
+    const cutil_GenericType *const key_type = CUTIL_GENERIC_TYPE_INT;
+    const cutil_GenericType *const val_type = CUTIL_GENERIC_TYPE_DOUBLE;
+
+    /* Act */
+    cutil_Map *const map = cutil_PersistentHashMap_alloc(key_type, val_type);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(map);
+    TEST_ASSERT_NOT_NULL(map->data);
+    TEST_ASSERT_EQUAL_STRING("cutil_PersistentHashMap", map->vtable->name);
+    TEST_ASSERT_EQUAL_PTR(key_type, cutil_Map_get_key_type(map));
+    TEST_ASSERT_EQUAL_PTR(val_type, cutil_Map_get_val_type(map));
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+    const int key = 1;
+    TEST_ASSERT_FALSE(cutil_Map_contains(map, &key));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Map_remove(map, &key));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for set, get and remove */
+static void
+_should_storeAndRemoveEntries_when_manyKeysUsed(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_PersistentHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    const int NUM_ENTRIES = 20000;
+    cutil_Bool *const present = malloc((size_t) NUM_ENTRIES * sizeof *present);
+
+    /* Act */
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        const int val = -i;
+        cutil_Map_set(map, &i, &val);
+        const int sq = i * i;
+        cutil_Map_set(map, &i, &sq);
+        present[i] = CUTIL_TRUE;
+    }
+    _assert_entries(map, present, NUM_ENTRIES);
+    for (int i = 0; i < NUM_ENTRIES; i += 3) {
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &i));
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Map_remove(map, &i));
+        present[i] = CUTIL_FALSE;
+    }
+
+    /* Assert */
+    _assert_entries(map, present, NUM_ENTRIES);
+    int val = 0;
+    const int key = 7;
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_get(map, &key, &val));
+    TEST_ASSERT_EQUAL_INT(49, val);
+
+    /* Removing everything leaves an empty map */
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        cutil_Map_remove(map, &i);
+        present[i] = CUTIL_FALSE;
+    }
+    _assert_entries(map, present, NUM_ENTRIES);
+
+    /* Cleanup */
+    free(present);
+    cutil_Map_free(map);
+}
+
+static void
+_should_keepAllEntries_when_hashesCollide(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_PersistentHashMap_alloc(
+      &COLLIDING_INT_TYPE, CUTIL_GENERIC_TYPE_INT
+    );
+    const int NUM_ENTRIES = 60;
+    cutil_Bool present[60];
+
+    /* Act */
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        const int sq = i * i;
+        cutil_Map_set(map, &i, &sq);
+        present[i] = CUTIL_TRUE;
+    }
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    for (int i = 0; i < NUM_ENTRIES; i += 2) {
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_remove(map, &i));
+        present[i] = CUTIL_FALSE;
+    }
+
+    /* Assert */
+    _assert_entries(map, present, NUM_ENTRIES);
+    TEST_ASSERT_EQUAL_size_t(60UL, cutil_Map_get_count(dup));
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        TEST_ASSERT_TRUE(cutil_Map_contains(dup, &i));
+    }
+
+    /* Cleanup */
+    cutil_Map_free(dup);
+    cutil_Map_free(map);
+}
+
+/* Tests for structural sharing */
+static void
+_should_isolateSnapshots_when_duplicateModified(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_PersistentHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    const int NUM_ENTRIES = 5000;
+    cutil_Bool *const present = malloc((size_t) NUM_ENTRIES * sizeof *present);
+    cutil_Bool *const dup_present
+      = malloc((size_t) NUM_ENTRIES * sizeof *dup_present);
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        const int sq = i * i;
+        if (i % 2 == 0) {
+            cutil_Map_set(map, &i, &sq);
+        }
+        present[i] = i % 2 == 0;
+        dup_present[i] = i % 2 == 0;
+    }
+
+    /* Act */
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        const int sq = i * i;
+        if (i % 4 == 0) {
+            cutil_Map_remove(dup, &i);
+            dup_present[i] = CUTIL_FALSE;
+        } else if (i % 2 == 1) {
+            cutil_Map_set(map, &i, &sq);
+            present[i] = CUTIL_TRUE;
+        }
+    }
+    const int key = 2;
+    int *const val = cutil_Map_get_or_insert(dup, &key, &key, NULL);
+    *val = -1;
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(4, *(const int *) cutil_Map_get_ptr(map, &key));
+    TEST_ASSERT_EQUAL_INT(-1, *(const int *) cutil_Map_get_ptr(dup, &key));
+    *val = 4;
+    _assert_entries(map, present, NUM_ENTRIES);
+    _assert_entries(dup, dup_present, NUM_ENTRIES);
+
+    /* Cleanup */
+    free(present);
+    free(dup_present);
+    cutil_Map_free(map);
+    cutil_Map_free(dup);
+}
+
+static void
+_should_shareEntries_when_copied(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_PersistentHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    for (int i = 0; i < 1000; ++i) {
+        const int sq = i * i;
+        cutil_Map_set(map, &i, &sq);
+    }
+    cutil_Map *const copy = cutil_PersistentHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    const int stale = -1;
+    cutil_Map_set(copy, &stale, &stale);
+
+    /* Act */
+    cutil_Map_copy(copy, map);
+    cutil_Map_copy(copy, copy);
+    cutil_Map_reset(map);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Map_get_count(map));
+    TEST_ASSERT_EQUAL_size_t(1000UL, cutil_Map_get_count(copy));
+    TEST_ASSERT_FALSE(cutil_Map_contains(copy, &stale));
+    const int key = 31;
+    TEST_ASSERT_EQUAL_INT(961, *(const int *) cutil_Map_get_ptr(copy, &key));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+    cutil_Map_free(copy);
+}
+
+static void
+_should_releaseOwnedKeys_when_stringKeysShared(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_PersistentHashMap_alloc(
+      CUTIL_GENERIC_TYPE_STRING, CUTIL_GENERIC_TYPE_INT
+    );
+    char buf[32];
+    for (int i = 0; i < 500; ++i) {
+        snprintf(buf, sizeof buf, "key-%04d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        cutil_Map_set(map, str, &i);
+        cutil_String_free(str);
+    }
+
+    /* Act */
+    cutil_Map *const dup = cutil_Map_duplicate(map);
+    for (int i = 0; i < 500; i += 2) {
+        snprintf(buf, sizeof buf, "key-%04d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Map_remove(dup, str));
+        cutil_String_free(str);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(500UL, cutil_Map_get_count(map));
+    TEST_ASSERT_EQUAL_size_t(250UL, cutil_Map_get_count(dup));
+    TEST_ASSERT_FALSE(cutil_Map_deep_equals(map, dup));
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(dup);
+    while (cutil_ConstIterator_next(it)) {
+        const cutil_String *const key = cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_TRUE(cutil_Map_contains(map, key));
+    }
+    cutil_ConstIterator_free(it);
+
+    /* Cleanup */
+    cutil_Map_free(dup);
+    cutil_Map_free(map);
+}
+
+/* Tests for iterators */
+static void
+_should_iterateSnapshot_when_mapModifiedDuringIteration(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_PersistentHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    const int NUM_ENTRIES = 3000;
+    cutil_Bool *const present = malloc((size_t) NUM_ENTRIES * sizeof *present);
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        const int sq = i * i;
+        if (i < NUM_ENTRIES / 2) {
+            cutil_Map_set(map, &i, &sq);
+        }
+        present[i] = CUTIL_TRUE;
+    }
+
+    /* Act */
+    cutil_ConstIterator *const it = cutil_Map_get_const_iterator(map);
+    size_t num_visited = 0UL;
+    int next = NUM_ENTRIES / 2;
+    while (cutil_ConstIterator_next(it)) {
+        const int key = *(const int *) cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_TRUE(key < NUM_ENTRIES / 2);
+        const int sq = next * next;
+        cutil_Map_set(map, &next, &sq);
+        ++next;
+        ++num_visited;
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t((size_t) NUM_ENTRIES / 2, num_visited);
+    _assert_entries(map, present, NUM_ENTRIES);
+    cutil_ConstIterator_rewind(it);
+    num_visited = 0UL;
+    while (cutil_ConstIterator_next(it)) {
+        ++num_visited;
+    }
+    TEST_ASSERT_EQUAL_size_t((size_t) NUM_ENTRIES, num_visited);
+
+    /* Cleanup */
+    cutil_ConstIterator_free(it);
+    free(present);
+    cutil_Map_free(map);
+}
+
+static void
+_should_removeEntries_when_removedThroughIterator(void)
+{
+    /* Arrange */
+    cutil_Map *const map = cutil_PersistentHashMap_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GENERIC_TYPE_INT
+    );
+    const int NUM_ENTRIES = 1000;
+    cutil_Bool *const present = malloc((size_t) NUM_ENTRIES * sizeof *present);
+    for (int i = 0; i < NUM_ENTRIES; ++i) {
+        const int sq = i * i;
+        cutil_Map_set(map, &i, &sq);
+        present[i] = i % 3 != 0;
+    }
+
+    /* Act */
+    cutil_Iterator *const it = cutil_Map_get_iterator(map);
+    size_t num_visited = 0UL;
+    while (cutil_Iterator_next(it)) {
+        const int key = *(const int *) cutil_Iterator_get_ptr(it);
+        if (key % 3 == 0) {
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Iterator_remove(it)
+            );
+        }
+        ++num_visited;
+    }
+    cutil_Iterator_free(it);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t((size_t) NUM_ENTRIES, num_visited);
+    _assert_entries(map, present, NUM_ENTRIES);
+
+    /* Cleanup */
+    free(present);
+    cutil_Map_free(map);
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_allocatePersistentHashMap_when_createdWithValidTypes);
+
+    RUN_TEST(_should_storeAndRemoveEntries_when_manyKeysUsed);
+    RUN_TEST(_should_keepAllEntries_when_hashesCollide);
+
+    RUN_TEST(_should_isolateSnapshots_when_duplicateModified);
+    RUN_TEST(_should_shareEntries_when_copied);
+    RUN_TEST(_should_releaseOwnedKeys_when_stringKeysShared);
+
+    RUN_TEST(_should_iterateSnapshot_when_mapModifiedDuringIteration);
+    RUN_TEST(_should_removeEntries_when_removedThroughIterator);
+
+    return UNITY_END();
+}
@@ -0,0 +1,342 @@
+#include "unity.h"
+#include <cutil/data/generic/set/bitset.h>
+
+#include <limits.h>
+
+#include <cutil/data/generic/set/hashset.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/std/inttypes.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/util/macro.h>
+
+/* Tests for cutil_BitSet_alloc */
+static void
+_should_allocateBitSet_when_elemTypeIsUnsigned(void)
+{
+    /* Arrange */
+    const cutil_GenericType *const elem_types[] = {
+      CUTIL_GENERIC_TYPE_UCHAR, CUTIL_GENERIC_TYPE_U16,
+      CUTIL_GENERIC_TYPE_UINT,  CUTIL_GENERIC_TYPE_U64,
+      CUTIL_GENERIC_TYPE_SIZET,
+    };
+    const size_t NUM_TYPES = CUTIL_GET_NATIVE_ARRAY_SIZE(elem_types);
+
+    for (size_t i = 0; i < NUM_TYPES; ++i) {
+        /* Act */
+        cutil_Set *const set = cutil_BitSet_alloc(elem_types[i]);
+
+        /* Assert */
+        TEST_ASSERT_NOT_NULL(set);
+        TEST_ASSERT_EQUAL_PTR(CUTIL_SET_TYPE_BITSET, set->vtable);
+        TEST_ASSERT_EQUAL_PTR(elem_types[i], cutil_Set_get_elem_type(set));
+        TEST_ASSERT_EQUAL_size_t(0UL, cutil_Set_get_count(set));
+
+        /* Cleanup */
+        cutil_Set_free(set);
+    }
+}
+
+static void
+_should_returnNull_when_elemTypeIsNotUnsigned(void)
+{
+    /* Arrange */
+    const cutil_GenericType *const elem_types[] = {
+      CUTIL_GENERIC_TYPE_INT,
+      CUTIL_GENERIC_TYPE_I64,
+      CUTIL_GENERIC_TYPE_DOUBLE,
+      NULL,
+    };
+    const size_t NUM_TYPES = CUTIL_GET_NATIVE_ARRAY_SIZE(elem_types);
+
+    for (size_t i = 0; i < NUM_TYPES; ++i) {
+        /* Act / Assert */
+        TEST_ASSERT_NULL(cutil_BitSet_alloc(elem_types[i]));
+    }
+}
+
+static void
+_should_reserveAndShrink_when_allocatedWithBound(void)
+{
+    /* Arrange */
+    cutil_Set *const set
+      = cutil_BitSet_alloc_with_bound(CUTIL_GENERIC_TYPE_U16, 1000UL);
+    const size_t capacity = cutil_BitSet_get_capacity(set);
+    const uint16_t elem = 70U;
+
+    /* Act */
+    cutil_Set_add(set, &elem);
+    const size_t capacity_after_add = cutil_BitSet_get_capacity(set);
+    const cutil_Status status = cutil_Set_shrink_to_fit(set);
+
+    /* Assert */
+    TEST_ASSERT_GREATER_OR_EQUAL_size_t(1000UL, capacity);
+    TEST_ASSERT_EQUAL_size_t(capacity, capacity_after_add);
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_size_t(128UL, cutil_BitSet_get_capacity(set));
+    TEST_ASSERT_EQUAL_size_t(1000UL, cutil_BitSet_get_bound(set));
+    TEST_ASSERT_TRUE(cutil_Set_contains(set, &elem));
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+static void
+_should_rejectElements_when_notBelowBound(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_BitSet_alloc(CUTIL_GENERIC_TYPE_U64);
+    cutil_Set *const bounded
+      = cutil_BitSet_alloc_with_bound(CUTIL_GENERIC_TYPE_U64, 100UL);
+    cutil_Set *const small
+      = cutil_BitSet_alloc_with_bound(CUTIL_GENERIC_TYPE_U8, 1000UL);
+    const uint64_t huge = UINT64_C(1) << 50;
+    const uint64_t last = 99U;
+    const uint64_t first_out = 100U;
+
+    /* Act */
+    const cutil_Status huge_status = cutil_Set_add(set, &huge);
+    cutil_Set_add(set, &first_out);
+    const cutil_Status last_status = cutil_Set_add(bounded, &last);
+    const cutil_Status out_status = cutil_Set_add(bounded, &first_out);
+    const cutil_Status reserve_status = cutil_Set_reserve(bounded, 101UL);
+    const cutil_Status union_status = cutil_Set_union(bounded, set);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, huge_status);
+    TEST_ASSERT_FALSE(cutil_Set_contains(set, &huge));
+    TEST_ASSERT_EQUAL_size_t(128UL, cutil_BitSet_get_capacity(set));
+    TEST_ASSERT_EQUAL_size_t(1UL << 24, cutil_BitSet_get_bound(set));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, last_status);
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, out_status);
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, reserve_status);
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, union_status);
+    TEST_ASSERT_EQUAL_size_t(1UL, cutil_Set_get_count(bounded));
+    TEST_ASSERT_EQUAL_size_t(256UL, cutil_BitSet_get_bound(small));
+    TEST_ASSERT_NULL(cutil_BitSet_alloc_with_bound(CUTIL_GENERIC_TYPE_U8, 0UL));
+
+    /* Cleanup */
+    cutil_Set_free(small);
+    cutil_Set_free(bounded);
+    cutil_Set_free(set);
+}
+
+/* Tests for membership */
+static void
+_should_trackMembership_when_elementsSpanWords(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_BitSet_alloc(CUTIL_GENERIC_TYPE_U64);
+    const uint64_t elems[] = {0U, 1U, 63U, 64U, 65U, 127U, 128U, 5000U};
+    const size_t N = CUTIL_GET_NATIVE_ARRAY_SIZE(elems);
+
+    /* Act */
+    for (size_t i = 0; i < N; ++i) {
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Set_add(set, &elems[i])
+        );
+    }
+    const uint64_t removed = 64U;
+    const cutil_Status remove_status = cutil_Set_remove(set, &removed);
+    const cutil_Status missing_status = cutil_Set_remove(set, &removed);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, remove_status);
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, missing_status);
+    TEST_ASSERT_EQUAL_size_t(N - 1UL, cutil_Set_get_count(set));
+    for (uint64_t elem = 0U; elem < 5100U; ++elem) {
+        cutil_Bool expected = false;
+        for (size_t i = 0; i < N; ++i) {
+            expected = expected || (elems[i] == elem && elem != removed);
+        }
+        TEST_ASSERT_EQUAL(expected, cutil_Set_contains(set, &elem));
+    }
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+static void
+_should_reportInsertion_when_insertedIfAbsent(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_BitSet_alloc(CUTIL_GENERIC_TYPE_UCHAR);
+    const unsigned char elem = UCHAR_MAX;
+    cutil_Bool first = false;
+    cutil_Bool second = true;
+
+    /* Act */
+    cutil_Set_insert_if_absent(set, &elem, &first);
+    cutil_Set_insert_if_absent(set, &elem, &second);
+
+    /* Assert */
+    TEST_ASSERT_TRUE(first);
+    TEST_ASSERT_FALSE(second);
+    TEST_ASSERT_EQUAL_size_t(1UL, cutil_Set_get_count(set));
+    TEST_ASSERT_TRUE(cutil_Set_contains(set, &elem));
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+/* Tests for iterators */
+static void
+_should_iterateInAscendingOrder_when_elementsSpanWords(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_BitSet_alloc(CUTIL_GENERIC_TYPE_U16);
+    const uint16_t elems[] = {700U, 3U, 64U, 63U, 200U, 0U};
+    const uint16_t sorted[] = {0U, 3U, 63U, 64U, 200U, 700U};
+    for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(elems); ++i) {
+        cutil_Set_add(set, &elems[i]);
+    }
+    cutil_ConstIterator *const it = cutil_Set_get_const_iterator(set);
+
+    /* Act / Assert */
+    for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(sorted); ++i) {
+        TEST_ASSERT_TRUE(cutil_ConstIterator_next(it));
+        const uint16_t *const p = cutil_ConstIterator_get_ptr(it);
+        uint16_t elem = 0U;
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_ConstIterator_get(it, &elem)
+        );
+        TEST_ASSERT_EQUAL_UINT16(sorted[i], *p);
+        TEST_ASSERT_EQUAL_UINT16(sorted[i], elem);
+    }
+    TEST_ASSERT_FALSE(cutil_ConstIterator_next(it));
+    TEST_ASSERT_NULL(cutil_ConstIterator_get_ptr(it));
+
+    /* Cleanup */
+    cutil_ConstIterator_free(it);
+    cutil_Set_free(set);
+}
+
+static void
+_should_removeCurrentElement_when_removeCalledOnIterator(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_BitSet_alloc(CUTIL_GENERIC_TYPE_UINT);
+    for (unsigned elem = 0U; elem < 300U; ++elem) {
+        cutil_Set_add(set, &elem);
+    }
+    cutil_Iterator *const it = cutil_Set_get_iterator(set);
+
+    /* Act */
+    while (cutil_Iterator_next(it)) {
+        const unsigned *const p = cutil_Iterator_get_ptr(it);
+        if (*p % 3U != 0U) {
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Iterator_remove(it)
+            );
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_FAILURE, cutil_Iterator_remove(it)
+            );
+        }
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(100UL, cutil_Set_get_count(set));
+    for (unsigned elem = 0U; elem < 300U; ++elem) {
+        TEST_ASSERT_EQUAL(elem % 3U == 0U, cutil_Set_contains(set, &elem));
+    }
+
+    /* Cleanup */
+    cutil_Iterator_free(it);
+    cutil_Set_free(set);
+}
+
+/* Tests for cutil_Set_combine on BitSets */
+static cutil_Set *
+_alloc_bitset_with_stride(unsigned num, unsigned stride)
+{
+    cutil_Set *const set = cutil_BitSet_alloc(CUTIL_GENERIC_TYPE_UINT);
+    for (unsigned i = 0U; i < num; ++i) {
+        const unsigned elem = i * stride;
+        cutil_Set_add(set, &elem);
+    }
+    return set;
+}
+
+static void
+_should_matchHashSetResult_when_setsCombined(void)
+{
+    /* Arrange */
+    cutil_Set *const operands[] = {
+      _alloc_bitset_with_stride(300U, 2U),
+      _alloc_bitset_with_stride(100U, 3U),
+      _alloc_bitset_with_stride(5U, 7U),
+      cutil_BitSet_alloc(CUTIL_GENERIC_TYPE_UINT),
+    };
+    const size_t NUM_OPERANDS = CUTIL_GET_NATIVE_ARRAY_SIZE(operands);
+    const cutil_SetOp ops[] = {
+      CUTIL_SET_OP_UNION, CUTIL_SET_OP_INTERSECTION, CUTIL_SET_OP_DIFFERENCE,
+      CUTIL_SET_OP_SYMDIFF
+    };
+
+    for (size_t l = 0; l < NUM_OPERANDS; ++l) {
+        for (size_t r = 0; r < NUM_OPERANDS; ++r) {
+            for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(ops); ++i) {
+                cutil_Set *const lhs = operands[l];
+                cutil_Set *const rhs = operands[r];
+                cutil_Set *const expected
+                  = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_UINT);
+                cutil_Set_union(expected, lhs);
+                cutil_Set_combine(expected, rhs, ops[i]);
+
+                /* Act */
+                cutil_Set *const res = cutil_Set_combine_new(lhs, rhs, ops[i]);
+
+                /* Assert */
+                TEST_ASSERT_NOT_NULL(res);
+                TEST_ASSERT_EQUAL_PTR(CUTIL_SET_TYPE_BITSET, res->vtable);
+                TEST_ASSERT_EQUAL_size_t(
+                  cutil_Set_get_count(expected), cutil_Set_get_count(res)
+                );
+                for (unsigned elem = 0U; elem < 700U; ++elem) {
+                    TEST_ASSERT_EQUAL(
+                      cutil_Set_contains(expected, &elem),
+                      cutil_Set_contains(res, &elem)
+                    );
+                }
+
+                /* Cleanup */
+                cutil_Set_free(res);
+                cutil_Set_free(expected);
+            }
+        }
+    }
+
+    /* Cleanup */
+    for (size_t i = 0; i < NUM_OPERANDS; ++i) {
+        cutil_Set_free(operands[i]);
+    }
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_allocateBitSet_when_elemTypeIsUnsigned);
+    RUN_TEST(_should_returnNull_when_elemTypeIsNotUnsigned);
+    RUN_TEST(_should_reserveAndShrink_when_allocatedWithBound);
+    RUN_TEST(_should_rejectElements_when_notBelowBound);
+    RUN_TEST(_should_trackMembership_when_elementsSpanWords);
+    RUN_TEST(_should_reportInsertion_when_insertedIfAbsent);
+
+    /* Iterator tests */
+    RUN_TEST(_should_iterateInAscendingOrder_when_elementsSpanWords);
+    RUN_TEST(_should_removeCurrentElement_when_removeCalledOnIterator);
+
+    /* Set algebra tests */
+    RUN_TEST(_should_matchHashSetResult_when_setsCombined);
+
+    return UNITY_END();
+}
@@ -0,0 +1,242 @@
+#include "unity.h"
+#include <cutil/data/generic/set/flatset.h>
+
+#include <cutil/data/generic/array.h>
+#include <cutil/data/generic/set/hashset.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/status.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/util/macro.h>
+
+static cutil_Set *
+_alloc_flat_with_stride(int first, int num, int stride)
+{
+    cutil_Set *const set = cutil_FlatSet_alloc(CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < num; ++i) {
+        const int elem = first + i * stride;
+        cutil_Set_add(set, &elem);
+    }
+    return set;
+}
+
+/**
+ * Asserts that `set` holds exactly the elements of `expected` and iterates
+ * them in ascending order.
+ */
+static void
+_assert_same_elems(const cutil_Set *expected, const cutil_Set *set)
+{
+    TEST_ASSERT_EQUAL_size_t(
+      cutil_Set_get_count(expected), cutil_Set_get_count(set)
+    );
+    cutil_ConstIterator *const it = cutil_Set_get_const_iterator(set);
+    cutil_Bool first = CUTIL_TRUE;
+    int prev = 0;
+    while (cutil_ConstIterator_next(it)) {
+        const int elem = *(const int *) cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_TRUE(cutil_Set_contains(expected, &elem));
+        if (!first) {
+            TEST_ASSERT_LESS_THAN_INT(elem, prev);
+        }
+        first = CUTIL_FALSE;
+        prev = elem;
+    }
+    cutil_ConstIterator_free(it);
+}
+
+/* Tests for cutil_FlatSet_alloc */
+static void
+_should_allocateEmptySet_when_allocCalled(void)
+{
+    /* Act */
+    cutil_Set *const set = cutil_FlatSet_alloc(CUTIL_GENERIC_TYPE_INT);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(set);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_SET_TYPE_FLATSET, set->vtable);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_GENERIC_TYPE_INT, cutil_Set_get_elem_type(set));
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Set_get_count(set));
+    TEST_ASSERT_NULL(cutil_FlatSet_alloc(NULL));
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+/* Tests for membership */
+static void
+_should_trackMembership_when_elementsAddedAndRemoved(void)
+{
+    /* Arrange */
+    cutil_Set *const set = _alloc_flat_with_stride(999, 1000, -1);
+    cutil_Set *const expected = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 5 != 0) {
+            cutil_Set_add(expected, &i);
+        }
+    }
+
+    /* Act */
+    for (int i = 0; i < 1000; i += 5) {
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Set_remove(set, &i));
+    }
+    const int missing = 0;
+    cutil_Bool inserted = CUTIL_TRUE;
+    const int present = 1;
+    cutil_Set_insert_if_absent(set, &present, &inserted);
+
+    /* Assert */
+    TEST_ASSERT_FALSE(inserted);
+    TEST_ASSERT_FALSE(cutil_Set_contains(set, &missing));
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_FAILURE, cutil_Set_remove(set, &missing)
+    );
+    _assert_same_elems(expected, set);
+
+    /* Cleanup */
+    cutil_Set_free(expected);
+    cutil_Set_free(set);
+}
+
+/* Tests for bulk loading */
+static void
+_should_ignoreDuplicates_when_elementsAddedInBulk(void)
+{
+    /* Arrange */
+    cutil_Set *const set = _alloc_flat_with_stride(0, 100, 4);
+    cutil_Set *const expected = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
+    int elems[600];
+    for (int i = 0; i < 600; ++i) {
+        elems[i] = (i * 37) % 300;
+    }
+    for (int i = 0; i < 300; ++i) {
+        cutil_Set_add(expected, &i);
+    }
+    for (int i = 300; i < 400; i += 4) {
+        cutil_Set_add(expected, &i);
+    }
+
+    /* Act */
+    const cutil_Status status = cutil_FlatSet_add_mult(set, elems, 600UL);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    _assert_same_elems(expected, set);
+
+    /* Cleanup */
+    cutil_Set_free(expected);
+    cutil_Set_free(set);
+}
+
+static void
+_should_holdUniqueElements_when_constructedFromArray(void)
+{
+    /* Arrange */
+    const int values[] = {9, 3, 7, 3, 1, 9, 5};
+    cutil_Array *const elems = cutil_Array_alloc(
+      CUTIL_GENERIC_TYPE_INT, CUTIL_GET_NATIVE_ARRAY_SIZE(values)
+    );
+    for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(values); ++i) {
+        cutil_Array_set(elems, i, &values[i]);
+    }
+
+    /* Act */
+    cutil_Set *const set = cutil_FlatSet_from_array(elems);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(set);
+    TEST_ASSERT_EQUAL_size_t(5UL, cutil_Set_get_count(set));
+    cutil_ConstIterator *const it = cutil_Set_get_const_iterator(set);
+    for (int expected = 1; expected < 10; expected += 2) {
+        TEST_ASSERT_TRUE(cutil_ConstIterator_next(it));
+        TEST_ASSERT_EQUAL_INT(
+          expected, *(const int *) cutil_ConstIterator_get_ptr(it)
+        );
+    }
+    TEST_ASSERT_FALSE(cutil_ConstIterator_next(it));
+    cutil_ConstIterator_free(it);
+
+    /* Cleanup */
+    cutil_Set_free(set);
+    cutil_Array_free(elems);
+}
+
+/* Tests for cutil_Set_combine on flat sets */
+static void
+_should_matchHashSetResult_when_setsCombined(void)
+{
+    /* Arrange */
+    cutil_Set *const operands[] = {
+      _alloc_flat_with_stride(0, 2000, 2),
+      _alloc_flat_with_stride(1000, 1000, 3),
+      _alloc_flat_with_stride(3999, 500, -1),
+      _alloc_flat_with_stride(-50, 40, 100),
+      cutil_FlatSet_alloc(CUTIL_GENERIC_TYPE_INT),
+    };
+    const size_t NUM_OPERANDS = CUTIL_GET_NATIVE_ARRAY_SIZE(operands);
+    const cutil_SetOp ops[] = {
+      CUTIL_SET_OP_UNION, CUTIL_SET_OP_INTERSECTION, CUTIL_SET_OP_DIFFERENCE,
+      CUTIL_SET_OP_SYMDIFF
+    };
+
+    for (size_t l = 0; l < NUM_OPERANDS; ++l) {
+        for (size_t r = 0; r < NUM_OPERANDS; ++r) {
+            for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(ops); ++i) {
+                cutil_Set *const lhs = operands[l];
+                cutil_Set *const rhs = operands[r];
+                cutil_Set *const expected
+                  = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
+                cutil_Set_union(expected, lhs);
+                cutil_Set_combine(expected, rhs, ops[i]);
+                cutil_Set *const in_place = cutil_Set_duplicate(lhs);
+
+                /* Act */
+                cutil_Set *const res = cutil_Set_combine_new(lhs, rhs, ops[i]);
+                const cutil_Status status
+                  = cutil_Set_combine(in_place, rhs, ops[i]);
+
+                /* Assert */
+                TEST_ASSERT_NOT_NULL(res);
+                TEST_ASSERT_EQUAL_PTR(CUTIL_SET_TYPE_FLATSET, res->vtable);
+                TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+                _assert_same_elems(expected, res);
+                _assert_same_elems(expected, in_place);
+
+                /* Cleanup */
+                cutil_Set_free(in_place);
+                cutil_Set_free(res);
+                cutil_Set_free(expected);
+            }
+        }
+    }
+
+    /* Cleanup */
+    for (size_t i = 0; i < NUM_OPERANDS; ++i) {
+        cutil_Set_free(operands[i]);
+    }
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_allocateEmptySet_when_allocCalled);
+    RUN_TEST(_should_trackMembership_when_elementsAddedAndRemoved);
+
+    /* Bulk loading tests */
+    RUN_TEST(_should_ignoreDuplicates_when_elementsAddedInBulk);
+    RUN_TEST(_should_holdUniqueElements_when_constructedFromArray);
+
+    /* Set algebra tests */
+    RUN_TEST(_should_matchHashSetResult_when_setsCombined);
+
+    return UNITY_END();
+}
@@ -1,8 +1,12 @@
 #include "unity.h"
 #include <cutil/data/generic/set/hashset.h>
 
+#include <cutil/data/generic/array.h>
+#include <cutil/data/generic/list/arraylist.h>
 #include <cutil/data/generic/type.h>
+#include <cutil/std/stdio.h>
 #include <cutil/std/stdlib.h>
+#include <cutil/string/type.h>
 #include <cutil/util/macro.h>
 
 /* Tests for cutil_HashSet_alloc */
@@ -50,6 +54,122 @@ _should_allocateHashSet_withVariousElemTypes(void)
     }
 }
 
+static void
+_should_reserveAndShrink_when_allocatedWithCapacity(void)
+{
+    /* Arrange */
+    cutil_Set *const set
+      = cutil_HashSet_alloc_with_capacity(CUTIL_GENERIC_TYPE_INT, 100UL, 0.75);
+    TEST_ASSERT_NOT_NULL(set);
+    const size_t capacity = cutil_HashSet_get_capacity(set);
+    for (int i = 0; i < 100; ++i) {
+        cutil_Set_add(set, &i);
+    }
+
+    /* Act & Assert */
+    TEST_ASSERT_EQUAL_size_t(capacity, cutil_HashSet_get_capacity(set));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Set_reserve(set, 1000UL));
+    TEST_ASSERT_TRUE(cutil_HashSet_get_capacity(set) > capacity);
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Set_shrink_to_fit(set));
+    TEST_ASSERT_EQUAL_size_t(capacity, cutil_HashSet_get_capacity(set));
+    TEST_ASSERT_EQUAL_size_t((size_t) 100, cutil_Set_get_count(set));
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+static void
+_should_reportMembership_when_checkedInBatch(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
+    int elems[200];
+    cutil_Bool res[200];
+    for (int i = 0; i < 200; ++i) {
+        elems[i] = i;
+        if (i % 3 == 0) {
+            cutil_Set_add(set, &i);
+        }
+    }
+
+    /* Act */
+    const cutil_Status status
+      = cutil_Set_contains_batch(set, elems, (size_t) 200, res);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    for (int i = 0; i < 200; ++i) {
+        TEST_ASSERT_EQUAL(i % 3 == 0, res[i]);
+    }
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+static void
+_should_reportInsertion_when_insertedIfAbsent(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
+    int num_inserted = 0;
+
+    /* Act */
+    for (int i = 0; i < 300; ++i) {
+        const int elem = i % 50;
+        cutil_Bool inserted = false;
+        const cutil_Status status
+          = cutil_Set_insert_if_absent(set, &elem, &inserted);
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+        TEST_ASSERT_EQUAL(i < 50, inserted);
+        num_inserted += inserted;
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(50, num_inserted);
+    TEST_ASSERT_EQUAL_size_t((size_t) 50, cutil_Set_get_count(set));
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+/* Tests for cutil_Set_hash */
+static void
+_should_matchElementHash_when_modifiedAfterHashing(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
+    cutil_Set *const other = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
+    cutil_hash_t expected = CUTIL_HASH_C(0);
+    TEST_ASSERT_EQUAL_UINT64(expected, cutil_Set_hash(set));
+
+    /* Act & Assert */
+    for (int i = 0; i < 201; ++i) {
+        cutil_Set_add(set, &i);
+        cutil_Set_add(other, &i);
+        expected ^= cutil_GenericType_apply_hash(CUTIL_GENERIC_TYPE_INT, &i);
+        TEST_ASSERT_EQUAL_UINT64(expected, cutil_Set_hash(set));
+    }
+    for (int i = 0; i < 201; i += 2) {
+        cutil_Set_remove(set, &i);
+        expected ^= cutil_GenericType_apply_hash(CUTIL_GENERIC_TYPE_INT, &i);
+    }
+    TEST_ASSERT_EQUAL_UINT64(expected, cutil_Set_hash(set));
+    TEST_ASSERT_FALSE(cutil_Set_deep_equals(set, other));
+    for (int i = 1; i < 201; i += 2) {
+        cutil_Set_remove(other, &i);
+    }
+    const int elem = 0;
+    cutil_Set_remove(other, &elem);
+    TEST_ASSERT_EQUAL_size_t(
+      cutil_Set_get_count(set), cutil_Set_get_count(other)
+    );
+    TEST_ASSERT_FALSE(cutil_Set_deep_equals(set, other));
+
+    /* Cleanup */
+    cutil_Set_free(set);
+    cutil_Set_free(other);
+}
+
 /* Tests for vtable pointer identity */
 static void
 _should_haveCorrectVtablePointer_when_created(void)
@@ -610,6 +730,53 @@ _should_haveCorrectElemType_for_multipleDescriptorVariants(void)
     }
 }
 
+/* Tests for cutil_HashSet_from_list */
+static void
+_should_containEachElementOnce_when_constructedFromList(void)
+{
+    /* Arrange */
+    cutil_List *const list = cutil_ArrayList_alloc(CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < 1000; ++i) {
+        const int elem = i % 250;
+        cutil_List_append(list, &elem);
+    }
+
+    /* Act */
+    cutil_Set *const set = cutil_HashSet_from_list(list);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(set);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_GENERIC_TYPE_INT, cutil_Set_get_elem_type(set));
+    TEST_ASSERT_EQUAL_size_t(250UL, cutil_Set_get_count(set));
+    for (int elem = -10; elem < 260; ++elem) {
+        TEST_ASSERT_EQUAL(
+          elem >= 0 && elem < 250, cutil_Set_contains(set, &elem)
+        );
+    }
+
+    /* Cleanup */
+    cutil_Set_free(set);
+    cutil_List_free(list);
+}
+
+static void
+_should_beEmpty_when_constructedFromEmptyList(void)
+{
+    /* Arrange */
+    cutil_List *const list = cutil_ArrayList_alloc(CUTIL_GENERIC_TYPE_DOUBLE);
+
+    /* Act */
+    cutil_Set *const set = cutil_HashSet_from_list(list);
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(set);
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Set_get_count(set));
+
+    /* Cleanup */
+    cutil_Set_free(set);
+    cutil_List_free(list);
+}
+
 void
 setUp(void)
 {}
@@ -618,6 +785,286 @@ void
 tearDown(void)
 {}
 
+/* Tests for cutil_HashSet_get_stats */
+static void
+_should_countElements_when_statsRequested(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < 100; ++i) {
+        cutil_Set_add(set, &i);
+    }
+    cutil_HashMapStats stats;
+
+    /* Act */
+    const cutil_Status status = cutil_HashSet_get_stats(set, &stats);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_size_t(cutil_HashSet_get_capacity(set), stats.capacity);
+    TEST_ASSERT_EQUAL_size_t(100UL, stats.num_entries);
+    TEST_ASSERT_GREATER_OR_EQUAL_size_t(1UL, stats.max_probe_length);
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+/* Tests for cutil_HashSet_add_mult */
+static void
+_should_insertMissingElements_when_addedInBulk(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_STRING);
+    cutil_Set *const expected = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_STRING);
+    cutil_Array *const elems
+      = cutil_Array_alloc(CUTIL_GENERIC_TYPE_STRING, 300UL);
+    char buf[32];
+    for (size_t i = 0; i < 300UL; ++i) {
+        (void) snprintf(buf, sizeof buf, "elem%zu", i % 100UL);
+        cutil_String *const str = cutil_String_from_string(buf);
+        cutil_Array_set(elems, i, str);
+        if (i < 100UL) {
+            cutil_Set_add(expected, str);
+        }
+        cutil_String_free(str);
+    }
+    const cutil_String *const first = cutil_Array_get_ptr(elems, 0UL);
+    cutil_Set_add(set, first);
+
+    /* Act */
+    const cutil_Status status
+      = cutil_HashSet_add_mult(set, cutil_Array_get_ptr(elems, 0UL), 300UL);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_size_t(100UL, cutil_Set_get_count(set));
+    TEST_ASSERT_TRUE(cutil_Set_deep_equals(set, expected));
+    TEST_ASSERT_EQUAL_UINT64(cutil_Set_hash(expected), cutil_Set_hash(set));
+
+    /* Cleanup */
+    cutil_Array_free(elems);
+    cutil_Set_free(expected);
+    cutil_Set_free(set);
+}
+
+/* Tests for cutil_Set_combine on HashSets */
+static cutil_Bool
+_is_in_combination(cutil_SetOp op, cutil_Bool in_lhs, cutil_Bool in_rhs)
+{
+    switch (op) {
+    case CUTIL_SET_OP_UNION:
+        return in_lhs || in_rhs;
+    case CUTIL_SET_OP_INTERSECTION:
+        return in_lhs && in_rhs;
+    case CUTIL_SET_OP_DIFFERENCE:
+        return in_lhs && !in_rhs;
+    default:
+        return in_lhs != in_rhs;
+    }
+}
+
+static cutil_Set *
+_alloc_int_set_with_stride(int num, int stride)
+{
+    cutil_Set *const set = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
+    for (int i = 0; i < num; ++i) {
+        const int elem = i * stride;
+        cutil_Set_add(set, &elem);
+    }
+    return set;
+}
+
+static void
+_assert_combines_elementwise(
+  const cutil_Set *lhs, const cutil_Set *rhs, int max_elem
+)
+{
+    const cutil_SetOp ops[] = {
+      CUTIL_SET_OP_UNION, CUTIL_SET_OP_INTERSECTION, CUTIL_SET_OP_DIFFERENCE,
+      CUTIL_SET_OP_SYMDIFF
+    };
+    for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(ops); ++i) {
+        cutil_Set *const expected = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
+        for (int elem = 0; elem <= max_elem; ++elem) {
+            if (_is_in_combination(
+                  ops[i], cutil_Set_contains(lhs, &elem),
+                  cutil_Set_contains(rhs, &elem)
+                )) {
+                cutil_Set_add(expected, &elem);
+            }
+        }
+        cutil_Set *const dst = cutil_Set_duplicate(lhs);
+        /* Maintain the content hash across the combination */
+        (void) cutil_Set_hash(dst);
+
+        cutil_Set *const res = cutil_Set_combine_new(lhs, rhs, ops[i]);
+        const cutil_Status status = cutil_Set_combine(dst, rhs, ops[i]);
+
+        TEST_ASSERT_NOT_NULL(res);
+        TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+        TEST_ASSERT_TRUE(cutil_Set_deep_equals(res, expected));
+        TEST_ASSERT_TRUE(cutil_Set_deep_equals(dst, expected));
+        TEST_ASSERT_EQUAL_UINT64(cutil_Set_hash(expected), cutil_Set_hash(res));
+        TEST_ASSERT_EQUAL_UINT64(cutil_Set_hash(expected), cutil_Set_hash(dst));
+
+        cutil_Set_free(res);
+        cutil_Set_free(dst);
+        cutil_Set_free(expected);
+    }
+}
+
+static void
+_should_matchElementwiseResult_when_setsCombined(void)
+{
+    /* Arrange */
+    cutil_Set *const evens = _alloc_int_set_with_stride(300, 2);
+    cutil_Set *const triples = _alloc_int_set_with_stride(100, 3);
+    cutil_Set *const few = _alloc_int_set_with_stride(6, 5);
+    cutil_Set *const empty = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
+
+    /* Act / Assert */
+    _assert_combines_elementwise(evens, triples, 600);
+    _assert_combines_elementwise(triples, evens, 600);
+    _assert_combines_elementwise(few, triples, 600);
+    _assert_combines_elementwise(evens, few, 600);
+    _assert_combines_elementwise(few, empty, 600);
+    _assert_combines_elementwise(empty, evens, 600);
+
+    /* Cleanup */
+    cutil_Set_free(empty);
+    cutil_Set_free(few);
+    cutil_Set_free(triples);
+    cutil_Set_free(evens);
+}
+
+static void
+_should_findCombinedStrings_when_operandsAreSeededDifferently(void)
+{
+    /* Arrange */
+    cutil_Set *const lhs = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_STRING);
+    cutil_Set *const rhs = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_STRING);
+    cutil_String *strs[200];
+    char buf[32];
+    for (size_t i = 0; i < 200UL; ++i) {
+        (void) snprintf(buf, sizeof buf, "perm%zu", i);
+        strs[i] = cutil_String_from_string(buf);
+        if (i < 150UL) {
+            cutil_Set_add(lhs, strs[i]);
+        }
+        if (i >= 100UL) {
+            cutil_Set_add(rhs, strs[i]);
+        }
+    }
+
+    /* Act */
+    cutil_Set *const both = cutil_Set_intersect_new(lhs, rhs);
+    const cutil_Status status = cutil_Set_union(lhs, rhs);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_size_t(50UL, cutil_Set_get_count(both));
+    TEST_ASSERT_EQUAL_size_t(200UL, cutil_Set_get_count(lhs));
+    for (size_t i = 0; i < 200UL; ++i) {
+        TEST_ASSERT_EQUAL(
+          i >= 100UL && i < 150UL, cutil_Set_contains(both, strs[i])
+        );
+        TEST_ASSERT_TRUE(cutil_Set_contains(lhs, strs[i]));
+    }
+
+    /* Cleanup */
+    for (size_t i = 0; i < 200UL; ++i) {
+        cutil_String_free(strs[i]);
+    }
+    cutil_Set_free(both);
+    cutil_Set_free(rhs);
+    cutil_Set_free(lhs);
+}
+
+static void
+_should_shrinkTable_when_intersectedWithSmallerSet(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_STRING);
+    cutil_Set *const few = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_STRING);
+    char buf[32];
+    for (int i = 0; i < 2000; ++i) {
+        (void) snprintf(buf, sizeof buf, "elem%d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        cutil_Set_add(set, str);
+        if (i % 400 == 0) {
+            cutil_Set_add(few, str);
+        }
+        cutil_String_free(str);
+    }
+    cutil_String *const absent = cutil_String_from_string("absent");
+    cutil_Set_add(few, absent);
+    const size_t old_capacity = cutil_HashSet_get_capacity(set);
+
+    /* Act */
+    const cutil_Status status = cutil_Set_intersect(set, few);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_size_t(5UL, cutil_Set_get_count(set));
+    TEST_ASSERT_LESS_THAN_size_t(
+      old_capacity, cutil_HashSet_get_capacity(set)
+    );
+    TEST_ASSERT_FALSE(cutil_Set_contains(set, absent));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Set_add(set, absent));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, cutil_Set_remove(set, absent));
+    for (int i = 0; i < 2000; i += 400) {
+        (void) snprintf(buf, sizeof buf, "elem%d", i);
+        cutil_String *const str = cutil_String_from_string(buf);
+        TEST_ASSERT_TRUE(cutil_Set_contains(set, str));
+        cutil_String_free(str);
+    }
+
+    /* Cleanup */
+    cutil_String_free(absent);
+    cutil_Set_free(few);
+    cutil_Set_free(set);
+}
+
+static void
+_should_emptySet_when_differenceWithItself(void)
+{
+    /* Arrange */
+    cutil_Set *const set = _alloc_int_set_with_stride(50, 1);
+
+    /* Act */
+    const cutil_Status union_status = cutil_Set_union(set, set);
+    const size_t union_count = cutil_Set_get_count(set);
+    const cutil_Status diff_status = cutil_Set_difference(set, set);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, union_status);
+    TEST_ASSERT_EQUAL_size_t(50UL, union_count);
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, diff_status);
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Set_get_count(set));
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+static void
+_should_returnFailure_when_combiningDifferentElemTypes(void)
+{
+    /* Arrange */
+    cutil_Set *const ints = _alloc_int_set_with_stride(10, 1);
+    cutil_Set *const doubles = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_DOUBLE);
+
+    /* Act / Assert */
+    TEST_ASSERT_EQUAL_INT(
+      CUTIL_STATUS_FAILURE, cutil_Set_intersect(ints, doubles)
+    );
+    TEST_ASSERT_NULL(cutil_Set_union_new(ints, doubles));
+    TEST_ASSERT_EQUAL_size_t(10UL, cutil_Set_get_count(ints));
+
+    /* Cleanup */
+    cutil_Set_free(doubles);
+    cutil_Set_free(ints);
+}
+
 int
 main(void)
 {
@@ -625,10 +1072,23 @@ main(void)
 
     RUN_TEST(_should_allocateHashSet_when_createdWithValidElemType);
     RUN_TEST(_should_allocateHashSet_withVariousElemTypes);
+    RUN_TEST(_should_reserveAndShrink_when_allocatedWithCapacity);
+    RUN_TEST(_should_reportMembership_when_checkedInBatch);
+    RUN_TEST(_should_reportInsertion_when_insertedIfAbsent);
+    RUN_TEST(_should_matchElementHash_when_modifiedAfterHashing);
     RUN_TEST(_should_haveCorrectVtablePointer_when_created);
     RUN_TEST(_should_returnElemType_when_queried);
     RUN_TEST(_should_returnElemType_forVariousTypes);
     RUN_TEST(_should_preserveElemType_whenCreatedWithDifferentTypes);
+    RUN_TEST(_should_containEachElementOnce_when_constructedFromList);
+    RUN_TEST(_should_beEmpty_when_constructedFromEmptyList);
+    RUN_TEST(_should_countElements_when_statsRequested);
+    RUN_TEST(_should_insertMissingElements_when_addedInBulk);
+    RUN_TEST(_should_matchElementwiseResult_when_setsCombined);
+    RUN_TEST(_should_findCombinedStrings_when_operandsAreSeededDifferently);
+    RUN_TEST(_should_shrinkTable_when_intersectedWithSmallerSet);
+    RUN_TEST(_should_emptySet_when_differenceWithItself);
+    RUN_TEST(_should_returnFailure_when_combiningDifferentElemTypes);
 
     /* Iterator tests */
     RUN_TEST(_should_returnNonNull_when_getConstIteratorCalledOnHashSet);
@@ -0,0 +1,416 @@
+#include "unity.h"
+#include <cutil/data/generic/set/roaringset.h>
+
+#include <cutil/data/generic/set/hashset.h>
+#include <cutil/data/generic/type.h>
+#include <cutil/status.h>
+#include <cutil/std/inttypes.h>
+#include <cutil/std/stdlib.h>
+#include <cutil/util/macro.h>
+
+static cutil_Set *
+_alloc_roaring_with_stride(uint32_t first, uint32_t num, uint32_t stride)
+{
+    cutil_Set *const set = cutil_RoaringSet_alloc();
+    for (uint32_t i = 0U; i < num; ++i) {
+        const uint32_t elem = first + i * stride;
+        cutil_Set_add(set, &elem);
+    }
+    return set;
+}
+
+/**
+ * Asserts that `set` holds exactly the elements of `expected`.
+ */
+static void
+_assert_same_elems(const cutil_Set *expected, const cutil_Set *set)
+{
+    TEST_ASSERT_EQUAL_size_t(
+      cutil_Set_get_count(expected), cutil_Set_get_count(set)
+    );
+    cutil_ConstIterator *const it = cutil_Set_get_const_iterator(expected);
+    while (cutil_ConstIterator_next(it)) {
+        const void *const elem = cutil_ConstIterator_get_ptr(it);
+        TEST_ASSERT_TRUE(cutil_Set_contains(set, elem));
+    }
+    cutil_ConstIterator_free(it);
+}
+
+/* Tests for cutil_RoaringSet_alloc */
+static void
+_should_allocateEmptySet_when_allocCalled(void)
+{
+    /* Act */
+    cutil_Set *const set = cutil_RoaringSet_alloc();
+
+    /* Assert */
+    TEST_ASSERT_NOT_NULL(set);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_SET_TYPE_ROARING, set->vtable);
+    TEST_ASSERT_EQUAL_PTR(CUTIL_GENERIC_TYPE_U32, cutil_Set_get_elem_type(set));
+    TEST_ASSERT_EQUAL_size_t(0UL, cutil_Set_get_count(set));
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+/* Tests for membership */
+static void
+_should_trackMembership_when_elementsSpanChunks(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_RoaringSet_alloc();
+    const uint32_t elems[] = {
+      0U, 1U, 65535U, 65536U, 65537U, 1000000U, UINT32_MAX - 1U, UINT32_MAX,
+    };
+    const size_t N = CUTIL_GET_NATIVE_ARRAY_SIZE(elems);
+
+    /* Act */
+    for (size_t i = 0; i < N; ++i) {
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_Set_add(set, &elems[i])
+        );
+    }
+    const uint32_t removed = 1000000U;
+    const cutil_Status remove_status = cutil_Set_remove(set, &removed);
+    const cutil_Status missing_status = cutil_Set_remove(set, &removed);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, remove_status);
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, missing_status);
+    TEST_ASSERT_EQUAL_size_t(N - 1UL, cutil_Set_get_count(set));
+    for (size_t i = 0; i < N; ++i) {
+        TEST_ASSERT_EQUAL(
+          elems[i] != removed, cutil_Set_contains(set, &elems[i])
+        );
+    }
+    const uint32_t missing[] = {2U, 65534U, 131072U, UINT32_MAX - 2U};
+    for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(missing); ++i) {
+        TEST_ASSERT_FALSE(cutil_Set_contains(set, &missing[i]));
+    }
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+static void
+_should_keepMembership_when_containerGrowsAndShrinksPastArrayLimit(void)
+{
+    /* Arrange */
+    cutil_Set *const set = _alloc_roaring_with_stride(70000U, 6000U, 2U);
+
+    /* Act */
+    for (uint32_t elem = 70000U; elem < 74000U; elem += 2U) {
+        cutil_Set_remove(set, &elem);
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(4000UL, cutil_Set_get_count(set));
+    for (uint32_t elem = 69990U; elem < 82010U; ++elem) {
+        const cutil_Bool expected
+          = elem >= 74000U && elem < 82000U && elem % 2U == 0U;
+        TEST_ASSERT_EQUAL(expected, cutil_Set_contains(set, &elem));
+    }
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+static void
+_should_keepMembership_when_runsOptimizedAndModified(void)
+{
+    /* Arrange */
+    cutil_Set *const set = _alloc_roaring_with_stride(100U, 100000U, 1U);
+    const uint32_t split = 50000U;
+    const uint32_t joined = 100100U;
+
+    /* Act */
+    const cutil_Status status = cutil_RoaringSet_run_optimize(set);
+    cutil_Set_remove(set, &split);
+    cutil_Set_add(set, &joined);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_size_t(100000UL, cutil_Set_get_count(set));
+    for (uint32_t elem = 0U; elem < 100200U; ++elem) {
+        const cutil_Bool expected
+          = elem >= 100U && elem <= joined && elem != split;
+        TEST_ASSERT_EQUAL(expected, cutil_Set_contains(set, &elem));
+    }
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+/* Tests for iterators */
+static void
+_should_iterateInAscendingOrder_when_containersOfAllKinds(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_RoaringSet_alloc();
+    cutil_Set *const expected = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_U32);
+    for (uint32_t i = 0U; i < 5000U; ++i) {
+        const uint32_t elems[] = {
+          UINT32_MAX - i * 7U, 200000U + i * 3U, 300000U + i, i * 13U,
+        };
+        for (size_t j = 0; j < CUTIL_GET_NATIVE_ARRAY_SIZE(elems); ++j) {
+            cutil_Set_insert_if_absent(set, &elems[j], NULL);
+            cutil_Set_insert_if_absent(expected, &elems[j], NULL);
+        }
+    }
+    cutil_RoaringSet_run_optimize(set);
+    cutil_ConstIterator *const it = cutil_Set_get_const_iterator(set);
+
+    /* Act */
+    size_t count = 0UL;
+    uint64_t prev = 0U;
+    while (cutil_ConstIterator_next(it)) {
+        uint32_t elem = 0U;
+        TEST_ASSERT_EQUAL_INT(
+          CUTIL_STATUS_SUCCESS, cutil_ConstIterator_get(it, &elem)
+        );
+        TEST_ASSERT_TRUE(count == 0UL || elem > prev);
+        TEST_ASSERT_TRUE(cutil_Set_contains(expected, &elem));
+        prev = elem;
+        ++count;
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(cutil_Set_get_count(expected), count);
+    TEST_ASSERT_FALSE(cutil_ConstIterator_next(it));
+    TEST_ASSERT_NULL(cutil_ConstIterator_get_ptr(it));
+
+    /* Cleanup */
+    cutil_ConstIterator_free(it);
+    cutil_Set_free(expected);
+    cutil_Set_free(set);
+}
+
+static void
+_should_removeCurrentElement_when_removeCalledOnIterator(void)
+{
+    /* Arrange */
+    cutil_Set *const set = _alloc_roaring_with_stride(60000U, 15000U, 1U);
+    cutil_Iterator *const it = cutil_Set_get_iterator(set);
+
+    /* Act */
+    size_t visited = 0UL;
+    while (cutil_Iterator_next(it)) {
+        const uint32_t *const p = cutil_Iterator_get_ptr(it);
+        ++visited;
+        if (*p % 3U != 0U) {
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_SUCCESS, cutil_Iterator_remove(it)
+            );
+            TEST_ASSERT_EQUAL_INT(
+              CUTIL_STATUS_FAILURE, cutil_Iterator_remove(it)
+            );
+        }
+    }
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(15000UL, visited);
+    TEST_ASSERT_EQUAL_size_t(5000UL, cutil_Set_get_count(set));
+    for (uint32_t elem = 60000U; elem < 75000U; ++elem) {
+        TEST_ASSERT_EQUAL(elem % 3U == 0U, cutil_Set_contains(set, &elem));
+    }
+
+    /* Cleanup */
+    cutil_Iterator_free(it);
+    cutil_Set_free(set);
+}
+
+/* Tests for cutil_Set_combine on Roaring bitmaps */
+static void
+_should_matchHashSetResult_when_setsCombined(void)
+{
+    /* Arrange */
+    cutil_Set *const operands[] = {
+      _alloc_roaring_with_stride(0U, 20000U, 2U),
+      _alloc_roaring_with_stride(30000U, 30000U, 3U),
+      _alloc_roaring_with_stride(10000U, 50000U, 1U),
+      _alloc_roaring_with_stride(65000U, 3000U, 5U),
+      _alloc_roaring_with_stride(7U, 40U, 1000U),
+      _alloc_roaring_with_stride(65536U, 4000U, 1U),
+      _alloc_roaring_with_stride(65540U, 50U, 40U),
+      cutil_RoaringSet_alloc(),
+    };
+    const size_t NUM_OPERANDS = CUTIL_GET_NATIVE_ARRAY_SIZE(operands);
+    cutil_RoaringSet_run_optimize(operands[2]);
+    const cutil_SetOp ops[] = {
+      CUTIL_SET_OP_UNION, CUTIL_SET_OP_INTERSECTION, CUTIL_SET_OP_DIFFERENCE,
+      CUTIL_SET_OP_SYMDIFF
+    };
+
+    for (size_t l = 0; l < NUM_OPERANDS; ++l) {
+        for (size_t r = 0; r < NUM_OPERANDS; ++r) {
+            for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(ops); ++i) {
+                cutil_Set *const lhs = operands[l];
+                cutil_Set *const rhs = operands[r];
+                cutil_Set *const expected
+                  = cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_U32);
+                cutil_Set_union(expected, lhs);
+                cutil_Set_combine(expected, rhs, ops[i]);
+                cutil_Set *const in_place = cutil_Set_duplicate(lhs);
+
+                /* Act */
+                cutil_Set *const res = cutil_Set_combine_new(lhs, rhs, ops[i]);
+                const cutil_Status status
+                  = cutil_Set_combine(in_place, rhs, ops[i]);
+
+                /* Assert */
+                TEST_ASSERT_NOT_NULL(res);
+                TEST_ASSERT_EQUAL_PTR(CUTIL_SET_TYPE_ROARING, res->vtable);
+                TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+                _assert_same_elems(expected, res);
+                _assert_same_elems(expected, in_place);
+
+                /* Cleanup */
+                cutil_Set_free(in_place);
+                cutil_Set_free(res);
+                cutil_Set_free(expected);
+            }
+        }
+    }
+
+    /* Cleanup */
+    for (size_t i = 0; i < NUM_OPERANDS; ++i) {
+        cutil_Set_free(operands[i]);
+    }
+}
+
+/* Tests for serialization */
+static void
+_should_writePortableHeader_when_serialized(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_RoaringSet_alloc();
+    const uint32_t elems[] = {5U, 65536U + 3U};
+    for (size_t i = 0; i < CUTIL_GET_NATIVE_ARRAY_SIZE(elems); ++i) {
+        cutil_Set_add(set, &elems[i]);
+    }
+    const unsigned char expected[] = {
+      0x3A, 0x30, 0x00, 0x00, /* cookie without runs */
+      0x02, 0x00, 0x00, 0x00, /* number of containers */
+      0x00, 0x00, 0x00, 0x00, /* key 0, cardinality 1 */
+      0x01, 0x00, 0x00, 0x00, /* key 1, cardinality 1 */
+      0x18, 0x00, 0x00, 0x00, /* offset of container 0 */
+      0x1A, 0x00, 0x00, 0x00, /* offset of container 1 */
+      0x05, 0x00,             /* container 0 */
+      0x03, 0x00,             /* container 1 */
+    };
+    unsigned char buf[64] = {0};
+
+    /* Act */
+    const size_t required = cutil_RoaringSet_serialize(set, NULL, 0UL);
+    const size_t too_small
+      = cutil_RoaringSet_serialize(set, buf, sizeof expected - 1UL);
+    const size_t written = cutil_RoaringSet_serialize(set, buf, sizeof buf);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_size_t(sizeof expected, required);
+    TEST_ASSERT_EQUAL_size_t(CUTIL_ERROR_SIZE, too_small);
+    TEST_ASSERT_EQUAL_size_t(sizeof expected, written);
+    TEST_ASSERT_EQUAL_MEMORY(expected, buf, sizeof expected);
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+static void
+_should_restoreSet_when_serializedAndDeserialized(void)
+{
+    /* Arrange */
+    cutil_Set *const set = cutil_RoaringSet_alloc();
+    for (uint32_t i = 0U; i < 10000U; ++i) {
+        const uint32_t elems[] = {i * 2U, 100000U + i, UINT32_MAX - i * 9U};
+        for (size_t j = 0; j < CUTIL_GET_NATIVE_ARRAY_SIZE(elems); ++j) {
+            cutil_Set_insert_if_absent(set, &elems[j], NULL);
+        }
+    }
+
+    for (int with_runs = 0; with_runs < 2; ++with_runs) {
+        if (with_runs) {
+            cutil_RoaringSet_run_optimize(set);
+        }
+        const size_t len = cutil_RoaringSet_serialize(set, NULL, 0UL);
+        unsigned char *const buf = malloc(len);
+
+        /* Act */
+        const size_t written = cutil_RoaringSet_serialize(set, buf, len);
+        cutil_Set *const restored = cutil_RoaringSet_deserialize(buf, len);
+
+        /* Assert */
+        TEST_ASSERT_EQUAL_size_t(len, written);
+        TEST_ASSERT_NOT_NULL(restored);
+        _assert_same_elems(set, restored);
+        TEST_ASSERT_NULL(cutil_RoaringSet_deserialize(buf, len - 1UL));
+
+        /* Cleanup */
+        cutil_Set_free(restored);
+        free(buf);
+    }
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+static void
+_should_returnNull_when_deserializingMalformedInput(void)
+{
+    /* Arrange */
+    const unsigned char bad_cookie[] = {0x00, 0x00, 0x00, 0x00};
+    const unsigned char unsorted[] = {
+      0x3A, 0x30, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+      0x01, 0x00, 0x10, 0x00, 0x00, 0x00, 0x07, 0x00, 0x03, 0x00,
+    };
+    const unsigned char overlapping_runs[] = {
+      0x3B, 0x30, 0x00, 0x00, 0x01, 0x00, 0x00, 0x04, 0x00, 0x02,
+      0x00, 0x00, 0x00, 0x02, 0x00, 0x01, 0x00, 0x01, 0x00,
+    };
+
+    /* Act / Assert */
+    TEST_ASSERT_NULL(cutil_RoaringSet_deserialize(NULL, 0UL));
+    TEST_ASSERT_NULL(cutil_RoaringSet_deserialize(bad_cookie, 3UL));
+    TEST_ASSERT_NULL(
+      cutil_RoaringSet_deserialize(bad_cookie, sizeof bad_cookie)
+    );
+    TEST_ASSERT_NULL(cutil_RoaringSet_deserialize(unsorted, sizeof unsorted));
+    TEST_ASSERT_NULL(
+      cutil_RoaringSet_deserialize(overlapping_runs, sizeof overlapping_runs)
+    );
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_allocateEmptySet_when_allocCalled);
+    RUN_TEST(_should_trackMembership_when_elementsSpanChunks);
+    RUN_TEST(
+      _should_keepMembership_when_containerGrowsAndShrinksPastArrayLimit
+    );
+    RUN_TEST(_should_keepMembership_when_runsOptimizedAndModified);
+
+    /* Iterator tests */
+    RUN_TEST(_should_iterateInAscendingOrder_when_containersOfAllKinds);
+    RUN_TEST(_should_removeCurrentElement_when_removeCalledOnIterator);
+
+    /* Set algebra tests */
+    RUN_TEST(_should_matchHashSetResult_when_setsCombined);
+
+    /* Serialization tests */
+    RUN_TEST(_should_writePortableHeader_when_serialized);
+    RUN_TEST(_should_restoreSet_when_serializedAndDeserialized);
+    RUN_TEST(_should_returnNull_when_deserializingMalformedInput);
+
+    return UNITY_END();
+}
@@ -510,6 +510,28 @@ _should_returnPointer_when_keyIsFound(void)
     cutil_Map_free(map);
 }
 
+/* Tests for cutil_Map_get_ptr_batch */
+static void
+_should_fallBackToGetPtr_when_batchLookupUnsupported(void)
+{
+    /* Arrange */
+    cutil_Map *const map = _create_mock_map();
+    const int keys[] = {1, 2, 3};
+    const void *vals[] = {NULL, NULL, NULL};
+
+    /* Act */
+    const cutil_Status status = cutil_Map_get_ptr_batch(map, keys, 3UL, vals);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    for (size_t i = 0; i < 3; ++i) {
+        TEST_ASSERT_EQUAL_PTR(map->data, vals[i]);
+    }
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
 /* Tests for cutil_Map_set */
 static void
 _should_callSetFunction_when_keyValuePairIsInserted(void)
@@ -532,6 +554,45 @@ _should_callSetFunction_when_keyValuePairIsInserted(void)
     cutil_Map_free(map);
 }
 
+/* Tests for cutil_Map_reserve and cutil_Map_shrink_to_fit */
+static void
+_should_returnFailure_when_capacityManagementUnsupported(void)
+{
+    /* Arrange */
+    cutil_Map *const map = _create_mock_map();
+
+    /* Act & Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Map_reserve(map, 100UL));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Map_shrink_to_fit(map));
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
+/* Tests for cutil_Map_get_or_insert */
+static void
+_should_fallBackToContains_when_getOrInsertUnsupported(void)
+{
+    /* Arrange */
+    cutil_Map *const map = _create_mock_map();
+    MockMapData *const mock = map->data;
+    const int key = 42;
+    const int value = 100;
+    cutil_Bool inserted = true;
+
+    /* Act */
+    void *const res = cutil_Map_get_or_insert(map, &key, &value, &inserted);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_PTR(map->data, res);
+    TEST_ASSERT_FALSE(inserted);
+    TEST_ASSERT_EQUAL_INT(1, mock->contains_count);
+    TEST_ASSERT_EQUAL_INT(0, mock->set_count);
+
+    /* Cleanup */
+    cutil_Map_free(map);
+}
+
 /* Tests for cutil_Map_get_vtable */
 static void
 _should_returnVtable_when_vtableIsRequested(void)
@@ -1640,6 +1701,9 @@ main(void)
     RUN_TEST(_should_callGetFunction_when_valueIsRetrieved);
     RUN_TEST(_should_returnPointer_when_keyIsFound);
     RUN_TEST(_should_callSetFunction_when_keyValuePairIsInserted);
+    RUN_TEST(_should_returnFailure_when_capacityManagementUnsupported);
+    RUN_TEST(_should_fallBackToGetPtr_when_batchLookupUnsupported);
+    RUN_TEST(_should_fallBackToContains_when_getOrInsertUnsupported);
     RUN_TEST(_should_returnVtable_when_vtableIsRequested);
     RUN_TEST(_should_returnNull_when_vtableMapIsNull);
     RUN_TEST(_should_callGetKeyTypeFunction_when_keyTypeIsQueried);
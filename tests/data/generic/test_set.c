@@ -1,7 +1,9 @@
 #include "unity.h"
 #include <cutil/data/generic/set.h>
 
+#include <cutil/data/generic/set/bitset.h>
 #include <cutil/data/generic/set/hashset.h>
+#include <cutil/data/generic/set/roaringset.h>
 
 #include <cutil/data/generic/type.h>
 #include <cutil/std/stdlib.h>
@@ -471,6 +473,66 @@ _should_callGetElemTypeFunction_when_elemTypeIsQueried(void)
     cutil_Set_free(set);
 }
 
+static void
+_should_returnFailure_when_capacityManagementUnsupported(void)
+{
+    /* Arrange */
+    cutil_Set *const set = _create_mock_set();
+
+    /* Act & Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Set_reserve(set, 100UL));
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_FAILURE, cutil_Set_shrink_to_fit(set));
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+static void
+_should_fallBackToContains_when_batchLookupUnsupported(void)
+{
+    /* Arrange */
+    cutil_Set *const set = _create_mock_set();
+    MockSetData *const mock = set->data;
+    const int elems[] = {1, 2, 3};
+    cutil_Bool res[] = {false, false, false};
+
+    /* Act */
+    const cutil_Status status = cutil_Set_contains_batch(set, elems, 3UL, res);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    TEST_ASSERT_EQUAL_INT(3, mock->contains_count);
+    for (size_t i = 0; i < 3; ++i) {
+        TEST_ASSERT_TRUE(res[i]);
+    }
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
+static void
+_should_fallBackToContains_when_insertIfAbsentUnsupported(void)
+{
+    /* Arrange */
+    cutil_Set *const set = _create_mock_set();
+    MockSetData *const mock = set->data;
+    const int elem = 42;
+    cutil_Bool inserted = true;
+
+    /* Act */
+    const cutil_Status status
+      = cutil_Set_insert_if_absent(set, &elem, &inserted);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_INT(CUTIL_STATUS_SUCCESS, status);
+    TEST_ASSERT_FALSE(inserted);
+    TEST_ASSERT_EQUAL_INT(1, mock->contains_count);
+    TEST_ASSERT_EQUAL_INT(0, mock->add_count);
+
+    /* Cleanup */
+    cutil_Set_free(set);
+}
+
 /* Tests for cutil_Set iterator shims */
 
 static void
@@ -541,6 +603,18 @@ _hashset_factory_int(void)
     return cutil_HashSet_alloc(CUTIL_GENERIC_TYPE_INT);
 }
 
+static cutil_Set *
+_bitset_factory_uint(void)
+{
+    return cutil_BitSet_alloc(CUTIL_GENERIC_TYPE_UINT);
+}
+
+static cutil_Set *
+_roaringset_factory_u32(void)
+{
+    return cutil_RoaringSet_alloc();
+}
+
 /* ==========================================================================
  * Section B: Factory-driven behavioural tests
  * ========================================================================== */
@@ -1358,6 +1432,9 @@ main(void)
     RUN_TEST(_should_callAddFunction_when_elemIsAdded);
     RUN_TEST(_should_callRemoveFunction_when_elemIsRemoved);
     RUN_TEST(_should_callGetElemTypeFunction_when_elemTypeIsQueried);
+    RUN_TEST(_should_returnFailure_when_capacityManagementUnsupported);
+    RUN_TEST(_should_fallBackToContains_when_batchLookupUnsupported);
+    RUN_TEST(_should_fallBackToContains_when_insertIfAbsentUnsupported);
 
     /* Iterator shim tests */
     RUN_TEST(_should_callGetConstIterator_when_getConstIteratorCalledOnSet);
@@ -1408,6 +1485,92 @@ main(void)
     RUN_TEST(_should_returnZero_when_toStringCalledWithTooSmallBuffer);
     RUN_TEST(_should_renderAllElements_when_toStringCalledOnMultiElementSet);
 
+    /* --- BitSet (UINT) — full interface coverage --- */
+    g_current_factory = _bitset_factory_uint;
+    RUN_TEST(_should_returnSuccess_when_singleElemAdded);
+    RUN_TEST(_should_returnZeroCount_when_setIsNewlyAllocated);
+    RUN_TEST(_should_incrementCountWithEachUniqueElem);
+    RUN_TEST(_should_returnTrue_when_containsExistingElem);
+    RUN_TEST(_should_returnFalse_when_containsMissingElem);
+    RUN_TEST(_should_returnSuccess_when_removingExistingElem);
+    RUN_TEST(_should_returnFailure_when_removingMissingElem);
+    RUN_TEST(_should_decrementCount_when_existingElemRemoved);
+    RUN_TEST(_should_returnZeroCount_when_resetAfterFill);
+    RUN_TEST(_should_notDuplicateCount_when_sameElemAddedTwice);
+    RUN_TEST(_should_matchAllElems_when_copied);
+    RUN_TEST(_should_beIndependent_when_dstModifiedAfterCopy);
+    RUN_TEST(_should_matchAllElems_when_duplicated);
+    RUN_TEST(_should_beIndependent_when_dupModifiedAfterDuplicate);
+    RUN_TEST(_should_returnNonNull_when_getConstIteratorCalled);
+    RUN_TEST(_should_returnNonNull_when_getIteratorCalled);
+    RUN_TEST(_should_traverseAllElements_when_constIteratorRewoundOnSet);
+    RUN_TEST(_should_traverseAllElements_when_iteratorRewoundOnSet);
+    RUN_TEST(_should_returnFalse_when_nextCalledAfterExhaustionOnConstSet);
+    RUN_TEST(_should_returnFalse_when_nextCalledAfterExhaustionOnMutableSet);
+    RUN_TEST(_should_returnTrue_when_deepEqualsCalledOnSetsWithSameElements);
+    RUN_TEST(_should_returnFalse_when_deepEqualsCalledOnSetsWithDifferentCount);
+    RUN_TEST(
+      _should_returnFalse_when_deepEqualsCalledOnSetsWithDifferentElements
+    );
+    RUN_TEST(_should_handleNullInputs_when_deepEqualsCalledWithNulls);
+    RUN_TEST(_should_returnZero_when_compareCalledWithSamePointer);
+    RUN_TEST(
+      _should_returnConsistentSign_when_compareCalledOnSetsWithDifferentCount
+    );
+    RUN_TEST(_should_returnSameHash_when_hashCalledTwiceOnSameSet);
+    RUN_TEST(
+      _should_returnSameHash_when_setsHaveSameElementsInDifferentInsertionOrder
+    );
+    RUN_TEST(_should_returnZero_when_hashCalledOnNullOrEmptySet);
+    RUN_TEST(_should_renderEmptyBraces_when_toStringCalledOnEmptySet);
+    RUN_TEST(_should_renderSingleElement_when_toStringCalledOnSingletonSet);
+    RUN_TEST(_should_returnRequiredLength_when_toStringCalledWithNullBuf);
+    RUN_TEST(_should_returnZero_when_toStringCalledWithTooSmallBuffer);
+    RUN_TEST(_should_renderAllElements_when_toStringCalledOnMultiElementSet);
+
+    /* --- RoaringSet (U32) — full interface coverage --- */
+    g_current_factory = _roaringset_factory_u32;
+    RUN_TEST(_should_returnSuccess_when_singleElemAdded);
+    RUN_TEST(_should_returnZeroCount_when_setIsNewlyAllocated);
+    RUN_TEST(_should_incrementCountWithEachUniqueElem);
+    RUN_TEST(_should_returnTrue_when_containsExistingElem);
+    RUN_TEST(_should_returnFalse_when_containsMissingElem);
+    RUN_TEST(_should_returnSuccess_when_removingExistingElem);
+    RUN_TEST(_should_returnFailure_when_removingMissingElem);
+    RUN_TEST(_should_decrementCount_when_existingElemRemoved);
+    RUN_TEST(_should_returnZeroCount_when_resetAfterFill);
+    RUN_TEST(_should_notDuplicateCount_when_sameElemAddedTwice);
+    RUN_TEST(_should_matchAllElems_when_copied);
+    RUN_TEST(_should_beIndependent_when_dstModifiedAfterCopy);
+    RUN_TEST(_should_matchAllElems_when_duplicated);
+    RUN_TEST(_should_beIndependent_when_dupModifiedAfterDuplicate);
+    RUN_TEST(_should_returnNonNull_when_getConstIteratorCalled);
+    RUN_TEST(_should_returnNonNull_when_getIteratorCalled);
+    RUN_TEST(_should_traverseAllElements_when_constIteratorRewoundOnSet);
+    RUN_TEST(_should_traverseAllElements_when_iteratorRewoundOnSet);
+    RUN_TEST(_should_returnFalse_when_nextCalledAfterExhaustionOnConstSet);
+    RUN_TEST(_should_returnFalse_when_nextCalledAfterExhaustionOnMutableSet);
+    RUN_TEST(_should_returnTrue_when_deepEqualsCalledOnSetsWithSameElements);
+    RUN_TEST(_should_returnFalse_when_deepEqualsCalledOnSetsWithDifferentCount);
+    RUN_TEST(
+      _should_returnFalse_when_deepEqualsCalledOnSetsWithDifferentElements
+    );
+    RUN_TEST(_should_handleNullInputs_when_deepEqualsCalledWithNulls);
+    RUN_TEST(_should_returnZero_when_compareCalledWithSamePointer);
+    RUN_TEST(
+      _should_returnConsistentSign_when_compareCalledOnSetsWithDifferentCount
+    );
+    RUN_TEST(_should_returnSameHash_when_hashCalledTwiceOnSameSet);
+    RUN_TEST(
+      _should_returnSameHash_when_setsHaveSameElementsInDifferentInsertionOrder
+    );
+    RUN_TEST(_should_returnZero_when_hashCalledOnNullOrEmptySet);
+    RUN_TEST(_should_renderEmptyBraces_when_toStringCalledOnEmptySet);
+    RUN_TEST(_should_renderSingleElement_when_toStringCalledOnSingletonSet);
+    RUN_TEST(_should_returnRequiredLength_when_toStringCalledWithNullBuf);
+    RUN_TEST(_should_returnZero_when_toStringCalledWithTooSmallBuffer);
+    RUN_TEST(_should_renderAllElements_when_toStringCalledOnMultiElementSet);
+
     /* --- Elem-type test (not factory-driven) --- */
     RUN_TEST(_should_returnElemType_when_elemTypeQueried);
 
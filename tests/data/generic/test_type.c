@@ -231,6 +231,25 @@ _should_compareNotEqual_when_typesAreDifferent(void)
     TEST_ASSERT_FALSE(equals);
 }
 
+static void
+_should_beTriviallyCopyable_when_noLifecycleFunctions(void)
+{
+    /* Arrange */
+    const cutil_GenericType plain = {.name = "plain", .size = 4};
+    const cutil_GenericType with_init
+      = {.name = "with_init", .size = 4, .init = &_noop_one};
+    const cutil_GenericType with_clear
+      = {.name = "with_clear", .size = 4, .clear = &_noop_one};
+
+    /* Act & Assert */
+    TEST_ASSERT_TRUE(cutil_GenericType_is_trivially_copyable(&plain));
+    TEST_ASSERT_TRUE(
+      cutil_GenericType_is_trivially_copyable(CUTIL_GENERIC_TYPE_DOUBLE)
+    );
+    TEST_ASSERT_FALSE(cutil_GenericType_is_trivially_copyable(&with_init));
+    TEST_ASSERT_FALSE(cutil_GenericType_is_trivially_copyable(&with_clear));
+}
+
 static void
 _should_callInitAppropriateCount_when_applyInit(void)
 {
@@ -376,6 +395,47 @@ _should_useCustomHash_when_functionIsProvided(void)
     TEST_ASSERT_EQUAL_size_t(1, _hash_ctr);
 }
 
+static cutil_hash_t
+_hash_seeded_fnc(const void *obj, cutil_hash_t seed)
+{
+    return cutil_hashfunc_int(obj) + seed;
+}
+
+static void
+_should_mixSeedIntoHash_when_seededHashApplied(void)
+{
+    /* Arrange */
+    const int val = 42;
+    const cutil_hash_t seed = CUTIL_HASH_C(0x1234);
+    const cutil_GenericType raw_type = {.size = sizeof val};
+    const cutil_GenericType hashed_type = {
+      .size = sizeof val,
+      .hash = &_hash_fnc_count,
+    };
+    const cutil_GenericType seeded_type = {
+      .size = sizeof val,
+      .hash = &_hash_fnc_count,
+      .hash_seeded = &_hash_seeded_fnc,
+    };
+
+    /* Act & Assert */
+    TEST_ASSERT_EQUAL_UINT64(
+      cutil_hash_bytes(&val, sizeof val, seed),
+      cutil_GenericType_apply_hash_seeded(&raw_type, &val, seed)
+    );
+    TEST_ASSERT_TRUE(cutil_GenericType_has_seeded_hash(&raw_type));
+    TEST_ASSERT_EQUAL_UINT64(
+      UINT64_C(0xCAFEBABE) ^ seed,
+      cutil_GenericType_apply_hash_seeded(&hashed_type, &val, seed)
+    );
+    TEST_ASSERT_FALSE(cutil_GenericType_has_seeded_hash(&hashed_type));
+    TEST_ASSERT_EQUAL_UINT64(
+      (cutil_hash_t) val + seed,
+      cutil_GenericType_apply_hash_seeded(&seeded_type, &val, seed)
+    );
+    TEST_ASSERT_TRUE(cutil_GenericType_has_seeded_hash(&seeded_type));
+}
+
 static void
 _should_useFallbackCompare_when_functionIsNull(void)
 {
@@ -872,6 +932,7 @@ main(void)
     RUN_TEST(_should_returnValid_when_sizeIsNonzero);
     RUN_TEST(_should_compareEqual_when_typesAreIdentical);
     RUN_TEST(_should_compareNotEqual_when_typesAreDifferent);
+    RUN_TEST(_should_beTriviallyCopyable_when_noLifecycleFunctions);
     RUN_TEST(_should_callInitAppropriateCount_when_applyInit);
     RUN_TEST(_should_callClearAppropriateCount_when_applyClear);
     RUN_TEST(_should_callCopyAppropriateCount_when_applyCopy);
@@ -880,6 +941,7 @@ main(void)
     RUN_TEST(_should_callClearOnRemovedElements_when_reallocShrinks);
     RUN_TEST(_should_useFallbackHash_when_functionIsNull);
     RUN_TEST(_should_useCustomHash_when_functionIsProvided);
+    RUN_TEST(_should_mixSeedIntoHash_when_seededHashApplied);
     RUN_TEST(_should_useFallbackCompare_when_functionIsNull);
     RUN_TEST(_should_useCustomCompare_when_functionIsProvided);
     RUN_TEST(_should_useFallbackDeepEquals_when_functionIsNull);
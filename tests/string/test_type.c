@@ -180,6 +180,36 @@ _should_returnZeroHash_when_hashCalledOnNullStr(void)
     cutil_String_free(s);
 }
 
+static void
+_should_separateCollidingStrings_when_hashedWithSeed(void)
+{
+    /* Arrange */
+    /* "ap" and "g6" collide under 'cutil_String_hash' */
+    cutil_String *const lhs = cutil_String_from_string("ap");
+    cutil_String *const rhs = cutil_String_from_string("g6");
+    cutil_String *const same = cutil_String_from_string("ap");
+    const cutil_hash_t seed = CUTIL_HASH_C(0x243f6a8885a308d3);
+
+    /* Act */
+    const cutil_hash_t lhs_hash = cutil_String_hash_seeded_generic(lhs, seed);
+    const cutil_hash_t rhs_hash = cutil_String_hash_seeded_generic(rhs, seed);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_UINT64(cutil_String_hash(lhs), cutil_String_hash(rhs));
+    TEST_ASSERT_TRUE(lhs_hash != rhs_hash);
+    TEST_ASSERT_EQUAL_UINT64(
+      lhs_hash, cutil_String_hash_seeded_generic(same, seed)
+    );
+    TEST_ASSERT_TRUE(
+      lhs_hash != cutil_String_hash_seeded_generic(lhs, seed + 1U)
+    );
+
+    /* Cleanup */
+    cutil_String_free(same);
+    cutil_String_free(rhs);
+    cutil_String_free(lhs);
+}
+
 static void
 _should_writeContent_when_toStringCalledWithAdequateBuffer(void)
 {
@@ -701,6 +731,7 @@ main(void)
     RUN_TEST(_should_returnZero_when_compareCalledOnEqualStrings);
     RUN_TEST(_should_returnNonZeroHash_when_hashCalledOnNonEmpty);
     RUN_TEST(_should_returnZeroHash_when_hashCalledOnNullStr);
+    RUN_TEST(_should_separateCollidingStrings_when_hashedWithSeed);
     RUN_TEST(_should_writeContent_when_toStringCalledWithAdequateBuffer);
     RUN_TEST(_should_writeNullString_when_toStringCalledOnNullStr);
     RUN_TEST(_should_returnZero_when_toStringCalledWithTooSmallBuffer);
@@ -0,0 +1,96 @@
+#include "unity.h"
+#include <cutil/util/bits.h>
+
+#include <cutil/util/macro.h>
+
+static void
+_should_returnIndexOfLowestSetBit_when_countTrailingZeros(void)
+{
+    /* Arrange */
+    const uint64_t VALUES[] = {
+      UINT64_C(1),
+      UINT64_C(2),
+      UINT64_C(12),
+      UINT64_C(0x8000),
+      UINT64_C(0x8888888888888880),
+      UINT64_C(0x8000000000000000),
+    };
+    const unsigned int EXPECTED[] = {0U, 1U, 2U, 15U, 7U, 63U};
+    const size_t NUM_VALUES = CUTIL_GET_NATIVE_ARRAY_SIZE(VALUES);
+
+    for (size_t i = 0; i < NUM_VALUES; ++i) {
+        /* Act */
+        const unsigned int res = cutil_bits_ctz_u64(VALUES[i]);
+
+        /* Assert */
+        TEST_ASSERT_EQUAL_UINT32(EXPECTED[i], res);
+    }
+}
+
+static void
+_should_returnDistanceToHighestSetBit_when_countLeadingZeros(void)
+{
+    /* Arrange */
+    const uint64_t VALUES[] = {
+      UINT64_C(1),
+      UINT64_C(2),
+      UINT64_C(12),
+      UINT64_C(0x8000),
+      UINT64_C(0x0888888888888880),
+      UINT64_C(0x8000000000000000),
+    };
+    const unsigned int EXPECTED[] = {63U, 62U, 60U, 48U, 4U, 0U};
+    const size_t NUM_VALUES = CUTIL_GET_NATIVE_ARRAY_SIZE(VALUES);
+
+    for (size_t i = 0; i < NUM_VALUES; ++i) {
+        /* Act */
+        const unsigned int res = cutil_bits_clz_u64(VALUES[i]);
+
+        /* Assert */
+        TEST_ASSERT_EQUAL_UINT32(EXPECTED[i], res);
+    }
+}
+
+static void
+_should_returnNumberOfSetBits_when_countPopulation(void)
+{
+    /* Arrange */
+    const uint64_t VALUES[] = {
+      UINT64_C(0),
+      UINT64_C(1),
+      UINT64_C(12),
+      UINT64_C(0x8000000000000001),
+      UINT64_C(0x8888888888888880),
+      UINT64_C(0xFFFFFFFFFFFFFFFF),
+    };
+    const unsigned int EXPECTED[] = {0U, 1U, 2U, 2U, 15U, 64U};
+    const size_t NUM_VALUES = CUTIL_GET_NATIVE_ARRAY_SIZE(VALUES);
+
+    for (size_t i = 0; i < NUM_VALUES; ++i) {
+        /* Act */
+        const unsigned int res = cutil_bits_popcount_u64(VALUES[i]);
+
+        /* Assert */
+        TEST_ASSERT_EQUAL_UINT32(EXPECTED[i], res);
+    }
+}
+
+void
+setUp(void)
+{}
+
+void
+tearDown(void)
+{}
+
+int
+main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(_should_returnIndexOfLowestSetBit_when_countTrailingZeros);
+    RUN_TEST(_should_returnDistanceToHighestSetBit_when_countLeadingZeros);
+    RUN_TEST(_should_returnNumberOfSetBits_when_countPopulation);
+
+    return UNITY_END();
+}
@@ -145,6 +145,27 @@ _should_hashStringCorrectly_when_provideEmptyAndNonEmpty(void)
     TEST_ASSERT_EQUAL_UINT64(hash4, empty_hash);
 }
 
+static void
+_should_spreadSequentialInputs_when_finalizeHashes(void)
+{
+    /* Arrange */
+    const cutil_hash_t h0 = CUTIL_HASH_C(0);
+    const cutil_hash_t h1 = CUTIL_HASH_C(1);
+    const cutil_hash_t h2 = CUTIL_HASH_C(2);
+
+    /* Act */
+    const cutil_hash_t f0 = cutil_hash_finalize(h0);
+    const cutil_hash_t f1 = cutil_hash_finalize(h1);
+    const cutil_hash_t f2 = cutil_hash_finalize(h2);
+
+    /* Assert */
+    TEST_ASSERT_EQUAL_UINT64(f1, cutil_hash_finalize(h1));
+    TEST_ASSERT_EQUAL_UINT64(CUTIL_HASH_C(0), f0);
+    TEST_ASSERT_NOT_EQUAL_UINT64(f1, f2);
+    TEST_ASSERT_NOT_EQUAL_UINT64(f1 & CUTIL_HASH_C(0x7F), f2 & 0x7F);
+    TEST_ASSERT_NOT_EQUAL_UINT64(f1 >> 32, f2 >> 32);
+}
+
 void
 setUp(void)
 {}
@@ -163,6 +184,7 @@ main(void)
     RUN_TEST(_should_combineHashesCorrectly_when_varyInput);
     RUN_TEST(_should_hashBytesCorrectly_when_provideString);
     RUN_TEST(_should_hashStringCorrectly_when_provideEmptyAndNonEmpty);
+    RUN_TEST(_should_spreadSequentialInputs_when_finalizeHashes);
 
     return UNITY_END();
 }